@@ -0,0 +1,245 @@
+# benchmarkharness.py - Headless benchmark of the hot paths of the Psychtoolbox modules.
+#
+# Runs a fixed set of benchmarks which don't need any display, sound or input hardware,
+# and writes the results as JSON, to stdout or into the file given as first argument,
+# so results can be compared across releases and machines:
+#
+# dispatch:   Time per call of cheap subfunctions, ie. the Python -> module dispatch overhead.
+# getsecs:    Time per GetSecs() call and smallest increment between successive calls.
+# waitsecs:   Distribution of the lateness of WaitSecs('UntilTime') wakeups after their deadline.
+# ioport:     Throughput of IOPort reads and writes over a pseudo-terminal pair (Linux and macOS).
+# kbqueue:    Enqueue and dequeue rates of synthetic events via PsychHID('KbQueueBenchmark').
+# portaudio:  Cost of the audio callback via PsychPortAudio('CallbackBenchmark').
+#
+# Benchmarks for modules which are not available are reported as skipped. Each benchmark
+# runs in its own subprocess, so they can't disturb each other. Iteration counts and random
+# seeds are fixed.
+#
+# Usage: python3 benchmarkharness.py [results.json] [benchmarkname ...]
+#
+# (c) 2026 agent - Licensed under MIT license.
+
+import os
+import sys
+import json
+import time
+import platform
+import subprocess
+
+# Version of the format of the results. Increment if the meaning of existing fields changes:
+formatversion = 1
+
+
+def percentiles(values):
+    values = sorted(values)
+    n = len(values)
+    return {'min': values[0], 'median': values[n // 2], 'p90': values[int(0.9 * (n - 1))],
+            'p99': values[int(0.99 * (n - 1))], 'max': values[-1], 'mean': sum(values) / n}
+
+
+def bench_dispatch():
+    import timeit
+    import psychtoolbox as ptb
+
+    numcalls = 100000
+    calls = [('builtin max(1, 2)', lambda: max(1, 2)),
+             ('GetSecs()', lambda: ptb.GetSecs()),
+             ('GetSecs(\'Version\')', lambda: ptb.GetSecs('Version')),
+             ('WaitSecs(0)', lambda: ptb.WaitSecs(0)),
+             ('IOPort(\'Verbosity\')', lambda: ptb.IOPort('Verbosity'))]
+
+    if hasattr(ptb, 'PsychPortAudio'):
+        calls.append(('PsychPortAudio(\'Verbosity\')', lambda: ptb.PsychPortAudio('Verbosity')))
+
+    # Best of 5 runs, in seconds per call:
+    return {name: min(timeit.repeat(fn, number=numcalls, repeat=5)) / numcalls for name, fn in calls}
+
+
+def bench_getsecs():
+    import timeit
+    from psychtoolbox import GetSecs
+
+    numcalls = 1000000
+    results = {'callSecs': min(timeit.repeat(GetSecs, number=numcalls, repeat=5)) / numcalls}
+
+    mininc = 1e9
+    for i in range(100000):
+        t1 = GetSecs()
+        t2 = GetSecs()
+        while t2 == t1:
+            t2 = GetSecs()
+        mininc = min(mininc, t2 - t1)
+    results['minIncrementSecs'] = mininc
+
+    try:
+        results['timebase'], _, results['resolutionSecs'] = GetSecs('Timebase')
+    except Exception:
+        pass
+
+    return results
+
+
+def bench_waitsecs():
+    import random
+    from psychtoolbox import GetSecs, WaitSecs
+
+    numwaits = 1000
+    random.seed(1)
+
+    # Warmup, to let the calibration of the busy-wait threshold settle:
+    for i in range(100):
+        WaitSecs('UntilTime', GetSecs() + 0.001)
+
+    lateness = []
+    waited = 0
+    cpu = time.thread_time()
+    for i in range(numwaits):
+        interval = random.uniform(0.0005, 0.005)
+        deadline = GetSecs() + interval
+        lateness.append(WaitSecs('UntilTime', deadline) - deadline)
+        waited += interval
+    cpu = time.thread_time() - cpu
+
+    return {'numWaits': numwaits, 'latenessSecs': percentiles(lateness), 'cpuFraction': cpu / waited}
+
+
+def bench_ioport():
+    if not hasattr(os, 'openpty'):
+        raise RuntimeError('No pseudo-terminals on this operating system.')
+
+    import tty
+    import threading
+    import numpy as np
+    from psychtoolbox import IOPort, GetSecs
+
+    IOPort('Verbosity', 0)
+    nbytes = 4 * 1024 * 1024
+    chunk = 4096
+    data = bytes(i & 0xff for i in range(chunk))
+    results = {'numBytes': nbytes}
+
+    master, slave = os.openpty()
+    try:
+        # Raw mode on the master side as well, so the line discipline doesn't mangle data:
+        tty.setraw(master)
+        port, errmsg = IOPort('OpenSerialPort', os.ttyname(slave), 'Lenient ReceiveTimeout=1 InputBufferSize=%i' % (8 * chunk))
+        try:
+            # Reads: Writer thread feeds the master side, IOPort reads blocking:
+            def writer():
+                for i in range(nbytes // chunk):
+                    os.write(master, data)
+
+            t = GetSecs()
+            thread = threading.Thread(target=writer)
+            thread.start()
+            received = 0
+            while received < nbytes:
+                buf, _, _ = IOPort('Read', port, 1, min(chunk, nbytes - received))
+                received += np.size(buf)
+            results['readBytesPerSec'] = nbytes / (GetSecs() - t)
+            thread.join()
+
+            # Writes: Child process drains the master side, IOPort writes blocking. A thread wouldn't do, as
+            # IOPort('Write') holds the Python GIL while it blocks:
+            drain = 'import os, sys\nn = int(sys.argv[1])\nwhile n > 0:\n    n -= len(os.read(0, %i))\n' % chunk
+            wdata = np.frombuffer(data, dtype=np.uint8)
+            child = subprocess.Popen([sys.executable, '-c', drain, str(nbytes)], stdin=master)
+            t = GetSecs()
+            for i in range(nbytes // chunk):
+                IOPort('Write', port, wdata, 1)
+            child.wait()
+            results['writeBytesPerSec'] = nbytes / (GetSecs() - t)
+        finally:
+            IOPort('Close', port)
+    finally:
+        os.close(master)
+        os.close(slave)
+
+    return results
+
+
+def bench_kbqueue():
+    from psychtoolbox import PsychHID
+
+    results = {}
+    for numvaluators in (0, 4):
+        r = PsychHID('KbQueueBenchmark', 0, 1000000, numvaluators)
+        results['valuators%i' % numvaluators] = {k: r[k] for k in ('numEvents', 'enqueueRate', 'dequeueRate', 'availRate')}
+
+    return results
+
+
+def bench_portaudio():
+    from psychtoolbox import PsychPortAudio
+
+    PsychPortAudio('Verbosity', 0)
+    results = {}
+    for name, mode, streamclock in (('playback', 1, 0), ('capture', 2, 0), ('fullduplex', 3, 0),
+                                    ('monitoring', 7, 0), ('playbackStreamClock', 1, 1)):
+        results[name] = PsychPortAudio('CallbackBenchmark', mode, 2, 256, 100000, 48000, streamclock)
+
+    return results
+
+
+benchmarks = [('dispatch', bench_dispatch), ('getsecs', bench_getsecs), ('waitsecs', bench_waitsecs),
+              ('ioport', bench_ioport), ('kbqueue', bench_kbqueue), ('portaudio', bench_portaudio)]
+
+
+def measure(name):
+    # Runs in a subprocess: Prints JSON results of benchmark 'name' to stdout.
+    try:
+        results = dict(benchmarks)[name]()
+    except Exception as e:
+        msg = str(e).strip()
+        results = {'skipped': msg.splitlines()[-1] if msg else type(e).__name__}
+
+    sys.stdout.write('\n' + json.dumps(results) + '\n')
+
+
+def versions():
+    import psychtoolbox as ptb
+    v = {}
+    for module in ('GetSecs', 'WaitSecs', 'IOPort', 'PsychHID', 'PsychPortAudio'):
+        try:
+            v[module] = getattr(ptb, module)('Version')['version']
+        except Exception:
+            pass
+
+    return v
+
+
+def run(filename=None, names=None):
+    results = {'formatVersion': formatversion,
+               'date': time.strftime('%Y-%m-%dT%H:%M:%SZ', time.gmtime()),
+               'machine': {'platform': platform.platform(), 'processor': platform.processor() or platform.machine(),
+                           'cpus': os.cpu_count(), 'python': platform.python_version()},
+               'versions': versions(),
+               'benchmarks': {}}
+
+    for name, fn in benchmarks:
+        if names and name not in names:
+            continue
+
+        sys.stderr.write('Running %s...\n' % name)
+        p = subprocess.run([sys.executable, __file__, 'measure', name], stdout=subprocess.PIPE, universal_newlines=True)
+        try:
+            # Modules may print to stdout as well, so the results are the last line:
+            results['benchmarks'][name] = json.loads(p.stdout.strip().splitlines()[-1])
+        except (ValueError, IndexError):
+            results['benchmarks'][name] = {'skipped': 'Benchmark failed with exit code %i.' % p.returncode}
+
+    text = json.dumps(results, indent=2, sort_keys=True)
+    if filename:
+        with open(filename, 'w') as f:
+            f.write(text + '\n')
+    else:
+        print(text)
+
+
+if __name__ == '__main__':
+    if len(sys.argv) > 2 and sys.argv[1] == 'measure':
+        measure(sys.argv[2])
+    else:
+        args = sys.argv[1:]
+        filename = args.pop(0) if args and args[0].endswith('.json') else None
+        run(filename, args)
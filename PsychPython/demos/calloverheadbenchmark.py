@@ -0,0 +1,68 @@
+# calloverheadbenchmark.py - Measure the call overhead of Psychtoolbox module subfunctions.
+#
+# Calls cheap subfunctions of the Psychtoolbox Python modules in a tight loop and
+# prints the average time per call in microseconds. The measured time is dominated
+# by the overhead of the Python -> module dispatch, subfunction name lookup and
+# argument conversion, so this is useful to check for regressions in the scripting
+# glue. Subfunctions which can't run on the current machine, e.g., PsychHID without
+# a keyboard, or PsychPortAudio without a sound card, are skipped.
+#
+# (c) 2026 agent - Licensed under MIT license.
+
+import timeit
+import psychtoolbox as ptb
+
+numcalls = 100000
+
+
+def benchmark(name, fn, baseline=0.0):
+    try:
+        fn()
+    except Exception as e:
+        print('%-45s: Skipped [%s]' % (name, str(e).strip().splitlines()[-1] if str(e).strip() else type(e).__name__))
+        return None
+
+    # Best of 5 runs, to reduce noise from other activity on the machine:
+    t = min(timeit.repeat(fn, number=numcalls, repeat=5)) / numcalls * 1e6
+    print('%-45s: %8.3f usecs per call, %8.3f usecs dispatch overhead.' % (name, t, t - baseline))
+    return t
+
+
+def run():
+    GetSecs = ptb.GetSecs
+    WaitSecs = ptb.WaitSecs
+    IOPort = ptb.IOPort
+    PsychHID = getattr(ptb, 'PsychHID', None)
+    PsychPortAudio = getattr(ptb, 'PsychPortAudio', None)
+
+    # Reference: Cost of calling a trivial Python builtin with the same arguments:
+    baseline = benchmark('Python builtin max(1, 2)', lambda: max(1, 2))
+
+    print()
+    benchmark('GetSecs()', lambda: GetSecs(), baseline)
+    benchmark('GetSecs(\'AllClocks\')', lambda: GetSecs('AllClocks'), baseline)
+    benchmark('GetSecs(\'Version\')', lambda: GetSecs('Version'), baseline)
+    benchmark('WaitSecs(0)', lambda: WaitSecs(0), baseline)
+    benchmark('WaitSecs(\'UntilTime\', 0)', lambda: WaitSecs('UntilTime', 0), baseline)
+    benchmark('IOPort(\'Verbosity\')', lambda: IOPort('Verbosity'), baseline)
+
+    # Subfunction late in the function table, with mixed case spelling of the name:
+    benchmark('IOPort(\'closeall\')', lambda: IOPort('closeall'), baseline)
+
+    if PsychHID:
+        benchmark('PsychHID(\'KbCheck\')', lambda: PsychHID('KbCheck'), baseline)
+        benchmark('PsychHID(\'KbQueueFlush\')', lambda: PsychHID('KbQueueFlush'), baseline)
+
+    if PsychPortAudio:
+        PsychPortAudio('Verbosity', 0)
+        benchmark('PsychPortAudio(\'Verbosity\')', lambda: PsychPortAudio('Verbosity'), baseline)
+        try:
+            pahandle = PsychPortAudio('Open', [], 1, 0, 48000, 2)
+            benchmark('PsychPortAudio(\'GetStatus\')', lambda: PsychPortAudio('GetStatus', pahandle), baseline)
+            PsychPortAudio('Close', pahandle)
+        except Exception:
+            print('%-45s: Skipped [No sound device]' % 'PsychPortAudio(\'GetStatus\')')
+
+
+if __name__ == '__main__':
+    run()
@@ -0,0 +1,90 @@
+# clockdomaintest.py - Test the clock domain registry of the Psychtoolbox modules.
+#
+# Prints the state of the built-in clock domains, then feeds samples of a simulated
+# device clock in msecs, with a drift of 50 ppm against GetSecs, jitter of the
+# pairing of samples, and occasional gross outliers, into a script created clock
+# domain via GetSecs('ClockDomains', 'AddSamples', ...). Reports the error of the
+# mapping of device time to GetSecs time against the true mapping, and the estimated
+# uncertainty and drift. Then simulates a reset of the device clock.
+#
+# (c) 2026 agent - Licensed under MIT license.
+
+import numpy as np
+from psychtoolbox import GetSecs
+
+drift = 50e-6
+jitter = 0.0002
+nsamples = 2000
+interval = 0.01
+
+
+def printdomains():
+    for d in GetSecs('ClockDomains'):
+        print('%-32s: offset %16.6f slope %.9f drift %+9.3f ppm sd %8.2f usecs, uncertainty %8.2f usecs, %i samples, %i rejected.' %
+              (d['name'], d['offset'], d['slope'], d['drift'] * 1e6, d['residualSD'] * 1e6, d['uncertainty'] * 1e6,
+               d['numSamples'], d['numRejected']))
+
+
+def devicetime(t, origin):
+    # True mapping of GetSecs time to device clock in msecs:
+    return (t - origin) * (1 + drift) * 1000.0
+
+
+def run():
+    rng = np.random.default_rng(1)
+    t0 = GetSecs()
+
+    # Mapping of built-in domains at current time:
+    print('Built-in domains:')
+    GetSecs('ClockDomains', 'ToGetSecs', 'realtime', [0.0])
+    GetSecs('ClockDomains', 'ToGetSecs', 'monotonic', [0.0])
+    printdomains()
+
+    # Simulated device, with samples taken at 'interval' secs, starting at t0. The GetSecs
+    # timestamp of each sample is late by a random delay, and 2% of samples are grossly late,
+    # as if the collecting thread got preempted:
+    ref = t0 + np.arange(nsamples) * interval
+    dev = devicetime(ref, t0 - 100)
+    delay = rng.exponential(jitter, nsamples)
+    outliers = rng.random(nsamples) < 0.02
+    delay[outliers] += rng.uniform(0.002, 0.02, np.count_nonzero(outliers))
+    unc = np.full(nsamples, jitter)
+
+    if any(d['name'] == 'testdevice' for d in GetSecs('ClockDomains')):
+        GetSecs('ClockDomains', 'Remove', 'testdevice')
+
+    accepted = 0
+    for i in range(nsamples):
+        accepted += GetSecs('ClockDomains', 'AddSamples', 'testdevice', [dev[i]], [ref[i] + delay[i]], [unc[i]], 1000)
+
+    print('\nSimulated device: %i of %i samples accepted, %i injected outliers.' % (accepted, nsamples, np.count_nonzero(outliers)))
+    printdomains()
+
+    # The regression estimates the mean delay as part of the offset, so compare against truth plus mean delay
+    # of non-outliers:
+    bias = np.mean(delay[~outliers])
+    probe = devicetime(ref[-1] + np.array([0, 1, 10, 60]), t0 - 100)
+    mapped, uncertainty = GetSecs('ClockDomains', 'ToGetSecs', 'testdevice', probe)
+    truth = ref[-1] + np.array([0, 1, 10, 60]) + bias
+    for p, e in zip([0, 1, 10, 60], (np.ravel(mapped) - truth) * 1e6):
+        print('Error of mapped time %2i secs after last sample: %8.2f usecs.' % (p, e))
+    print('Reported uncertainty: %.2f usecs.' % (uncertainty * 1e6))
+
+    back, _ = GetSecs('ClockDomains', 'FromGetSecs', 'testdevice', mapped)
+    print('Max roundtrip error: %g msecs.' % np.max(np.abs(np.ravel(back) - probe)))
+
+    # Device clock restarts at zero: The mapping must restart after a few rejected samples:
+    ref2 = ref[-1] + interval + np.arange(100) * interval
+    dev2 = devicetime(ref2, ref2[0])
+    for i in range(100):
+        GetSecs('ClockDomains', 'AddSamples', 'testdevice', [dev2[i]], [ref2[i]], [jitter])
+
+    mapped, _ = GetSecs('ClockDomains', 'ToGetSecs', 'testdevice', [dev2[-1]])
+    print('\nAfter device clock reset: Error %.2f usecs.' % ((np.ravel(mapped)[0] - ref2[-1]) * 1e6))
+    printdomains()
+
+    GetSecs('ClockDomains', 'Remove', 'testdevice')
+
+
+if __name__ == '__main__':
+    run()
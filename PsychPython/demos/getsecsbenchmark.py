@@ -0,0 +1,62 @@
+# getsecsbenchmark.py - Measure call cost and resolution of GetSecs for all timebases.
+#
+# On Linux, the clock used as GetSecs timebase can be selected via the environment
+# variable PSYCH_GETSECS_TIMEBASE before the Psychtoolbox modules are loaded. This
+# test runs itself in a subprocess for each timebase, and measures the time per
+# GetSecs() call, the smallest nonzero increment between successive calls, the
+# clock resolution reported by GetSecs('Timebase'), and the offset of GetSecs time
+# to gettimeofday() aka Python time.time(). On other operating systems, only the
+# native timebase is tested.
+#
+# (c) 2026 agent - Licensed under MIT license.
+
+import os
+import sys
+import subprocess
+import timeit
+
+timebases = ['gettimeofday', 'realtime', 'monotonic', 'monotonicraw']
+numcalls = 1000000
+
+
+def measure():
+    import time
+    from psychtoolbox import GetSecs
+
+    name, offset, resolution = GetSecs('Timebase')
+
+    # Call cost, best of 5 runs:
+    t = min(timeit.repeat(GetSecs, number=numcalls, repeat=5)) / numcalls
+
+    # Smallest nonzero increment between successive calls:
+    mininc = 1e9
+    for i in range(100000):
+        t1 = GetSecs()
+        t2 = GetSecs()
+        while t2 == t1:
+            t2 = GetSecs()
+        mininc = min(mininc, t2 - t1)
+
+    # Offset to gettimeofday() epoch, ie. Python time.time():
+    toffset = GetSecs() - time.time()
+
+    print('%-15s: %7.1f nsecs per call, min increment %7.1f nsecs, resolution %7.1f nsecs, offset to time.time() %9.6f secs.' %
+          (name, t * 1e9, mininc * 1e9, resolution * 1e9, toffset))
+
+
+def run():
+    if not sys.platform.startswith('linux'):
+        measure()
+        return
+
+    for timebase in timebases:
+        env = dict(os.environ, PSYCH_GETSECS_TIMEBASE=timebase)
+        env.pop('PSYCH_GETSECS_TIMEBASEOFFSET', None)
+        subprocess.run([sys.executable, __file__, 'measure'], env=env)
+
+
+if __name__ == '__main__':
+    if len(sys.argv) > 1 and sys.argv[1] == 'measure':
+        measure()
+    else:
+        run()
@@ -0,0 +1,99 @@
+# gilreleasetest.py - Test if blocking Psychtoolbox calls let other Python threads run.
+#
+# Module calls which wait for time to pass or for input data release the Python
+# global interpreter lock while they wait. This test runs a pure Python counting
+# thread in parallel to blocking WaitSecs, WaitSecs('UntilTime') and IOPort 'Read'
+# calls on the main thread, and to GetSecs calls from a 2nd thread, and compares
+# its throughput to the throughput of the same thread running alone. Without GIL
+# release, the counting thread would be starved during the blocking calls.
+#
+# (c) 2026 agent - Licensed under MIT license.
+
+import os
+import threading
+from psychtoolbox import GetSecs, WaitSecs, IOPort
+
+duration = 1.0
+
+
+class Counter(threading.Thread):
+    def __init__(self):
+        threading.Thread.__init__(self, daemon=True)
+        self.count = 0
+        self.done = False
+
+    def run(self):
+        while not self.done:
+            self.count += 1
+
+
+class GetSecsCaller(threading.Thread):
+    def __init__(self):
+        threading.Thread.__init__(self, daemon=True)
+        self.count = 0
+        self.done = False
+
+    def run(self):
+        while not self.done:
+            GetSecs()
+            self.count += 1
+
+
+def measure(name, blocker, baseline=None, helper=None):
+    # Run counting thread (and optional helper thread) while main thread executes blocker:
+    counter = Counter()
+    threads = [counter] + ([helper] if helper else [])
+    for t in threads:
+        t.start()
+
+    tstart = GetSecs()
+    blocker()
+    telapsed = GetSecs() - tstart
+
+    for t in threads:
+        t.done = True
+    for t in threads:
+        t.join()
+
+    rate = counter.count / telapsed
+    if baseline:
+        print('%-40s: %12.0f counts/sec = %5.1f %% of baseline.' % (name, rate, 100 * rate / baseline))
+    else:
+        print('%-40s: %12.0f counts/sec.' % (name, rate))
+
+    if helper:
+        print('%-40s: %12.0f GetSecs calls/sec from 2nd thread.' % ('', helper.count / telapsed))
+
+    return rate
+
+
+def run():
+    # Baseline: Counting thread alone, main thread sleeps in Python:
+    baseline = measure('Python sleep (baseline)', lambda: threading.Event().wait(duration))
+
+    # Blocking wait via WaitSecs:
+    measure('WaitSecs', lambda: WaitSecs(duration), baseline)
+    measure('WaitSecs(\'UntilTime\')', lambda: WaitSecs('UntilTime', GetSecs() + duration), baseline)
+
+    # Many short WaitSecs calls, to also exercise the dispatch lock:
+    def shortwaits():
+        for i in range(int(duration / 0.001)):
+            WaitSecs(0.001)
+
+    measure('WaitSecs 1 msec loop', shortwaits, baseline)
+
+    # WaitSecs on main thread and GetSecs on a 2nd thread at the same time:
+    measure('WaitSecs + GetSecs thread', lambda: WaitSecs(duration), baseline, GetSecsCaller())
+
+    # Blocking IOPort 'Read' from a pseudo-terminal which never delivers data:
+    if os.name == 'posix':
+        master, slave = os.openpty()
+        port, errmsg = IOPort('OpenSerialPort', os.ttyname(slave), 'Lenient ReadTimeout=%f' % duration)
+        measure('IOPort blocking Read', lambda: IOPort('Read', port, 1, 1), baseline)
+        IOPort('Close', port)
+        os.close(slave)
+        os.close(master)
+
+
+if __name__ == '__main__':
+    run()
@@ -0,0 +1,71 @@
+# structbuilderbenchmark.py - Benchmark creation of output structs by Psychtoolbox modules.
+#
+# Subfunctions like PsychPortAudio('GetStatus'), PsychPortAudio('GetDevices') or
+# PsychHID('KbQueueGetEvent') return structs with many fields, which are dicts in
+# Python. This test uses the hidden 'StructBuilderBenchmarkHelper' subfunction,
+# which every Python module has, to compare the cost of creating a struct with the
+# 23 fields of a 'GetStatus' struct by setting each field by name (the old way),
+# and via a struct builder which sets fields by precomputed index (the new way).
+# Then it repeats the struct builder test with lightweight named tuple records
+# instead of dicts, as selected by the hidden 'StructRecordsHelper' subfunction.
+#
+# If PsychPortAudio is available and a sound device can be opened, the time per
+# PsychPortAudio('GetStatus') call is measured with dicts and with records.
+#
+# (c) 2026 agent - Licensed under MIT license.
+
+import timeit
+import psychtoolbox as ptb
+from psychtoolbox import GetSecs
+
+numstructs = 20000
+numcalls = 20000
+
+
+def benchmark(name, numElements):
+    bestname = 1e9
+    bestbuilder = 1e9
+    for i in range(5):
+        namesecs, buildersecs = GetSecs('StructBuilderBenchmarkHelper', numstructs, numElements)
+        bestname = min(bestname, namesecs)
+        bestbuilder = min(bestbuilder, buildersecs)
+
+    print('%-45s: By name %8.3f usecs, by builder %8.3f usecs per struct = %5.1fx speedup.' %
+          (name, bestname * 1e6, bestbuilder * 1e6, bestname / bestbuilder))
+
+
+def run():
+    for records in (0, 1):
+        GetSecs('StructRecordsHelper', records)
+        kind = 'records' if records else 'dicts'
+        benchmark('Single struct, 23 fields, %s' % kind, -1)
+        benchmark('10 element struct array, 23 fields, %s' % kind, 10)
+        print()
+
+    GetSecs('StructRecordsHelper', 0)
+
+    PsychPortAudio = getattr(ptb, 'PsychPortAudio', None)
+    if not PsychPortAudio:
+        return
+
+    PsychPortAudio('Verbosity', 0)
+    try:
+        pahandle = PsychPortAudio('Open', [], 1, 0, 48000, 2)
+    except Exception:
+        print('PsychPortAudio(\'GetStatus\'): Skipped [No sound device]')
+        return
+
+    for records in (0, 1):
+        PsychPortAudio('StructRecordsHelper', records)
+        t = min(timeit.repeat(lambda: PsychPortAudio('GetStatus', pahandle), number=numcalls, repeat=5)) / numcalls * 1e6
+        status = PsychPortAudio('GetStatus', pahandle)
+        active = status.Active if records else status['Active']
+        print('%-45s: %8.3f usecs per call. Active = %i' %
+              ('PsychPortAudio(\'GetStatus\') %s' % ('records' if records else 'dicts'), t, active))
+
+    PsychPortAudio('StructRecordsHelper', 0)
+    PsychPortAudio('Close', pahandle)
+
+
+if __name__ == '__main__':
+    run()
@@ -0,0 +1,40 @@
+# tempmembenchmark.py - Benchmark the temporary memory allocator of Psychtoolbox modules.
+#
+# Subfunctions of Psychtoolbox modules allocate temporary memory buffers for input
+# arguments, and as scratch memory. All these buffers are released at the end of
+# each module call. This test uses the hidden 'TempMemoryBenchmarkHelper' subfunction,
+# which every Python module has, to measure the cost of many such allocations and
+# releases within one call, and the cost of the final release at the end of the call.
+#
+# (c) 2026 agent - Licensed under MIT license.
+
+from psychtoolbox import GetSecs
+
+numcalls = 20
+
+
+def benchmark(name, numAllocs, maxSize, freeMode):
+    besttotal = 1e9
+    bestinner = 1e9
+    for i in range(numcalls):
+        t = GetSecs()
+        allocrate, inner = GetSecs('TempMemoryBenchmarkHelper', numAllocs, maxSize, freeMode)
+        total = GetSecs() - t
+        besttotal = min(besttotal, total)
+        bestinner = min(bestinner, inner)
+
+    print('%-40s: %7.1f nsecs per alloc, %7.1f nsecs per alloc incl. final release.' %
+          (name, bestinner / numAllocs * 1e9, besttotal / numAllocs * 1e9))
+
+
+def run():
+    benchmark('1000 small allocs, release at end', 1000, 256, 0)
+    benchmark('100000 small allocs, release at end', 100000, 256, 0)
+    benchmark('100000 small allocs, free each', 100000, 256, 1)
+    benchmark('20000 small allocs, free every 2nd', 20000, 256, 2)
+    benchmark('10000 medium allocs, release at end', 10000, 8192, 0)
+    benchmark('1000 huge allocs, release at end', 1000, 1024 * 1024, 0)
+
+
+if __name__ == '__main__':
+    run()
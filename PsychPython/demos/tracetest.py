@@ -0,0 +1,65 @@
+# tracetest.py - Test event tracing via the 'Trace' subfunction of the Psychtoolbox modules.
+#
+# Opens a pseudo-terminal as serial port with IOPort, with background reader thread,
+# then enables tracing in IOPort and sends data into the pseudo-terminal, so the reader
+# thread records an event for each received chunk of data. Then reads the recorded
+# events back via IOPort('Trace', 'Get'), and dumps them as Chrome trace JSON file,
+# with the (empty) trace of GetSecs appended, and checks the file is valid JSON. Load
+# the file into https://ui.perfetto.dev to view it. Only works on Linux and macOS.
+#
+# (c) 2026 agent - Licensed under MIT license.
+
+import os
+import json
+import time
+import tempfile
+from psychtoolbox import IOPort, GetSecs
+
+nchunks = 100
+
+
+def run():
+    master, slave = os.openpty()
+    port, errmsg = IOPort('OpenSerialPort', os.ttyname(slave), 'Lenient ReceiveTimeout=1 InputBufferSize=65536')
+
+    IOPort('Trace', 'Start', 1000)
+    IOPort('ConfigureSerialPort', port, 'Lenient BlockingBackgroundRead=1 StartBackgroundRead=1')
+
+    t0 = GetSecs()
+    for i in range(nchunks):
+        os.write(master, b'x')
+        time.sleep(0.002)
+
+    # Wait for reader thread to catch up:
+    t = GetSecs()
+    while IOPort('BytesAvailable', port) < nchunks and GetSecs() - t < 2:
+        time.sleep(0.01)
+
+    IOPort('ConfigureSerialPort', port, 'Lenient StopBackgroundRead')
+    IOPort('Trace', 'Stop')
+    enabled, numevents = IOPort('Trace')
+
+    events = IOPort('Trace', 'Get')
+    chunks = [e for e in events if e['name'] == 'ReadChunk']
+    print('Tracing enabled %i, %i events, %i ReadChunk events for %i written bytes.' % (enabled, numevents, len(chunks), nchunks))
+    if chunks:
+        print('First chunk %.3f msecs after start of writes, on thread %i.' % ((chunks[0]['timestamp'] - t0) * 1000, chunks[0]['thread']))
+
+    filename = os.path.join(tempfile.gettempdir(), 'ptbtrace.json')
+    n = IOPort('Trace', 'Dump', filename)
+    GetSecs('Trace', 'Start')
+    m = GetSecs('Trace', 'Dump', filename, 1)
+    GetSecs('Trace', 'Stop')
+
+    with open(filename) as f:
+        trace = json.load(f)
+
+    print('Dumped %i + %i events into %s, which holds %i valid JSON entries.' % (n, m, filename, len(trace)))
+
+    IOPort('Close', port)
+    os.close(master)
+    os.close(slave)
+
+
+if __name__ == '__main__':
+    run()
@@ -0,0 +1,75 @@
+# waitsecsbenchmark.py - Measure accuracy and cpu cost of precise waits via WaitSecs.
+#
+# WaitSecs('UntilTime') sleeps until shortly before its deadline, then busy-waits until
+# the deadline. On Linux, the busy-wait threshold is calibrated per thread and scheduling
+# class from the measured wakeup latency after sleep. This test runs a series of waits for
+# random intervals, and reports the lateness of wakeups after the deadline, the fraction of
+# the waiting time spent using the cpu, and the statistics of WaitSecs('Statistics').
+#
+# On Linux, it runs itself in a subprocess for clock_nanosleep() sleeps, for timerfd sleeps
+# as selected by environment variable PSYCH_WAITSECS_TIMERFD=1, and with boost to SCHED_FIFO
+# realtime scheduling during waits, as selected by PSYCH_WAITSECS_SCHEDFIFO=priority. The
+# latter needs permission for realtime scheduling.
+#
+# (c) 2026 agent - Licensed under MIT license.
+
+import os
+import sys
+import random
+import subprocess
+import time
+
+numwaits = 1000
+
+modes = [('clock_nanosleep', {}),
+         ('timerfd', {'PSYCH_WAITSECS_TIMERFD': '1'}),
+         ('clock_nanosleep + SCHED_FIFO', {'PSYCH_WAITSECS_SCHEDFIFO': '10'})]
+
+
+def measure(name):
+    from psychtoolbox import GetSecs, WaitSecs
+
+    # Warmup, to let the calibration settle:
+    for i in range(100):
+        WaitSecs('UntilTime', GetSecs() + 0.001)
+
+    stats = WaitSecs('Statistics', 1)
+
+    lateness = []
+    waited = 0
+    cpu = time.thread_time()
+    for i in range(numwaits):
+        interval = random.uniform(0.0005, 0.005)
+        deadline = GetSecs() + interval
+        wakeup = WaitSecs('UntilTime', deadline)
+        lateness.append(wakeup - deadline)
+        waited += interval
+    cpu = time.thread_time() - cpu
+
+    stats = WaitSecs('Statistics')
+    if isinstance(stats, list):
+        stats = stats[0]
+
+    lateness.sort()
+    print('%-30s: Lateness median %6.1f usecs, 99%% %6.1f usecs, max %7.1f usecs. Cpu busy %5.1f %%, spin %5.1f %%, misses %i.' %
+          (name, lateness[len(lateness) // 2] * 1e6, lateness[int(len(lateness) * 0.99)] * 1e6, lateness[-1] * 1e6,
+           100 * cpu / waited, 100 * stats['spinSecs'] / waited, stats['numMisses']))
+    print('%-30s  Threshold %6.1f usecs, wakeup latency %6.1f usecs, realtime %i, timerfd %i, fifoPriority %i.' %
+          ('', stats['thresholdSecs'] * 1e6, stats['wakeupLatencySecs'] * 1e6, stats['realtime'], stats['timerfd'], stats['fifoPriority']))
+
+
+def run():
+    if not sys.platform.startswith('linux'):
+        print('WaitSecs(\'Statistics\') is only supported on Linux.')
+        return
+
+    for name, options in modes:
+        env = dict(os.environ, **options)
+        subprocess.run([sys.executable, __file__, 'measure', name], env=env)
+
+
+if __name__ == '__main__':
+    if len(sys.argv) > 2 and sys.argv[1] == 'measure':
+        measure(sys.argv[2])
+    else:
+        run()
@@ -71,17 +71,19 @@ def get_devices(device_type=None, device_index=None):
 
 
 def tune_engine(yield_interval, mutex_enable, lock_to_core1,
-                audioserver_autosuspend):
+                audioserver_autosuspend, streamclock_tracking=[]):
     """Sets values for various advanced tuning parameters for the audio engine
 
     :param yield_interval:
     :param mutex_enable:
     :param lock_to_core1:
     :param audioserver_autosuspend:
-    :return: the 4 values in their final state
+    :param streamclock_tracking:
+    :return: the 5 values in their final state
     """
     return PsychPortAudio('EngineTunables', yield_interval, mutex_enable,
-                          lock_to_core1, audioserver_autosuspend)
+                          lock_to_core1, audioserver_autosuspend,
+                          streamclock_tracking)
 
 
 class Stream():
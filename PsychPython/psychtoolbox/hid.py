@@ -8,6 +8,12 @@ PsychHID('KbQueueStop' [, deviceIndex])
 [keyIsDown, firstKeyPressTimes, firstKeyReleaseTimes, lastKeyPressTimes, lastKeyReleaseTimes]=PsychHID('KbQueueCheck' [, deviceIndex])
 secs=PsychHID('KbTriggerWait', KeysUsage, [deviceNumber])
 [event, navail] = PsychHID('KbQueueGetEvent' [, deviceIndex][, maxWaitTimeSecs=0])
+[oldEnable, navail] = PsychHID('KbQueueMerge' [, enable][, numSlots=10000])
+[events, navail] = PsychHID('KbQueueGetMergedEvents' [, maxEvents=all][, maxWaitTimeSecs=0])
+numRecords = PsychHID('KbQueueJournal', deviceIndex [, filename][, numValuators])
+[events, info] = PsychHID('KbQueueJournalRead', filename [, startIndex=0][, maxEvents=all])
+results = PsychHID('KbQueueBenchmark', deviceIndex [, numEvents=1000000][, numValuators=0][, numSlots=10000])
+[stats, oldEnable] = PsychHID('KbQueueLatencyTrace', deviceIndex [, enable])
 
 
 Support for access to generic USB devices: See 'help ColorCal2' for one usage example:
@@ -11,6 +11,7 @@
  * - Anti-Aliased drawing via Alpha-Blending.
  * - Full Unicode support.
  * - Text measuring support, e.g., bounding boxes.
+ * - Access to rasterized glyph bitmaps, glyph metrics and kerning, for glyph atlas rendering in Screen().
  *
  * New style:   Includes our own - slightly modified - version of OGLFT.h/cpp for libglft support, thereby avoiding runtime
  *              dependencies on a properly configured & built libglft (Many binary installs of this library are built without unicode support).
@@ -151,6 +152,9 @@ OGLFT_API void PsychSetTextVerbosity(unsigned int verbosity);
 OGLFT_API void PsychSetTextAntiAliasing(int context, int antiAliasing);
 OGLFT_API void PsychSetAffineTransformMatrix(int context, double matrix[2][3]);
 OGLFT_API void PsychGetTextCursor(int context, double* xp, double* yp, double* height);
+OGLFT_API int PsychGetTextGlyph(int context, unsigned int charCode, float* xmin, float* ymin, float* xmax, float* ymax, float* xadvance,
+                                int* left, int* top, int* width, int* height, const unsigned char** bitmap);
+OGLFT_API int PsychGetTextKerning(int context, unsigned int leftCharCode, unsigned int rightCharCode, float* xkerning);
 
 fontCacheItem* getForContext(int contextId)
 {
@@ -667,6 +671,115 @@ int PsychMeasureText(int context, int textLen, double* text, float* xmin, float*
     return(0);
 }
 
+// Return metrics and rasterized bitmap of a single glyph for character charCode of the current font.
+// The metrics are the same as used by PsychMeasureText() for a single character. The bitmap is 8 bpp
+// alpha, top row first, tightly packed, with its top-left corner at offset (left, -top) from the pen
+// position on the baseline, with y pointing down. It is only valid until the next call and NULL for
+// empty glyphs, e.g., spaces. Characters without a glyph in the font return all zero metrics, like
+// in PsychMeasureText():
+int PsychGetTextGlyph(int context, unsigned int charCode, float* xmin, float* ymin, float* xmax, float* ymax, float* xadvance,
+                      int* left, int* top, int* width, int* height, const unsigned char** bitmap)
+{
+    static unsigned char* glyphBuffer = NULL;
+    static size_t glyphBufferSize = 0;
+    FT_UInt glyph_index;
+    FT_Glyph glyph;
+    FT_BBox ft_bbox;
+    FT_Bitmap* ft_bitmap;
+    unsigned char* src;
+    unsigned char* dst;
+    int x, y;
+
+    *xmin = *ymin = *xmax = *ymax = *xadvance = 0;
+    *left = *top = *width = *height = 0;
+    *bitmap = NULL;
+
+    fontCacheItem *fi = getForContext(context);
+    if (!fi) return(1);
+
+    glyph_index = FT_Get_Char_Index(fi->ft_face, charCode);
+    if (glyph_index == 0) return(0);
+
+    if (FT_Load_Glyph(fi->ft_face, glyph_index, FT_LOAD_DEFAULT) || FT_Get_Glyph(fi->ft_face->glyph, &glyph)) return(0);
+    FT_Glyph_Get_CBox(glyph, ft_glyph_bbox_unscaled, &ft_bbox);
+    FT_Done_Glyph(glyph);
+
+    *xmin = ft_bbox.xMin / 64.f;
+    *ymin = ft_bbox.yMin / 64.f;
+    *xmax = ft_bbox.xMax / 64.f;
+    *ymax = ft_bbox.yMax / 64.f;
+    *xadvance = fi->ft_face->glyph->advance.x / 64.f;
+
+    // Rasterize, anti-aliased or monochrome, as the OGLFT face of this font would do:
+    if ((fi->ft_face->glyph->format != FT_GLYPH_FORMAT_BITMAP) &&
+        FT_Render_Glyph(fi->ft_face->glyph, (fi->faceT) ? FT_RENDER_MODE_NORMAL : FT_RENDER_MODE_MONO)) {
+        if (_verbosity > 5) fprintf(stdout, "libptbdrawtext_ftgl: Failed to rasterize glyph for character %i.\n", charCode);
+        return(1);
+    }
+
+    ft_bitmap = &(fi->ft_face->glyph->bitmap);
+    *left = fi->ft_face->glyph->bitmap_left;
+    *top = fi->ft_face->glyph->bitmap_top;
+    if ((ft_bitmap->width == 0) || (ft_bitmap->rows == 0)) return(0);
+
+    if ((ft_bitmap->pixel_mode != FT_PIXEL_MODE_GRAY) && (ft_bitmap->pixel_mode != FT_PIXEL_MODE_MONO)) {
+        if (_verbosity > 5) fprintf(stdout, "libptbdrawtext_ftgl: Unsupported pixel mode %i of glyph for character %i.\n", (int) ft_bitmap->pixel_mode, charCode);
+        return(1);
+    }
+
+    if (glyphBufferSize < (size_t) ft_bitmap->width * ft_bitmap->rows) {
+        free(glyphBuffer);
+        glyphBufferSize = (size_t) ft_bitmap->width * ft_bitmap->rows;
+        glyphBuffer = (unsigned char*) malloc(glyphBufferSize);
+        if (!glyphBuffer) {
+            glyphBufferSize = 0;
+            return(1);
+        }
+    }
+
+    // Convert to tightly packed 8 bpp top-down, expanding monochrome bitmaps to 0 or 255:
+    for (y = 0; y < (int) ft_bitmap->rows; y++) {
+        src = ft_bitmap->buffer + ((ft_bitmap->pitch >= 0) ? y : ((int) ft_bitmap->rows - 1 - y)) * abs(ft_bitmap->pitch);
+        dst = glyphBuffer + (size_t) y * ft_bitmap->width;
+        if (ft_bitmap->pixel_mode == FT_PIXEL_MODE_GRAY) {
+            memcpy(dst, src, ft_bitmap->width);
+        }
+        else {
+            for (x = 0; x < (int) ft_bitmap->width; x++) dst[x] = (src[x >> 3] & (0x80 >> (x & 7))) ? 255 : 0;
+        }
+    }
+
+    *width = (int) ft_bitmap->width;
+    *height = (int) ft_bitmap->rows;
+    *bitmap = glyphBuffer;
+
+    return(0);
+}
+
+// Return horizontal kerning between the glyphs for characters leftCharCode and rightCharCode of the
+// current font, zero if the font has no kerning information:
+int PsychGetTextKerning(int context, unsigned int leftCharCode, unsigned int rightCharCode, float* xkerning)
+{
+    FT_Vector kerning;
+    FT_UInt left_index, right_index;
+
+    *xkerning = 0;
+
+    fontCacheItem *fi = getForContext(context);
+    if (!fi) return(1);
+
+    if (!FT_HAS_KERNING(fi->ft_face)) return(0);
+
+    left_index = FT_Get_Char_Index(fi->ft_face, leftCharCode);
+    right_index = FT_Get_Char_Index(fi->ft_face, rightCharCode);
+    if ((left_index == 0) || (right_index == 0)) return(0);
+
+    if (FT_Get_Kerning(fi->ft_face, left_index, right_index, FT_KERNING_DEFAULT, &kerning)) return(0);
+    *xkerning = kerning.x / 64.f;
+
+    return(0);
+}
+
 int PsychInitText(void)
 {
     _firstCall = true;
@@ -110,6 +110,10 @@ SOURCE=..\..\..\Source\Common\Base\PsychCellGlue.c
 # End Source File
 # Begin Source File
 
+SOURCE=..\..\..\Source\Common\Base\PsychClockDomains.c
+# End Source File
+# Begin Source File
+
 SOURCE=..\..\..\Source\Common\Base\PsychError.c
 # End Source File
 # Begin Source File
@@ -126,10 +130,6 @@ SOURCE=..\..\..\Source\Common\Base\PsychInit.c
 # End Source File
 # Begin Source File
 
-SOURCE=..\..\..\Source\Common\Base\PsychInstrument.c
-# End Source File
-# Begin Source File
-
 SOURCE=..\..\..\Source\Common\Base\PsychMemory.c
 # End Source File
 # Begin Source File
@@ -158,6 +158,10 @@ SOURCE=..\..\..\Source\Common\Base\PsychStructGlue.c
 # End Source File
 # Begin Source File
 
+SOURCE=..\..\..\Source\Common\Base\PsychTrace.c
+# End Source File
+# Begin Source File
+
 SOURCE=..\..\..\Source\windows\Screen\PsychTextureSupport.c
 # End Source File
 # Begin Source File
@@ -558,6 +562,10 @@ SOURCE=..\..\..\Source\Common\Base\PsychCellGlue.h
 # End Source File
 # Begin Source File
 
+SOURCE=..\..\..\Source\Common\Base\PsychClockDomains.h
+# End Source File
+# Begin Source File
+
 SOURCE=..\..\..\Source\Common\Base\PsychConstants.h
 # End Source File
 # Begin Source File
@@ -578,10 +586,6 @@ SOURCE=..\..\..\Source\Common\Base\PsychInit.h
 # End Source File
 # Begin Source File
 
-SOURCE=..\..\..\Source\Common\Base\PsychInstrument.h
-# End Source File
-# Begin Source File
-
 SOURCE=..\..\..\Source\Common\Base\PsychMemory.h
 # End Source File
 # Begin Source File
@@ -618,6 +622,10 @@ SOURCE=..\..\..\Source\Common\Base\PsychStructGlue.h
 # End Source File
 # Begin Source File
 
+SOURCE=..\..\..\Source\Common\Base\PsychTrace.h
+# End Source File
+# Begin Source File
+
 SOURCE=..\..\..\Source\windows\Screen\PsychTextureSupport.h
 # End Source File
 # Begin Source File
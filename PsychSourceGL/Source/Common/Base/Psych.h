@@ -40,7 +40,8 @@ extern "C" {
 #include "PsychInit.h"
 #include "PsychMemory.h"
 #include "PsychTimeGlue.h"
-#include "PsychInstrument.h"	
+#include "PsychClockDomains.h"
+#include "PsychTrace.h"
 
 #ifndef PTBINSCRIPTINGGLUE
 // This is provided by the project. We do not
@@ -0,0 +1,699 @@
+/*
+    Psychtoolbox3/Source/Common/PsychClockDomains.c
+
+    AUTHORS:
+
+    agent@local                     agent
+
+    PLATFORMS: All
+
+    PROJECTS: All
+
+    HISTORY:
+
+    10/18/26  agent Wrote it.
+
+    DESCRIPTION:
+
+    Registry of clock domains, ie. of clocks other than our GetSecs reference clock, and
+    of the mapping of their time to GetSecs time.
+
+    The mapping of a domain is refTime = offset + slope * foreignTime. It is estimated by
+    weighted linear regression from pairs of simultaneous samples of the foreign clock and
+    of GetSecs time, which modules or scripts add whenever they get one, e.g., from the
+    timestamps of each audio callback, or from replies of an external device to a time query.
+    Built-in domains, like the system wall clock, have a sampler function instead, which gets
+    called to take a new pair of samples whenever the mapping is used and older than 0.25 secs.
+
+    The regression is incremental, with exponential forgetting of old samples over a window of
+    at least 64 samples and 30 seconds, so it follows slow changes of drift, e.g., due to NTP
+    slewing or temperature. Each sample is weighted by
+    its own uncertainty, e.g., the time between the two GetSecs reads bracketing the read of
+    the foreign clock. Samples whose residual exceeds 4 standard deviations of the residuals
+    of previous samples get rejected as outliers, e.g., due to preemption of the thread which
+    collected them. If many successive samples get rejected, the foreign clock jumped, so the
+    mapping restarts from scratch. While the samples only span a short time, the slope stays
+    close to the nominal rate of the foreign clock, instead of being dominated by noise.
+
+    All state is per module. Mapping a timestamp is a constant time operation, protected by a
+    per-domain mutex. Realtime threads, e.g., audio callbacks, must use the PsychTryXXX variants
+    of the functions, which skip the operation instead of waiting if the mutex is busy, so they
+    can't get blocked by a lower priority thread which holds the mutex.
+    The mutex of each slot lives as long as the registry, so removal of a domain can't pull it
+    out from under a thread which is just using the domain.
+*/
+
+#include "Psych.h"
+
+// Effective number of samples in the regression window, and its minimum duration in secs of GetSecs time:
+#define kPsychClockDomainWindow         64.0
+#define kPsychClockDomainWindowSecs     30.0
+// Weight of a sample with zero uncertainty corresponds to an uncertainty of 1 usec:
+#define kPsychClockDomainMinUncertainty 0.000001
+// Minimum tolerance for outlier rejection:
+#define kPsychClockDomainMinTolerance   0.000005
+// Number of samples before outlier rejection starts, and number of successive rejects which trigger a restart:
+#define kPsychClockDomainMinSamples     8
+// Resampling interval for built-in domains with a sampler function:
+#define kPsychClockDomainResampleSecs   0.25
+
+typedef struct PsychClockDomain {
+    psych_bool              used;
+    char                    name[64];
+    double                  nominalSlope;   // Nominal GetSecs seconds per foreign clock unit.
+    PsychClockDomainSampler sampler;        // Sampler for built-in domains, NULL otherwise.
+    psych_bool              byScript;       // Domain was created by script via 'ClockDomains' subfunction.
+    psych_mutex             mutex;
+
+    // Anchor point of the regression: All sums are over sample coordinates relative to the anchor, for precision:
+    double                  x0, y0;
+
+    // Exponentially weighted sums over samples of weight, squared weight, x, y, x*x and x*y:
+    double                  sw, sw2, sx, sy, sxx, sxy;
+
+    // Moving averages of the squared residuals, and of the squared uncertainties of samples:
+    double                  residualVar, sampleVar;
+
+    // Current fit: refTime = ycenter + slope * ((foreignTime - x0) - xmean):
+    double                  xmean, ycenter, slope;
+
+    double                  lastX;          // Foreign time of last accepted sample.
+    double                  lastSampleTime; // GetSecs time of last accepted sample.
+    double                  lastAttemptTime;// GetSecs time of last call of the sampler.
+    unsigned int            numSamples, numRejected, numSuccessiveRejects;
+} PsychClockDomain;
+
+static PsychClockDomain clockDomains[kPsychMaxClockDomains];
+static psych_mutex      clockDomainsMutex;
+static psych_bool       clockDomainsInitialized = FALSE;
+
+// Sampler for the system wall clock: Bracket a read of the wall clock by two reads of GetSecs, best of three:
+static psych_bool PsychSampleRealtimeClock(double* foreignTime, double* refTime, double* uncertainty)
+{
+    double t1, t2, t, best = 1e9;
+    int i;
+
+    for (i = 0; i < 3; i++) {
+        PsychGetAdjustedPrecisionTimerSeconds(&t1);
+        t = PsychGetWallClockSeconds();
+        PsychGetAdjustedPrecisionTimerSeconds(&t2);
+
+        if (t2 - t1 < best) {
+            best = t2 - t1;
+            *foreignTime = t;
+            *refTime = (t1 + t2) / 2;
+        }
+    }
+
+    *uncertainty = best / 2;
+
+    return(TRUE);
+}
+
+// Sampler for the monotonic clock:
+static psych_bool PsychSampleMonotonicClock(double* foreignTime, double* refTime, double* uncertainty)
+{
+    #if PSYCH_SYSTEM == PSYCH_LINUX
+        // CLOCK_MONOTONIC. The mapping is exact if our timebase is CLOCK_MONOTONIC, otherwise
+        // PsychOSMonotonicToRefTime() bounds its error to 20 usecs:
+        *foreignTime = PsychOSGetLinuxMonotonicTime();
+        *refTime = PsychOSMonotonicToRefTime(*foreignTime);
+        *uncertainty = (PsychOSGetTimebase(NULL, NULL, NULL) == kPsychTimebaseMonotonic) ? 0 : 0.00001;
+    #else
+        // GetSecs time is monotonic time on other systems:
+        PsychGetAdjustedPrecisionTimerSeconds(refTime);
+        *foreignTime = *refTime;
+        *uncertainty = 0;
+    #endif
+
+    return(TRUE);
+}
+
+void PsychInitClockDomains(void)
+{
+    int i;
+
+    if (clockDomainsInitialized)
+        return;
+
+    memset(clockDomains, 0, sizeof(clockDomains));
+    PsychInitMutex(&clockDomainsMutex);
+    for (i = 0; i < kPsychMaxClockDomains; i++)
+        PsychInitMutex(&clockDomains[i].mutex);
+    clockDomainsInitialized = TRUE;
+
+    // Register built-in domains. They get the first slots, matching kPsychClockDomainXXX:
+    PsychRegisterClockDomain("realtime", 1.0, PsychSampleRealtimeClock);
+    PsychRegisterClockDomain("monotonic", 1.0, PsychSampleMonotonicClock);
+}
+
+void PsychExitClockDomains(void)
+{
+    int i;
+
+    if (!clockDomainsInitialized)
+        return;
+
+    for (i = 0; i < kPsychMaxClockDomains; i++)
+        PsychUnregisterClockDomain(i);
+
+    for (i = 0; i < kPsychMaxClockDomains; i++)
+        PsychDestroyMutex(&clockDomains[i].mutex);
+
+    PsychDestroyMutex(&clockDomainsMutex);
+    clockDomainsInitialized = FALSE;
+}
+
+// Return clock domain with its mutex locked, or NULL if there isn't any, or if 'tryOnly' and
+// the mutex is busy. Checks again under the lock, as the domain might get removed concurrently:
+static PsychClockDomain* PsychLockClockDomain(int domain, psych_bool tryOnly)
+{
+    PsychClockDomain* d;
+
+    if (!clockDomainsInitialized || (domain < 0) || (domain >= kPsychMaxClockDomains) || !clockDomains[domain].used)
+        return(NULL);
+
+    d = &clockDomains[domain];
+    if (tryOnly) {
+        if (PsychTryLockMutex(&d->mutex))
+            return(NULL);
+    }
+    else {
+        PsychLockMutex(&d->mutex);
+    }
+
+    if (!d->used) {
+        PsychUnlockMutex(&d->mutex);
+        return(NULL);
+    }
+
+    return(d);
+}
+
+static void PsychResetClockDomainLocked(PsychClockDomain* d)
+{
+    d->x0 = d->y0 = 0;
+    d->sw = d->sw2 = d->sx = d->sy = d->sxx = d->sxy = 0;
+    d->residualVar = d->sampleVar = 0;
+    d->xmean = d->ycenter = 0;
+    d->slope = d->nominalSlope;
+    d->lastX = d->lastSampleTime = d->lastAttemptTime = 0;
+    d->numSamples = d->numRejected = d->numSuccessiveRejects = 0;
+}
+
+// Register a new clock domain 'name', whose clock nominally runs at 'unitsPerSecond' units per second of GetSecs time,
+// with an optional 'sampler' function for built-in domains. Returns the domain handle, or -1 if no free slot is left.
+// If a domain of the same name exists, its handle is returned instead:
+int PsychRegisterClockDomain(const char* name, double unitsPerSecond, PsychClockDomainSampler sampler)
+{
+    PsychClockDomain* d;
+    int i, domain = -1;
+
+    if (!clockDomainsInitialized)
+        PsychInitClockDomains();
+
+    PsychLockMutex(&clockDomainsMutex);
+
+    for (i = 0; (i < kPsychMaxClockDomains) && (domain < 0); i++)
+        if (clockDomains[i].used && !strcmp(clockDomains[i].name, name))
+            domain = i;
+
+    for (i = 0; (i < kPsychMaxClockDomains) && (domain < 0); i++) {
+        if (!clockDomains[i].used) {
+            d = &clockDomains[i];
+            PsychLockMutex(&d->mutex);
+            snprintf(d->name, sizeof(d->name), "%s", name);
+            d->nominalSlope = (unitsPerSecond > 0) ? 1.0 / unitsPerSecond : 1.0;
+            d->sampler = sampler;
+            d->byScript = FALSE;
+            PsychResetClockDomainLocked(d);
+            d->used = TRUE;
+            PsychUnlockMutex(&d->mutex);
+            domain = i;
+        }
+    }
+
+    PsychUnlockMutex(&clockDomainsMutex);
+
+    return(domain);
+}
+
+void PsychUnregisterClockDomain(int domain)
+{
+    PsychClockDomain* d;
+
+    PsychLockMutex(&clockDomainsMutex);
+
+    // Mark the slot unused under its mutex, so users of the domain either finish first, or see it gone:
+    if ((d = PsychLockClockDomain(domain, FALSE))) {
+        d->used = FALSE;
+        PsychUnlockMutex(&d->mutex);
+    }
+
+    PsychUnlockMutex(&clockDomainsMutex);
+}
+
+// Return handle of the clock domain with the given 'name', or -1 if there isn't any:
+int PsychFindClockDomain(const char* name)
+{
+    int i, domain = -1;
+
+    if (!clockDomainsInitialized)
+        return(-1);
+
+    PsychLockMutex(&clockDomainsMutex);
+
+    for (i = 0; (i < kPsychMaxClockDomains) && (domain < 0); i++)
+        if (clockDomains[i].used && !strcmp(clockDomains[i].name, name))
+            domain = i;
+
+    PsychUnlockMutex(&clockDomainsMutex);
+
+    return(domain);
+}
+
+// Discard all samples of a clock domain, e.g., because its clock got reset:
+void PsychResetClockDomain(int domain)
+{
+    PsychClockDomain* d;
+
+    if (!(d = PsychLockClockDomain(domain, FALSE)))
+        return;
+
+    PsychResetClockDomainLocked(d);
+    PsychUnlockMutex(&d->mutex);
+}
+
+// Compute fit from the weighted sums:
+static void PsychFitClockDomainLocked(PsychClockDomain* d)
+{
+    double mx, my, vxx, cxy, k;
+
+    mx = d->sx / d->sw;
+    my = d->sy / d->sw;
+    vxx = d->sxx / d->sw - mx * mx;
+    cxy = d->sxy / d->sw - mx * my;
+    if (vxx < 0) vxx = 0;
+
+    // Ridge regression towards the nominal slope, with a prior as strong as samples
+    // spanning 10 msecs, so samples spanning only a short time can't cause wild slopes:
+    k = 0.0001 / (d->nominalSlope * d->nominalSlope);
+    d->slope = (cxy + k * d->nominalSlope) / (vxx + k);
+
+    d->xmean = mx;
+    d->ycenter = d->y0 + my;
+}
+
+static psych_bool PsychAddClockDomainSampleLocked(PsychClockDomain* d, double foreignTime, double refTime, double uncertainty)
+{
+    double lambda, r = 0, alpha, tolerance, w, dx, dy, a, b;
+    unsigned int rejected;
+
+    if (!(uncertainty >= 0))
+        uncertainty = 0;
+
+    // Rate of moving averages of residuals: Plain averages until the window is full:
+    alpha = (d->numSamples + 1 < kPsychClockDomainWindow) ? 1.0 / (double) (d->numSamples + 1) : 1.0 / kPsychClockDomainWindow;
+
+    if (d->numSamples > 0) {
+        // Residual of new sample against current fit:
+        r = refTime - (d->ycenter + d->slope * ((foreignTime - d->x0) - d->xmean));
+
+        if (d->numSamples >= kPsychClockDomainMinSamples) {
+            tolerance = 4 * sqrt(d->residualVar) + 3 * uncertainty;
+            if (tolerance < kPsychClockDomainMinTolerance) tolerance = kPsychClockDomainMinTolerance;
+
+            if (fabs(r) > tolerance) {
+                // Outlier: Reject, but let it widen the tolerance as if it were a sample at half the tolerance,
+                // so the tolerance can't shrink indefinitely under heavy tailed noise:
+                d->numRejected++;
+                d->residualVar += alpha * (tolerance * tolerance / 4 - d->residualVar);
+
+                // Many successive outliers mean the foreign clock jumped. Restart from this sample:
+                if (++d->numSuccessiveRejects < kPsychClockDomainMinSamples)
+                    return(FALSE);
+
+                rejected = d->numRejected;
+                PsychResetClockDomainLocked(d);
+                d->numRejected = rejected;
+                r = 0;
+                alpha = 1;
+            }
+        }
+    }
+
+    if (d->numSamples == 0) {
+        // First sample becomes the anchor:
+        d->x0 = foreignTime;
+        d->y0 = refTime;
+    }
+    else if (fabs((foreignTime - d->x0) * d->nominalSlope) > 1000) {
+        // Move anchor to the weighted mean of the samples once it is far away, to keep the sums precise:
+        a = d->sx / d->sw;
+        b = d->sy / d->sw;
+        d->sxy += a * b * d->sw - a * d->sy - b * d->sx;
+        d->sxx += a * a * d->sw - 2 * a * d->sx;
+        d->sx -= a * d->sw;
+        d->sy -= b * d->sw;
+        d->x0 += a;
+        d->y0 += b;
+    }
+
+    dx = foreignTime - d->x0;
+    dy = refTime - d->y0;
+
+    // Forgetting factor: The window spans at least the given number of samples, and at least the given
+    // time, so densely spaced samples, e.g., from audio callbacks, still span enough time to estimate drift:
+    lambda = exp(-(refTime - d->lastSampleTime) / kPsychClockDomainWindowSecs);
+    if (lambda < 1.0 - 1.0 / kPsychClockDomainWindow) lambda = 1.0 - 1.0 / kPsychClockDomainWindow;
+    if (lambda > 1.0) lambda = 1.0;
+
+    // Weight by uncertainty of the sample:
+    w = (kPsychClockDomainMinUncertainty * kPsychClockDomainMinUncertainty) /
+        (uncertainty * uncertainty + kPsychClockDomainMinUncertainty * kPsychClockDomainMinUncertainty);
+
+    d->sw  = lambda * d->sw + w;
+    d->sw2 = lambda * lambda * d->sw2 + w * w;
+    d->sx  = lambda * d->sx + w * dx;
+    d->sy  = lambda * d->sy + w * dy;
+    d->sxx = lambda * d->sxx + w * dx * dx;
+    d->sxy = lambda * d->sxy + w * dx * dy;
+
+    d->residualVar += alpha * (r * r - d->residualVar);
+    d->sampleVar += alpha * (uncertainty * uncertainty - d->sampleVar);
+
+    d->lastX = foreignTime;
+    d->lastSampleTime = refTime;
+    d->numSamples++;
+    d->numSuccessiveRejects = 0;
+
+    PsychFitClockDomainLocked(d);
+
+    return(TRUE);
+}
+
+// Add pair of simultaneous samples 'foreignTime' of the domains clock and 'refTime' of GetSecs time,
+// with optional 'uncertainty' of their pairing in seconds. Returns TRUE if accepted, FALSE if rejected:
+psych_bool PsychAddClockDomainSample(int domain, double foreignTime, double refTime, double uncertainty)
+{
+    PsychClockDomain* d;
+    psych_bool rc;
+
+    if (!(d = PsychLockClockDomain(domain, FALSE)))
+        return(FALSE);
+
+    rc = PsychAddClockDomainSampleLocked(d, foreignTime, refTime, uncertainty);
+    PsychUnlockMutex(&d->mutex);
+
+    return(rc);
+}
+
+// Same as PsychAddClockDomainSample(), but for realtime threads: Skips the sample and returns FALSE if the domain is busy:
+psych_bool PsychTryAddClockDomainSample(int domain, double foreignTime, double refTime, double uncertainty)
+{
+    PsychClockDomain* d;
+    psych_bool rc;
+
+    if (!(d = PsychLockClockDomain(domain, TRUE)))
+        return(FALSE);
+
+    rc = PsychAddClockDomainSampleLocked(d, foreignTime, refTime, uncertainty);
+    PsychUnlockMutex(&d->mutex);
+
+    return(rc);
+}
+
+// Take a new sample for a built-in domain, if its last one is too old:
+static void PsychUpdateClockDomainLocked(PsychClockDomain* d)
+{
+    double now, foreignTime, refTime, uncertainty;
+
+    if (!d->sampler)
+        return;
+
+    PsychGetAdjustedPrecisionTimerSeconds(&now);
+    if ((d->numSamples > 0) && (now - d->lastAttemptTime < kPsychClockDomainResampleSecs))
+        return;
+
+    d->lastAttemptTime = now;
+    if ((*(d->sampler))(&foreignTime, &refTime, &uncertainty))
+        PsychAddClockDomainSampleLocked(d, foreignTime, refTime, uncertainty);
+}
+
+// Map 'foreignTime' of a locked clock domain to GetSecs time:
+static double PsychClockDomainToRefTimeLocked(PsychClockDomain* d, double foreignTime)
+{
+    PsychUpdateClockDomainLocked(d);
+    return((d->numSamples > 0) ? d->ycenter + d->slope * ((foreignTime - d->x0) - d->xmean) : PsychGetNanValue());
+}
+
+// Map 'foreignTime' of a clock domain to GetSecs time. Returns NaN for invalid domains, or domains without samples:
+double PsychClockDomainToRefTime(int domain, double foreignTime)
+{
+    PsychClockDomain* d;
+    double refTime;
+
+    if (!(d = PsychLockClockDomain(domain, FALSE)))
+        return(PsychGetNanValue());
+
+    refTime = PsychClockDomainToRefTimeLocked(d, foreignTime);
+    PsychUnlockMutex(&d->mutex);
+
+    return(refTime);
+}
+
+// Same as PsychClockDomainToRefTime(), but for realtime threads: Returns NaN if the domain is busy:
+double PsychTryClockDomainToRefTime(int domain, double foreignTime)
+{
+    PsychClockDomain* d;
+    double refTime;
+
+    if (!(d = PsychLockClockDomain(domain, TRUE)))
+        return(PsychGetNanValue());
+
+    refTime = PsychClockDomainToRefTimeLocked(d, foreignTime);
+    PsychUnlockMutex(&d->mutex);
+
+    return(refTime);
+}
+
+// Map GetSecs time 'refTime' to time of a clock domain. Returns NaN for invalid domains, or domains without samples:
+double PsychRefTimeToClockDomain(int domain, double refTime)
+{
+    PsychClockDomain* d;
+    double foreignTime;
+
+    if (!(d = PsychLockClockDomain(domain, FALSE)))
+        return(PsychGetNanValue());
+
+    PsychUpdateClockDomainLocked(d);
+    foreignTime = (d->numSamples > 0) ? d->x0 + d->xmean + (refTime - d->ycenter) / d->slope : PsychGetNanValue();
+    PsychUnlockMutex(&d->mutex);
+
+    return(foreignTime);
+}
+
+// Return current state of the mapping of a clock domain in 'mapping'. Returns FALSE for invalid domains:
+psych_bool PsychGetClockDomainMapping(int domain, PsychClockMapping* mapping)
+{
+    PsychClockDomain* d;
+    double vxx, neff, dx, sd2;
+
+    if (!(d = PsychLockClockDomain(domain, FALSE)))
+        return(FALSE);
+
+    PsychUpdateClockDomainLocked(d);
+
+    memset(mapping, 0, sizeof(*mapping));
+    mapping->name = d->name;
+    mapping->slope = d->slope;
+    mapping->drift = d->slope / d->nominalSlope - 1;
+    mapping->residualSD = sqrt(d->residualVar);
+    mapping->lastSampleTime = d->lastSampleTime;
+    mapping->numSamples = d->numSamples;
+    mapping->numRejected = d->numRejected;
+    mapping->builtin = (d->sampler) ? TRUE : FALSE;
+
+    if (d->numSamples > 0) {
+        mapping->offset = d->ycenter - d->slope * (d->x0 + d->xmean);
+
+        // Standard error of the mapped GetSecs time at the most recent sample, from the noise of
+        // the samples and the effective number and spread of samples in the regression window:
+        sd2 = (d->residualVar > d->sampleVar) ? d->residualVar : d->sampleVar;
+        neff = d->sw * d->sw / d->sw2;
+        vxx = d->sxx / d->sw - d->xmean * d->xmean;
+        if (vxx < 0) vxx = 0;
+        dx = (d->lastX - d->x0) - d->xmean;
+        mapping->uncertainty = sqrt(sd2 * (1 / neff + dx * dx / (neff * vxx + 0.0001 / (d->nominalSlope * d->nominalSlope))));
+    }
+    else {
+        mapping->offset = mapping->uncertainty = PsychGetNanValue();
+    }
+
+    PsychUnlockMutex(&d->mutex);
+
+    return(TRUE);
+}
+
+PsychError PsychClockDomainsSubfunction(void)
+{
+    static char useString[] = "domains = Modulename('ClockDomains');\n"
+                              "[getSecsTimes, uncertainty] = Modulename('ClockDomains', 'ToGetSecs', domainName, foreignTimes);\n"
+                              "foreignTimes = Modulename('ClockDomains', 'FromGetSecs', domainName, getSecsTimes);\n"
+                              "numAccepted = Modulename('ClockDomains', 'AddSamples', domainName, foreignTimes, getSecsTimes [, uncertainties][, unitsPerSecond=1]);\n"
+                              "Modulename('ClockDomains', 'Reset', domainName);\n"
+                              "Modulename('ClockDomains', 'Remove', domainName);";
+    //                          1
+    static char synopsisString[] =
+        "Query and use the clock domains of this module.\n\n"
+        "A clock domain is a clock other than the GetSecs clock, e.g., the system wall clock, the sample "
+        "clock of a sound card, or the clock of an external device like an eye tracker. For each domain, "
+        "the module keeps a mapping 'getSecsTime = offset + slope * foreignTime' to GetSecs time, estimated "
+        "via robust linear regression from pairs of simultaneous samples of the foreign clock and of GetSecs "
+        "time. The mapping follows slow drift of the clocks against each other, rejects outlier samples, and "
+        "restarts if the foreign clock jumps. Built-in domains 'realtime' (the system wall clock) and "
+        "'monotonic' (CLOCK_MONOTONIC on Linux, GetSecs time on other systems) sample their clocks "
+        "automatically. Modules may register additional domains, e.g., PsychPortAudio for the clocks of "
+        "audio devices.\n\n"
+        "Without a command, returns a struct array 'domains' with the state of all domains: Their 'name', "
+        "'offset', 'slope', 'drift' relative to the nominal clock rate, 'residualSD' standard deviation of "
+        "the residuals of samples, 'uncertainty' standard error of mapped times at the most recent sample, "
+        "all in seconds, 'lastSampleTime' GetSecs time of the most recent sample, 'numSamples' number of "
+        "accepted samples, 'numRejected' number of rejected outliers, and 'builtin' 1 for built-in domains.\n\n"
+        "'ToGetSecs' maps a vector of 'foreignTimes' of domain 'domainName' to GetSecs time, and returns the "
+        "current 'uncertainty' of the mapping.\n\n"
+        "'FromGetSecs' maps a vector of 'getSecsTimes' to time of domain 'domainName'.\n\n"
+        "'AddSamples' adds pairs of samples 'foreignTimes' and 'getSecsTimes' to domain 'domainName', "
+        "creating the domain if it doesn't exist yet. Built-in domains and domains of the module itself "
+        "can't be fed this way. Use it, e.g., when you read a timestamp of a device clock, and "
+        "timestamps of sending the query and of receiving the reply. Optional 'uncertainties' are the "
+        "uncertainties of the pairing of each sample, e.g., half the roundtrip time of the query, so precise "
+        "samples get more weight. Optional 'unitsPerSecond' is the nominal rate of the foreign clock, e.g., "
+        "1000 for a clock in msecs, only used when creating a domain. Returns the number of accepted samples.\n\n"
+        "'Reset' discards all samples of domain 'domainName'. 'Remove' deletes domain 'domainName'. Both only "
+        "work on domains created via 'AddSamples'.\n";
+    static char seeAlsoString[] = "";
+
+    const char *FieldNames[] = { "name", "offset", "slope", "drift", "residualSD", "uncertainty", "lastSampleTime",
+                                 "numSamples", "numRejected", "builtin" };
+    PsychGenericScriptType *domains;
+    PsychClockMapping mapping;
+    char *cmd = NULL, *name = NULL;
+    double *foreignTimes, *refTimes, *uncertainties, *out;
+    double unitsPerSecond = 1;
+    int m, n, p, m2, n2, p2, i, j, count, domain;
+
+    // All sub functions should have these two lines:
+    PsychPushHelp(useString, synopsisString, seeAlsoString);
+    if (PsychIsGiveHelp()) { PsychGiveHelp(); return(PsychError_none); };
+
+    PsychErrorExit(PsychCapNumOutputArgs(2));
+    PsychErrorExit(PsychCapNumInputArgs(6));
+
+    if (!clockDomainsInitialized)
+        PsychInitClockDomains();
+
+    if (!PsychAllocInCharArg(1, kPsychArgOptional, &cmd)) {
+        // No command: Return state of all domains:
+        for (i = 0, count = 0; i < kPsychMaxClockDomains; i++)
+            if (clockDomains[i].used) count++;
+
+        PsychAllocOutStructArray(1, kPsychArgOptional, count, 10, FieldNames, &domains);
+        for (i = 0, j = 0; (i < kPsychMaxClockDomains) && (j < count); i++) {
+            if (!PsychGetClockDomainMapping(i, &mapping))
+                continue;
+
+            PsychSetStructArrayStringElement("name", j, (char*) mapping.name, domains);
+            PsychSetStructArrayDoubleElement("offset", j, mapping.offset, domains);
+            PsychSetStructArrayDoubleElement("slope", j, mapping.slope, domains);
+            PsychSetStructArrayDoubleElement("drift", j, mapping.drift, domains);
+            PsychSetStructArrayDoubleElement("residualSD", j, mapping.residualSD, domains);
+            PsychSetStructArrayDoubleElement("uncertainty", j, mapping.uncertainty, domains);
+            PsychSetStructArrayDoubleElement("lastSampleTime", j, mapping.lastSampleTime, domains);
+            PsychSetStructArrayDoubleElement("numSamples", j, (double) mapping.numSamples, domains);
+            PsychSetStructArrayDoubleElement("numRejected", j, (double) mapping.numRejected, domains);
+            PsychSetStructArrayDoubleElement("builtin", j, (double) mapping.builtin, domains);
+            j++;
+        }
+
+        return(PsychError_none);
+    }
+
+    PsychAllocInCharArg(2, kPsychArgRequired, &name);
+    domain = PsychFindClockDomain(name);
+
+    if (PsychMatch(cmd, "AddSamples")) {
+        PsychAllocInDoubleMatArg(3, kPsychArgRequired, &m, &n, &p, &foreignTimes);
+        PsychAllocInDoubleMatArg(4, kPsychArgRequired, &m2, &n2, &p2, &refTimes);
+        count = m * n * p;
+        if (m2 * n2 * p2 != count)
+            PsychErrorExitMsg(PsychError_user, "'foreignTimes' and 'getSecsTimes' must have the same number of elements.");
+
+        uncertainties = NULL;
+        if (PsychAllocInDoubleMatArg(5, kPsychArgOptional, &m2, &n2, &p2, &uncertainties) && (m2 * n2 * p2 != count))
+            PsychErrorExitMsg(PsychError_user, "'uncertainties' must have the same number of elements as 'foreignTimes'.");
+
+        PsychCopyInDoubleArg(6, kPsychArgOptional, &unitsPerSecond);
+        if (!(unitsPerSecond > 0))
+            PsychErrorExitMsg(PsychError_user, "'unitsPerSecond' must be greater than zero.");
+
+        if (domain < 0) {
+            if ((domain = PsychRegisterClockDomain(name, unitsPerSecond, NULL)) < 0)
+                PsychErrorExitMsg(PsychError_user, "Could not create new clock domain. Too many domains.");
+            clockDomains[domain].byScript = TRUE;
+        }
+        else if (!clockDomains[domain].byScript) {
+            // Built-in and module domains are fed by their owner only, so scripts can't corrupt their mapping:
+            PsychErrorExitMsg(PsychError_user, "Samples can only be added to clock domains created via 'AddSamples'.");
+        }
+
+        for (i = 0, j = 0; i < count; i++)
+            if (PsychAddClockDomainSample(domain, foreignTimes[i], refTimes[i], (uncertainties) ? uncertainties[i] : 0))
+                j++;
+
+        PsychCopyOutDoubleArg(1, kPsychArgOptional, (double) j);
+        return(PsychError_none);
+    }
+
+    if (domain < 0)
+        PsychErrorExitMsg(PsychError_user, "No such clock domain.");
+
+    if (PsychMatch(cmd, "ToGetSecs") || PsychMatch(cmd, "FromGetSecs")) {
+        PsychAllocInDoubleMatArg(3, kPsychArgRequired, &m, &n, &p, &foreignTimes);
+        PsychAllocOutDoubleMatArg(1, kPsychArgOptional, m, n, p, &out);
+        count = m * n * p;
+
+        if (PsychMatch(cmd, "ToGetSecs")) {
+            for (i = 0; i < count; i++)
+                out[i] = PsychClockDomainToRefTime(domain, foreignTimes[i]);
+        }
+        else {
+            for (i = 0; i < count; i++)
+                out[i] = PsychRefTimeToClockDomain(domain, foreignTimes[i]);
+        }
+
+        PsychGetClockDomainMapping(domain, &mapping);
+        PsychCopyOutDoubleArg(2, kPsychArgOptional, mapping.uncertainty);
+        return(PsychError_none);
+    }
+
+    if (PsychMatch(cmd, "Reset")) {
+        if (!clockDomains[domain].byScript)
+            PsychErrorExitMsg(PsychError_user, "Only clock domains created via 'AddSamples' can be reset.");
+
+        PsychResetClockDomain(domain);
+        return(PsychError_none);
+    }
+
+    if (PsychMatch(cmd, "Remove")) {
+        if (!clockDomains[domain].byScript)
+            PsychErrorExitMsg(PsychError_user, "Only clock domains created via 'AddSamples' can be removed.");
+
+        PsychUnregisterClockDomain(domain);
+        return(PsychError_none);
+    }
+
+    PsychErrorExitMsg(PsychError_user, "Unknown command.");
+
+    return(PsychError_none);
+}
@@ -0,0 +1,75 @@
+/*
+  Psychtoolbox/Source/Common/PsychClockDomains.h
+
+  AUTHORS:
+
+  agent@local                       agent
+
+  PLATFORMS: All
+
+  PROJECTS: All
+
+  HISTORY:
+
+  10/18/26  agent   Wrote it.
+
+  DESCRIPTION:
+
+  Registry of clock domains, ie. clocks other than our GetSecs reference clock, like the
+  system wall clock, CLOCK_MONOTONIC, the sample clock of a sound card, or the clock of an
+  external device like an eye tracker. Each domain holds a linear mapping of its time to
+  GetSecs time, with offset and drift, which is updated incrementally from pairs of samples
+  of both clocks via robust weighted linear regression, so timestamps can be converted in
+  constant time, and the uncertainty of the mapping can be queried.
+
+*/
+
+//begin include once
+#ifndef PSYCH_IS_INCLUDED_PsychClockDomains
+#define PSYCH_IS_INCLUDED_PsychClockDomains
+
+#include "Psych.h"
+
+// Built-in clock domains, registered at module init time:
+#define kPsychClockDomainRealtime       0   // System wall clock, ie. gettimeofday(), seconds since 1.1.1970.
+#define kPsychClockDomainMonotonic      1   // Linux CLOCK_MONOTONIC, GetSecs time itself on other systems.
+
+// Maximum number of clock domains per module:
+#define kPsychMaxClockDomains           32
+
+// Sampler function of a clock domain: Returns a pair of simultaneous samples of the foreign clock in
+// 'foreignTime' and of GetSecs time in 'refTime', with the uncertainty of the pairing in seconds:
+typedef psych_bool (*PsychClockDomainSampler)(double* foreignTime, double* refTime, double* uncertainty);
+
+// Current state of the mapping of a clock domain:
+typedef struct PsychClockMapping {
+    const char*     name;           // Name of domain.
+    double          slope;          // GetSecs seconds per foreign clock unit.
+    double          offset;         // GetSecs time at foreign time zero, ie. refTime = offset + slope * foreignTime.
+    double          drift;          // Relative drift against GetSecs clock: slope / nominal slope - 1.
+    double          residualSD;     // Standard deviation of residuals of accepted samples, in seconds.
+    double          uncertainty;    // Standard error of mapped GetSecs time, at most recent sample, in seconds.
+    double          lastSampleTime; // GetSecs time of most recent accepted sample.
+    unsigned int    numSamples;     // Number of accepted samples since last reset.
+    unsigned int    numRejected;    // Number of samples rejected as outliers since last reset.
+    psych_bool      builtin;        // Domain is updated by a sampler function.
+} PsychClockMapping;
+
+void        PsychInitClockDomains(void);
+void        PsychExitClockDomains(void);
+int         PsychRegisterClockDomain(const char* name, double unitsPerSecond, PsychClockDomainSampler sampler);
+void        PsychUnregisterClockDomain(int domain);
+int         PsychFindClockDomain(const char* name);
+void        PsychResetClockDomain(int domain);
+psych_bool  PsychAddClockDomainSample(int domain, double foreignTime, double refTime, double uncertainty);
+psych_bool  PsychTryAddClockDomainSample(int domain, double foreignTime, double refTime, double uncertainty);
+double      PsychClockDomainToRefTime(int domain, double foreignTime);
+double      PsychTryClockDomainToRefTime(int domain, double foreignTime);
+double      PsychRefTimeToClockDomain(int domain, double refTime);
+psych_bool  PsychGetClockDomainMapping(int domain, PsychClockMapping* mapping);
+
+// Implementation of the 'ClockDomains' subfunction, which modules can register to expose their clock domains:
+PsychError  PsychClockDomainsSubfunction(void);
+
+//end include once
+#endif
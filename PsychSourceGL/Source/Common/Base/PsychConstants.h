@@ -67,10 +67,13 @@
 #endif
 
 #if PSYCH_LANGUAGE == PSYCH_PYTHON
+    // Print via Python, or defer output until the end of a blocking region without the GIL:
+    void PsychPythonPrintf(const char* format, ...);
+    void PsychPythonErrPrintf(const char* format, ...);
     #undef printf
-    #define printf PySys_WriteStdout
+    #define printf PsychPythonPrintf
     #undef fprintf
-    #define fprintf(fdignore, ...) PySys_WriteStderr(__VA_ARGS__)
+    #define fprintf(fdignore, ...) PsychPythonErrPrintf(__VA_ARGS__)
 #endif
 
 //platform dependent macro defines
@@ -189,6 +192,13 @@ typedef unsigned char        psych_bool;
     typedef pthread_t     psych_threadid;
 #endif
 
+// Storage class for thread-local variables:
+#ifdef _MSC_VER
+    #define PSYCH_THREADLOCAL __declspec(thread)
+#else
+    #define PSYCH_THREADLOCAL __thread
+#endif
+
 #if PSYCH_LANGUAGE == PSYCH_MATLAB
     typedef const mxArray CONSTmxArray;
     #define PsychGenericScriptType mxArray
@@ -14,6 +14,8 @@
 
   08/25/02  awi     wrote it.
   03/24/08  mk      Add call to PsychExitTimeGlue() and some cleanup.
+  10/18/26  agent   Add init and shutdown of clock domain registry.
+  10/18/26  agent   Add init and shutdown of event tracing.
 
   DESCRIPTION:
 
@@ -42,6 +44,8 @@ PsychError PsychInit(void)
     InitPsychError();
     InitPsychAuthorList();
     PsychInitTimeGlue();
+    PsychInitClockDomains();
+    PsychInitTrace();
 
     // Registration of the Psychtoolbox exit function is
     // done in PsychScriptingGlueXXX.c because how that is done is
@@ -67,6 +71,8 @@ PsychError PsychExit(void)
     if (projectExit != NULL) (*projectExit)();
 
     // Put whatever cleanup of the Psychtoolbox is required here.
+    PsychExitTrace();
+    PsychExitClockDomains();
     PsychExitTimeGlue();
 
     // Reset / Clear function and module name registry:
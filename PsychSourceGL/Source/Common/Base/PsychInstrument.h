@@ -1,30 +0,0 @@
-/*
-  PsychToolbox2/Source/Common/PsychInstrument.h		
-    
-  AUTHORS:
-  Allen.Ingling@nyu.edu		awi 
-  
-  PLATFORMS:	This file should compile on all platforms.
-    
-
-  HISTORY:
-  3/18/04  awi		Created. 
- 
-  
-*/
-
-//begin include once 
-#ifndef PSYCH_IS_INCLUDED_PsychInstrument
-#define PSYCH_IS_INCLUDED_PsychInstrument
-
-#include "Psych.h"
-
-void	PsychPushClock(void);
-double  PsychPopClock(void);
-
-
-
-
-//end include once
-#endif
-	
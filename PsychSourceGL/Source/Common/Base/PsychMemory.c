@@ -14,17 +14,12 @@
 
     09/04/02  awi   Wrote it.
     03/19/11  mk    Make 64-bit clean.
+    10/18/26  agent Arena allocator with per call level release for our own temp memory manager.
 
 */
 
 #include "Psych.h"
 
-// Pointer to the start of our list of allocated temporary memory buffers:
-static size_t* PsychTempMemHead = NULL;
-
-// Total count of allocated memory in Bytes:
-static size_t totalTempMemAllocated = 0;
-
 // Convert a double value (which encodes a memory address) into a ptr:
 void*  PsychDoubleToPtr(volatile double dptr)
 {
@@ -72,170 +67,314 @@ void *PsychMallocTemp(size_t n)
 #else
 
 // If not running on Matlab, we use our own allocator...
+//
+// Temporary memory is allocated from an arena of fixed size chunks via a simple bump allocator.
+// Each module call pushes a new level via PsychPushTempMemoryLevel() at entry, remembering the
+// current fill position of the arena. PsychFreeAllTempMemory() at the end of the call rolls the
+// arena back to that position, which releases all temporary memory of the call in O(1), without
+// touching memory of outer levels in case of recursive calls. Chunks which are no longer needed
+// are kept on a free list for reuse by future calls, so a typical module call doesn't need any
+// malloc() or free() calls at all. Huge buffers which wouldn't fit well into a chunk are allocated
+// via malloc() and kept in a doubly linked list instead, so they can be freed in O(1) as well.
+
+// Size of a standard arena chunk, including its header:
+#define PSYCH_TEMPMEM_CHUNKSIZE (64 * 1024)
+
+// Allocations bigger than this go directly to malloc():
+#define PSYCH_TEMPMEM_MAXARENASIZE (PSYCH_TEMPMEM_CHUNKSIZE / 4)
+
+// Maximum number of unused chunks to keep around for reuse:
+#define PSYCH_TEMPMEM_MAXSPARECHUNKS 16
+
+// Maximum number of nested temp memory levels, ie. module call recursion levels:
+#define PSYCH_TEMPMEM_MAXLEVELS 16
+
+// All buffers are aligned to this size:
+#define PSYCH_TEMPMEM_ALIGN 16
+#define PTBTEMPMEMALIGN(n) (((n) + PSYCH_TEMPMEM_ALIGN - 1) & ~((size_t) PSYCH_TEMPMEM_ALIGN - 1))
+
+// Header of an arena chunk:
+typedef struct PsychTempMemChunk {
+    struct PsychTempMemChunk*   prev;   // Previously used chunk, or next spare chunk on free list.
+    size_t                      used;   // Number of used bytes in the chunk, including this header.
+} PsychTempMemChunk;
+
+// Header in front of each temporary memory buffer:
+typedef struct PsychTempMemHeader {
+    struct PsychTempMemHeader*  prev;   // Neighbours in the list of malloc()'ed buffers. Unused for arena buffers.
+    struct PsychTempMemHeader*  next;
+    size_t                      size;   // Size of the buffer in bytes, including this header.
+    int                         level;  // Temp memory level at time of allocation.
+    int                         kind;   // One of the PSYCH_TEMPMEM_KIND_* below.
+} PsychTempMemHeader;
+
+#define PSYCH_TEMPMEM_KIND_ARENA  1
+#define PSYCH_TEMPMEM_KIND_MALLOC 2
+#define PSYCH_TEMPMEM_KIND_FREED  3
+
+#define PSYCH_TEMPMEM_CHUNKHDRSIZE PTBTEMPMEMALIGN(sizeof(PsychTempMemChunk))
+#define PSYCH_TEMPMEM_HDRSIZE PTBTEMPMEMALIGN(sizeof(PsychTempMemHeader))
+
+// Saved arena state at start of a temp memory level:
+typedef struct PsychTempMemMark {
+    PsychTempMemChunk*  chunk;
+    size_t              used;
+} PsychTempMemMark;
+
+// Currently used arena chunk and list of spare chunks for reuse:
+static PsychTempMemChunk* PsychTempMemChunkHead = NULL;
+static PsychTempMemChunk* PsychTempMemSpareChunks = NULL;
+static int numTempMemSpareChunks = 0;
+
+// Most recently allocated buffer of our list of malloc()'ed buffers:
+static PsychTempMemHeader* PsychTempMemHead = NULL;
+
+// Stack of temp memory levels:
+static PsychTempMemMark tempMemMarks[PSYCH_TEMPMEM_MAXLEVELS];
+static size_t tempMemLevelArenaBytes[PSYCH_TEMPMEM_MAXLEVELS + 1];
+static int tempMemLevel = 0;
+static int tempMemLevelOverflow = 0;
+
+// Total count of allocated memory in Bytes:
+static size_t totalTempMemAllocated = 0;
 
 #define PTBTEMPMEMDEC(n) totalTempMemAllocated -=(n)
 
-// Enqueues a new record into our linked list of temp. memory buffers.
-// Returns the memory pointer to be passed to rest of Psychtoolbox.
-static void* PsychEnqueueTempMemory(size_t* p, size_t n)
+// Allocate 'n' bytes from the arena, 'n' including the header and properly aligned.
+// Returns NULL if out of memory:
+static PsychTempMemHeader* PsychArenaAllocTempMemory(size_t n)
 {
-    // Add current buffer-head ptr as next-pointer to our new buffer:
-    *p = (size_t) PsychTempMemHead;
+    PsychTempMemChunk* chunk = PsychTempMemChunkHead;
+    PsychTempMemHeader* hdr;
+
+    // Need a new chunk?
+    if (!chunk || (chunk->used + n > PSYCH_TEMPMEM_CHUNKSIZE)) {
+        if (PsychTempMemSpareChunks) {
+            // Recycle a spare chunk:
+            chunk = PsychTempMemSpareChunks;
+            PsychTempMemSpareChunks = chunk->prev;
+            numTempMemSpareChunks--;
+        }
+        else if (NULL == (chunk = (PsychTempMemChunk*) malloc(PSYCH_TEMPMEM_CHUNKSIZE))) {
+            return(NULL);
+        }
+
+        chunk->prev = PsychTempMemChunkHead;
+        chunk->used = PSYCH_TEMPMEM_CHUNKHDRSIZE;
+        PsychTempMemChunkHead = chunk;
+    }
+
+    hdr = (PsychTempMemHeader*) ((unsigned char*) chunk + chunk->used);
+    chunk->used += n;
+
+    hdr->kind = PSYCH_TEMPMEM_KIND_ARENA;
+    tempMemLevelArenaBytes[tempMemLevel] += n;
+
+    return(hdr);
+}
+
+// Allocates a new temporary memory buffer for 'n' user-visible bytes, either from the
+// arena, or via malloc(). Returns the memory pointer to be passed to rest of Psychtoolbox:
+static void* PsychAllocTempMemory(size_t n, psych_bool zeroed)
+{
+    PsychTempMemHeader* hdr;
+
+    // Add some extra bytes for our little header and for alignment of the next buffer. Check
+    // for wraparound due to absurd sizes:
+    if (n > (size_t) -1 - PSYCH_TEMPMEM_HDRSIZE - PSYCH_TEMPMEM_ALIGN)
+        PsychErrorExitMsg(PsychError_outofMemory, NULL);
+
+    n = PTBTEMPMEMALIGN(n + PSYCH_TEMPMEM_HDRSIZE);
 
-    // Set our buffer as new head of list:
-    PsychTempMemHead = p;
+    if (n <= PSYCH_TEMPMEM_MAXARENASIZE) {
+        if (NULL == (hdr = PsychArenaAllocTempMemory(n)))
+            PsychErrorExitMsg(PsychError_outofMemory, NULL);
+
+        if (zeroed)
+            memset((unsigned char*) hdr + PSYCH_TEMPMEM_HDRSIZE, 0, n - PSYCH_TEMPMEM_HDRSIZE);
+    }
+    else {
+        if (NULL == (hdr = (PsychTempMemHeader*) ((zeroed) ? calloc((size_t) 1, n) : malloc(n))))
+            PsychErrorExitMsg(PsychError_outofMemory, NULL);
+
+        // Enqueue as new head of our list of malloc()'ed buffers:
+        hdr->kind = PSYCH_TEMPMEM_KIND_MALLOC;
+        hdr->prev = NULL;
+        hdr->next = PsychTempMemHead;
+        if (PsychTempMemHead)
+            PsychTempMemHead->prev = hdr;
+        PsychTempMemHead = hdr;
+    }
 
-    // Add allocated buffer size as 2nd element:
-    p++;
-    *p = n;
+    hdr->size = n;
+    hdr->level = tempMemLevel;
 
     // Accounting:
     totalTempMemAllocated += n;
-    // printf("TEMPMALLOCED %i Bytes,  new = %i.\n", n, totalTempMemAllocated); fflush(NULL);
-
-    // Increment p again to get real start of user-visible buffer:
-    p++;
 
-    // Return ptr:
-    return((void*) p);
+    // Return ptr to real start of user-visible buffer:
+    return((void*) ((unsigned char*) hdr + PSYCH_TEMPMEM_HDRSIZE));
 }
 
 void *PsychCallocTemp(size_t n, size_t size)
 {
-    size_t *ret;
-
     // MK: This could create an overflow if product n * size is
     // bigger than length of a unsigned long int --> Only
     // happens if more than 4 GB of RAM are allocated at once.
     // --> Improbable for PTB, unless someones trying a buffer
     // overflow attack -- PTB would lose there badly anyway...
-    size_t realsize = n * size + sizeof(void*) + sizeof(size_t);
-
-    // realsize has extra bytes allocated for our little header...  
-    if (NULL == (ret = (size_t*) calloc((size_t) 1, realsize))) {
-        PsychErrorExitMsg(PsychError_outofMemory, NULL);
-    }
-
-    // Need to enqueue memory buffer...
-    return(PsychEnqueueTempMemory(ret, realsize));
+    return(PsychAllocTempMemory(n * size, TRUE));
 }
 
 void *PsychMallocTemp(size_t n)
 {
-    size_t *ret;
-
-    // Allocate some extra bytes for our little header...
-    n = n + sizeof(void*) + sizeof(size_t);
-
-    if (NULL == (ret = (size_t*) malloc(n))) {
-        PsychErrorExitMsg(PsychError_outofMemory,NULL);
-    }
-
-    // Need to enqueue memory buffer...
-    return(PsychEnqueueTempMemory(ret, n));
+    return(PsychAllocTempMemory(n, FALSE));
 }
 
-// Free a single spec'd temp memory buffer.
-// TODO Note: The current implementation of our allocator
-// uses a single-linked list, which has O(1) cost for
-// allocating memory (Optimal!) and O(n) cost for freeing
-// all allocated memory (Optimal!), but it has up to
-// O(n) cost for deleting a single memory buffer as well,
-// be n the total number of allocated buffers. This is
-// worst-case upper bound. If PsychFreeTemp() is used a
-// lot on long buffer lists, this will incur significant
-// overhead! A better implementation would use a double-
-// linked list or even a binary tree or hash structure,
-// but for now this has to be good enough(TM).
+// Free a single spec'd temp memory buffer. This has O(1) cost. Buffers
+// allocated via malloc() are released immediately. Arena buffers are
+// only released for real if they are the most recently allocated buffer
+// in the arena, otherwise their memory is reclaimed at the end of the
+// current module call.
 void PsychFreeTemp(void* inptr)
 {
-    size_t *ptr = (size_t*) inptr;
-    size_t *ptrbackup = ptr;
-    size_t *next = PsychTempMemHead;
-    size_t *prevptr = NULL;
+    PsychTempMemHeader* hdr;
 
-    if (ptr == NULL)
+    if (inptr == NULL)
         return;
 
     // Convert ptb supplied pointer (in)ptr into real start
     // of our buffer, including our header:
-    ptr-= 2;
+    hdr = (PsychTempMemHeader*) ((unsigned char*) inptr - PSYCH_TEMPMEM_HDRSIZE);
 
-    if (ptr == NULL)
-        return;
+    if (hdr->kind == PSYCH_TEMPMEM_KIND_MALLOC) {
+        // Dequeue from list of malloc()'ed buffers:
+        if (hdr->prev)
+            hdr->prev->next = hdr->next;
+        else
+            PsychTempMemHead = hdr->next;
 
-    if (PsychTempMemHead == ptr) {
-        // Special case: ptr is first buffer in queue. Dequeue:
-        PsychTempMemHead = (size_t*) *PsychTempMemHead;
+        if (hdr->next)
+            hdr->next->prev = hdr->prev;
 
         // Some accounting:
-        PTBTEMPMEMDEC(ptr[1]);
+        PTBTEMPMEMDEC(hdr->size);
 
         // Release it:
-        free(ptr);
+        free(hdr);
 
         return;
     }
 
-    // ptr valid and not first buffer in queue.
-    // Walk the whole buffer list until we encounter our buffer:
-    while (next != NULL && next != ptr) {
-        prevptr = next;
-        next = (size_t*) *next;
-    }
-
-    // Done with search loop. Did we find our buffer?
-    if (next == ptr) {
-        // Found it! Set next-ptr of previous buffer to next-ptr
-        // of this buffer to dequeue from list:
-        *prevptr = *next;
-
+    if (hdr->kind == PSYCH_TEMPMEM_KIND_ARENA) {
         // Some accounting:
-        PTBTEMPMEMDEC(next[1]);
+        PTBTEMPMEMDEC(hdr->size);
+        tempMemLevelArenaBytes[hdr->level] -= hdr->size;
+        hdr->kind = PSYCH_TEMPMEM_KIND_FREED;
 
-        // Release:
-        free(ptr);
+        // Most recent allocation in the arena? Then we can give back its space right away:
+        if (PsychTempMemChunkHead && ((unsigned char*) hdr + hdr->size == (unsigned char*) PsychTempMemChunkHead + PsychTempMemChunkHead->used))
+            PsychTempMemChunkHead->used -= hdr->size;
 
-        // Done.
         return;
     }
 
-    // Oops.: Did not find matching buffer to pointer --> Trouble!
-    printf("PTB-BUG: In PsychFreeTemp: Tried to free non-existent temporary membuffer %p!!! Ignored.\n", ptrbackup);
+    // Oops.: Not a valid or already freed buffer --> Trouble!
+    printf("PTB-BUG: In PsychFreeTemp: Tried to free non-existent temporary membuffer %p!!! Ignored.\n", inptr);
     fflush(NULL);
     return;
 }
 
-// Master cleanup routine: Frees all allocated memory:
+// Start a new temp memory level at entry of a module call. The following
+// PsychFreeAllTempMemory() only frees memory allocated from now on:
+void PsychPushTempMemoryLevel(void)
+{
+    if (tempMemLevel >= PSYCH_TEMPMEM_MAXLEVELS) {
+        // Memory of this level will simply get released together with the
+        // parent level. Our caller limits the recursion depth well below
+        // PSYCH_TEMPMEM_MAXLEVELS, so this is just a safety net:
+        tempMemLevelOverflow++;
+        return;
+    }
+
+    tempMemMarks[tempMemLevel].chunk = PsychTempMemChunkHead;
+    tempMemMarks[tempMemLevel].used = (PsychTempMemChunkHead) ? PsychTempMemChunkHead->used : 0;
+    tempMemLevel++;
+    tempMemLevelArenaBytes[tempMemLevel] = 0;
+}
+
+// Master cleanup routine: Frees all memory allocated since the last
+// PsychPushTempMemoryLevel() and ends that level. Frees all allocated
+// memory if this ends the outermost level:
 void PsychFreeAllTempMemory(void)
 {
-    size_t* p = NULL;
-    size_t* next = PsychTempMemHead;
+    PsychTempMemHeader* hdr;
+    PsychTempMemChunk* chunk;
+    PsychTempMemMark mark;
+    int level, i;
 
-    // Walk our whole buffer list and release all buffers on it:
-    while (next != NULL) {
-        // next points to current buffer to release. Make a copy of
-        // next:
-        p = next;
+    if (tempMemLevelOverflow > 0) {
+        tempMemLevelOverflow--;
+        return;
+    }
 
-        // Update next to point to the next buffer to release:
-        next = (size_t*) *p;
+    // Oldest level to release. The outermost level also takes memory
+    // allocated outside of any level with it:
+    level = (tempMemLevel > 1) ? tempMemLevel : 0;
+    if (level > 0) {
+        mark = tempMemMarks[level - 1];
+    }
+    else {
+        mark.chunk = NULL;
+        mark.used = 0;
+    }
+
+    // Release all malloc()'ed buffers of this level. They are at the start of the list:
+    while (PsychTempMemHead && (PsychTempMemHead->level >= level)) {
+        hdr = PsychTempMemHead;
+        PsychTempMemHead = hdr->next;
+        if (PsychTempMemHead)
+            PsychTempMemHead->prev = NULL;
 
         // Some accounting:
-        PTBTEMPMEMDEC(p[1]);
+        PTBTEMPMEMDEC(hdr->size);
 
-        // Release buffer p:
-        free(p);
+        // Release buffer:
+        free(hdr);
+    }
 
-        // We're done with this buffer, next points to next one to release
-        // or is NULL if all released...
+    // Roll back the arena to its state at start of this level, putting all
+    // chunks which were used since then onto the spare list, or releasing
+    // them if we already have enough spares:
+    while (PsychTempMemChunkHead && (PsychTempMemChunkHead != mark.chunk)) {
+        chunk = PsychTempMemChunkHead;
+        PsychTempMemChunkHead = chunk->prev;
+
+        if (numTempMemSpareChunks < PSYCH_TEMPMEM_MAXSPARECHUNKS) {
+            chunk->prev = PsychTempMemSpareChunks;
+            PsychTempMemSpareChunks = chunk;
+            numTempMemSpareChunks++;
+        }
+        else {
+            free(chunk);
+        }
     }
 
-    // Done. NULL-out the list start ptr:
-    PsychTempMemHead = NULL;
+    if (PsychTempMemChunkHead)
+        PsychTempMemChunkHead->used = mark.used;
+
+    // Some accounting:
+    for (i = level; i <= tempMemLevel; i++) {
+        PTBTEMPMEMDEC(tempMemLevelArenaBytes[i]);
+        tempMemLevelArenaBytes[i] = 0;
+    }
+
+    // Done with this level:
+    if (tempMemLevel > 0)
+        tempMemLevel--;
 
     // Sanity check:
-    if (totalTempMemAllocated != 0) {
+    if ((tempMemLevel == 0) && (totalTempMemAllocated != 0)) {
         // Cannot use PsychErrorXXX Routines here, because this is outside
         // the jumpbuffer context for our error-routines. Could lead to
         // infinite recursion!!!
@@ -250,4 +389,72 @@ void PsychFreeAllTempMemory(void)
     return;
 }
 
+// Microbenchmark of the temp memory allocator, registered by the scripting glue:
+PsychError PsychTempMemoryBenchmark(void)
+{
+    static char useString[] = "[allocsPerSec, elapsedSecs] = Modulename('TempMemoryBenchmarkHelper' [, numAllocs=100000][, maxSize=256][, freeMode=0]);";
+    static char synopsisString[] = "Benchmark the allocator for temporary memory buffers of this module.\n"
+                                   "Allocates 'numAllocs' temporary memory buffers of random size between 1 and 'maxSize' Bytes, "
+                                   "like subfunctions do for their input arguments and scratch buffers.\n"
+                                   "'freeMode' 0 = Only release all buffers at return from the call. 1 = Release each buffer "
+                                   "right after allocation. 2 = Release every 2nd buffer, oldest first, after all allocations.\n"
+                                   "Returns the rate of allocations per second, and the total elapsed time in seconds for allocation "
+                                   "and optional release. Time for the final release of all remaining buffers at return from the "
+                                   "call is not included, but can be measured from the calling script.\n";
+    static char seeAlsoString[] = "";
+
+    int             numAllocs = 100000, maxSize = 256, freeMode = 0, i;
+    unsigned int    seed = 1;
+    size_t          n;
+    void            **buffers;
+    double          tStart, tEnd;
+
+    // All subfunctions should have these two lines:
+    PsychPushHelp(useString, synopsisString, seeAlsoString);
+    if (PsychIsGiveHelp()) { PsychGiveHelp(); return(PsychError_none); };
+
+    PsychErrorExit(PsychCapNumInputArgs(3));
+    PsychErrorExit(PsychCapNumOutputArgs(2));
+
+    PsychCopyInIntegerArg(1, kPsychArgOptional, &numAllocs);
+    if (numAllocs < 1)
+        PsychErrorExitMsg(PsychError_user, "Invalid 'numAllocs' specified. Must be at least 1.");
+
+    PsychCopyInIntegerArg(2, kPsychArgOptional, &maxSize);
+    if (maxSize < 1)
+        PsychErrorExitMsg(PsychError_user, "Invalid 'maxSize' specified. Must be at least 1.");
+
+    PsychCopyInIntegerArg(3, kPsychArgOptional, &freeMode);
+    if (freeMode < 0 || freeMode > 2)
+        PsychErrorExitMsg(PsychError_user, "Invalid 'freeMode' specified. Must be 0, 1 or 2.");
+
+    buffers = (void**) PsychMallocTemp(sizeof(void*) * (size_t) numAllocs);
+
+    PsychGetAdjustedPrecisionTimerSeconds(&tStart);
+
+    for (i = 0; i < numAllocs; i++) {
+        // Simple LCG for reproducible buffer sizes:
+        seed = seed * 1103515245U + 12345U;
+        n = 1 + (size_t) ((seed >> 8) % (unsigned int) maxSize);
+
+        buffers[i] = PsychMallocTemp(n);
+        ((unsigned char*) buffers[i])[0] = (unsigned char) i;
+
+        if (freeMode == 1)
+            PsychFreeTemp(buffers[i]);
+    }
+
+    if (freeMode == 2) {
+        for (i = 0; i < numAllocs; i += 2)
+            PsychFreeTemp(buffers[i]);
+    }
+
+    PsychGetAdjustedPrecisionTimerSeconds(&tEnd);
+
+    PsychCopyOutDoubleArg(1, kPsychArgOptional, (double) numAllocs / (tEnd - tStart));
+    PsychCopyOutDoubleArg(2, kPsychArgOptional, tEnd - tStart);
+
+    return(PsychError_none);
+}
+
 #endif
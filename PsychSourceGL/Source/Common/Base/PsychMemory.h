@@ -15,6 +15,7 @@
   09/04/02  awi     Wrote it.
   05/10/06  mk      Added our own allocator for Octave-Port.
   03/19/11  mk      Make 64-bit clean.  
+  10/18/26  agent   Arena allocator with per call level release.
 
 */
 
@@ -45,9 +46,16 @@ void *PsychMallocTemp(size_t n);
 // the memory anyway when returning control to Matlab/Octave et al.
 void PsychFreeTemp(void* inptr);
 
-// Master cleanup routine: Frees all allocated memory.
+// Start a new level of temp memory at entry of a module call.
+void PsychPushTempMemoryLevel(void);
+
+// Master cleanup routine: Frees all memory allocated since the last
+// PsychPushTempMemoryLevel() and ends that level.
 void PsychFreeAllTempMemory(void);
 
+// Microbenchmark of the temp memory allocator, registered by the scripting glue:
+PsychError PsychTempMemoryBenchmark(void);
+
 #endif
 
 //allocate memory which is valid while the module is loaded
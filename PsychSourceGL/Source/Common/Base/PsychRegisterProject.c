@@ -11,6 +11,7 @@
 
   HISTORY:
   8/23/02  awi		Created. 
+  10/18/26 agent		Hashed subfunction name lookup.
  
 */
 
@@ -25,10 +26,18 @@ static char *currentFunctionNameREGISTER;
 static int numFunctionsREGISTER = 0;
 static psych_bool nameRegistered = FALSE;
 
+// Open addressing hash table for subfunction name lookup by PsychGetProjectFunction(). Each
+// slot stores the index + 1 of an entry in functionTableREGISTER, or 0 for an empty slot. The
+// table is sized to a power of two of at least twice PSYCH_MAX_FUNCTIONS, so it never fills up
+// and linear probe sequences stay short:
+#define PSYCH_FUNCTION_HASH_SIZE (4 * PSYCH_MAX_FUNCTIONS)
+static int functionHashREGISTER[PSYCH_FUNCTION_HASH_SIZE];
+
 
 //file static function declarations
 static PsychError PsychRegisterModuleName(char *name);
 static PsychError PsychRegisterBase(PsychFunctionPtr baseFunc);
+static unsigned int PsychHashFunctionName(const char *name);
 
 /* PsychResetRegistry()
  *
@@ -44,6 +53,7 @@ void PsychResetRegistry(void)
     numFunctionsREGISTER = 0;
     nameRegistered = FALSE;
     memset(&functionTableREGISTER[0], 0, sizeof(functionTableREGISTER));
+    memset(&functionHashREGISTER[0], 0, sizeof(functionHashREGISTER));
 }
 
 /*  This function is called by the special subfunction 'DescribeModuleFunctionsHelper'.
@@ -118,6 +128,7 @@ PsychError PsychDescribeModuleFunctions(void)
 PsychError PsychRegister(char *name,  PsychFunctionPtr func)
 {
 	int i;
+	unsigned int h;
 
 	//check to see if name is null which means we register the module base function.  
 	if(name==NULL){
@@ -146,6 +157,11 @@ PsychError PsychRegister(char *name,  PsychFunctionPtr func)
 	if(strlen(name) > PSYCH_MAX_FUNCTION_NAME_LENGTH)
 		return(PsychError_longString);
 	strcpy(functionTableREGISTER[numFunctionsREGISTER].name, name);
+
+	//enter it into the first free slot of its probe sequence in the lookup hash table
+	for(h = PsychHashFunctionName(name); functionHashREGISTER[h]; h = (h + 1) & (PSYCH_FUNCTION_HASH_SIZE - 1));
+	functionHashREGISTER[h] = numFunctionsREGISTER + 1;
+
 	++numFunctionsREGISTER;
 	PsychEnableSubfunctions();
 	return(PsychError_none);
@@ -170,6 +186,7 @@ PsychError PsychRegisterExit(PsychFunctionPtr exitFunc)
 PsychFunctionPtr PsychGetProjectFunction(char *command)
 {
 	int i; 
+	unsigned int h;
 
 	//return the project base function
 	if(command==NULL){
@@ -183,8 +200,10 @@ PsychFunctionPtr PsychGetProjectFunction(char *command)
 	}else
 		PsychClearGiveHelp();
 	
-	//lookup the function in the table
-	for(i=0;i<numFunctionsREGISTER;i++){
+	//lookup the function in the table. Names which PsychMatch() considers equal have the same hash,
+	//so walking the probe sequence until the first empty slot finds the same entry as a linear scan.
+	for(h = PsychHashFunctionName(command); functionHashREGISTER[h]; h = (h + 1) & (PSYCH_FUNCTION_HASH_SIZE - 1)){
+		i = functionHashREGISTER[h] - 1;
 		if(PsychMatch(functionTableREGISTER[i].name, command)){
 			currentFunctionNameREGISTER = functionTableREGISTER[i].name;
 			return(functionTableREGISTER[i].function);
@@ -257,3 +276,19 @@ static PsychError PsychRegisterBase(PsychFunctionPtr baseFunc)
 		
 	return(PsychError_none);
 }
+
+/*
+	Return the slot of a subfunction name in the lookup hash table. FNV-1a hash of the lower case
+	version of the name, so lookups work regardless if PsychMatch() is case sensitive or not.
+*/
+static unsigned int PsychHashFunctionName(const char *name)
+{
+	unsigned int h = 2166136261U;
+
+	while(*name){
+		h ^= (unsigned int) tolower((unsigned char) *name++);
+		h *= 16777619U;
+	}
+
+	return(h & (PSYCH_FUNCTION_HASH_SIZE - 1));
+}
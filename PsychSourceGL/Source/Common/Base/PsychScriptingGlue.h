@@ -69,6 +69,16 @@ const char* PsychRuntimeGetPsychtoolboxRoot(psych_bool getConfigDir);
 // which case Fortran layout is the thing.
 psych_bool PsychUseCMemoryLayoutIfOptimal(psych_bool tryEnableCMemoryLayout);
 
+// Mark begin and end of a region of a subfunction which may block for a long time, e.g., waiting
+// for time to pass, for input data or for a device to start. Scripting environments with a global
+// interpreter lock, ie. Python, release that lock inside such regions, so other interpreter threads
+// can run in parallel. Code inside the region must not touch any scripting objects, ie. not call any
+// Psych*Arg functions. printf() is fine, but its output only shows up at the end of the region under
+// Python. Error exits via PsychErrorExit() et al. are allowed. Regions can't nest, an inner region
+// ends the outer one. No-ops for Matlab and Octave.
+void PsychBeginBlockingRegion(void);
+void PsychEndBlockingRegion(void);
+
 //for memory pointers (void*):
 psych_bool PsychCopyInPointerArg(int position, PsychArgRequirementType isRequired, void **ptr);
 psych_bool PsychCopyOutPointerArg(int position, PsychArgRequirementType isRequired, void* ptr);
@@ -92,6 +102,11 @@ psych_bool PsychCopyOutDoubleArg(int position, PsychArgRequirementType isRequire
 psych_bool PsychAllocOutDoubleArg(int position, PsychArgRequirementType isRequired, double **value);
 psych_bool PsychAllocOutDoubleMatArg(int position, PsychArgRequirementType isRequired, psych_int64 m, psych_int64 n, psych_int64 p, double **array);
 psych_bool PsychCopyOutDoubleMatArg(int position, PsychArgRequirementType isRequired, psych_int64 m, psych_int64 n, psych_int64 p, double *fromArray);
+
+//for matrices of any of a set of numeric types, passed through in their native type:
+psych_bool PsychAllocInNativeMatArg64(int position, PsychArgRequirementType isRequired, PsychArgFormatType acceptedTypes,
+                                      psych_int64 *m, psych_int64 *n, psych_int64 *p, PsychArgFormatType *type, void **array);
+
 // PsychAllocateNativeXXXMat() is for use with cell arrays and structs. The right way to do this is to use the normal function for returning
 // values, detect if the position is -1, and if so accept the optional "nativeElement" value.
 void PsychAllocateNativeDoubleMat(psych_int64 m, psych_int64 n, psych_int64 p, double **cArray, PsychGenericScriptType **nativeElement);
@@ -101,6 +116,11 @@ void PsychAllocateNativeUnsignedByteMat(psych_int64 m, psych_int64 n, psych_int6
 psych_bool PsychCopyOutUnsignedInt16MatArg(int position, PsychArgRequirementType isRequired, psych_int64 m, psych_int64 n, psych_int64 p, psych_uint16 *fromArray);
 psych_bool PsychAllocOutUnsignedInt16MatArg(int position, PsychArgRequirementType isRequired, psych_int64 m, psych_int64 n, psych_int64 p, psych_uint16 **array);
 
+// for uint8 or uint16 matrices in external memory, returned without copy where the scripting environment allows it:
+typedef void (*PsychExternalMatReleaseFunc)(void* releaseArg);
+psych_bool PsychCopyOutExternalMatArg(int position, PsychArgRequirementType isRequired, psych_int64 m, psych_int64 n, psych_int64 p,
+                                      PsychArgFormatType type, void *fromArray, PsychExternalMatReleaseFunc releaseFunc, void *releaseArg);
+
 //for psych_bool.  These should be consolidated with the flags below.
 psych_bool PsychAllocOutBooleanMatArg(int position, PsychArgRequirementType isRequired, psych_int64 m, psych_int64 n, psych_int64 p, PsychNativeBooleanType **array);
 psych_bool PsychCopyOutBooleanArg(int position, PsychArgRequirementType isRequired, PsychNativeBooleanType value);
@@ -176,7 +196,15 @@ double mxGetScalar(const PyObject* arrayPtr);
 PyObject* mxGetField(const PyObject* structArray, int index, const char* fieldName);
 PyObject** PsychGetOutArgPyPtr(int position);
 const PyObject *PsychGetInArgPyPtr(int position);
+// Python 3.7+ supports the METH_FASTCALL calling convention, which passes input arguments as a C array
+// instead of a newly built tuple. Not part of the limited api before Python 3.10, so keep it simple:
+#if (PY_VERSION_HEX >= 0x03070000) && !defined(Py_LIMITED_API)
+#define PSYCH_PYTHON_FASTCALL 1
+PyObject* PsychScriptingGluePythonDispatch(PyObject* self, PyObject* const* args, Py_ssize_t nargs);
+#else
+#define PSYCH_PYTHON_FASTCALL 0
 PyObject* PsychScriptingGluePythonDispatch(PyObject* self, PyObject* args);
+#endif
 const char* PsychGetPyModuleFilename(void);
 #endif
 
@@ -180,6 +180,18 @@ psych_bool PsychUseCMemoryLayoutIfOptimal(psych_bool tryEnableCMemoryLayout)
     return(FALSE);
 }
 
+/*     PsychBeginBlockingRegion() / PsychEndBlockingRegion() - Mark potentially long blocking regions.
+ *
+ *     Matlab and Octave don't have multi-threaded script execution, so nothing to do.
+ */
+void PsychBeginBlockingRegion(void)
+{
+}
+
+void PsychEndBlockingRegion(void)
+{
+}
+
 
 /*
  *
@@ -1150,6 +1162,40 @@ psych_bool PsychAllocOutUnsignedInt16MatArg(int position, PsychArgRequirementTyp
 }
 
 
+/*
+ *    PsychCopyOutExternalMatArg()
+ *
+ *    Return the m x n x p matrix of uint8 or uint16 elements 'fromArray', stored in column-major
+ *    order. Matlab and Octave can not wrap external memory in their arrays, so the matrix is copied
+ *    and releaseFunc(releaseArg) is called before returning.
+ */
+psych_bool PsychCopyOutExternalMatArg(int position, PsychArgRequirementType isRequired, psych_int64 m, psych_int64 n, psych_int64 p,
+                                      PsychArgFormatType type, void *fromArray, PsychExternalMatReleaseFunc releaseFunc, void *releaseArg)
+{
+    psych_uint8     *toArray8;
+    psych_uint16    *toArray16;
+    psych_bool      putOut;
+
+    if (type == PsychArgType_uint8) {
+        if ((putOut = PsychAllocOutUnsignedByteMatArg(position, isRequired, m, n, p, &toArray8)))
+            memcpy(toArray8, fromArray, sizeof(psych_uint8) * (size_t) m * (size_t) n * (size_t) maxInt(1,p));
+    }
+    else if (type == PsychArgType_uint16) {
+        if ((putOut = PsychAllocOutUnsignedInt16MatArg(position, isRequired, m, n, p, &toArray16)))
+            memcpy(toArray16, fromArray, sizeof(psych_uint16) * (size_t) m * (size_t) n * (size_t) maxInt(1,p));
+    }
+    else {
+        releaseFunc(releaseArg);
+        PsychErrorExitMsg(PsychError_internal, "PsychCopyOutExternalMatArg() called with unsupported matrix type!");
+        return(FALSE);
+    }
+
+    releaseFunc(releaseArg);
+
+    return(putOut);
+}
+
+
 psych_bool PsychCopyOutDoubleMatArg(int position, PsychArgRequirementType isRequired, psych_int64 m, psych_int64 n, psych_int64 p, double *fromArray)
 {
     mxArray     **mxpp;
@@ -1291,6 +1337,39 @@ psych_bool PsychAllocInDoubleMatArg64(int position, PsychArgRequirementType isRe
 }
 
 
+/*
+ *    PsychAllocInNativeMatArg64()
+ *
+ *    Like PsychAllocInDoubleMatArg64(), but accepts a matrix of any of the numeric types in the
+ *    'acceptedTypes' bitmask of PsychArgType_xxx flags, e.g., PsychArgType_single | PsychArgType_int16.
+ *    The data is returned in its native type, which is returned in *type, so the caller can handle
+ *    each type appropriately, e.g., convert it while copying it into its own buffers. The data of
+ *    the input matrix is passed through without any copy or conversion.
+ *
+ */
+psych_bool PsychAllocInNativeMatArg64(int position, PsychArgRequirementType isRequired, PsychArgFormatType acceptedTypes,
+                                      psych_int64 *m, psych_int64 *n, psych_int64 *p, PsychArgFormatType *type, void **array)
+{
+    const mxArray     *mxPtr;
+    PsychError        matchError;
+    psych_bool        acceptArg;
+
+    PsychSetReceivedArgDescriptor(position, TRUE, PsychArgIn);
+    PsychSetSpecifiedArgDescriptor(position, PsychArgIn, acceptedTypes, isRequired, 1,-1,1,-1,0,-1);
+    matchError=PsychMatchDescriptors();
+    acceptArg=PsychAcceptInputArgumentDecider(isRequired, matchError);
+    if (acceptArg) {
+        mxPtr = PsychGetInArgMxPtr(position);
+        *m = (psych_int64) mxGetM(mxPtr);
+        *n = (psych_int64) mxGetNOnly(mxPtr);
+        *p = (psych_int64) mxGetP(mxPtr);
+        *type = PsychGetTypeFromMxPtr(mxPtr);
+        *array = mxGetData(mxPtr);
+    }
+    return(acceptArg);
+}
+
+
 /* Like PsychAllocInFloatMatArg64, but with 32-Bit int type size return-arguments. */
 psych_bool PsychAllocInFloatMatArg(int position, PsychArgRequirementType isRequired, int *m, int *n, int *p, float **array)
 {
@@ -13,6 +13,7 @@
     HISTORY:
     12/31/02  awi   wrote it.
     03/28/11   mk   Make 64-bit clean.
+    10/18/26   agent Add struct builders which set fields by index.
 
     DESCRIPTION:
 
@@ -310,4 +311,89 @@ void PsychSetStructArrayNativeElement(const char *fieldName,
     mxSetField(pStructArray, (mwIndex) index, fieldName, pNativeElement);
 }
 
+// Struct builder functions
+///////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+///////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+/*
+    PsychAllocOutStructBuilder()
+
+    Like PsychAllocOutStructArray(), but returns a builder for setting the fields of the new struct
+    array by field index instead of by field name. mxCreateStructArray() creates the fields in the
+    order of 'fieldNames', so the field number of each field is its index in 'fieldNames' and
+    nothing needs to be resolved here.
+*/
+psych_bool PsychAllocOutStructBuilder(int position,
+                                      PsychArgRequirementType isRequired,
+                                      int numElements,
+                                      int numFields,
+                                      const char **fieldNames,
+                                      PsychStructBuilder *builder)
+{
+    builder->numElements = numElements;
+    builder->numFields = numFields;
+    builder->fieldSlots = NULL;
+
+    return(PsychAllocOutStructArray(position, isRequired, numElements, numFields, fieldNames, &(builder->pStruct)));
+}
+
+// Validate fieldIndex and element index for a set into the struct of 'builder':
+static void PsychCheckStructBuilderSlot(PsychStructBuilder *builder, int fieldIndex, int index)
+{
+    if ((fieldIndex < 0) || (fieldIndex >= builder->numFields))
+        PsychErrorExitMsg(PsychError_internal, "Attempt to set a non-existent structure field index");
+
+    if ((index < 0) || (index >= abs(builder->numElements)))
+        PsychErrorExitMsg(PsychError_internal, "Attempt to set a structure field at an out-of-bounds index");
+}
+
+void PsychSetStructBuilderStringElement(PsychStructBuilder *builder,
+                                        int fieldIndex,
+                                        int index,
+                                        const char *text)
+{
+    mxArray *mxFieldValue;
+
+    PsychCheckStructBuilderSlot(builder, fieldIndex, index);
+    mxFieldValue = mxCreateString(text);
+    mxSetFieldByNumber(builder->pStruct, (mwIndex) index, fieldIndex, mxFieldValue);
+    if (PSYCH_LANGUAGE == PSYCH_OCTAVE) mxDestroyArray(mxFieldValue);
+}
+
+void PsychSetStructBuilderDoubleElement(PsychStructBuilder *builder,
+                                        int fieldIndex,
+                                        int index,
+                                        double value)
+{
+    mxArray *mxFieldValue;
+
+    PsychCheckStructBuilderSlot(builder, fieldIndex, index);
+    mxFieldValue = mxCreateDoubleScalar(value);
+    mxSetFieldByNumber(builder->pStruct, (mwIndex) index, fieldIndex, mxFieldValue);
+    if (PSYCH_LANGUAGE == PSYCH_OCTAVE) mxDestroyArray(mxFieldValue);
+}
+
+void PsychSetStructBuilderBooleanElement(PsychStructBuilder *builder,
+                                         int fieldIndex,
+                                         int index,
+                                         psych_bool state)
+{
+    mxArray *mxFieldValue;
+
+    PsychCheckStructBuilderSlot(builder, fieldIndex, index);
+    mxFieldValue = mxCreateLogicalScalar((mxLogical) state);
+    mxSetFieldByNumber(builder->pStruct, (mwIndex) index, fieldIndex, mxFieldValue);
+    if (PSYCH_LANGUAGE == PSYCH_OCTAVE) mxDestroyArray(mxFieldValue);
+}
+
+void PsychSetStructBuilderNativeElement(PsychStructBuilder *builder,
+                                        int fieldIndex,
+                                        int index,
+                                        PsychGenericScriptType *pNativeElement)
+{
+    PsychCheckStructBuilderSlot(builder, fieldIndex, index);
+    mxSetFieldByNumber(builder->pStruct, (mwIndex) index, fieldIndex, pNativeElement);
+}
+
 #endif
+
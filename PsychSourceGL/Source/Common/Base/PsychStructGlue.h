@@ -58,5 +58,48 @@ psych_bool PsychAssignOutStructArray(   int position,
                                         PsychArgRequirementType isRequired,
                                         PsychGenericScriptType *pStruct);
 
+// Struct builder: Creates a struct array like PsychAllocOutStructArray() and resolves the slots of all its
+// fields once, so they can be set by index into the 'fieldNames' array the builder was created with, instead
+// of by lookup of the field name for each set. Use for output structs with many fields or many elements:
+typedef struct PsychStructBuilder {
+    PsychGenericScriptType  *pStruct;       // The struct array under construction.
+    int                     numElements;    // Number of elements, -1 for a single struct.
+    int                     numFields;      // Number of fields per element.
+    void                    *fieldSlots;    // Resolved field slots, private to the scripting glue.
+} PsychStructBuilder;
+
+psych_bool PsychAllocOutStructBuilder(  int position,
+                                        PsychArgRequirementType isRequired,
+                                        int numElements,
+                                        int numFields,
+                                        const char **fieldNames,
+                                        PsychStructBuilder *builder);
+
+void PsychSetStructBuilderStringElement(PsychStructBuilder *builder,
+                                        int fieldIndex,
+                                        int index,
+                                        const char *text);
+
+void PsychSetStructBuilderDoubleElement(PsychStructBuilder *builder,
+                                        int fieldIndex,
+                                        int index,
+                                        double value);
+
+void PsychSetStructBuilderBooleanElement(PsychStructBuilder *builder,
+                                         int fieldIndex,
+                                         int index,
+                                         psych_bool state);
+
+void PsychSetStructBuilderNativeElement(PsychStructBuilder *builder,
+                                        int fieldIndex,
+                                        int index,
+                                        PsychGenericScriptType *nativeElement);
+
+#if PSYCH_LANGUAGE == PSYCH_PYTHON
+// Hidden helper subfunctions for benchmarking struct output and selecting the struct builder output format:
+PsychError PsychStructBuilderBenchmark(void);
+PsychError PsychStructRecordsHelper(void);
+#endif
+
 //end include once
 #endif
@@ -0,0 +1,692 @@
+/*
+    Psychtoolbox3/Source/Common/PsychTrace.c
+
+    AUTHORS:
+
+    agent@local                     agent
+
+    PLATFORMS: All
+
+    PROJECTS: All
+
+    HISTORY:
+
+    10/18/26  agent Wrote it. Replaces PsychInstrument.
+
+    DESCRIPTION:
+
+    Low overhead event tracing. Each thread which records an event gets its own ring
+    buffer of events on first use, so recording needs no locks: The recording thread is
+    the only writer of its buffer, and publishes each new event by incrementing the write
+    count of the buffer with release semantics. Readers, ie. 'Dump' and 'Get' on the main
+    thread, snapshot the buffers at any time, discarding events which got overwritten while
+    they were copied. Once a buffer is full, the oldest events get overwritten.
+
+    Only the owning thread releases its buffer, when it exits, or when it finds its buffer
+    retired by a change of capacity on its next event, as it may be writing to the buffer at
+    any time before that. Released retired buffers get freed. Buffers of exited threads stay
+    around, so their events can still be dumped, but once kPsychMaxTraceThreads buffers
+    exist, new threads take over buffers of exited threads. Only if there aren't any, events
+    of new threads are not recorded, until a buffer gets released.
+
+    Dumps are in Chrome trace event JSON array format, which Perfetto and chrome://tracing
+    can load. Dumps of multiple modules can be merged into one file, as events carry the
+    system process id and thread id, and the module name as category.
+*/
+
+#include "Psych.h"
+#include <stdarg.h>
+#include <ctype.h>
+
+#if PSYCH_SYSTEM == PSYCH_LINUX
+#include <sys/syscall.h>
+#endif
+
+// Default number of events per thread, and maximum number of threads with trace buffers:
+#define kPsychTraceDefaultEvents    16384
+#define kPsychMaxTraceThreads       64
+
+typedef struct PsychTraceBuffer {
+    struct PsychTraceBuffer*    next;
+    psych_uint64                thread;         // System thread id of owning thread.
+    char                        threadName[32]; // Name of owning thread, if any.
+    unsigned int                generation;     // Buffers of older generations are retired and not used anymore.
+    psych_bool                  owned;          // Buffer is in use by a living thread.
+    unsigned int                mask;           // Capacity - 1, capacity is a power of two.
+    volatile psych_uint64       writeCount;     // Total number of events written since last clear.
+    PsychTraceEvent             events[1];
+} PsychTraceBuffer;
+
+volatile psych_bool psychTraceEnabled = FALSE;
+
+static psych_mutex          traceMutex;
+static psych_bool           traceInitialized = FALSE;
+static PsychTraceBuffer*    traceBuffers = NULL;
+static unsigned int         traceNumBuffers = 0;
+static unsigned int         traceEventsPerThread = kPsychTraceDefaultEvents;
+static volatile unsigned int traceGeneration = 1;
+static volatile unsigned int traceReleaseCount = 0;
+
+static PSYCH_THREADLOCAL PsychTraceBuffer*  traceBuffer = NULL;
+static PSYCH_THREADLOCAL unsigned int       traceBufferGeneration = 0;
+static PSYCH_THREADLOCAL unsigned int       traceBufferReleaseCount = 0;
+static PSYCH_THREADLOCAL char               traceThreadName[32];
+
+// Key whose destructor releases the trace buffer of an exiting thread:
+#if PSYCH_SYSTEM == PSYCH_WINDOWS
+static DWORD                traceExitKey = FLS_OUT_OF_INDEXES;
+#else
+static pthread_key_t        traceExitKey;
+static psych_bool           traceExitKeyValid = FALSE;
+#endif
+
+// System thread id of calling thread, as shown by debuggers, top, etc.:
+static psych_uint64 PsychTraceGetThreadId(void)
+{
+    #if PSYCH_SYSTEM == PSYCH_LINUX
+        return((psych_uint64) syscall(SYS_gettid));
+    #elif PSYCH_SYSTEM == PSYCH_OSX
+        uint64_t tid = 0;
+        pthread_threadid_np(NULL, &tid);
+        return((psych_uint64) tid);
+    #else
+        return((psych_uint64) GetCurrentThreadId());
+    #endif
+}
+
+static int PsychTraceGetProcessId(void)
+{
+    #if PSYCH_SYSTEM == PSYCH_WINDOWS
+        return((int) GetCurrentProcessId());
+    #else
+        return((int) getpid());
+    #endif
+}
+
+// Store with release semantics, so the event is visible to other threads before the new write count:
+static void PsychTraceStoreRelease(volatile psych_uint64* dst, psych_uint64 value)
+{
+    #ifdef _MSC_VER
+        // Volatile stores have release semantics with MSVC:
+        *dst = value;
+    #else
+        __atomic_store_n(dst, value, __ATOMIC_RELEASE);
+    #endif
+}
+
+static psych_uint64 PsychTraceLoadAcquire(volatile psych_uint64* src)
+{
+    #ifdef _MSC_VER
+        return(*src);
+    #else
+        return(__atomic_load_n(src, __ATOMIC_ACQUIRE));
+    #endif
+}
+
+// Release trace buffer 'buf' of the calling thread, ie. of its owner. A retired buffer gets freed, the
+// buffer of an exiting thread is kept for its events. Ignores buffers which are gone already:
+static void PsychTraceReleaseBuffer(PsychTraceBuffer* buf)
+{
+    PsychTraceBuffer** link;
+
+    if (!traceInitialized || !buf)
+        return;
+
+    PsychLockMutex(&traceMutex);
+
+    for (link = &traceBuffers; *link; link = &((*link)->next)) {
+        if (*link == buf) {
+            buf->owned = FALSE;
+            if (buf->generation != traceGeneration) {
+                *link = buf->next;
+                free(buf);
+                traceNumBuffers--;
+            }
+
+            // Threads which failed to get a buffer can retry now:
+            traceReleaseCount++;
+            break;
+        }
+    }
+
+    PsychUnlockMutex(&traceMutex);
+}
+
+#if PSYCH_SYSTEM == PSYCH_WINDOWS
+static VOID WINAPI PsychTraceThreadExit(PVOID buf)
+#else
+static void PsychTraceThreadExit(void* buf)
+#endif
+{
+    PsychTraceReleaseBuffer((PsychTraceBuffer*) buf);
+}
+
+// Free retired buffers of exited threads, or of threads which switched to a new buffer:
+static void PsychTraceFreeRetiredLocked(void)
+{
+    PsychTraceBuffer **link, *buf;
+
+    for (link = &traceBuffers; (buf = *link);) {
+        if (!buf->owned && (buf->generation != traceGeneration)) {
+            *link = buf->next;
+            free(buf);
+            traceNumBuffers--;
+        }
+        else {
+            link = &(buf->next);
+        }
+    }
+}
+
+void PsychInitTrace(void)
+{
+    if (traceInitialized)
+        return;
+
+    PsychInitMutex(&traceMutex);
+    traceBuffers = NULL;
+    traceNumBuffers = 0;
+    traceEventsPerThread = kPsychTraceDefaultEvents;
+    psychTraceEnabled = FALSE;
+
+    #if PSYCH_SYSTEM == PSYCH_WINDOWS
+        traceExitKey = FlsAlloc(PsychTraceThreadExit);
+    #else
+        traceExitKeyValid = (pthread_key_create(&traceExitKey, PsychTraceThreadExit) == 0) ? TRUE : FALSE;
+    #endif
+
+    traceInitialized = TRUE;
+}
+
+void PsychExitTrace(void)
+{
+    PsychTraceBuffer *buf, *next;
+
+    if (!traceInitialized)
+        return;
+
+    psychTraceEnabled = FALSE;
+
+    // No more release of buffers on thread exit, they all get freed below. FlsFree() calls the
+    // destructor for still set values itself, which is harmless as long as the buffers exist:
+    #if PSYCH_SYSTEM == PSYCH_WINDOWS
+        if (traceExitKey != FLS_OUT_OF_INDEXES)
+            FlsFree(traceExitKey);
+        traceExitKey = FLS_OUT_OF_INDEXES;
+    #else
+        if (traceExitKeyValid)
+            pthread_key_delete(traceExitKey);
+        traceExitKeyValid = FALSE;
+    #endif
+
+    PsychLockMutex(&traceMutex);
+
+    // Invalidate cached buffer pointers of all threads:
+    traceGeneration++;
+
+    for (buf = traceBuffers; buf; buf = next) {
+        next = buf->next;
+        free(buf);
+    }
+
+    traceBuffers = NULL;
+    traceNumBuffers = 0;
+
+    PsychUnlockMutex(&traceMutex);
+    PsychDestroyMutex(&traceMutex);
+    traceInitialized = FALSE;
+}
+
+// Allocate a trace buffer for the calling thread, replacing its retired buffer, if any. Returns NULL if
+// no more buffers are allowed:
+static PsychTraceBuffer* PsychTraceAllocBuffer(void)
+{
+    PsychTraceBuffer* buf = NULL;
+
+    if (!traceInitialized)
+        return(NULL);
+
+    if (traceBuffer)
+        PsychTraceReleaseBuffer(traceBuffer);
+
+    PsychLockMutex(&traceMutex);
+
+    PsychTraceFreeRetiredLocked();
+
+    if (traceNumBuffers < kPsychMaxTraceThreads) {
+        buf = (PsychTraceBuffer*) calloc(1, sizeof(PsychTraceBuffer) + (traceEventsPerThread - 1) * sizeof(PsychTraceEvent));
+        if (buf) {
+            buf->generation = traceGeneration;
+            buf->mask = traceEventsPerThread - 1;
+            buf->next = traceBuffers;
+            traceBuffers = buf;
+            traceNumBuffers++;
+        }
+    }
+    else {
+        // Take over the buffer of an exited thread, discarding its events:
+        for (buf = traceBuffers; buf && buf->owned; buf = buf->next);
+        if (buf)
+            PsychTraceStoreRelease(&buf->writeCount, 0);
+    }
+
+    if (buf) {
+        buf->owned = TRUE;
+        buf->thread = PsychTraceGetThreadId();
+        buf->threadName[0] = 0;
+        if (traceThreadName[0])
+            snprintf(buf->threadName, sizeof(buf->threadName), "%s", traceThreadName);
+        else if (PsychIsMasterThread())
+            snprintf(buf->threadName, sizeof(buf->threadName), "Main");
+    }
+
+    // Failure is also cached, so we don't retry on each event, only after some buffer got released:
+    traceBuffer = buf;
+    traceBufferGeneration = traceGeneration;
+    traceBufferReleaseCount = traceReleaseCount;
+
+    PsychUnlockMutex(&traceMutex);
+
+    // Release the buffer when the thread exits:
+    #if PSYCH_SYSTEM == PSYCH_WINDOWS
+        if (traceExitKey != FLS_OUT_OF_INDEXES)
+            FlsSetValue(traceExitKey, buf);
+    #else
+        if (traceExitKeyValid)
+            pthread_setspecific(traceExitKey, buf);
+    #endif
+
+    return(buf);
+}
+
+// Record an event for the calling thread. A negative 'timestamp' means current GetSecs time.
+// Use the PsychTraceXXX() macros instead of calling this directly:
+void PsychTraceRecord(char phase, const char* category, const char* name, double timestamp, double value)
+{
+    PsychTraceBuffer* buf = traceBuffer;
+    PsychTraceEvent* evt;
+    psych_uint64 n;
+
+    if ((traceBufferGeneration != traceGeneration) || (!buf && (traceBufferReleaseCount != traceReleaseCount)))
+        buf = PsychTraceAllocBuffer();
+
+    if (!buf)
+        return;
+
+    if (timestamp < 0)
+        PsychGetAdjustedPrecisionTimerSeconds(&timestamp);
+
+    n = buf->writeCount;
+    evt = &buf->events[n & buf->mask];
+    evt->timestamp = timestamp;
+    evt->value = value;
+    evt->category = category;
+    evt->name = name;
+    evt->phase = phase;
+    PsychTraceStoreRelease(&buf->writeCount, n + 1);
+}
+
+// Set name of calling thread for trace output. Called by PsychSetThreadName():
+void PsychTraceSetThreadName(const char* name)
+{
+    snprintf(traceThreadName, sizeof(traceThreadName), "%s", (name) ? name : "");
+
+    if (traceInitialized && traceBuffer && (traceBufferGeneration == traceGeneration)) {
+        PsychLockMutex(&traceMutex);
+        snprintf(traceBuffer->threadName, sizeof(traceBuffer->threadName), "%s", traceThreadName);
+        PsychUnlockMutex(&traceMutex);
+    }
+}
+
+// Enable tracing, and discard all recorded events. A non-zero 'eventsPerThread' sets the capacity
+// of each threads ring buffer, rounded up to a power of two:
+void PsychTraceStart(unsigned int eventsPerThread)
+{
+    unsigned int capacity;
+
+    if (!traceInitialized)
+        PsychInitTrace();
+
+    if (eventsPerThread > 0) {
+        if (eventsPerThread > (1 << 24))
+            eventsPerThread = 1 << 24;
+
+        for (capacity = 16; capacity < eventsPerThread; capacity <<= 1);
+
+        if (capacity != traceEventsPerThread) {
+            // Retire all buffers of the old size. Threads allocate new ones on their next event:
+            PsychLockMutex(&traceMutex);
+            traceEventsPerThread = capacity;
+            traceGeneration++;
+            PsychTraceFreeRetiredLocked();
+            PsychUnlockMutex(&traceMutex);
+        }
+    }
+
+    PsychTraceClear();
+    psychTraceEnabled = TRUE;
+}
+
+void PsychTraceStop(void)
+{
+    psychTraceEnabled = FALSE;
+}
+
+// Discard all recorded events:
+void PsychTraceClear(void)
+{
+    PsychTraceBuffer* buf;
+
+    if (!traceInitialized)
+        return;
+
+    PsychLockMutex(&traceMutex);
+    for (buf = traceBuffers; buf; buf = buf->next)
+        PsychTraceStoreRelease(&buf->writeCount, 0);
+    PsychUnlockMutex(&traceMutex);
+}
+
+// Return all recorded events in 'events', in temporary memory which gets released at the end of the
+// current module call, in order of recording per thread. Returns number of events:
+psych_uint64 PsychTraceSnapshot(PsychTraceEvent** events)
+{
+    PsychTraceBuffer* buf;
+    PsychTraceEvent* out;
+    psych_uint64 count, total, start, end, end2, i, j;
+
+    *events = NULL;
+    if (!traceInitialized)
+        return(0);
+
+    PsychLockMutex(&traceMutex);
+
+    total = 0;
+    for (buf = traceBuffers; buf; buf = buf->next) {
+        if (buf->generation != traceGeneration)
+            continue;
+
+        end = PsychTraceLoadAcquire(&buf->writeCount);
+        total += (end > (psych_uint64) buf->mask + 1) ? (psych_uint64) buf->mask + 1 : end;
+    }
+
+    // Events recorded after counting can only replace older events in a full buffer, or
+    // increase the count of a non-full one, so limit each copy to what we counted:
+    out = (PsychTraceEvent*) PsychMallocTemp((size_t) ((total > 0) ? total : 1) * sizeof(PsychTraceEvent));
+    count = 0;
+
+    for (buf = traceBuffers; buf && (count < total); buf = buf->next) {
+        if (buf->generation != traceGeneration)
+            continue;
+
+        end = PsychTraceLoadAcquire(&buf->writeCount);
+        start = (end > (psych_uint64) buf->mask + 1) ? end - buf->mask - 1 : 0;
+        if (end - start > total - count)
+            start = end - (total - count);
+
+        for (i = start, j = count; i < end; i++, j++) {
+            out[j] = buf->events[i & buf->mask];
+            out[j].thread = buf->thread;
+        }
+
+        // Discard events which may have been overwritten by the recording thread during the copy, including
+        // the slot of the event it may be writing right now:
+        end2 = PsychTraceLoadAcquire(&buf->writeCount);
+        if (end2 < end) {
+            // Buffer got cleared meanwhile:
+            continue;
+        }
+
+        if (end2 > start + buf->mask) {
+            i = end2 - buf->mask - start;
+            if (i > end - start) i = end - start;
+            memmove(&out[count], &out[count + i], (size_t) (end - start - i) * sizeof(PsychTraceEvent));
+            count += end - start - i;
+        }
+        else {
+            count += end - start;
+        }
+    }
+
+    PsychUnlockMutex(&traceMutex);
+
+    *events = out;
+    return(count);
+}
+
+// Formatted output to file. fprintf() is redirected to the console in some scripting environments:
+static void PsychTracePrintf(FILE* fd, const char* format, ...)
+{
+    char line[256];
+    va_list args;
+    int n;
+
+    va_start(args, format);
+    n = vsnprintf(line, sizeof(line), format, args);
+    va_end(args);
+
+    if (n > 0)
+        fwrite(line, 1, (n < (int) sizeof(line)) ? (size_t) n : sizeof(line) - 1, fd);
+}
+
+// Print 'str' as JSON string, with escaping of special characters:
+static void PsychTraceWriteString(FILE* fd, const char* str)
+{
+    fputc('"', fd);
+    for (; str && *str; str++) {
+        if ((*str == '"') || (*str == '\\'))
+            fputc('\\', fd);
+
+        if ((unsigned char) *str >= 32)
+            fputc(*str, fd);
+    }
+    fputc('"', fd);
+}
+
+// Write all recorded events as Chrome trace event JSON array to file 'filename'. If 'append'
+// is set and the file contains such an array already, e.g., from a dump of another module, the
+// events are appended to that array. Returns number of written events, or -1 on error:
+static double PsychTraceDump(const char* filename, psych_bool append)
+{
+    PsychTraceBuffer* buf;
+    PsychTraceEvent *events, *evt;
+    psych_uint64 count, i;
+    FILE* fd = NULL;
+    char tail[64];
+    long pos;
+    int pid, n;
+    psych_bool first = TRUE, appending = FALSE;
+
+    count = PsychTraceSnapshot(&events);
+    pid = PsychTraceGetProcessId();
+
+    if (append && (fd = fopen(filename, "r+b"))) {
+        // Find closing bracket of existing array, to replace it with our events:
+        if ((fseek(fd, 0, SEEK_END) == 0) && ((pos = ftell(fd)) > 0)) {
+            // Start of last block of the file:
+            pos = (pos > (long) sizeof(tail)) ? pos - (long) sizeof(tail) : 0;
+            fseek(fd, pos, SEEK_SET);
+            n = (int) fread(tail, 1, sizeof(tail), fd);
+            while ((n > 0) && (tail[n - 1] != ']'))
+                n--;
+
+            if ((n > 0) && (fseek(fd, pos + n - 1, SEEK_SET) == 0)) {
+                appending = TRUE;
+
+                // Only need a separator before our first entry if the array isn't empty, ie.
+                // if the last non-whitespace character before the bracket isn't the opening one:
+                for (n = n - 2; (n >= 0) && isspace((unsigned char) tail[n]); n--);
+                if ((n >= 0) ? (tail[n] != '[') : (pos > 0))
+                    first = FALSE;
+            }
+        }
+
+        if (!appending) {
+            fclose(fd);
+            fd = NULL;
+        }
+    }
+
+    if (!appending) {
+        if (!(fd = fopen(filename, "wb")))
+            return(-1);
+
+        PsychTracePrintf(fd, "[\n");
+    }
+
+    // Names of all threads:
+    PsychLockMutex(&traceMutex);
+    for (buf = traceBuffers; buf; buf = buf->next) {
+        if ((buf->generation != traceGeneration) || !buf->threadName[0])
+            continue;
+
+        PsychTracePrintf(fd, "%s{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":%i,\"tid\":%llu,\"args\":{\"name\":", (first) ? "" : ",\n", pid, (unsigned long long) buf->thread);
+        PsychTraceWriteString(fd, buf->threadName);
+        PsychTracePrintf(fd, "}}");
+        first = FALSE;
+    }
+    PsychUnlockMutex(&traceMutex);
+
+    for (i = 0; i < count; i++) {
+        evt = &events[i];
+
+        PsychTracePrintf(fd, "%s{\"name\":", (first) ? "" : ",\n");
+        PsychTraceWriteString(fd, evt->name);
+        PsychTracePrintf(fd, ",\"cat\":");
+        PsychTraceWriteString(fd, evt->category);
+        PsychTracePrintf(fd, ",\"ph\":\"%c\",\"ts\":%.3f,\"pid\":%i,\"tid\":%llu", evt->phase, evt->timestamp * 1e6, pid, (unsigned long long) evt->thread);
+
+        switch (evt->phase) {
+            case 'X':
+                PsychTracePrintf(fd, ",\"dur\":%.3f", evt->value * 1e6);
+                break;
+
+            case 'i':
+                PsychTracePrintf(fd, ",\"s\":\"t\",\"args\":{\"value\":%.17g}", evt->value);
+                break;
+
+            case 'C':
+                PsychTracePrintf(fd, ",\"args\":{");
+                PsychTraceWriteString(fd, evt->name);
+                PsychTracePrintf(fd, ":%.17g}", evt->value);
+                break;
+        }
+
+        PsychTracePrintf(fd, "}");
+        first = FALSE;
+    }
+
+    PsychTracePrintf(fd, "\n]\n");
+    fclose(fd);
+
+    return((double) count);
+}
+
+PsychError PsychTraceSubfunction(void)
+{
+    static char useString[] = "[enabled, numEvents] = Modulename('Trace');\n"
+                              "Modulename('Trace', 'Start' [, eventsPerThread=16384]);\n"
+                              "Modulename('Trace', 'Stop');\n"
+                              "Modulename('Trace', 'Clear');\n"
+                              "numEvents = Modulename('Trace', 'Dump', filename [, append=0]);\n"
+                              "events = Modulename('Trace', 'Get');";
+    //                          1                                        2
+    static char synopsisString[] =
+        "Control low overhead event tracing of this module.\n\n"
+        "When tracing is enabled, the module records timestamped events from its time critical code paths, "
+        "e.g., Screen('Flip'), the PsychPortAudio audio callback, or input processing threads of PsychHID "
+        "and IOPort, to find out where time is spent during a running experiment. Each thread records into "
+        "its own ring buffer, so once a buffer is full, the oldest events of that thread get overwritten.\n\n"
+        "Without a command, returns if tracing is 'enabled', and the current total 'numEvents'.\n\n"
+        "'Start' discards all recorded events and enables tracing. Optional 'eventsPerThread' sets the "
+        "capacity of the ring buffer of each thread, rounded up to a power of two. 'Stop' disables tracing, "
+        "but keeps the recorded events. 'Clear' discards all recorded events.\n\n"
+        "'Dump' writes all recorded events to file 'filename', in Chrome trace event JSON format, which you "
+        "can view in Perfetto at https://ui.perfetto.dev or in chrome://tracing. If optional 'append' is 1, "
+        "events are appended to an existing dump, e.g., from another module, so traces of multiple modules "
+        "can be viewed together. Returns the number of written events.\n\n"
+        "'Get' returns all recorded events as struct array, with fields 'timestamp' in GetSecs time, "
+        "'value', which is the duration for complete events, 'category', 'name', 'phase' of the event as "
+        "in Chrome trace format, and system 'thread' id.\n";
+    static char seeAlsoString[] = "";
+
+    const char *FieldNames[] = { "timestamp", "value", "category", "name", "phase", "thread" };
+    PsychGenericScriptType *outEvents;
+    PsychTraceEvent *events;
+    psych_uint64 count, i;
+    char *cmd = NULL, *filename = NULL;
+    char phase[2];
+    int eventsPerThread = 0, append = 0;
+    double rc;
+
+    // All sub functions should have these two lines:
+    PsychPushHelp(useString, synopsisString, seeAlsoString);
+    if (PsychIsGiveHelp()) { PsychGiveHelp(); return(PsychError_none); };
+
+    PsychErrorExit(PsychCapNumOutputArgs(2));
+    PsychErrorExit(PsychCapNumInputArgs(3));
+
+    if (!traceInitialized)
+        PsychInitTrace();
+
+    if (!PsychAllocInCharArg(1, kPsychArgOptional, &cmd)) {
+        PsychCopyOutDoubleArg(1, kPsychArgOptional, (double) psychTraceEnabled);
+        if (PsychIsArgPresent(PsychArgOut, 2))
+            PsychCopyOutDoubleArg(2, kPsychArgOptional, (double) PsychTraceSnapshot(&events));
+
+        return(PsychError_none);
+    }
+
+    if (PsychMatch(cmd, "Start")) {
+        PsychCopyInIntegerArg(2, kPsychArgOptional, &eventsPerThread);
+        if (eventsPerThread < 0)
+            PsychErrorExitMsg(PsychError_user, "'eventsPerThread' must not be negative.");
+
+        PsychTraceStart((unsigned int) eventsPerThread);
+        return(PsychError_none);
+    }
+
+    if (PsychMatch(cmd, "Stop")) {
+        PsychTraceStop();
+        return(PsychError_none);
+    }
+
+    if (PsychMatch(cmd, "Clear")) {
+        PsychTraceClear();
+        return(PsychError_none);
+    }
+
+    if (PsychMatch(cmd, "Dump")) {
+        PsychAllocInCharArg(2, kPsychArgRequired, &filename);
+        PsychCopyInIntegerArg(3, kPsychArgOptional, &append);
+
+        if ((rc = PsychTraceDump(filename, (psych_bool) (append > 0))) < 0) {
+            printf("PTB-ERROR: Could not write trace to file '%s'.\n", filename);
+            PsychErrorExitMsg(PsychError_system, "Failed to write trace file.");
+        }
+
+        PsychCopyOutDoubleArg(1, kPsychArgOptional, rc);
+        return(PsychError_none);
+    }
+
+    if (PsychMatch(cmd, "Get")) {
+        count = PsychTraceSnapshot(&events);
+        PsychAllocOutStructArray(1, kPsychArgOptional, (int) count, 6, FieldNames, &outEvents);
+        phase[1] = 0;
+
+        for (i = 0; i < count; i++) {
+            phase[0] = events[i].phase;
+            PsychSetStructArrayDoubleElement("timestamp", (int) i, events[i].timestamp, outEvents);
+            PsychSetStructArrayDoubleElement("value", (int) i, events[i].value, outEvents);
+            PsychSetStructArrayStringElement("category", (int) i, (char*) events[i].category, outEvents);
+            PsychSetStructArrayStringElement("name", (int) i, (char*) events[i].name, outEvents);
+            PsychSetStructArrayStringElement("phase", (int) i, phase, outEvents);
+            PsychSetStructArrayDoubleElement("thread", (int) i, (double) events[i].thread, outEvents);
+        }
+
+        return(PsychError_none);
+    }
+
+    PsychErrorExitMsg(PsychError_user, "Unknown command.");
+
+    return(PsychError_none);
+}
@@ -0,0 +1,74 @@
+/*
+  Psychtoolbox/Source/Common/PsychTrace.h
+
+  AUTHORS:
+
+  agent@local                       agent
+
+  PLATFORMS: All
+
+  PROJECTS: All
+
+  HISTORY:
+
+  10/18/26  agent   Wrote it. Replaces PsychInstrument.
+
+  DESCRIPTION:
+
+  Low overhead event tracing for instrumenting hot paths of modules, e.g., Screen('Flip'),
+  the PsychPortAudio callback, or input processing threads. Each thread records into its
+  own lock-free ring buffer of events, which can be dumped as a Chrome trace event JSON
+  file, viewable in Perfetto (https://ui.perfetto.dev) or chrome://tracing.
+
+  Use the PsychTraceXXX() macros: If tracing is disabled, they cost one load and one
+  branch. Category and name of events must be string literals or otherwise constant
+  for the lifetime of the module, as only pointers to them get recorded.
+
+*/
+
+//begin include once
+#ifndef PSYCH_IS_INCLUDED_PsychTrace
+#define PSYCH_IS_INCLUDED_PsychTrace
+
+#include "Psych.h"
+
+// A recorded event:
+typedef struct PsychTraceEvent {
+    double          timestamp;  // GetSecs time of event, or of start of a complete event.
+    double          value;      // Duration of complete events, value of counters, optional argument of other events.
+    const char*     category;   // Category, e.g., the module name.
+    const char*     name;       // Name of event.
+    psych_uint64    thread;     // System thread id of recording thread. Filled in by PsychTraceSnapshot().
+    char            phase;      // Chrome trace event phase: 'B'egin, 'E'nd, 'X' complete, 'i'nstant, 'C'ounter.
+} PsychTraceEvent;
+
+// Is tracing enabled? Only read this via the macros below:
+extern volatile psych_bool psychTraceEnabled;
+
+void            PsychInitTrace(void);
+void            PsychExitTrace(void);
+void            PsychTraceStart(unsigned int eventsPerThread);
+void            PsychTraceStop(void);
+void            PsychTraceClear(void);
+void            PsychTraceSetThreadName(const char* name);
+void            PsychTraceRecord(char phase, const char* category, const char* name, double timestamp, double value);
+psych_uint64    PsychTraceSnapshot(PsychTraceEvent** events);
+
+// Begin and end of a duration event on the calling thread. Must be properly nested:
+#define PsychTraceBegin(category, name)                 do { if (psychTraceEnabled) PsychTraceRecord('B', (category), (name), -1, 0); } while (0)
+#define PsychTraceEnd(category, name)                   do { if (psychTraceEnabled) PsychTraceRecord('E', (category), (name), -1, 0); } while (0)
+
+// Complete event with known start and end time, e.g., from a hardware timestamp:
+#define PsychTraceComplete(category, name, tStart, tEnd) do { if (psychTraceEnabled) PsychTraceRecord('X', (category), (name), (tStart), (tEnd) - (tStart)); } while (0)
+
+// Instant event, with a numeric argument:
+#define PsychTraceInstant(category, name, value)        do { if (psychTraceEnabled) PsychTraceRecord('i', (category), (name), -1, (value)); } while (0)
+
+// New value of a counter, e.g., a queue fill level:
+#define PsychTraceCounter(category, name, value)        do { if (psychTraceEnabled) PsychTraceRecord('C', (category), (name), -1, (value)); } while (0)
+
+// Implementation of the 'Trace' subfunction, which modules can register to control tracing:
+PsychError      PsychTraceSubfunction(void);
+
+//end include once
+#endif
@@ -71,6 +71,7 @@
 
 #include <string.h>
 #include <setjmp.h>
+#include <stdarg.h>
 
 ////Static functions local to ScriptingGluePython.c.
 // _____________________________________________________________________________________
@@ -109,6 +110,27 @@ static int recLevel = -1;
 static psych_bool psych_recursion_debug = FALSE;
 static int psych_refcount_debug = 0;
 
+// Saved Python thread state of each call recursion level while the Python GIL is released inside a
+// PsychBeginBlockingRegion() / PsychEndBlockingRegion() region, NULL while the GIL is held:
+static PyThreadState* threadStateGLUE[MAX_RECURSIONLEVEL];
+
+// Output of printf() and fprintf() by the module call thread while it doesn't hold the GIL. Python
+// must not be called without the GIL, so the text is collected here and printed at the end of the
+// blocking region. Only the thread which owns the dispatch lock writes to it, so no locking needed:
+#define MAX_DEFERRED_OUTPUT 4096
+static char deferredOutputGLUE[2][MAX_DEFERRED_OUTPUT];
+static size_t deferredOutputLenGLUE[2] = { 0, 0 };
+
+// Dispatch lock: Module calls from multiple Python threads would trample on the recLevel stack and
+// the module state, as soon as one of them releases the GIL in a blocking region. Therefore only one
+// Python thread at a time may execute inside the module. Recursive calls from the owning thread, e.g.,
+// via Python callbacks, are fine. dispatchOwnerGLUE and dispatchDepthGLUE are only accessed with the
+// GIL held, so the GIL orders access to them:
+static psych_mutex dispatchMutexGLUE;
+static psych_bool dispatchMutexInitializedGLUE = FALSE;
+static psych_threadid dispatchOwnerGLUE;
+static int dispatchDepthGLUE = 0;
+
 // Our own module object:
 static PyObject *module = NULL;
 
@@ -123,7 +145,11 @@ static char modulefilename[FILENAME_MAX];
 #define PPYNAME(...) _PPYNAME(__VA_ARGS__)
 
 static PyMethodDef GlobalPythonMethodsTable[] = {
+#if PSYCH_PYTHON_FASTCALL
+    {PPYNAME(PTBMODULENAME), (PyCFunction) (void(*)(void)) PsychScriptingGluePythonDispatch, METH_FASTCALL, NULL},
+#else
     {PPYNAME(PTBMODULENAME), PsychScriptingGluePythonDispatch, METH_VARARGS, NULL},
+#endif
     {NULL, NULL, 0, NULL}
 };
 
@@ -237,6 +263,9 @@ jmp_buf jmpbuffer[MAX_RECURSIONLEVEL];
 // to the cleanup routine at the end of our PsychScriptingGluePythonDispatch()
 // dispatcher.
 void mexErrMsgTxt(const char* s) {
+    // Error exit from within a blocking region? Need the GIL back before talking to Python:
+    PsychEndBlockingRegion();
+
     if (s && strlen(s) > 0)
         printf("%s:%s: %s\n", PsychGetModuleName(), PsychGetFunctionName(), s);
     else
@@ -876,6 +905,118 @@ psych_bool PsychUseCMemoryLayoutIfOptimal(psych_bool tryEnableCMemoryLayout)
     return(tryEnableCMemoryLayout);
 }
 
+// Common implementation of printf() and fprintf(), see PsychConstants.h. 'stream' 0 = stdout, 1 = stderr:
+static void PsychPythonVPrintf(int stream, const char* format, va_list args)
+{
+    char msg[1001];
+    size_t len;
+    int n;
+
+    // Called from the module call thread inside a blocking region, without the GIL? Defer output:
+    if ((recLevel >= 0) && threadStateGLUE[recLevel] && PsychIsCurrentThreadEqualToId(dispatchOwnerGLUE)) {
+        len = deferredOutputLenGLUE[stream];
+        n = vsnprintf(&deferredOutputGLUE[stream][len], MAX_DEFERRED_OUTPUT - len, format, args);
+        if (n > 0)
+            deferredOutputLenGLUE[stream] = (len + n < MAX_DEFERRED_OUTPUT) ? len + n : MAX_DEFERRED_OUTPUT - 1;
+
+        return;
+    }
+
+    // Python truncates output of PySys_WriteStdout() to 1000 Bytes, so do we:
+    vsnprintf(msg, sizeof(msg), format, args);
+    if (stream)
+        PySys_WriteStderr("%s", msg);
+    else
+        PySys_WriteStdout("%s", msg);
+}
+
+void PsychPythonPrintf(const char* format, ...)
+{
+    va_list args;
+
+    va_start(args, format);
+    PsychPythonVPrintf(0, format, args);
+    va_end(args);
+}
+
+void PsychPythonErrPrintf(const char* format, ...)
+{
+    va_list args;
+
+    va_start(args, format);
+    PsychPythonVPrintf(1, format, args);
+    va_end(args);
+}
+
+/*     PsychBeginBlockingRegion() - Release the Python GIL for a potentially long blocking region.
+ *
+ *     Releases the GIL until PsychEndBlockingRegion(), so other Python threads can run while this
+ *     subfunction waits. The code in between must not touch any Python objects. Output of printf()
+ *     is deferred until PsychEndBlockingRegion(), as printing needs the GIL. Only acts
+ *     on the thread which executes the current module call, and only once per call recursion level.
+ *     PsychErrorExit() et al. and the dispatcher reacquire the GIL automatically if needed.
+ */
+void PsychBeginBlockingRegion(void)
+{
+    if ((recLevel < 0) || (dispatchDepthGLUE <= 0) || threadStateGLUE[recLevel] || !PsychIsCurrentThreadEqualToId(dispatchOwnerGLUE))
+        return;
+
+    threadStateGLUE[recLevel] = PyEval_SaveThread();
+}
+
+/*     PsychEndBlockingRegion() - Reacquire the Python GIL at the end of a blocking region.
+ *
+ *     No-op if the GIL is not released by a PsychBeginBlockingRegion() at the current recursion level.
+ */
+void PsychEndBlockingRegion(void)
+{
+    PyThreadState* state;
+
+    if ((recLevel < 0) || !threadStateGLUE[recLevel] || !PsychIsCurrentThreadEqualToId(dispatchOwnerGLUE))
+        return;
+
+    state = threadStateGLUE[recLevel];
+    threadStateGLUE[recLevel] = NULL;
+    PyEval_RestoreThread(state);
+
+    // Print output which was deferred while we didn't hold the GIL:
+    if (deferredOutputLenGLUE[0]) {
+        PySys_FormatStdout("%s", deferredOutputGLUE[0]);
+        deferredOutputLenGLUE[0] = 0;
+    }
+
+    if (deferredOutputLenGLUE[1]) {
+        PySys_FormatStderr("%s", deferredOutputGLUE[1]);
+        deferredOutputLenGLUE[1] = 0;
+    }
+}
+
+// Acquire dispatch lock for the calling thread. Called with the GIL held. Releases the GIL while
+// waiting for another thread to finish its module call, so that thread can get the GIL back:
+static void PsychPythonGlueLockDispatch(void)
+{
+    // Recursive call from the owning thread?
+    if ((dispatchDepthGLUE > 0) && PsychIsCurrentThreadEqualToId(dispatchOwnerGLUE)) {
+        dispatchDepthGLUE++;
+        return;
+    }
+
+    if (PsychTryLockMutex(&dispatchMutexGLUE)) {
+        Py_BEGIN_ALLOW_THREADS
+        PsychLockMutex(&dispatchMutexGLUE);
+        Py_END_ALLOW_THREADS
+    }
+
+    dispatchOwnerGLUE = PsychGetThreadId();
+    dispatchDepthGLUE = 1;
+}
+
+static void PsychPythonGlueUnlockDispatch(void)
+{
+    if (--dispatchDepthGLUE == 0)
+        PsychUnlockMutex(&dispatchMutexGLUE);
+}
+
 
 /*
  *
@@ -904,7 +1045,11 @@ psych_bool PsychUseCMemoryLayoutIfOptimal(psych_bool tryEnableCMemoryLayout)
  *        Modules should now register in subfunction mode to support the build-in 'version' command.
  *
  */
-PyObject* PsychScriptingGluePythonDispatch(PyObject* self, PyObject* args)
+#if PSYCH_PYTHON_FASTCALL
+PyObject* PsychScriptingGluePythonDispatch(PyObject* self, PyObject* const* args, Py_ssize_t nargs)
+#else
+PyObject* PsychScriptingGluePythonDispatch(PyObject* self, PyObject* argsTuple)
+#endif
 {
     psych_bool          isArgThere[2], isArgEmptyMat[2], isArgText[2], isArgFunction[2];
     PsychFunctionPtr    fArg[2], baseFunction;
@@ -912,13 +1057,33 @@ PyObject* PsychScriptingGluePythonDispatch(PyObject* self, PyObject* args)
     PyObject*           tmparg = NULL;
     PyObject*           plhs = NULL;
     int                 i;
-    int                 nrhs = (int) PyTuple_Size(args);
+    int                 nrhs;
+
+    #if !PSYCH_PYTHON_FASTCALL
+    PyObject*           args[MAX_INPUT_ARGS];
+    Py_ssize_t          nargs;
 
-    if (!PyTuple_Check(args)) {
+    if (!PyTuple_Check(argsTuple)) {
         printf("FAIL FAIL FAIL!\n");
         return(NULL);
     }
 
+    nargs = PyTuple_Size(argsTuple);
+    #endif
+
+    if (nargs > MAX_INPUT_ARGS) {
+        PyErr_Format(PyExc_TypeError, "%s: Too many input arguments (%i), at most %i are supported.", PPYNAME(PTBMODULENAME), (int) nargs, MAX_INPUT_ARGS);
+        return(NULL);
+    }
+
+    #if !PSYCH_PYTHON_FASTCALL
+    // Get the tuple items as a C array of borrowed references, just like METH_FASTCALL passes them:
+    for (i = 0; i < (int) nargs; i++)
+        args[i] = PyTuple_GetItem(argsTuple, i);
+    #endif
+
+    nrhs = (int) nargs;
+
     // Initialization
     if (firstTime) {
         // Reset call recursion level to startup default:
@@ -932,6 +1097,12 @@ PyObject* PsychScriptingGluePythonDispatch(PyObject* self, PyObject* args)
         // Initialize NumPy array extension for use in *this compilation unit* only:
         (void) init_numpy();
 
+        // Dispatch lock survives module shutdown via "Shutdown", as we are executing under it:
+        if (!dispatchMutexInitializedGLUE) {
+            PsychInitMutex(&dispatchMutexGLUE);
+            dispatchMutexInitializedGLUE = TRUE;
+        }
+
         // Call the Psychtoolbox init function, which inits the Psychtoolbox and calls the project init.
         PsychInit();
 
@@ -946,9 +1117,20 @@ PyObject* PsychScriptingGluePythonDispatch(PyObject* self, PyObject* args)
         // generator script to find out about subfunctions of a module:
         PsychRegister((char*) "DescribeModuleFunctionsHelper",  &PsychDescribeModuleFunctions);
 
+        // Register hidden helper function: Microbenchmark of our temporary memory allocator:
+        PsychRegister((char*) "TempMemoryBenchmarkHelper",  &PsychTempMemoryBenchmark);
+
+        // Register hidden helper functions: Microbenchmark of struct output, and selection of
+        // struct output format for struct builders:
+        PsychRegister((char*) "StructBuilderBenchmarkHelper",  &PsychStructBuilderBenchmark);
+        PsychRegister((char*) "StructRecordsHelper",  &PsychStructRecordsHelper);
+
         firstTime = FALSE;
     }
 
+    // Only one Python thread at a time executes in this module:
+    PsychPythonGlueLockDispatch();
+
     // Increment call recursion level for this invocation of the module:
     recLevel++;
     if (recLevel >= MAX_RECURSIONLEVEL) {
@@ -956,9 +1138,16 @@ PyObject* PsychScriptingGluePythonDispatch(PyObject* self, PyObject* args)
         printf("PTB-CRITICAL: Maximum recursion level %i for recursive calls into module '%s' exceeded!\n", recLevel, PsychGetModuleName());
         printf("PTB-CRITICAL: Aborting call sequence. Check code for recursion bugs!\n");
         recLevel--;
+        PsychPythonGlueUnlockDispatch();
         return(NULL);
     }
 
+    // GIL is held at entry:
+    threadStateGLUE[recLevel] = NULL;
+
+    // Temporary memory allocated from now on belongs to this call recursion level:
+    PsychPushTempMemoryLevel();
+
     if (psych_recursion_debug) printf("PTB-DEBUG: Module %s entering recursive call level %i.\n", PsychGetModuleName(), recLevel);
 
     // Default to not using C memory layout, but classic (backwards compatible) Fortran layout:
@@ -979,7 +1168,7 @@ PyObject* PsychScriptingGluePythonDispatch(PyObject* self, PyObject* args)
 
     nrhsGLUE[recLevel] = nrhs;
     for (i = 0; i < nrhs; i++) {
-        tmparg = PyTuple_GetItem(args, i);
+        tmparg = args[i];
         prhsGLUE[recLevel][i] = tmparg;
 
         // Empty args, strings and structs are special - handled directly the Python way.
@@ -1162,7 +1351,9 @@ PyObject* PsychScriptingGluePythonDispatch(PyObject* self, PyObject* args)
     } //close else
 
     // If we reach this point of execution, then we're successfully done with function execution
-    // and just need to return return arguments and clean up:
+    // and just need to return return arguments and clean up. Reacquire GIL, in case the subfunction
+    // forgot to end a blocking region:
+    PsychEndBlockingRegion();
     if (psych_refcount_debug) {
         for (i = 0; i < MAX_OUTPUT_ARGS; i++) {
             if (plhsGLUE[recLevel][i] && (PyArray_REFCOUNT(plhsGLUE[recLevel][i]) >= psych_refcount_debug))
@@ -1230,6 +1421,7 @@ PyObject* PsychScriptingGluePythonDispatch(PyObject* self, PyObject* args)
 PythonFunctionCleanup:
     // The following code is executed both at end of normal execution, and also
     // during an error return. It has to do the common cleanup work:
+    PsychEndBlockingRegion();
 
     // Release references to NumPy PyArrays, as the PyObject -> PyArray code always
     // returns a new reference which we should get rid off, now that we don't need
@@ -1261,6 +1453,9 @@ PythonFunctionCleanup:
     // Done with this call recursion level:
     PsychExitRecursion();
 
+    // Let other Python threads into the module again:
+    PsychPythonGlueUnlockDispatch();
+
     // Return PyObject tuple with all return arguments:
     return(plhs);
 }
@@ -1331,7 +1526,7 @@ static PyObject* PsychPyArgGet(int position)
         // At the end of this ballet, if this was a no-op conversion, then the
         // reference count of prhsGLUE should be unchanged. If it was a real
         // conversion, then only the Python interpreter should hold references
-        // original prhsGLUE input argument aka the 'args' input tuple argument
+        // original prhsGLUE input argument aka the 'args' input argument array
         // to the PsychScriptingGluePythonDispatch(), and our new updated prhsGLUE,
         // aka ret is a new refcount == 1 NumPy array of suitable format and memory
         // layout, which we can now use and will dispose of in PythonFunctionCleanup
@@ -2169,6 +2364,101 @@ psych_bool PsychAllocOutUnsignedInt16MatArg(int position, PsychArgRequirementTyp
 }
 
 
+// Owner of the memory of a NumPy array returned by PsychCopyOutExternalMatArg(), attached to
+// the array as its base object, so the memory gets released when the array is destroyed:
+typedef struct PsychExternalMatOwner {
+    PsychExternalMatReleaseFunc releaseFunc;
+    void*                       releaseArg;
+} PsychExternalMatOwner;
+
+static void PsychExternalMatOwnerDestructor(PyObject *capsule)
+{
+    PsychExternalMatOwner *owner = (PsychExternalMatOwner*) PyCapsule_GetPointer(capsule, "PsychExternalMatOwner");
+
+    if (owner) {
+        owner->releaseFunc(owner->releaseArg);
+        free(owner);
+    }
+}
+
+/*
+ *    PsychCopyOutExternalMatArg()
+ *
+ *    Return the m x n x p matrix of uint8 or uint16 elements 'fromArray', stored in column-major
+ *    order, without copying it. The returned NumPy array is a read-only view of 'fromArray', which
+ *    keeps it alive until the array is destroyed, then releaseFunc(releaseArg) gets called. If the
+ *    calling subfunction opted into C memory layout, the view has shape p x n x m instead, which is
+ *    the same memory. If the argument is not returned, releaseFunc(releaseArg) is called immediately.
+ */
+psych_bool PsychCopyOutExternalMatArg(int position, PsychArgRequirementType isRequired, psych_int64 m, psych_int64 n, psych_int64 p,
+                                      PsychArgFormatType type, void *fromArray, PsychExternalMatReleaseFunc releaseFunc, void *releaseArg)
+{
+    PyObject                **mxpp;
+    PyObject                *capsule;
+    PsychError              matchError;
+    psych_bool              putOut;
+    npy_intp                dimArray[3];
+    int                     numDims;
+    PsychExternalMatOwner   *owner;
+
+    if (type != PsychArgType_uint8 && type != PsychArgType_uint16)
+        PsychErrorExitMsg(PsychError_internal, "PsychCopyOutExternalMatArg() called with unsupported matrix type!");
+
+    PsychSetReceivedArgDescriptor(position, TRUE, PsychArgOut);
+    PsychSetSpecifiedArgDescriptor(position, PsychArgOut, type, isRequired, m, m, n, n, p, p);
+    matchError = PsychMatchDescriptors();
+    putOut = PsychAcceptOutputArgumentDecider(isRequired, matchError);
+
+    // Empty matrices have no memory to share:
+    if (!putOut || m <= 0 || n <= 0) {
+        releaseFunc(releaseArg);
+        if (putOut) {
+            dimArray[0] = 0; dimArray[1] = 0;
+            *PsychGetOutArgPyPtr(position) = mxCreateNumericArray(2, (ptbSize*) dimArray, type);
+        }
+
+        return(putOut);
+    }
+
+    PsychCheckSizeLimits(m, n, p);
+    numDims = (p == 0 || p == 1) ? 2 : 3;
+    if (use_C_memory_layout[recLevel]) {
+        // Same memory, viewed with reversed order of dimensions:
+        dimArray[0] = (npy_intp) ((numDims == 3) ? p : n);
+        dimArray[1] = (npy_intp) ((numDims == 3) ? n : m);
+        dimArray[2] = (npy_intp) m;
+    } else {
+        dimArray[0] = (npy_intp) m; dimArray[1] = (npy_intp) n; dimArray[2] = (npy_intp) p;
+    }
+
+    owner = (PsychExternalMatOwner*) malloc(sizeof(PsychExternalMatOwner));
+    if (NULL == owner) {
+        releaseFunc(releaseArg);
+        PsychErrorExitMsg(PsychError_outofMemory, "Out of memory while trying to return an external matrix!");
+    }
+
+    owner->releaseFunc = releaseFunc;
+    owner->releaseArg = releaseArg;
+
+    mxpp = PsychGetOutArgPyPtr(position);
+    *mxpp = PyArray_New(&PyArray_Type, numDims, dimArray, PsychGetNumTypeFromArgType(type), NULL, fromArray, 0,
+                        ((use_C_memory_layout[recLevel]) ? NPY_ARRAY_C_CONTIGUOUS : NPY_ARRAY_F_CONTIGUOUS) | NPY_ARRAY_ALIGNED, NULL);
+    capsule = (*mxpp) ? PyCapsule_New(owner, "PsychExternalMatOwner", PsychExternalMatOwnerDestructor) : NULL;
+    if (NULL == capsule) {
+        Py_XDECREF(*mxpp);
+        *mxpp = NULL;
+        releaseFunc(releaseArg);
+        free(owner);
+        PsychErrorExitMsg(PsychError_outofMemory, "Out of memory while trying to return an external matrix!");
+    }
+
+    // Steals our reference to the capsule:
+    PyArray_SetBaseObject((PyArrayObject*) *mxpp, capsule);
+
+    return(putOut);
+}
+
+
 psych_bool PsychCopyOutDoubleMatArg(int position, PsychArgRequirementType isRequired, psych_int64 m, psych_int64 n, psych_int64 p, double *fromArray)
 {
     PyObject    **mxpp;
@@ -2302,6 +2592,43 @@ psych_bool PsychAllocInDoubleMatArg64(int position, PsychArgRequirementType isRe
 }
 
 
+/*
+ *    PsychAllocInNativeMatArg64()
+ *
+ *    Like PsychAllocInDoubleMatArg64(), but accepts a matrix of any of the numeric types in the
+ *    'acceptedTypes' bitmask of PsychArgType_xxx flags, e.g., PsychArgType_single | PsychArgType_int16.
+ *    The data is returned in its native type, which is returned in *type, so the caller can handle
+ *    each type appropriately, e.g., convert it while copying it into its own buffers. The data of
+ *    the input matrix is passed through without any copy or conversion if it is a
+ *    NumPy array which is aligned and contiguous in the memory layout selected for the current call,
+ *    ie. C layout if the subfunction opted in via PsychUseCMemoryLayoutIfOptimal(TRUE), Fortran layout
+ *    otherwise. Other inputs, e.g., Python lists or non-contiguous array slices, are copied once into
+ *    a NumPy array of matching layout, but still keep their type.
+ *
+ */
+psych_bool PsychAllocInNativeMatArg64(int position, PsychArgRequirementType isRequired, PsychArgFormatType acceptedTypes,
+                                      psych_int64 *m, psych_int64 *n, psych_int64 *p, PsychArgFormatType *type, void **array)
+{
+    const PyObject    *ppyPtr;
+    PsychError        matchError;
+    psych_bool        acceptArg;
+
+    PsychSetReceivedArgDescriptor(position, TRUE, PsychArgIn);
+    PsychSetSpecifiedArgDescriptor(position, PsychArgIn, acceptedTypes, isRequired, 1, -1, 1, -1, 0, -1);
+    matchError = PsychMatchDescriptors();
+    acceptArg = PsychAcceptInputArgumentDecider(isRequired, matchError);
+    if (acceptArg) {
+        ppyPtr = (PyObject*) PsychGetInArgPyPtr(position);
+        *m = (psych_int64) mxGetM(ppyPtr);
+        *n = (psych_int64) mxGetNOnly(ppyPtr);
+        *p = (psych_int64) mxGetP(ppyPtr);
+        *type = PsychGetTypeFromPyPtr(ppyPtr);
+        *array = mxGetData(ppyPtr);
+    }
+    return(acceptArg);
+}
+
+
 /* Like PsychAllocInFloatMatArg64, but with 32-Bit int type size return-arguments. */
 psych_bool PsychAllocInFloatMatArg(int position, PsychArgRequirementType isRequired, int *m, int *n, int *p, float **array)
 {
@@ -3364,6 +3691,352 @@ void PsychSetStructArrayNativeElement(const char *fieldName,
 }
 
 
+// Struct builder functions
+///////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+///////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+// Field set of a struct builder: The field names of one kind of struct, resolved once into interned
+// Python unicode dictionary keys, and the struct sequence type for returning such structs as records.
+// Field sets are created on first use and then kept for the lifetime of the module, as the field names
+// are referenced by the record type. The same set of field names usually comes from the same static
+// fieldNames array of a subfunction, so the number of field sets per module is small:
+#define MAX_STRUCTFIELDSETS 64
+
+typedef struct PsychStructFieldSet {
+    int                         numFields;
+    char                        **names;        // Our own copy of the field names.
+    PyObject                    **keys;         // Interned unicode keys for struct dicts.
+    PyStructSequence_Field      *recordFields;  // Field descriptions for record type.
+    PyStructSequence_Desc       recordDesc;     // Description of record type.
+    PyTypeObject                *recordType;    // Record type, created on first use.
+} PsychStructFieldSet;
+
+static PsychStructFieldSet structFieldSetsGLUE[MAX_STRUCTFIELDSETS];
+static int numStructFieldSetsGLUE = 0;
+static int lastStructFieldSetGLUE = 0;
+
+// Return structs from struct builders as struct sequence records instead of dicts?
+static psych_bool useStructRecordsGLUE = FALSE;
+
+// Find or create field set for field names 'fieldNames':
+static PsychStructFieldSet* PsychGetStructFieldSet(int numFields, const char **fieldNames)
+{
+    PsychStructFieldSet *set;
+    int i, j;
+
+    // Try the most recently used field set first, then all others:
+    for (i = 0; i < numStructFieldSetsGLUE; i++) {
+        set = &structFieldSetsGLUE[(lastStructFieldSetGLUE + i) % numStructFieldSetsGLUE];
+        if (set->numFields != numFields)
+            continue;
+
+        for (j = 0; j < numFields; j++)
+            if (strcmp(set->names[j], fieldNames[j]))
+                break;
+
+        if (j == numFields) {
+            lastStructFieldSetGLUE = (lastStructFieldSetGLUE + i) % numStructFieldSetsGLUE;
+            return(set);
+        }
+    }
+
+    if (numStructFieldSetsGLUE >= MAX_STRUCTFIELDSETS)
+        PsychErrorExitMsg(PsychError_internal, "Error: PsychAllocOutStructBuilder: Too many different struct types!");
+
+    if (numFields < 1)
+        PsychErrorExitMsg(PsychError_internal, "Error: PsychAllocOutStructBuilder: numFields < 1 ?!?");
+
+    // Create new field set:
+    set = &structFieldSetsGLUE[numStructFieldSetsGLUE];
+    set->numFields = numFields;
+    set->names = (char**) calloc(numFields, sizeof(char*));
+    set->keys = (PyObject**) calloc(numFields, sizeof(PyObject*));
+    set->recordFields = (PyStructSequence_Field*) calloc(numFields + 1, sizeof(PyStructSequence_Field));
+    set->recordType = NULL;
+    if (!set->names || !set->keys || !set->recordFields)
+        PsychErrorExitMsg(PsychError_outofMemory, "Error: PsychAllocOutStructBuilder: Out of memory!");
+
+    for (j = 0; j < numFields; j++) {
+        set->names[j] = strdup(fieldNames[j]);
+        set->keys[j] = PyUnicode_InternFromString(fieldNames[j]);
+        if (!set->names[j] || !set->keys[j])
+            PsychErrorExitMsg(PsychError_internal, "Error: PsychAllocOutStructBuilder: Failed to create field name key!");
+
+        set->recordFields[j].name = set->names[j];
+        set->recordFields[j].doc = NULL;
+    }
+
+    set->recordDesc.name = (char*) "psychtoolbox.StructRecord";
+    set->recordDesc.doc = NULL;
+    set->recordDesc.fields = set->recordFields;
+    set->recordDesc.n_in_sequence = numFields;
+
+    lastStructFieldSetGLUE = numStructFieldSetsGLUE++;
+
+    return(set);
+}
+
+/*
+    PsychAllocOutStructBuilder()
+
+    Like PsychAllocOutStructArray(), but returns a builder for setting the fields of the new struct
+    array by field index instead of by field name. The field index is the index of the field name in
+    'fieldNames'. Dictionary keys of all fields are resolved once per kind of struct and cached, so
+    setting a field is a single dictionary insert with a prehashed key.
+
+    If record output is enabled via the hidden 'StructRecordsHelper' subfunction, each struct is
+    created as a struct sequence record instead of a dict, which is a tuple with named fields like
+    a namedtuple, ie. fields are accessed as record.fieldname instead of struct['fieldname'].
+*/
+psych_bool PsychAllocOutStructBuilder(int position,
+                                      PsychArgRequirementType isRequired,
+                                      int numElements,
+                                      int numFields,
+                                      const char **fieldNames,
+                                      PsychStructBuilder *builder)
+{
+    PyObject            **mxArrayOut;
+    PsychStructFieldSet *set;
+    PyObject            *slot;
+    PsychError          matchError;
+    psych_bool          putOut = TRUE;
+    int                 i, j, n;
+
+    if (numElements < -1)
+        PsychErrorExitMsg(PsychError_internal, "Error: PsychAllocOutStructBuilder: Negative number of array elements requested?!?");
+
+    if (position != kPsychNoArgReturn) {
+        // Return the result to both the C caller and the scripting environment.
+        PsychSetReceivedArgDescriptor(position, FALSE, PsychArgOut);
+        PsychSetSpecifiedArgDescriptor(position, PsychArgOut, PsychArgType_structArray, isRequired, 1, 1, abs(numElements), abs(numElements), 0, 0);
+        matchError = PsychMatchDescriptors();
+        putOut = PsychAcceptOutputArgumentDecider(isRequired, matchError);
+    }
+
+    set = PsychGetStructFieldSet(numFields, fieldNames);
+    if (useStructRecordsGLUE && !set->recordType) {
+        set->recordType = PyStructSequence_NewType(&set->recordDesc);
+        if (!set->recordType)
+            PsychErrorExitMsg(PsychError_internal, "Error: PsychAllocOutStructBuilder: Failed to create record type!");
+    }
+
+    builder->numElements = numElements;
+    builder->numFields = numFields;
+    builder->fieldSlots = (void*) set;
+
+    // Create a list of slots - the struct array - with each slot being a dict or record
+    // with all fields initialized to None, or just a single slot if numElements == -1:
+    builder->pStruct = (numElements != -1) ? PyList_New((Py_ssize_t) numElements) : NULL;
+    n = abs(numElements);
+
+    for (i = 0; i < n; i++) {
+        if (useStructRecordsGLUE) {
+            slot = PyStructSequence_New(set->recordType);
+            for (j = 0; slot && (j < numFields); j++) {
+                Py_INCREF(Py_None);
+                PyStructSequence_SetItem(slot, j, Py_None);
+            }
+        }
+        else {
+            slot = PyDict_New();
+            for (j = 0; slot && (j < numFields); j++) {
+                if (PyDict_SetItem(slot, set->keys[j], Py_None))
+                    PsychErrorExitMsg(PsychError_internal, "Error: PsychAllocOutStructBuilder: Failed to init struct-Array slot with item!");
+            }
+        }
+
+        if (!slot)
+            PsychErrorExitMsg(PsychError_outofMemory, "Error: PsychAllocOutStructBuilder: Failed to create struct!");
+
+        if (numElements != -1)
+            PyList_SetItem(builder->pStruct, i, slot);
+        else
+            builder->pStruct = slot;
+    }
+
+    if ((position != kPsychNoArgReturn) && putOut) {
+        mxArrayOut = PsychGetOutArgPyPtr(position);
+        *mxArrayOut = builder->pStruct;
+    }
+
+    return(putOut);
+}
+
+// Assign pValue to field fieldIndex of element index of the struct array of 'builder'.
+// Steals the reference to pValue, irrespective of success or failure:
+static void PsychSetStructBuilderElement(PsychStructBuilder *builder, int fieldIndex, int index, PyObject *pValue)
+{
+    PsychStructFieldSet *set = (PsychStructFieldSet*) builder->fieldSlots;
+    PyObject *slot, *oldValue;
+
+    if (!pValue)
+        PsychErrorExitMsg(PsychError_outofMemory, "Error: PsychSetStructBuilderElement: Failed to create field value!");
+
+    if ((fieldIndex < 0) || (fieldIndex >= builder->numFields)) {
+        Py_DECREF(pValue);
+        PsychErrorExitMsg(PsychError_internal, "Attempt to set a non-existent structure field index");
+    }
+
+    if ((index < 0) || (index >= abs(builder->numElements))) {
+        Py_DECREF(pValue);
+        PsychErrorExitMsg(PsychError_internal, "Attempt to set a structure field at an out-of-bounds index");
+    }
+
+    slot = (builder->numElements != -1) ? PyList_GetItem(builder->pStruct, index) : builder->pStruct;
+
+    if (PyDict_Check(slot)) {
+        // Dict insert, which gets its own reference to pValue:
+        if (PyDict_SetItem(slot, set->keys[fieldIndex], pValue)) {
+            Py_DECREF(pValue);
+            PsychErrorExitMsg(PsychError_internal, "Error: PsychSetStructBuilderElement: PyDict_SetItem() failed!");
+        }
+
+        Py_DECREF(pValue);
+    }
+    else {
+        // Record: PyStructSequence_SetItem() steals the reference to pValue, but does not
+        // release the previous value, so we have to:
+        oldValue = PyStructSequence_GetItem(slot, fieldIndex);
+        PyStructSequence_SetItem(slot, fieldIndex, pValue);
+        Py_XDECREF(oldValue);
+    }
+}
+
+void PsychSetStructBuilderStringElement(PsychStructBuilder *builder,
+                                        int fieldIndex,
+                                        int index,
+                                        const char *text)
+{
+    PsychSetStructBuilderElement(builder, fieldIndex, index, mxCreateString(text));
+}
+
+void PsychSetStructBuilderDoubleElement(PsychStructBuilder *builder,
+                                        int fieldIndex,
+                                        int index,
+                                        double value)
+{
+    PsychSetStructBuilderElement(builder, fieldIndex, index, PyFloat_FromDouble(value));
+}
+
+void PsychSetStructBuilderBooleanElement(PsychStructBuilder *builder,
+                                         int fieldIndex,
+                                         int index,
+                                         psych_bool state)
+{
+    PsychSetStructBuilderElement(builder, fieldIndex, index, PyBool_FromLong((long) state));
+}
+
+/*
+ * PsychSetStructBuilderNativeElement()
+ *
+ * Irrespective of success or failure, this steals the reference to pNativeElement, like
+ * PsychSetStructArrayNativeElement().
+ */
+void PsychSetStructBuilderNativeElement(PsychStructBuilder *builder,
+                                        int fieldIndex,
+                                        int index,
+                                        PsychGenericScriptType *pNativeElement)
+{
+    PsychSetStructBuilderElement(builder, fieldIndex, index, pNativeElement);
+}
+
+// Select struct builder output format, registered by the scripting glue:
+PsychError PsychStructRecordsHelper(void)
+{
+    static char useString[] = "oldEnable = Modulename('StructRecordsHelper' [, enable]);";
+    static char synopsisString[] = "Select output format of structs returned by some subfunctions of this module.\n"
+                                   "If 'enable' is 1, structs are returned as lightweight records, ie. struct sequences "
+                                   "which behave like named tuples, with fields accessed as record.fieldname. If 'enable' "
+                                   "is 0, the default, structs are returned as dicts. Only subfunctions which were optimized "
+                                   "for fast struct output support records, all others always return dicts.\n"
+                                   "Returns the previous setting.\n";
+    static char seeAlsoString[] = "";
+
+    int enable;
+
+    // All subfunctions should have these two lines:
+    PsychPushHelp(useString, synopsisString, seeAlsoString);
+    if (PsychIsGiveHelp()) { PsychGiveHelp(); return(PsychError_none); };
+
+    PsychErrorExit(PsychCapNumInputArgs(1));
+    PsychErrorExit(PsychCapNumOutputArgs(1));
+
+    PsychCopyOutDoubleArg(1, kPsychArgOptional, (double) useStructRecordsGLUE);
+
+    if (PsychCopyInIntegerArg(1, kPsychArgOptional, &enable))
+        useStructRecordsGLUE = (enable > 0) ? TRUE : FALSE;
+
+    return(PsychError_none);
+}
+
+// Microbenchmark of struct output, registered by the scripting glue:
+PsychError PsychStructBuilderBenchmark(void)
+{
+    static char useString[] = "[nameSecs, builderSecs] = Modulename('StructBuilderBenchmarkHelper' [, numStructs=10000][, numElements=-1]);";
+    static char synopsisString[] = "Benchmark creation of output structs with many fields.\n"
+                                   "Creates 'numStructs' structs with 23 double fields each, similar to the struct returned by "
+                                   "PsychPortAudio('GetStatus'), once by setting each field by name via PsychSetStructArrayDoubleElement(), "
+                                   "once via a struct builder which sets fields by index. 'numElements' selects struct arrays of that "
+                                   "many elements instead of single structs.\n"
+                                   "Returns the average time per struct in seconds for both methods, including the release of the struct.\n";
+    static char seeAlsoString[] = "";
+
+    static const char *fieldNames[] = { "Active", "State", "RequestedStartTime", "StartTime", "CaptureStartTime", "RequestedStopTime",
+                                        "EstimatedStopTime", "CurrentStreamTime", "ElapsedOutSamples", "PositionSecs", "RecordedSecs",
+                                        "ReadSecs", "SchedulePosition", "XRuns", "TotalCalls", "TimeFailed", "BufferSize", "CPULoad",
+                                        "PredictedLatency", "LatencyBias", "SampleRate", "OutDeviceIndex", "InDeviceIndex" };
+    const int           numFields = 23;
+    int                 numStructs = 10000, numElements = -1, i, j, k;
+    PsychGenericScriptType *pStruct;
+    PsychStructBuilder  builder;
+    double              tStart, tEnd, nameSecs, builderSecs;
+
+    // All subfunctions should have these two lines:
+    PsychPushHelp(useString, synopsisString, seeAlsoString);
+    if (PsychIsGiveHelp()) { PsychGiveHelp(); return(PsychError_none); };
+
+    PsychErrorExit(PsychCapNumInputArgs(2));
+    PsychErrorExit(PsychCapNumOutputArgs(2));
+
+    PsychCopyInIntegerArg(1, kPsychArgOptional, &numStructs);
+    if (numStructs < 1)
+        PsychErrorExitMsg(PsychError_user, "Invalid 'numStructs' specified. Must be at least 1.");
+
+    PsychCopyInIntegerArg(2, kPsychArgOptional, &numElements);
+    if ((numElements < 1) && (numElements != -1))
+        PsychErrorExitMsg(PsychError_user, "Invalid 'numElements' specified. Must be -1 or at least 1.");
+
+    // Set fields by name:
+    PsychGetAdjustedPrecisionTimerSeconds(&tStart);
+    for (i = 0; i < numStructs; i++) {
+        PsychAllocOutStructArray(kPsychNoArgReturn, kPsychArgOptional, numElements, numFields, fieldNames, &pStruct);
+        for (k = 0; k < abs(numElements); k++)
+            for (j = 0; j < numFields; j++)
+                PsychSetStructArrayDoubleElement(fieldNames[j], k, (double) j, pStruct);
+        Py_DECREF(pStruct);
+    }
+    PsychGetAdjustedPrecisionTimerSeconds(&tEnd);
+    nameSecs = (tEnd - tStart) / numStructs;
+
+    // Set fields by index via struct builder:
+    PsychGetAdjustedPrecisionTimerSeconds(&tStart);
+    for (i = 0; i < numStructs; i++) {
+        PsychAllocOutStructBuilder(kPsychNoArgReturn, kPsychArgOptional, numElements, numFields, fieldNames, &builder);
+        for (k = 0; k < abs(numElements); k++)
+            for (j = 0; j < numFields; j++)
+                PsychSetStructBuilderDoubleElement(&builder, j, k, (double) j);
+        Py_DECREF(builder.pStruct);
+    }
+    PsychGetAdjustedPrecisionTimerSeconds(&tEnd);
+    builderSecs = (tEnd - tStart) / numStructs;
+
+    PsychCopyOutDoubleArg(1, kPsychArgOptional, nameSecs);
+    PsychCopyOutDoubleArg(2, kPsychArgOptional, builderSecs);
+
+    return(PsychError_none);
+}
+
+
 /*
  *    PsychAllocOutCellVector()
  *
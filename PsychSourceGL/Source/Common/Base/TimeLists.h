@@ -17,7 +17,7 @@
 	DESCRIPTION:
 
 		For purposes of instrumenting Screen, maintain times samples in an abstract list type.  Internally we use a 
-		linked list.  To external functions reading out values, it appears to be an array.
+		growable array.  To external functions reading out values, it appears to be an array.
 */
 
 //begin include once 
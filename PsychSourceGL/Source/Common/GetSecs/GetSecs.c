@@ -36,6 +36,9 @@ const char** InitializeSynopsis(void)
     int i = 0;
     const char **synopsis = synopsisSYNOPSIS;
     synopsis[i++] = "[GetSecsTime, WallTime, syncErrorSecs, MonotonicTime] = GetSecs('AllClocks' [, maxError=0.000020]);";
+    synopsis[i++] = "[timebaseName, offsetSecs, resolutionSecs] = GetSecs('Timebase');";
+    synopsis[i++] = "domains = GetSecs('ClockDomains' [, command, domainName, ...]);";
+    synopsis[i++] = "[enabled, numEvents] = GetSecs('Trace' [, command, ...]);";
     synopsis[i++] = NULL;
 
     return(synopsisSYNOPSIS);
@@ -197,3 +200,46 @@ PsychError GETSECSAllClocks(void)
 
     return(PsychError_none);
 }
+
+PsychError GETSECSTimebase(void)
+{
+    static char useString[] = "[timebaseName, offsetSecs, resolutionSecs] = GetSecs('Timebase');";
+    //                          1             2           3
+    static char synopsisString[] =
+    "Return information about the clock which is used as timebase for GetSecs time.\n\n"
+    "'timebaseName' is the name of the timebase. On Linux, it can be selected via the environment variable "
+    "PSYCH_GETSECS_TIMEBASE before the first Psychtoolbox function is called, and is one of:\n"
+    "'gettimeofday' = gettimeofday(), seconds since 1. January 1970, with microsecond resolution.\n"
+    "'realtime' = Posix clock CLOCK_REALTIME, same as gettimeofday(), but with nanosecond resolution.\n"
+    "'monotonic' = Posix clock CLOCK_MONOTONIC, not subject to system time changes by the administrator or NTP, "
+    "plus a constant offset to the gettimeofday() epoch, measured at startup. This is the default.\n"
+    "'monotonicraw' = Posix clock CLOCK_MONOTONIC_RAW, like 'monotonic', but not slewed by NTP either. "
+    "Will drift against other clocks of the system, so only use it if you know why.\n"
+    "On other operating systems, 'timebaseName' is always 'native'.\n\n"
+    "'offsetSecs' is the constant offset added to the timebase clock to get GetSecs time, zero if none.\n\n"
+    "'resolutionSecs' is the resolution of the timebase clock in seconds, as reported by the operating system.\n";
+    static char seeAlsoString[] = "AllClocks";
+
+    const char *name = "native";
+    double offset = 0, resolution;
+
+    // All sub functions should have these two lines:
+    PsychPushHelp(useString, synopsisString, seeAlsoString);
+    if (PsychIsGiveHelp()) { PsychGiveHelp(); return(PsychError_none); };
+
+    // Check to see if the user supplied superfluous arguments
+    PsychErrorExit(PsychCapNumOutputArgs(3));
+    PsychErrorExit(PsychCapNumInputArgs(0));
+
+    #if PSYCH_SYSTEM == PSYCH_LINUX
+        PsychOSGetTimebase(&name, &offset, &resolution);
+    #else
+        resolution = 1.0 / PsychGetKernelTimebaseFrequencyHz();
+    #endif
+
+    PsychCopyOutCharArg(1, kPsychArgOptional, name);
+    PsychCopyOutDoubleArg(2, kPsychArgOptional, offset);
+    PsychCopyOutDoubleArg(3, kPsychArgOptional, resolution);
+
+    return(PsychError_none);
+}
@@ -33,6 +33,7 @@ const char** InitializeSynopsis(void);
 PsychError MODULEVersion(void);
 PsychError GETSECSGetSecs(void);
 PsychError GETSECSAllClocks(void);
+PsychError GETSECSTimebase(void);
 
 //end include once
 #endif
@@ -36,6 +36,9 @@ PsychError PsychModuleInit(void)
 
     PsychErrorExit(PsychRegister("Version",  &MODULEVersion));
     PsychErrorExit(PsychRegister("AllClocks",  &GETSECSAllClocks));
+    PsychErrorExit(PsychRegister("Timebase",  &GETSECSTimebase));
+    PsychErrorExit(PsychRegister("ClockDomains",  &PsychClockDomainsSubfunction));
+    PsychErrorExit(PsychRegister("Trace",  &PsychTraceSubfunction));
 
     //register the module name
     PsychErrorExit(PsychRegister("GetSecs", NULL));
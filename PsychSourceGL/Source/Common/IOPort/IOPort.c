@@ -61,6 +61,8 @@ const char** InitializeSynopsis(void)
     synopsis[i++] = "[data, when, errmsg] = IOPort('Read', handle [, blocking=0] [, amount]);";
     synopsis[i++] = "navailable = IOPort('BytesAvailable', handle);";
     synopsis[i++] = "IOPort('Purge', handle);";
+    synopsis[i++] = "domains = IOPort('ClockDomains' [, command, domainName, ...]);  -- Map device clock timestamps to GetSecs time.";
+    synopsis[i++] = "[enabled, numEvents] = IOPort('Trace' [, command, ...]);  -- Trace reader thread activity.";
 
     synopsis[i++] = "\nCommands specific to serial ports:\n";
     synopsis[i++] = "[handle, errmsg] = IOPort('OpenSerialPort', port [, configString]);";
@@ -582,8 +584,10 @@ PsychError IOPORTRead(void)
 
     if (amount < 0) PsychErrorExitMsg(PsychError_user, "Invalid (negative) 'amount' of data to read!");
 
-    // Read data:
+    // Read data. Let other script threads run during blocking reads:
+    if (blocking > 0) PsychBeginBlockingRegion();
     nread = PsychReadIOPort(handle, (void**) &readbuffer, amount, blocking, errmsg, &timestamp);
+    PsychEndBlockingRegion();
 
     // Allocate outbuffer of proper size:
     PsychAllocOutDoubleMatArg(1, kPsychArgOptional, 1, ((nread >=0) ? nread : 0), 1, &outbuffer);
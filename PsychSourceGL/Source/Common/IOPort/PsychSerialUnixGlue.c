@@ -466,6 +466,9 @@ void* PsychSerialUnixGlueReaderThreadMain( void* deviceToCast)
         // Reenable cancellation:
         pthread_setcancelstate(PTHREAD_CANCEL_ENABLE, &oldstate);
 
+        // Trace arrival of data chunk, with total number of bytes stored so far:
+        PsychTraceInstant("IOPort", "ReadChunk", (double) device->readerThreadWritePos);
+
         // Next iteration...
     }
 
@@ -71,6 +71,8 @@ PsychError PsychModuleInit(void)
     PsychErrorExit(PsychRegister("BytesAvailable", &IOPORTBytesAvailable));
     PsychErrorExit(PsychRegister("Purge", &IOPORTPurge));
     PsychErrorExit(PsychRegister("Flush", &IOPORTFlush));
+    PsychErrorExit(PsychRegister("ClockDomains", &PsychClockDomainsSubfunction));
+    PsychErrorExit(PsychRegister("Trace", &PsychTraceSubfunction));
     // PsychErrorExit(PsychRegister("Status", &IOPORTStatus));
     // PsychErrorExit(PsychRegister("Break", &IOPORTBreak));
 
@@ -144,6 +144,24 @@ struct PsychHIDEventRecord_Struct {
 
 typedef struct PsychHIDEventRecord_Struct PsychHIDEventRecord;
 
+// Latency histograms of the KbQueue event processing chain, see PsychHIDKbQueueLatency.c.
+// Stages are kernel -> worker, worker -> event buffer, event buffer -> script, and total.
+// Bin 0 counts latencies below 1 usec, bin i > 0 covers [2^((i-1)/4), 2^(i/4)) usecs,
+// the last bin is open-ended:
+#define PSYCH_HID_LATENCY_STAGES    4
+#define PSYCH_HID_LATENCY_BINS      80
+
+struct PsychHIDLatencyHistogram_Struct {
+    double          count;
+    double          min;
+    double          max;
+    double          sum;
+    double          sumsq;
+    double          bins[PSYCH_HID_LATENCY_BINS];
+};
+
+typedef struct PsychHIDLatencyHistogram_Struct PsychHIDLatencyHistogram;
+
 // Structure which carries all required setup and matching parameters for
 // finding, opening and configuring a generic USB device. This is passed
 // to PsychHIDOSOpenUSBDevice(); to define what device should be opened,
@@ -199,6 +217,12 @@ PsychError PSYCHHIDKbQueueFlush(void);                  // PsychHIDKbQueueFlush.
 PsychError PSYCHHIDKbQueueRelease(void);                // PsychHIDKbQueueRelease.c
 PsychError PSYCHHIDKbCheck(void);                       // PsychHIDKbCheck.c
 PsychError PSYCHHIDKbQueueGetEvent(void);               // PsychHIDKbCheck.c
+PsychError PSYCHHIDKbQueueMerge(void);                  // PsychHIDKbQueueMerge.c
+PsychError PSYCHHIDKbQueueGetMergedEvents(void);        // PsychHIDKbQueueMerge.c
+PsychError PSYCHHIDKbQueueJournal(void);                // PsychHIDKbQueueJournal.c
+PsychError PSYCHHIDKbQueueJournalRead(void);            // PsychHIDKbQueueJournal.c
+PsychError PSYCHHIDKbQueueBenchmark(void);              // PsychHIDKbQueueBenchmark.c
+PsychError PSYCHHIDKbQueueLatencyTrace(void);           // PsychHIDKbQueueLatency.c
 
 PsychError PSYCHHIDGetReport(void);                     // PsychHIDGetReport.c
 PsychError PSYCHHIDSetReport(void);                     // PsychHIDSetReport.c
@@ -283,8 +307,36 @@ extern "C" {
     psych_bool  PsychHIDFlushEventBuffer(int deviceIndex);
     unsigned int PsychHIDAvailEventBuffer(int deviceIndex, unsigned int flags);
     int         PsychHIDReturnEventFromEventBuffer(int deviceIndex, int outArgIndex, double maxWaitTimeSecs);
-    PsychHIDEventRecord* PsychHIDLastTouchEventFromEventBuffer(int deviceIndex, int touchID);
+    unsigned int PsychHIDGetEventFromEventBuffer(int deviceIndex, PsychHIDEventRecord* evt, double maxWaitTimeSecs);
+    psych_bool  PsychHIDLastTouchEventFromEventBuffer(int deviceIndex, int touchID, PsychHIDEventRecord* oldevt, unsigned int setStatusBits);
     int         PsychHIDAddEventToEventBuffer(int deviceIndex, PsychHIDEventRecord* evt);
+    int         PsychHIDAddTracedEventToEventBuffer(int deviceIndex, PsychHIDEventRecord* evt, double kernelTime);
+
+    // Helpers for latency tracing of KbQueue event buffers:
+    int         PsychHIDSetEventLatencyTrace(int deviceIndex, int enable);                                      // PsychHIDHelpers.c
+    psych_bool  PsychHIDEventLatencyTraceEnabled(int deviceIndex);                                          // PsychHIDHelpers.c
+    psych_bool  PsychHIDGetEventLatencyStats(int deviceIndex, PsychHIDLatencyHistogram* stats);             // PsychHIDHelpers.c
+    psych_bool  PsychHIDResetEventLatencyStats(int deviceIndex);                                            // PsychHIDKbQueueLatency.c
+    void        PsychHIDCopyEventLatencyStats(int deviceIndex, PsychHIDLatencyHistogram* stats);            // PsychHIDKbQueueLatency.c
+    void        PsychHIDAddEventLatencySample(int deviceIndex, double tKernel, double tWorker, double tBuffer, double tScript); // PsychHIDKbQueueLatency.c
+    void        PsychHIDReleaseEventLatencyStats(void);                                                     // PsychHIDKbQueueLatency.c
+
+    // Helpers for on-disk journaling of KbQueue event buffers:
+    int         PsychHIDStartEventJournal(int deviceIndex, const char* filename, int numValuators);  // PsychHIDHelpers.c
+    double      PsychHIDStopEventJournal(int deviceIndex);                                          // PsychHIDHelpers.c
+    psych_bool  PsychHIDEventJournalActive(int deviceIndex);                                        // PsychHIDKbQueueJournal.c
+    psych_bool  PsychHIDOpenEventJournal(int deviceIndex, const char* filename, int numValuators);  // PsychHIDKbQueueJournal.c
+    double      PsychHIDCloseEventJournal(int deviceIndex);                                         // PsychHIDKbQueueJournal.c
+    psych_bool  PsychHIDAddEventToEventJournal(int deviceIndex, PsychHIDEventRecord* evt);          // PsychHIDKbQueueJournal.c
+
+    // Helpers for merged event buffer of all KbQueues:
+    psych_bool  PsychHIDCreateMergedEventBuffer(int numSlots);
+    psych_bool  PsychHIDDeleteMergedEventBuffer(void);
+    psych_bool  PsychHIDFlushMergedEventBuffer(void);
+    psych_bool  PsychHIDMergedEventBufferEnabled(void);
+    unsigned int PsychHIDAvailMergedEventBuffer(void);
+    int         PsychHIDReturnEventsFromMergedEventBuffer(int outArgIndex, int maxEvents, double maxWaitTimeSecs);
+    int         PsychHIDAddEventToMergedEventBuffer(int deviceIndex, PsychHIDEventRecord* evt);
 
 #ifdef __cplusplus
 }
@@ -43,12 +43,52 @@ IOHIDDeviceInterface122** deviceInterfaces[MAXDEVICEINDEXS];
 // PsychUSBDeviceRecord is currently defined in PsychHID.h.
 PsychUSBDeviceRecord usbDeviceRecordBank[PSYCH_HID_MAX_GENERIC_USB_DEVICES];
 
-PsychHIDEventRecord* hidEventBuffer[PSYCH_HID_MAX_DEVICES];
+// Per-device KbQueue event buffers: Byte-packed ring of variable size event records, each one a
+// PsychHIDPackedEventRecord, followed by the event's valuators. hidEventBufferOffsets[] maps event
+// slots to byte offsets of their records, hidEventBufferValidPos is the oldest not yet overwritten
+// slot, hidEventBufferNumCookedKeys is the number of unread keypress events with a CookedKey code:
+typedef struct PsychHIDPackedEventRecord {
+    double          timestamp;
+    psych_uint32    status;
+    psych_uint32    buttonStates;
+    int             rawEventCode;
+    int             cookedEventCode;
+    psych_uint16    type;
+    psych_uint16    numValuators;
+    float           X;
+    float           Y;
+    float           normX;
+    float           normY;
+    psych_uint32    reserved;
+} PsychHIDPackedEventRecord;
+
+unsigned char*  hidEventBuffer[PSYCH_HID_MAX_DEVICES];
+static unsigned int* hidEventBufferOffsets[PSYCH_HID_MAX_DEVICES];
+static unsigned int  hidEventBufferBytes[PSYCH_HID_MAX_DEVICES];
+static unsigned int  hidEventBufferWriteOffset[PSYCH_HID_MAX_DEVICES];
+static unsigned int  hidEventBufferValidPos[PSYCH_HID_MAX_DEVICES];
+static unsigned int  hidEventBufferNumCookedKeys[PSYCH_HID_MAX_DEVICES];
+static psych_bool    hidEventBufferOverflowed[PSYCH_HID_MAX_DEVICES];
+
+// Optional latency trace: Per event slot the kernel timestamp and the time of insertion into the buffer:
+static double*  hidEventBufferTrace[PSYCH_HID_MAX_DEVICES];
 unsigned int    hidEventBufferCapacity[PSYCH_HID_MAX_DEVICES];
 unsigned int    hidEventBufferReadPos[PSYCH_HID_MAX_DEVICES];
 unsigned int    hidEventBufferWritePos[PSYCH_HID_MAX_DEVICES];
 psych_mutex     hidEventBufferMutex[PSYCH_HID_MAX_DEVICES];
 psych_condition hidEventBufferCondition[PSYCH_HID_MAX_DEVICES];
+int             hidEventBufferNumValuators[PSYCH_HID_MAX_DEVICES];
+
+// Optional merged event buffer: Receives a copy of the events of all KbQueues,
+// tagged with the deviceIndex of their source and kept in timestamp order:
+static PsychHIDEventRecord* hidMergedEventBuffer = NULL;
+static int*             hidMergedEventDeviceIndex = NULL;
+static unsigned int     hidMergedEventBufferCapacity;
+static unsigned int     hidMergedEventBufferReadPos;
+static unsigned int     hidMergedEventBufferWritePos;
+static psych_bool       hidMergedEventBufferOverflowed;
+static psych_mutex      hidMergedEventBufferMutex;
+static psych_condition  hidMergedEventBufferCondition;
 
 /* PsychInitializePsychHID()
  *
@@ -67,11 +107,25 @@ void PsychInitializePsychHID(void)
     // Setup event ringbuffers:
     for (i = 0; i < PSYCH_HID_MAX_DEVICES; i++) {
         hidEventBuffer[i] = NULL;
+        hidEventBufferOffsets[i] = NULL;
+        hidEventBufferTrace[i] = NULL;
+        hidEventBufferNumCookedKeys[i] = 0;
         hidEventBufferCapacity[i] = 10000; // Initial capacity of event buffer.
         hidEventBufferReadPos[i] = 0;
         hidEventBufferWritePos[i] = 0;
+        hidEventBufferNumValuators[i] = 0;
     }
 
+    // Setup merged event buffer - disabled by default:
+    hidMergedEventBuffer = NULL;
+    hidMergedEventDeviceIndex = NULL;
+    hidMergedEventBufferCapacity = 10000;
+    hidMergedEventBufferReadPos = 0;
+    hidMergedEventBufferWritePos = 0;
+    hidMergedEventBufferOverflowed = FALSE;
+    PsychInitMutex(&hidMergedEventBufferMutex);
+    PsychInitCondition(&hidMergedEventBufferCondition, NULL);
+
 #if PSYCH_SYSTEM == PSYCH_OSX
     for (i = 0; i < MAXDEVICEINDEXS; i++) deviceInterfaces[i] = NULL;
 
@@ -179,6 +233,14 @@ PsychError PsychHIDCleanup(void)
     // Shutdown os specific interfaces and routines:
     PsychHIDShutdownHIDStandardInterfaces();
 
+    // All KbQueues are released now, so release the merged event buffer as well:
+    PsychHIDDeleteMergedEventBuffer();
+    PsychDestroyMutex(&hidMergedEventBufferMutex);
+    PsychDestroyCondition(&hidMergedEventBufferCondition);
+
+    // Release latency trace statistics:
+    PsychHIDReleaseEventLatencyStats();
+
     // Release all other HID device data structures:
 #if PSYCH_SYSTEM == PSYCH_OSX
     // Via Apple HIDUtils:
@@ -261,9 +323,18 @@ pRecDevice PsychHIDGetDeviceRecordPtrFromIndex(int deviceIndex)
     return(NULL);  //make the compiler happy.
 }
 
+/* Size in bytes of a packed event record carrying 'numValuators' valuators: */
+static size_t PsychHIDPackedEventRecordSize(int numValuators)
+{
+    // Valuator payload is padded to a multiple of 8 Bytes, so the double timestamp
+    // of the following record stays naturally aligned:
+    return(sizeof(PsychHIDPackedEventRecord) + ((((size_t) numValuators * sizeof(float)) + 7) & ~((size_t) 7)));
+}
+
 psych_bool PsychHIDCreateEventBuffer(int deviceIndex, int numValuators, int numSlots)
 {
     unsigned int bufferSize;
+    size_t minRecordSize, maxRecordSize;
 
     if (deviceIndex < 0) deviceIndex = PsychHIDGetDefaultKbQueueDevice();
 
@@ -287,18 +358,42 @@ psych_bool PsychHIDCreateEventBuffer(int deviceIndex, int numValuators, int numS
         return(FALSE);
     }
 
-    hidEventBuffer[deviceIndex] = (PsychHIDEventRecord*) calloc(sizeof(PsychHIDEventRecord), bufferSize);
-    if (NULL==hidEventBuffer[deviceIndex]) {
+    if (numValuators < 0) numValuators = 0;
+
+    // Byte capacity: Enough for bufferSize records without valuators, as most events are key or
+    // button events, plus one record with the full valuator payload, so any record fits and the
+    // unused tail after a wrap around never costs a slot. Events with valuators take more room,
+    // so with many of them the buffer fills up before all slots are used:
+    minRecordSize = PsychHIDPackedEventRecordSize(0);
+    maxRecordSize = PsychHIDPackedEventRecordSize(numValuators);
+    if ((size_t) bufferSize > ((size_t) 0xffffffff - maxRecordSize) / minRecordSize) {
+        printf("PTB-ERROR: PsychHIDCreateEventBuffer(): numSlots %i too large!\n", bufferSize);
+        return(FALSE);
+    }
+
+    hidEventBufferBytes[deviceIndex] = (unsigned int) ((size_t) bufferSize * minRecordSize + maxRecordSize);
+    hidEventBuffer[deviceIndex] = (unsigned char*) malloc(hidEventBufferBytes[deviceIndex]);
+    hidEventBufferOffsets[deviceIndex] = (unsigned int*) calloc(sizeof(unsigned int), bufferSize);
+    if ((NULL == hidEventBuffer[deviceIndex]) || (NULL == hidEventBufferOffsets[deviceIndex])) {
+        free(hidEventBuffer[deviceIndex]);
+        free(hidEventBufferOffsets[deviceIndex]);
+        hidEventBuffer[deviceIndex] = NULL;
+        hidEventBufferOffsets[deviceIndex] = NULL;
         printf("PTB-ERROR: PsychHIDCreateEventBuffer(): Insufficient memory to create KbQueue event buffer!");
         return(FALSE);
     }
 
+    hidEventBufferNumValuators[deviceIndex] = numValuators;
+
     // Prepare mutex for buffer:
     PsychInitMutex(&hidEventBufferMutex[deviceIndex]);
     PsychInitCondition(&hidEventBufferCondition[deviceIndex], NULL);
 
     // Init & Flush it:
     hidEventBufferWritePos[deviceIndex] = 0;
+    hidEventBufferValidPos[deviceIndex] = 0;
+    hidEventBufferWriteOffset[deviceIndex] = 0;
+    hidEventBufferOverflowed[deviceIndex] = FALSE;
     PsychHIDFlushEventBuffer(deviceIndex);
 
     return(TRUE);
@@ -312,9 +407,16 @@ psych_bool PsychHIDDeleteEventBuffer(int deviceIndex)
         // Empty the buffer, reset read/writepointers:
         PsychHIDFlushEventBuffer(deviceIndex);
 
+        // Finalize event journal, if any:
+        PsychHIDStopEventJournal(deviceIndex);
+
         // Release it:
         free(hidEventBuffer[deviceIndex]);
         hidEventBuffer[deviceIndex] = NULL;
+        free(hidEventBufferOffsets[deviceIndex]);
+        hidEventBufferOffsets[deviceIndex] = NULL;
+        free(hidEventBufferTrace[deviceIndex]);
+        hidEventBufferTrace[deviceIndex] = NULL;
         PsychDestroyMutex(&hidEventBufferMutex[deviceIndex]);
         PsychDestroyCondition(&hidEventBufferCondition[deviceIndex]);
     }
@@ -330,6 +432,7 @@ psych_bool PsychHIDFlushEventBuffer(int deviceIndex)
 
     PsychLockMutex(&hidEventBufferMutex[deviceIndex]);
     hidEventBufferReadPos[deviceIndex] = hidEventBufferWritePos[deviceIndex];
+    hidEventBufferNumCookedKeys[deviceIndex] = 0;
     PsychUnlockMutex(&hidEventBufferMutex[deviceIndex]);
 
     return TRUE;
@@ -341,7 +444,7 @@ psych_bool PsychHIDFlushEventBuffer(int deviceIndex)
  */
 unsigned int PsychHIDAvailEventBuffer(int deviceIndex, unsigned int flags)
 {
-    unsigned int navail, i, j;
+    unsigned int navail;
 
     if (deviceIndex < 0) deviceIndex = PsychHIDGetDefaultKbQueueDevice();
 
@@ -349,34 +452,97 @@ unsigned int PsychHIDAvailEventBuffer(int deviceIndex, unsigned int flags)
 
     PsychLockMutex(&hidEventBufferMutex[deviceIndex]);
 
-    // Compute total number of available events by default:
-    navail = hidEventBufferWritePos[deviceIndex] - hidEventBufferReadPos[deviceIndex];
-
     // Only count of valid "CookedKey" mapped keypress events, e.g., for use by CharAvail(), requested?
-    if (flags & 1) {
-        // Yes: Iterate over all available events and only count number of keypress events
-        // with meaningful 'CookedKey' field:
-        navail = 0;
-        for (i = hidEventBufferReadPos[deviceIndex]; i < hidEventBufferWritePos[deviceIndex]; i++) {
-            j = i % hidEventBufferCapacity[deviceIndex];
-            if ((hidEventBuffer[deviceIndex][j].status & (1 << 0)) && (hidEventBuffer[deviceIndex][j].cookedEventCode > 0)) navail++;
-        }
-    }
+    // This count is maintained incrementally by the enqueue/dequeue code, so no need to scan the buffer.
+    // Otherwise compute total number of available events by default:
+    if (flags & 1)
+        navail = hidEventBufferNumCookedKeys[deviceIndex];
+    else
+        navail = hidEventBufferWritePos[deviceIndex] - hidEventBufferReadPos[deviceIndex];
 
     PsychUnlockMutex(&hidEventBufferMutex[deviceIndex]);
 
     return(navail);
 }
 
-int PsychHIDReturnEventFromEventBuffer(int deviceIndex, int outArgIndex, double maxWaitTimeSecs)
+// Field names of KbQueue event structs. The optional last field "DeviceIndex" is only returned for the merged event buffer:
+static const char *kbQueueEventFieldNames[] = { "Type", "Time", "Pressed", "Keycode", "CookedKey", "ButtonStates", "Motion", "X", "Y", "NormX", "NormY", "Valuators", "DeviceIndex" };
+
+// Indices of the fields in kbQueueEventFieldNames:
+enum { kKbQueueEventType, kKbQueueEventTime, kKbQueueEventPressed, kKbQueueEventKeycode, kKbQueueEventCookedKey,
+       kKbQueueEventButtonStates, kKbQueueEventMotion, kKbQueueEventX, kKbQueueEventY, kKbQueueEventNormX,
+       kKbQueueEventNormY, kKbQueueEventValuators, kKbQueueEventDeviceIndex, kKbQueueEventNumFields };
+
+// Assign content of event 'evt' to the index'th element of event struct array builder 'retevent':
+static void PsychHIDSetEventStructElement(PsychHIDEventRecord* evt, int index, PsychStructBuilder *retevent)
 {
-    unsigned int navail, j;
-    PsychHIDEventRecord evt;
-    PsychGenericScriptType *retevent;
-    double* foo = NULL;
     PsychGenericScriptType *outMat;
     double *v;
-    const char *FieldNames[] = { "Type", "Time", "Pressed", "Keycode", "CookedKey", "ButtonStates", "Motion", "X", "Y", "NormX", "NormY", "Valuators" };
+    int j;
+
+    switch (evt->type) {
+        case 0: // Press/Release
+        case 1: // Motion/Valuator change
+        case 2: // Touch begin
+        case 3: // Touch update/move
+        case 4: // Touch end
+        case 5: // Touch sequence compromised marker. If this one shows up - with magic touch point
+                // id 0xffffffff btw., then the user script knows the sequence was cut short / aborted
+                // by some higher priority consumer, e.g., some global gesture recognizer.
+            break;
+
+        default:
+            PsychErrorExitMsg(PsychError_internal, "Unhandled keyboard queue event type!");
+    }
+
+    PsychSetStructBuilderDoubleElement(retevent, kKbQueueEventType, index, (double) evt->type);
+    PsychSetStructBuilderDoubleElement(retevent, kKbQueueEventTime, index, evt->timestamp);
+    PsychSetStructBuilderDoubleElement(retevent, kKbQueueEventPressed, index, (double) (evt->status & (1 << 0)) ? 1 : 0);
+    PsychSetStructBuilderDoubleElement(retevent, kKbQueueEventKeycode, index, (double) evt->rawEventCode);
+    PsychSetStructBuilderDoubleElement(retevent, kKbQueueEventCookedKey, index, (double) evt->cookedEventCode);
+    PsychSetStructBuilderDoubleElement(retevent, kKbQueueEventButtonStates, index, (double) evt->buttonStates);
+    PsychSetStructBuilderDoubleElement(retevent, kKbQueueEventMotion, index, (double) (evt->status & (1 << 1)) ? 1 : 0);
+    PsychSetStructBuilderDoubleElement(retevent, kKbQueueEventX, index, (double) evt->X);
+    PsychSetStructBuilderDoubleElement(retevent, kKbQueueEventY, index, (double) evt->Y);
+    PsychSetStructBuilderDoubleElement(retevent, kKbQueueEventNormX, index, (double) evt->normX);
+    PsychSetStructBuilderDoubleElement(retevent, kKbQueueEventNormY, index, (double) evt->normY);
+
+    // Copy out all valuators (including redundant (X,Y) again:
+    v = NULL;
+    PsychAllocateNativeDoubleMat(1, evt->numValuators, 1, &v, &outMat);
+    for (j = 0; j < evt->numValuators; j++)
+        *(v++) = (double) evt->valuators[j];
+    PsychSetStructBuilderNativeElement(retevent, kKbQueueEventValuators, index, outMat);
+}
+
+/* Unpack event record in buffer slot 'slot' of device 'deviceIndex' into 'evt'. Needs the buffer mutex held. */
+static void PsychHIDUnpackEventRecord(int deviceIndex, unsigned int slot, PsychHIDEventRecord* evt)
+{
+    PsychHIDPackedEventRecord* rec = (PsychHIDPackedEventRecord*) &(hidEventBuffer[deviceIndex][hidEventBufferOffsets[deviceIndex][slot % hidEventBufferCapacity[deviceIndex]]]);
+
+    evt->timestamp = rec->timestamp;
+    evt->type = rec->type;
+    evt->status = rec->status;
+    evt->buttonStates = rec->buttonStates;
+    evt->rawEventCode = rec->rawEventCode;
+    evt->cookedEventCode = rec->cookedEventCode;
+    evt->numValuators = rec->numValuators;
+    evt->X = rec->X;
+    evt->Y = rec->Y;
+    evt->normX = rec->normX;
+    evt->normY = rec->normY;
+    memset(evt->valuators, 0, sizeof(evt->valuators));
+    memcpy(evt->valuators, (unsigned char*) rec + sizeof(PsychHIDPackedEventRecord), rec->numValuators * sizeof(float));
+}
+
+/* Fetch oldest unread event from buffer of 'deviceIndex' into 'evt', waiting up to 'maxWaitTimeSecs'
+ * for one if the buffer is empty. Returns number of events available before the fetch, ie. 0 if none
+ * was fetched.
+ */
+unsigned int PsychHIDGetEventFromEventBuffer(int deviceIndex, PsychHIDEventRecord* evt, double maxWaitTimeSecs)
+{
+    unsigned int navail, slot;
+    double tScript;
 
     if (deviceIndex < 0) deviceIndex = PsychHIDGetDefaultKbQueueDevice();
     if (!hidEventBuffer[deviceIndex]) return(0);
@@ -395,51 +561,44 @@ int PsychHIDReturnEventFromEventBuffer(int deviceIndex, int outArgIndex, double
 
     // Check if anything available, copy it if so:
     if (navail) {
-        memcpy(&evt, &(hidEventBuffer[deviceIndex][hidEventBufferReadPos[deviceIndex] % hidEventBufferCapacity[deviceIndex]]), sizeof(PsychHIDEventRecord));
+        PsychHIDUnpackEventRecord(deviceIndex, hidEventBufferReadPos[deviceIndex], evt);
+
+        // Latency tracing active? Event timestamp is the time the worker received the event:
+        if (hidEventBufferTrace[deviceIndex]) {
+            PsychGetAdjustedPrecisionTimerSeconds(&tScript);
+            slot = hidEventBufferReadPos[deviceIndex] % hidEventBufferCapacity[deviceIndex];
+            PsychHIDAddEventLatencySample(deviceIndex, hidEventBufferTrace[deviceIndex][2 * slot], evt->timestamp,
+                                          hidEventBufferTrace[deviceIndex][2 * slot + 1], tScript);
+        }
+
         hidEventBufferReadPos[deviceIndex]++;
+
+        // Consumed a cooked keypress event? Update count:
+        if ((evt->status & (1 << 0)) && (evt->cookedEventCode > 0) && (hidEventBufferNumCookedKeys[deviceIndex] > 0))
+            hidEventBufferNumCookedKeys[deviceIndex]--;
     }
 
     PsychUnlockMutex(&hidEventBufferMutex[deviceIndex]);
 
-    if (navail) {
-        // Return event struct:
-        switch (evt.type) {
-            case 0: // Press/Release
-            case 1: // Motion/Valuator change
-                PsychAllocOutStructArray(outArgIndex, kPsychArgOptional, -1, 12, FieldNames, &retevent);
-                break;
-
-            case 2: // Touch begin
-            case 3: // Touch update/move
-            case 4: // Touch end
-            case 5: // Touch sequence compromised marker. If this one shows up - with magic touch point
-                    // id 0xffffffff btw., then the user script knows the sequence was cut short / aborted
-                    // by some higher priority consumer, e.g., some global gesture recognizer.
-                PsychAllocOutStructArray(outArgIndex, kPsychArgOptional, -1, 12, FieldNames, &retevent);
-                break;
-
-            default:
-                PsychErrorExitMsg(PsychError_internal, "Unhandled keyboard queue event type!");
-        }
+    return(navail);
+}
+
+int PsychHIDReturnEventFromEventBuffer(int deviceIndex, int outArgIndex, double maxWaitTimeSecs)
+{
+    unsigned int navail;
+    PsychHIDEventRecord evt;
+    PsychStructBuilder retevent;
+    double* foo = NULL;
+
+    // Let other script threads run while waiting for events:
+    if (maxWaitTimeSecs > 0) PsychBeginBlockingRegion();
+    navail = PsychHIDGetEventFromEventBuffer(deviceIndex, &evt, maxWaitTimeSecs);
+    PsychEndBlockingRegion();
 
-        PsychSetStructArrayDoubleElement("Type",         0, (double) evt.type,                        retevent);
-        PsychSetStructArrayDoubleElement("Time",         0, evt.timestamp,                            retevent);
-        PsychSetStructArrayDoubleElement("Pressed",      0, (double) (evt.status & (1 << 0)) ? 1 : 0, retevent);
-        PsychSetStructArrayDoubleElement("Keycode",      0, (double) evt.rawEventCode,                retevent);
-        PsychSetStructArrayDoubleElement("CookedKey",    0, (double) evt.cookedEventCode,             retevent);
-        PsychSetStructArrayDoubleElement("ButtonStates", 0, (double) evt.buttonStates,                retevent);
-        PsychSetStructArrayDoubleElement("Motion",       0, (double) (evt.status & (1 << 1)) ? 1 : 0, retevent);
-        PsychSetStructArrayDoubleElement("X",            0, (double) evt.X,                           retevent);
-        PsychSetStructArrayDoubleElement("Y",            0, (double) evt.Y,                           retevent);
-        PsychSetStructArrayDoubleElement("NormX",        0, (double) evt.normX,                       retevent);
-        PsychSetStructArrayDoubleElement("NormY",        0, (double) evt.normY,                       retevent);
-
-        // Copy out all valuators (including redundant (X,Y) again:
-        v = NULL;
-        PsychAllocateNativeDoubleMat(1, evt.numValuators, 1, &v, &outMat);
-        for (j = 0; j < evt.numValuators; j++)
-            *(v++) = (double) evt.valuators[j];
-        PsychSetStructArrayNativeElement("Valuators", 0, outMat, retevent);
+    if (navail) {
+        // Return event struct, without the DeviceIndex field:
+        PsychAllocOutStructBuilder(outArgIndex, kPsychArgOptional, -1, kKbQueueEventDeviceIndex, kbQueueEventFieldNames, &retevent);
+        PsychHIDSetEventStructElement(&evt, 0, &retevent);
 
         return(navail - 1);
     }
@@ -450,62 +609,470 @@ int PsychHIDReturnEventFromEventBuffer(int deviceIndex, int outArgIndex, double
     }
 }
 
-PsychHIDEventRecord* PsychHIDLastTouchEventFromEventBuffer(int deviceIndex, int touchID)
+/* Find most recent touch event for touch point 'touchID' in the event buffer of 'deviceIndex'.
+ * Also searches already consumed events, as long as they weren't overwritten by newer events.
+ * Returns TRUE if found, and a copy of the event in 'oldevt', unless that is NULL. Status bits
+ * 'setStatusBits' are or'ed into the status of the stored event.
+ */
+psych_bool PsychHIDLastTouchEventFromEventBuffer(int deviceIndex, int touchID, PsychHIDEventRecord* oldevt, unsigned int setStatusBits)
 {
-    int nend, current;
-    PsychHIDEventRecord *evt;
+    unsigned int current;
+    PsychHIDPackedEventRecord *rec = NULL;
 
-    if (!hidEventBuffer[deviceIndex]) return(0);
+    if (!hidEventBuffer[deviceIndex]) return(FALSE);
 
     PsychLockMutex(&hidEventBufferMutex[deviceIndex]);
-    nend = (hidEventBufferWritePos[deviceIndex] - 1) % hidEventBufferCapacity[deviceIndex];
-    current = nend;
-
-    // Go backwards through all touch events until the most recent one with touchID is found:
-    do {
-        if ((hidEventBuffer[deviceIndex][current].type >= 2) &&
-            (hidEventBuffer[deviceIndex][current].type <= 4) &&
-            (hidEventBuffer[deviceIndex][current].rawEventCode == touchID))
+
+    // Go backwards through all still intact events until the most recent touch event with touchID is found:
+    for (current = hidEventBufferWritePos[deviceIndex]; current != hidEventBufferValidPos[deviceIndex]; current--) {
+        rec = (PsychHIDPackedEventRecord*) &(hidEventBuffer[deviceIndex][hidEventBufferOffsets[deviceIndex][(current - 1) % hidEventBufferCapacity[deviceIndex]]]);
+        if ((rec->type >= 2) && (rec->type <= 4) && (rec->rawEventCode == touchID))
             break;
 
-        current = (current - 1) % hidEventBufferCapacity[deviceIndex];
-    } while ((current != nend) && (current >= 0));
+        rec = NULL;
+    }
 
-    if (hidEventBuffer[deviceIndex][current].rawEventCode == touchID)
-        evt = &(hidEventBuffer[deviceIndex][current]);
-    else
-        evt = NULL;
+    if (rec) {
+        rec->status |= setStatusBits;
+        if (oldevt)
+            PsychHIDUnpackEventRecord(deviceIndex, current - 1, oldevt);
+    }
 
     PsychUnlockMutex(&hidEventBufferMutex[deviceIndex]);
 
-    return (evt);
+    return((rec) ? TRUE : FALSE);
 }
 
 int PsychHIDAddEventToEventBuffer(int deviceIndex, PsychHIDEventRecord* evt)
 {
-    unsigned int navail;
+    return(PsychHIDAddTracedEventToEventBuffer(deviceIndex, evt, -1));
+}
+
+/* Add event 'evt' to the event buffer of 'deviceIndex'. 'kernelTime' is the GetSecs time when the OS
+ * kernel or window system received the event, for latency tracing, or -1 if unknown. Returns 1 if the
+ * event got stored, 0 if it got discarded because the buffer is full or doesn't exist.
+ */
+int PsychHIDAddTracedEventToEventBuffer(int deviceIndex, PsychHIDEventRecord* evt, double kernelTime)
+{
+    unsigned int navail, offset, validPos, numValuators, recordSize;
+    PsychHIDPackedEventRecord *rec;
+    psych_bool journaled, fits;
 
     if (deviceIndex < 0) deviceIndex = PsychHIDGetDefaultKbQueueDevice();
 
     if (!hidEventBuffer[deviceIndex]) return 0;
 
+    // Only store as many valuators as the event carries, up to the maximum of the buffer:
+    numValuators = (evt->numValuators > 0) ? (unsigned int) evt->numValuators : 0;
+    if (numValuators > (unsigned int) hidEventBufferNumValuators[deviceIndex])
+        numValuators = (unsigned int) hidEventBufferNumValuators[deviceIndex];
+
+    recordSize = (unsigned int) PsychHIDPackedEventRecordSize(numValuators);
+
     PsychLockMutex(&hidEventBufferMutex[deviceIndex]);
 
+    // Append to on-disk journal first, if journaling is active for this buffer:
+    journaled = PsychHIDAddEventToEventJournal(deviceIndex, evt);
+
     navail = hidEventBufferWritePos[deviceIndex] - hidEventBufferReadPos[deviceIndex];
-    if (navail < hidEventBufferCapacity[deviceIndex]) {
-        memcpy(&(hidEventBuffer[deviceIndex][hidEventBufferWritePos[deviceIndex] % hidEventBufferCapacity[deviceIndex]]), evt, sizeof(PsychHIDEventRecord));
+    fits = (navail < hidEventBufferCapacity[deviceIndex]) ? TRUE : FALSE;
+
+    // Records are stored contiguously and never wrap. Find where the new record goes, and which
+    // old records it overwrites. Records are laid out in byte order oldest to newest, so the ones
+    // to overwrite are the oldest ones. Unread records must never be overwritten:
+    offset = hidEventBufferWriteOffset[deviceIndex];
+    validPos = hidEventBufferValidPos[deviceIndex];
+
+    // Discard oldest record if the slot index is exhausted:
+    if (hidEventBufferWritePos[deviceIndex] - validPos >= hidEventBufferCapacity[deviceIndex])
+        validPos++;
+
+    if (offset + recordSize > hidEventBufferBytes[deviceIndex]) {
+        // Not enough room at the end of the buffer: Wrap around to start, abandon all
+        // records in the unused tail:
+        while ((validPos != hidEventBufferWritePos[deviceIndex]) && (hidEventBufferOffsets[deviceIndex][validPos % hidEventBufferCapacity[deviceIndex]] >= offset))
+            validPos++;
+        offset = 0;
+    }
+
+    // Discard old records overlapping the target range:
+    while ((validPos != hidEventBufferWritePos[deviceIndex]) &&
+           (hidEventBufferOffsets[deviceIndex][validPos % hidEventBufferCapacity[deviceIndex]] >= offset) &&
+           (hidEventBufferOffsets[deviceIndex][validPos % hidEventBufferCapacity[deviceIndex]] < offset + recordSize))
+        validPos++;
+
+    // Would this discard unread events?
+    if (validPos - hidEventBufferValidPos[deviceIndex] > hidEventBufferReadPos[deviceIndex] - hidEventBufferValidPos[deviceIndex])
+        fits = FALSE;
+
+    if (fits) {
+        hidEventBufferValidPos[deviceIndex] = validPos;
+        hidEventBufferOffsets[deviceIndex][hidEventBufferWritePos[deviceIndex] % hidEventBufferCapacity[deviceIndex]] = offset;
+        hidEventBufferWriteOffset[deviceIndex] = offset + recordSize;
+
+        rec = (PsychHIDPackedEventRecord*) &(hidEventBuffer[deviceIndex][offset]);
+        rec->timestamp = evt->timestamp;
+        rec->status = evt->status;
+        rec->buttonStates = evt->buttonStates;
+        rec->rawEventCode = evt->rawEventCode;
+        rec->cookedEventCode = evt->cookedEventCode;
+        rec->type = (psych_uint16) evt->type;
+        rec->numValuators = (psych_uint16) numValuators;
+        rec->X = evt->X;
+        rec->Y = evt->Y;
+        rec->normX = evt->normX;
+        rec->normY = evt->normY;
+        memcpy((unsigned char*) rec + sizeof(PsychHIDPackedEventRecord), evt->valuators, numValuators * sizeof(float));
+
+        // Record kernel time and time of insertion for latency tracing:
+        if (hidEventBufferTrace[deviceIndex]) {
+            hidEventBufferTrace[deviceIndex][2 * (hidEventBufferWritePos[deviceIndex] % hidEventBufferCapacity[deviceIndex])] = kernelTime;
+            PsychGetAdjustedPrecisionTimerSeconds(&hidEventBufferTrace[deviceIndex][2 * (hidEventBufferWritePos[deviceIndex] % hidEventBufferCapacity[deviceIndex]) + 1]);
+        }
+
         hidEventBufferWritePos[deviceIndex]++;
 
+        // Keep count of cooked keypress events for PsychHIDAvailEventBuffer():
+        if ((evt->status & (1 << 0)) && (evt->cookedEventCode > 0))
+            hidEventBufferNumCookedKeys[deviceIndex]++;
+
         // Announce new event to potential waiters:
         PsychSignalCondition(&hidEventBufferCondition[deviceIndex]);
+
+        hidEventBufferOverflowed[deviceIndex] = FALSE;
     }
-    else {
-        printf("PsychHID: WARNING: KbQueue event buffer is full! Maximum capacity of %i elements reached, will discard future events.\n", hidEventBufferCapacity[deviceIndex]);
+    else if (!journaled && !hidEventBufferOverflowed[deviceIndex]) {
+        // Only whine if the event is really lost, ie. not at least safely stored in the journal,
+        // and only once until events can be stored again:
+        printf("PsychHID: WARNING: KbQueue event buffer is full! Maximum capacity of %i elements, or less for events with valuators, reached. Will discard future events.\n",
+               hidEventBufferCapacity[deviceIndex]);
+        hidEventBufferOverflowed[deviceIndex] = TRUE;
+    }
+
+    PsychUnlockMutex(&hidEventBufferMutex[deviceIndex]);
+
+    // Also feed the merged event buffer, if enabled:
+    if (hidMergedEventBuffer) PsychHIDAddEventToMergedEventBuffer(deviceIndex, evt);
+
+    return((fits) ? 1 : 0);
+}
+
+/* Start journaling of events of event buffer 'deviceIndex' into file 'filename'.
+ * numValuators < 0 means to use the valuator count of the event buffer.
+ * Returns 0 on success, 1 if there isn't an event buffer, 2 if journaling is
+ * already active, 3 if the journal file could not be created.
+ */
+int PsychHIDStartEventJournal(int deviceIndex, const char* filename, int numValuators)
+{
+    int rc;
+
+    if (deviceIndex < 0) deviceIndex = PsychHIDGetDefaultKbQueueDevice();
+    if (!hidEventBuffer[deviceIndex]) return(1);
+
+    if (numValuators < 0) numValuators = hidEventBufferNumValuators[deviceIndex];
+
+    PsychLockMutex(&hidEventBufferMutex[deviceIndex]);
+    if (PsychHIDEventJournalActive(deviceIndex))
+        rc = 2;
+    else
+        rc = (PsychHIDOpenEventJournal(deviceIndex, filename, numValuators)) ? 0 : 3;
+    PsychUnlockMutex(&hidEventBufferMutex[deviceIndex]);
+
+    return(rc);
+}
+
+/* Stop journaling of events of event buffer 'deviceIndex', finalize the journal file
+ * and return the number of journaled events.
+ */
+double PsychHIDStopEventJournal(int deviceIndex)
+{
+    double numRecords;
+
+    if (deviceIndex < 0) deviceIndex = PsychHIDGetDefaultKbQueueDevice();
+    if (!hidEventBuffer[deviceIndex]) return(0);
+
+    PsychLockMutex(&hidEventBufferMutex[deviceIndex]);
+    numRecords = PsychHIDCloseEventJournal(deviceIndex);
+    PsychUnlockMutex(&hidEventBufferMutex[deviceIndex]);
+
+    return(numRecords);
+}
+
+/* Enable or disable latency tracing for event buffer 'deviceIndex':
+ * enable == 0 -> Disable, keep statistics.
+ * enable == 1 -> Enable and reset statistics.
+ * enable == 2 -> Only reset statistics.
+ * enable <  0 -> Only query.
+ * Returns previous enable state, or -1 if there isn't an event buffer for 'deviceIndex'.
+ */
+int PsychHIDSetEventLatencyTrace(int deviceIndex, int enable)
+{
+    int rc;
+
+    if (deviceIndex < 0) deviceIndex = PsychHIDGetDefaultKbQueueDevice();
+    if (!hidEventBuffer[deviceIndex]) return(-1);
+
+    PsychLockMutex(&hidEventBufferMutex[deviceIndex]);
+
+    rc = (hidEventBufferTrace[deviceIndex]) ? 1 : 0;
+
+    if ((enable == 1) || (enable == 2))
+        PsychHIDResetEventLatencyStats(deviceIndex);
+
+    if ((enable == 1) && !hidEventBufferTrace[deviceIndex]) {
+        // Events which are already in the buffer have no trace timestamps, so mark them as unknown:
+        hidEventBufferTrace[deviceIndex] = (double*) malloc(2 * sizeof(double) * hidEventBufferCapacity[deviceIndex]);
+        if (hidEventBufferTrace[deviceIndex]) {
+            unsigned int i;
+            for (i = 0; i < 2 * hidEventBufferCapacity[deviceIndex]; i++)
+                hidEventBufferTrace[deviceIndex][i] = -1;
+        }
+    }
+
+    if (enable == 0) {
+        free(hidEventBufferTrace[deviceIndex]);
+        hidEventBufferTrace[deviceIndex] = NULL;
     }
 
     PsychUnlockMutex(&hidEventBufferMutex[deviceIndex]);
 
-    return navail - 1;
+    return(rc);
+}
+
+psych_bool PsychHIDEventLatencyTraceEnabled(int deviceIndex)
+{
+    if (deviceIndex < 0) deviceIndex = PsychHIDGetDefaultKbQueueDevice();
+
+    return((hidEventBuffer[deviceIndex] && hidEventBufferTrace[deviceIndex]) ? TRUE : FALSE);
+}
+
+/* Copy latency statistics of event buffer 'deviceIndex' into the PSYCH_HID_LATENCY_STAGES
+ * histograms 'stats'. Returns FALSE if there isn't an event buffer for 'deviceIndex'.
+ */
+psych_bool PsychHIDGetEventLatencyStats(int deviceIndex, PsychHIDLatencyHistogram* stats)
+{
+    if (deviceIndex < 0) deviceIndex = PsychHIDGetDefaultKbQueueDevice();
+    if (!hidEventBuffer[deviceIndex]) return(FALSE);
+
+    PsychLockMutex(&hidEventBufferMutex[deviceIndex]);
+    PsychHIDCopyEventLatencyStats(deviceIndex, stats);
+    PsychUnlockMutex(&hidEventBufferMutex[deviceIndex]);
+
+    return(TRUE);
+}
+
+/* Merged event buffer:
+ *
+ * If enabled via PsychHIDCreateMergedEventBuffer(), PsychHIDAddEventToEventBuffer()
+ * also appends a copy of each event to one global ringbuffer, together with the
+ * deviceIndex of the queue which received the event. All KbQueue worker paths of
+ * all operating systems funnel their events through PsychHIDAddEventToEventBuffer(),
+ * so the merged buffer sees the events of all queues of all devices.
+ *
+ * Events are inserted in timestamp order. Events usually arrive in order already,
+ * so the insertion sort below only has to move elements if the worker of one device
+ * delivers a slightly older event after the worker of another device, e.g., on OSX
+ * with its per-device callbacks. Insertion is therefore O(1) in the common case.
+ *
+ * The merged buffer is independent of the per-device buffers, ie. fetching or flushing
+ * events from one doesn't affect the other.
+ */
+psych_bool PsychHIDCreateMergedEventBuffer(int numSlots)
+{
+    PsychHIDEventRecord* buffer;
+    int* deviceIndices;
+
+    if (numSlots < 0) {
+        printf("PTB-ERROR: PsychHIDCreateMergedEventBuffer(): numSlots %i invalid. Must be at least 0.\n", numSlots);
+        return(FALSE);
+    }
+
+    // Already created? If so, nothing to do:
+    if (hidMergedEventBuffer) return(TRUE);
+
+    // Non-zero numSlots ==> Set new capacity, otherwise leave at default/last capacity:
+    if (numSlots > 0)
+        hidMergedEventBufferCapacity = numSlots;
+
+    buffer = (PsychHIDEventRecord*) calloc(sizeof(PsychHIDEventRecord), hidMergedEventBufferCapacity);
+    deviceIndices = (int*) calloc(sizeof(int), hidMergedEventBufferCapacity);
+    if ((NULL == buffer) || (NULL == deviceIndices)) {
+        free(buffer);
+        free(deviceIndices);
+        printf("PTB-ERROR: PsychHIDCreateMergedEventBuffer(): Insufficient memory to create merged KbQueue event buffer!");
+        return(FALSE);
+    }
+
+    PsychLockMutex(&hidMergedEventBufferMutex);
+    hidMergedEventDeviceIndex = deviceIndices;
+    hidMergedEventBufferReadPos = 0;
+    hidMergedEventBufferWritePos = 0;
+    hidMergedEventBufferOverflowed = FALSE;
+    hidMergedEventBuffer = buffer;
+    PsychUnlockMutex(&hidMergedEventBufferMutex);
+
+    return(TRUE);
+}
+
+psych_bool PsychHIDDeleteMergedEventBuffer(void)
+{
+    PsychHIDEventRecord* buffer;
+    int* deviceIndices;
+
+    if (!hidMergedEventBuffer) return(FALSE);
+
+    PsychLockMutex(&hidMergedEventBufferMutex);
+    buffer = hidMergedEventBuffer;
+    deviceIndices = hidMergedEventDeviceIndex;
+    hidMergedEventBuffer = NULL;
+    hidMergedEventDeviceIndex = NULL;
+    hidMergedEventBufferReadPos = hidMergedEventBufferWritePos = 0;
+
+    // Wake up potential waiters, so they notice the buffer is gone:
+    PsychBroadcastCondition(&hidMergedEventBufferCondition);
+    PsychUnlockMutex(&hidMergedEventBufferMutex);
+
+    free(buffer);
+    free(deviceIndices);
+
+    return(TRUE);
+}
+
+psych_bool PsychHIDFlushMergedEventBuffer(void)
+{
+    if (!hidMergedEventBuffer) return(FALSE);
+
+    PsychLockMutex(&hidMergedEventBufferMutex);
+    hidMergedEventBufferReadPos = hidMergedEventBufferWritePos;
+    PsychUnlockMutex(&hidMergedEventBufferMutex);
+
+    return(TRUE);
+}
+
+psych_bool PsychHIDMergedEventBufferEnabled(void)
+{
+    return((hidMergedEventBuffer) ? TRUE : FALSE);
+}
+
+unsigned int PsychHIDAvailMergedEventBuffer(void)
+{
+    unsigned int navail;
+
+    if (!hidMergedEventBuffer) return(0);
+
+    PsychLockMutex(&hidMergedEventBufferMutex);
+    navail = hidMergedEventBufferWritePos - hidMergedEventBufferReadPos;
+    PsychUnlockMutex(&hidMergedEventBufferMutex);
+
+    return(navail);
+}
+
+int PsychHIDAddEventToMergedEventBuffer(int deviceIndex, PsychHIDEventRecord* evt)
+{
+    unsigned int navail, pos, cap;
+
+    PsychLockMutex(&hidMergedEventBufferMutex);
+
+    // Buffer got deleted in the meantime?
+    if (!hidMergedEventBuffer) {
+        PsychUnlockMutex(&hidMergedEventBufferMutex);
+        return(0);
+    }
+
+    cap = hidMergedEventBufferCapacity;
+    navail = hidMergedEventBufferWritePos - hidMergedEventBufferReadPos;
+    if (navail < cap) {
+        // Find insertion position: Move all newer events one slot up:
+        pos = hidMergedEventBufferWritePos;
+        while ((pos != hidMergedEventBufferReadPos) && (hidMergedEventBuffer[(pos - 1) % cap].timestamp > evt->timestamp)) {
+            memcpy(&(hidMergedEventBuffer[pos % cap]), &(hidMergedEventBuffer[(pos - 1) % cap]), sizeof(PsychHIDEventRecord));
+            hidMergedEventDeviceIndex[pos % cap] = hidMergedEventDeviceIndex[(pos - 1) % cap];
+            pos--;
+        }
+
+        memcpy(&(hidMergedEventBuffer[pos % cap]), evt, sizeof(PsychHIDEventRecord));
+        hidMergedEventDeviceIndex[pos % cap] = deviceIndex;
+        hidMergedEventBufferWritePos++;
+        navail++;
+
+        // Announce new event to potential waiters:
+        PsychSignalCondition(&hidMergedEventBufferCondition);
+    }
+    else if (!hidMergedEventBufferOverflowed) {
+        // Only warn once per overflow, as this is called for the events of all devices:
+        hidMergedEventBufferOverflowed = TRUE;
+        printf("PsychHID: WARNING: Merged KbQueue event buffer is full! Maximum capacity of %i elements reached, will discard future events.\n", cap);
+    }
+
+    PsychUnlockMutex(&hidMergedEventBufferMutex);
+
+    return(navail);
+}
+
+/* Return up to maxEvents events from the merged event buffer as struct array in output
+ * argument outArgIndex, or all available events if maxEvents < 0. Waits up to maxWaitTimeSecs
+ * for at least one event if the buffer is empty. Returns the number of events remaining in
+ * the buffer after the fetch.
+ */
+int PsychHIDReturnEventsFromMergedEventBuffer(int outArgIndex, int maxEvents, double maxWaitTimeSecs)
+{
+    unsigned int navail, ncopy, i, cap;
+    PsychHIDEventRecord* evts;
+    int* deviceIndices;
+    PsychStructBuilder retevents;
+    double* foo = NULL;
+
+    if (!hidMergedEventBuffer) {
+        PsychCopyOutDoubleMatArg(outArgIndex, kPsychArgOptional, 0, 0, 0, foo);
+        return(0);
+    }
+
+    // Let other script threads run while waiting for events:
+    if (maxWaitTimeSecs > 0) PsychBeginBlockingRegion();
+
+    PsychLockMutex(&hidMergedEventBufferMutex);
+    navail = hidMergedEventBufferWritePos - hidMergedEventBufferReadPos;
+
+    // If nothing available and we're asked to wait for something, then wait:
+    if ((navail == 0) && (maxWaitTimeSecs > 0)) {
+        PsychTimedWaitCondition(&hidMergedEventBufferCondition, &hidMergedEventBufferMutex, maxWaitTimeSecs);
+        navail = (hidMergedEventBuffer) ? hidMergedEventBufferWritePos - hidMergedEventBufferReadPos : 0;
+    }
+
+    ncopy = ((maxEvents >= 0) && ((unsigned int) maxEvents < navail)) ? (unsigned int) maxEvents : navail;
+
+    // Copy out the events in one go, so we hold the lock only for a short time:
+    evts = (PsychHIDEventRecord*) PsychMallocTemp((ncopy + 1) * sizeof(PsychHIDEventRecord));
+    deviceIndices = (int*) PsychMallocTemp((ncopy + 1) * sizeof(int));
+    cap = hidMergedEventBufferCapacity;
+    for (i = 0; i < ncopy; i++) {
+        memcpy(&evts[i], &(hidMergedEventBuffer[(hidMergedEventBufferReadPos + i) % cap]), sizeof(PsychHIDEventRecord));
+        deviceIndices[i] = hidMergedEventDeviceIndex[(hidMergedEventBufferReadPos + i) % cap];
+    }
+
+    hidMergedEventBufferReadPos += ncopy;
+
+    // Space available again, so rearm overflow warning:
+    if (ncopy > 0) hidMergedEventBufferOverflowed = FALSE;
+
+    PsychUnlockMutex(&hidMergedEventBufferMutex);
+
+    PsychEndBlockingRegion();
+
+    if (ncopy > 0) {
+        // Return struct array with one element per event, oldest event first:
+        PsychAllocOutStructBuilder(outArgIndex, kPsychArgOptional, (int) ncopy, kKbQueueEventNumFields, kbQueueEventFieldNames, &retevents);
+        for (i = 0; i < ncopy; i++) {
+            PsychHIDSetEventStructElement(&evts[i], (int) i, &retevents);
+            PsychSetStructBuilderDoubleElement(&retevents, kKbQueueEventDeviceIndex, (int) i, (double) deviceIndices[i]);
+        }
+    }
+    else {
+        // Return empty matrix:
+        PsychCopyOutDoubleMatArg(outArgIndex, kPsychArgOptional, 0, 0, 0, foo);
+    }
+
+    return((int) (navail - ncopy));
 }
 
 // Platform specific code starts here:
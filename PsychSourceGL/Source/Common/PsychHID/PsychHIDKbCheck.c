@@ -21,7 +21,7 @@
 
 #include "PsychHID.h"
 
-static char useString[] = "[keyIsDown,secs,keyCode]=PsychHID('KbCheck' [, deviceNumber][, scanList])";
+static char useString[] = "[keyIsDown,secs,keyCode,changeTimes]=PsychHID('KbCheck' [, deviceNumber][, scanList])";
 static char synopsisString[] =
         "Scan a keyboard, keypad, or other HID device with buttons, and return a vector of logical values indicating the "
         "state of each key.\n"
@@ -33,6 +33,12 @@ static char synopsisString[] =
         "the 256 keys by providing the optional 'scanList' parameter: 'scanList' must be a vector of 256 "
         "doubles, where the i'th element corresponds to the i'th key and a zero value means: Ignore this "
         "key during scan, whereas a positive non-zero value means: Scan this key.\n"
+        "On Linux, if 'deviceNumber' is specified and a keyboard queue for that device was created with flag 8 "
+        "and is started, the key state "
+        "is not queried from the X-Server, but read from a shadow copy which the queue's background thread "
+        "keeps up to date, so KbCheck becomes a cheap memory read. In that case 'changeTimes' returns the "
+        "GetSecs time of the most recent state change of each key, or zero if unknown. In all other cases "
+        "'changeTimes' is all zeros, and on other operating systems it is not returned.\n"
         "The PsychHID('KbCheck') implements the KbCheck command as provided by the  OS 9 Psychtoolbox. "
         "KbCheck is defined in Psychtoolbox-3 and invokes PsychHID('KbCheck'). "
         "Always use KbCheck instead of directly calling PsychHID('KbCheck'), unless you have very good "
@@ -50,7 +56,12 @@ PsychError PSYCHHIDKbCheck(void)
     PsychPushHelp(useString, synopsisString, seeAlsoString);
     if (PsychIsGiveHelp()) {PsychGiveHelp(); return(PsychError_none);};
 
+    // 'changeTimes' is only returned on Linux:
+    #if PSYCH_SYSTEM == PSYCH_LINUX
+    PsychErrorExit(PsychCapNumOutputArgs(4));
+    #else
     PsychErrorExit(PsychCapNumOutputArgs(3));
+    #endif
     PsychErrorExit(PsychCapNumInputArgs(2));
 
     // Get the optional device index:
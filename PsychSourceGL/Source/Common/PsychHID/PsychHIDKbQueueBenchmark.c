@@ -0,0 +1,133 @@
+/*
+    PsychtoolboxGL/Source/Common/PsychHID/PsychHIDKbQueueBenchmark.c
+
+    PROJECTS:
+
+        PsychHID only.
+
+    PLATFORMS:
+
+        All.
+
+    AUTHORS:
+
+        agent@local                     agent
+
+    HISTORY:
+
+        10/18/26  agent     Created. Throughput benchmark of the KbQueue event buffers.
+
+*/
+
+#include "PsychHID.h"
+
+PsychError PSYCHHIDKbQueueBenchmark(void)
+{
+    static char useString[] = "results = PsychHID('KbQueueBenchmark', deviceIndex [, numEvents=1000000][, numValuators=0][, numSlots=10000])";
+    static char synopsisString[] =
+        "Measure enqueue and dequeue throughput of the keyboard queue event buffer implementation.\n"
+        "Creates a temporary event buffer for 'deviceIndex', then repeatedly fills it with synthetic "
+        "events and drains it again, until 'numEvents' events have passed through it. No input devices "
+        "are needed or touched, so this also works on headless machines.\n"
+        "'deviceIndex' must not have a keyboard queue at the time of the call, and the merged event buffer "
+        "of PsychHID('KbQueueMerge') must be disabled.\n"
+        "'numValuators' Maximum number of valuators per event, as for PsychHID('KbQueueCreate'). Synthetic "
+        "events carry a varying number of valuators between 0 and 'numValuators'.\n"
+        "'numSlots' Capacity of the event buffer, ie. events per fill/drain round. Events with valuators take "
+        "more room than key events, so with 'numValuators' > 0 a round may end before 'numSlots' events, when the buffer runs out of room.\n"
+        "Returns a struct 'results' with the number of events, the enqueue and dequeue rates in events per "
+        "second, and the rate of queries for the number of pending CookedKey keypress events per second, as "
+        "used by CharAvail.\n";
+    static char seeAlsoString[] = "KbQueueCreate, KbQueueGetEvent, KbQueueMerge";
+
+    const char *FieldNames[] = { "numEvents", "enqueueRate", "dequeueRate", "availRate", "numCookedKeys" };
+    PsychGenericScriptType *results;
+    PsychHIDEventRecord evt;
+    int deviceIndex, numEvents, numValuators, numSlots, i, j, n, done;
+    unsigned int ncooked;
+    double tstart, tend, tenqueue, tdequeue, tavail;
+
+    PsychPushHelp(useString, synopsisString, seeAlsoString);
+    if (PsychIsGiveHelp()) {PsychGiveHelp(); return(PsychError_none);};
+
+    PsychErrorExit(PsychCapNumOutputArgs(1));
+    PsychErrorExit(PsychCapNumInputArgs(4));
+
+    PsychCopyInIntegerArg(1, kPsychArgRequired, &deviceIndex);
+    if (deviceIndex < 0) deviceIndex = PsychHIDGetDefaultKbQueueDevice();
+    if (deviceIndex >= PSYCH_HID_MAX_DEVICES) PsychErrorExitMsg(PsychError_user, "Invalid 'deviceIndex' specified. No such device!");
+
+    numEvents = 1000000;
+    PsychCopyInIntegerArg(2, kPsychArgOptional, &numEvents);
+    if (numEvents < 1) PsychErrorExitMsg(PsychError_user, "Invalid 'numEvents' specified. Must be at least 1.");
+
+    numValuators = 0;
+    PsychCopyInIntegerArg(3, kPsychArgOptional, &numValuators);
+    if ((numValuators < 0) || (numValuators > PSYCH_HID_MAX_VALUATORS))
+        PsychErrorExitMsg(PsychError_user, "Invalid 'numValuators' specified.");
+
+    numSlots = 10000;
+    PsychCopyInIntegerArg(4, kPsychArgOptional, &numSlots);
+    if (numSlots < 1) PsychErrorExitMsg(PsychError_user, "Invalid 'numSlots' specified. Must be at least 1.");
+
+    if (PsychHIDMergedEventBufferEnabled())
+        PsychErrorExitMsg(PsychError_user, "The merged event buffer is enabled. Disable it via PsychHID('KbQueueMerge', 0) first.");
+
+    if (!PsychHIDCreateEventBuffer(deviceIndex, numValuators, numSlots))
+        PsychErrorExitMsg(PsychError_user, "Could not create event buffer. Is there already a keyboard queue for 'deviceIndex'?");
+
+    memset(&evt, 0, sizeof(evt));
+    for (j = 0; j < numValuators; j++)
+        evt.valuators[j] = (float) j;
+
+    tenqueue = tdequeue = tavail = 0;
+    ncooked = 0;
+
+    for (done = 0; done < numEvents; done += n) {
+        n = numEvents - done;
+        if (n > numSlots) n = numSlots;
+
+        // Fill: Mix of keypresses with CookedKey codes, key releases and valuator events:
+        PsychGetAdjustedPrecisionTimerSeconds(&tstart);
+        for (i = 0; i < n; i++) {
+            evt.timestamp = tstart;
+            evt.type = (i & 1) ? 1 : 0;
+            evt.status = (i & 2) ? 0 : 1;
+            evt.rawEventCode = i & 0xff;
+            evt.cookedEventCode = (evt.type == 0) ? 'a' + (i % 26) : -1;
+            evt.numValuators = (numValuators > 0) ? i % (numValuators + 1) : 0;
+            if (!PsychHIDAddEventToEventBuffer(deviceIndex, &evt)) break;
+        }
+        PsychGetAdjustedPrecisionTimerSeconds(&tend);
+        tenqueue += tend - tstart;
+
+        // Buffer full before n events? Every round has the same mix of events, so all following
+        // rounds only get as many events as fit, without hitting the full buffer again:
+        if (i < n) numSlots = n = i;
+
+        // Query number of pending cooked keypress events with a full buffer:
+        PsychGetAdjustedPrecisionTimerSeconds(&tstart);
+        for (i = 0; i < n; i++)
+            ncooked = PsychHIDAvailEventBuffer(deviceIndex, 1);
+        PsychGetAdjustedPrecisionTimerSeconds(&tend);
+        tavail += tend - tstart;
+
+        // Drain:
+        PsychGetAdjustedPrecisionTimerSeconds(&tstart);
+        for (i = 0; i < n; i++)
+            PsychHIDGetEventFromEventBuffer(deviceIndex, &evt, 0);
+        PsychGetAdjustedPrecisionTimerSeconds(&tend);
+        tdequeue += tend - tstart;
+    }
+
+    PsychHIDDeleteEventBuffer(deviceIndex);
+
+    PsychAllocOutStructArray(1, kPsychArgOptional, -1, 5, FieldNames, &results);
+    PsychSetStructArrayDoubleElement("numEvents", 0, (double) numEvents, results);
+    PsychSetStructArrayDoubleElement("enqueueRate", 0, (tenqueue > 0) ? (double) numEvents / tenqueue : 0, results);
+    PsychSetStructArrayDoubleElement("dequeueRate", 0, (tdequeue > 0) ? (double) numEvents / tdequeue : 0, results);
+    PsychSetStructArrayDoubleElement("availRate", 0, (tavail > 0) ? (double) numEvents / tavail : 0, results);
+    PsychSetStructArrayDoubleElement("numCookedKeys", 0, (double) ncooked, results);
+
+    return(PsychError_none);
+}
@@ -93,7 +93,8 @@ static char synopsisString[] =
 "warnings will be printed. This defaults to 10000 events if omitted, which is plenty for simple collection "
 "of key/button press/release events, but might be tight for long running trials if mouse movements, joystick "
 "movements, or touch screen input is collected, ie. continuous input that might generate hundreds of events "
-"per second.\n"
+"per second. The buffer is sized for 'numSlots' events without valuators. Events with valuators take more "
+"room, so if many of them are queued, the buffer can be full before 'numSlots' events are stored.\n"
 "'flags' Optional flags to alter operation of the queue. Defaults to zero for default behavior.\n"
 "+1 = Always label synthetic key repeat events as invalid - iow. suppress them.\n"
 "     Supported on Linux only.\n"
@@ -103,6 +104,10 @@ static char synopsisString[] =
 "     Linux and Windows only.\n"
 "     For mouse and touchpad devices, this usually reports relative motion, ie.\n"
 "     movement deltas, instead of absolute position values.\n"
+"+8 = Maintain a shadow copy of the key state while the queue is started, from which\n"
+"     KbCheck for this device is served without querying the windowing system. Also\n"
+"     provides the time of the last state change of each key to KbCheck.\n"
+"     Linux only.\n"
 "\n\n"
 "'windowHandle' Optional windowing system specific handle for an associated onscreen window. Used on Linux/X11 only.\n"
 "\n";
@@ -0,0 +1,531 @@
+/*
+    PsychtoolboxGL/Source/Common/PsychHID/PsychHIDKbQueueJournal.c
+
+    PROJECTS:
+
+        PsychHID only.
+
+    PLATFORMS:
+
+        All.
+
+    AUTHORS:
+
+        agent@local                     agent
+
+    HISTORY:
+
+        10/18/26  agent     Created. Binary on-disk journal of KbQueue events.
+
+    NOTES:
+
+        A journal is a binary file which receives a compact copy of each event
+        that gets added to a keyboard queue event buffer via PsychHIDAddEventToEventBuffer().
+        The append happens inside the KbQueue worker thread, directly after the event is
+        stored in the live event buffer, and also if the live buffer is full, so the live
+        buffer can be kept small during long sessions without losing any events.
+
+        On Linux and OSX the file is written through a memory mapped window which gets
+        advanced in steps of PSYCH_HID_JOURNAL_MAPCHUNK bytes, so appending a record is
+        just a memcpy() without any syscall. On Windows, buffered stdio is used instead.
+
+        File layout, all values in native byte order of the writing machine:
+
+        PsychHIDJournalHeader, followed by numRecords records of recordSize bytes each.
+
+        Each record is a PsychHIDJournalRecord, followed by numValuators floats. The header
+        is rewritten with the final numRecords at journal close. If the writer did not close
+        the journal cleanly, numRecords is zero and readers detect the end of valid data by
+        the first all zero record of the zero-filled preallocated file tail.
+*/
+
+#include "PsychHID.h"
+
+#if PSYCH_SYSTEM != PSYCH_WINDOWS
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <fcntl.h>
+#include <unistd.h>
+#endif
+
+#define PSYCH_HID_JOURNAL_MAGIC     "PTBHIDJ1"
+#define PSYCH_HID_JOURNAL_VERSION   1
+#define PSYCH_HID_JOURNAL_BYTEORDER 0x01020304
+#define PSYCH_HID_JOURNAL_MAPCHUNK  (4 * 1024 * 1024)
+
+// 64-bit file offsets for stdio, as long is only 32 bits on Windows:
+#if PSYCH_SYSTEM == PSYCH_WINDOWS
+#define PsychHIDJournalSeek(fp, pos, whence)    _fseeki64((fp), (__int64) (pos), (whence))
+#define PsychHIDJournalTell(fp)                 ((psych_int64) _ftelli64(fp))
+#else
+#define PsychHIDJournalSeek(fp, pos, whence)    fseeko((fp), (off_t) (pos), (whence))
+#define PsychHIDJournalTell(fp)                 ((psych_int64) ftello(fp))
+#endif
+
+// On-disk header of a journal file:
+typedef struct PsychHIDJournalHeader {
+    char            magic[8];       // PSYCH_HID_JOURNAL_MAGIC
+    psych_uint32    version;        // PSYCH_HID_JOURNAL_VERSION
+    psych_uint32    byteOrder;      // PSYCH_HID_JOURNAL_BYTEORDER as written by writing machine.
+    psych_uint32    headerSize;     // sizeof(PsychHIDJournalHeader) - Offset of first record.
+    psych_uint32    recordSize;     // Size of one record in bytes, including valuators.
+    psych_uint32    numValuators;   // Number of float valuators stored per record.
+    psych_uint32    deviceIndex;    // deviceIndex of the keyboard queue which was journaled.
+    psych_uint32    timeBase;       // Time base of record timestamps: 0 = GetSecs() time.
+    psych_uint32    reserved;
+    double          startTime;      // GetSecs() time at journal creation.
+    double          startWallTime;  // Seconds since the UNIX epoch at journal creation.
+    psych_uint64    numRecords;     // Number of records, or zero if journal was not closed cleanly.
+} PsychHIDJournalHeader;
+
+// On-disk event record, followed by numValuators floats:
+typedef struct PsychHIDJournalRecord {
+    double          timestamp;
+    psych_uint32    type;
+    psych_uint32    status;
+    psych_uint32    buttonStates;
+    int             rawEventCode;
+    int             cookedEventCode;
+    int             numValuators;
+    float           X;
+    float           Y;
+    float           normX;
+    float           normY;
+} PsychHIDJournalRecord;
+
+// Writer state of one journal:
+typedef struct PsychHIDJournal {
+    PsychHIDJournalHeader header;
+    psych_uint64    writePos;       // Byte offset of next record in file.
+#if PSYCH_SYSTEM != PSYCH_WINDOWS
+    int             fd;
+    unsigned char*  map;            // Currently mapped window of the file.
+    psych_uint64    mapStart;       // File offset of the start of the mapped window.
+    psych_uint64    mapSize;        // Size of mapped window.
+#else
+    FILE*           fp;
+#endif
+    psych_bool      failed;         // Write error occured. Journal is dead.
+} PsychHIDJournal;
+
+static PsychHIDJournal* hidEventJournal[PSYCH_HID_MAX_DEVICES];
+static psych_bool hidEventJournalInitialized = FALSE;
+
+// Size of one record with numValuators valuators. Padded to a multiple of 8 Bytes to keep timestamps aligned:
+static size_t PsychHIDJournalRecordSize(int numValuators)
+{
+    return(sizeof(PsychHIDJournalRecord) + ((numValuators * sizeof(float) + 7) & ~((size_t) 7)));
+}
+
+#if PSYCH_SYSTEM != PSYCH_WINDOWS
+// Advance mapped window so that it contains at least 'bytes' bytes starting at 'pos':
+static psych_bool PsychHIDJournalRemap(PsychHIDJournal* journal, psych_uint64 pos, size_t bytes)
+{
+    psych_uint64 pagesize = (psych_uint64) sysconf(_SC_PAGESIZE);
+
+    if (journal->map) munmap(journal->map, journal->mapSize);
+    journal->map = NULL;
+
+    journal->mapStart = (pos / pagesize) * pagesize;
+    journal->mapSize = PSYCH_HID_JOURNAL_MAPCHUNK;
+    while (journal->mapStart + journal->mapSize < pos + bytes) journal->mapSize += PSYCH_HID_JOURNAL_MAPCHUNK;
+
+    // Preallocate the file. The new tail is zero-filled, which is what readers use to detect end of data:
+    if (ftruncate(journal->fd, (off_t) (journal->mapStart + journal->mapSize))) return(FALSE);
+
+    journal->map = (unsigned char*) mmap(NULL, journal->mapSize, PROT_READ | PROT_WRITE, MAP_SHARED, journal->fd, (off_t) journal->mapStart);
+    if (journal->map == MAP_FAILED) {
+        journal->map = NULL;
+        return(FALSE);
+    }
+
+    return(TRUE);
+}
+#endif
+
+// Write a block of bytes at the current write position and advance it:
+static psych_bool PsychHIDJournalWrite(PsychHIDJournal* journal, const void* data, size_t bytes)
+{
+#if PSYCH_SYSTEM != PSYCH_WINDOWS
+    if (!journal->map || (journal->writePos + bytes > journal->mapStart + journal->mapSize)) {
+        if (!PsychHIDJournalRemap(journal, journal->writePos, bytes)) return(FALSE);
+    }
+
+    memcpy(journal->map + (journal->writePos - journal->mapStart), data, bytes);
+#else
+    if (fwrite(data, 1, bytes, journal->fp) != bytes) return(FALSE);
+#endif
+
+    journal->writePos += bytes;
+    return(TRUE);
+}
+
+// Rewrite the header at the start of the file:
+static psych_bool PsychHIDJournalWriteHeader(PsychHIDJournal* journal)
+{
+#if PSYCH_SYSTEM != PSYCH_WINDOWS
+    return(pwrite(journal->fd, &journal->header, sizeof(journal->header), 0) == sizeof(journal->header));
+#else
+    psych_bool rc;
+    psych_int64 pos = PsychHIDJournalTell(journal->fp);
+    rc = (PsychHIDJournalSeek(journal->fp, 0, SEEK_SET) == 0) && (fwrite(&journal->header, sizeof(journal->header), 1, journal->fp) == 1);
+    PsychHIDJournalSeek(journal->fp, pos, SEEK_SET);
+    return(rc);
+#endif
+}
+
+static void PsychHIDJournalInit(void)
+{
+    if (!hidEventJournalInitialized) {
+        memset(&hidEventJournal[0], 0, sizeof(hidEventJournal));
+        hidEventJournalInitialized = TRUE;
+    }
+}
+
+psych_bool PsychHIDEventJournalActive(int deviceIndex)
+{
+    return((hidEventJournalInitialized && hidEventJournal[deviceIndex]) ? TRUE : FALSE);
+}
+
+/* Open a new journal file 'filename' for the event buffer of 'deviceIndex', storing
+ * up to 'numValuators' valuators per event. Replaces an existing file of that name.
+ * Must be called with the event buffer lock of deviceIndex held.
+ */
+psych_bool PsychHIDOpenEventJournal(int deviceIndex, const char* filename, int numValuators)
+{
+    PsychHIDJournal* journal;
+    double now;
+
+    PsychHIDJournalInit();
+
+    if (hidEventJournal[deviceIndex]) return(FALSE);
+
+    journal = (PsychHIDJournal*) calloc(1, sizeof(PsychHIDJournal));
+    if (!journal) return(FALSE);
+
+    if (numValuators < 0) numValuators = 0;
+    if (numValuators > PSYCH_HID_MAX_VALUATORS) numValuators = PSYCH_HID_MAX_VALUATORS;
+
+    PsychGetAdjustedPrecisionTimerSeconds(&now);
+
+    memcpy(journal->header.magic, PSYCH_HID_JOURNAL_MAGIC, sizeof(journal->header.magic));
+    journal->header.version = PSYCH_HID_JOURNAL_VERSION;
+    journal->header.byteOrder = PSYCH_HID_JOURNAL_BYTEORDER;
+    journal->header.headerSize = (psych_uint32) sizeof(PsychHIDJournalHeader);
+    journal->header.recordSize = (psych_uint32) PsychHIDJournalRecordSize(numValuators);
+    journal->header.numValuators = (psych_uint32) numValuators;
+    journal->header.deviceIndex = (psych_uint32) deviceIndex;
+    journal->header.timeBase = 0;
+    journal->header.startTime = now;
+    journal->header.startWallTime = (double) time(NULL);
+    journal->header.numRecords = 0;
+
+#if PSYCH_SYSTEM != PSYCH_WINDOWS
+    journal->fd = open(filename, O_RDWR | O_CREAT | O_TRUNC, 0644);
+    if (journal->fd < 0) {
+        free(journal);
+        return(FALSE);
+    }
+#else
+    journal->fp = fopen(filename, "w+b");
+    if (!journal->fp) {
+        free(journal);
+        return(FALSE);
+    }
+
+    // Use a large stdio buffer, so appends rarely cause a syscall:
+    setvbuf(journal->fp, NULL, _IOFBF, PSYCH_HID_JOURNAL_MAPCHUNK);
+#endif
+
+    if (!PsychHIDJournalWrite(journal, &journal->header, sizeof(journal->header))) {
+#if PSYCH_SYSTEM != PSYCH_WINDOWS
+        if (journal->map) munmap(journal->map, journal->mapSize);
+        close(journal->fd);
+#else
+        fclose(journal->fp);
+#endif
+        free(journal);
+        return(FALSE);
+    }
+
+    hidEventJournal[deviceIndex] = journal;
+
+    return(TRUE);
+}
+
+/* Close journal of 'deviceIndex', if any, and return number of records written.
+ * Must be called with the event buffer lock of deviceIndex held.
+ */
+double PsychHIDCloseEventJournal(int deviceIndex)
+{
+    PsychHIDJournal* journal;
+    double numRecords;
+
+    PsychHIDJournalInit();
+
+    journal = hidEventJournal[deviceIndex];
+    if (!journal) return(0);
+    hidEventJournal[deviceIndex] = NULL;
+
+    journal->header.numRecords = (journal->writePos > journal->header.headerSize) ?
+                                 (journal->writePos - journal->header.headerSize) / journal->header.recordSize : 0;
+    numRecords = (double) journal->header.numRecords;
+
+#if PSYCH_SYSTEM != PSYCH_WINDOWS
+    if (journal->map) {
+        msync(journal->map, journal->mapSize, MS_SYNC);
+        munmap(journal->map, journal->mapSize);
+    }
+
+    // Cut off preallocated, but unused, tail:
+    if (ftruncate(journal->fd, (off_t) journal->writePos))
+        printf("PsychHID-WARNING: Failed to truncate KbQueue journal file to final size: %s\n", strerror(errno));
+
+    if (!PsychHIDJournalWriteHeader(journal))
+        printf("PsychHID-WARNING: Failed to finalize header of KbQueue journal file.\n");
+
+    close(journal->fd);
+#else
+    if (!PsychHIDJournalWriteHeader(journal))
+        printf("PsychHID-WARNING: Failed to finalize header of KbQueue journal file.\n");
+
+    fclose(journal->fp);
+#endif
+
+    if (journal->failed)
+        printf("PsychHID-WARNING: KbQueue journal for deviceIndex %i is incomplete due to write errors!\n", deviceIndex);
+
+    free(journal);
+
+    return(numRecords);
+}
+
+/* Append event 'evt' to journal of 'deviceIndex', if journaling is active.
+ * Called from PsychHIDAddEventToEventBuffer() with the event buffer lock of
+ * deviceIndex held. Returns TRUE if the event was journaled.
+ */
+psych_bool PsychHIDAddEventToEventJournal(int deviceIndex, PsychHIDEventRecord* evt)
+{
+    PsychHIDJournal* journal;
+    PsychHIDJournalRecord rec;
+    int numValuators;
+
+    if (!hidEventJournalInitialized || !(journal = hidEventJournal[deviceIndex]) || journal->failed) return(FALSE);
+
+    numValuators = (int) journal->header.numValuators;
+
+    rec.timestamp = evt->timestamp;
+    rec.type = evt->type;
+    rec.status = evt->status;
+    rec.buttonStates = evt->buttonStates;
+    rec.rawEventCode = evt->rawEventCode;
+    rec.cookedEventCode = evt->cookedEventCode;
+    rec.numValuators = (evt->numValuators < numValuators) ? evt->numValuators : numValuators;
+    rec.X = evt->X;
+    rec.Y = evt->Y;
+    rec.normX = evt->normX;
+    rec.normY = evt->normY;
+
+    if (!PsychHIDJournalWrite(journal, &rec, sizeof(rec)) ||
+        ((numValuators > 0) && !PsychHIDJournalWrite(journal, &evt->valuators[0], journal->header.recordSize - sizeof(rec)))) {
+        journal->failed = TRUE;
+        printf("PsychHID-ERROR: Write to KbQueue journal for deviceIndex %i failed! Journaling stopped.\n", deviceIndex);
+        return(FALSE);
+    }
+
+    return(TRUE);
+}
+
+PsychError PSYCHHIDKbQueueJournal(void)
+{
+    static char useString[] = "numRecords = PsychHID('KbQueueJournal', deviceIndex [, filename][, numValuators])";
+    //                                                                  1              2           3
+    static char synopsisString[] =
+        "Start or stop journaling of all events of a keyboard queue into a binary file.\n"
+        "While journaling is active, every event which gets recorded into the event buffer of the "
+        "keyboard queue of device 'deviceIndex' is also appended as a compact binary record to the "
+        "journal file. The append happens in the background queue processing thread, and it also "
+        "happens if the event buffer is full, so you can keep the event buffer small during long "
+        "sessions, e.g., EEG or fMRI runs over multiple hours, without losing events.\n"
+        "PsychHID('KbQueueCreate') must be called before this routine. Releasing the queue also "
+        "stops journaling. Use PsychHID('KbQueueJournalRead') to read and decode a journal file.\n"
+        "'deviceIndex' The index of the device whose queue should be journaled. -1 selects the default device.\n"
+        "'filename' Name of the journal file to create. An existing file of the same name gets replaced. "
+        "If omitted or empty, journaling of the queue is stopped and the file is finalized.\n"
+        "'numValuators' How many valuators should be stored per event. Defaults to the 'numValuators' "
+        "setting of the queue, as specified in PsychHID('KbQueueCreate').\n"
+        "Returns the number of records written to the journal if journaling was stopped, zero otherwise.\n";
+    static char seeAlsoString[] = "KbQueueJournalRead, KbQueueCreate, KbQueueStart, KbQueueStop, KbQueueGetEvent";
+
+    int deviceIndex, numValuators;
+    char* filename = NULL;
+    double numRecords = 0;
+
+    PsychPushHelp(useString, synopsisString, seeAlsoString);
+    if (PsychIsGiveHelp()) {PsychGiveHelp(); return(PsychError_none);};
+
+    PsychErrorExit(PsychCapNumOutputArgs(1));
+    PsychErrorExit(PsychCapNumInputArgs(3));
+
+    deviceIndex = -1;
+    PsychCopyInIntegerArg(1, kPsychArgRequired, &deviceIndex);
+    if (deviceIndex < 0) deviceIndex = PsychHIDGetDefaultKbQueueDevice();
+    if (deviceIndex >= PSYCH_HID_MAX_DEVICES) PsychErrorExitMsg(PsychError_user, "Invalid 'deviceIndex' specified. No such device!");
+
+    numValuators = -1;
+    PsychCopyInIntegerArg(3, kPsychArgOptional, &numValuators);
+
+    PsychAllocInCharArg(2, kPsychArgOptional, &filename);
+
+    if (filename && strlen(filename) > 0) {
+        switch (PsychHIDStartEventJournal(deviceIndex, filename, numValuators)) {
+            case 0:
+                break;
+
+            case 1:
+                PsychErrorExitMsg(PsychError_user, "Invalid 'deviceIndex' specified. No queue for that device yet! Call KbQueueCreate first!");
+
+            case 2:
+                PsychErrorExitMsg(PsychError_user, "Journaling for this keyboard queue is already active. Stop it first.");
+
+            default:
+                printf("PsychHID-ERROR: Could not create KbQueue journal file '%s'.\n", filename);
+                PsychErrorExitMsg(PsychError_system, "Failed to create journal file for keyboard queue.");
+        }
+    }
+    else {
+        numRecords = PsychHIDStopEventJournal(deviceIndex);
+    }
+
+    PsychCopyOutDoubleArg(1, kPsychArgOptional, numRecords);
+
+    return(PsychError_none);
+}
+
+PsychError PSYCHHIDKbQueueJournalRead(void)
+{
+    static char useString[] = "[events, info] = PsychHID('KbQueueJournalRead', filename [, startIndex=0][, maxEvents=all])";
+    //                                                                          1           2                3
+    static char synopsisString[] =
+        "Read and decode events from a keyboard queue journal file, as written by PsychHID('KbQueueJournal').\n"
+        "'filename' Name of the journal file.\n"
+        "'startIndex' Zero-based index of the first event to return. Defaults to zero.\n"
+        "'maxEvents' Maximum number of events to return. Defaults to all remaining events.\n"
+        "Returns a double matrix 'events' with one column per event, in recording order. The rows are:\n"
+        "1 = Time, 2 = Type, 3 = Pressed, 4 = Keycode, 5 = CookedKey, 6 = ButtonStates, 7 = Motion, "
+        "8 = X, 9 = Y, 10 = NormX, 11 = NormY, 12 = number of valid valuators, 13 and following = Valuators.\n"
+        "The meaning of these values is the same as for the fields of the event struct returned by "
+        "PsychHID('KbQueueGetEvent'). The matrix has 12 + info.numValuators rows.\n"
+        "The optional struct 'info' describes the journal: 'deviceIndex', 'numValuators', 'timeBase' "
+        "(0 = GetSecs() time), 'startTime' (GetSecs time of journal creation), 'startWallTime' "
+        "(Seconds since UNIX epoch at journal creation), 'numRecords' (total number of events in the journal) "
+        "and 'complete' (1 if the journal was cleanly closed, 0 if the session was aborted, in which case "
+        "all events up to the point of the abort are still returned).\n";
+    static char seeAlsoString[] = "KbQueueJournal";
+
+    const char *FieldNames[] = { "deviceIndex", "numValuators", "timeBase", "startTime", "startWallTime", "numRecords", "complete" };
+    PsychGenericScriptType *info;
+    PsychHIDJournalHeader header;
+    PsychHIDJournalRecord* rec;
+    unsigned char *buffer, *recbuf;
+    char* filename = NULL;
+    double *out;
+    double startIndex, maxEvents;
+    psych_uint64 numRecords, i, count;
+    FILE* fp;
+    psych_int64 fileSize;
+    int j, nrows;
+    psych_bool complete;
+
+    PsychPushHelp(useString, synopsisString, seeAlsoString);
+    if (PsychIsGiveHelp()) {PsychGiveHelp(); return(PsychError_none);};
+
+    PsychErrorExit(PsychCapNumOutputArgs(2));
+    PsychErrorExit(PsychCapNumInputArgs(3));
+
+    PsychAllocInCharArg(1, kPsychArgRequired, &filename);
+
+    startIndex = 0;
+    PsychCopyInDoubleArg(2, kPsychArgOptional, &startIndex);
+    if (startIndex < 0) PsychErrorExitMsg(PsychError_user, "Invalid 'startIndex' specified. Must be at least 0.");
+
+    maxEvents = -1;
+    PsychCopyInDoubleArg(3, kPsychArgOptional, &maxEvents);
+
+    fp = fopen(filename, "rb");
+    if (!fp) PsychErrorExitMsg(PsychError_user, "Could not open the given journal file for reading.");
+
+    if ((fread(&header, sizeof(header), 1, fp) != 1) || memcmp(header.magic, PSYCH_HID_JOURNAL_MAGIC, sizeof(header.magic))) {
+        fclose(fp);
+        PsychErrorExitMsg(PsychError_user, "The given file is not a PsychHID keyboard queue journal.");
+    }
+
+    if ((header.byteOrder != PSYCH_HID_JOURNAL_BYTEORDER) || (header.version != PSYCH_HID_JOURNAL_VERSION) ||
+        (header.headerSize != sizeof(header)) || (header.numValuators > PSYCH_HID_MAX_VALUATORS) ||
+        (header.recordSize != PsychHIDJournalRecordSize((int) header.numValuators))) {
+        fclose(fp);
+        PsychErrorExitMsg(PsychError_user, "The given journal file has an unsupported version or byte order.");
+    }
+
+    PsychHIDJournalSeek(fp, 0, SEEK_END);
+    fileSize = PsychHIDJournalTell(fp);
+
+    // numRecords is only valid for cleanly closed journals. Otherwise derive an upper bound from the file size:
+    complete = (header.numRecords > 0) || (fileSize == (psych_int64) header.headerSize);
+    numRecords = (complete) ? header.numRecords : (psych_uint64) (fileSize - header.headerSize) / header.recordSize;
+
+    count = ((psych_uint64) startIndex < numRecords) ? numRecords - (psych_uint64) startIndex : 0;
+    if ((maxEvents >= 0) && ((psych_uint64) maxEvents < count)) count = (psych_uint64) maxEvents;
+
+    // Read all requested records in one go:
+    buffer = (unsigned char*) PsychMallocTemp((size_t) (count * header.recordSize) + 1);
+    PsychHIDJournalSeek(fp, header.headerSize + (psych_uint64) startIndex * header.recordSize, SEEK_SET);
+    count = (count > 0) ? (psych_uint64) fread(buffer, header.recordSize, (size_t) count, fp) : 0;
+    fclose(fp);
+
+    // Journal of an aborted session? Valid data ends at first zero-filled record:
+    if (!complete) {
+        for (i = 0; i < count; i++) {
+            rec = (PsychHIDJournalRecord*) (buffer + i * header.recordSize);
+            if (rec->timestamp == 0) break;
+        }
+
+        count = i;
+        numRecords = (psych_uint64) startIndex + count;
+    }
+
+    // Decode into output matrix:
+    nrows = 12 + (int) header.numValuators;
+    PsychAllocOutDoubleMatArg(1, kPsychArgOptional, nrows, (int) count, 1, &out);
+    for (i = 0; i < count; i++) {
+        recbuf = buffer + i * header.recordSize;
+        rec = (PsychHIDJournalRecord*) recbuf;
+
+        *(out++) = rec->timestamp;
+        *(out++) = (double) rec->type;
+        *(out++) = (rec->status & (1 << 0)) ? 1 : 0;
+        *(out++) = (double) rec->rawEventCode;
+        *(out++) = (double) rec->cookedEventCode;
+        *(out++) = (double) rec->buttonStates;
+        *(out++) = (rec->status & (1 << 1)) ? 1 : 0;
+        *(out++) = (double) rec->X;
+        *(out++) = (double) rec->Y;
+        *(out++) = (double) rec->normX;
+        *(out++) = (double) rec->normY;
+        *(out++) = (double) rec->numValuators;
+
+        for (j = 0; j < (int) header.numValuators; j++)
+            *(out++) = (double) ((float*) (recbuf + sizeof(PsychHIDJournalRecord)))[j];
+    }
+
+    PsychAllocOutStructArray(2, kPsychArgOptional, -1, 7, FieldNames, &info);
+    PsychSetStructArrayDoubleElement("deviceIndex",   0, (double) header.deviceIndex,  info);
+    PsychSetStructArrayDoubleElement("numValuators",  0, (double) header.numValuators, info);
+    PsychSetStructArrayDoubleElement("timeBase",      0, (double) header.timeBase,     info);
+    PsychSetStructArrayDoubleElement("startTime",     0, header.startTime,             info);
+    PsychSetStructArrayDoubleElement("startWallTime", 0, header.startWallTime,         info);
+    PsychSetStructArrayDoubleElement("numRecords",    0, (double) numRecords,          info);
+    PsychSetStructArrayDoubleElement("complete",      0, (double) complete,            info);
+
+    return(PsychError_none);
+}
@@ -0,0 +1,178 @@
+/*
+    PsychtoolboxGL/Source/Common/PsychHID/PsychHIDKbQueueLatency.c
+
+    PROJECTS:
+
+        PsychHID only.
+
+    PLATFORMS:
+
+        All.
+
+    AUTHORS:
+
+        agent@local                     agent
+
+    HISTORY:
+
+        10/18/26  agent     Created. Latency tracing of the KbQueue event processing chain.
+
+    NOTES:
+
+        Each traced event gets timestamped at four stages: When the OS kernel or window system received it,
+        when the KbQueue worker thread dequeued it, when it got inserted into the event buffer, and when
+        the script retrieved it via KbQueueGetEvent. The latencies between stages are accumulated into
+        per-device histograms. All functions except the PSYCHHIDKbQueueLatencyTrace() subfunction must be
+        called with the event buffer lock of the device held.
+
+*/
+
+#include "PsychHID.h"
+
+static PsychHIDLatencyHistogram* hidLatencyStats[PSYCH_HID_MAX_DEVICES];
+
+static const char *hidLatencyStageNames[PSYCH_HID_LATENCY_STAGES] = { "KernelToWorker", "WorkerToBuffer", "BufferToScript", "Total" };
+
+static void PsychHIDAddLatency(PsychHIDLatencyHistogram* hist, double latency)
+{
+    double usecs = latency * 1e6;
+    int bin;
+
+    if (hist->count == 0 || latency < hist->min) hist->min = latency;
+    if (hist->count == 0 || latency > hist->max) hist->max = latency;
+    hist->count++;
+    hist->sum += latency;
+    hist->sumsq += latency * latency;
+
+    // Logarithmic bins, four per octave, starting at 1 usec:
+    if (usecs < 1)
+        bin = 0;
+    else
+        bin = 1 + (int) floor(4 * log2(usecs));
+
+    if (bin >= PSYCH_HID_LATENCY_BINS) bin = PSYCH_HID_LATENCY_BINS - 1;
+
+    hist->bins[bin]++;
+}
+
+psych_bool PsychHIDResetEventLatencyStats(int deviceIndex)
+{
+    if (!hidLatencyStats[deviceIndex])
+        hidLatencyStats[deviceIndex] = (PsychHIDLatencyHistogram*) malloc(PSYCH_HID_LATENCY_STAGES * sizeof(PsychHIDLatencyHistogram));
+
+    if (!hidLatencyStats[deviceIndex]) return(FALSE);
+
+    memset(hidLatencyStats[deviceIndex], 0, PSYCH_HID_LATENCY_STAGES * sizeof(PsychHIDLatencyHistogram));
+
+    return(TRUE);
+}
+
+void PsychHIDCopyEventLatencyStats(int deviceIndex, PsychHIDLatencyHistogram* stats)
+{
+    if (hidLatencyStats[deviceIndex])
+        memcpy(stats, hidLatencyStats[deviceIndex], PSYCH_HID_LATENCY_STAGES * sizeof(PsychHIDLatencyHistogram));
+    else
+        memset(stats, 0, PSYCH_HID_LATENCY_STAGES * sizeof(PsychHIDLatencyHistogram));
+}
+
+/* Account one event: tKernel is < 0 if the OS backend doesn't provide kernel timestamps, tBuffer < 0
+ * if the event was already in the buffer when tracing got enabled.
+ */
+void PsychHIDAddEventLatencySample(int deviceIndex, double tKernel, double tWorker, double tBuffer, double tScript)
+{
+    PsychHIDLatencyHistogram* hist = hidLatencyStats[deviceIndex];
+
+    if (!hist || (tBuffer < 0)) return;
+
+    if (tKernel >= 0) PsychHIDAddLatency(&hist[0], tWorker - tKernel);
+    PsychHIDAddLatency(&hist[1], tBuffer - tWorker);
+    PsychHIDAddLatency(&hist[2], tScript - tBuffer);
+    PsychHIDAddLatency(&hist[3], tScript - ((tKernel >= 0) ? tKernel : tWorker));
+}
+
+void PsychHIDReleaseEventLatencyStats(void)
+{
+    int i;
+
+    for (i = 0; i < PSYCH_HID_MAX_DEVICES; i++) {
+        free(hidLatencyStats[i]);
+        hidLatencyStats[i] = NULL;
+    }
+}
+
+PsychError PSYCHHIDKbQueueLatencyTrace(void)
+{
+    static char useString[] = "[stats, oldEnable] = PsychHID('KbQueueLatencyTrace', deviceIndex [, enable])";
+    static char synopsisString[] =
+        "Enable, disable or query latency tracing of the keyboard queue of device 'deviceIndex'.\n"
+        "While enabled, each event of the queue is timestamped when the operating system kernel or window "
+        "system received it, when the queue's worker thread dequeued it, when it got stored in the queue's "
+        "event buffer, and when the script fetched it via PsychHID('KbQueueGetEvent'). The delays between "
+        "these stages are accumulated in histograms, to quantify the latency of the input processing chain.\n"
+        "Kernel timestamps are currently only available on Linux with the XInput2 backend, with the "
+        "1 msec resolution of the X-Server. On other systems the 'KernelToWorker' stage stays empty and "
+        "the 'Total' stage starts at the worker thread.\n"
+        "'deviceIndex' The index of the device whose queue should be traced. -1 selects the default device.\n"
+        "'enable' 1 = Enable tracing and reset statistics, 0 = Disable tracing, 2 = Only reset statistics. "
+        "If omitted, the current statistics are only queried.\n"
+        "Returns a struct array 'stats' with one element per stage 'KernelToWorker', 'WorkerToBuffer', "
+        "'BufferToScript' and 'Total', as of before the call. Fields are the 'stage' name, the number of "
+        "events 'count', the 'min', 'max', 'mean' and standard deviation 'std' of the latencies in seconds, "
+        "the lower edges of the histogram bins 'binEdges' in seconds, and the event 'counts' per bin. Bins "
+        "are logarithmically spaced, four per octave, starting at 1 usec. The last bin also counts all "
+        "longer latencies. 'oldEnable' is the previous enable setting.\n";
+    static char seeAlsoString[] = "KbQueueCreate, KbQueueGetEvent";
+
+    const char *FieldNames[] = { "stage", "count", "min", "max", "mean", "std", "binEdges", "counts" };
+    PsychHIDLatencyHistogram stats[PSYCH_HID_LATENCY_STAGES];
+    PsychGenericScriptType *outStats, *outMat;
+    double *edges, *counts, mean;
+    int deviceIndex, enable, oldEnable, i, j;
+
+    PsychPushHelp(useString, synopsisString, seeAlsoString);
+    if (PsychIsGiveHelp()) {PsychGiveHelp(); return(PsychError_none);};
+
+    PsychErrorExit(PsychCapNumOutputArgs(2));
+    PsychErrorExit(PsychCapNumInputArgs(2));
+
+    deviceIndex = -1;
+    PsychCopyInIntegerArg(1, kPsychArgRequired, &deviceIndex);
+    if (deviceIndex < 0) deviceIndex = PsychHIDGetDefaultKbQueueDevice();
+    if (deviceIndex >= PSYCH_HID_MAX_DEVICES) PsychErrorExitMsg(PsychError_user, "Invalid 'deviceIndex' specified. No such device!");
+
+    enable = -1;
+    PsychCopyInIntegerArg(2, kPsychArgOptional, &enable);
+    if (enable > 2) PsychErrorExitMsg(PsychError_user, "Invalid 'enable' setting specified. Must be 0, 1 or 2.");
+
+    if (!PsychHIDGetEventLatencyStats(deviceIndex, stats))
+        PsychErrorExitMsg(PsychError_user, "Invalid 'deviceIndex' specified. No queue for that device yet! Call KbQueueCreate first!");
+
+    oldEnable = PsychHIDSetEventLatencyTrace(deviceIndex, enable);
+
+    PsychAllocOutStructArray(1, kPsychArgOptional, PSYCH_HID_LATENCY_STAGES, 8, FieldNames, &outStats);
+    for (i = 0; i < PSYCH_HID_LATENCY_STAGES; i++) {
+        mean = (stats[i].count > 0) ? stats[i].sum / stats[i].count : 0;
+
+        PsychSetStructArrayStringElement("stage", i, (char*) hidLatencyStageNames[i], outStats);
+        PsychSetStructArrayDoubleElement("count", i, stats[i].count, outStats);
+        PsychSetStructArrayDoubleElement("min", i, stats[i].min, outStats);
+        PsychSetStructArrayDoubleElement("max", i, stats[i].max, outStats);
+        PsychSetStructArrayDoubleElement("mean", i, mean, outStats);
+        PsychSetStructArrayDoubleElement("std", i, (stats[i].count > 1) ?
+                                         sqrt(fmax(0, (stats[i].sumsq - stats[i].count * mean * mean) / (stats[i].count - 1))) : 0, outStats);
+
+        PsychAllocateNativeDoubleMat(1, PSYCH_HID_LATENCY_BINS, 1, &edges, &outMat);
+        edges[0] = 0;
+        for (j = 1; j < PSYCH_HID_LATENCY_BINS; j++)
+            edges[j] = pow(2.0, (double) (j - 1) / 4.0) * 1e-6;
+        PsychSetStructArrayNativeElement("binEdges", i, outMat, outStats);
+
+        PsychAllocateNativeDoubleMat(1, PSYCH_HID_LATENCY_BINS, 1, &counts, &outMat);
+        memcpy(counts, stats[i].bins, PSYCH_HID_LATENCY_BINS * sizeof(double));
+        PsychSetStructArrayNativeElement("counts", i, outMat, outStats);
+    }
+
+    PsychCopyOutDoubleArg(2, kPsychArgOptional, (double) oldEnable);
+
+    return(PsychError_none);
+}
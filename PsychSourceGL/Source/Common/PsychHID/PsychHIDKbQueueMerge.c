@@ -0,0 +1,133 @@
+/*
+    PsychtoolboxGL/Source/Common/PsychHID/PsychHIDKbQueueMerge.c
+
+    PROJECTS:
+
+        PsychHID only.
+
+    PLATFORMS:
+
+        All.
+
+    AUTHORS:
+
+        agent@local                     agent
+
+    HISTORY:
+
+        10/18/26  agent     Created. Merged, time-ordered event stream of all keyboard queues.
+
+*/
+
+#include "PsychHID.h"
+
+PsychError PSYCHHIDKbQueueMerge(void)
+{
+    static char useString[] = "[oldEnable, navail] = PsychHID('KbQueueMerge' [, enable][, numSlots=10000])";
+    static char synopsisString[] =
+        "Enable or disable the merged event buffer of all keyboard queues.\n"
+        "If enabled, every event recorded by any keyboard queue of any device is also "
+        "stored in one global merged event buffer, tagged with the 'deviceIndex' of the "
+        "device which generated it. Events in the merged buffer are kept in order of their "
+        "timestamps, so a script can collect all input from multiple keyboards, response pads, "
+        "mice and touchscreens with one call to PsychHID('KbQueueGetMergedEvents'), instead "
+        "of polling and merging the event buffers of the individual queues itself.\n"
+        "The merged buffer is independent of the per-device event buffers, ie. events fetched "
+        "via PsychHID('KbQueueGetEvent') are still available from the merged buffer and vice "
+        "versa. Queues must still be created and started via PsychHID('KbQueueCreate') and "
+        "PsychHID('KbQueueStart') for their events to be recorded.\n"
+        "'enable' 1 = Enable merged buffer, 0 = Disable and release it, discarding all events it "
+        "contains, 2 = Flush all events from the merged buffer. If omitted, the current setting is "
+        "only queried.\n"
+        "'numSlots' Maximum capacity of the merged event buffer. Defaults to 10000 events. Only "
+        "takes effect when the buffer gets created.\n"
+        "Returns the previous 'oldEnable' setting, and the number of events 'navail' in the "
+        "merged buffer before the call.\n";
+    static char seeAlsoString[] = "KbQueueGetMergedEvents, KbQueueCreate, KbQueueStart, KbQueueStop, KbQueueGetEvent";
+
+    int enable, numSlots;
+    unsigned int navail;
+    psych_bool oldEnable;
+
+    PsychPushHelp(useString, synopsisString, seeAlsoString);
+    if (PsychIsGiveHelp()) {PsychGiveHelp(); return(PsychError_none);};
+
+    PsychErrorExit(PsychCapNumOutputArgs(2));
+    PsychErrorExit(PsychCapNumInputArgs(2));
+
+    oldEnable = PsychHIDMergedEventBufferEnabled();
+    navail = PsychHIDAvailMergedEventBuffer();
+
+    PsychCopyOutDoubleArg(1, kPsychArgOptional, (double) oldEnable);
+    PsychCopyOutDoubleArg(2, kPsychArgOptional, (double) navail);
+
+    // numSlots = 0 means to keep the default or last capacity:
+    numSlots = 0;
+    if (PsychCopyInIntegerArg(2, kPsychArgOptional, &numSlots) && (numSlots < 1))
+        PsychErrorExitMsg(PsychError_user, "Invalid number of 'numSlots' provided. Must be at least 1.");
+
+    if (PsychCopyInIntegerArg(1, kPsychArgOptional, &enable)) {
+        switch (enable) {
+            case 0:
+                PsychHIDDeleteMergedEventBuffer();
+                break;
+
+            case 1:
+                if (!PsychHIDCreateMergedEventBuffer(numSlots))
+                    PsychErrorExitMsg(PsychError_outofMemory, "Failed to create merged keyboard queue event buffer.");
+                break;
+
+            case 2:
+                PsychHIDFlushMergedEventBuffer();
+                break;
+
+            default:
+                PsychErrorExitMsg(PsychError_user, "Invalid 'enable' setting provided. Must be 0, 1 or 2.");
+        }
+    }
+
+    return(PsychError_none);
+}
+
+PsychError PSYCHHIDKbQueueGetMergedEvents(void)
+{
+    static char useString[] = "[events, navail] = PsychHID('KbQueueGetMergedEvents' [, maxEvents=all][, maxWaitTimeSecs=0])";
+    static char synopsisString[] =
+        "Fetch all events recorded in the merged event buffer since the last call.\n"
+        "The merged event buffer must have been enabled via PsychHID('KbQueueMerge', 1) before.\n"
+        "'maxEvents' optionally limits the number of returned events. By default, or if -1, all available "
+        "events are returned.\n"
+        "'maxWaitTimeSecs' is an optional maximum wait time for a new event in seconds, if the "
+        "merged buffer is empty. It defaults to zero, which means to just poll for pending events.\n"
+        "'events' is a struct array with one element per event, ordered by event time, oldest "
+        "event first, or an empty matrix if no events are pending. Each element has the same fields "
+        "as the 'event' struct returned by PsychHID('KbQueueGetEvent'), see its help for a "
+        "description, plus an additional field 'DeviceIndex' with the index of the device whose "
+        "keyboard queue recorded the event.\n"
+        "'navail' is the number of events remaining in the merged buffer after the fetch.\n";
+    static char seeAlsoString[] = "KbQueueMerge, KbQueueCreate, KbQueueStart, KbQueueStop, KbQueueGetEvent";
+
+    int maxEvents;
+    int navail;
+    double maxWaitTimeSecs;
+
+    PsychPushHelp(useString, synopsisString, seeAlsoString);
+    if (PsychIsGiveHelp()) {PsychGiveHelp(); return(PsychError_none);};
+
+    PsychErrorExit(PsychCapNumOutputArgs(2));
+    PsychErrorExit(PsychCapNumInputArgs(2));
+
+    maxEvents = -1;
+    PsychCopyInIntegerArg(1, kPsychArgOptional, &maxEvents);
+    if (maxEvents < -1)
+        PsychErrorExitMsg(PsychError_user, "Invalid 'maxEvents' provided. Must be -1 (all) or at least 0.");
+
+    maxWaitTimeSecs = 0;
+    PsychCopyInDoubleArg(2, kPsychArgOptional, &maxWaitTimeSecs);
+
+    // Get all (or up to maxEvents) events from merged buffer, return them as 1st return argument:
+    navail = PsychHIDReturnEventsFromMergedEventBuffer(1, maxEvents, maxWaitTimeSecs);
+    PsychCopyOutDoubleArg(2, FALSE, (double) navail);
+
+    return(PsychError_none);
+}
@@ -42,7 +42,7 @@ const char** InitializeSynopsis(void)
     synopsis[i++] = "elementState=PsychHID('CalibratedState',deviceNumber,elementNumber)";
     #endif
     synopsis[i++] = "elementState=PsychHID('RawState',deviceNumber,elementNumber)";
-    synopsis[i++] = "[keyIsDown,secs,keyCode]=PsychHID('KbCheck' [, deviceNumber][, scanList])";
+    synopsis[i++] = "[keyIsDown,secs,keyCode,changeTimes]=PsychHID('KbCheck' [, deviceNumber][, scanList])";
     synopsis[i++] = "[report,err]=PsychHID('GetReport',deviceNumber,reportType,reportID,reportBytes)";
     synopsis[i++] = "err=PsychHID('SetReport',deviceNumber,reportType,reportID,report)";
     synopsis[i++] = "[reports,err]=PsychHID('GiveMeReports',deviceNumber,[reportBytes])";
@@ -58,6 +58,14 @@ const char** InitializeSynopsis(void)
     synopsis[i++] = "[keyIsDown, firstKeyPressTimes, firstKeyReleaseTimes, lastKeyPressTimes, lastKeyReleaseTimes]=PsychHID('KbQueueCheck' [, deviceIndex])";
     synopsis[i++] = "secs=PsychHID('KbTriggerWait', KeysUsage, [deviceNumber])";
     synopsis[i++] = "[event, navail] = PsychHID('KbQueueGetEvent' [, deviceIndex][, maxWaitTimeSecs=0])";
+    synopsis[i++] = "[oldEnable, navail] = PsychHID('KbQueueMerge' [, enable][, numSlots=10000])";
+    synopsis[i++] = "[events, navail] = PsychHID('KbQueueGetMergedEvents' [, maxEvents=all][, maxWaitTimeSecs=0])";
+    synopsis[i++] = "numRecords = PsychHID('KbQueueJournal', deviceIndex [, filename][, numValuators])";
+    synopsis[i++] = "[events, info] = PsychHID('KbQueueJournalRead', filename [, startIndex=0][, maxEvents=all])";
+    synopsis[i++] = "results = PsychHID('KbQueueBenchmark', deviceIndex [, numEvents=1000000][, numValuators=0][, numSlots=10000])";
+    synopsis[i++] = "[stats, oldEnable] = PsychHID('KbQueueLatencyTrace', deviceIndex [, enable])";
+    synopsis[i++] = "domains = PsychHID('ClockDomains' [, command, domainName, ...])";
+    synopsis[i++] = "[enabled, numEvents] = PsychHID('Trace' [, command, ...])";
 
     synopsis[i++] = "\n\nSupport for access to generic USB devices: See 'help ColorCal2' for one usage example:\n\n";
     synopsis[i++] = "usbHandle = PsychHID('OpenUSBDevice', vendorID, deviceID [, configurationId=0])";
@@ -57,6 +57,12 @@ PsychError PsychModuleInit(void)
     PsychErrorExit(PsychRegister("KbQueueFlush", &PSYCHHIDKbQueueFlush));
     PsychErrorExit(PsychRegister("KbQueueRelease", &PSYCHHIDKbQueueRelease));
     PsychErrorExit(PsychRegister("KbQueueGetEvent", &PSYCHHIDKbQueueGetEvent));
+    PsychErrorExit(PsychRegister("KbQueueMerge", &PSYCHHIDKbQueueMerge));
+    PsychErrorExit(PsychRegister("KbQueueGetMergedEvents", &PSYCHHIDKbQueueGetMergedEvents));
+    PsychErrorExit(PsychRegister("KbQueueJournal", &PSYCHHIDKbQueueJournal));
+    PsychErrorExit(PsychRegister("KbQueueJournalRead", &PSYCHHIDKbQueueJournalRead));
+    PsychErrorExit(PsychRegister("KbQueueBenchmark", &PSYCHHIDKbQueueBenchmark));
+    PsychErrorExit(PsychRegister("KbQueueLatencyTrace", &PSYCHHIDKbQueueLatencyTrace));
 
     PsychErrorExit(PsychRegister("RawState",  &PSYCHHIDGetRawState));
     PsychErrorExit(PsychRegister("KbCheck",  &PSYCHHIDKbCheck));
@@ -70,6 +76,8 @@ PsychError PsychModuleInit(void)
     PsychErrorExit(PsychRegister("CloseUSBDevice", &PSYCHHIDCloseUSBDevice));
     PsychErrorExit(PsychRegister("USBControlTransfer", &PSYCHHIDUSBControlTransfer));
     PsychErrorExit(PsychRegister("KeyboardHelper", &PSYCHHIDKeyboardHelper));
+    PsychErrorExit(PsychRegister("ClockDomains", &PsychClockDomainsSubfunction));
+    PsychErrorExit(PsychRegister("Trace", &PsychTraceSubfunction));
 
     PsychSetModuleAuthorByInitials("awi");
     PsychSetModuleAuthorByInitials("dgp");
@@ -12,6 +12,10 @@
  *        21.03.2007        mk        wrote it.
  *        03.04.2011        mk        Make 64 bit clean. Allow 64-bit sized operations and float matrices.
  *        03.04.2011        mk        License changed to MIT with some restrictions.
+ *        18.10.2026        agent     Accept int16 sound data and pass usercode sound matrices through without copy.
+ *        18.10.2026        agent     Map audio timestamps via clock domain registry, with optional drift tracking for the stream clock.
+ *        18.10.2026        agent     Add event tracing of paCallback.
+ *        18.10.2026        agent     Add 'CallbackBenchmark' to measure the cost of paCallback without sound hardware.
  *
  *        DESCRIPTION:
  *
@@ -275,6 +279,8 @@ typedef struct PsychPADevice {
     double   latencyBias;           // A bias value to add to the value that PortAudio reports for total buffer->Speaker latency.
     // This value defaults to zero, but can be set up automatically on OS/X or manually on other OSes to compensate
     // for slight mistakes in PA's estimate.
+    int      clockDomain;           // Clock domain of ALSA timestamps: -2 = Not yet determined, -1 = GetSecs time, else kPsychClockDomainXXX.
+    int      streamClockDomain;     // Clock domain for the stream clock of host API's with unverified timestamps, -1 if none.
 
     // Audio schedule related:
     PsychPASchedule* schedule;      // Pointer to start of array with playback schedule, or a NULL pointer if none defined.
@@ -310,6 +316,7 @@ psych_bool    uselocking = TRUE;                // Use Mutex locking and signall
 psych_bool    lockToCore1 = TRUE;               // NO LONGER USED: Lock all engine threads to run on cpu core 1 on Windows to work around broken TSC sync on multi-cores?
 psych_bool    pulseaudio_autosuspend = TRUE;    // Should we try to suspend the Pulseaudio sound server on Linux while we're active?
 psych_bool    pulseaudio_isSuspended = FALSE;   // Is PulseAudio suspended by us?
+psych_bool    streamclock_tracking = FALSE;     // Map stream time of host API's with unverified timestamps via a clock domain with drift tracking?
 
 double debugdummy1, debugdummy2;
 
@@ -853,7 +860,13 @@ int PsychPAProcessSchedule(PsychPADevice* dev, psych_int64 *playposition, float*
     return(0);
 }
 
-/* paCallback: PortAudo I/O processing callback.
+static int paCallback( const void *inputBuffer, void *outputBuffer,
+                       unsigned long framesPerBuffer,
+                       const PaStreamCallbackTimeInfo* timeInfo,
+                       PaStreamCallbackFlags statusFlags,
+                       void *userData );
+
+/* paProcessCallback: PortAudo I/O processing callback, called via paCallback().
  *
  * This callback is called by PortAudios playback/capture engine whenever
  * it needs new data for playback or has new data from capture. We are expected
@@ -867,11 +880,11 @@ int PsychPAProcessSchedule(PsychPADevice* dev, psych_int64 *playposition, float*
  * things like calling PortAudio functions, allocating memory, file i/o or
  * other unbounded operations!
  */
-static int paCallback( const void *inputBuffer, void *outputBuffer,
-                       unsigned long framesPerBuffer,
-                       const PaStreamCallbackTimeInfo* timeInfo,
-                       PaStreamCallbackFlags statusFlags,
-                       void *userData )
+static int paProcessCallback( const void *inputBuffer, void *outputBuffer,
+                              unsigned long framesPerBuffer,
+                              const PaStreamCallbackTimeInfo* timeInfo,
+                              PaStreamCallbackFlags statusFlags,
+                              void *userData )
 {
     // Assign all variables, especially our dev device structure
     // with info about this stream:
@@ -940,21 +953,43 @@ static int paCallback( const void *inputBuffer, void *outputBuffer,
             // and remap such timestamps to our standard GetSecs timebase before
             // further processing.
 
-            // Get current CLOCK_MONOTONIC time:
-            double tMonotonic = PsychOSGetLinuxMonotonicTime();
+            // The clock domain is determined once at first callback, as it can't change while the
+            // device is open, and the mapping of that domain to GetSecs time is then taken from the
+            // clock domain registry, which tracks offset and drift without having to read the clock
+            // in each callback:
+            if (dev->clockDomain == -2) {
+                // Get current CLOCK_MONOTONIC time:
+                double tMonotonic = PsychOSGetLinuxMonotonicTime();
+
+                // Returned current time timestamp closer to tMonotonic than to GetSecs time?
+                if (fabs(timeInfo->currentTime - tMonotonic) < fabs(timeInfo->currentTime - now)) {
+                    // Timestamps are in monotonic time! Need to remap.
+                    dev->clockDomain = kPsychClockDomainMonotonic;
+                }
+                else if (PsychOSGetTimebase(NULL, NULL, NULL) > kPsychTimebaseRealtime) {
+                    // Timestamps are in CLOCK_REALTIME time, but our GetSecs timebase is CLOCK_MONOTONIC
+                    // based, so they may be off by NTP adjustments since startup. Need to remap.
+                    dev->clockDomain = kPsychClockDomainRealtime;
+                }
+                else {
+                    // Timestamps are already in GetSecs time:
+                    dev->clockDomain = -1;
+                }
+            }
 
-            // Returned current time timestamp closer to tMonotonic than to GetSecs time?
-            if (fabs(timeInfo->currentTime - tMonotonic) < fabs(timeInfo->currentTime - now)) {
-                // Timestamps are in monotonic time! Need to remap.
-                // tMonotonic shall be the offset between GetSecs and monotonic time,
-                // i.e., the offset that needs to be added to monotonic timestamps to
-                // remap them to GetSecs time:
-                tMonotonic = now - tMonotonic;
+            if (dev->clockDomain >= 0) {
+                // tOffset shall be the offset that needs to be added to the timestamps to remap
+                // them to GetSecs time. Never wait for the domain in this realtime callback:
+                double tOffset = PsychTryClockDomainToRefTime(dev->clockDomain, timeInfo->currentTime) - timeInfo->currentTime;
+
+                // Domain busy, or no mapping yet? Use the current offset between both clocks instead:
+                if (isnan(tOffset))
+                    tOffset = now - ((dev->clockDomain == kPsychClockDomainMonotonic) ? PsychOSGetLinuxMonotonicTime() : PsychGetWallClockSeconds());
 
                 // Correct all PortAudio timestamps by adding corrective offset:
-                ((PaStreamCallbackTimeInfo*) timeInfo)->currentTime += tMonotonic;
-                ((PaStreamCallbackTimeInfo*) timeInfo)->outputBufferDacTime += tMonotonic;
-                ((PaStreamCallbackTimeInfo*) timeInfo)->inputBufferAdcTime += tMonotonic;
+                ((PaStreamCallbackTimeInfo*) timeInfo)->currentTime += tOffset;
+                ((PaStreamCallbackTimeInfo*) timeInfo)->outputBufferDacTime += tOffset;
+                ((PaStreamCallbackTimeInfo*) timeInfo)->inputBufferAdcTime += tOffset;
             }
         }
         #endif
@@ -984,21 +1019,36 @@ static int paCallback( const void *inputBuffer, void *outputBuffer,
         else {
             // Not yet verified how these other audio APIs behave. Play safe
             // and perform timebase remapping: This also needs our special fixed
-            // PortAudio version where currentTime actually has a value:
+            // PortAudio version where currentTime actually has a value.
+            //
+            // If stream clock tracking is enabled, each callback gives us a pair of samples of the
+            // stream clock and of GetSecs time for the clock domain of the stream. Mapping currentTime
+            // via the fitted offset and drift, instead of using 'now' directly, removes the jitter of
+            // callback invocation from our timestamps. The domain is skipped if it is busy, as this
+            // realtime callback must not wait for other threads:
+            double tNow = now;
+
+            if ((dev->streamClockDomain >= 0) && (timeInfo->currentTime != 0)) {
+                PsychTryAddClockDomainSample(dev->streamClockDomain, timeInfo->currentTime, now, 0);
+                tNow = PsychTryClockDomainToRefTime(dev->streamClockDomain, timeInfo->currentTime);
+                if (isnan(tNow))
+                    tNow = now;
+            }
+
             if (dev->opmode & kPortAudioPlayBack) {
                 // Playback enabled: Use DAC time as basis for timing:
                 // Assign predicted (remapped to our time system) audio onset time for this buffer:
-                firstsampleonset = now + ((double) (timeInfo->outputBufferDacTime - timeInfo->currentTime)) + dev->latencyBias;
+                firstsampleonset = tNow + ((double) (timeInfo->outputBufferDacTime - timeInfo->currentTime)) + dev->latencyBias;
             }
             else {
                 // Recording (only): Use ADC time as basis for timing:
                 // Assign predicted (remapped to our time system) audio onset time for this buffer:
-                firstsampleonset = now + ((double) (timeInfo->inputBufferAdcTime - timeInfo->currentTime)) + dev->latencyBias;
+                firstsampleonset = tNow + ((double) (timeInfo->inputBufferAdcTime - timeInfo->currentTime)) + dev->latencyBias;
             }
 
             // Compute estimated capturetime in captureStartTime. This is only important in
             // full-duplex mode, redundant in pure half-duplex capture mode:
-            captureStartTime = now + ((double) (timeInfo->inputBufferAdcTime - timeInfo->currentTime));
+            captureStartTime = tNow + ((double) (timeInfo->inputBufferAdcTime - timeInfo->currentTime));
         }
 
         if (FALSE) {
@@ -1052,7 +1102,10 @@ static int paCallback( const void *inputBuffer, void *outputBuffer,
     if (dev->batchsize < (psych_int64) framesPerBuffer) dev->batchsize = (psych_int64) framesPerBuffer;
 
     // Keep track of buffer over-/underflows:
-    if (statusFlags & (paInputOverflow | paInputUnderflow | paOutputOverflow | paOutputUnderflow)) dev->xruns++;
+    if (statusFlags & (paInputOverflow | paInputUnderflow | paOutputOverflow | paOutputUnderflow)) {
+        dev->xruns++;
+        PsychTraceInstant("PsychPortAudio", "xrun", (double) statusFlags);
+    }
 
     // Reset number of already committed sample frames for this buffer fill iteration to zero:
     // This is a running count of how much of the current output buffer has been filled with
@@ -1677,6 +1730,24 @@ static int paCallback( const void *inputBuffer, void *outputBuffer,
     return(paContinue);
 }
 
+/* paCallback: PortAudio I/O processing callback, also called by master devices
+ * for their slaves. Wraps paProcessCallback() for tracing of its execution.
+ */
+static int paCallback( const void *inputBuffer, void *outputBuffer,
+                       unsigned long framesPerBuffer,
+                       const PaStreamCallbackTimeInfo* timeInfo,
+                       PaStreamCallbackFlags statusFlags,
+                       void *userData )
+{
+    int rc;
+
+    PsychTraceBegin("PsychPortAudio", "paCallback");
+    rc = paProcessCallback(inputBuffer, outputBuffer, framesPerBuffer, timeInfo, statusFlags, userData);
+    PsychTraceEnd("PsychPortAudio", "paCallback");
+
+    return(rc);
+}
+
 void PsychPACloseStream(int id)
 {
     int pamaster, i;
@@ -1762,6 +1833,12 @@ void PsychPACloseStream(int id)
         // Release stream reference to now dead stream:
         audiodevices[id].stream = NULL;
 
+        // Release clock domain of stream clock, if any:
+        if (audiodevices[id].streamClockDomain >= 0) {
+            PsychUnregisterClockDomain(audiodevices[id].streamClockDomain);
+            audiodevices[id].streamClockDomain = -1;
+        }
+
         // Free associated sound outputbuffer:
         if(audiodevices[id].outputbuffer) {
             free(audiodevices[id].outputbuffer);
@@ -1850,7 +1927,7 @@ const char** InitializeSynopsis(void)
     synopsis[i++] = "count = PsychPortAudio('GetOpenDeviceCount');";
     synopsis[i++] = "devices = PsychPortAudio('GetDevices' [,devicetype] [, deviceIndex]);";
     synopsis[i++] = "\nGeneral settings:\n";
-    synopsis[i++] = "[oldyieldInterval, oldMutexEnable, lockToCore1, audioserver_autosuspend] = PsychPortAudio('EngineTunables' [, yieldInterval] [, MutexEnable] [, lockToCore1] [, audioserver_autosuspend]);";
+    synopsis[i++] = "[oldyieldInterval, oldMutexEnable, lockToCore1, audioserver_autosuspend, streamclock_tracking] = PsychPortAudio('EngineTunables' [, yieldInterval] [, MutexEnable] [, lockToCore1] [, audioserver_autosuspend] [, streamclock_tracking]);";
     synopsis[i++] = "oldRunMode = PsychPortAudio('RunMode', pahandle [,runMode]);";
     synopsis[i++] = "\n\nDevice setup and shutdown:\n";
     synopsis[i++] = "pahandle = PsychPortAudio('Open' [, deviceid][, mode][, reqlatencyclass][, freq][, channels][, buffersize][, suggestedLatency][, selectchannels][, specialFlags=0]);";
@@ -1878,6 +1955,9 @@ const char** InitializeSynopsis(void)
     synopsis[i++] = "[startTime endPositionSecs xruns estStopTime] = PsychPortAudio('Stop', pahandle [,waitForEndOfPlayback=0] [, blockUntilStopped=1] [, repetitions] [, stopTime]);";
     synopsis[i++] = "PsychPortAudio('UseSchedule', pahandle, enableSchedule [, maxSize = 128]);";
     synopsis[i++] = "[success, freeslots] = PsychPortAudio('AddToSchedule', pahandle [, bufferHandle=0][, repetitions=1][, startSample=0][, endSample=max][, UnitIsSeconds=0][, specialFlags=0]);";
+    synopsis[i++] = "results = PsychPortAudio('CallbackBenchmark' [, mode=1][, channels=2][, framesPerBuffer=256][, numCalls=100000][, freq=48000][, streamClock=0]);";
+    synopsis[i++] = "domains = PsychPortAudio('ClockDomains' [, command, domainName, ...]);";
+    synopsis[i++] = "[enabled, numEvents] = PsychPortAudio('Trace' [, command, ...]);";
 
     synopsis[i++] = NULL;  //this tells PsychDisplayScreenSynopsis where to stop
     if (i > MAX_SYNOPSIS_STRINGS) {
@@ -2910,6 +2990,8 @@ PsychError PSYCHPORTAUDIOOpen(void)
     audiodevices[id].outchannels = mynrchannels[0];
     audiodevices[id].inchannels = mynrchannels[1];
     audiodevices[id].latencyBias = 0.0;
+    audiodevices[id].clockDomain = -2;
+    audiodevices[id].streamClockDomain = -1;
     audiodevices[id].schedule = NULL;
     audiodevices[id].schedule_size = 0;
     audiodevices[id].schedule_pos = 0;
@@ -2930,6 +3012,15 @@ PsychError PSYCHPORTAUDIOOpen(void)
     audiodevices[id].playposition = 0;
     audiodevices[id].totalplaycount = 0;
 
+    // Host API's whose timestamps are not verified to be in GetSecs time get a clock domain for
+    // their stream clock, to map stream time to GetSecs time in paCallback, if enabled:
+    if (streamclock_tracking && !(audiodevices[id].hostAPI == paCoreAudio || audiodevices[id].hostAPI == paDirectSound ||
+          audiodevices[id].hostAPI == paMME || audiodevices[id].hostAPI == paALSA)) {
+        char clockName[64];
+        sprintf(clockName, "PsychPortAudio %i stream clock", id);
+        audiodevices[id].streamClockDomain = PsychRegisterClockDomain(clockName, 1.0, NULL);
+    }
+
     // If this is a master, create a slave device list and init it to "empty":
     if (mode & kPortAudioIsMaster) {
         audiodevices[id].slaves = (int*) malloc(sizeof(int) * MAX_PSYCH_AUDIO_SLAVES_PER_DEVICE);
@@ -3363,6 +3454,8 @@ PsychError PSYCHPORTAUDIOOpenSlave(void)
     audiodevices[id].outchannels = mynrchannels[0];
     audiodevices[id].inchannels = mynrchannels[1];
     audiodevices[id].latencyBias = 0.0;
+    audiodevices[id].clockDomain = -1;
+    audiodevices[id].streamClockDomain = -1;
     audiodevices[id].schedule = NULL;
     audiodevices[id].schedule_size = 0;
     audiodevices[id].schedule_pos = 0;
@@ -3502,6 +3595,51 @@ PsychError PSYCHPORTAUDIOClose(void)
     return(PsychError_none);
 }
 
+// Sound data matrix types accepted from usercode:
+#define PA_USERDATATYPES (PsychArgType_double | PsychArgType_single | PsychArgType_int16)
+
+// Copy 'count' samples of usercode sound data of type 'type' from 'indata' into the float ringbuffer
+// 'outbuffer' of 'outcount' samples, starting at sample index 'outpos' with wraparound. Converts
+// to float, maps int16 range to -1 to +1 range and applies the anti-clamp gain:
+static void PsychPACopyUserSamples(float* outbuffer, psych_int64 outcount, psych_int64 outpos, const void* indata, PsychArgFormatType type, psych_int64 count)
+{
+    psych_int64 i, n;
+    float* outdata;
+
+    while (count > 0) {
+        // Copy up to the end of the ringbuffer in one go:
+        outpos = outpos % outcount;
+        n = (count < outcount - outpos) ? count : outcount - outpos;
+        outdata = outbuffer + outpos;
+
+        switch (type) {
+            case PsychArgType_double:
+                for (i = 0; i < n; i++)
+                    outdata[i] = (float) (PA_ANTICLAMPGAIN * ((const double*) indata)[i]);
+                indata = (const double*) indata + n;
+                break;
+
+            case PsychArgType_single:
+                for (i = 0; i < n; i++)
+                    outdata[i] = (float) (PA_ANTICLAMPGAIN * ((const float*) indata)[i]);
+                indata = (const float*) indata + n;
+                break;
+
+            case PsychArgType_int16:
+                for (i = 0; i < n; i++)
+                    outdata[i] = (float) (PA_ANTICLAMPGAIN / 32768.0 * ((const short*) indata)[i]);
+                indata = (const short*) indata + n;
+                break;
+
+            default:
+                PsychErrorExitMsg(PsychError_internal, "Unsupported sound data type!");
+        }
+
+        outpos += n;
+        count -= n;
+    }
+}
+
 /* PsychPortAudio('FillBuffer') - Fill audio outputbuffer of a device with data.
  */
 PsychError PSYCHPORTAUDIOFillAudioBuffer(void)
@@ -3512,13 +3650,15 @@ PsychError PSYCHPORTAUDIOFillAudioBuffer(void)
     "Fill audio data playback buffer of a PortAudio audio device. 'pahandle' is the handle of the device "
     "whose buffer is to be filled.\n"
     #if PSYCH_LANGUAGE == PSYCH_MATLAB
-    "'bufferdata' is usually a matrix with audio data in double() or single() format. "
+    "'bufferdata' is usually a matrix with audio data in double() or single() format, or int16() format. "
     "Each row of the matrix specifies one sound channel, each column one sample for each channel. "
     #else
-    "'bufferdata' is usually a NumPy 2D matrix with audio data in (ideally) float32 format, or also float64 format. "
+    "'bufferdata' is usually a NumPy 2D matrix with audio data in (ideally) float32 format, or also float64 or int16 format. "
+    "A C-contiguous float32, float64 or int16 matrix is used directly without any intermediate copy. "
     "Each column of the matrix specifies one sound channel, each row one sample for each channel. "
     #endif
-    "Only floating point values are supported. Samples need to be in range -1.0 to +1.0, with 0.0 for silence. This is "
+    "Floating point samples need to be in range -1.0 to +1.0, with 0.0 for silence. int16 samples in range -32768 to "
+    "+32767 are mapped to that range. This is "
     "intentionally a very restricted interface. For lowest latency and best timing we want you to provide audio "
     "data exactly at the optimal format and sample rate, so the driver can save computation time and latency for "
     "expensive sample rate conversion, sample format conversion, and bounds checking/clipping.\n"
@@ -3557,11 +3697,11 @@ PsychError PSYCHPORTAUDIOFillAudioBuffer(void)
     PsychPABuffer* inbuffer;
     int inbufferhandle = 0;
     float*  indatafloat = NULL;
-    psych_bool userfloat = FALSE;
+    PsychArgFormatType intype = PsychArgType_none;
     psych_int64 inchannels, insamples, p;
     size_t buffersize;
     psych_int64 totalplaycount;
-    double*    indata = NULL;
+    void*   indata = NULL;
     float*  outdata = NULL;
     int pahandle   = -1;
     int streamingrefill = 0;
@@ -3597,12 +3737,8 @@ PsychError PSYCHPORTAUDIOFillAudioBuffer(void)
         indatafloat = inbuffer->outputbuffer;
     }
     else {
-        // Regular double matrix with sound data from runtime?
-        if (!PsychAllocInDoubleMatArg64(2, kPsychArgAnything, &inchannels, &insamples, &p, &indata)) {
-            // Or regular float matrix instead?
-            PsychAllocInFloatMatArg64(2, kPsychArgRequired, &inchannels, &insamples, &p, &indatafloat);
-            userfloat = TRUE;
-        }
+        // Regular double, float or int16 matrix with sound data from runtime:
+        PsychAllocInNativeMatArg64(2, kPsychArgRequired, PA_USERDATATYPES, &inchannels, &insamples, &p, &intype, &indata);
 
         if (p != 1)
             PsychErrorExitMsg(PsychError_user, "Audio data matrix must be a 2D matrix, but this one is not a 2D matrix!");
@@ -3663,20 +3799,9 @@ PsychError PSYCHPORTAUDIOFillAudioBuffer(void)
         audiodevices[pahandle].playposition = 0;
 
         outdata = audiodevices[pahandle].outputbuffer;
-        if (indata || userfloat) {
-            if (indata) {
-                // Copy the data, convert it from double to float:
-                while(buffersize) {
-                    *(outdata++) = (float) (PA_ANTICLAMPGAIN *  *(indata++));
-                    buffersize-=sizeof(float);
-                }
-            } else {
-                // Copy the data:
-                while(buffersize) {
-                    *(outdata++) = (float) (PA_ANTICLAMPGAIN *  *(indatafloat++));
-                    buffersize-=sizeof(float);
-                }
-            }
+        if (indata) {
+            // Copy the data, convert it to float:
+            PsychPACopyUserSamples(outdata, (psych_int64) (buffersize / sizeof(float)), 0, indata, intype, (psych_int64) (buffersize / sizeof(float)));
         }
         else {
             // Data copy from internal audio buffer (already in float format and premultiplied with anti-clamp gain):
@@ -3757,32 +3882,13 @@ PsychError PSYCHPORTAUDIOFillAudioBuffer(void)
 
         // Ok, device locked and enough headroom for batch streaming refill:
 
-        // Copy the data, convert it from double to float, take ringbuffer wraparound into account:
-        if (indata || userfloat) {
-            if (indata) {
-                while(buffersize > 0) {
-                    // Fetch next sample and copy it to matrix:
-                    audiodevices[pahandle].outputbuffer[(audiodevices[pahandle].writeposition % (audiodevices[pahandle].outputbuffersize / sizeof(float)))] = (float) (PA_ANTICLAMPGAIN *  *(indata++));
-
-                    // Update sample write counter:
-                    audiodevices[pahandle].writeposition++;
-
-                    // Decrement copy counter:
-                    buffersize-=sizeof(float);
-                }
-            }
-            else {
-                while(buffersize > 0) {
-                    // Fetch next sample and copy it to matrix:
-                    audiodevices[pahandle].outputbuffer[(audiodevices[pahandle].writeposition % (audiodevices[pahandle].outputbuffersize / sizeof(float)))] = (float) (PA_ANTICLAMPGAIN *  *(indatafloat++));
-
-                    // Update sample write counter:
-                    audiodevices[pahandle].writeposition++;
+        // Copy the data, convert it to float, take ringbuffer wraparound into account:
+        if (indata) {
+            PsychPACopyUserSamples(audiodevices[pahandle].outputbuffer, audiodevices[pahandle].outputbuffersize / sizeof(float),
+                                   audiodevices[pahandle].writeposition, indata, intype, (psych_int64) (buffersize / sizeof(float)));
 
-                    // Decrement copy counter:
-                    buffersize-=sizeof(float);
-                }
-            }
+            // Update sample write counter:
+            audiodevices[pahandle].writeposition += (psych_int64) (buffersize / sizeof(float));
         }
         else {
             // Data copy from internal audio buffer (already in float format and premultiplied with anti-clamp gain):
@@ -3844,13 +3950,15 @@ PsychError PSYCHPORTAUDIORefillBuffer(void)
     "'bufferhandle' is the handle of the buffer: Use a handle of zero for the standard "
     "buffer created and accessed via 'FillBuffer'.\n"
     #if PSYCH_LANGUAGE == PSYCH_MATLAB
-    "'bufferdata' is a matrix with audio data in double() or single() format. "
+    "'bufferdata' is a matrix with audio data in double() or single() format, or int16() format. "
     "Each row of the matrix specifies one sound channel, each column one sample for each channel. "
     #else
-    "'bufferdata' is usually a NumPy 2D matrix with audio data in (ideally) float32 format, or also float64 format. "
+    "'bufferdata' is usually a NumPy 2D matrix with audio data in (ideally) float32 format, or also float64 or int16 format. "
+    "A C-contiguous float32, float64 or int16 matrix is used directly without any intermediate copy. "
     "Each column of the matrix specifies one sound channel, each row one sample for each channel. "
     #endif
-    "Only floating point values are supported. Samples need to be in range -1.0 to +1.0, with 0.0 for silence. This is "
+    "Floating point samples need to be in range -1.0 to +1.0, with 0.0 for silence. int16 samples in range -32768 to "
+    "+32767 are mapped to that range. This is "
     "intentionally a very restricted interface. For lowest latency and best timing we want you to provide audio "
     "data exactly at the optimal format and sample rate, so the driver can save computation time and latency for "
     "expensive sample rate conversion, sample format conversion, and bounds checking/clipping.\n"
@@ -3876,10 +3984,10 @@ PsychError PSYCHPORTAUDIORefillBuffer(void)
 
     psych_int64 inchannels, insamples, p;
     size_t buffersize, outbuffersize;
-    double*    indata = NULL;
+    void*   indata = NULL;
+    PsychArgFormatType intype = PsychArgType_none;
     int inbufferhandle = 0;
     float*  indatafloat = NULL;
-    psych_bool userfloat = FALSE;
     float*  outdata = NULL;
     int pahandle   = -1;
     int bufferhandle = 0;
@@ -3929,12 +4037,8 @@ PsychError PSYCHPORTAUDIORefillBuffer(void)
         indatafloat = inbuffer->outputbuffer;
     }
     else {
-        // Regular double matrix with sound data from runtime:
-        if (!PsychAllocInDoubleMatArg64(3, kPsychArgAnything, &inchannels, &insamples, &p, &indata)) {
-            // Or regular float matrix instead:
-            PsychAllocInFloatMatArg64(3, kPsychArgRequired, &inchannels, &insamples, &p, &indatafloat);
-            userfloat = TRUE;
-        }
+        // Regular double, float or int16 matrix with sound data from runtime:
+        PsychAllocInNativeMatArg64(3, kPsychArgRequired, PA_USERDATATYPES, &inchannels, &insamples, &p, &intype, &indata);
 
         if (p != 1)
             PsychErrorExitMsg(PsychError_user, "Audio data matrix must be a 2D matrix, but this one is not a 2D matrix!");
@@ -3998,21 +4102,9 @@ PsychError PSYCHPORTAUDIORefillBuffer(void)
     // Ok, everything sane, fill the buffer: 'buffersize' iterations into 'outdata':
     //fprintf(stderr, "buffersize = %i\n", buffersize);
 
-    if (indata || userfloat) {
-        if (indata) {
-            // Copy the data, convert it from double to float:
-            while(buffersize > 0) {
-                *(outdata++) = (float) (PA_ANTICLAMPGAIN *  *(indata++));
-                buffersize-=sizeof(float);
-            }
-        }
-        else {
-            // Copy the data:
-            while(buffersize > 0) {
-                *(outdata++) = (float) (PA_ANTICLAMPGAIN *  *(indatafloat++));
-                buffersize-=sizeof(float);
-            }
-        }
+    if (indata) {
+        // Copy the data, convert it to float:
+        PsychPACopyUserSamples(outdata, (psych_int64) (buffersize / sizeof(float)), 0, indata, intype, (psych_int64) (buffersize / sizeof(float)));
     }
     else {
         // Data copy from internal audio buffer (already in float format and premultiplied with anti-clamp gain):
@@ -4104,13 +4196,15 @@ PsychError PSYCHPORTAUDIOCreateBuffer(void)
     "Return a 'bufferhandle' to the new buffer. 'pahandle' is the optional handle of the device "
     "whose buffer is to be filled.\n"
     #if PSYCH_LANGUAGE == PSYCH_MATLAB
-    "'bufferdata' is a matrix with audio data in double() or single() format. "
+    "'bufferdata' is a matrix with audio data in double() or single() format, or int16() format. "
     "Each row of the matrix specifies one sound channel, each column one sample for each channel. "
     #else
-    "'bufferdata' is usually a NumPy 2D matrix with audio data in (ideally) float32 format, or also float64 format. "
+    "'bufferdata' is usually a NumPy 2D matrix with audio data in (ideally) float32 format, or also float64 or int16 format. "
+    "A C-contiguous float32, float64 or int16 matrix is used directly without any intermediate copy. "
     "Each column of the matrix specifies one sound channel, each row one sample for each channel. "
     #endif
-    "Only floating point values are supported. Samples need to be in range -1.0 to +1.0, with 0.0 for silence. This is "
+    "Floating point samples need to be in range -1.0 to +1.0, with 0.0 for silence. int16 samples in range -32768 to "
+    "+32767 are mapped to that range. This is "
     "intentionally a very restricted interface. For lowest latency and best timing we want you to provide audio "
     "data exactly at the optimal format and sample rate, so the driver can save computation time and latency for "
     "expensive sample rate conversion, sample format conversion, and bounds checking/clipping.\n\n"
@@ -4126,8 +4220,8 @@ PsychError PSYCHPORTAUDIOCreateBuffer(void)
     PsychPABuffer* buffer;
     psych_int64 inchannels, insamples, p;
     size_t buffersize;
-    double*    indata = NULL;
-    float* indatafloat = NULL;
+    void*   indata = NULL;
+    PsychArgFormatType intype = PsychArgType_none;
     float*  outdata = NULL;
     int pahandle   = -1;
     int bufferhandle = 0;
@@ -4144,11 +4238,8 @@ PsychError PSYCHPORTAUDIOCreateBuffer(void)
     // Make sure PortAudio is online:
     PsychPortAudioInitialize();
 
-    // Get data matrix with initial buffer content:
-    if (!PsychAllocInDoubleMatArg64(2, kPsychArgAnything, &inchannels, &insamples, &p, &indata)) {
-        // Or regular float matrix instead:
-        PsychAllocInFloatMatArg64(2, kPsychArgRequired, &inchannels, &insamples, &p, &indatafloat);
-    }
+    // Get double, float or int16 data matrix with initial buffer content:
+    PsychAllocInNativeMatArg64(2, kPsychArgRequired, PA_USERDATATYPES, &inchannels, &insamples, &p, &intype, &indata);
 
     if (p != 1)
         PsychErrorExitMsg(PsychError_user, "Audio data matrix must be a 2D matrix, but this one is not a 2D matrix!");
@@ -4188,19 +4279,8 @@ PsychError PSYCHPORTAUDIOCreateBuffer(void)
     outdata = buffer->outputbuffer;
     buffersize = sizeof(float) * (size_t) inchannels * (size_t) insamples;
 
-    if (indata) {
-        // Copy the data, convert it from double to float:
-        while(buffersize > 0) {
-            *(outdata++) = (float) (PA_ANTICLAMPGAIN *  *(indata++));
-            buffersize-=sizeof(float);
-        }
-    } else {
-        // Copy the float data:
-        while(buffersize > 0) {
-            *(outdata++) = (float) (PA_ANTICLAMPGAIN *  *(indatafloat++));
-            buffersize-=sizeof(float);
-        }
-    }
+    // Copy the data, convert it to float:
+    PsychPACopyUserSamples(outdata, (psych_int64) (buffersize / sizeof(float)), 0, indata, intype, (psych_int64) (buffersize / sizeof(float)));
 
     // Return bufferhandle:
     PsychCopyOutDoubleArg(1, FALSE, (double) bufferhandle);
@@ -4396,7 +4476,9 @@ PsychError PSYCHPORTAUDIOGetAudioData(void)
             minSecs = (minSamples - (double) insamples) / ((double) audiodevices[pahandle].inchannels) / ((double) audiodevices[pahandle].streaminfo->sampleRate);
             // Ok, required data will be available earliest in 'minSecs' seconds. Sleep until then with lock dropped:
             PsychPAUnlockDeviceMutex(&audiodevices[pahandle]);
+            PsychBeginBlockingRegion();
             PsychWaitIntervalSeconds(minSecs);
+            PsychEndBlockingRegion();
             PsychPALockDeviceMutex(&audiodevices[pahandle]);
 
             // We've slept at least the estimated amount of required time. Recalculate amount
@@ -4675,6 +4757,7 @@ PsychError PSYCHPORTAUDIORescheduleStart(void)
         // Wait for real start of device: We enter the first while() loop iteration with
         // the device lock still held from above, so the while() loop will iterate at
         // least once...
+        PsychBeginBlockingRegion();
         while (audiodevices[pahandle].state == 1 && Pa_IsStreamActive(audiodevices[pahandle].stream)) {
             // Wait for a state-change before reevaluating the .state:
             PsychPAWaitForChange(&audiodevices[pahandle]);
@@ -4690,6 +4773,7 @@ PsychError PSYCHPORTAUDIORescheduleStart(void)
         // We now have an estimate of real sound onset in startTime, wait until
         // then:
         PsychWaitUntilSeconds(audiodevices[pahandle].startTime);
+        PsychEndBlockingRegion();
 
         // Engine should run now. Return real onset time:
         PsychCopyOutDoubleArg(1, kPsychArgOptional, audiodevices[pahandle].startTime);
@@ -4853,6 +4937,9 @@ PsychError PSYCHPORTAUDIOStartAudioDevice(void)
             // Safeguard: If the stream is not stopped, do it now:
             if (!Pa_IsStreamStopped(audiodevices[pahandle].stream)) Pa_StopStream(audiodevices[pahandle].stream);
 
+            // Stream clock may restart from zero with the stream, so discard its old mapping:
+            PsychResetClockDomain(audiodevices[pahandle].streamClockDomain);
+
             // Start engine:
             if ((err=Pa_StartStream(audiodevices[pahandle].stream))!=paNoError) {
                 printf("PTB-ERROR: Failed to start audio device %i. PortAudio reports this error: %s \n", pahandle, Pa_GetErrorText(err));
@@ -4884,6 +4971,7 @@ PsychError PSYCHPORTAUDIOStartAudioDevice(void)
         // We need to enter the first while() loop iteration with
         // the device lock held from above, so the while() loop will iterate at
         // least once...
+        PsychBeginBlockingRegion();
         while (audiodevices[pahandle].state == 1 && Pa_IsStreamActive(audiodevices[pahandle].stream)) {
             // Wait for a state-change before reevaluating the .state:
             PsychPAWaitForChange(&audiodevices[pahandle]);
@@ -4899,6 +4987,7 @@ PsychError PSYCHPORTAUDIOStartAudioDevice(void)
         // We now have an estimate of real sound onset in startTime, wait until
         // then:
         PsychWaitUntilSeconds(audiodevices[pahandle].startTime);
+        PsychEndBlockingRegion();
 
         // Engine should run now. Return real onset time:
         PsychCopyOutDoubleArg(1, kPsychArgOptional, audiodevices[pahandle].startTime);
@@ -5129,7 +5218,9 @@ PsychError PSYCHPORTAUDIOStopAudioDevice(void)
         PsychCopyOutDoubleArg(4, kPsychArgOptional, audiodevices[pahandle].estStopTime);
 
         // We now have an estimate of real sound offset in estStopTime, wait until then:
+        PsychBeginBlockingRegion();
         PsychWaitUntilSeconds(audiodevices[pahandle].estStopTime);
+        PsychEndBlockingRegion();
     }
     else {
         // No block until stopped. That means we won't have meaningful return arguments available.
@@ -5208,13 +5299,20 @@ PsychError PSYCHPORTAUDIOGetStatus(void)
     "The difference between RecordedSecs and ReadSecs is the amount of recorded sound data pending for retrieval. ";
 
     static char seeAlsoString[] = "Open GetDeviceSettings ";
-    PsychGenericScriptType     *status;
+    PsychStructBuilder status;
     double currentTime;
     psych_int64 playposition, totalplaycount, recposition;
 
-    const char *FieldNames[]={    "Active", "State", "RequestedStartTime", "StartTime", "CaptureStartTime", "RequestedStopTime", "EstimatedStopTime", "CurrentStreamTime", "ElapsedOutSamples", "PositionSecs", "RecordedSecs", "ReadSecs", "SchedulePosition",
+    static const char *FieldNames[]={    "Active", "State", "RequestedStartTime", "StartTime", "CaptureStartTime", "RequestedStopTime", "EstimatedStopTime", "CurrentStreamTime", "ElapsedOutSamples", "PositionSecs", "RecordedSecs", "ReadSecs", "SchedulePosition",
         "XRuns", "TotalCalls", "TimeFailed", "BufferSize", "CPULoad", "PredictedLatency", "LatencyBias", "SampleRate",
         "OutDeviceIndex", "InDeviceIndex" };
+
+    // Indices of the fields in FieldNames:
+    enum { kFieldActive, kFieldState, kFieldRequestedStartTime, kFieldStartTime, kFieldCaptureStartTime,
+           kFieldRequestedStopTime, kFieldEstimatedStopTime, kFieldCurrentStreamTime, kFieldElapsedOutSamples,
+           kFieldPositionSecs, kFieldRecordedSecs, kFieldReadSecs, kFieldSchedulePosition, kFieldXRuns,
+           kFieldTotalCalls, kFieldTimeFailed, kFieldBufferSize, kFieldCPULoad, kFieldPredictedLatency,
+           kFieldLatencyBias, kFieldSampleRate, kFieldOutDeviceIndex, kFieldInDeviceIndex, kNumFields };
     int pahandle = -1;
 
     // Setup online help:
@@ -5231,7 +5329,7 @@ PsychError PSYCHPORTAUDIOGetStatus(void)
     PsychCopyInIntegerArg(1, kPsychArgRequired, &pahandle);
     if (pahandle < 0 || pahandle>=MAX_PSYCH_AUDIO_DEVS || audiodevices[pahandle].stream == NULL) PsychErrorExitMsg(PsychError_user, "Invalid audio device handle provided.");
 
-    PsychAllocOutStructArray(1, kPsychArgOptional, -1, 23, FieldNames, &status);
+    PsychAllocOutStructBuilder(1, kPsychArgOptional, -1, kNumFields, FieldNames, &status);
 
     // Ok, in a perfect world we should hold the device mutex while querying all the device state.
     // However, we don't: This reduces lock contention at the price of a small chance that the
@@ -5247,29 +5345,29 @@ PsychError PSYCHPORTAUDIOGetStatus(void)
     PsychPAUnlockDeviceMutex(&audiodevices[pahandle]);
 
     // Atomic snapshot for remaining fields would only be needed for low-level debugging, so who cares?
-    PsychSetStructArrayDoubleElement("Active", 0, (audiodevices[pahandle].state >= 2) ? 1 : 0, status);
-    PsychSetStructArrayDoubleElement("State", 0, audiodevices[pahandle].state, status);
-    PsychSetStructArrayDoubleElement("RequestedStartTime", 0, audiodevices[pahandle].reqStartTime, status);
-    PsychSetStructArrayDoubleElement("StartTime", 0, audiodevices[pahandle].startTime, status);
-    PsychSetStructArrayDoubleElement("CaptureStartTime", 0, audiodevices[pahandle].captureStartTime, status);
-    PsychSetStructArrayDoubleElement("RequestedStopTime", 0, audiodevices[pahandle].reqStopTime, status);
-    PsychSetStructArrayDoubleElement("EstimatedStopTime", 0, audiodevices[pahandle].estStopTime, status);
-    PsychSetStructArrayDoubleElement("CurrentStreamTime", 0, currentTime, status);
-    PsychSetStructArrayDoubleElement("ElapsedOutSamples", 0, ((double)(totalplaycount / audiodevices[pahandle].outchannels)), status);
-    PsychSetStructArrayDoubleElement("PositionSecs", 0, ((double)(playposition / audiodevices[pahandle].outchannels)) / (double) audiodevices[pahandle].streaminfo->sampleRate, status);
-    PsychSetStructArrayDoubleElement("RecordedSecs", 0, ((double)(recposition / audiodevices[pahandle].inchannels)) / (double) audiodevices[pahandle].streaminfo->sampleRate, status);
-    PsychSetStructArrayDoubleElement("ReadSecs", 0, ((double)(audiodevices[pahandle].readposition / audiodevices[pahandle].inchannels)) / (double) audiodevices[pahandle].streaminfo->sampleRate, status);
-    PsychSetStructArrayDoubleElement("SchedulePosition", 0, audiodevices[pahandle].schedule_pos, status);
-    PsychSetStructArrayDoubleElement("XRuns", 0, audiodevices[pahandle].xruns, status);
-    PsychSetStructArrayDoubleElement("TotalCalls", 0, audiodevices[pahandle].paCalls, status);
-    PsychSetStructArrayDoubleElement("TimeFailed", 0, audiodevices[pahandle].noTime, status);
-    PsychSetStructArrayDoubleElement("BufferSize", 0, (double) audiodevices[pahandle].batchsize, status);
-    PsychSetStructArrayDoubleElement("CPULoad", 0, (Pa_IsStreamActive(audiodevices[pahandle].stream)) ? Pa_GetStreamCpuLoad(audiodevices[pahandle].stream) : 0.0, status);
-    PsychSetStructArrayDoubleElement("PredictedLatency", 0, audiodevices[pahandle].predictedLatency, status);
-    PsychSetStructArrayDoubleElement("LatencyBias", 0, audiodevices[pahandle].latencyBias, status);
-    PsychSetStructArrayDoubleElement("SampleRate", 0, audiodevices[pahandle].streaminfo->sampleRate, status);
-    PsychSetStructArrayDoubleElement("OutDeviceIndex", 0, audiodevices[pahandle].outdeviceidx, status);
-    PsychSetStructArrayDoubleElement("InDeviceIndex", 0, audiodevices[pahandle].indeviceidx, status);
+    PsychSetStructBuilderDoubleElement(&status, kFieldActive, 0, (audiodevices[pahandle].state >= 2) ? 1 : 0);
+    PsychSetStructBuilderDoubleElement(&status, kFieldState, 0, audiodevices[pahandle].state);
+    PsychSetStructBuilderDoubleElement(&status, kFieldRequestedStartTime, 0, audiodevices[pahandle].reqStartTime);
+    PsychSetStructBuilderDoubleElement(&status, kFieldStartTime, 0, audiodevices[pahandle].startTime);
+    PsychSetStructBuilderDoubleElement(&status, kFieldCaptureStartTime, 0, audiodevices[pahandle].captureStartTime);
+    PsychSetStructBuilderDoubleElement(&status, kFieldRequestedStopTime, 0, audiodevices[pahandle].reqStopTime);
+    PsychSetStructBuilderDoubleElement(&status, kFieldEstimatedStopTime, 0, audiodevices[pahandle].estStopTime);
+    PsychSetStructBuilderDoubleElement(&status, kFieldCurrentStreamTime, 0, currentTime);
+    PsychSetStructBuilderDoubleElement(&status, kFieldElapsedOutSamples, 0, ((double)(totalplaycount / audiodevices[pahandle].outchannels)));
+    PsychSetStructBuilderDoubleElement(&status, kFieldPositionSecs, 0, ((double)(playposition / audiodevices[pahandle].outchannels)) / (double) audiodevices[pahandle].streaminfo->sampleRate);
+    PsychSetStructBuilderDoubleElement(&status, kFieldRecordedSecs, 0, ((double)(recposition / audiodevices[pahandle].inchannels)) / (double) audiodevices[pahandle].streaminfo->sampleRate);
+    PsychSetStructBuilderDoubleElement(&status, kFieldReadSecs, 0, ((double)(audiodevices[pahandle].readposition / audiodevices[pahandle].inchannels)) / (double) audiodevices[pahandle].streaminfo->sampleRate);
+    PsychSetStructBuilderDoubleElement(&status, kFieldSchedulePosition, 0, audiodevices[pahandle].schedule_pos);
+    PsychSetStructBuilderDoubleElement(&status, kFieldXRuns, 0, audiodevices[pahandle].xruns);
+    PsychSetStructBuilderDoubleElement(&status, kFieldTotalCalls, 0, audiodevices[pahandle].paCalls);
+    PsychSetStructBuilderDoubleElement(&status, kFieldTimeFailed, 0, audiodevices[pahandle].noTime);
+    PsychSetStructBuilderDoubleElement(&status, kFieldBufferSize, 0, (double) audiodevices[pahandle].batchsize);
+    PsychSetStructBuilderDoubleElement(&status, kFieldCPULoad, 0, (Pa_IsStreamActive(audiodevices[pahandle].stream)) ? Pa_GetStreamCpuLoad(audiodevices[pahandle].stream) : 0.0);
+    PsychSetStructBuilderDoubleElement(&status, kFieldPredictedLatency, 0, audiodevices[pahandle].predictedLatency);
+    PsychSetStructBuilderDoubleElement(&status, kFieldLatencyBias, 0, audiodevices[pahandle].latencyBias);
+    PsychSetStructBuilderDoubleElement(&status, kFieldSampleRate, 0, audiodevices[pahandle].streaminfo->sampleRate);
+    PsychSetStructBuilderDoubleElement(&status, kFieldOutDeviceIndex, 0, audiodevices[pahandle].outdeviceidx);
+    PsychSetStructBuilderDoubleElement(&status, kFieldInDeviceIndex, 0, audiodevices[pahandle].indeviceidx);
     return(PsychError_none);
 }
 
@@ -5537,9 +5635,14 @@ PsychError PSYCHPORTAUDIOGetDevices(void)
     "\n";
 
     static char seeAlsoString[] = "Open GetDeviceSettings ";
-    PsychGenericScriptType     *devices;
-    const char *FieldNames[]= { "DeviceIndex", "HostAudioAPIId", "HostAudioAPIName", "DeviceName", "NrInputChannels", "NrOutputChannels",
+    PsychStructBuilder devices;
+    static const char *FieldNames[]= { "DeviceIndex", "HostAudioAPIId", "HostAudioAPIName", "DeviceName", "NrInputChannels", "NrOutputChannels",
                                 "LowInputLatency", "HighInputLatency", "LowOutputLatency", "HighOutputLatency",  "DefaultSampleRate", "xxx" };
+
+    // Indices of the fields in FieldNames, the unused last field "xxx" excluded:
+    enum { kFieldDeviceIndex, kFieldHostAudioAPIId, kFieldHostAudioAPIName, kFieldDeviceName, kFieldNrInputChannels,
+           kFieldNrOutputChannels, kFieldLowInputLatency, kFieldHighInputLatency, kFieldLowOutputLatency,
+           kFieldHighOutputLatency, kFieldDefaultSampleRate, kNumFields };
     int devicetype = -1;
     int deviceindex = -1;
     int count = 0;
@@ -5585,7 +5688,7 @@ PsychError PSYCHPORTAUDIOGetDevices(void)
         if (deviceindex >= 0) filteredcount = 1;
 
         // Alloc output struct array:
-        PsychAllocOutStructArray(1, kPsychArgOptional, filteredcount, 11, FieldNames, &devices);
+        PsychAllocOutStructBuilder(1, kPsychArgOptional, filteredcount, kNumFields, FieldNames, &devices);
     }
     else {
         PsychErrorExitMsg(PsychError_user, "PTB-ERROR: PortAudio can't detect any supported sound device on this system.");
@@ -5604,18 +5707,18 @@ PsychError PSYCHPORTAUDIOGetDevices(void)
             // Return info if devicetype doesn't matter or if it matches the required one:
             if ((devicetype==-1) || (hainfo->type == devicetype)) {
                 // Fill slot ic of struct array with info of deviceindex i:
-                PsychSetStructArrayDoubleElement("DeviceIndex", ic, i, devices);
-                PsychSetStructArrayDoubleElement("HostAudioAPIId", ic, hainfo->type, devices);
-                PsychSetStructArrayStringElement("HostAudioAPIName", ic, (char*) (hainfo->name), devices);
-                PsychSetStructArrayStringElement("DeviceName", ic, (char*) (padev->name), devices);
-                PsychSetStructArrayDoubleElement("NrInputChannels", ic, padev->maxInputChannels, devices);
-                PsychSetStructArrayDoubleElement("NrOutputChannels", ic, padev->maxOutputChannels, devices);
-                PsychSetStructArrayDoubleElement("LowInputLatency", ic, padev->defaultLowInputLatency, devices);
-                PsychSetStructArrayDoubleElement("HighInputLatency", ic, padev->defaultHighInputLatency, devices);
-                PsychSetStructArrayDoubleElement("LowOutputLatency", ic, padev->defaultLowOutputLatency, devices);
-                PsychSetStructArrayDoubleElement("HighOutputLatency", ic, padev->defaultHighOutputLatency, devices);
-                PsychSetStructArrayDoubleElement("DefaultSampleRate", ic, padev->defaultSampleRate, devices);
-                // PsychSetStructArrayDoubleElement("xxx", ic, 0, devices);
+                PsychSetStructBuilderDoubleElement(&devices, kFieldDeviceIndex, ic, i);
+                PsychSetStructBuilderDoubleElement(&devices, kFieldHostAudioAPIId, ic, hainfo->type);
+                PsychSetStructBuilderStringElement(&devices, kFieldHostAudioAPIName, ic, (char*) (hainfo->name));
+                PsychSetStructBuilderStringElement(&devices, kFieldDeviceName, ic, (char*) (padev->name));
+                PsychSetStructBuilderDoubleElement(&devices, kFieldNrInputChannels, ic, padev->maxInputChannels);
+                PsychSetStructBuilderDoubleElement(&devices, kFieldNrOutputChannels, ic, padev->maxOutputChannels);
+                PsychSetStructBuilderDoubleElement(&devices, kFieldLowInputLatency, ic, padev->defaultLowInputLatency);
+                PsychSetStructBuilderDoubleElement(&devices, kFieldHighInputLatency, ic, padev->defaultHighInputLatency);
+                PsychSetStructBuilderDoubleElement(&devices, kFieldLowOutputLatency, ic, padev->defaultLowOutputLatency);
+                PsychSetStructBuilderDoubleElement(&devices, kFieldHighOutputLatency, ic, padev->defaultHighOutputLatency);
+                PsychSetStructBuilderDoubleElement(&devices, kFieldDefaultSampleRate, ic, padev->defaultSampleRate);
+                // PsychSetStructBuilderDoubleElement(&devices, 11, ic, 0);
                 ic++;
             }
         }
@@ -5768,7 +5871,7 @@ PsychError PSYCHPORTAUDIOSetLoop(void)
  */
 PsychError PSYCHPORTAUDIOEngineTunables(void)
 {
-    static char useString[] = "[oldyieldInterval, oldMutexEnable, lockToCore1, audioserver_autosuspend] = PsychPortAudio('EngineTunables' [, yieldInterval] [, MutexEnable] [, lockToCore1] [, audioserver_autosuspend]);";
+    static char useString[] = "[oldyieldInterval, oldMutexEnable, lockToCore1, audioserver_autosuspend, streamclock_tracking] = PsychPortAudio('EngineTunables' [, yieldInterval] [, MutexEnable] [, lockToCore1] [, audioserver_autosuspend] [, streamclock_tracking]);";
     static char synopsisString[] =
     "Return, and optionally set low-level tuneable driver parameters.\n"
     "The driver must be idle, ie., no audio device must be open, if you want to change tuneables! "
@@ -5797,20 +5900,26 @@ PsychError PSYCHPORTAUDIOEngineTunables(void)
     "can interfere with low level audio device access and low-latency / high-precision audio timing. "
     "For this reason it is a good idea to switch them to standby (suspend) while a PsychPortAudio "
     "session is active. Sometimes this isn't needed or not even desireable. Therefore this option "
-    "allows to inhibit this automatic suspending of audio servers.\n";
+    "allows to inhibit this automatic suspending of audio servers.\n"
+    "'streamclock_tracking' - Enable (1) or Disable (0) tracking of the stream clock for audio host API's whose "
+    "timestamps are not verified to be in GetSecs time, e.g., WASAPI, ASIO or JACK. If enabled, the stream clock "
+    "of each device gets its own clock domain, see PsychPortAudio('ClockDomains'), whose offset and drift to GetSecs "
+    "time are fitted from the timestamps of all audio callbacks, so jitter of the callback invocation doesn't affect "
+    "onset timestamps. Default is (0) - use the time of invocation of each callback, as this is not yet verified "
+    "with all of these host API's. The setting applies to devices opened after the change.\n";
 
     static char seeAlsoString[] = "Open ";
 
-    int mutexenable, mylockToCore1, mysuspend;
+    int mutexenable, mylockToCore1, mysuspend, mytracking;
     double myyieldInterval;
 
     // Setup online help:
     PsychPushHelp(useString, synopsisString, seeAlsoString);
     if(PsychIsGiveHelp()) {PsychGiveHelp(); return(PsychError_none); };
 
-    PsychErrorExit(PsychCapNumInputArgs(4));     // The maximum number of inputs
+    PsychErrorExit(PsychCapNumInputArgs(5));     // The maximum number of inputs
     PsychErrorExit(PsychRequireNumInputArgs(0)); // The required number of inputs
-    PsychErrorExit(PsychCapNumOutputArgs(4));    // The maximum number of outputs
+    PsychErrorExit(PsychCapNumOutputArgs(5));    // The maximum number of outputs
 
     // Make sure no settings are changed while an audio device is open:
     if ((PsychGetNumInputArgs() > 0) && (audiodevicecount > 0)) PsychErrorExitMsg(PsychError_user, "Tried to change low-level engine parameter while at least one audio device is open! Forbidden!");
@@ -5858,6 +5967,16 @@ PsychError PSYCHPORTAUDIOEngineTunables(void)
         if (verbosity > 3) printf("PsychPortAudio: INFO: Locking of all engine threads to cpu core 1 %s.\n", (lockToCore1) ? "enabled" : "disabled");
     }
 
+    // Return current/old streamclock_tracking:
+    PsychCopyOutDoubleArg(5, kPsychArgOptional, (double) ((streamclock_tracking) ? 1 : 0));
+
+    // Get optional new streamclock_tracking:
+    if (PsychCopyInIntegerArg(5, kPsychArgOptional, &mytracking)) {
+        if (mytracking < 0 || mytracking > 1) PsychErrorExitMsg(PsychError_user, "Invalid setting for 'streamclock_tracking' provided. Valid are 0 and 1.");
+        streamclock_tracking = (mytracking > 0) ? TRUE : FALSE;
+        if (verbosity > 3) printf("PsychPortAudio: INFO: Stream clock tracking for unverified host API's %s.\n", (streamclock_tracking) ? "enabled" : "disabled");
+    }
+
     return(PsychError_none);
 }
 
@@ -6450,3 +6569,184 @@ PsychError PSYCHPORTAUDIODirectInputMonitoring(void)
 
     return(PsychError_none);
 }
+
+// qsort() comparator for PSYCHPORTAUDIOCallbackBenchmark():
+static int PsychPACompareDurations(const void* a, const void* b)
+{
+    double da = *((const double*) a);
+    double db = *((const double*) b);
+
+    return((da < db) ? -1 : ((da > db) ? 1 : 0));
+}
+
+/* PsychPortAudio('CallbackBenchmark') - Measure execution time of the audio callback.
+ */
+PsychError PSYCHPORTAUDIOCallbackBenchmark(void)
+{
+    static char useString[] = "results = PsychPortAudio('CallbackBenchmark' [, mode=1][, channels=2][, framesPerBuffer=256][, numCalls=100000][, freq=48000][, streamClock=0]);";
+    static char synopsisString[] =
+        "Measure the execution time of the audio processing callback of PsychPortAudio.\n"
+        "Drives the callback with synthetic buffers and timestamps for a simulated standalone audio device, "
+        "which plays back an endless loop of sound and/or captures sound. No PortAudio stream or sound "
+        "hardware is used, so this also works on headless machines, and is useful for tracking the cost "
+        "of the callback across releases.\n"
+        "'mode' Mode of operation of the simulated device, as for PsychPortAudio('Open'): 1 = Playback, "
+        "2 = Capture, 3 = Full-duplex, 7 = Full-duplex with live monitoring.\n"
+        "'channels' Number of output and input channels.\n"
+        "'framesPerBuffer' Number of sample frames per callback invocation.\n"
+        "'numCalls' Number of callback invocations to measure.\n"
+        "'freq' Simulated sampling rate in Hz.\n"
+        "'streamClock' If 0, simulate a host API which provides timestamps in GetSecs time. If 1, simulate "
+        "one which provides timestamps in a separate stream clock, so each callback also updates and "
+        "applies the clock domain mapping of that clock.\n"
+        "Returns a struct 'results' with the number of calls, the nominal duration of one buffer, and the "
+        "mean, minimum, median, 99th percentile and maximum execution time of the callback in seconds. "
+        "'load' is the mean execution time in units of the buffer duration.\n";
+    static char seeAlsoString[] = "Open GetStatus";
+
+    static const char *FieldNames[] = { "numCalls", "bufferDuration", "meanDuration", "minDuration", "medianDuration", "p99Duration", "maxDuration", "load" };
+    enum { kFieldNumCalls, kFieldBufferDuration, kFieldMeanDuration, kFieldMinDuration, kFieldMedianDuration,
+           kFieldP99Duration, kFieldMaxDuration, kFieldLoad, kNumFields };
+    PsychStructBuilder results;
+    PsychPADevice dev;
+    PaStreamInfo streaminfo;
+    PaStreamCallbackTimeInfo timeInfo;
+    float *inBuffer, *outBuffer;
+    double *durations;
+    double freq, tstart, tend, t0, tsum, bufferDuration;
+    int mode, channels, framesPerBuffer, numCalls, streamClock, i, rc;
+
+    // Setup online help:
+    PsychPushHelp(useString, synopsisString, seeAlsoString);
+    if (PsychIsGiveHelp()) { PsychGiveHelp(); return(PsychError_none); };
+
+    PsychErrorExit(PsychCapNumInputArgs(6));     // The maximum number of inputs
+    PsychErrorExit(PsychCapNumOutputArgs(1));    // The maximum number of outputs
+
+    mode = kPortAudioPlayBack;
+    PsychCopyInIntegerArg(1, kPsychArgOptional, &mode);
+    if ((mode != kPortAudioPlayBack) && (mode != kPortAudioCapture) && (mode != kPortAudioFullDuplex) && (mode != (kPortAudioFullDuplex | kPortAudioMonitoring)))
+        PsychErrorExitMsg(PsychError_user, "Invalid 'mode' specified. Must be 1, 2, 3 or 7.");
+
+    channels = 2;
+    PsychCopyInIntegerArg(2, kPsychArgOptional, &channels);
+    if ((channels < 1) || (channels > 256)) PsychErrorExitMsg(PsychError_user, "Invalid 'channels' specified. Must be between 1 and 256.");
+
+    framesPerBuffer = 256;
+    PsychCopyInIntegerArg(3, kPsychArgOptional, &framesPerBuffer);
+    if ((framesPerBuffer < 1) || (framesPerBuffer > 65536)) PsychErrorExitMsg(PsychError_user, "Invalid 'framesPerBuffer' specified. Must be between 1 and 65536.");
+
+    numCalls = 100000;
+    PsychCopyInIntegerArg(4, kPsychArgOptional, &numCalls);
+    if (numCalls < 1) PsychErrorExitMsg(PsychError_user, "Invalid 'numCalls' specified. Must be at least 1.");
+
+    freq = 48000;
+    PsychCopyInDoubleArg(5, kPsychArgOptional, &freq);
+    if ((freq < 1000) || (freq > 1000000)) PsychErrorExitMsg(PsychError_user, "Invalid 'freq' specified. Must be between 1000 and 1000000 Hz.");
+
+    streamClock = 0;
+    PsychCopyInIntegerArg(6, kPsychArgOptional, &streamClock);
+    if ((streamClock < 0) || (streamClock > 1)) PsychErrorExitMsg(PsychError_user, "Invalid 'streamClock' specified. Must be 0 or 1.");
+
+    bufferDuration = (double) framesPerBuffer / freq;
+
+    // Host buffers, a one second sound loop for playback and a ten second ringbuffer for capture:
+    inBuffer = (float*) PsychMallocTemp(sizeof(float) * (size_t) framesPerBuffer * (size_t) channels);
+    outBuffer = (float*) PsychMallocTemp(sizeof(float) * (size_t) framesPerBuffer * (size_t) channels);
+    durations = (double*) PsychMallocTemp(sizeof(double) * (size_t) numCalls);
+    for (i = 0; i < framesPerBuffer * channels; i++)
+        inBuffer[i] = (float) (i % 128) / 128.0f;
+
+    // Simulated device, as setup by 'Open', 'FillBuffer' and 'Start' in runMode 1, with playback looping forever:
+    memset(&streaminfo, 0, sizeof(streaminfo));
+    streaminfo.structVersion = 1;
+    streaminfo.sampleRate = freq;
+    streaminfo.inputLatency = streaminfo.outputLatency = 0.005;
+
+    memset(&dev, 0, sizeof(dev));
+    dev.opmode = mode;
+    dev.runMode = 1;
+    dev.streaminfo = &streaminfo;
+    dev.hostAPI = (streamClock) ? paJACK : paCoreAudio;
+    dev.indeviceidx = (mode & kPortAudioCapture) ? 0 : -1;
+    dev.outdeviceidx = (mode & kPortAudioPlayBack) ? 0 : -1;
+    dev.reqStopTime = DBL_MAX;
+    dev.state = 2;
+    dev.reqstate = 255;
+    dev.repeatCount = -1;
+    dev.outchannels = channels;
+    dev.inchannels = channels;
+    dev.pamaster = -1;
+    dev.modulatorSlave = -1;
+    dev.clockDomain = -2;
+    dev.streamClockDomain = -1;
+    dev.masterVolume = 1.0;
+
+    if (mode & kPortAudioPlayBack) {
+        dev.outputbuffersize = sizeof(float) * (psych_int64) freq * channels;
+        dev.outputbuffer = (float*) PsychMallocTemp((size_t) dev.outputbuffersize);
+        for (i = 0; i < dev.outputbuffersize / (psych_int64) sizeof(float); i++)
+            dev.outputbuffer[i] = (float) (i % 256) / 256.0f;
+        dev.loopEndFrame = (psych_int64) freq - 1;
+    }
+
+    if (mode & kPortAudioCapture) {
+        dev.inputbuffersize = sizeof(float) * (psych_int64) (10 * freq) * channels;
+        dev.inputbuffer = (float*) PsychMallocTemp((size_t) dev.inputbuffersize);
+    }
+
+    if (uselocking && PsychInitMutex(&(dev.mutex))) {
+        PsychErrorExitMsg(PsychError_system, "Failed to create mutex lock for simulated audio device.");
+    }
+    PsychPACreateSignal(&dev);
+
+    if (streamClock) {
+        dev.streamClockDomain = PsychRegisterClockDomain("PsychPortAudio benchmark stream clock", 1.0, NULL);
+        if (dev.streamClockDomain < 0 && verbosity > 1)
+            printf("PTB-WARNING: PsychPortAudio('CallbackBenchmark'): Could not register clock domain for stream clock.\n");
+    }
+
+    // Timestamps are derived from the real time of each invocation, so they are as consistent as with real
+    // hardware. A stream clock starts at zero at start of the benchmark:
+    PsychGetAdjustedPrecisionTimerSeconds(&t0);
+    if (!streamClock) t0 = 0;
+
+    rc = paContinue;
+    tsum = 0;
+    for (i = 0; (i < numCalls) && (rc == paContinue); i++) {
+        PsychGetAdjustedPrecisionTimerSeconds(&tstart);
+        timeInfo.currentTime = tstart - t0;
+        timeInfo.outputBufferDacTime = timeInfo.currentTime + streaminfo.outputLatency;
+        timeInfo.inputBufferAdcTime = timeInfo.currentTime - streaminfo.inputLatency;
+
+        rc = paCallback((mode & kPortAudioCapture) ? inBuffer : NULL, (mode & kPortAudioPlayBack) ? outBuffer : NULL,
+                        (unsigned long) framesPerBuffer, &timeInfo, 0, &dev);
+
+        PsychGetAdjustedPrecisionTimerSeconds(&tend);
+        durations[i] = tend - tstart;
+        tsum += durations[i];
+    }
+
+    if (dev.streamClockDomain >= 0)
+        PsychUnregisterClockDomain(dev.streamClockDomain);
+
+    PsychPADestroySignal(&dev);
+    if (uselocking) PsychDestroyMutex(&(dev.mutex));
+
+    if (rc != paContinue)
+        PsychErrorExitMsg(PsychError_internal, "Audio callback stopped processing of simulated audio device!");
+
+    qsort(durations, (size_t) numCalls, sizeof(double), PsychPACompareDurations);
+
+    PsychAllocOutStructBuilder(1, kPsychArgOptional, -1, kNumFields, FieldNames, &results);
+    PsychSetStructBuilderDoubleElement(&results, kFieldNumCalls, 0, (double) numCalls);
+    PsychSetStructBuilderDoubleElement(&results, kFieldBufferDuration, 0, bufferDuration);
+    PsychSetStructBuilderDoubleElement(&results, kFieldMeanDuration, 0, tsum / numCalls);
+    PsychSetStructBuilderDoubleElement(&results, kFieldMinDuration, 0, durations[0]);
+    PsychSetStructBuilderDoubleElement(&results, kFieldMedianDuration, 0, durations[numCalls / 2]);
+    PsychSetStructBuilderDoubleElement(&results, kFieldP99Duration, 0, durations[(int) (0.99 * (numCalls - 1))]);
+    PsychSetStructBuilderDoubleElement(&results, kFieldMaxDuration, 0, durations[numCalls - 1]);
+    PsychSetStructBuilderDoubleElement(&results, kFieldLoad, 0, tsum / numCalls / bufferDuration);
+
+    return(PsychError_none);
+}
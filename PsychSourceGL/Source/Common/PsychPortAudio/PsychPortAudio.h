@@ -91,5 +91,7 @@ PsychError PSYCHPORTAUDIOSetOpMode(void);
 PsychError PSYCHPORTAUDIODirectInputMonitoring(void);
 // Set per-device volume:
 PsychError PSYCHPORTAUDIOVolume(void);
+// Benchmark the audio callback with a simulated device:
+PsychError PSYCHPORTAUDIOCallbackBenchmark(void);
 //end include once
 #endif
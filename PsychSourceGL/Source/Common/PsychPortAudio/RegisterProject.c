@@ -59,6 +59,9 @@ PsychError PsychModuleInit(void)
     PsychErrorExit(PsychRegister("SetOpMode", &PSYCHPORTAUDIOSetOpMode));
     PsychErrorExit(PsychRegister("DirectInputMonitoring", &PSYCHPORTAUDIODirectInputMonitoring));
     PsychErrorExit(PsychRegister("Volume", &PSYCHPORTAUDIOVolume));
+    PsychErrorExit(PsychRegister("CallbackBenchmark", &PSYCHPORTAUDIOCallbackBenchmark));
+    PsychErrorExit(PsychRegister("ClockDomains", &PsychClockDomainsSubfunction));
+    PsychErrorExit(PsychRegister("Trace", &PsychTraceSubfunction));
 
     // Setup synopsis help strings:
     InitializeSynopsis();   //Scripting glue won't require this if the function takes no arguments.
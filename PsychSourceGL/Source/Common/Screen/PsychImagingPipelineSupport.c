@@ -2998,8 +2998,10 @@ void PsychNormalizeTextureOrientation(PsychWindowRecordType *sourceRecord)
             glDeleteTextures(1, &(sourceRecord->textureNumber));
         }
 
-        // Assign new texture:
+        // Assign new texture. Its storage is not recycled via the texture pool, as
+        // shape and format differ from the old texture:
         sourceRecord->textureNumber = sourceRecord->fboTable[0]->coltexid;
+        sourceRecord->texturePoolFormat = 0;
 
         // Finally sourceRecord has the proper orientation:
         sourceRecord->textureOrientation = 2;
@@ -200,6 +200,20 @@ void PsychFreeMovieTexture(PsychWindowRecordType *win)
     #endif
 }
 
+/*
+ *  PsychDetachMoviesFromWindow() - Stop use of onscreen window 'win' by movies.
+ *
+ *  This routine is called by PsychCloseWindow(), so movies stop prefetching of
+ *  video frames into textures of the window which is about to get closed.
+ */
+void PsychDetachMoviesFromWindow(PsychWindowRecordType *win)
+{
+    #ifdef PTB_USE_GSTREAMER
+    PsychGSDetachMoviesFromWindow(win);
+    return;
+    #endif
+}
+
 /*
  *  PsychPlaybackRate() - Start- and stop movieplayback, set playback parameters.
  *
@@ -42,6 +42,7 @@ void PsychGetMovieInfos(int moviehandle, int* width, int* height, int* framecoun
 void PsychDeleteMovie(int moviehandle);
 void PsychDeleteAllMovies(void);
 void PsychFreeMovieTexture(PsychWindowRecordType *win);
+void PsychDetachMoviesFromWindow(PsychWindowRecordType *win);
 int PsychGetTextureFromMovie(PsychWindowRecordType *win, int moviehandle, int checkForImage, double timeindex, PsychWindowRecordType *out_texture, double *presentation_timestamp);
 int PsychPlaybackRate(int moviehandle, double playbackrate, int loop, double soundvolume);
 void PsychExitMovies(void);
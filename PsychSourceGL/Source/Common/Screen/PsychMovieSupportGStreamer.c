@@ -11,6 +11,7 @@
 
         28.11.2010    mk      Wrote it.
         20.08.2014    mk      Ported to GStreamer-1.4.x and later.
+        18.10.2026    agent   Prefetching of decoded frames into textures during playback.
 
     DESCRIPTION:
 
@@ -50,7 +51,28 @@ typedef enum {
 
 #define PSYCH_MAX_MOVIES 100
 
-typedef struct {
+// States of a slot in the prefetch ring of a movie:
+#define kPsychPrefetchFree      0
+#define kPsychPrefetchUploading 1
+#define kPsychPrefetchReady     2
+
+struct PsychMovieRecordType;
+
+// One decoded video frame in the prefetch ring, with the texture it gets uploaded into:
+typedef struct PsychMoviePrefetchSlot {
+    struct PsychMovieRecordType* movie;
+    int                 state;              // kPsychPrefetchXXX, protected by mutex of movie.
+    psych_bool          discard;            // Discard frame after completion of its upload, e.g., after a seek.
+    GstSample           *sample;            // Sample of the frame, held until its upload is done.
+    GstMapInfo          mapinfo;
+    GLuint              texture;            // Texture of slot, or 0 if the uploader shall create one.
+    GLsync              fence;              // Fence for completion of upload if state is ready, or 0.
+    double              pts;
+    double              duration;
+    gint64              offset;
+} PsychMoviePrefetchSlot;
+
+typedef struct PsychMovieRecordType {
     psych_mutex         mutex;
     psych_condition     condition;
     double              pts;
@@ -81,12 +103,26 @@ typedef struct {
     char                movieLocation[FILENAME_MAX];
     char                movieName[FILENAME_MAX];
     GLuint              cached_texture;
+    PsychWindowRecordType* prefetchWindow;  // Onscreen window whose uploader fills the prefetch ring, NULL if prefetching is inactive.
+    PsychMoviePrefetchSlot* prefetchSlots;
+    int                 prefetchSlotCount;
+    int                 prefetchHead;       // Slot of oldest prefetched frame.
+    int                 prefetchQueued;     // Number of prefetched frames, in order of arrival starting at prefetchHead. Protected by mutex.
+    GLint               prefetchInternalFormat;
+    GLenum              prefetchFormat;
+    GLenum              prefetchType;
+    int                 prefetchAlignment;
+    size_t              prefetchSize;       // Size of pixel data of a frame in bytes.
+    psych_bool          prefetchUnsupported;
 } PsychMovieRecordType;
 
 static PsychMovieRecordType movieRecordBANK[PSYCH_MAX_MOVIES];
 static int numMovieRecords = 0;
 static psych_bool firsttime = TRUE;
 
+// Number of slots in the prefetch ring of a movie, or 0 to disable prefetching. -1 = Not yet queried:
+static int prefetchSlotCount = -1;
+
 /*
  *     PsychGSMovieInit() -- Initialize movie subsystem.
  *     This routine is called by Screen's RegisterProject.c PsychModuleInit()
@@ -1297,6 +1333,316 @@ void PsychGSGetMovieInfos(int moviehandle, int* width, int* height, int* frameco
     return;
 }
 
+/*
+ * Prefetching of decoded video frames in active playback: Frames are pulled from the
+ * appsink into a small ring of slots as soon as possible, and each one gets uploaded into
+ * its own texture by the texture uploader thread of the onscreen window, through its pixel
+ * buffer object. See PsychTextureUploadSupport.c. A texture fetch in PsychGSGetTextureFromMovie()
+ * then only needs to hand over the texture of the oldest slot, instead of uploading the
+ * frame itself.
+ *
+ * Prefetching gets enabled by the first texture fetch in playback mode, after the texture
+ * for that frame got created the regular way, so the format of slot textures is known. It
+ * is not used for frames which need CPU processing, e.g., Bayer filtering, or a special
+ * texture setup, e.g., for I420 or > 8 bpc formats. The environment variable
+ * PSYCH_MOVIE_PREFETCH sets the number of slots, default is 3, or disables prefetching if
+ * set to 0.
+ */
+
+/* Completion callback of the texture upload of a prefetched frame. Usually called on the uploader thread: */
+static void PsychGSMoviePrefetchDone(void* arg, GLuint texture, GLsync fence, psych_bool cancelled)
+{
+    PsychMoviePrefetchSlot *slot = (PsychMoviePrefetchSlot*) arg;
+    PsychMovieRecordType *movie = slot->movie;
+
+    PsychLockMutex(&movie->mutex);
+
+    // Upload done, the sample is no longer needed:
+    gst_buffer_unmap(gst_sample_get_buffer(slot->sample), &slot->mapinfo);
+    gst_sample_unref(slot->sample);
+    slot->sample = NULL;
+    slot->texture = texture;
+
+    if (cancelled || slot->discard) {
+        // Frame dropped or lost. A cancelled, not discarded, slot stays in the ring
+        // as free slot, for the consumer to skip:
+        if (fence) glDeleteSync(fence);
+        slot->discard = FALSE;
+        slot->state = kPsychPrefetchFree;
+    }
+    else {
+        slot->fence = fence;
+        slot->state = kPsychPrefetchReady;
+    }
+
+    PsychSignalCondition(&movie->condition);
+    PsychUnlockMutex(&movie->mutex);
+}
+
+/* Pull all pending frames from the videosink into free slots of the prefetch ring and queue
+ * their uploads. Called by the main thread with the mutex of the movie unlocked:
+ */
+static void PsychGSRefillMoviePrefetch(PsychWindowRecordType *win, PsychMovieRecordType* movie)
+{
+    PsychMoviePrefetchSlot *slot;
+    GstSample *sample;
+    GstBuffer *buffer;
+    int maxBuffers;
+
+    // Recycled textures need a fence in our context:
+    PsychSetGLContext(win);
+
+    PsychLockMutex(&movie->mutex);
+
+    // Clamp frameAvail to maximum queue capacity, unless queue capacity is zero == "unlimited" capacity:
+    maxBuffers = (int) gst_app_sink_get_max_buffers(GST_APP_SINK(movie->videosink));
+    if ((maxBuffers > 0) && (movie->frameAvail > maxBuffers)) movie->frameAvail = maxBuffers;
+
+    while ((movie->frameAvail > 0) && (movie->prefetchQueued < movie->prefetchSlotCount)) {
+        // Next slot may still be busy with the upload of a discarded frame:
+        slot = &movie->prefetchSlots[(movie->prefetchHead + movie->prefetchQueued) % movie->prefetchSlotCount];
+        if (slot->state != kPsychPrefetchFree) break;
+
+        movie->frameAvail--;
+        PsychUnlockMutex(&movie->mutex);
+
+        // This won't block, as at least one sample is queued:
+        sample = gst_app_sink_pull_sample(GST_APP_SINK(movie->videosink));
+        if (NULL == sample) {
+            PsychLockMutex(&movie->mutex);
+            break;
+        }
+
+        buffer = gst_sample_get_buffer(sample);
+        if (!gst_buffer_map(buffer, &slot->mapinfo, GST_MAP_READ)) {
+            printf("PTB-ERROR: Failed to map video data of prefetched movie frame! Dropping frame.\n");
+            gst_sample_unref(sample);
+            PsychLockMutex(&movie->mutex);
+            continue;
+        }
+
+        slot->sample = sample;
+        slot->pts = (double) GST_BUFFER_PTS(buffer) / (double) 1e9;
+        slot->duration = (GST_CLOCK_TIME_IS_VALID(GST_BUFFER_DURATION(buffer))) ? (double) GST_BUFFER_DURATION(buffer) / (double) 1e9 : 0;
+        slot->offset = GST_BUFFER_OFFSET(buffer);
+
+        // Reuse texture of the slot, or the one in our texture cache, if any:
+        if ((slot->texture == 0) && (movie->cached_texture > 0)) {
+            slot->texture = movie->cached_texture;
+            movie->cached_texture = 0;
+        }
+
+        PsychLockMutex(&movie->mutex);
+        slot->discard = FALSE;
+        slot->state = kPsychPrefetchUploading;
+        movie->prefetchQueued++;
+        PsychUnlockMutex(&movie->mutex);
+
+        if (PsychPrefStateGet_Verbosity() > 5) printf("PTB-DEBUG: Prefetching buffer id %i with pts %f secs.\n", (int) slot->offset, slot->pts);
+
+        PsychQueueRawTextureUpload(win, slot->texture, GL_TEXTURE_RECTANGLE_EXT, movie->prefetchInternalFormat, movie->width, movie->height,
+                                   movie->prefetchFormat, movie->prefetchType, movie->prefetchAlignment, slot->mapinfo.data,
+                                   (slot->mapinfo.size < movie->prefetchSize) ? slot->mapinfo.size : movie->prefetchSize,
+                                   PsychGSMoviePrefetchDone, (void*) slot);
+
+        PsychLockMutex(&movie->mutex);
+    }
+
+    PsychUnlockMutex(&movie->mutex);
+}
+
+/* Drop all prefetched frames, e.g., after a seek or stop of playback. Waits for completion
+ * of all pending uploads if 'wait' is TRUE:
+ */
+static void PsychGSFlushMoviePrefetch(PsychMovieRecordType* movie, psych_bool wait)
+{
+    PsychMoviePrefetchSlot *slot;
+    psych_bool busy;
+    int i;
+
+    if (NULL == movie->prefetchWindow) return;
+
+    // Fences are deleted in the context of our window:
+    PsychSetGLContext(movie->prefetchWindow);
+
+    PsychLockMutex(&movie->mutex);
+    for (i = 0; i < movie->prefetchQueued; i++) {
+        slot = &movie->prefetchSlots[(movie->prefetchHead + i) % movie->prefetchSlotCount];
+        if (slot->state == kPsychPrefetchReady) {
+            if (slot->fence) glDeleteSync(slot->fence);
+            slot->fence = 0;
+            slot->state = kPsychPrefetchFree;
+        }
+        else if (slot->state == kPsychPrefetchUploading) {
+            slot->discard = TRUE;
+        }
+    }
+    movie->prefetchQueued = 0;
+
+    while (wait) {
+        for (busy = FALSE, i = 0; i < movie->prefetchSlotCount; i++) if (movie->prefetchSlots[i].state == kPsychPrefetchUploading) busy = TRUE;
+        if (!busy) break;
+        PsychWaitCondition(&movie->condition, &movie->mutex);
+    }
+    PsychUnlockMutex(&movie->mutex);
+}
+
+/* Disable prefetching for a movie and release the prefetch ring with all its textures: */
+static void PsychGSStopMoviePrefetch(PsychMovieRecordType* movie)
+{
+    int i;
+
+    if (NULL == movie->prefetchWindow) return;
+
+    PsychGSFlushMoviePrefetch(movie, TRUE);
+
+    for (i = 0; i < movie->prefetchSlotCount; i++) {
+        if (movie->prefetchSlots[i].texture) glDeleteTextures(1, &(movie->prefetchSlots[i].texture));
+    }
+
+    free(movie->prefetchSlots);
+    movie->prefetchSlots = NULL;
+    movie->prefetchSlotCount = 0;
+    movie->prefetchHead = 0;
+    movie->prefetchWindow = NULL;
+}
+
+/* Enable prefetching for a movie, if possible. Called after creation of 'out_texture' from
+ * the first frame fetched in playback mode, with 'size' bytes of pixel data, for onscreen
+ * window 'win' with its context bound:
+ */
+static void PsychGSStartMoviePrefetch(PsychWindowRecordType *win, PsychMovieRecordType* movie, PsychWindowRecordType *out_texture, size_t size)
+{
+    int i;
+
+    if (prefetchSlotCount < 0) {
+        prefetchSlotCount = (getenv("PSYCH_MOVIE_PREFETCH")) ? atoi(getenv("PSYCH_MOVIE_PREFETCH")) : 3;
+        if (prefetchSlotCount < 0) prefetchSlotCount = 0;
+    }
+
+    // Only for 8 bpc frames which are uploaded as they are, into rectangle textures via the
+    // uploader thread of the window, with fences for cheap recycling of textures:
+    if (movie->prefetchUnsupported) return;
+
+    if ((prefetchSlotCount == 0) || (movie->specialFlags1 & 1024) || (movie->bitdepth > 8) || (movie->pixelFormat == 6) ||
+        (PsychGetTextureTarget(out_texture) != GL_TEXTURE_RECTANGLE_EXT) || (out_texture->textureNumber == 0) ||
+        !glewIsSupported("GL_ARB_sync") || !PsychGetTextureUploader(win) ||
+        !(movie->prefetchSlots = (PsychMoviePrefetchSlot*) calloc(prefetchSlotCount, sizeof(PsychMoviePrefetchSlot)))) {
+        // Don't retry for this movie:
+        movie->prefetchUnsupported = TRUE;
+        return;
+    }
+
+    for (i = 0; i < prefetchSlotCount; i++) movie->prefetchSlots[i].movie = movie;
+
+    // Same texture format as for 'out_texture':
+    if (out_texture->textureinternalformat) {
+        movie->prefetchInternalFormat = out_texture->textureinternalformat;
+    }
+    else {
+        glBindTexture(GL_TEXTURE_RECTANGLE_EXT, out_texture->textureNumber);
+        glGetTexLevelParameteriv(GL_TEXTURE_RECTANGLE_EXT, 0, GL_TEXTURE_INTERNAL_FORMAT, &movie->prefetchInternalFormat);
+        glBindTexture(GL_TEXTURE_RECTANGLE_EXT, 0);
+    }
+
+    PsychGetTextureUploadFormat(out_texture, &movie->prefetchFormat, &movie->prefetchType);
+    movie->prefetchAlignment = (out_texture->textureByteAligned > 1) ? out_texture->textureByteAligned : 1;
+    movie->prefetchSize = size;
+    movie->prefetchSlotCount = prefetchSlotCount;
+    movie->prefetchHead = 0;
+    movie->prefetchQueued = 0;
+    movie->prefetchWindow = win;
+
+    if (PsychPrefStateGet_Verbosity() > 4) printf("PTB-DEBUG: Prefetching of %i decoded frames enabled for movie '%s'.\n", prefetchSlotCount, movie->movieName);
+}
+
+/* Take the oldest frame from the prefetch ring, waiting for completion of its upload if needed.
+ * In forward playback, frames older than 'timeindex' are skipped as long as newer ones are
+ * available. Called by PsychGSGetTextureFromMovie() with the mutex of the movie locked, returns
+ * with it unlocked. Returns FALSE if no frame could be retrieved. Otherwise returns the texture
+ * of the frame in 'texture', if non-NULL, and the fence for completion of its upload in 'fence':
+ */
+static psych_bool PsychGSTakeMoviePrefetch(PsychWindowRecordType *win, PsychMovieRecordType* movie, double rate, double timeindex,
+                                           GLuint *texture, GLsync *fence, double *duration, gint64 *offset)
+{
+    PsychMoviePrefetchSlot *slot;
+
+    while (TRUE) {
+        // Pull in frames which arrived since the last refill:
+        if (movie->frameAvail > 0) {
+            PsychUnlockMutex(&movie->mutex);
+            PsychGSRefillMoviePrefetch(win, movie);
+            PsychLockMutex(&movie->mutex);
+        }
+
+        if (movie->prefetchQueued == 0) {
+            if (movie->frameAvail == 0) {
+                PsychUnlockMutex(&movie->mutex);
+                return(FALSE);
+            }
+
+            // Refill may be blocked by a slot still busy with a discarded frame. Wait for it:
+            if (movie->prefetchSlots[movie->prefetchHead].state == kPsychPrefetchUploading) PsychWaitCondition(&movie->condition, &movie->mutex);
+            continue;
+        }
+
+        slot = &movie->prefetchSlots[movie->prefetchHead];
+        while (slot->state == kPsychPrefetchUploading) PsychWaitCondition(&movie->condition, &movie->mutex);
+
+        movie->prefetchHead = (movie->prefetchHead + 1) % movie->prefetchSlotCount;
+        movie->prefetchQueued--;
+
+        // Skip frame lost due to cancelled upload:
+        if (slot->state != kPsychPrefetchReady) continue;
+
+        movie->pts = slot->pts;
+
+        // Skip frames before target timeindex, as long as there are more:
+        if ((rate > 0) && (timeindex >= 0) && (slot->pts < timeindex) && ((movie->prefetchQueued > 0) || (movie->frameAvail > 0))) {
+            if (PsychPrefStateGet_Verbosity() > 5) {
+                printf("PTB-DEBUG: Fast-Skipped prefetched buffer id %i with pts %f secs < targetpts %f secs.\n", (int) slot->offset, slot->pts, timeindex);
+            }
+
+            if (slot->fence) glDeleteSync(slot->fence);
+            slot->fence = 0;
+            slot->state = kPsychPrefetchFree;
+            continue;
+        }
+
+        break;
+    }
+
+    // Hand over the texture of the slot, unless the caller only wants to skip the frame:
+    if (texture) {
+        *texture = slot->texture;
+        slot->texture = 0;
+    }
+
+    *fence = slot->fence;
+    *duration = slot->duration;
+    *offset = slot->offset;
+    slot->fence = 0;
+    slot->state = kPsychPrefetchFree;
+
+    PsychUnlockMutex(&movie->mutex);
+
+    return(TRUE);
+}
+
+/*
+ *  PsychGSDetachMoviesFromWindow() -- Stop prefetching of all movies into textures of onscreen window 'win'.
+ *
+ *  Called by PsychCloseWindow() before the texture uploader of the window is deleted.
+ */
+void PsychGSDetachMoviesFromWindow(PsychWindowRecordType *win)
+{
+    int i;
+
+    for (i = 0; i < PSYCH_MAX_MOVIES; i++) {
+        if (movieRecordBANK[i].theMovie && (movieRecordBANK[i].prefetchWindow == win)) PsychGSStopMoviePrefetch(&(movieRecordBANK[i]));
+    }
+}
+
 /*
  *  PsychGSDeleteMovie() -- Delete a movie object and release all associated ressources.
  */
@@ -1313,6 +1659,9 @@ void PsychGSDeleteMovie(int moviehandle)
         PsychErrorExitMsg(PsychError_user, "Invalid moviehandle provided. No movie associated with this handle !!!");
     }
 
+    // Release prefetched frames and their textures:
+    PsychGSStopMoviePrefetch(&(movieRecordBANK[moviehandle]));
+
     // Stop movie playback immediately:
     PsychMoviePipelineSetState(movieRecordBANK[moviehandle].theMovie, GST_STATE_NULL, 20.0);
 
@@ -1396,6 +1745,9 @@ int PsychGSGetTextureFromMovie(PsychWindowRecordType *win, int moviehandle, int
     double          tNow;
     double          preT, postT;
     unsigned char*  releaseMemPtr = NULL;
+    psych_bool      prefetched = FALSE;
+    GLuint          prefetchTexture = 0;
+    GLsync          prefetchFence = 0;
 #if PSYCH_SYSTEM == PSYCH_WINDOWS
     #pragma warning( disable : 4068 )
 #endif
@@ -1450,6 +1802,16 @@ int PsychGSGetTextureFromMovie(PsychWindowRecordType *win, int moviehandle, int
     // Get current playback rate:
     rate = movieRecordBANK[moviehandle].rate;
 
+    // Keep prefetch ring filled with newly decoded frames during playback, unless the frames
+    // are now requested for a different window than the one of the ring, or for textures
+    // other than the rectangle textures of the ring:
+    if ((0 != rate) && movieRecordBANK[moviehandle].prefetchWindow) {
+        if ((movieRecordBANK[moviehandle].prefetchWindow == win) && (!out_texture || (PsychGetTextureTarget(out_texture) == GL_TEXTURE_RECTANGLE_EXT)))
+            PsychGSRefillMoviePrefetch(win, &(movieRecordBANK[moviehandle]));
+        else
+            PsychGSStopMoviePrefetch(&(movieRecordBANK[moviehandle]));
+    }
+
     // Is movie actively playing (automatic async playback, possibly with synced sound)?
     // If so, then we ignore the 'timeindex' parameter, because the automatic playback
     // process determines which frames should be delivered to PTB when. This function will
@@ -1478,8 +1840,10 @@ int PsychGSGetTextureFromMovie(PsychWindowRecordType *win, int moviehandle, int
         if (tStart == 0) PsychGetAdjustedPrecisionTimerSeconds(&tStart);
         PsychLockMutex(&movieRecordBANK[moviehandle].mutex);
 
-        if ((((0 != rate) && movieRecordBANK[moviehandle].frameAvail) || ((0 == rate) && movieRecordBANK[moviehandle].preRollAvail)) &&
-            !gst_app_sink_is_eos(GST_APP_SINK(movieRecordBANK[moviehandle].videosink))) {
+        // Prefetched frames are available even after the videosink reached eos:
+        if (((((0 != rate) && movieRecordBANK[moviehandle].frameAvail) || ((0 == rate) && movieRecordBANK[moviehandle].preRollAvail)) &&
+             !gst_app_sink_is_eos(GST_APP_SINK(movieRecordBANK[moviehandle].videosink))) ||
+            ((0 != rate) && movieRecordBANK[moviehandle].prefetchQueued)) {
             // New frame available. Unlock and report success:
             //printf("PTB-DEBUG: NEW FRAME %d\n", movieRecordBANK[moviehandle].frameAvail);
             PsychUnlockMutex(&movieRecordBANK[moviehandle].mutex);
@@ -1512,7 +1876,7 @@ int PsychGSGetTextureFromMovie(PsychWindowRecordType *win, int moviehandle, int
     PsychLockMutex(&movieRecordBANK[moviehandle].mutex);
     // printf("PTB-DEBUG: Blocking fetch start %d\n", movieRecordBANK[moviehandle].frameAvail);
 
-    if (((0 != rate) && !movieRecordBANK[moviehandle].frameAvail) ||
+    if (((0 != rate) && !movieRecordBANK[moviehandle].frameAvail && !movieRecordBANK[moviehandle].prefetchQueued) ||
         ((0 == rate) && !movieRecordBANK[moviehandle].preRollAvail)) {
         // No new frame available. Perform a blocking wait with timeout of 0.5 seconds:
         PsychTimedWaitCondition(&movieRecordBANK[moviehandle].condition, &movieRecordBANK[moviehandle].mutex, 0.5);
@@ -1521,7 +1885,7 @@ int PsychGSGetTextureFromMovie(PsychWindowRecordType *win, int moviehandle, int
         PsychGSProcessMovieContext(&(movieRecordBANK[moviehandle]), FALSE);
 
         // Recheck:
-        if (((0 != rate) && !movieRecordBANK[moviehandle].frameAvail) ||
+        if (((0 != rate) && !movieRecordBANK[moviehandle].frameAvail && !movieRecordBANK[moviehandle].prefetchQueued) ||
             ((0 == rate) && !movieRecordBANK[moviehandle].preRollAvail)) {
             // Wait timed out after 0.5 secs.
             PsychUnlockMutex(&movieRecordBANK[moviehandle].mutex);
@@ -1552,8 +1916,21 @@ int PsychGSGetTextureFromMovie(PsychWindowRecordType *win, int moviehandle, int
     movieRecordBANK[moviehandle].preRollAvail = 0;
 
     // Perform texture fetch & creation:
-    // Active playback mode?
-    if (0 != rate) {
+    // Active playback mode with prefetching?
+    if ((0 != rate) && movieRecordBANK[moviehandle].prefetchWindow) {
+        // Take the oldest prefetched frame, already uploaded into its own texture:
+        if (!PsychGSTakeMoviePrefetch(win, &(movieRecordBANK[moviehandle]), rate, timeindex, (out_texture) ? &prefetchTexture : NULL,
+                                      &prefetchFence, &deltaT, &bufferIndex)) {
+            printf("PTB-ERROR: No new video frame received from prefetch ring! Something's wrong. Aborting fetch.\n");
+            return(FALSE);
+        }
+
+        prefetched = TRUE;
+        if (out_texture) out_texture->textureMemory = NULL;
+
+        if (PsychPrefStateGet_Verbosity() > 5) printf("PTB-DEBUG: pts %f secs, dT %f secs, bufferId %i, prefetched.\n", movieRecordBANK[moviehandle].pts, deltaT, (int) bufferIndex);
+    }
+    else if (0 != rate) {
         // Active playback mode:
         if (PsychPrefStateGet_Verbosity() > 5) printf("PTB-DEBUG: Pulling buffer from videosink, %d buffers decoded and queued.\n", movieRecordBANK[moviehandle].frameAvail);
 
@@ -1643,7 +2020,7 @@ int PsychGSGetTextureFromMovie(PsychWindowRecordType *win, int moviehandle, int
             }
             out_texture->textureMemory = (GLuint*) mapinfo.data;
         }
-    } else {
+    } else if (!prefetched) {
         printf("PTB-ERROR: No new video frame received in gst_app_sink_pull_sample! Something's wrong. Aborting fetch.\n");
         return(FALSE);
     }
@@ -1662,6 +2039,13 @@ int PsychGSGetTextureFromMovie(PsychWindowRecordType *win, int moviehandle, int
         // Activate OpenGL context of target window:
         PsychSetGLContext(win);
 
+        // Prefetched frame must be completely uploaded before use of its texture:
+        if (prefetchFence) {
+            glWaitSync(prefetchFence, 0, GL_TIMEOUT_IGNORED);
+            glDeleteSync(prefetchFence);
+            prefetchFence = 0;
+        }
+
         #if PSYCH_SYSTEM == PSYCH_OSX
         // Explicitely disable Apple's Client storage extensions. For now they are not really useful to us.
         glPixelStorei(GL_UNPACK_CLIENT_STORAGE_APPLE, GL_FALSE);
@@ -1718,8 +2102,8 @@ int PsychGSGetTextureFromMovie(PsychWindowRecordType *win, int moviehandle, int
             out_texture->textureByteAligned = (movieRecordBANK[moviehandle].width % 2) ? 4 : 8;
         }
 
-        // Assign texturehandle of our cached texture, if any, so it gets recycled now:
-        out_texture->textureNumber = movieRecordBANK[moviehandle].cached_texture;
+        // Assign texturehandle of the prefetched frame, or of our cached texture, if any, so it gets recycled now:
+        out_texture->textureNumber = (prefetched) ? prefetchTexture : movieRecordBANK[moviehandle].cached_texture;
 
         // Mark this texture as originating from us, ie., our moviehandle, so texture recycling
         // actually gets used:
@@ -1913,7 +2297,11 @@ int PsychGSGetTextureFromMovie(PsychWindowRecordType *win, int moviehandle, int
         // and no longer available for recycling. We mark the cache as empty:
         // It will be filled with a new textureid for recycling if a texture gets
         // deleted in PsychMovieDeleteTexture()....
-        movieRecordBANK[moviehandle].cached_texture = 0;
+        if (!prefetched) movieRecordBANK[moviehandle].cached_texture = 0;
+
+        // First frame in playback mode, created the regular way? Prefetch following frames if possible:
+        if ((0 != rate) && !prefetched && !movieRecordBANK[moviehandle].prefetchWindow)
+            PsychGSStartMoviePrefetch(win, &(movieRecordBANK[moviehandle]), out_texture, mapinfo.size);
 
         // Does usercode want immediate conversion of texture into standard RGBA8 packed pixel
         // upright format for use as a render-target? If so, do it:
@@ -1962,9 +2350,16 @@ int PsychGSGetTextureFromMovie(PsychWindowRecordType *win, int moviehandle, int
     }
 
     // Unlock.
-    gst_buffer_unmap(videoBuffer, &mapinfo);
-    gst_sample_unref(videoSample);
-    videoBuffer = NULL;
+    if (videoSample) {
+        gst_buffer_unmap(videoBuffer, &mapinfo);
+        gst_sample_unref(videoSample);
+        videoBuffer = NULL;
+    }
+    else if (prefetchFence) {
+        // Prefetched frame skipped without texture creation:
+        PsychSetGLContext(win);
+        glDeleteSync(prefetchFence);
+    }
 
     // Manually advance movie time, if in fetch mode:
     if (0 == rate) {
@@ -2070,6 +2465,9 @@ int PsychGSPlaybackRate(int moviehandle, double playbackrate, int loop, double s
         return(0);
     }
 
+    // Start, stop or change of playback rate flushes all decoded and prefetched frames:
+    PsychGSFlushMoviePrefetch(&(movieRecordBANK[moviehandle]), FALSE);
+
     if (playbackrate != 0) {
         // Start playback of movie:
 
@@ -2262,6 +2660,9 @@ double PsychGSSetMovieTimeIndex(int moviehandle, double timeindex, psych_bool in
     // Retrieve current timeindex:
     oldtime = PsychGSGetMovieTimeIndex(moviehandle);
 
+    // Prefetched frames are from before the seek:
+    PsychGSFlushMoviePrefetch(&(movieRecordBANK[moviehandle]), FALSE);
+
     // NOTE: We could use GST_SEEK_FLAG_SKIP to allow framedropping on fast forward/reverse playback...
     flags = GST_SEEK_FLAG_FLUSH | GST_SEEK_FLAG_ACCURATE;
 
@@ -31,6 +31,7 @@ void PsychGSGetMovieInfos(int moviehandle, int* width, int* height, int* frameco
 void PsychGSDeleteMovie(int moviehandle);
 void PsychGSDeleteAllMovies(void);
 void PsychGSFreeMovieTexture(PsychWindowRecordType *win);
+void PsychGSDetachMoviesFromWindow(PsychWindowRecordType *win);
 int PsychGSGetTextureFromMovie(PsychWindowRecordType *win, int moviehandle, int checkForImage, double timeindex, PsychWindowRecordType *out_texture, double *presentation_timestamp);
 int PsychGSPlaybackRate(int moviehandle, double playbackrate, int loop, double soundvolume);
 void PsychGSExitMovies(void);
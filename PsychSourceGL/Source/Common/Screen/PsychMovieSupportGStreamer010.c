@@ -2152,6 +2152,17 @@ void PsychGSFreeMovieTexture(PsychWindowRecordType *win)
     return;
 }
 
+/*
+ *  PsychGSDetachMoviesFromWindow() -- Stop use of onscreen window 'win' by movies.
+ *
+ *  No-op, as frame prefetching is only supported with GStreamer 1.x.
+ */
+void PsychGSDetachMoviesFromWindow(PsychWindowRecordType *win)
+{
+    (void) win;
+    return;
+}
+
 /*
  *  PsychGSPlaybackRate() - Start- and stop movieplayback, set playback parameters.
  *
@@ -47,7 +47,11 @@ int PsychCreateNewMovieFile(char* moviefile, int width, int height, double frame
 int PsychFinalizeNewMovieFile(int movieHandle);
 int PsychAddVideoFrameToMovie(int moviehandle, int frameDurationUnits, psych_bool isUpsideDown, double frameTimestamp);
 unsigned char*	PsychGetVideoFrameForMoviePtr(int moviehandle, unsigned int* twidth, unsigned int* theight, unsigned int* numChannels, unsigned int* bitdepth);
+psych_bool PsychGetMovieFrameFormat(int moviehandle, unsigned int* twidth, unsigned int* theight, unsigned int* numChannels, unsigned int* bitdepth);
 psych_bool PsychAddAudioBufferToMovie(int moviehandle, unsigned int nrChannels, unsigned int nrSamples, double* buffer);
+int PsychQueueVideoFrameToMovie(int moviehandle, const void* pixels, int frameDurationUnits, psych_bool isUpsideDown, double captureTime, psych_bool* copied);
+psych_bool PsychMovieFrameCopied(int moviehandle, psych_bool* copied, psych_bool doWait);
+void PsychGetMovieWriterStats(int moviehandle, unsigned int* framesWritten, unsigned int* framesDropped, double* meanLatency, double* maxLatency);
 unsigned char* PsychMovieCopyPulledPipelineBuffer(int moviehandle, unsigned int* twidth, unsigned int* theight, unsigned int* numChannels, unsigned int* bitdepth, double* timestamp);
 
 //end include once
@@ -13,6 +13,7 @@
 
         06-Jun-2011     mk      Wrote it.
         23-Aug-2014     mk      Ported from 0.10 to 1.0+ GStreamer.
+        18-Oct-2026     agent   Add asynchronous writer thread with bounded frame queue.
 
     DESCRIPTION:
 
@@ -35,6 +36,29 @@
 
 // GStreamer implementation of movie writing support:
 
+// Frame handed to the asynchronous writer thread by PsychQueueVideoFrameToMovie():
+typedef struct PsychMovieWriterFrame {
+    struct PsychMovieWriterFrame*                   next;
+    const void*                                     pixels;             // Pixels to copy. Owned by the caller until 'copied' is set.
+    psych_bool*                                     copied;             // Set to TRUE once 'pixels' are no longer needed.
+    int                                             frameDurationUnits;
+    psych_bool                                      isUpsideDown;
+    GstClockTime                                    pts;                // Timestamp of the first copy of the frame.
+    double                                          captureTime;        // Time of capture, for latency statistics.
+} PsychMovieWriterFrame;
+
+// Bounded queue of frames, feeding the ptbvideoappsrc from a writer thread:
+typedef struct PsychMovieWriterQueue {
+    psych_thread                                    thread;
+    psych_mutex                                     mutex;
+    psych_condition                                 condition;          // Signalled on any change of queue state.
+    PsychMovieWriterFrame*                          head;
+    PsychMovieWriterFrame*                          tail;
+    int                                             count;              // Frames queued or being pushed into the pipeline.
+    psych_bool                                      shutdown;
+    GstFlowReturn                                   error;              // First failed push, GST_FLOW_OK if none.
+} PsychMovieWriterQueue;
+
 // Record which defines all state for a capture device:
 typedef struct {
     volatile psych_bool                             eos;
@@ -57,6 +81,15 @@ typedef struct {
     double                                          frameTime;
     double                                          frameTimeDelta;
     GstClockTime                                    audioTime;
+    PsychMovieWriterQueue*                          writerQueue;        // Asynchronous writer, NULL if not started.
+    int                                             writerQueueDepth;   // Maximum number of queued frames, 0 = no asynchronous writer.
+    psych_bool                                      writerDropFrames;   // Drop new frames if queue is full, instead of waiting.
+    unsigned int                                    framesWritten;      // Statistics, protected by writerQueue->mutex if writer is active.
+    unsigned int                                    framesDropped;
+    unsigned int                                    latencyCount;
+    double                                          latencySum;
+    double                                          latencyMax;
+    double                                          latencyLast;
 } PsychMovieWriterRecordType;
 
 static PsychMovieWriterRecordType moviewriterRecordBANK[PSYCH_MAX_MOVIEWRITERDEVICES];
@@ -142,6 +175,177 @@ PsychMovieWriterRecordType* PsychGetMovieWriter(int moviehandle, psych_bool unsa
     return(&(moviewriterRecordBANK[moviehandle]));
 }
 
+// Main routine of asynchronous writer thread: Copies queued frames into new GStreamer buffers,
+// flipping bottom-up images on the fly, then pushes them into the pipeline. Pushing blocks if
+// the appsrc queue is full, ie. if the encoder can't keep up. The calling thread then waits or
+// drops frames in PsychQueueVideoFrameToMovie(), once the writer queue is full as well:
+static void* PsychMovieWriterThreadMain(void* arg)
+{
+    PsychMovieWriterRecordType* pwriterRec = (PsychMovieWriterRecordType*) arg;
+    PsychMovieWriterQueue* queue = pwriterRec->writerQueue;
+    PsychMovieWriterFrame* frame;
+    GstBuffer* buffer;
+    GstBuffer* curBuffer;
+    GstFlowReturn ret;
+    size_t rowbytes = (size_t) pwriterRec->width * pwriterRec->numChannels * (pwriterRec->bitdepth / 8);
+    size_t y, h = (size_t) pwriterRec->height;
+    double tnow;
+    int i, n;
+#if PSYCH_SYSTEM == PSYCH_WINDOWS
+    #pragma warning( disable : 4068 )
+#endif
+    #pragma GCC diagnostic push
+    #pragma GCC diagnostic ignored "-Wmissing-field-initializers"
+    GstMapInfo mapinfo = GST_MAP_INFO_INIT;
+    #pragma GCC diagnostic pop
+
+    PsychSetThreadName("PTBMovieWriter");
+
+    PsychLockMutex(&(queue->mutex));
+    while (TRUE) {
+        // Wait for a new frame or shutdown:
+        while ((NULL == queue->head) && !queue->shutdown) PsychWaitCondition(&(queue->condition), &(queue->mutex));
+        if (NULL == queue->head) break;
+
+        frame = queue->head;
+        queue->head = frame->next;
+        if (NULL == queue->head) queue->tail = NULL;
+        PsychUnlockMutex(&(queue->mutex));
+
+        ret = GST_FLOW_ERROR;
+        buffer = gst_buffer_new_allocate(NULL, rowbytes * h, NULL);
+        if (buffer && gst_buffer_map(buffer, &mapinfo, GST_MAP_WRITE)) {
+            if (frame->isUpsideDown) {
+                for (y = 0; y < h; y++)
+                    memcpy(mapinfo.data + y * rowbytes, (const unsigned char*) frame->pixels + (h - 1 - y) * rowbytes, rowbytes);
+            }
+            else {
+                memcpy(mapinfo.data, frame->pixels, rowbytes * h);
+            }
+
+            gst_buffer_unmap(buffer, &mapinfo);
+            ret = GST_FLOW_OK;
+        }
+
+        // Pixels are no longer needed, the caller can reuse them:
+        PsychLockMutex(&(queue->mutex));
+        *(frame->copied) = TRUE;
+        PsychBroadcastCondition(&(queue->condition));
+        PsychUnlockMutex(&(queue->mutex));
+
+        // Push the frame, followed by frameDurationUnits - 1 copies of it. push_buffer takes our
+        // reference, so the frame itself goes last:
+        n = (frame->frameDurationUnits > 1) ? frame->frameDurationUnits : 1;
+        for (i = 0; (i < n) && (ret == GST_FLOW_OK); i++) {
+            curBuffer = (i < n - 1) ? gst_buffer_copy(buffer) : buffer;
+            GST_BUFFER_PTS(curBuffer) = frame->pts + (GstClockTime) (i * pwriterRec->frameTimeDelta * 1e9);
+            ret = gst_app_src_push_buffer(GST_APP_SRC(pwriterRec->ptbvideoappsrc), curBuffer);
+        }
+
+        if (buffer && (i < n)) gst_buffer_unref(buffer);
+
+        PsychGetAdjustedPrecisionTimerSeconds(&tnow);
+
+        PsychLockMutex(&(queue->mutex));
+        if (ret == GST_FLOW_OK) {
+            pwriterRec->framesWritten++;
+            pwriterRec->latencyCount++;
+            pwriterRec->latencyLast = tnow - frame->captureTime;
+            pwriterRec->latencySum += pwriterRec->latencyLast;
+            if (pwriterRec->latencyLast > pwriterRec->latencyMax) pwriterRec->latencyMax = pwriterRec->latencyLast;
+        }
+        else if (queue->error == GST_FLOW_OK) {
+            queue->error = ret;
+        }
+
+        queue->count--;
+        PsychBroadcastCondition(&(queue->condition));
+        free(frame);
+    }
+    PsychUnlockMutex(&(queue->mutex));
+
+    return(NULL);
+}
+
+// Start asynchronous writer thread for movie. Returns FALSE if that is impossible:
+static psych_bool PsychGSStartMovieWriterQueue(PsychMovieWriterRecordType* pwriterRec)
+{
+    PsychMovieWriterQueue* queue;
+    size_t size = (size_t) pwriterRec->width * pwriterRec->height * pwriterRec->numChannels * (pwriterRec->bitdepth / 8);
+    int rc;
+
+    queue = (PsychMovieWriterQueue*) calloc(1, sizeof(PsychMovieWriterQueue));
+    if (NULL == queue) PsychErrorExitMsg(PsychError_outofMemory, "Out of memory while trying to setup asynchronous movie writing!");
+
+    queue->error = GST_FLOW_OK;
+    PsychInitMutex(&(queue->mutex));
+    PsychInitCondition(&(queue->condition), NULL);
+    pwriterRec->writerQueue = queue;
+
+    // Bound the amount of data buffered by the appsrc as well, so a lagging encoder makes the
+    // writer thread block, instead of letting memory consumption and latency grow without bounds:
+    g_object_set(G_OBJECT(pwriterRec->ptbvideoappsrc), "max-bytes", (guint64) size * (guint64) pwriterRec->writerQueueDepth, NULL);
+
+    if ((rc = PsychCreateThread(&(queue->thread), NULL, PsychMovieWriterThreadMain, (void*) pwriterRec))) {
+        if (PsychPrefStateGet_Verbosity() > 1)
+            printf("PTB-WARNING: Failed to start movie writer thread [%s]. Adding frames synchronously.\n", strerror(rc));
+
+        PsychDestroyCondition(&(queue->condition));
+        PsychDestroyMutex(&(queue->mutex));
+        free(queue);
+        pwriterRec->writerQueue = NULL;
+
+        // Don't try again for this movie:
+        pwriterRec->writerQueueDepth = 0;
+        return(FALSE);
+    }
+
+    if (PsychPrefStateGet_Verbosity() > 4)
+        printf("PTB-DEBUG: Asynchronous movie writer with queue depth %i started, %s frames if queue is full.\n", pwriterRec->writerQueueDepth,
+               (pwriterRec->writerDropFrames) ? "dropping" : "waiting for space for");
+
+    return(TRUE);
+}
+
+// Wait until all frames queued for asynchronous writing are pushed into the pipeline. Handles
+// pipeline bus messages meanwhile, so errors get reported:
+static void PsychGSWaitMovieWriterQueue(PsychMovieWriterRecordType* pwriterRec)
+{
+    PsychMovieWriterQueue* queue = pwriterRec->writerQueue;
+
+    if (NULL == queue) return;
+
+    PsychLockMutex(&(queue->mutex));
+    while (queue->count > 0) {
+        PsychUnlockMutex(&(queue->mutex));
+        PsychGSProcessMovieContext(pwriterRec, FALSE);
+        PsychLockMutex(&(queue->mutex));
+        if (queue->count > 0) PsychTimedWaitCondition(&(queue->condition), &(queue->mutex), 0.010);
+    }
+    PsychUnlockMutex(&(queue->mutex));
+}
+
+// Drain queue and stop asynchronous writer thread, if any:
+static void PsychGSStopMovieWriterQueue(PsychMovieWriterRecordType* pwriterRec)
+{
+    PsychMovieWriterQueue* queue = pwriterRec->writerQueue;
+
+    if (NULL == queue) return;
+
+    PsychGSWaitMovieWriterQueue(pwriterRec);
+
+    PsychLockMutex(&(queue->mutex));
+    queue->shutdown = TRUE;
+    PsychSignalCondition(&(queue->condition));
+    PsychUnlockMutex(&(queue->mutex));
+    PsychDeleteThread(&(queue->thread));
+
+    PsychDestroyCondition(&(queue->condition));
+    PsychDestroyMutex(&(queue->mutex));
+    free(queue);
+    pwriterRec->writerQueue = NULL;
+}
+
 // Pulls next GStreamer videobuffer from appsink, if any, and copies its image data into a new malloc'd buffer. Caller has to free() the returned buffer.
 // Used mostly by the libdc1394 video capture engine for retrieval of feedback data:
 unsigned char* PsychMovieCopyPulledPipelineBuffer(int moviehandle, unsigned int* twidth, unsigned int* theight, unsigned int* numChannels, unsigned int* bitdepth, double* timestamp)
@@ -193,6 +397,18 @@ unsigned char* PsychMovieCopyPulledPipelineBuffer(int moviehandle, unsigned int*
     return(imgdata);
 }
 
+psych_bool PsychGetMovieFrameFormat(int moviehandle, unsigned int* twidth, unsigned int* theight, unsigned int* numChannels, unsigned int* bitdepth)
+{
+    PsychMovieWriterRecordType* pwriterRec = PsychGetMovieWriter(moviehandle, FALSE);
+
+    *twidth  = pwriterRec->width;
+    *theight = pwriterRec->height;
+    *numChannels = pwriterRec->numChannels;
+    *bitdepth = pwriterRec->bitdepth;
+
+    return(TRUE);
+}
+
 unsigned char* PsychGetVideoFrameForMoviePtr(int moviehandle, unsigned int* twidth, unsigned int* theight, unsigned int* numChannels, unsigned int* bitdepth)
 {
     PsychMovieWriterRecordType* pwriterRec = PsychGetMovieWriter(moviehandle, FALSE);
@@ -248,6 +464,9 @@ int PsychAddVideoFrameToMovie(int moviehandle, int frameDurationUnits, psych_boo
     if (NULL == pwriterRec->ptbvideoappsrc) return(0);
     if (NULL == pwriterRec->PixMap) return(0);
 
+    // Frames still queued for asynchronous writing go first, so frames stay in order:
+    PsychGSWaitMovieWriterQueue(pwriterRec);
+
     if ((frameDurationUnits < 1) && (PsychPrefStateGet_Verbosity() > 1)) printf("PTB-WARNING:In AddFrameToMovie: Negative or zero 'frameduration' %i units for moviehandle %i provided! Sounds like trouble ahead.\n", frameDurationUnits, moviehandle);
 
     // Assign frameTimestamp (if valid aka greater than zero) as video buffer timestamp, after conversion into nanoseconds:
@@ -356,6 +575,8 @@ int PsychAddVideoFrameToMovie(int moviehandle, int frameDurationUnits, psych_boo
         return((int) ret);
     }
 
+    pwriterRec->framesWritten++;
+
     PsychGSProcessMovieContext(pwriterRec, FALSE);
 
     if (PsychPrefStateGet_Verbosity() > 5) printf("PTB-DEBUG:In AddFrameToMovie: Added new videoframe with %i units duration and upsidedown = %i to moviehandle %i.\n", bframeDurationUnits, (int) isUpsideDown, moviehandle);
@@ -364,6 +585,129 @@ int PsychAddVideoFrameToMovie(int moviehandle, int frameDurationUnits, psych_boo
     return((int) ret);
 }
 
+// Add a video frame from memory 'pixels' in the movies frame format, with the same meaning of
+// the other parameters as for PsychAddVideoFrameToMovie() with an invalid -1 timestamp. If an
+// asynchronous writer is enabled for the movie, the frame is only queued, and later copied by
+// the writer thread, which sets *copied = TRUE afterwards. The caller must keep 'pixels' valid
+// until then. Without asynchronous writer, or if the frame gets dropped because the queue is
+// full, *copied is TRUE on return. Returns 0 on success, an error code otherwise:
+int PsychQueueVideoFrameToMovie(int moviehandle, const void* pixels, int frameDurationUnits, psych_bool isUpsideDown, double captureTime, psych_bool* copied)
+{
+    PsychMovieWriterRecordType* pwriterRec = PsychGetMovieWriter(moviehandle, FALSE);
+    PsychMovieWriterQueue* queue;
+    PsychMovieWriterFrame* frame;
+    unsigned int twidth, theight, numChannels, bitdepth;
+    unsigned char* framepixels;
+    GstFlowReturn ret;
+    int n = (frameDurationUnits > 1) ? frameDurationUnits : 1;
+
+    *copied = TRUE;
+    if (NULL == pwriterRec->ptbvideoappsrc) return(0);
+
+    if (!pwriterRec->writerQueue && ((pwriterRec->writerQueueDepth <= 0) || !PsychGSStartMovieWriterQueue(pwriterRec))) {
+        // No asynchronous writer: Add frame synchronously:
+        framepixels = PsychGetVideoFrameForMoviePtr(moviehandle, &twidth, &theight, &numChannels, &bitdepth);
+        if (NULL == framepixels) return(1);
+
+        memcpy(framepixels, pixels, (size_t) twidth * theight * numChannels * (bitdepth / 8));
+        return(PsychAddVideoFrameToMovie(moviehandle, frameDurationUnits, isUpsideDown, -1));
+    }
+
+    if ((frameDurationUnits < 1) && (PsychPrefStateGet_Verbosity() > 1)) printf("PTB-WARNING:In AddFrameToMovie: Negative or zero 'frameduration' %i units for moviehandle %i provided! Sounds like trouble ahead.\n", frameDurationUnits, moviehandle);
+
+    queue = pwriterRec->writerQueue;
+    PsychLockMutex(&(queue->mutex));
+
+    // Writer thread failed to push a previous frame?
+    if ((ret = queue->error) != GST_FLOW_OK) {
+        PsychUnlockMutex(&(queue->mutex));
+        if (PsychPrefStateGet_Verbosity() > 0) printf("PTB-ERROR:In AddFrameToMovie: Adding frame to moviehandle %i failed [push-buffer returned error code %i]!\n", moviehandle, (int) ret);
+        return((int) ret);
+    }
+
+    if (queue->count >= pwriterRec->writerQueueDepth) {
+        if (pwriterRec->writerDropFrames) {
+            // Drop the frame, but advance the timeline, so following frames keep their timing:
+            pwriterRec->framesDropped++;
+            pwriterRec->frameTime += n * pwriterRec->frameTimeDelta;
+            PsychUnlockMutex(&(queue->mutex));
+
+            if (PsychPrefStateGet_Verbosity() > 5) printf("PTB-DEBUG:In AddFrameToMovie: Writer queue full. Dropped videoframe for moviehandle %i.\n", moviehandle);
+            return(0);
+        }
+
+        // Backpressure: Wait for the writer thread to catch up:
+        while ((queue->count >= pwriterRec->writerQueueDepth) && (queue->error == GST_FLOW_OK)) {
+            PsychUnlockMutex(&(queue->mutex));
+            PsychGSProcessMovieContext(pwriterRec, FALSE);
+            PsychLockMutex(&(queue->mutex));
+            if (queue->count >= pwriterRec->writerQueueDepth) PsychTimedWaitCondition(&(queue->condition), &(queue->mutex), 0.010);
+        }
+    }
+
+    frame = (PsychMovieWriterFrame*) calloc(1, sizeof(PsychMovieWriterFrame));
+    if (NULL == frame) {
+        PsychUnlockMutex(&(queue->mutex));
+        PsychErrorExitMsg(PsychError_outofMemory, "Out of memory while trying to add video data to movie!");
+    }
+
+    frame->pixels = pixels;
+    frame->copied = copied;
+    frame->frameDurationUnits = frameDurationUnits;
+    frame->isUpsideDown = isUpsideDown;
+    frame->captureTime = captureTime;
+    frame->pts = (GstClockTime) (pwriterRec->frameTime * 1e9);
+    pwriterRec->frameTime += n * pwriterRec->frameTimeDelta;
+
+    *copied = FALSE;
+    if (queue->tail) queue->tail->next = frame; else queue->head = frame;
+    queue->tail = frame;
+    queue->count++;
+    PsychSignalCondition(&(queue->condition));
+
+    if (PsychPrefStateGet_Verbosity() > 5) printf("PTB-DEBUG:In AddFrameToMovie: Queued videoframe with %i units duration to moviehandle %i, %i frames queued. Latency of last written frame %f msecs.\n",
+                                                  frameDurationUnits, moviehandle, queue->count, pwriterRec->latencyLast * 1000);
+    PsychUnlockMutex(&(queue->mutex));
+
+    PsychGSProcessMovieContext(pwriterRec, FALSE);
+
+    return(0);
+}
+
+// Check if the asynchronous writer has copied a frame queued by PsychQueueVideoFrameToMovie(),
+// ie., if *copied is TRUE. Waits for the copy if 'doWait' is TRUE. Always TRUE if the movie
+// has no running writer thread anymore, e.g., because it got finalized meanwhile:
+psych_bool PsychMovieFrameCopied(int moviehandle, psych_bool* copied, psych_bool doWait)
+{
+    PsychMovieWriterRecordType* pwriterRec = PsychGetMovieWriter(moviehandle, TRUE);
+    PsychMovieWriterQueue* queue = pwriterRec->writerQueue;
+    psych_bool rc;
+
+    if (NULL == queue) return(TRUE);
+
+    PsychLockMutex(&(queue->mutex));
+    while (doWait && !*copied) PsychWaitCondition(&(queue->condition), &(queue->mutex));
+    rc = *copied;
+    PsychUnlockMutex(&(queue->mutex));
+
+    return(rc);
+}
+
+// Return statistics of the movie: Number of written and dropped frames, and mean and maximum
+// latency in seconds between capture and push into the encoding pipeline of asynchronously
+// written frames. Waits for all queued frames to be written first:
+void PsychGetMovieWriterStats(int moviehandle, unsigned int* framesWritten, unsigned int* framesDropped, double* meanLatency, double* maxLatency)
+{
+    PsychMovieWriterRecordType* pwriterRec = PsychGetMovieWriter(moviehandle, FALSE);
+
+    PsychGSWaitMovieWriterQueue(pwriterRec);
+
+    *framesWritten = pwriterRec->framesWritten;
+    *framesDropped = pwriterRec->framesDropped;
+    *meanLatency = (pwriterRec->latencyCount > 0) ? pwriterRec->latencySum / pwriterRec->latencyCount : 0;
+    *maxLatency = pwriterRec->latencyMax;
+}
+
 psych_bool PsychAddAudioBufferToMovie(int moviehandle, unsigned int nrChannels, unsigned int nrSamples, double* buffer)
 {
     PsychMovieWriterRecordType* pwriterRec = PsychGetMovieWriter(moviehandle, FALSE);
@@ -609,6 +953,15 @@ int PsychCreateNewMovieFile(char* moviefile, int width, int height, double frame
     pwriterRec->frameTime = 0.0;
     pwriterRec->frameTimeDelta = (framerate > 0.0) ? (1.0 / framerate) : 0.0;
     pwriterRec->audioTime = 0;
+    pwriterRec->writerQueue = NULL;
+    pwriterRec->writerQueueDepth = 8;
+    pwriterRec->writerDropFrames = FALSE;
+    pwriterRec->framesWritten = 0;
+    pwriterRec->framesDropped = 0;
+    pwriterRec->latencyCount = 0;
+    pwriterRec->latencySum = 0;
+    pwriterRec->latencyMax = 0;
+    pwriterRec->latencyLast = 0;
 
     // If no movieoptions specified, create default string for default
     // codec selection and configuration:
@@ -680,6 +1033,17 @@ int PsychCreateNewMovieFile(char* moviefile, int width, int height, double frame
         else PsychErrorExitMsg(PsychError_user, "Invalid EncodingQuality= parameter provided in movieoptions parameter. Parse error or out of valid 0 - 1 range!");
     }
 
+    // Queue depth of asynchronous writer for asynchronous 'AddFrameToMovie', 0 = synchronous writing:
+    if ((poption = strstr(movieoptions, "WriterQueueDepth="))) {
+        if ((sscanf(poption, "WriterQueueDepth=%i", &dummyInt) == 1) && (dummyInt >= 0)) {
+            pwriterRec->writerQueueDepth = dummyInt;
+        }
+        else PsychErrorExitMsg(PsychError_user, "Invalid WriterQueueDepth= parameter provided in movieoptions parameter. Parse error or negative depth!");
+    }
+
+    // Drop frames instead of waiting if the asynchronous writer can't keep up?
+    if (strstr(movieoptions, "WriterDropFrames")) pwriterRec->writerDropFrames = TRUE;
+
     // Check for valid parameters. Also warn if some parameters are borderline for certain codecs:
     if ((framerate < 1) && (PsychPrefStateGet_Verbosity() > 1)) printf("PTB-WARNING:In CreateMovie: Negative or zero 'framerate' %f units for moviehandle %i provided! Sounds like trouble ahead.\n", (float) framerate, moviehandle);
     if (width < 1) PsychErrorExitMsg(PsychError_user, "In CreateMovie: Invalid zero or negative 'width' for video frame size provided!");
@@ -1022,6 +1386,17 @@ int PsychFinalizeNewMovieFile(int movieHandle)
 
     if (NULL == pwriterRec->ptbvideoappsrc) return(0);
 
+    // Push all frames still queued for asynchronous writing, then stop the writer:
+    PsychGSStopMovieWriterQueue(pwriterRec);
+
+    if ((pwriterRec->framesDropped > 0) && (PsychPrefStateGet_Verbosity() > 1))
+        printf("PTB-WARNING: Moviehandle %i: %i of %i video frames dropped, because encoding could not keep up.\n", movieHandle,
+               pwriterRec->framesDropped, pwriterRec->framesDropped + pwriterRec->framesWritten);
+
+    if ((pwriterRec->latencyCount > 0) && (PsychPrefStateGet_Verbosity() > 3))
+        printf("PTB-INFO: Moviehandle %i: %i video frames written asynchronously. Capture to encoder latency mean %f msecs, max %f msecs.\n", movieHandle,
+               pwriterRec->latencyCount, pwriterRec->latencySum / pwriterRec->latencyCount * 1000, pwriterRec->latencyMax * 1000);
+
     // Release any pending buffers:
     if (pwriterRec->PixMap) gst_buffer_unref(pwriterRec->PixMap);
     pwriterRec->PixMap = NULL;
@@ -1147,6 +1522,28 @@ unsigned char* PsychGetVideoFrameForMoviePtr(int moviehandle, unsigned int* twid
     return(NULL);
 }
 
+psych_bool PsychGetMovieFrameFormat(int moviehandle, unsigned int* twidth, unsigned int* theight, unsigned int* numChannels, unsigned int* bitdepth)
+{
+    PsychErrorExitMsg(PsychError_unimplemented, "Sorry, movie writing not supported on this operating system");
+    return(FALSE);
+}
+
+int PsychQueueVideoFrameToMovie(int moviehandle, const void* pixels, int frameDurationUnits, psych_bool isUpsideDown, double captureTime, psych_bool* copied)
+{
+    PsychErrorExitMsg(PsychError_unimplemented, "Sorry, movie writing not supported on this operating system");
+    return(1);
+}
+
+psych_bool PsychMovieFrameCopied(int moviehandle, psych_bool* copied, psych_bool doWait)
+{
+    return(TRUE);
+}
+
+void PsychGetMovieWriterStats(int moviehandle, unsigned int* framesWritten, unsigned int* framesDropped, double* meanLatency, double* maxLatency)
+{
+    PsychErrorExitMsg(PsychError_unimplemented, "Sorry, movie writing not supported on this operating system");
+}
+
 psych_bool PsychAddAudioBufferToMovie(int moviehandle, unsigned int nrChannels, unsigned int nrSamples, double* buffer)
 {
     PsychErrorExitMsg(PsychError_unimplemented, "Sorry, movie writing not supported on this operating system");
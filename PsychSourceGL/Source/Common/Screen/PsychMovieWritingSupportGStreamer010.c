@@ -213,6 +213,18 @@ unsigned char* PsychMovieCopyPulledPipelineBuffer(int moviehandle, unsigned int*
     return(imgdata);
 }
 
+psych_bool PsychGetMovieFrameFormat(int moviehandle, unsigned int* twidth, unsigned int* theight, unsigned int* numChannels, unsigned int* bitdepth)
+{
+    PsychMovieWriterRecordType* pwriterRec = PsychGetMovieWriter(moviehandle, FALSE);
+
+    *twidth  = pwriterRec->width;
+    *theight = pwriterRec->height;
+    *numChannels = pwriterRec->numChannels;
+    *bitdepth = pwriterRec->bitdepth;
+
+    return(TRUE);
+}
+
 unsigned char* PsychGetVideoFrameForMoviePtr(int moviehandle, unsigned int* twidth, unsigned int* theight, unsigned int* numChannels, unsigned int* bitdepth)
 {
     PsychMovieWriterRecordType* pwriterRec = PsychGetMovieWriter(moviehandle, FALSE);
@@ -1040,6 +1052,33 @@ int PsychFinalizeNewMovieFile(int movieHandle)
     return(myErr == 0);
 }
 
+// No asynchronous writer thread for GStreamer 0.10. Frames get added synchronously:
+int PsychQueueVideoFrameToMovie(int moviehandle, const void* pixels, int frameDurationUnits, psych_bool isUpsideDown, double captureTime, psych_bool* copied)
+{
+    unsigned int twidth, theight, numChannels, bitdepth;
+    unsigned char* framepixels;
+
+    *copied = TRUE;
+    framepixels = PsychGetVideoFrameForMoviePtr(moviehandle, &twidth, &theight, &numChannels, &bitdepth);
+    if (NULL == framepixels) return(1);
+
+    memcpy(framepixels, pixels, (size_t) twidth * theight * numChannels * (bitdepth / 8));
+    return(PsychAddVideoFrameToMovie(moviehandle, frameDurationUnits, isUpsideDown, -1));
+}
+
+psych_bool PsychMovieFrameCopied(int moviehandle, psych_bool* copied, psych_bool doWait)
+{
+    return(TRUE);
+}
+
+void PsychGetMovieWriterStats(int moviehandle, unsigned int* framesWritten, unsigned int* framesDropped, double* meanLatency, double* maxLatency)
+{
+    *framesWritten = 0;
+    *framesDropped = 0;
+    *meanLatency = 0;
+    *maxLatency = 0;
+}
+
 #endif // #if !GST_CHECK_VERSION(1,0,0)
 
 // End of GStreamer routines.
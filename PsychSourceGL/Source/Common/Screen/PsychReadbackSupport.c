@@ -0,0 +1,492 @@
+/*
+    Common/Screen/PsychReadbackSupport.c
+
+    PLATFORMS:
+
+        All.
+
+    AUTHORS:
+
+        agent           agent  agent@local
+
+    HISTORY:
+
+        10/18/26    agent Wrote it.
+
+    DESCRIPTION:
+
+        Helpers for readback of pixel data from framebuffers into runtime arrays or movie
+        frames, as used by Screen('GetImage') and Screen('AddFrameToMovie').
+
+        glReadPixels() returns images bottom-up, with interleaved color channels. Runtimes
+        like Matlab/Octave want column-major arrays with one plane per color channel, whereas
+        Python wants row-major arrays with interleaved channels. The copy-out routines here
+        handle both: The first case by a cache blocked transpose, the second one by a plain
+        vertical flip of rows, which is close to memcpy() speed.
+
+        Asynchronous readback keeps a ring of depth + 1 pixel pack buffers per window: Each
+        call issues a new glReadPixels() into the next free buffer, then maps and returns the
+        result of the readback issued 'depth' calls ago. The GPU thereby gets 'depth' calls,
+        typically 'depth' Screen('Flip')s, worth of time to finish the transfer, and the
+        calling thread doesn't stall on the readback.
+
+        For 'AddFrameToMovie', finished readbacks are instead handed to the movie writer as
+        soon as their fences signal, oldest first, without waiting for unfinished ones. The
+        writer copies the pixels out of the mapped buffer on its own thread, and the buffer is
+        unmapped and reused once the copy is done. Only a readback issued 'depth' calls ago
+        which still isn't finished gets waited for.
+
+*/
+
+#include "Screen.h"
+
+// Edge length in pixels of blocks for the cache blocked transpose into column-major arrays:
+#define PSYCH_READBACK_BLOCKSIZE 64
+
+typedef struct PsychReadbackSlot {
+    GLuint              pbo;            // Pixel pack buffer object receiving the readback.
+    GLsync              fence;          // Fence to signal readback completion, if ARB_sync is supported, 0 otherwise.
+    psych_bool          pending;        // TRUE if readback was issued, but its result not yet consumed.
+    int                 moviehandle;    // Target movie for 'AddFrameToMovie', -1 for 'GetImage'.
+    int                 frameduration;  // Duration of movie frame for 'AddFrameToMovie'.
+    double              captureTime;    // Time of readback issue, for latency statistics of the movie writer.
+    psych_bool          handed;         // TRUE if mapped and handed to the movie writer, until unmapped after copy.
+    psych_bool          copied;         // Set by the movie writer once it has copied the pixels of a handed slot.
+} PsychReadbackSlot;
+
+struct PsychReadbackRing {
+    int                 depth;          // Readback latency in calls. The ring has depth + 1 slots.
+    int                 next;           // Slot to receive the next readback.
+    int                 mapped;         // Slot which is currently mapped for copy-out, -1 if none.
+    int                 width;
+    int                 height;
+    GLenum              format;
+    GLenum              type;
+    size_t              size;           // Size of one readback in bytes.
+    psych_bool          isMovie;        // TRUE if ring is used by 'AddFrameToMovie'.
+    PsychReadbackSlot   slots[PSYCH_MAX_READBACK_DEPTH + 1];
+};
+
+// Copy bottom-up interleaved uint8 pixels with 'srcstride' components per pixel into 'dst',
+// keeping the first 'nrchannels' components of each pixel. Output is top-down in row-major
+// order if 'cLayout' is TRUE, column-major with one plane per channel otherwise:
+void PsychCopyOutReadbackPixelsUInt8(const psych_uint8* src, int srcstride, psych_uint8* dst, size_t width, size_t height, int nrchannels, psych_bool cLayout)
+{
+    size_t ix, iy, bx, by, bxend, byend;
+    size_t rowstride = width * (size_t) srcstride;
+    const psych_uint8 *srcrow, *srccol;
+    psych_uint8 *dstcol;
+    int c;
+
+    if (cLayout) {
+        // Row-major: Only flip vertically and drop unwanted channels:
+        for (iy = 0; iy < height; iy++) {
+            srcrow = src + (height - 1 - iy) * rowstride;
+            if (srcstride == nrchannels) {
+                memcpy(dst, srcrow, rowstride);
+                dst += rowstride;
+            }
+            else {
+                for (ix = 0; ix < width; ix++)
+                    for (c = 0; c < nrchannels; c++)
+                        *(dst++) = srcrow[ix * srcstride + c];
+            }
+        }
+
+        return;
+    }
+
+    // Column-major: Transpose and flip in blocks which fit into the cache, so the strided
+    // reads of one block reuse the same cachelines while destination columns are written
+    // sequentially:
+    for (bx = 0; bx < width; bx += PSYCH_READBACK_BLOCKSIZE) {
+        bxend = (bx + PSYCH_READBACK_BLOCKSIZE < width) ? bx + PSYCH_READBACK_BLOCKSIZE : width;
+        for (by = 0; by < height; by += PSYCH_READBACK_BLOCKSIZE) {
+            byend = (by + PSYCH_READBACK_BLOCKSIZE < height) ? by + PSYCH_READBACK_BLOCKSIZE : height;
+            for (c = 0; c < nrchannels; c++) {
+                for (ix = bx; ix < bxend; ix++) {
+                    dstcol = dst + (size_t) c * width * height + ix * height;
+                    srccol = src + ix * srcstride + c;
+                    for (iy = by; iy < byend; iy++)
+                        dstcol[iy] = srccol[(height - 1 - iy) * rowstride];
+                }
+            }
+        }
+    }
+}
+
+// Same as PsychCopyOutReadbackPixelsUInt8(), but for float pixels into a double array:
+void PsychCopyOutReadbackPixelsFloat(const float* src, int srcstride, double* dst, size_t width, size_t height, int nrchannels, psych_bool cLayout)
+{
+    size_t ix, iy, bx, by, bxend, byend;
+    size_t rowstride = width * (size_t) srcstride;
+    const float *srcrow, *srccol;
+    double *dstcol;
+    int c;
+
+    if (cLayout) {
+        for (iy = 0; iy < height; iy++) {
+            srcrow = src + (height - 1 - iy) * rowstride;
+            for (ix = 0; ix < width; ix++)
+                for (c = 0; c < nrchannels; c++)
+                    *(dst++) = (double) srcrow[ix * srcstride + c];
+        }
+
+        return;
+    }
+
+    for (bx = 0; bx < width; bx += PSYCH_READBACK_BLOCKSIZE) {
+        bxend = (bx + PSYCH_READBACK_BLOCKSIZE < width) ? bx + PSYCH_READBACK_BLOCKSIZE : width;
+        for (by = 0; by < height; by += PSYCH_READBACK_BLOCKSIZE) {
+            byend = (by + PSYCH_READBACK_BLOCKSIZE < height) ? by + PSYCH_READBACK_BLOCKSIZE : height;
+            for (c = 0; c < nrchannels; c++) {
+                for (ix = bx; ix < bxend; ix++) {
+                    dstcol = dst + (size_t) c * width * height + ix * height;
+                    srccol = src + ix * srcstride + c;
+                    for (iy = by; iy < byend; iy++)
+                        dstcol[iy] = (double) srccol[(height - 1 - iy) * rowstride];
+                }
+            }
+        }
+    }
+}
+
+// Flip an image of 'height' rows of 'rowbytes' bytes vertically in place:
+void PsychFlipReadbackRowsInPlace(psych_uint8* pixels, size_t rowbytes, size_t height)
+{
+    psych_uint8 *top, *bottom, *tmp;
+
+    if (height < 2) return;
+
+    tmp = (psych_uint8*) PsychMallocTemp(rowbytes);
+    for (top = pixels, bottom = pixels + (height - 1) * rowbytes; top < bottom; top += rowbytes, bottom -= rowbytes) {
+        memcpy(tmp, top, rowbytes);
+        memcpy(top, bottom, rowbytes);
+        memcpy(bottom, tmp, rowbytes);
+    }
+}
+
+static const void* PsychMapReadbackSlot(PsychReadbackRing *ring, int i)
+{
+    PsychReadbackSlot *slot = &(ring->slots[i]);
+    const void* pixels;
+
+    // Wait for completion of the readback. Mapping would wait as well, but the fence
+    // allows the wait to flush the command stream and does not hold any driver locks:
+    if (slot->fence) {
+        while (glClientWaitSync(slot->fence, GL_SYNC_FLUSH_COMMANDS_BIT, 1000000000) == GL_TIMEOUT_EXPIRED);
+        glDeleteSync(slot->fence);
+        slot->fence = 0;
+    }
+
+    glBindBuffer(GL_PIXEL_PACK_BUFFER, slot->pbo);
+    pixels = glMapBuffer(GL_PIXEL_PACK_BUFFER, GL_READ_ONLY);
+    glBindBuffer(GL_PIXEL_PACK_BUFFER, 0);
+
+    if (NULL == pixels) {
+        slot->pending = FALSE;
+        PsychErrorExitMsg(PsychError_system, "Failed to map pixel buffer of asynchronous readback!");
+    }
+
+    ring->mapped = i;
+
+    return(pixels);
+}
+
+static void PsychUnmapReadbackSlot(PsychReadbackRing *ring)
+{
+    if (ring->mapped < 0) return;
+
+    glBindBuffer(GL_PIXEL_PACK_BUFFER, ring->slots[ring->mapped].pbo);
+    glUnmapBuffer(GL_PIXEL_PACK_BUFFER);
+    glBindBuffer(GL_PIXEL_PACK_BUFFER, 0);
+
+    ring->slots[ring->mapped].pending = FALSE;
+    ring->mapped = -1;
+}
+
+// Check without waiting if the readback of 'slot' is finished:
+static psych_bool PsychReadbackSlotDone(PsychReadbackSlot *slot)
+{
+    GLenum rc;
+
+    // Without fence, the readback is only collected when its slot is needed again:
+    if (!slot->fence) return(FALSE);
+
+    rc = glClientWaitSync(slot->fence, 0, 0);
+    return((rc == GL_ALREADY_SIGNALED) || (rc == GL_CONDITION_SATISFIED));
+}
+
+// Map readback of slot 'i', waiting for it if needed, and hand it to its movie. The movie
+// writer copies the pixels, possibly later on its writer thread, and sets 'copied' then:
+static void PsychHandReadbackSlotToMovie(PsychReadbackRing *ring, int i)
+{
+    PsychReadbackSlot *slot = &(ring->slots[i]);
+    const void* pixels;
+
+    pixels = PsychMapReadbackSlot(ring, i);
+    ring->mapped = -1;
+    slot->handed = TRUE;
+
+    if (PsychQueueVideoFrameToMovie(slot->moviehandle, pixels, slot->frameduration, TRUE, slot->captureTime, &(slot->copied)) != 0) {
+        PsychErrorExitMsg(PsychError_user, "AddFrameToMovie failed with error above!");
+    }
+}
+
+// Unmap handed slot 'i' and mark it free once the movie writer has copied its pixels. Waits
+// for the copy if 'doWait', otherwise returns FALSE if the copy is not done yet:
+static psych_bool PsychReclaimReadbackSlot(PsychReadbackRing *ring, int i, psych_bool doWait)
+{
+    PsychReadbackSlot *slot = &(ring->slots[i]);
+
+    if (!slot->handed) return(TRUE);
+    if (!PsychMovieFrameCopied(slot->moviehandle, &(slot->copied), doWait)) return(FALSE);
+
+    glBindBuffer(GL_PIXEL_PACK_BUFFER, slot->pbo);
+    glUnmapBuffer(GL_PIXEL_PACK_BUFFER);
+    glBindBuffer(GL_PIXEL_PACK_BUFFER, 0);
+
+    slot->handed = FALSE;
+    slot->pending = FALSE;
+
+    return(TRUE);
+}
+
+// Add all pending frames of the ring for movie 'moviehandle', or for all movies if
+// 'moviehandle' is -1, to their movies, oldest frame first, and wait until the movie
+// writer is done with them:
+static void PsychFlushReadbackRing(PsychReadbackRing *ring, int moviehandle)
+{
+    PsychReadbackSlot *slot;
+    int i, n = ring->depth + 1;
+
+    PsychUnmapReadbackSlot(ring);
+
+    // Slots are reused round-robin, so the oldest pending readback is in slot 'next':
+    for (i = 0; i < n; i++) {
+        slot = &(ring->slots[(ring->next + i) % n]);
+        if (!slot->pending || slot->handed || (slot->moviehandle < 0) || ((moviehandle >= 0) && (slot->moviehandle != moviehandle)))
+            continue;
+
+        PsychHandReadbackSlotToMovie(ring, (ring->next + i) % n);
+    }
+
+    for (i = 0; i < n; i++) {
+        if ((moviehandle < 0) || (ring->slots[i].moviehandle == moviehandle))
+            PsychReclaimReadbackSlot(ring, i, TRUE);
+    }
+}
+
+// Delete all OpenGL objects of the ring and the ring itself. Needs the OpenGL context bound:
+static void PsychDestroyReadbackRing(PsychReadbackRing *ring)
+{
+    int i;
+
+    PsychUnmapReadbackSlot(ring);
+
+    for (i = 0; i <= ring->depth; i++) {
+        PsychReclaimReadbackSlot(ring, i, TRUE);
+        if (ring->slots[i].fence) glDeleteSync(ring->slots[i].fence);
+        if (ring->slots[i].pbo) glDeleteBuffers(1, &(ring->slots[i].pbo));
+    }
+
+    free(ring);
+}
+
+// Return the asynchronous readback ring of the window for the given readback parameters,
+// replacing a ring with different parameters:
+static PsychReadbackRing* PsychGetReadbackRing(PsychWindowRecordType *windowRecord, int depth, int width, int height, GLenum format, GLenum type,
+                                               size_t size, psych_bool isMovie)
+{
+    PsychReadbackRing *ring = windowRecord->readbackRing;
+    int i;
+
+    if (PsychIsGLES(windowRecord) || !glewIsSupported("GL_ARB_pixel_buffer_object"))
+        PsychErrorExitMsg(PsychError_unimplemented, "Asynchronous readback not supported, as your graphics driver lacks support for pixel buffer objects.");
+
+    if (depth < 1 || depth > PSYCH_MAX_READBACK_DEPTH) {
+        printf("PTB-ERROR: Invalid asynchronous readback depth %i. Must be between 1 and %i.\n", depth, PSYCH_MAX_READBACK_DEPTH);
+        PsychErrorExitMsg(PsychError_user, "Invalid 'asyncDepth' specified.");
+    }
+
+    if (ring) {
+        // Release pixels of previous call, in case that call got aborted by an error:
+        PsychUnmapReadbackSlot(ring);
+
+        // Readback parameters changed? Retire the old ring. Pending movie frames get added to
+        // their movies, pending 'GetImage' results are discarded. The origin of the readback
+        // rect is not a ring parameter, as each slot just gets read from wherever its call
+        // asked for, so moving the rect keeps pending results:
+        if ((ring->depth != depth) || (ring->width != width) || (ring->height != height) || (ring->format != format) ||
+            (ring->type != type) || (ring->isMovie != isMovie)) {
+            if (ring->isMovie) PsychFlushReadbackRing(ring, -1);
+            windowRecord->readbackRing = NULL;
+            PsychDestroyReadbackRing(ring);
+            ring = NULL;
+        }
+    }
+
+    if (NULL == ring) {
+        ring = (PsychReadbackRing*) calloc(1, sizeof(PsychReadbackRing));
+        if (NULL == ring) PsychErrorExitMsg(PsychError_outofMemory, "Out of memory while trying to setup asynchronous readback!");
+
+        ring->depth = depth;
+        ring->mapped = -1;
+        ring->width = width;
+        ring->height = height;
+        ring->format = format;
+        ring->type = type;
+        ring->size = size;
+        ring->isMovie = isMovie;
+
+        for (i = 0; i <= depth; i++) {
+            glGenBuffers(1, &(ring->slots[i].pbo));
+            glBindBuffer(GL_PIXEL_PACK_BUFFER, ring->slots[i].pbo);
+            glBufferData(GL_PIXEL_PACK_BUFFER, (GLsizeiptr) size, NULL, GL_STREAM_READ);
+        }
+        glBindBuffer(GL_PIXEL_PACK_BUFFER, 0);
+
+        windowRecord->readbackRing = ring;
+
+        if (PsychPrefStateGet_Verbosity() > 4)
+            printf("PTB-DEBUG: Asynchronous readback with depth %i and %i bytes per frame enabled for window %i.\n", depth, (int) size, windowRecord->windowIndex);
+    }
+
+    return(ring);
+}
+
+// Issue readback of the given region of the current read buffer into the next slot of the
+// ring, whose old content must be consumed already:
+static void PsychIssueReadback(PsychReadbackRing *ring, int x, int y, int moviehandle, int frameduration)
+{
+    PsychReadbackSlot *slot = &(ring->slots[ring->next]);
+
+    if (slot->fence) {
+        glDeleteSync(slot->fence);
+        slot->fence = 0;
+    }
+
+    glBindBuffer(GL_PIXEL_PACK_BUFFER, slot->pbo);
+    glReadPixels(x, y, ring->width, ring->height, ring->format, ring->type, NULL);
+    glBindBuffer(GL_PIXEL_PACK_BUFFER, 0);
+    if (glewIsSupported("GL_ARB_sync")) slot->fence = glFenceSync(GL_SYNC_GPU_COMMANDS_COMPLETE, 0);
+
+    // Kick off the transfer now, instead of at the next flip:
+    glFlush();
+
+    slot->pending = TRUE;
+    slot->moviehandle = moviehandle;
+    slot->frameduration = frameduration;
+    PsychGetAdjustedPrecisionTimerSeconds(&(slot->captureTime));
+    ring->next = (ring->next + 1) % (ring->depth + 1);
+}
+
+// Issue asynchronous readback of the given region of the current read buffer, and return
+// a pointer to the pixels of the readback issued 'depth' calls ago, or NULL if there isn't
+// any such readback yet. Returned pixels stay valid until PsychReleaseAsyncReadPixels() or
+// the next call of this function:
+const void* PsychAsyncReadPixels(PsychWindowRecordType *windowRecord, int depth, int x, int y, int width, int height, GLenum format, GLenum type, size_t size)
+{
+    PsychReadbackRing *ring = PsychGetReadbackRing(windowRecord, depth, width, height, format, type, size, FALSE);
+
+    // Issue readback into the next slot, whose old content was consumed 'depth' calls ago:
+    PsychIssueReadback(ring, x, y, -1, 0);
+
+    // The slot after it holds the readback issued 'depth' calls ago, if any:
+    if (!ring->slots[ring->next].pending) return(NULL);
+
+    return(PsychMapReadbackSlot(ring, ring->next));
+}
+
+// Issue asynchronous readback of the given region of the current read buffer for movie
+// 'moviehandle', and hand all finished readbacks to their movie, oldest first:
+void PsychAsyncReadPixelsToMovie(PsychWindowRecordType *windowRecord, int depth, int x, int y, int width, int height, GLenum format, GLenum type,
+                                 size_t size, int moviehandle, int frameduration)
+{
+    PsychReadbackRing *ring = PsychGetReadbackRing(windowRecord, depth, width, height, format, type, size, TRUE);
+    PsychReadbackSlot *slot;
+    int i, n = depth + 1;
+
+    // Reuse buffers whose pixels the movie writer has copied meanwhile:
+    for (i = 0; i < n; i++) PsychReclaimReadbackSlot(ring, i, FALSE);
+
+    // Next slot still holds the readback issued 'depth' calls ago? Hand it over now, even if
+    // that means waiting for the GPU, then wait for the writer to be done with it:
+    slot = &(ring->slots[ring->next]);
+    if (slot->pending && !slot->handed) PsychHandReadbackSlotToMovie(ring, ring->next);
+    PsychReclaimReadbackSlot(ring, ring->next, TRUE);
+
+    PsychIssueReadback(ring, x, y, moviehandle, frameduration);
+
+    // Hand over finished readbacks, oldest first. Stop at the first unfinished one, so frames
+    // stay in order:
+    for (i = 0; i < n; i++) {
+        slot = &(ring->slots[(ring->next + i) % n]);
+        if (!slot->pending || slot->handed) continue;
+        if (!PsychReadbackSlotDone(slot)) break;
+
+        PsychHandReadbackSlotToMovie(ring, (ring->next + i) % n);
+    }
+}
+
+// Release pixels returned by PsychAsyncReadPixels():
+void PsychReleaseAsyncReadPixels(PsychWindowRecordType *windowRecord)
+{
+    if (windowRecord->readbackRing) PsychUnmapReadbackSlot(windowRecord->readbackRing);
+}
+
+// Add all pending asynchronous readbacks for movie 'moviehandle' of all windows to the
+// movie, e.g., before finalizing the movie. -1 does this for all movies:
+void PsychFlushAsyncMovieFrames(int moviehandle)
+{
+    PsychWindowRecordType **windowRecordArray;
+    int i, numWindows;
+
+    PsychCreateVolatileWindowRecordPointerList(&numWindows, &windowRecordArray);
+    for (i = 0; i < numWindows; i++) {
+        if (windowRecordArray[i]->readbackRing && windowRecordArray[i]->readbackRing->isMovie && windowRecordArray[i]->targetSpecific.contextObject) {
+            PsychSetGLContext(windowRecordArray[i]);
+            PsychFlushReadbackRing(windowRecordArray[i]->readbackRing, moviehandle);
+        }
+    }
+    PsychDestroyVolatileWindowRecordPointerList(windowRecordArray);
+}
+
+// Delete the asynchronous readback ring of a window at window close time. Pending movie
+// frames get added to their movies first, pending 'GetImage' results are discarded. Must be
+// called before the windows OpenGL context gets destroyed, so the movie writer copies from
+// valid buffers:
+void PsychDeleteReadbackRing(PsychWindowRecordType *windowRecord)
+{
+    PsychReadbackRing *ring = windowRecord->readbackRing;
+    int i, discarded = 0;
+
+    if (NULL == ring) return;
+    windowRecord->readbackRing = NULL;
+
+    if (windowRecord->targetSpecific.contextObject) {
+        PsychSetGLContext(windowRecord);
+        if (ring->isMovie) PsychFlushReadbackRing(ring, -1);
+        PsychDestroyReadbackRing(ring);
+    }
+    else {
+        // OpenGL context, and with it all buffers, is already gone. This should not happen, as
+        // PsychCloseWindow() deletes the rings of all windows sharing a context before it
+        // destroys the context, so all we can do is to tell about lost frames:
+        for (i = 0; i <= ring->depth; i++) {
+            if (ring->slots[i].pending && !ring->slots[i].handed && (ring->slots[i].moviehandle >= 0)) discarded++;
+
+            // Frames handed to the movie writer are lost as well, but it must be done with them
+            // before the ring goes away, as it reports completion via the ring:
+            if (ring->slots[i].handed) {
+                discarded++;
+                PsychMovieFrameCopied(ring->slots[i].moviehandle, &(ring->slots[i].copied), TRUE);
+            }
+        }
+
+        if ((discarded > 0) && (PsychPrefStateGet_Verbosity() > 1))
+            printf("PTB-WARNING: Discarded %i pending movie frames from asynchronous 'AddFrameToMovie' of already destroyed window %i.\n", discarded, windowRecord->windowIndex);
+
+        free(ring);
+    }
+}
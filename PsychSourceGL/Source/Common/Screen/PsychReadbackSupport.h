@@ -0,0 +1,48 @@
+/*
+    Common/Screen/PsychReadbackSupport.h
+
+    PLATFORMS:
+
+        All.
+
+    AUTHORS:
+
+        agent           agent  agent@local
+
+    HISTORY:
+
+        10/18/26    agent Wrote it.
+
+    DESCRIPTION:
+
+        Helpers for readback of pixel data from framebuffers into runtime arrays or movie
+        frames, as used by Screen('GetImage') and Screen('AddFrameToMovie'): Conversion of
+        OpenGL's bottom-up, interleaved pixel layout into the layout of the returned arrays,
+        and asynchronous readback via a per-window ring of pixel pack buffers.
+
+*/
+
+//include once
+#ifndef PSYCH_IS_INCLUDED_PsychReadbackSupport
+#define PSYCH_IS_INCLUDED_PsychReadbackSupport
+
+#include "Screen.h"
+
+// Maximum number of readbacks which can be in flight per window in asynchronous mode:
+#define PSYCH_MAX_READBACK_DEPTH 16
+
+// Conversion of readback pixels into output arrays:
+void        PsychCopyOutReadbackPixelsUInt8(const psych_uint8* src, int srcstride, psych_uint8* dst, size_t width, size_t height, int nrchannels, psych_bool cLayout);
+void        PsychCopyOutReadbackPixelsFloat(const float* src, int srcstride, double* dst, size_t width, size_t height, int nrchannels, psych_bool cLayout);
+void        PsychFlipReadbackRowsInPlace(psych_uint8* pixels, size_t rowbytes, size_t height);
+
+// Asynchronous readback via ring of pixel pack buffers:
+const void* PsychAsyncReadPixels(PsychWindowRecordType *windowRecord, int depth, int x, int y, int width, int height, GLenum format, GLenum type, size_t size);
+void        PsychAsyncReadPixelsToMovie(PsychWindowRecordType *windowRecord, int depth, int x, int y, int width, int height, GLenum format, GLenum type,
+                                        size_t size, int moviehandle, int frameduration);
+void        PsychReleaseAsyncReadPixels(PsychWindowRecordType *windowRecord);
+void        PsychFlushAsyncMovieFrames(int moviehandle);
+void        PsychDeleteReadbackRing(PsychWindowRecordType *windowRecord);
+
+//end include once
+#endif
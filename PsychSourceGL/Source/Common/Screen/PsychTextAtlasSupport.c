@@ -0,0 +1,548 @@
+/*
+    Common/Screen/PsychTextAtlasSupport.c
+
+    PLATFORMS:
+
+        All.
+
+    AUTHORS:
+
+        agent           agent  agent@local
+
+    HISTORY:
+
+        10/18/26    agent Wrote it.
+
+    DESCRIPTION:
+
+        Glyph atlas text renderer with cache of shaped strings, for 'DrawText' and 'TextBounds'
+        with the FTGL text renderer plugin.
+
+        The plugin draws each string via OGLFT, which measures the string on the cpu, then
+        draws one textured quad per glyph via its own display list, with many state changes
+        and draw calls per string. Scripts which draw many labels per frame are limited by
+        this overhead. Instead, if the plugin exports PsychGetTextGlyph(), Screen keeps one
+        atlas texture per font, ie., per combination of font name, size, style and
+        anti-aliasing setting, into which the rasterized glyph bitmaps of the plugin are
+        packed on first use. A string is shaped once into glyph quads with its bounding box
+        and advance, including kerning if the plugin exports PsychGetTextKerning(). Shaped
+        strings are cached per font, keyed by their unicode characters, so 'TextBounds' and
+        repeated 'DrawText' of the same string don't need to call into the plugin at all.
+        Drawing a string is a single glDrawArrays() call via the streaming vertex buffer.
+
+        Each onscreen window, ie., each OpenGL context, has its own atlas with up to
+        PSYCH_TEXT_ATLAS_MAXFONTS fonts and PSYCH_TEXT_ATLAS_MAXSTRINGS shaped strings per
+        font, both replaced in least recently used order. A font whose atlas texture is full
+        gets reset to empty. The atlas is only used on desktop OpenGL with an identity text
+        transform matrix. It can be disabled by setting the environment variable
+        PSYCH_TEXT_ATLAS=0, in which case the plugin draws all text as before.
+
+*/
+
+#include "Screen.h"
+
+#define PSYCH_TEXT_ATLAS_MAXFONTS       16
+#define PSYCH_TEXT_ATLAS_MAXSTRINGS     1024
+#define PSYCH_TEXT_ATLAS_BUCKETS        1024
+
+// Optional functions of the text renderer plugin, bound in SCREENDrawText.c:
+extern int (*PsychPluginGetTextGlyph)(int context, unsigned int charCode, float* xmin, float* ymin, float* xmax, float* ymax, float* xadvance,
+                                      int* left, int* top, int* width, int* height, const unsigned char** bitmap);
+extern int (*PsychPluginGetTextKerning)(int context, unsigned int leftCharCode, unsigned int rightCharCode, float* xkerning);
+extern void (*PsychPluginGetTextCursor)(int context, double* xp, double* yp, double* height);
+
+typedef struct PsychAtlasGlyph {
+    unsigned int            code;           // Unicode character.
+    psych_bool              used;           // TRUE if this slot of the glyph table is used.
+    float                   bbox[4];        // xmin, ymin, xmax, ymax relative to pen, y up, as from PsychPluginMeasureText().
+    float                   advance;
+    float                   quad[8];        // x0, y0, x1, y1 of bitmap relative to pen, y down, and s0, t0, s1, t1 in atlas. Empty if x0 == x1.
+} PsychAtlasGlyph;
+
+struct PsychShapedText {
+    struct PsychShapedText* hashNext;       // Next string in same hash bucket.
+    struct PsychShapedText* prev;           // Next more recently used string.
+    struct PsychShapedText* next;           // Next less recently used string.
+    unsigned int            hash;
+    int                     textLen;
+    unsigned int*           text;           // Unicode characters of the string.
+    int                     nrQuads;
+    float*                  quads;          // nrQuads glyph quads, as in PsychAtlasGlyph.
+    float                   bbox[4];
+    float                   advance;
+    struct PsychAtlasFont*  font;
+};
+
+typedef struct PsychAtlasFont {
+    char                    fontName[256];
+    int                     fontSize;
+    int                     fontStyle;
+    int                     antiAliasing;
+    double                  lineHeight;
+    unsigned int            timestamp;      // Time of last use for LRU replacement.
+    GLuint                  texture;        // GL_TEXTURE_2D alpha texture of size x size texels.
+    int                     size;
+    int                     shelfX;         // Next free position in current shelf of packed glyphs.
+    int                     shelfY;
+    int                     shelfHeight;
+    PsychAtlasGlyph*        glyphs;         // Open addressing hash table of glyphCapacity slots, a power of two.
+    int                     glyphCapacity;
+    int                     glyphCount;
+    PsychShapedText*        buckets[PSYCH_TEXT_ATLAS_BUCKETS];
+    PsychShapedText*        head;           // Most recently used string.
+    PsychShapedText*        tail;           // Least recently used string, first to be evicted.
+    int                     stringCount;
+} PsychAtlasFont;
+
+struct PsychTextAtlas {
+    PsychAtlasFont*         fonts[PSYCH_TEXT_ATLAS_MAXFONTS];
+    int                     nrFonts;
+    unsigned int            now;
+    unsigned int            hits;
+    unsigned int            misses;
+    unsigned int            resets;
+};
+
+static int textAtlasEnabled = -1;
+
+// Return the atlas of the OpenGL context of 'win', or NULL if text of 'win' can't be drawn via an atlas:
+static PsychTextAtlas* PsychGetTextAtlas(PsychWindowRecordType *win)
+{
+    PsychWindowRecordType *parentRecord;
+
+    if (textAtlasEnabled < 0) {
+        textAtlasEnabled = (getenv("PSYCH_TEXT_ATLAS") && (atoi(getenv("PSYCH_TEXT_ATLAS")) == 0)) ? 0 : 1;
+        if ((PsychPrefStateGet_Verbosity() > 4) && !textAtlasEnabled) printf("PTB-DEBUG: Glyph atlas text renderer disabled.\n");
+    }
+
+    if (!textAtlasEnabled || (NULL == PsychPluginGetTextGlyph) || !PsychIsGLClassic(win)) return(NULL);
+
+    // Only plain 2D text, as glyph bitmaps are not rasterized for transformed text:
+    if (win->text2DMatrix[0][0] != 1 || win->text2DMatrix[1][1] != 1 || win->text2DMatrix[1][0] != 0 ||
+        win->text2DMatrix[0][1] != 0 || win->text2DMatrix[0][2] != 0 || win->text2DMatrix[1][2] != 0)
+        return(NULL);
+
+    parentRecord = PsychGetParentWindow(win);
+    if (!PsychIsOnscreenWindow(parentRecord) || (parentRecord->targetSpecific.contextObject == NULL) ||
+        (parentRecord->targetSpecific.contextObject != win->targetSpecific.contextObject))
+        return(NULL);
+
+    if (NULL == parentRecord->textAtlas) parentRecord->textAtlas = (PsychTextAtlas*) calloc(1, sizeof(PsychTextAtlas));
+
+    return(parentRecord->textAtlas);
+}
+
+// Clear atlas texture of 'font' to zero, so the gaps between packed glyphs are transparent:
+static void PsychClearAtlasTexture(PsychAtlasFont *font)
+{
+    unsigned char *zeros = (unsigned char*) calloc(1, (size_t) font->size * (size_t) font->size);
+
+    glBindTexture(GL_TEXTURE_2D, font->texture);
+    glPushClientAttrib(GL_CLIENT_PIXEL_STORE_BIT);
+    glPixelStorei(GL_UNPACK_ALIGNMENT, 1);
+    glPixelStorei(GL_UNPACK_ROW_LENGTH, 0);
+    glTexImage2D(GL_TEXTURE_2D, 0, GL_ALPHA8, font->size, font->size, 0, GL_ALPHA, GL_UNSIGNED_BYTE, zeros);
+    glPopClientAttrib();
+    glBindTexture(GL_TEXTURE_2D, 0);
+
+    free(zeros);
+}
+
+static void PsychDeleteShapedText(PsychShapedText *shaped)
+{
+    free(shaped->text);
+    free(shaped->quads);
+    free(shaped);
+}
+
+static void PsychDeleteShapedTexts(PsychAtlasFont *font)
+{
+    PsychShapedText *shaped;
+
+    while ((shaped = font->head)) {
+        font->head = shaped->next;
+        PsychDeleteShapedText(shaped);
+    }
+
+    memset(font->buckets, 0, sizeof(font->buckets));
+    font->tail = NULL;
+    font->stringCount = 0;
+}
+
+// Forget all glyphs and shaped strings of 'font', and clear its atlas texture:
+static void PsychResetAtlasFont(PsychAtlasFont *font)
+{
+    PsychDeleteShapedTexts(font);
+
+    memset(font->glyphs, 0, sizeof(PsychAtlasGlyph) * font->glyphCapacity);
+    font->glyphCount = 0;
+
+    font->shelfX = 1;
+    font->shelfY = 1;
+    font->shelfHeight = 0;
+
+    PsychClearAtlasTexture(font);
+}
+
+static void PsychDeleteAtlasFont(PsychAtlasFont *font)
+{
+    PsychDeleteShapedTexts(font);
+    glDeleteTextures(1, &font->texture);
+    free(font->glyphs);
+    free(font);
+}
+
+// Return the font of 'atlas' for the current font settings of 'win', creating it if needed:
+static PsychAtlasFont* PsychGetAtlasFont(PsychTextAtlas *atlas, PsychWindowRecordType *win, int ctx)
+{
+    PsychAtlasFont *font;
+    double dummy;
+    GLint maxsize;
+    int i, slot, antiAliasing;
+
+    antiAliasing = (PsychPrefStateGet_TextAntiAliasing() != 0) ? 1 : 0;
+    atlas->now++;
+
+    for (i = 0; i < atlas->nrFonts; i++) {
+        font = atlas->fonts[i];
+        if ((font->fontSize == win->textAttributes.textSize) && (font->fontStyle == win->textAttributes.textStyle) &&
+            (font->antiAliasing == antiAliasing) && !strcmp(font->fontName, (const char*) win->textAttributes.textFontName)) {
+            font->timestamp = atlas->now;
+            return(font);
+        }
+    }
+
+    // New font. Replace the least recently used one if the atlas is full:
+    if (atlas->nrFonts < PSYCH_TEXT_ATLAS_MAXFONTS) {
+        slot = atlas->nrFonts++;
+    }
+    else {
+        for (i = 1, slot = 0; i < atlas->nrFonts; i++) if (atlas->fonts[i]->timestamp < atlas->fonts[slot]->timestamp) slot = i;
+        PsychDeleteAtlasFont(atlas->fonts[slot]);
+    }
+
+    font = (PsychAtlasFont*) calloc(1, sizeof(PsychAtlasFont));
+    atlas->fonts[slot] = font;
+
+    snprintf(font->fontName, sizeof(font->fontName), "%s", (const char*) win->textAttributes.textFontName);
+    font->fontSize = win->textAttributes.textSize;
+    font->fontStyle = win->textAttributes.textStyle;
+    font->antiAliasing = antiAliasing;
+    font->timestamp = atlas->now;
+    if (PsychPluginGetTextCursor) PsychPluginGetTextCursor(ctx, &dummy, &dummy, &font->lineHeight);
+
+    // Atlas size by font size, so typical character sets fit without resets:
+    font->size = (font->fontSize <= 32) ? 512 : ((font->fontSize <= 64) ? 1024 : ((font->fontSize <= 128) ? 2048 : 4096));
+    glGetIntegerv(GL_MAX_TEXTURE_SIZE, &maxsize);
+    if (font->size > maxsize) font->size = maxsize;
+
+    font->glyphCapacity = 256;
+    font->glyphs = (PsychAtlasGlyph*) calloc(font->glyphCapacity, sizeof(PsychAtlasGlyph));
+
+    glGenTextures(1, &font->texture);
+    glBindTexture(GL_TEXTURE_2D, font->texture);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_NEAREST);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_NEAREST);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
+    glBindTexture(GL_TEXTURE_2D, 0);
+
+    PsychResetAtlasFont(font);
+
+    if (PsychPrefStateGet_Verbosity() > 5) printf("PTB-DEBUG: New %i x %i glyph atlas for font '%s', size %i, style %i.\n", font->size, font->size, font->fontName, font->fontSize, font->fontStyle);
+
+    return(font);
+}
+
+static PsychAtlasGlyph* PsychFindAtlasGlyph(PsychAtlasFont *font, unsigned int code)
+{
+    unsigned int i = (code * 2654435761U) & (unsigned int) (font->glyphCapacity - 1);
+
+    while (font->glyphs[i].used && (font->glyphs[i].code != code)) i = (i + 1) & (unsigned int) (font->glyphCapacity - 1);
+
+    return(&(font->glyphs[i]));
+}
+
+// Get glyph for character 'code' of 'font', rasterizing and packing it into the atlas on first use.
+// Returns 0 on success, 1 if the plugin failed, 2 if the atlas is full:
+static int PsychGetAtlasGlyph(PsychAtlasFont *font, int ctx, unsigned int code, PsychAtlasGlyph **glyph)
+{
+    PsychAtlasGlyph *g, *oldglyphs;
+    const unsigned char *bitmap;
+    int left, top, width, height, i, oldcapacity;
+
+    g = PsychFindAtlasGlyph(font, code);
+    if (g->used) {
+        *glyph = g;
+        return(0);
+    }
+
+    // Grow hash table at half load:
+    if (2 * (font->glyphCount + 1) > font->glyphCapacity) {
+        oldglyphs = font->glyphs;
+        oldcapacity = font->glyphCapacity;
+        font->glyphCapacity *= 2;
+        font->glyphs = (PsychAtlasGlyph*) calloc(font->glyphCapacity, sizeof(PsychAtlasGlyph));
+        for (i = 0; i < oldcapacity; i++) if (oldglyphs[i].used) *PsychFindAtlasGlyph(font, oldglyphs[i].code) = oldglyphs[i];
+        free(oldglyphs);
+        g = PsychFindAtlasGlyph(font, code);
+    }
+
+    memset(g, 0, sizeof(PsychAtlasGlyph));
+    if (PsychPluginGetTextGlyph(ctx, code, &g->bbox[0], &g->bbox[1], &g->bbox[2], &g->bbox[3], &g->advance, &left, &top, &width, &height, &bitmap))
+        return(1);
+
+    if (bitmap && (width > 0) && (height > 0)) {
+        // Shelf packing with a gap of one texel between glyphs:
+        if (font->shelfX + width + 1 > font->size) {
+            font->shelfY += font->shelfHeight + 1;
+            font->shelfX = 1;
+            font->shelfHeight = 0;
+        }
+
+        if ((width + 2 > font->size) || (font->shelfY + height + 1 > font->size)) return(2);
+
+        glBindTexture(GL_TEXTURE_2D, font->texture);
+        glPushClientAttrib(GL_CLIENT_PIXEL_STORE_BIT);
+        glPixelStorei(GL_UNPACK_ALIGNMENT, 1);
+        glPixelStorei(GL_UNPACK_ROW_LENGTH, 0);
+        glTexSubImage2D(GL_TEXTURE_2D, 0, font->shelfX, font->shelfY, width, height, GL_ALPHA, GL_UNSIGNED_BYTE, bitmap);
+        glPopClientAttrib();
+        glBindTexture(GL_TEXTURE_2D, 0);
+
+        g->quad[0] = (float) left;
+        g->quad[1] = (float) -top;
+        g->quad[2] = (float) (left + width);
+        g->quad[3] = (float) (height - top);
+        g->quad[4] = (float) font->shelfX / (float) font->size;
+        g->quad[5] = (float) font->shelfY / (float) font->size;
+        g->quad[6] = (float) (font->shelfX + width) / (float) font->size;
+        g->quad[7] = (float) (font->shelfY + height) / (float) font->size;
+
+        font->shelfX += width + 1;
+        if (height > font->shelfHeight) font->shelfHeight = height;
+    }
+
+    g->code = code;
+    g->used = TRUE;
+    font->glyphCount++;
+    *glyph = g;
+
+    return(0);
+}
+
+// Shape string 'text' with glyphs of 'font', with the same bounding box and advance as OGLFT's
+// measurement, plus kerning. Returns 0 on success, or the error of PsychGetAtlasGlyph():
+static int PsychShapeAtlasString(PsychAtlasFont *font, int ctx, int textLen, double *text, unsigned int hash, PsychShapedText **result)
+{
+    PsychShapedText *shaped;
+    PsychAtlasGlyph *g;
+    float pen, kerning;
+    int i, rc;
+
+    shaped = (PsychShapedText*) calloc(1, sizeof(PsychShapedText));
+    shaped->text = (unsigned int*) malloc(sizeof(unsigned int) * (textLen + 1));
+    shaped->quads = (float*) malloc(sizeof(float) * 8 * (textLen + 1));
+    shaped->textLen = textLen;
+    shaped->hash = hash;
+    shaped->font = font;
+
+    for (i = 0; i < textLen; i++) {
+        shaped->text[i] = (unsigned int) text[i];
+        if ((rc = PsychGetAtlasGlyph(font, ctx, shaped->text[i], &g))) {
+            PsychDeleteShapedText(shaped);
+            return(rc);
+        }
+
+        if (i == 0) {
+            pen = 0;
+            memcpy(shaped->bbox, g->bbox, sizeof(shaped->bbox));
+        }
+        else {
+            kerning = 0;
+            if (PsychPluginGetTextKerning) PsychPluginGetTextKerning(ctx, shaped->text[i - 1], shaped->text[i], &kerning);
+            pen = shaped->advance + kerning;
+
+            if (g->bbox[0] + pen < shaped->bbox[0]) shaped->bbox[0] = g->bbox[0] + pen;
+            if (g->bbox[1] < shaped->bbox[1]) shaped->bbox[1] = g->bbox[1];
+            if (g->bbox[2] + pen > shaped->bbox[2]) shaped->bbox[2] = g->bbox[2] + pen;
+            if (g->bbox[3] > shaped->bbox[3]) shaped->bbox[3] = g->bbox[3];
+        }
+
+        shaped->advance = pen + g->advance;
+
+        if (g->quad[0] != g->quad[2]) {
+            memcpy(&(shaped->quads[shaped->nrQuads * 8]), g->quad, sizeof(g->quad));
+            shaped->quads[shaped->nrQuads * 8 + 0] += pen;
+            shaped->quads[shaped->nrQuads * 8 + 2] += pen;
+            shaped->nrQuads++;
+        }
+    }
+
+    *result = shaped;
+    return(0);
+}
+
+// Shape string 'text' for the current font settings of 'windowRecord', with its bounding box,
+// advance and the line height of the font, as PsychPluginMeasureText() and PsychPluginGetTextCursor()
+// would return them. Returns NULL if the string can't be drawn via the atlas, in which case the
+// plugin has to do it. The result is valid until the next call. Needs the OpenGL context bound:
+PsychShapedText* PsychShapeTextWithAtlas(PsychWindowRecordType *windowRecord, int ctx, int textLen, double *text, float *xmin, float *ymin,
+                                         float *xmax, float *ymax, float *xadvance, double *lineHeight)
+{
+    PsychTextAtlas *atlas;
+    PsychAtlasFont *font;
+    PsychShapedText *shaped, *victim, **link;
+    unsigned int hash;
+    int i, rc;
+
+    if (NULL == (atlas = PsychGetTextAtlas(windowRecord))) return(NULL);
+    font = PsychGetAtlasFont(atlas, windowRecord, ctx);
+
+    // FNV-1a hash of the unicode characters:
+    for (i = 0, hash = 2166136261U; i < textLen; i++) hash = (hash ^ (unsigned int) text[i]) * 16777619U;
+
+    for (shaped = font->buckets[hash % PSYCH_TEXT_ATLAS_BUCKETS]; shaped; shaped = shaped->hashNext) {
+        if ((shaped->hash != hash) || (shaped->textLen != textLen)) continue;
+        for (i = 0; (i < textLen) && (shaped->text[i] == (unsigned int) text[i]); i++);
+        if (i == textLen) break;
+    }
+
+    if (shaped) {
+        atlas->hits++;
+
+        // Move to front of LRU list:
+        if (shaped->prev) {
+            shaped->prev->next = shaped->next;
+            if (shaped->next) shaped->next->prev = shaped->prev; else font->tail = shaped->prev;
+            shaped->prev = NULL;
+            shaped->next = font->head;
+            font->head->prev = shaped;
+            font->head = shaped;
+        }
+    }
+    else {
+        atlas->misses++;
+
+        // Atlas texture full? Start over with an empty atlas and retry once:
+        rc = PsychShapeAtlasString(font, ctx, textLen, text, hash, &shaped);
+        if (rc == 2) {
+            if (PsychPrefStateGet_Verbosity() > 5) printf("PTB-DEBUG: Glyph atlas for font '%s', size %i full. Resetting it.\n", font->fontName, font->fontSize);
+            atlas->resets++;
+            PsychResetAtlasFont(font);
+            rc = PsychShapeAtlasString(font, ctx, textLen, text, hash, &shaped);
+        }
+
+        if (rc) return(NULL);
+
+        shaped->hashNext = font->buckets[hash % PSYCH_TEXT_ATLAS_BUCKETS];
+        font->buckets[hash % PSYCH_TEXT_ATLAS_BUCKETS] = shaped;
+        shaped->next = font->head;
+        if (font->head) font->head->prev = shaped; else font->tail = shaped;
+        font->head = shaped;
+
+        // Evict least recently used string if the cache is full:
+        if (++font->stringCount > PSYCH_TEXT_ATLAS_MAXSTRINGS) {
+            victim = font->tail;
+            font->tail = victim->prev;
+            font->tail->next = NULL;
+            for (link = &(font->buckets[victim->hash % PSYCH_TEXT_ATLAS_BUCKETS]); *link != victim; link = &((*link)->hashNext));
+            *link = victim->hashNext;
+            PsychDeleteShapedText(victim);
+            font->stringCount--;
+        }
+    }
+
+    *xmin = shaped->bbox[0];
+    *ymin = shaped->bbox[1];
+    *xmax = shaped->bbox[2];
+    *ymax = shaped->bbox[3];
+    *xadvance = shaped->advance;
+    *lineHeight = font->lineHeight;
+
+    return(shaped);
+}
+
+// Draw 'shaped' string with pen start position (x,y) on the baseline in color 'fgcolor', on a bounding box
+// background of color 'bgcolor' if its alpha is greater zero. Needs the drawing target of 'windowRecord'
+// active, with the same state setup as for PsychPluginDrawText():
+void PsychDrawShapedText(PsychWindowRecordType *windowRecord, PsychShapedText *shaped, double x, double y, double *fgcolor, double *bgcolor)
+{
+    static const int quadCorners[6][2] = { {0, 1}, {2, 1}, {0, 3}, {2, 1}, {2, 3}, {0, 3} };
+    float *vertices, *v, *q;
+    psych_bool streamed;
+    int i, j, nrvertices;
+
+    if (bgcolor[3] > 0) {
+        glColor4dv(bgcolor);
+        glRectd(x + shaped->bbox[0], y - shaped->bbox[3], x + shaped->bbox[2], y - shaped->bbox[1]);
+    }
+
+    if (shaped->nrQuads == 0) return;
+
+    // Two triangles per glyph, with position and atlas texture coordinates per vertex:
+    nrvertices = 6 * shaped->nrQuads;
+    vertices = PsychMapVertexStream(windowRecord, nrvertices, kPsychVertexStreamTexCoords);
+    streamed = (vertices) ? TRUE : FALSE;
+    if (!streamed) vertices = (float*) PsychMallocTemp(sizeof(float) * 4 * nrvertices);
+
+    for (i = 0, v = vertices; i < shaped->nrQuads; i++) {
+        q = &(shaped->quads[i * 8]);
+        for (j = 0; j < 6; j++) {
+            *(v++) = (float) x + q[quadCorners[j][0]];
+            *(v++) = (float) y + q[quadCorners[j][1]];
+            *(v++) = q[quadCorners[j][0] + 4];
+            *(v++) = q[quadCorners[j][1] + 4];
+        }
+    }
+
+    glColor4dv(fgcolor);
+    glDisable(GL_TEXTURE_RECTANGLE_EXT);
+    glEnable(GL_TEXTURE_2D);
+    glBindTexture(GL_TEXTURE_2D, shaped->font->texture);
+    glTexEnvi(GL_TEXTURE_ENV, GL_TEXTURE_ENV_MODE, GL_MODULATE);
+
+    // Discard non-text pixels with alpha zero, as the plugin does:
+    glEnable(GL_ALPHA_TEST);
+    glAlphaFunc(GL_GREATER, 0);
+
+    if (streamed) {
+        PsychEnableVertexStream(windowRecord);
+        glDrawArrays(GL_TRIANGLES, 0, nrvertices);
+        PsychDisableVertexStream(windowRecord);
+    }
+    else {
+        glVertexPointer(2, GL_FLOAT, 4 * sizeof(float), vertices);
+        glTexCoordPointer(2, GL_FLOAT, 4 * sizeof(float), vertices + 2);
+        glEnableClientState(GL_VERTEX_ARRAY);
+        glEnableClientState(GL_TEXTURE_COORD_ARRAY);
+        glDrawArrays(GL_TRIANGLES, 0, nrvertices);
+        glDisableClientState(GL_TEXTURE_COORD_ARRAY);
+        glDisableClientState(GL_VERTEX_ARRAY);
+        glVertexPointer(2, GL_FLOAT, 0, NULL);
+        glTexCoordPointer(2, GL_FLOAT, 0, NULL);
+    }
+
+    glDisable(GL_ALPHA_TEST);
+    glBindTexture(GL_TEXTURE_2D, 0);
+    glDisable(GL_TEXTURE_2D);
+}
+
+// Delete the text atlas of an onscreen window with all its fonts and shaped strings. Called at
+// window close time, with the OpenGL context of the window bound:
+void PsychDeleteTextAtlas(PsychWindowRecordType *windowRecord)
+{
+    PsychTextAtlas *atlas = windowRecord->textAtlas;
+    int i;
+
+    if (NULL == atlas) return;
+    windowRecord->textAtlas = NULL;
+
+    if (PsychPrefStateGet_Verbosity() > 4) {
+        printf("PTB-DEBUG: Glyph atlas of window %i: %i fonts, %i cached and %i newly shaped strings, %i atlas resets.\n",
+               windowRecord->windowIndex, atlas->nrFonts, atlas->hits, atlas->misses, atlas->resets);
+    }
+
+    for (i = 0; i < atlas->nrFonts; i++) PsychDeleteAtlasFont(atlas->fonts[i]);
+    free(atlas);
+}
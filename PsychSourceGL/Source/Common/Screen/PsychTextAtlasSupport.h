@@ -0,0 +1,38 @@
+/*
+    Common/Screen/PsychTextAtlasSupport.h
+
+    PLATFORMS:
+
+        All.
+
+    AUTHORS:
+
+        agent           agent  agent@local
+
+    HISTORY:
+
+        10/18/26    agent Wrote it.
+
+    DESCRIPTION:
+
+        Glyph atlas text renderer with cache of shaped strings, for 'DrawText' and 'TextBounds'
+        with the FTGL text renderer plugin.
+
+*/
+
+//include once
+#ifndef PSYCH_IS_INCLUDED_PsychTextAtlasSupport
+#define PSYCH_IS_INCLUDED_PsychTextAtlasSupport
+
+#include "Screen.h"
+
+// Opaque string of glyph quads, as returned by PsychShapeTextWithAtlas():
+typedef struct PsychShapedText PsychShapedText;
+
+PsychShapedText*    PsychShapeTextWithAtlas(PsychWindowRecordType *windowRecord, int ctx, int textLen, double *text, float *xmin, float *ymin,
+                                            float *xmax, float *ymax, float *xadvance, double *lineHeight);
+void                PsychDrawShapedText(PsychWindowRecordType *windowRecord, PsychShapedText *shaped, double x, double y, double *fgcolor, double *bgcolor);
+void                PsychDeleteTextAtlas(PsychWindowRecordType *windowRecord);
+
+//end include once
+#endif
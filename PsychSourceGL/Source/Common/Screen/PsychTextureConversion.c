@@ -0,0 +1,563 @@
+/*
+    Common/Screen/PsychTextureConversion.c
+
+    PLATFORMS:
+
+        All.
+
+    AUTHORS:
+
+        agent           agent  agent@local
+
+    HISTORY:
+
+        10/18/26    agent Wrote it.
+
+    DESCRIPTION:
+
+        Conversion of planar image matrices from the runtime into interleaved pixel buffers
+        for texture upload, as used by Screen('MakeTexture').
+
+        Input matrices are planar, one plane of npixels elements per color channel, of type
+        uint8, uint16, single or double. Output is interleaved, with nplanes components per
+        pixel, either as 8 bpc GLubyte or as GLfloat. On x86-64, conversion and interleaving are
+        done with SSE2 in registers, reading all planes concurrently. Other processors and the
+        last few pixels of an image use plain C loops.
+
+        Images with more than kPsychMinParallelElements elements are split into contiguous
+        slices, which are processed in parallel by a pool of worker threads and the calling
+        thread. The pool is created on first use, with one thread per processor core, up to
+        PSYCH_MAX_CONVERSION_THREADS threads. The environment variable
+        PSYCH_CONVERSION_THREADS overrides the number of threads, a setting of 1 disables
+        multi-threading.
+
+*/
+
+#include "Screen.h"
+
+// Minimum number of elements of an image for multi-threaded conversion. Smaller images
+// are converted faster than worker threads could be woken up:
+#define kPsychMinParallelElements (512 * 1024)
+
+// SSE2 is part of every x86-64 processor. Other processors use the scalar code:
+#if defined(__SSE2__) || defined(_M_X64)
+#include <emmintrin.h>
+#define PSYCH_HAVE_SSE2 1
+#else
+#define PSYCH_HAVE_SSE2 0
+#endif
+
+typedef struct PsychConversionJob {
+    const void*         src;
+    PsychArgFormatType  srctype;
+    size_t              npixels;
+    int                 nplanes;
+    int                 order[4];
+    void*               dst;
+    psych_bool          dstfloat;
+    double              scale;
+    double              offset;
+    int                 nslices;
+} PsychConversionJob;
+
+typedef struct PsychConversionWorker {
+    psych_thread        thread;
+    int                 slice;
+    unsigned int        generation;     // Last job generation seen by this worker.
+} PsychConversionWorker;
+
+static PsychConversionWorker    workers[PSYCH_MAX_CONVERSION_THREADS];
+static int                      numThreads = 0;     // Number of threads incl. caller, 0 = Pool not yet initialized.
+static psych_mutex              poolMutex;
+static psych_mutex              submitMutex;        // Held by the thread which currently uses the pool.
+static psych_condition          jobCondition;
+static psych_condition          doneCondition;
+static PsychConversionJob       currentJob;
+static unsigned int             jobGeneration = 0;
+static int                      jobsPending = 0;
+static psych_bool               poolShutdown = FALSE;
+
+// Element conversions of the plain C code. Double and single precision inputs map to uint8
+// like before, with the truncating cast after scaling and offset. Integer inputs are
+// normalized to the range 0 - 1:
+#define PSYCH_CONV_COPY(v)          (v)
+#define PSYCH_CONV_REAL_TO_UINT8(v) ((GLubyte) (offset + scale * (double) (v)))
+#define PSYCH_CONV_U16_TO_UINT8(v)  ((GLubyte) (((unsigned int) (v) * 255 + 32767) / 65535))
+#define PSYCH_CONV_REAL_TO_FLOAT(v) ((GLfloat) (v))
+#define PSYCH_CONV_U8_TO_FLOAT(v)   ((GLfloat) (v) * (1.0f / 255.0f))
+#define PSYCH_CONV_U16_TO_FLOAT(v)  ((GLfloat) (v) * (1.0f / 65535.0f))
+
+// Convert pixels [start, start + count) of job. Each PSYCH_CONVERT_PLANES() instance
+// expands into one loop per number of planes:
+#define PSYCH_CONVERT_PLANES(stype, dtype, CONV) {                                              \
+    const stype *p0, *p1 = NULL, *p2 = NULL, *p3 = NULL;                                        \
+    dtype *d = (dtype*) job->dst + start * (size_t) job->nplanes;                               \
+    p0 = (const stype*) job->src + (size_t) job->order[0] * job->npixels + start;               \
+    if (job->nplanes > 1) p1 = (const stype*) job->src + (size_t) job->order[1] * job->npixels + start; \
+    if (job->nplanes > 2) p2 = (const stype*) job->src + (size_t) job->order[2] * job->npixels + start; \
+    if (job->nplanes > 3) p3 = (const stype*) job->src + (size_t) job->order[3] * job->npixels + start; \
+    switch (job->nplanes) {                                                                     \
+        case 1:                                                                                 \
+            for (i = 0; i < count; i++) d[i] = CONV(p0[i]);                                     \
+            break;                                                                              \
+        case 2:                                                                                 \
+            for (i = 0; i < count; i++) {                                                       \
+                d[2 * i + 0] = CONV(p0[i]);                                                     \
+                d[2 * i + 1] = CONV(p1[i]);                                                     \
+            }                                                                                   \
+            break;                                                                              \
+        case 3:                                                                                 \
+            for (i = 0; i < count; i++) {                                                       \
+                d[3 * i + 0] = CONV(p0[i]);                                                     \
+                d[3 * i + 1] = CONV(p1[i]);                                                     \
+                d[3 * i + 2] = CONV(p2[i]);                                                     \
+            }                                                                                   \
+            break;                                                                              \
+        case 4:                                                                                 \
+            for (i = 0; i < count; i++) {                                                       \
+                d[4 * i + 0] = CONV(p0[i]);                                                     \
+                d[4 * i + 1] = CONV(p1[i]);                                                     \
+                d[4 * i + 2] = CONV(p2[i]);                                                     \
+                d[4 * i + 3] = CONV(p3[i]);                                                     \
+            }                                                                                   \
+            break;                                                                              \
+    }                                                                                           \
+}
+
+static void PsychConvertTexturePlanesScalar(const PsychConversionJob *job, size_t start, size_t count)
+{
+    const double scale = job->scale;
+    const double offset = job->offset;
+    size_t i;
+
+    if (!job->dstfloat) {
+        switch (job->srctype) {
+            case PsychArgType_uint8:
+                if (job->nplanes == 1) {
+                    memcpy((GLubyte*) job->dst + start, (const psych_uint8*) job->src + start, count);
+                    break;
+                }
+                PSYCH_CONVERT_PLANES(psych_uint8, GLubyte, PSYCH_CONV_COPY);
+                break;
+
+            case PsychArgType_uint16:
+                PSYCH_CONVERT_PLANES(psych_uint16, GLubyte, PSYCH_CONV_U16_TO_UINT8);
+                break;
+
+            case PsychArgType_single:
+                PSYCH_CONVERT_PLANES(float, GLubyte, PSYCH_CONV_REAL_TO_UINT8);
+                break;
+
+            default:
+                PSYCH_CONVERT_PLANES(double, GLubyte, PSYCH_CONV_REAL_TO_UINT8);
+                break;
+        }
+    }
+    else {
+        switch (job->srctype) {
+            case PsychArgType_uint8:
+                PSYCH_CONVERT_PLANES(psych_uint8, GLfloat, PSYCH_CONV_U8_TO_FLOAT);
+                break;
+
+            case PsychArgType_uint16:
+                PSYCH_CONVERT_PLANES(psych_uint16, GLfloat, PSYCH_CONV_U16_TO_FLOAT);
+                break;
+
+            case PsychArgType_single:
+                if (job->nplanes == 1) {
+                    memcpy((GLfloat*) job->dst + start, (const float*) job->src + start, count * sizeof(GLfloat));
+                    break;
+                }
+                PSYCH_CONVERT_PLANES(float, GLfloat, PSYCH_CONV_REAL_TO_FLOAT);
+                break;
+
+            default:
+                PSYCH_CONVERT_PLANES(double, GLfloat, PSYCH_CONV_REAL_TO_FLOAT);
+                break;
+        }
+    }
+}
+
+#if PSYCH_HAVE_SSE2
+// Convert 2 x 4 doubles to 8 uint8 in the low half of the result. Truncation to int32 and
+// masking to the low byte is exactly what the (GLubyte) cast of the plain C code does:
+static inline __m128i PsychPackRealToUInt8(__m128d a, __m128d b, __m128d c, __m128d d, __m128d vs, __m128d vo)
+{
+    const __m128i mask = _mm_set1_epi32(0xff);
+    __m128i lo, hi;
+
+    lo = _mm_unpacklo_epi64(_mm_cvttpd_epi32(_mm_add_pd(vo, _mm_mul_pd(vs, a))), _mm_cvttpd_epi32(_mm_add_pd(vo, _mm_mul_pd(vs, b))));
+    hi = _mm_unpacklo_epi64(_mm_cvttpd_epi32(_mm_add_pd(vo, _mm_mul_pd(vs, c))), _mm_cvttpd_epi32(_mm_add_pd(vo, _mm_mul_pd(vs, d))));
+    lo = _mm_packs_epi32(_mm_and_si128(lo, mask), _mm_and_si128(hi, mask));
+
+    return(_mm_packus_epi16(lo, lo));
+}
+
+// Loaders for pixels [i, i + 8) of plane p as uint8 into the low half of the result, and
+// for pixels [i, i + 4) as float, one per source type:
+static inline __m128i PsychLoadUInt8x8_uint8(const void* p, size_t i, __m128d vs, __m128d vo)
+{
+    return(_mm_loadl_epi64((const __m128i*) ((const psych_uint8*) p + i)));
+}
+
+static inline __m128i PsychLoadUInt8x8_uint16(const void* p, size_t i, __m128d vs, __m128d vo)
+{
+    const __m128i zero = _mm_setzero_si128();
+    const __m128i bias = _mm_set1_epi32(128);
+    __m128i v, lo, hi;
+
+    // (v * 255 + 32767) / 65535 == (t - (t >> 8)) >> 8 with t = v + 128, for all uint16 v:
+    v = _mm_loadu_si128((const __m128i*) ((const psych_uint16*) p + i));
+    lo = _mm_add_epi32(_mm_unpacklo_epi16(v, zero), bias);
+    hi = _mm_add_epi32(_mm_unpackhi_epi16(v, zero), bias);
+    lo = _mm_srli_epi32(_mm_sub_epi32(lo, _mm_srli_epi32(lo, 8)), 8);
+    hi = _mm_srli_epi32(_mm_sub_epi32(hi, _mm_srli_epi32(hi, 8)), 8);
+    lo = _mm_packs_epi32(lo, hi);
+
+    return(_mm_packus_epi16(lo, lo));
+}
+
+static inline __m128i PsychLoadUInt8x8_single(const void* p, size_t i, __m128d vs, __m128d vo)
+{
+    const __m128 f0 = _mm_loadu_ps((const float*) p + i);
+    const __m128 f1 = _mm_loadu_ps((const float*) p + i + 4);
+
+    return(PsychPackRealToUInt8(_mm_cvtps_pd(f0), _mm_cvtps_pd(_mm_movehl_ps(f0, f0)),
+                                _mm_cvtps_pd(f1), _mm_cvtps_pd(_mm_movehl_ps(f1, f1)), vs, vo));
+}
+
+static inline __m128i PsychLoadUInt8x8_double(const void* p, size_t i, __m128d vs, __m128d vo)
+{
+    const double *pd = (const double*) p + i;
+
+    return(PsychPackRealToUInt8(_mm_loadu_pd(pd), _mm_loadu_pd(pd + 2), _mm_loadu_pd(pd + 4), _mm_loadu_pd(pd + 6), vs, vo));
+}
+
+static inline __m128 PsychLoadFloatx4_uint8(const void* p, size_t i)
+{
+    const __m128i zero = _mm_setzero_si128();
+    int v;
+
+    memcpy(&v, (const psych_uint8*) p + i, sizeof(v));
+    return(_mm_mul_ps(_mm_cvtepi32_ps(_mm_unpacklo_epi16(_mm_unpacklo_epi8(_mm_cvtsi32_si128(v), zero), zero)), _mm_set1_ps(1.0f / 255.0f)));
+}
+
+static inline __m128 PsychLoadFloatx4_uint16(const void* p, size_t i)
+{
+    const __m128i v = _mm_loadl_epi64((const __m128i*) ((const psych_uint16*) p + i));
+
+    return(_mm_mul_ps(_mm_cvtepi32_ps(_mm_unpacklo_epi16(v, _mm_setzero_si128())), _mm_set1_ps(1.0f / 65535.0f)));
+}
+
+static inline __m128 PsychLoadFloatx4_single(const void* p, size_t i)
+{
+    return(_mm_loadu_ps((const float*) p + i));
+}
+
+static inline __m128 PsychLoadFloatx4_double(const void* p, size_t i)
+{
+    return(_mm_movelh_ps(_mm_cvtpd_ps(_mm_loadu_pd((const double*) p + i)), _mm_cvtpd_ps(_mm_loadu_pd((const double*) p + i + 2))));
+}
+
+// Defines PsychConvertTexturePlanesSSE2_<stype>(job, start, count), which converts and interleaves
+// pixels [start, start + count) of job in SSE2 registers, so all planes are streamed from memory
+// concurrently, like in the plain C code. It returns the number of converted pixels, a multiple
+// of 8. The caller handles the remaining pixels:
+#define PSYCH_DEFINE_CONVERT_SSE2(stype, ctype)                                                 \
+static size_t PsychConvertTexturePlanesSSE2_##stype(const PsychConversionJob *job, size_t start, size_t count) \
+{                                                                                               \
+    const __m128d vs = _mm_set1_pd(job->scale);                                                 \
+    const __m128d vo = _mm_set1_pd(job->offset);                                                \
+    const int nplanes = job->nplanes;                                                           \
+    const ctype *p0, *p1 = NULL, *p2 = NULL, *p3 = NULL;                                        \
+    GLubyte *d8 = (GLubyte*) job->dst + start * (size_t) nplanes;                               \
+    GLfloat *df = (GLfloat*) job->dst + start * (size_t) nplanes;                               \
+    GLubyte c8[3][16];                                                                          \
+    __m128i v0, v1, v2, v3;                                                                     \
+    __m128 f0, f1, f2, f3, t0, t1, t2, t3;                                                      \
+    size_t i, j, n = count & ~((size_t) 7);                                                     \
+                                                                                                \
+    p0 = (const ctype*) job->src + (size_t) job->order[0] * job->npixels + start;               \
+    if (nplanes > 1) p1 = (const ctype*) job->src + (size_t) job->order[1] * job->npixels + start; \
+    if (nplanes > 2) p2 = (const ctype*) job->src + (size_t) job->order[2] * job->npixels + start; \
+    if (nplanes > 3) p3 = (const ctype*) job->src + (size_t) job->order[3] * job->npixels + start; \
+                                                                                                \
+    if (!job->dstfloat) {                                                                       \
+        switch (nplanes) {                                                                      \
+            case 1:                                                                             \
+                for (i = 0; i < n; i += 8)                                                      \
+                    _mm_storel_epi64((__m128i*) (d8 + i), PsychLoadUInt8x8_##stype(p0, i, vs, vo)); \
+                break;                                                                          \
+                                                                                                \
+            case 2:                                                                             \
+                for (i = 0; i < n; i += 8) {                                                    \
+                    v0 = PsychLoadUInt8x8_##stype(p0, i, vs, vo);                               \
+                    v1 = PsychLoadUInt8x8_##stype(p1, i, vs, vo);                               \
+                    _mm_storeu_si128((__m128i*) (d8 + 2 * i), _mm_unpacklo_epi8(v0, v1));       \
+                }                                                                               \
+                break;                                                                          \
+                                                                                                \
+            case 3:                                                                             \
+                /* No byte shuffles in SSE2, so RGB triplets are assembled in plain C: */       \
+                for (i = 0; i < n; i += 8) {                                                    \
+                    _mm_storel_epi64((__m128i*) c8[0], PsychLoadUInt8x8_##stype(p0, i, vs, vo)); \
+                    _mm_storel_epi64((__m128i*) c8[1], PsychLoadUInt8x8_##stype(p1, i, vs, vo)); \
+                    _mm_storel_epi64((__m128i*) c8[2], PsychLoadUInt8x8_##stype(p2, i, vs, vo)); \
+                    for (j = 0; j < 8; j++) {                                                   \
+                        d8[3 * (i + j) + 0] = c8[0][j];                                         \
+                        d8[3 * (i + j) + 1] = c8[1][j];                                         \
+                        d8[3 * (i + j) + 2] = c8[2][j];                                         \
+                    }                                                                           \
+                }                                                                               \
+                break;                                                                          \
+                                                                                                \
+            case 4:                                                                             \
+                for (i = 0; i < n; i += 8) {                                                    \
+                    v0 = PsychLoadUInt8x8_##stype(p0, i, vs, vo);                               \
+                    v1 = PsychLoadUInt8x8_##stype(p1, i, vs, vo);                               \
+                    v2 = PsychLoadUInt8x8_##stype(p2, i, vs, vo);                               \
+                    v3 = PsychLoadUInt8x8_##stype(p3, i, vs, vo);                               \
+                    v0 = _mm_unpacklo_epi8(v0, v1);                                             \
+                    v2 = _mm_unpacklo_epi8(v2, v3);                                             \
+                    _mm_storeu_si128((__m128i*) (d8 + 4 * i), _mm_unpacklo_epi16(v0, v2));      \
+                    _mm_storeu_si128((__m128i*) (d8 + 4 * i + 16), _mm_unpackhi_epi16(v0, v2)); \
+                }                                                                               \
+                break;                                                                          \
+        }                                                                                       \
+    }                                                                                           \
+    else {                                                                                      \
+        switch (nplanes) {                                                                      \
+            case 1:                                                                             \
+                for (i = 0; i < n; i += 4)                                                      \
+                    _mm_storeu_ps(df + i, PsychLoadFloatx4_##stype(p0, i));                     \
+                break;                                                                          \
+                                                                                                \
+            case 2:                                                                             \
+                for (i = 0; i < n; i += 4) {                                                    \
+                    f0 = PsychLoadFloatx4_##stype(p0, i);                                       \
+                    f1 = PsychLoadFloatx4_##stype(p1, i);                                       \
+                    _mm_storeu_ps(df + 2 * i, _mm_unpacklo_ps(f0, f1));                         \
+                    _mm_storeu_ps(df + 2 * i + 4, _mm_unpackhi_ps(f0, f1));                     \
+                }                                                                               \
+                break;                                                                          \
+                                                                                                \
+            case 3:                                                                             \
+                /* 4 pixels of 3 planes are 3 registers: R0G0B0R1 G1B1R2G2 B2R3G3B3: */         \
+                for (i = 0; i < n; i += 4) {                                                    \
+                    f0 = PsychLoadFloatx4_##stype(p0, i);                                       \
+                    f1 = PsychLoadFloatx4_##stype(p1, i);                                       \
+                    f2 = PsychLoadFloatx4_##stype(p2, i);                                       \
+                    t0 = _mm_unpacklo_ps(f0, f1);                               /* R0G0R1G1 */  \
+                    t1 = _mm_unpackhi_ps(f0, f1);                               /* R2G2R3G3 */  \
+                    t2 = _mm_shuffle_ps(f2, t0, _MM_SHUFFLE(3, 2, 0, 0));       /* B0B0R1G1 */  \
+                    _mm_storeu_ps(df + 3 * i, _mm_shuffle_ps(t0, t2, _MM_SHUFFLE(2, 0, 1, 0))); \
+                    t2 = _mm_shuffle_ps(t0, f2, _MM_SHUFFLE(1, 1, 3, 3));       /* G1G1B1B1 */  \
+                    _mm_storeu_ps(df + 3 * i + 4, _mm_shuffle_ps(t2, t1, _MM_SHUFFLE(1, 0, 2, 0))); \
+                    t2 = _mm_shuffle_ps(f2, t1, _MM_SHUFFLE(3, 2, 2, 2));       /* B2B2R3G3 */  \
+                    t3 = _mm_shuffle_ps(t1, f2, _MM_SHUFFLE(3, 3, 3, 3));       /* G3G3B3B3 */  \
+                    _mm_storeu_ps(df + 3 * i + 8, _mm_shuffle_ps(t2, t3, _MM_SHUFFLE(2, 0, 2, 0))); \
+                }                                                                               \
+                break;                                                                          \
+                                                                                                \
+            case 4:                                                                             \
+                for (i = 0; i < n; i += 4) {                                                    \
+                    f0 = PsychLoadFloatx4_##stype(p0, i);                                       \
+                    f1 = PsychLoadFloatx4_##stype(p1, i);                                       \
+                    f2 = PsychLoadFloatx4_##stype(p2, i);                                       \
+                    f3 = PsychLoadFloatx4_##stype(p3, i);                                       \
+                    t0 = _mm_unpacklo_ps(f0, f1);                                               \
+                    t1 = _mm_unpackhi_ps(f0, f1);                                               \
+                    t2 = _mm_unpacklo_ps(f2, f3);                                               \
+                    t3 = _mm_unpackhi_ps(f2, f3);                                               \
+                    _mm_storeu_ps(df + 4 * i, _mm_movelh_ps(t0, t2));                           \
+                    _mm_storeu_ps(df + 4 * i + 4, _mm_movehl_ps(t2, t0));                       \
+                    _mm_storeu_ps(df + 4 * i + 8, _mm_movelh_ps(t1, t3));                       \
+                    _mm_storeu_ps(df + 4 * i + 12, _mm_movehl_ps(t3, t1));                      \
+                }                                                                               \
+                break;                                                                          \
+        }                                                                                       \
+    }                                                                                           \
+                                                                                                \
+    return(n);                                                                                  \
+}
+
+PSYCH_DEFINE_CONVERT_SSE2(uint8, psych_uint8)
+PSYCH_DEFINE_CONVERT_SSE2(uint16, psych_uint16)
+PSYCH_DEFINE_CONVERT_SSE2(single, float)
+PSYCH_DEFINE_CONVERT_SSE2(double, double)
+#endif
+
+// Convert pixels of one slice of job:
+static void PsychConvertTexturePlanesSlice(const PsychConversionJob *job, int slice)
+{
+    size_t start, count, done = 0;
+
+    // Slices are contiguous ranges of pixels, multiples of 64 pixels apart to avoid false sharing:
+    start = ((job->npixels / (size_t) job->nslices) & ~((size_t) 63)) * (size_t) slice;
+    count = (slice == job->nslices - 1) ? job->npixels - start : ((job->npixels / (size_t) job->nslices) & ~((size_t) 63));
+
+    // Plain copies are left to memcpy():
+    #if PSYCH_HAVE_SSE2
+    if (!((job->nplanes == 1) && (job->srctype == (job->dstfloat ? PsychArgType_single : PsychArgType_uint8)))) {
+        switch (job->srctype) {
+            case PsychArgType_uint8:
+                done = PsychConvertTexturePlanesSSE2_uint8(job, start, count);
+                break;
+
+            case PsychArgType_uint16:
+                done = PsychConvertTexturePlanesSSE2_uint16(job, start, count);
+                break;
+
+            case PsychArgType_single:
+                done = PsychConvertTexturePlanesSSE2_single(job, start, count);
+                break;
+
+            default:
+                done = PsychConvertTexturePlanesSSE2_double(job, start, count);
+                break;
+        }
+    }
+    #endif
+
+    if (done < count) PsychConvertTexturePlanesScalar(job, start + done, count - done);
+}
+
+static void* PsychConversionWorkerMain(void* arg)
+{
+    PsychConversionWorker *worker = (PsychConversionWorker*) arg;
+
+    PsychSetThreadName("PTBConvert");
+
+    PsychLockMutex(&poolMutex);
+    while (TRUE) {
+        // Wait for a new job or shutdown:
+        while ((worker->generation == jobGeneration) && !poolShutdown) PsychWaitCondition(&jobCondition, &poolMutex);
+        if (poolShutdown) break;
+        worker->generation = jobGeneration;
+
+        // Jobs with fewer slices than threads leave some workers idle:
+        if (worker->slice < currentJob.nslices) {
+            PsychUnlockMutex(&poolMutex);
+            PsychConvertTexturePlanesSlice(&currentJob, worker->slice);
+            PsychLockMutex(&poolMutex);
+            if (--jobsPending == 0) PsychSignalCondition(&doneCondition);
+        }
+    }
+    PsychUnlockMutex(&poolMutex);
+
+    return(NULL);
+}
+
+// Return number of threads used for large conversions, starting the worker pool on first call.
+// The first call must happen on the main thread, before any other thread uses the pool:
+int PsychGetTextureConversionThreads(void)
+{
+    int i, rc;
+
+    if (numThreads > 0) return(numThreads);
+
+    #if PSYCH_SYSTEM == PSYCH_WINDOWS
+        SYSTEM_INFO sysinfo;
+        GetSystemInfo(&sysinfo);
+        numThreads = (int) sysinfo.dwNumberOfProcessors;
+    #else
+        numThreads = (int) sysconf(_SC_NPROCESSORS_ONLN);
+    #endif
+
+    if (getenv("PSYCH_CONVERSION_THREADS")) numThreads = atoi(getenv("PSYCH_CONVERSION_THREADS"));
+    if (numThreads < 1) numThreads = 1;
+    if (numThreads > PSYCH_MAX_CONVERSION_THREADS) numThreads = PSYCH_MAX_CONVERSION_THREADS;
+    if (numThreads == 1) return(numThreads);
+
+    PsychInitMutex(&poolMutex);
+    PsychInitMutex(&submitMutex);
+    PsychInitCondition(&jobCondition, NULL);
+    PsychInitCondition(&doneCondition, NULL);
+    poolShutdown = FALSE;
+
+    // Caller processes slice 0, workers the other ones:
+    for (i = 1; i < numThreads; i++) {
+        workers[i].slice = i;
+        // Only jobs submitted after thread creation are for this worker, even if a previous pool ran jobs:
+        workers[i].generation = jobGeneration;
+        if ((rc = PsychCreateThread(&(workers[i].thread), NULL, PsychConversionWorkerMain, (void*) &(workers[i])))) {
+            if (PsychPrefStateGet_Verbosity() > 1)
+                printf("PTB-WARNING: Failed to start texture conversion worker thread [%s]. Using %i threads.\n", strerror(rc), i);
+            break;
+        }
+    }
+    numThreads = i;
+
+    if (PsychPrefStateGet_Verbosity() > 4) printf("PTB-DEBUG: Using %i threads for conversion of large textures.\n", numThreads);
+
+    return(numThreads);
+}
+
+// Stop all worker threads. Called at Screen shutdown:
+void PsychExitTextureConversion(void)
+{
+    int i;
+
+    if (numThreads > 1) {
+        PsychLockMutex(&poolMutex);
+        poolShutdown = TRUE;
+        PsychBroadcastCondition(&jobCondition);
+        PsychUnlockMutex(&poolMutex);
+
+        for (i = 1; i < numThreads; i++) PsychDeleteThread(&(workers[i].thread));
+
+        PsychDestroyCondition(&doneCondition);
+        PsychDestroyCondition(&jobCondition);
+        PsychDestroyMutex(&submitMutex);
+        PsychDestroyMutex(&poolMutex);
+    }
+
+    numThreads = 0;
+}
+
+// Interleave 'nplanes' planes of 'npixels' elements of type 'srctype' from 'src' into 'dst'.
+// order[k] is the source plane for component k of each destination pixel. For 8 bpc output,
+// double and single values v are stored as (GLubyte) (offset + scale * v). For float output,
+// 'scale' and 'offset' are ignored:
+void PsychConvertTexturePlanes(const void* src, PsychArgFormatType srctype, size_t npixels, int nplanes, const int* order,
+                               void* dst, psych_bool dstfloat, double scale, double offset)
+{
+    PsychConversionJob job;
+    int i;
+
+    job.src = src;
+    job.srctype = srctype;
+    job.npixels = npixels;
+    job.nplanes = nplanes;
+    for (i = 0; i < 4; i++) job.order[i] = (i < nplanes) ? order[i] : 0;
+    job.dst = dst;
+    job.dstfloat = dstfloat;
+    job.scale = scale;
+    job.offset = offset;
+    job.nslices = 1;
+
+    // Small image, no worker threads, or pool busy with a conversion for another thread,
+    // e.g., the texture uploader thread? Convert on calling thread:
+    if ((npixels * (size_t) nplanes < kPsychMinParallelElements) || (PsychGetTextureConversionThreads() < 2) || PsychTryLockMutex(&submitMutex)) {
+        PsychConvertTexturePlanesSlice(&job, 0);
+        return;
+    }
+
+    // Hand out slices 1 to numThreads - 1 to the workers, then do slice 0 ourselves:
+    job.nslices = numThreads;
+
+    PsychLockMutex(&poolMutex);
+    currentJob = job;
+    jobsPending = numThreads - 1;
+    jobGeneration++;
+    PsychBroadcastCondition(&jobCondition);
+    PsychUnlockMutex(&poolMutex);
+
+    PsychConvertTexturePlanesSlice(&job, 0);
+
+    PsychLockMutex(&poolMutex);
+    while (jobsPending > 0) PsychWaitCondition(&doneCondition, &poolMutex);
+    PsychUnlockMutex(&poolMutex);
+
+    PsychUnlockMutex(&submitMutex);
+}
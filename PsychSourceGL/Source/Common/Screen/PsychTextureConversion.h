@@ -0,0 +1,39 @@
+/*
+    Common/Screen/PsychTextureConversion.h
+
+    PLATFORMS:
+
+        All.
+
+    AUTHORS:
+
+        agent           agent  agent@local
+
+    HISTORY:
+
+        10/18/26    agent Wrote it.
+
+    DESCRIPTION:
+
+        Conversion of planar image matrices from the runtime into interleaved pixel buffers
+        for texture upload, as used by Screen('MakeTexture'). Large images are split across
+        a small pool of worker threads.
+
+*/
+
+//include once
+#ifndef PSYCH_IS_INCLUDED_PsychTextureConversion
+#define PSYCH_IS_INCLUDED_PsychTextureConversion
+
+#include "Screen.h"
+
+// Maximum number of threads, including the calling thread, used for one conversion:
+#define PSYCH_MAX_CONVERSION_THREADS 8
+
+void PsychConvertTexturePlanes(const void* src, PsychArgFormatType srctype, size_t npixels, int nplanes, const int* order,
+                               void* dst, psych_bool dstfloat, double scale, double offset);
+int  PsychGetTextureConversionThreads(void);
+void PsychExitTextureConversion(void);
+
+//end include once
+#endif
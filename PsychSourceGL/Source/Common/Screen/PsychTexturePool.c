@@ -0,0 +1,242 @@
+/*
+    Common/Screen/PsychTexturePool.c
+
+    PLATFORMS:
+
+        All.
+
+    AUTHORS:
+
+        agent           agent  agent@local
+
+    HISTORY:
+
+        10/18/26    agent Wrote it.
+
+    DESCRIPTION:
+
+        Pool of released OpenGL texture objects, for recycling of their storage.
+
+        Scripts which create and close textures for each trial, or movie playback and video
+        capture where the user code holds on to more than one texture at a time, would
+        otherwise allocate and free texture storage all the time, with potential allocation
+        stalls in the driver. Each onscreen window, ie., each OpenGL context, has a pool of
+        textures which got closed. PsychCreateTexture() asks the pool for a texture object
+        with matching target, internal format, width, height and number of mipmap levels,
+        and if there is one, it only updates its content via glTexSubImage2D(), as for any
+        other recycled texture. Only storage created by PsychCreateTexture() is pooled, not
+        textures which were exposed to external OpenGL code via Screen('GetOpenGLTexture'),
+        or which got replaced by a framebuffer object color buffer texture.
+
+        The pool is limited in number of textures and estimated memory consumption. If a
+        limit is exceeded, the least recently released textures get deleted. The limits
+        default to 32 textures and 128 MB and can be set via the environment variables
+        PSYCH_TEXTURE_POOL_MAXCOUNT and PSYCH_TEXTURE_POOL_MB, a setting of zero disables
+        pooling. Pooling is also disabled if client storage textures are requested via the
+        Screen('Preference', 'ConserveVRAM') setting, and on OpenGL-ES.
+
+*/
+
+#include "Screen.h"
+
+typedef struct PsychPooledTexture {
+    GLuint                      texture;
+    GLenum                      target;
+    GLint                       internalFormat;
+    int                         width;
+    int                         height;
+    int                         levels;
+    int                         bpc;            // Effective bits per color component, as determined at creation.
+    size_t                      size;           // Estimated size of storage in bytes.
+    struct PsychPooledTexture*  prev;           // Next more recently released texture.
+    struct PsychPooledTexture*  next;           // Next less recently released texture.
+} PsychPooledTexture;
+
+struct PsychTexturePool {
+    PsychPooledTexture*     head;               // Most recently released texture.
+    PsychPooledTexture*     tail;               // Least recently released texture, first to be evicted.
+    int                     count;
+    size_t                  size;               // Estimated total size of pooled storage in bytes.
+    unsigned int            hits;
+    unsigned int            misses;
+    unsigned int            evictions;
+};
+
+static int      maxPoolCount = -1;
+static size_t   maxPoolSize = 0;
+
+// Get the limits of each pool, from environment variables on first call:
+static psych_bool PsychGetTexturePoolLimits(void)
+{
+    if (maxPoolCount < 0) {
+        maxPoolCount = 32;
+        maxPoolSize = 128;
+        if (getenv("PSYCH_TEXTURE_POOL_MAXCOUNT")) maxPoolCount = atoi(getenv("PSYCH_TEXTURE_POOL_MAXCOUNT"));
+        if (getenv("PSYCH_TEXTURE_POOL_MB")) maxPoolSize = (size_t) atoi(getenv("PSYCH_TEXTURE_POOL_MB"));
+        if (maxPoolCount < 0) maxPoolCount = 0;
+        maxPoolSize *= 1024 * 1024;
+
+        if (PsychPrefStateGet_Verbosity() > 4) {
+            if (maxPoolCount > 0 && maxPoolSize > 0)
+                printf("PTB-DEBUG: Texture pool limited to %i textures and %i MB per onscreen window.\n", maxPoolCount, (int) (maxPoolSize / 1024 / 1024));
+            else
+                printf("PTB-DEBUG: Texture pool disabled.\n");
+        }
+    }
+
+    return((maxPoolCount > 0 && maxPoolSize > 0 && !(PsychPrefStateGet_ConserveVRAM() & kPsychDontCacheTextures)) ? TRUE : FALSE);
+}
+
+// Return the pool of the OpenGL context of 'win', or NULL if textures of 'win' can't be pooled:
+static PsychTexturePool* PsychGetTexturePool(PsychWindowRecordType *win, psych_bool create)
+{
+    PsychWindowRecordType *parentRecord;
+
+    if (!PsychGetTexturePoolLimits() || PsychIsGLES(win)) return(NULL);
+
+    parentRecord = PsychGetParentWindow(win);
+    if (!PsychIsOnscreenWindow(parentRecord) || (parentRecord->targetSpecific.contextObject == NULL) ||
+        (parentRecord->targetSpecific.contextObject != win->targetSpecific.contextObject))
+        return(NULL);
+
+    if ((NULL == parentRecord->texturePool) && create) {
+        parentRecord->texturePool = (PsychTexturePool*) calloc(1, sizeof(PsychTexturePool));
+        if (NULL == parentRecord->texturePool) return(NULL);
+    }
+
+    return(parentRecord->texturePool);
+}
+
+static void PsychUnlinkPooledTexture(PsychTexturePool *pool, PsychPooledTexture *entry)
+{
+    if (entry->prev) entry->prev->next = entry->next; else pool->head = entry->next;
+    if (entry->next) entry->next->prev = entry->prev; else pool->tail = entry->prev;
+    pool->count--;
+    pool->size -= entry->size;
+}
+
+// Delete least recently released textures until the pool is within its limits. Needs
+// the OpenGL context of the pool bound:
+static void PsychTrimTexturePool(PsychTexturePool *pool, int maxCount, size_t maxSize)
+{
+    PsychPooledTexture *entry;
+
+    while (pool->tail && ((pool->count > maxCount) || (pool->size > maxSize))) {
+        entry = pool->tail;
+        PsychUnlinkPooledTexture(pool, entry);
+        glDeleteTextures(1, &entry->texture);
+        free(entry);
+        pool->evictions++;
+    }
+}
+
+// Assign a pooled texture object with storage of matching shape to texture 'win', if any.
+// Returns TRUE and sets textureNumber, bpc and surfaceSizeBytes of 'win' on success. Called
+// by PsychCreateTexture() with the OpenGL context of 'win' bound:
+psych_bool PsychAcquireTextureFromPool(PsychWindowRecordType *win, GLenum target, GLint internalFormat, int width, int height, int levels)
+{
+    PsychTexturePool *pool = PsychGetTexturePool(win, FALSE);
+    PsychPooledTexture *entry;
+
+    if (NULL == pool) return(FALSE);
+
+    for (entry = pool->head; entry; entry = entry->next) {
+        if ((entry->target == target) && (entry->internalFormat == internalFormat) && (entry->width == width) &&
+            (entry->height == height) && (entry->levels == levels))
+            break;
+    }
+
+    if (NULL == entry) {
+        pool->misses++;
+        return(FALSE);
+    }
+
+    PsychUnlinkPooledTexture(pool, entry);
+    pool->hits++;
+
+    win->textureNumber = entry->texture;
+    win->bpc = entry->bpc;
+    win->surfaceSizeBytes = entry->size;
+    free(entry);
+
+    if (PsychPrefStateGet_Verbosity() > 9) printf("PTB-DEBUG: Recycling pooled texture %i for %i x %i texels.\n", win->textureNumber, width, height);
+
+    return(TRUE);
+}
+
+// Put the texture object of texture 'win' into the pool, if its storage can be recycled.
+// Returns TRUE if so, in which case the caller must not delete the texture object. Called
+// by PsychFreeTextureForWindowRecord() with the OpenGL context of 'win' bound:
+psych_bool PsychReleaseTextureToPool(PsychWindowRecordType *win)
+{
+    PsychTexturePool *pool;
+    PsychPooledTexture *entry;
+    GLenum target;
+    GLint mipmapped = 0;
+
+    // Only storage allocated by PsychCreateTexture():
+    if ((win->texturePoolFormat == 0) || (win->textureNumber == 0)) return(FALSE);
+
+    // A texture which was used as drawing target is the color attachment of its FBO. Only
+    // this simple case is handled, by taking the texture away from the FBO further down:
+    if ((win->fboCount > 1) || ((win->fboCount == 1) && (win->fboTable[0]->coltexid != win->textureNumber))) return(FALSE);
+
+    pool = PsychGetTexturePool(win, TRUE);
+    if (NULL == pool) return(FALSE);
+
+    // Mip-mapped drawing may have added a mipmap pyramid to a GL_TEXTURE_2D texture. Such
+    // textures are not pooled, as PsychCreateTexture() only asks for single level storage:
+    target = PsychGetTextureTarget(win);
+    if (target == GL_TEXTURE_2D) {
+        glBindTexture(target, win->textureNumber);
+        glGetTexParameteriv(target, GL_GENERATE_MIPMAP, &mipmapped);
+        glBindTexture(target, 0);
+        if (mipmapped) return(FALSE);
+    }
+
+    entry = (PsychPooledTexture*) malloc(sizeof(PsychPooledTexture));
+    if (NULL == entry) return(FALSE);
+
+    // Make sure PsychDeleteFBO() won't delete the texture at imaging pipeline shutdown:
+    if (win->fboCount == 1) win->fboTable[0]->coltexid = 0;
+
+    entry->texture = win->textureNumber;
+    entry->target = target;
+    entry->internalFormat = win->texturePoolFormat;
+    entry->width = win->texturePoolSize[0];
+    entry->height = win->texturePoolSize[1];
+    entry->levels = 1;
+    entry->bpc = win->bpc;
+    entry->size = win->surfaceSizeBytes;
+
+    entry->prev = NULL;
+    entry->next = pool->head;
+    if (pool->head) pool->head->prev = entry; else pool->tail = entry;
+    pool->head = entry;
+    pool->count++;
+    pool->size += entry->size;
+
+    // Evict least recently released textures beyond the limits. This may evict 'entry'
+    // itself, if its storage alone exceeds the memory limit:
+    PsychTrimTexturePool(pool, maxPoolCount, maxPoolSize);
+
+    return(TRUE);
+}
+
+// Delete the texture pool of an onscreen window and all its textures. Called at window
+// close time, with the OpenGL context of the window bound:
+void PsychDeleteTexturePool(PsychWindowRecordType *windowRecord)
+{
+    PsychTexturePool *pool = windowRecord->texturePool;
+
+    if (NULL == pool) return;
+    windowRecord->texturePool = NULL;
+
+    if (PsychPrefStateGet_Verbosity() > 4) {
+        printf("PTB-DEBUG: Texture pool of window %i: %i recycled, %i newly allocated, %i evicted textures.\n",
+               windowRecord->windowIndex, pool->hits, pool->misses, pool->evictions);
+    }
+
+    PsychTrimTexturePool(pool, 0, 0);
+    free(pool);
+}
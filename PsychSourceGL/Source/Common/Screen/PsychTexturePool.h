@@ -0,0 +1,34 @@
+/*
+    Common/Screen/PsychTexturePool.h
+
+    PLATFORMS:
+
+        All.
+
+    AUTHORS:
+
+        agent           agent  agent@local
+
+    HISTORY:
+
+        10/18/26    agent Wrote it.
+
+    DESCRIPTION:
+
+        Per-context pool of released OpenGL texture objects, for recycling of their storage
+        by PsychCreateTexture() instead of reallocation.
+
+*/
+
+//include once
+#ifndef PSYCH_IS_INCLUDED_PsychTexturePool
+#define PSYCH_IS_INCLUDED_PsychTexturePool
+
+#include "Screen.h"
+
+psych_bool  PsychAcquireTextureFromPool(PsychWindowRecordType *win, GLenum target, GLint internalFormat, int width, int height, int levels);
+psych_bool  PsychReleaseTextureToPool(PsychWindowRecordType *win);
+void        PsychDeleteTexturePool(PsychWindowRecordType *windowRecord);
+
+//end include once
+#endif
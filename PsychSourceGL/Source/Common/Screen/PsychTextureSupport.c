@@ -132,6 +132,11 @@ void PsychInitWindowRecordTextureFields(PsychWindowRecordType *win)
     // setting will be used for the GL_UNPACK_ALIGNMENT setting in PsychCreateTexture() and friends
     // to optimize texture upload:
     win->textureByteAligned=0;
+
+    // No texture storage which could be recycled via the texture pool:
+    win->texturePoolFormat=0;
+    win->texturePoolSize[0]=0;
+    win->texturePoolSize[1]=0;
 }
 
 void PsychCreateTexture(PsychWindowRecordType *win)
@@ -141,12 +146,12 @@ void PsychCreateTexture(PsychWindowRecordType *win)
     #endif
     GLenum texturetarget, oldtexturetarget = GL_TEXTURE_RECTANGLE_EXT;
     double sourceWidth, sourceHeight;
-    GLint glinternalFormat = 0, gl_realinternalformat = 0;
+    GLint glinternalFormat = 0, gl_realinternalformat = 0, poolformat = 0;
     static GLint gl_lastrequestedinternalFormat = 0;
     GLint gl_rbits=0, gl_gbits=0, gl_bbits=0, gl_abits=0, gl_lbits=0;
     int twidth, theight, pass, texcount;
     void* texmemptr;
-    psych_bool recycle = FALSE, avoidCPUGPUSync;
+    psych_bool recycle = FALSE, avoidCPUGPUSync, poolable;
     GLenum glerr;
     int verbosity;
 
@@ -176,6 +181,53 @@ void PsychCreateTexture(PsychWindowRecordType *win)
     // low-mem gfx-cards. Enable clientstorage, if so...
     clientstorage = (PsychPrefStateGet_ConserveVRAM() & kPsychDontCacheTextures) ? TRUE : FALSE;
 
+    // Definition of width and height is swapped due to texture rotation trick, see comments in PsychBlit.....
+    if (win->textureOrientation==0 || win->textureOrientation==1) {
+        // Transposed case: Optimized for fast MakeTexture from Matlab image matrix.
+        // This is true for all calls from MakeTexure, except ones with the textureOrientation flag set to 2:
+        sourceHeight=PsychGetWidthFromRect(win->rect);
+        sourceWidth=PsychGetHeightFromRect(win->rect);
+    }
+    else {
+        // Non-transposed upright case: This is used for textures created by 'OpenOffscreenWindow'
+        // One can directly draw to these textures as rendertargets aka OpenGL framebuffer objects...
+        sourceHeight=PsychGetHeightFromRect(win->rect);
+        sourceWidth=PsychGetWidthFromRect(win->rect);
+    }
+
+    // We used to have different cases for Luminance, Luminance+Alpha, RGB, RGBA.
+    // This way we saved texture memory for the source->textureMemory -- Arrays, as well as copy-time
+    // in MakeTexture - In theory...
+    // Reality is: We always use GL_RGBA8 as internal format, except for pure luminance textures.
+    // This obviously wastes storage space for LA and RGB textures, but it is the only mode that is
+    // well supported (=fast) on all common gfx-hardware. Only the very latest models of NVidia and ATI
+    // are capable of handling the other formats natively in hardware :-(
+    if ((texturetarget == GL_TEXTURE_2D) && !(win->gfxcaps & kPsychGfxCapNPOTTex)) {
+        // This hardware doesn't support non-power-of-two GL_TEXTURE_2D textures. We create and use power of two
+        // textures to emulate rectangle textures...
+
+        // Compute smallest power of two dimension that fits the texture.
+        twidth=1;
+        while (twidth<sourceWidth) twidth*=2;
+        theight=1;
+        while (theight<sourceHeight) theight*=2;
+        // First we only use glTexImage2D with NULL data pointer to create a properly sized empty texture:
+        texmemptr=NULL;
+    }
+    else {
+        // Hardware supports rectangular textures: Use texture as-is:
+        twidth  = (int) sourceWidth;
+        theight = (int) sourceHeight;
+        texmemptr=win->textureMemory;
+    }
+
+    // Storage of new desktop OpenGL textures without power of two padding can be recycled via
+    // the texture pool of our context, once the texture gets closed. Derive the internal format
+    // as the creation code below does, for use as part of the key into the pool:
+    poolable = (win->textureNumber == 0 && !PsychIsGLES(win) && !clientstorage && (twidth == (int) sourceWidth) &&
+                (theight == (int) sourceHeight)) ? TRUE : FALSE;
+    if (poolable) poolformat = (win->textureinternalformat) ? win->textureinternalformat : ((win->depth == 8) ? GL_LUMINANCE8 : GL_RGBA8);
+
     // Create a unique texture handle for this texture:
     // If the texture already has a handle assigned then this means that we shouldn't
     // create and setup a new OpenGL texture from scratch, but bind and recycle the
@@ -183,9 +235,18 @@ void PsychCreateTexture(PsychWindowRecordType *win)
     // Updating textures is potentially faster than recreating them -> movie playback
     // and the Videocapture code et al. will benefit from this...
     if (win->textureNumber == 0) {
-        glGenTextures(1, &win->textureNumber);
-        recycle = FALSE;
-        //printf("CREATING NEW TEX %i\n", win->textureNumber);
+        if (poolable && PsychAcquireTextureFromPool(win, texturetarget, poolformat, twidth, theight, 1)) {
+            // Got a texture object with storage of matching shape from the pool. Recycle it:
+            recycle = TRUE;
+
+            // Accounting... ...this is only a rough guesstimate:
+            texmemguesstimate+= win->surfaceSizeBytes;
+        }
+        else {
+            glGenTextures(1, &win->textureNumber);
+            recycle = FALSE;
+            //printf("CREATING NEW TEX %i\n", win->textureNumber);
+        }
     }
     else {
         recycle = TRUE;
@@ -245,49 +306,9 @@ void PsychCreateTexture(PsychWindowRecordType *win)
 
     // The texture object is ready for use: Assign it our texture data:
 
-    // Definition of width and height is swapped due to texture rotation trick, see comments in PsychBlit.....
-    if (win->textureOrientation==0 || win->textureOrientation==1) {
-        // Transposed case: Optimized for fast MakeTexture from Matlab image matrix.
-        // This is true for all calls from MakeTexure, except ones with the textureOrientation flag set to 2:
-        sourceHeight=PsychGetWidthFromRect(win->rect);
-        sourceWidth=PsychGetHeightFromRect(win->rect);
-    }
-    else {
-        // Non-transposed upright case: This is used for textures created by 'OpenOffscreenWindow'
-        // One can directly draw to these textures as rendertargets aka OpenGL framebuffer objects...
-        sourceHeight=PsychGetHeightFromRect(win->rect);
-        sourceWidth=PsychGetWidthFromRect(win->rect);
-    }
-
     // Desktop-GL only:
     if (!PsychIsGLES(win)) glPixelStorei(GL_UNPACK_ROW_LENGTH, (int) sourceWidth);
 
-    // We used to have different cases for Luminance, Luminance+Alpha, RGB, RGBA.
-    // This way we saved texture memory for the source->textureMemory -- Arrays, as well as copy-time
-    // in MakeTexture - In theory...
-    // Reality is: We always use GL_RGBA8 as internal format, except for pure luminance textures.
-    // This obviously wastes storage space for LA and RGB textures, but it is the only mode that is
-    // well supported (=fast) on all common gfx-hardware. Only the very latest models of NVidia and ATI
-    // are capable of handling the other formats natively in hardware :-(
-    if ((texturetarget == GL_TEXTURE_2D) && !(win->gfxcaps & kPsychGfxCapNPOTTex)) {
-        // This hardware doesn't support non-power-of-two GL_TEXTURE_2D textures. We create and use power of two
-        // textures to emulate rectangle textures...
-
-        // Compute smallest power of two dimension that fits the texture.
-        twidth=1;
-        while (twidth<sourceWidth) twidth*=2;
-        theight=1;
-        while (theight<sourceHeight) theight*=2;
-        // First we only use glTexImage2D with NULL data pointer to create a properly sized empty texture:
-        texmemptr=NULL;
-    }
-    else {
-        // Hardware supports rectangular textures: Use texture as-is:
-        twidth  = (int) sourceWidth;
-        theight = (int) sourceHeight;
-        texmemptr=win->textureMemory;
-    }
-
     // We only execute this pass for really new textures, not for recycled ones:
     if (!recycle) {
         // This is a two-pass procedure. First we check with a proxy-texture if texture
@@ -534,8 +555,9 @@ void PsychCreateTexture(PsychWindowRecordType *win)
         texmemguesstimate+= win->surfaceSizeBytes;
     }  // End of new texture creation.
 
-    // Stage 2: If it is a 2D texture or a recycled texture, fill it with content via glTexSubImage2D:
-    if (texturetarget == GL_TEXTURE_2D || recycle) {
+    // Stage 2: If it is a 2D texture or a recycled texture, fill it with content via glTexSubImage2D.
+    // Without content, e.g., for asynchronous 'MakeTexture', the texture is left uninitialized:
+    if ((texturetarget == GL_TEXTURE_2D || recycle) && win->textureMemory) {
         // Special setup code for pot2 textures: Fill the empty power of two texture object with content:
         // We only fill a subrectangle (of sourceWidth x sourceHeight size) with our images content. The
         // unused border contains all zero == black.
@@ -613,6 +635,13 @@ void PsychCreateTexture(PsychWindowRecordType *win)
     if (!PsychIsGLES(win)) glPixelStorei(GL_UNPACK_ROW_LENGTH, 0);
     glPixelStorei(GL_UNPACK_ALIGNMENT, 1);
 
+    // Remember shape of storage, for recycling via the texture pool:
+    if (poolable) {
+        win->texturePoolFormat = poolformat;
+        win->texturePoolSize[0] = twidth;
+        win->texturePoolSize[1] = theight;
+    }
+
     // Client rect of a texture is always == rect of it:
     PsychCopyRect(win->clientrect, win->rect);
 
@@ -628,6 +657,9 @@ void PsychCreateTexture(PsychWindowRecordType *win)
  */
 void PsychFreeTextureForWindowRecord(PsychWindowRecordType *win)
 {
+    // Cancel or wait for a pending asynchronous upload into the texture, if any:
+    PsychCancelTextureUpload(win);
+
     // Destroy OpenGL texture object for windows that have one:
     if((win->windowType==kPsychSingleBufferOnscreen || win->windowType==kPsychDoubleBufferOnscreen || win->windowType==kPsychTexture) &&
         (win->targetSpecific.contextObject)) {
@@ -649,9 +681,10 @@ void PsychFreeTextureForWindowRecord(PsychWindowRecordType *win)
         // work for some strange reason :(
         if ((win->textureMemory) && (win->textureNumber > 0)) glFinish(); // FinishObjectAPPLE(GL_TEXTURE_2D, win->textureNumber);
 
-        // Perform standard OpenGL texture cleanup if needed:
+        // Perform standard OpenGL texture cleanup if needed, unless the texture object
+        // goes into the texture pool for recycling of its storage:
         if (win->textureNumber != 0) {
-            glDeleteTextures(1, &win->textureNumber);
+            if (!PsychReleaseTextureToPool(win)) glDeleteTextures(1, &win->textureNumber);
 
             // Accounting... ...this is only a rough guesstimate:
             texmemguesstimate-= win->surfaceSizeBytes;
@@ -683,6 +716,10 @@ void PsychBlitTextureToDisplay(PsychWindowRecordType *source, PsychWindowRecordT
     GLint attrib;
     GLuint shader = 0;
 
+    // Wait for completion of asynchronous texture creation of source, if needed. This
+    // must happen before we bind the targets context:
+    PsychFinishTextureUpload(source);
+
     // Enable targets framebuffer as current drawingtarget, except if this is a
     // blit operation from a window into itself and the imaging pipe is on:
     if ((source != target) || (target->imagingMode==0)) {
@@ -1375,6 +1412,8 @@ void PsychBatchBlitTexturesToDisplay(unsigned int opMode, unsigned int count, Ps
 {
     static unsigned int index = 0;
     static float *vertices, *colors, *texcoords;
+    static float *instances;
+    static unsigned int batchCount;
 
     static GLint attribs[11];
     static GLenum texturetarget;
@@ -1385,8 +1424,7 @@ void PsychBatchBlitTexturesToDisplay(unsigned int opMode, unsigned int count, Ps
     static double oldRotationAngle;
     static GLdouble sourceWidth, sourceHeight;
     GLdouble sourceX, sourceY, sourceXEnd, sourceYEnd;
-
-    (void) count;
+    float *instance;
 
     if (opMode == 0) {
         // Start new batch:
@@ -1394,10 +1432,19 @@ void PsychBatchBlitTexturesToDisplay(unsigned int opMode, unsigned int count, Ps
             PsychErrorExitMsg(PsychError_internal, "Non-NULL arrays at start of batch for opMode 0!\n");
 
         index = 0;
+        batchCount = count;
+
+        // Instanced drawing of the previous batch aborted by an error? Its stream mapping is
+        // finished at next use of the stream:
+        instances = NULL;
         //vertices = malloc(count * 2 *sizeof(float));
         //colors = malloc(count * 4 * sizeof(float));
         //texcoords = malloc(count * 2 * sizeof(float));
 
+        // Wait for completion of asynchronous texture creation of source, if needed. This
+        // must happen before we bind the targets context:
+        PsychFinishTextureUpload(source);
+
         // Enable targets framebuffer as current drawingtarget, except if this is a
         // blit operation from a window into itself and the imaging pipe is on:
         if ((source != target) || (target->imagingMode==0)) {
@@ -1421,7 +1468,15 @@ void PsychBatchBlitTexturesToDisplay(unsigned int opMode, unsigned int count, Ps
 
         // DRAW DRAW DRAW DRAW!
 
-        glEnd();
+        if (instances) {
+            // Draw all quads as instances of one unit quad:
+            PsychDrawQuadInstances(target, index, (textureNumber > 0) ? texturetarget : 0,
+                                   (source->textureOrientation == 2 || source->textureOrientation == 3 || source->textureOrientation == 4) ? FALSE : TRUE);
+            instances = NULL;
+        }
+        else {
+            glEnd();
+        }
 
         // Disable Transform:
         useXForm = 0;
@@ -1723,7 +1778,12 @@ void PsychBatchBlitTexturesToDisplay(unsigned int opMode, unsigned int count, Ps
 
         textureNumber = source->textureNumber;
 
-        glBegin(GL_QUADS);
+        // Without any shader, all quads of the batch can be drawn instanced, with per-quad
+        // records written into the vertex stream. Otherwise, shaders get their vertices and
+        // per-quad attributes in immediate mode:
+        instances = (shader == 0) ? PsychMapQuadInstances(target, (int) batchCount, (textureNumber > 0) ? texturetarget : 0) : NULL;
+
+        if (!instances) glBegin(GL_QUADS);
 
         // End of prep for first texture quad.
     }
@@ -1778,6 +1838,54 @@ void PsychBatchBlitTexturesToDisplay(unsigned int opMode, unsigned int count, Ps
         sourceYEnd=sourceYEnd / (double) tHeight;
     }
 
+    // Instanced drawing? Store the record for this quad, drawn at the end of the batch:
+    if (instances) {
+        if (index >= batchCount) PsychErrorExitMsg(PsychError_internal, "More quads than announced at start of batch for opMode 0!\n");
+
+        instance = instances + index * kPsychQuadInstanceFloats;
+        instance[0] = (float) targetRect[kPsychLeft];
+        instance[1] = (float) targetRect[kPsychTop];
+        instance[2] = (float) targetRect[kPsychRight];
+        instance[3] = (float) targetRect[kPsychBottom];
+        instance[4] = (float) sourceX;
+        instance[5] = (float) sourceY;
+        instance[6] = (float) sourceXEnd;
+        instance[7] = (float) sourceYEnd;
+
+        if ((rotationAngle != 0) && !(source->specialflags & kPsychDontDoRotation)) {
+            // Avoid redundant updates of rotation coefficients:
+            if (rotationAngle != oldRotationAngle) {
+                crt = (float) cos(rotationAngle * M_PI / 180.0);
+                srt = (float) sin(rotationAngle * M_PI / 180.0);
+                oldRotationAngle = rotationAngle;
+            }
+
+            instance[8] = crt;
+            instance[9] = srt;
+            instance[10] = (source->specialflags & kPsychUseTextureMatrixForRotation) ? 2.0f : 1.0f;
+        }
+        else {
+            instance[8] = 1.0f;
+            instance[9] = 0.0f;
+            instance[10] = 0.0f;
+        }
+        instance[11] = 0.0f;
+
+        if (globalAlpha == DBL_MAX) {
+            instance[12] = (float) target->currentColor[0];
+            instance[13] = (float) target->currentColor[1];
+            instance[14] = (float) target->currentColor[2];
+            instance[15] = (float) target->currentColor[3];
+        }
+        else {
+            instance[12] = instance[13] = instance[14] = 1.0f;
+            instance[15] = (float) globalAlpha;
+        }
+
+        index++;
+        return;
+    }
+
     // Any automatic shader assigned yet?
     if (shader > 0 && mattrib >= 0) {
         if (globalAlpha == DBL_MAX) {
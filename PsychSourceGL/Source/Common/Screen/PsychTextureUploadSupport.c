@@ -0,0 +1,610 @@
+/*
+    Common/Screen/PsychTextureUploadSupport.c
+
+    PLATFORMS:
+
+        All.
+
+    AUTHORS:
+
+        agent           agent  agent@local
+
+    HISTORY:
+
+        10/18/26    agent Wrote it.
+
+    DESCRIPTION:
+
+        Asynchronous texture creation for Screen('MakeTexture'), if specialFlags 64 is set.
+
+        The calling thread only allocates the texture storage via PsychCreateTexture(), as
+        for any other texture, and queues a private copy of the input matrix for upload. It
+        can then return the texture handle immediately. Each onscreen window has at most one
+        uploader thread, which is started on first use. It binds the dedicated upload OpenGL
+        context of the window, which shares all objects with the main context, and processes
+        queued uploads in order: Conversion of the input matrix via PsychConvertTexturePlanes()
+        directly into a mapped pixel unpack buffer, which gets orphaned for each upload to
+        allow streaming, followed by a glTexSubImage2D() from that buffer.
+
+        Synchronization between the contexts uses ARB_sync fences if supported: A fence after
+        storage allocation in the main context, which the uploader waits for on the GPU before
+        its upload, and a fence after the upload, which the main context waits for on the GPU
+        before first use of the texture. Without ARB_sync, glFinish() is used instead.
+
+        Any use of a texture with a pending upload, e.g., by Screen('DrawTexture'), first calls
+        PsychFinishTextureUpload(), which waits for the uploader to get done with the texture,
+        unless it already is. Screen('PreloadTextures') allows to wait for completion of, or
+        to poll for, all pending uploads.
+
+        Other modules can queue uploads of ready to use pixel data via PsychQueueRawTextureUpload(),
+        e.g., the movie playback engine for prefetching of decoded video frames. The pixel data is
+        copied into the pixel buffer on the uploader thread, and the texture storage is allocated
+        there as well if no texture is given. Completion, or cancellation at window close, is
+        reported to a callback, which then owns the returned texture and fence.
+
+*/
+
+#include "Screen.h"
+
+typedef enum {
+    kPsychUploadQueued = 0,
+    kPsychUploadInProgress = 1,
+    kPsychUploadDone = 2,
+    kPsychUploadCancelled = 3
+} PsychTextureUploadState;
+
+struct PsychTextureUploadJob {
+    PsychTextureUploader*   uploader;       // Uploader of this job, or NULL if uploader is gone. Only accessed by main thread.
+    PsychTextureUploadJob*  next;           // Next job in queue of uploader.
+    PsychTextureUploadState state;          // Protected by mutex of uploader.
+    void*                   image;          // Private copy of input image matrix, released after upload.
+    PsychArgFormatType      imageType;
+    size_t                  npixels;
+    int                     nplanes;
+    int                     order[4];
+    psych_bool              dstfloat;
+    psych_bool              flushTiny;      // Set values of magnitude < 1e-9 to zero, for FLOAT16 textures.
+    double                  scale;
+    double                  offset;
+    GLuint                  texture;
+    GLenum                  target;
+    GLsizei                 width;
+    GLsizei                 height;
+    GLenum                  format;
+    GLenum                  type;
+    size_t                  size;           // Size of converted image in bytes.
+    GLsync                  createFence;    // Fence after storage allocation in main context, or 0.
+    GLsync                  doneFence;      // Fence after upload in upload context, or 0.
+    const void*             pixels;         // Raw jobs only: Pixel data to copy, owned by the caller until completion.
+    GLint                   internalFormat; // Raw jobs only: Internal format for storage allocation if texture is 0.
+    int                     alignment;      // Raw jobs only: Row alignment of pixel data.
+    PsychTextureUploadDoneCallback doneCallback; // Completion callback of raw jobs, NULL for regular jobs.
+    void*                   doneArg;
+};
+
+struct PsychTextureUploader {
+    PsychWindowRecordType*  windowRecord;   // Onscreen window whose upload context is used.
+    psych_thread            thread;
+    psych_mutex             mutex;
+    psych_condition         jobCondition;   // Signalled on new job or shutdown request.
+    psych_condition         doneCondition;  // Broadcast on completion of any job.
+    PsychTextureUploadJob*  head;           // Queue of pending jobs, protected by mutex.
+    PsychTextureUploadJob*  tail;
+    psych_bool              shutdown;
+    psych_bool              useFences;      // ARB_sync supported?
+    GLuint                  pbo;            // Streaming pixel unpack buffer, only accessed by uploader thread.
+};
+
+static size_t PsychGetElementSize(PsychArgFormatType type)
+{
+    switch (type) {
+        case PsychArgType_uint8:
+            return(1);
+        case PsychArgType_uint16:
+            return(2);
+        case PsychArgType_single:
+            return(4);
+        default:
+            return(8);
+    }
+}
+
+// Bind the upload context of the onscreen window to the calling thread. Like in
+// PsychFlipperThreadMain(), this is done here directly, as the uploader thread is the
+// only user of this context:
+static void PsychBindUploadContext(PsychWindowRecordType *windowRecord, psych_bool bind)
+{
+    #if PSYCH_SYSTEM == PSYCH_OSX
+        CGLSetCurrentContext((bind) ? windowRecord->targetSpecific.gluploadcontextObject : NULL);
+    #endif
+
+    #if PSYCH_SYSTEM == PSYCH_LINUX
+        PsychLockDisplay();
+        #ifndef PTB_USE_WAFFLE
+            if (bind)
+                glXMakeCurrent(windowRecord->targetSpecific.deviceContext, windowRecord->targetSpecific.windowHandle, windowRecord->targetSpecific.gluploadcontextObject);
+            else
+                glXMakeCurrent(windowRecord->targetSpecific.deviceContext, None, NULL);
+        #else
+            if (bind) {
+                if (!waffle_make_current(windowRecord->targetSpecific.deviceContext, windowRecord->targetSpecific.windowHandle, windowRecord->targetSpecific.gluploadcontextObject) &&
+                    (PsychPrefStateGet_Verbosity() > 0)) {
+                    fprintf(stderr, "PTB-ERROR: Failed to bind OpenGL context for texture upload thread [%s]! This will end badly...\n", waffle_error_to_string(waffle_error_get_code()));
+                }
+            }
+            else {
+                waffle_make_current(windowRecord->targetSpecific.deviceContext, NULL, NULL);
+            }
+        #endif
+        PsychUnlockDisplay();
+    #endif
+
+    #if PSYCH_SYSTEM == PSYCH_WINDOWS
+        wglMakeCurrent((bind) ? windowRecord->targetSpecific.deviceContext : NULL, (bind) ? windowRecord->targetSpecific.gluploadcontextObject : NULL);
+    #endif
+}
+
+// Convert and upload the image of one job into its texture. Called by the uploader thread:
+static void PsychProcessTextureUpload(PsychTextureUploader *uploader, PsychTextureUploadJob *job)
+{
+    void *pixels = NULL;
+    psych_bool mapped = FALSE;
+    float *f;
+    size_t i;
+
+    // Texture storage must be allocated by the main context before we can update it:
+    if (job->createFence) {
+        glWaitSync(job->createFence, 0, GL_TIMEOUT_IGNORED);
+        glDeleteSync(job->createFence);
+        job->createFence = 0;
+    }
+
+    // Raw jobs without texture need a new one, which gets allocated here:
+    if (job->doneCallback && (job->texture == 0)) {
+        glGenTextures(1, &(job->texture));
+        glBindTexture(job->target, job->texture);
+        glTexImage2D(job->target, 0, job->internalFormat, job->width, job->height, 0, job->format, job->type, NULL);
+        glBindTexture(job->target, 0);
+    }
+
+    // Orphan the previous storage of the buffer, so we don't stall on a still ongoing
+    // upload from it, then convert directly into the mapped new storage:
+    if (uploader->pbo) {
+        glBindBuffer(GL_PIXEL_UNPACK_BUFFER, uploader->pbo);
+        glBufferData(GL_PIXEL_UNPACK_BUFFER, (GLsizeiptr) job->size, NULL, GL_STREAM_DRAW);
+        pixels = glMapBuffer(GL_PIXEL_UNPACK_BUFFER, GL_WRITE_ONLY);
+        if (pixels) mapped = TRUE;
+        else glBindBuffer(GL_PIXEL_UNPACK_BUFFER, 0);
+    }
+
+    // Fallback to a system memory buffer if mapping failed:
+    if (!mapped) pixels = malloc(job->size);
+
+    if (pixels) {
+        if (job->doneCallback) {
+            // Raw pixel data only needs a copy, with its own row alignment:
+            memcpy(pixels, job->pixels, job->size);
+            glPixelStorei(GL_UNPACK_ALIGNMENT, job->alignment);
+        }
+        else {
+            PsychConvertTexturePlanes(job->image, job->imageType, job->npixels, job->nplanes, job->order, pixels, job->dstfloat, job->scale, job->offset);
+        }
+
+        // Same workaround for FLOAT16 texture creation as in SCREENMakeTexture():
+        if (job->flushTiny) {
+            f = (float*) pixels;
+            for (i = 0; i < job->npixels * (size_t) job->nplanes; i++) if (fabs((double) f[i]) < 1e-9) f[i] = 0.0;
+        }
+
+        glBindTexture(job->target, job->texture);
+        if (mapped) {
+            // A failed unmap means the buffer content got lost, e.g., due to a display mode switch:
+            if (glUnmapBuffer(GL_PIXEL_UNPACK_BUFFER)) {
+                glTexSubImage2D(job->target, 0, 0, 0, job->width, job->height, job->format, job->type, NULL);
+            }
+            else if (PsychPrefStateGet_Verbosity() > 1) {
+                fprintf(stderr, "PTB-WARNING: Asynchronous texture upload failed due to loss of pixel buffer content! Texture content will be undefined.\n");
+            }
+            glBindBuffer(GL_PIXEL_UNPACK_BUFFER, 0);
+        }
+        else {
+            glTexSubImage2D(job->target, 0, 0, 0, job->width, job->height, job->format, job->type, pixels);
+            free(pixels);
+        }
+        glBindTexture(job->target, 0);
+        glPixelStorei(GL_UNPACK_ALIGNMENT, 1);
+    }
+    else if (PsychPrefStateGet_Verbosity() > 0) {
+        fprintf(stderr, "PTB-ERROR: Out of memory in asynchronous texture upload! Texture content will be undefined.\n");
+    }
+
+    free(job->image);
+    job->image = NULL;
+
+    // Make completion visible to the main context:
+    if (uploader->useFences) {
+        job->doneFence = glFenceSync(GL_SYNC_GPU_COMMANDS_COMPLETE, 0);
+        glFlush();
+    }
+    else {
+        glFinish();
+    }
+}
+
+static void* PsychTextureUploaderMain(void* arg)
+{
+    PsychTextureUploader *uploader = (PsychTextureUploader*) arg;
+    PsychTextureUploadJob *job;
+
+    PsychSetThreadName("PTBUploader");
+
+    PsychBindUploadContext(uploader->windowRecord, TRUE);
+
+    // Pixel data of our uploads is always tightly packed:
+    glPixelStorei(GL_UNPACK_ALIGNMENT, 1);
+    glPixelStorei(GL_UNPACK_ROW_LENGTH, 0);
+    glGenBuffers(1, &(uploader->pbo));
+
+    PsychLockMutex(&(uploader->mutex));
+    while (TRUE) {
+        // Wait for a new job or shutdown:
+        while ((NULL == uploader->head) && !uploader->shutdown) PsychWaitCondition(&(uploader->jobCondition), &(uploader->mutex));
+        if (NULL == uploader->head) break;
+
+        // Dequeue and process next job:
+        job = uploader->head;
+        uploader->head = job->next;
+        if (NULL == uploader->head) uploader->tail = NULL;
+        job->next = NULL;
+        job->state = kPsychUploadInProgress;
+        PsychUnlockMutex(&(uploader->mutex));
+
+        PsychProcessTextureUpload(uploader, job);
+
+        // Raw jobs are done after handing texture and fence to their callback:
+        if (job->doneCallback) {
+            job->doneCallback(job->doneArg, job->texture, job->doneFence, FALSE);
+            free(job);
+            PsychLockMutex(&(uploader->mutex));
+            continue;
+        }
+
+        PsychLockMutex(&(uploader->mutex));
+        job->state = kPsychUploadDone;
+        PsychBroadcastCondition(&(uploader->doneCondition));
+    }
+    PsychUnlockMutex(&(uploader->mutex));
+
+    glBindBuffer(GL_PIXEL_UNPACK_BUFFER, 0);
+    if (uploader->pbo) glDeleteBuffers(1, &(uploader->pbo));
+    uploader->pbo = 0;
+    glFinish();
+
+    PsychBindUploadContext(uploader->windowRecord, FALSE);
+
+    return(NULL);
+}
+
+// Check if asynchronous texture creation is supported for onscreen window 'windowRecord',
+// and start its uploader thread if not already running. Returns TRUE if supported:
+psych_bool PsychGetTextureUploader(PsychWindowRecordType *windowRecord)
+{
+    PsychTextureUploader *uploader;
+    int rc;
+
+    if (windowRecord->textureUploader) return(TRUE);
+
+    // Need a dedicated upload context, desktop OpenGL and pixel buffer objects. Client storage
+    // textures are incompatible, as they require their texture memory to stay around:
+    if (!windowRecord->targetSpecific.gluploadcontextObject || PsychIsGLES(windowRecord) || !glewIsSupported("GL_ARB_pixel_buffer_object") ||
+        (PsychPrefStateGet_ConserveVRAM() & kPsychDontCacheTextures)) {
+        if (PsychPrefStateGet_Verbosity() > 3)
+            printf("PTB-INFO: Asynchronous texture creation unsupported on window %i. Creating textures synchronously.\n", windowRecord->windowIndex);
+        return(FALSE);
+    }
+
+    uploader = (PsychTextureUploader*) calloc(1, sizeof(PsychTextureUploader));
+    if (NULL == uploader) PsychErrorExitMsg(PsychError_outofMemory, "Out of memory while trying to setup asynchronous texture creation!");
+
+    uploader->windowRecord = windowRecord;
+    uploader->useFences = glewIsSupported("GL_ARB_sync") ? TRUE : FALSE;
+    PsychInitMutex(&(uploader->mutex));
+    PsychInitCondition(&(uploader->jobCondition), NULL);
+    PsychInitCondition(&(uploader->doneCondition), NULL);
+
+    // Start the conversion worker pool from our thread, so the uploader thread only uses it:
+    PsychGetTextureConversionThreads();
+
+    if ((rc = PsychCreateThread(&(uploader->thread), NULL, PsychTextureUploaderMain, (void*) uploader))) {
+        if (PsychPrefStateGet_Verbosity() > 1)
+            printf("PTB-WARNING: Failed to start texture upload thread [%s]. Creating textures synchronously.\n", strerror(rc));
+
+        PsychDestroyCondition(&(uploader->doneCondition));
+        PsychDestroyCondition(&(uploader->jobCondition));
+        PsychDestroyMutex(&(uploader->mutex));
+        free(uploader);
+
+        // Don't try again for this window:
+        windowRecord->targetSpecific.gluploadcontextObject = NULL;
+        return(FALSE);
+    }
+
+    windowRecord->textureUploader = uploader;
+
+    if (PsychPrefStateGet_Verbosity() > 4)
+        printf("PTB-DEBUG: Asynchronous texture creation enabled for window %i, %s.\n", windowRecord->windowIndex, (uploader->useFences) ? "using fences" : "without fences");
+
+    return(TRUE);
+}
+
+// Return the external 'format' and 'type' of pixel data for upload into texture 'textureRecord',
+// the same as in PsychCreateTexture() for desktop OpenGL:
+void PsychGetTextureUploadFormat(PsychWindowRecordType *textureRecord, GLenum *format, GLenum *type)
+{
+    if (textureRecord->textureinternalformat == 0) {
+        *type = GL_UNSIGNED_BYTE;
+        switch (textureRecord->depth) {
+            case 8:
+                *format = GL_LUMINANCE;
+                break;
+
+            case 16:
+                *format = GL_LUMINANCE_ALPHA;
+                break;
+
+            case 24:
+                *format = GL_RGB;
+                break;
+
+            default:
+                *format = GL_BGRA;
+                if (!(textureRecord->gfxcaps & kPsychGfxCapNeedsUnsignedByteRGBATextureUpload)) *type = GL_UNSIGNED_INT_8_8_8_8_REV;
+        }
+    }
+    else {
+        *format = textureRecord->textureexternalformat;
+        *type = textureRecord->textureexternaltype;
+    }
+}
+
+// Queue upload of 'image' into the already created texture 'textureRecord'. The image is
+// copied, so the caller can release it. 'nplanes', 'order', 'dstfloat', 'scale' and 'offset'
+// are passed to PsychConvertTexturePlanes() for conversion. Must be called right after
+// PsychCreateTexture() with a NULL textureMemory, while the context of the texture is bound:
+void PsychQueueTextureUpload(PsychWindowRecordType *windowRecord, PsychWindowRecordType *textureRecord, const void* image, PsychArgFormatType imageType,
+                             int nplanes, const int* order, psych_bool dstfloat, double scale, double offset, psych_bool flushTiny)
+{
+    PsychTextureUploader *uploader = windowRecord->textureUploader;
+    PsychTextureUploadJob *job;
+    size_t imagesize;
+    int i;
+
+    job = (PsychTextureUploadJob*) calloc(1, sizeof(PsychTextureUploadJob));
+    if (NULL == job) PsychErrorExitMsg(PsychError_outofMemory, "Out of memory while trying to create texture asynchronously!");
+
+    // Width and height of the texture image, as computed by PsychCreateTexture():
+    if (textureRecord->textureOrientation == 0 || textureRecord->textureOrientation == 1) {
+        job->width = (GLsizei) PsychGetHeightFromRect(textureRecord->rect);
+        job->height = (GLsizei) PsychGetWidthFromRect(textureRecord->rect);
+    }
+    else {
+        job->width = (GLsizei) PsychGetWidthFromRect(textureRecord->rect);
+        job->height = (GLsizei) PsychGetHeightFromRect(textureRecord->rect);
+    }
+
+    job->npixels = (size_t) job->width * (size_t) job->height;
+    imagesize = job->npixels * (size_t) nplanes * PsychGetElementSize(imageType);
+    job->image = malloc(imagesize);
+    if (NULL == job->image) {
+        free(job);
+        PsychErrorExitMsg(PsychError_outofMemory, "Out of memory while trying to create texture asynchronously!");
+    }
+    memcpy(job->image, image, imagesize);
+
+    job->uploader = uploader;
+    job->state = kPsychUploadQueued;
+    job->imageType = imageType;
+    job->nplanes = nplanes;
+    for (i = 0; i < 4; i++) job->order[i] = (i < nplanes) ? order[i] : 0;
+    job->dstfloat = dstfloat;
+    job->flushTiny = flushTiny;
+    job->scale = scale;
+    job->offset = offset;
+    job->size = job->npixels * (size_t) nplanes * ((dstfloat) ? sizeof(GLfloat) : sizeof(GLubyte));
+    job->texture = textureRecord->textureNumber;
+    job->target = PsychGetTextureTarget(textureRecord);
+
+    PsychGetTextureUploadFormat(textureRecord, &(job->format), &(job->type));
+
+    // Make the storage allocation visible to the upload context:
+    if (uploader->useFences) {
+        job->createFence = glFenceSync(GL_SYNC_GPU_COMMANDS_COMPLETE, 0);
+        glFlush();
+    }
+    else {
+        glFinish();
+    }
+
+    textureRecord->textureUploadJob = job;
+
+    PsychLockMutex(&(uploader->mutex));
+    if (uploader->tail) uploader->tail->next = job;
+    else uploader->head = job;
+    uploader->tail = job;
+    PsychSignalCondition(&(uploader->jobCondition));
+    PsychUnlockMutex(&(uploader->mutex));
+}
+
+// Queue upload of 'size' bytes of ready to use pixel data 'pixels' of a 'width' x 'height' image
+// with given 'format', 'type' and row 'alignment' into 'texture'. If 'texture' is 0, a new texture
+// of 'internalFormat' gets created. 'pixels' must stay valid until 'doneCallback' gets called with
+// 'doneArg', the texture and a fence for the upload, or 0 without ARB_sync. The callback is called
+// on the uploader thread, or with 'cancelled' TRUE from PsychDeleteTextureUploader(). Requires a
+// running uploader, ie., a successful PsychGetTextureUploader(), and the context of 'windowRecord'
+// to be bound:
+void PsychQueueRawTextureUpload(PsychWindowRecordType *windowRecord, GLuint texture, GLenum target, GLint internalFormat, int width, int height,
+                                GLenum format, GLenum type, int alignment, const void* pixels, size_t size,
+                                PsychTextureUploadDoneCallback doneCallback, void* doneArg)
+{
+    PsychTextureUploader *uploader = windowRecord->textureUploader;
+    PsychTextureUploadJob *job;
+
+    job = (PsychTextureUploadJob*) calloc(1, sizeof(PsychTextureUploadJob));
+    if (NULL == job) PsychErrorExitMsg(PsychError_outofMemory, "Out of memory while trying to queue texture upload!");
+
+    job->uploader = uploader;
+    job->state = kPsychUploadQueued;
+    job->texture = texture;
+    job->target = target;
+    job->internalFormat = internalFormat;
+    job->width = (GLsizei) width;
+    job->height = (GLsizei) height;
+    job->format = format;
+    job->type = type;
+    job->alignment = alignment;
+    job->pixels = pixels;
+    job->size = size;
+    job->doneCallback = doneCallback;
+    job->doneArg = doneArg;
+
+    // A recycled texture may still be in use by the main context:
+    if (texture) {
+        if (uploader->useFences) {
+            job->createFence = glFenceSync(GL_SYNC_GPU_COMMANDS_COMPLETE, 0);
+            glFlush();
+        }
+        else {
+            glFinish();
+        }
+    }
+
+    PsychLockMutex(&(uploader->mutex));
+    if (uploader->tail) uploader->tail->next = job;
+    else uploader->head = job;
+    uploader->tail = job;
+    PsychSignalCondition(&(uploader->jobCondition));
+    PsychUnlockMutex(&(uploader->mutex));
+}
+
+// Wait for the job of 'textureRecord' to complete, or cancel it if 'cancel' is TRUE and the
+// uploader didn't start on it yet, then release it:
+static void PsychRetireTextureUploadJob(PsychWindowRecordType *textureRecord, psych_bool cancel)
+{
+    PsychTextureUploadJob *job = textureRecord->textureUploadJob;
+    PsychTextureUploader *uploader;
+    PsychTextureUploadJob **prev;
+
+    textureRecord->textureUploadJob = NULL;
+
+    if ((uploader = job->uploader)) {
+        PsychLockMutex(&(uploader->mutex));
+        if (cancel && (job->state == kPsychUploadQueued)) {
+            // Unlink from queue:
+            for (prev = &(uploader->head); *prev != job; prev = &((*prev)->next));
+            *prev = job->next;
+            if (uploader->tail == job) {
+                for (uploader->tail = uploader->head; uploader->tail && uploader->tail->next; uploader->tail = uploader->tail->next);
+            }
+            job->state = kPsychUploadCancelled;
+        }
+
+        while (job->state < kPsychUploadDone) PsychWaitCondition(&(uploader->doneCondition), &(uploader->mutex));
+        PsychUnlockMutex(&(uploader->mutex));
+    }
+
+    // Wait on the GPU for the upload to complete before the texture gets used. The fences
+    // are gone with the OpenGL context, if the texture already lost its context:
+    if (textureRecord->targetSpecific.contextObject && (job->createFence || job->doneFence)) {
+        PsychSetGLContext(textureRecord);
+        if (job->doneFence) {
+            glWaitSync(job->doneFence, 0, GL_TIMEOUT_IGNORED);
+            glDeleteSync(job->doneFence);
+        }
+
+        if (job->createFence) glDeleteSync(job->createFence);
+    }
+
+    free(job->image);
+    free(job);
+}
+
+// Return TRUE if the asynchronous upload of the texture is not yet done. Doesn't block:
+psych_bool PsychIsTextureUploadPending(PsychWindowRecordType *textureRecord)
+{
+    PsychTextureUploadJob *job = textureRecord->textureUploadJob;
+    psych_bool pending;
+
+    if ((NULL == job) || (NULL == job->uploader)) return(FALSE);
+
+    PsychLockMutex(&(job->uploader->mutex));
+    pending = (job->state < kPsychUploadDone) ? TRUE : FALSE;
+    PsychUnlockMutex(&(job->uploader->mutex));
+
+    return(pending);
+}
+
+// Make sure the texture has its final content, waiting for its asynchronous upload if
+// needed. Must be called before any use of a texture. This may change the bound OpenGL
+// context to the one of the texture:
+void PsychFinishTextureUpload(PsychWindowRecordType *textureRecord)
+{
+    if (textureRecord->textureUploadJob) PsychRetireTextureUploadJob(textureRecord, FALSE);
+}
+
+// Cancel the asynchronous upload of a texture, e.g., because it gets closed:
+void PsychCancelTextureUpload(PsychWindowRecordType *textureRecord)
+{
+    if (textureRecord->textureUploadJob) PsychRetireTextureUploadJob(textureRecord, TRUE);
+}
+
+// Stop the uploader thread of an onscreen window. Still queued uploads are cancelled.
+// Called at window close time, before the OpenGL contexts get destroyed:
+void PsychDeleteTextureUploader(PsychWindowRecordType *windowRecord)
+{
+    PsychTextureUploader *uploader = windowRecord->textureUploader;
+    PsychTextureUploadJob *job, *rawJobs = NULL, *next;
+    PsychWindowRecordType **windowRecordArray;
+    int i, numWindows;
+
+    if (NULL == uploader) return;
+    windowRecord->textureUploader = NULL;
+
+    PsychLockMutex(&(uploader->mutex));
+    for (job = uploader->head; job; job = next) {
+        next = job->next;
+        job->state = kPsychUploadCancelled;
+
+        // Raw jobs are owned by us, collect them for cancellation:
+        if (job->doneCallback) {
+            job->next = rawJobs;
+            rawJobs = job;
+        }
+    }
+    uploader->head = uploader->tail = NULL;
+    uploader->shutdown = TRUE;
+    PsychSignalCondition(&(uploader->jobCondition));
+    PsychUnlockMutex(&(uploader->mutex));
+
+    PsychDeleteThread(&(uploader->thread));
+
+    // Report cancellation of still queued raw jobs to their owners:
+    for (job = rawJobs; job; job = next) {
+        next = job->next;
+        if (job->createFence) glDeleteSync(job->createFence);
+        job->doneCallback(job->doneArg, job->texture, 0, TRUE);
+        free(job);
+    }
+
+    // Detach all jobs of still open textures from us:
+    PsychCreateVolatileWindowRecordPointerList(&numWindows, &windowRecordArray);
+    for (i = 0; i < numWindows; i++) {
+        if (windowRecordArray[i]->textureUploadJob && (windowRecordArray[i]->textureUploadJob->uploader == uploader))
+            windowRecordArray[i]->textureUploadJob->uploader = NULL;
+    }
+    PsychDestroyVolatileWindowRecordPointerList(windowRecordArray);
+
+    PsychDestroyCondition(&(uploader->doneCondition));
+    PsychDestroyCondition(&(uploader->jobCondition));
+    PsychDestroyMutex(&(uploader->mutex));
+    free(uploader);
+}
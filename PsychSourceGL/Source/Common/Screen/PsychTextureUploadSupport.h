@@ -0,0 +1,47 @@
+/*
+    Common/Screen/PsychTextureUploadSupport.h
+
+    PLATFORMS:
+
+        All.
+
+    AUTHORS:
+
+        agent           agent  agent@local
+
+    HISTORY:
+
+        10/18/26    agent Wrote it.
+
+    DESCRIPTION:
+
+        Asynchronous texture creation for Screen('MakeTexture'): Conversion and upload of
+        image matrices into already allocated textures on a per-window background thread,
+        which uses its own OpenGL context, shared with the windows context. Also used for
+        uploads of raw pixel data, e.g., prefetched movie frames.
+
+*/
+
+//include once
+#ifndef PSYCH_IS_INCLUDED_PsychTextureUploadSupport
+#define PSYCH_IS_INCLUDED_PsychTextureUploadSupport
+
+#include "Screen.h"
+
+// Completion callback of PsychQueueRawTextureUpload():
+typedef void (*PsychTextureUploadDoneCallback)(void* arg, GLuint texture, GLsync fence, psych_bool cancelled);
+
+psych_bool  PsychGetTextureUploader(PsychWindowRecordType *windowRecord);
+void        PsychGetTextureUploadFormat(PsychWindowRecordType *textureRecord, GLenum *format, GLenum *type);
+void        PsychQueueTextureUpload(PsychWindowRecordType *windowRecord, PsychWindowRecordType *textureRecord, const void* image, PsychArgFormatType imageType,
+                                    int nplanes, const int* order, psych_bool dstfloat, double scale, double offset, psych_bool flushTiny);
+void        PsychQueueRawTextureUpload(PsychWindowRecordType *windowRecord, GLuint texture, GLenum target, GLint internalFormat, int width, int height,
+                                       GLenum format, GLenum type, int alignment, const void* pixels, size_t size,
+                                       PsychTextureUploadDoneCallback doneCallback, void* doneArg);
+psych_bool  PsychIsTextureUploadPending(PsychWindowRecordType *textureRecord);
+void        PsychFinishTextureUpload(PsychWindowRecordType *textureRecord);
+void        PsychCancelTextureUpload(PsychWindowRecordType *textureRecord);
+void        PsychDeleteTextureUploader(PsychWindowRecordType *windowRecord);
+
+//end include once
+#endif
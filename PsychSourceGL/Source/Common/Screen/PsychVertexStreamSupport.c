@@ -0,0 +1,613 @@
+/*
+    Common/Screen/PsychVertexStreamSupport.c
+
+    PLATFORMS:
+
+        All.
+
+    AUTHORS:
+
+        agent           agent  agent@local
+
+    HISTORY:
+
+        10/18/26    agent Wrote it.
+
+    DESCRIPTION:
+
+        Streaming vertex buffer for the batch drawing functions of Screen, e.g., 'DrawDots',
+        'DrawLines' and 'FillRect'.
+
+        Client side vertex arrays require the driver to copy all vertex data at each draw
+        call, often after a conversion from double to float. Instead, the batch functions
+        write the vertices of a batch, with optional per-vertex colors and point sizes, in
+        an interleaved float layout directly into a vertex buffer object, then draw the
+        whole batch with a single glDrawArrays() call. The glyph atlas text renderer uses
+        the same buffer for the glyph quads of a string, with texture coordinates.
+
+        Each onscreen window, ie., each OpenGL context, has one such buffer, split into
+        three segments which are filled round-robin. If the GL_ARB_buffer_storage extension
+        is supported, the buffer is persistently and coherently mapped once, and a fence at
+        the end of each segment makes sure a segment is only overwritten after the GPU is
+        done with it. Without persistent mapping, each batch gets appended via an
+        unsynchronized glMapBufferRange(), and the buffer gets orphaned when it is full. The
+        buffer grows if a single batch doesn't fit into one segment.
+
+        Batches of 'DrawTextures' without any shader are drawn instanced: The buffer takes
+        one record per quad, with destination rectangle, texture coordinate rectangle, rotation
+        and modulate color, and a static unit quad is drawn once per record with a small
+        shader which places, rotates and textures it, in a single glDrawArraysInstanced() call.
+        This needs OpenGL 3.3, or the GL_ARB_draw_instanced and GL_ARB_instanced_arrays
+        extensions.
+
+        Streaming is only used with desktop OpenGL. It can be disabled by setting the
+        environment variable PSYCH_VERTEX_STREAM=0, in which case the batch functions use
+        their client side vertex arrays or immediate mode as before.
+
+*/
+
+#include "Screen.h"
+
+#define PSYCH_VERTEX_STREAM_SEGMENTS        3
+#define PSYCH_VERTEX_STREAM_MINSEGMENTSIZE  (1024 * 1024)
+#define PSYCH_VERTEX_STREAM_ALIGNMENT       64
+
+struct PsychVertexStream {
+    GLuint          vbo;                // Vertex buffer object, 0 if streaming is unsupported.
+    psych_bool      persistent;         // TRUE if vbo is persistently mapped via GL_ARB_buffer_storage.
+    unsigned char*  base;               // Persistent mapping of the whole vbo, NULL otherwise.
+    size_t          segmentSize;        // Size of one segment in bytes. The vbo has PSYCH_VERTEX_STREAM_SEGMENTS segments.
+    int             segment;            // Segment which is currently filled.
+    size_t          offset;             // Offset of the next free byte in the vbo.
+    GLsync          fences[PSYCH_VERTEX_STREAM_SEGMENTS];  // Fences after last use of each segment, 0 if none pending.
+    psych_bool      mapped;             // TRUE if a non-persistent mapping is active.
+    size_t          batchOffset;        // Offset of the current batch in the vbo.
+    int             layout;             // Vertex layout of the current batch.
+    int             stride;             // Size of one vertex of the current batch in bytes.
+    unsigned int    batches;
+    unsigned int    waits;              // Number of waits for the GPU to release a segment.
+    int             instancing;         // Support for instanced drawing of quads: 0 = unknown, 1 = yes, -1 = no.
+    GLuint          quadVBO;            // Static unit quad for instanced drawing.
+    GLuint          quadPrograms[3];    // Shaders for instanced quads with GL_TEXTURE_2D, GL_TEXTURE_RECTANGLE_EXT or no texture.
+    GLint           quadAttribs[3][4];  // Locations of dstRect, texRect, rotation, modulateColor in quadPrograms.
+    GLint           quadSwapTexCoords[3];
+    unsigned int    quadProgramsTried;  // Bit i set if creation of quadPrograms[i] was tried.
+    PFNGLDRAWARRAYSINSTANCEDPROC    drawArraysInstanced;
+    PFNGLVERTEXATTRIBDIVISORPROC    vertexAttribDivisor;
+};
+
+static int useVertexStream = -1;
+
+// Shaders for instanced drawing of textured quads in 'DrawTextures'. Each instance places the unit
+// quad 'corner' at its destination rectangle and texture coordinate rectangle, applies its rotation
+// in the same way as the immediate mode path, ie., either around the center of the quad or of the
+// texture coordinates, and modulates the texture with its color:
+static char quadInstanceVertexShaderSrc[] =
+"attribute vec2 corner; \n"
+"attribute vec4 dstRect; \n"
+"attribute vec4 texRect; \n"
+"attribute vec4 rotation; \n"
+"attribute vec4 modulateColor; \n"
+"uniform float swapTexCoords; \n"
+"\n"
+"void main() \n"
+"{ \n"
+"    vec2 pos = mix(dstRect.xy, dstRect.zw, corner); \n"
+"    vec2 tc = (swapTexCoords > 0.5) ? mix(texRect.xy, texRect.zw, corner.yx) : mix(texRect.xw, texRect.zy, corner); \n"
+"    mat2 rot = mat2(rotation.x, rotation.y, -rotation.y, rotation.x); \n"
+"\n"
+"    if (rotation.z == 1.0) pos = rot * (pos - 0.5 * (dstRect.xy + dstRect.zw)) + 0.5 * (dstRect.xy + dstRect.zw); \n"
+"    if (rotation.z == 2.0) tc = rot * (tc - 0.5 * (texRect.xy + texRect.zw)) + 0.5 * (texRect.xy + texRect.zw); \n"
+"\n"
+"    gl_Position = gl_ModelViewProjectionMatrix * vec4(pos, 0.0, 1.0); \n"
+"    gl_TexCoord[0] = gl_TextureMatrix[0] * vec4(tc, 0.0, 1.0); \n"
+"    gl_FrontColor = modulateColor; \n"
+"} \n";
+
+static char quadInstance2DFragmentShaderSrc[] =
+"uniform sampler2D Image; \n"
+"\n"
+"void main() \n"
+"{ \n"
+"    gl_FragColor = texture2D(Image, gl_TexCoord[0].st) * gl_Color; \n"
+"} \n";
+
+static char quadInstanceRectFragmentShaderSrc[] =
+"#extension GL_ARB_texture_rectangle : enable \n"
+"\n"
+"uniform sampler2DRect Image; \n"
+"\n"
+"void main() \n"
+"{ \n"
+"    gl_FragColor = texture2DRect(Image, gl_TexCoord[0].st) * gl_Color; \n"
+"} \n";
+
+static char quadInstanceUntexturedFragmentShaderSrc[] =
+"void main() \n"
+"{ \n"
+"    gl_FragColor = gl_Color; \n"
+"} \n";
+
+// Size in bytes of one vertex of the given layout:
+static int PsychGetVertexStreamStride(int layout)
+{
+    return((int) sizeof(float) * (2 + ((layout & kPsychVertexStreamColors) ? 4 : 0) + ((layout & kPsychVertexStreamSizes) ? 1 : 0) +
+                                  ((layout & kPsychVertexStreamTexCoords) ? 2 : 0)));
+}
+
+// Release the vbo and fences of 'stream'. Needs the OpenGL context of the stream bound:
+static void PsychReleaseVertexStreamBuffer(PsychVertexStream *stream)
+{
+    int i;
+
+    for (i = 0; i < PSYCH_VERTEX_STREAM_SEGMENTS; i++) {
+        if (stream->fences[i]) glDeleteSync(stream->fences[i]);
+        stream->fences[i] = 0;
+    }
+
+    if (stream->vbo) {
+        glBindBuffer(GL_ARRAY_BUFFER, stream->vbo);
+        if (stream->base || stream->mapped) glUnmapBuffer(GL_ARRAY_BUFFER);
+        glBindBuffer(GL_ARRAY_BUFFER, 0);
+        glDeleteBuffers(1, &stream->vbo);
+    }
+
+    stream->vbo = 0;
+    stream->base = NULL;
+    stream->mapped = FALSE;
+}
+
+// (Re-)Create the vbo of 'stream' with segments of at least 'segmentSize' bytes, leave it bound:
+static psych_bool PsychAllocVertexStreamBuffer(PsychVertexStream *stream, size_t segmentSize)
+{
+    GLbitfield flags = GL_MAP_WRITE_BIT | GL_MAP_PERSISTENT_BIT | GL_MAP_COHERENT_BIT;
+    size_t size;
+
+    PsychReleaseVertexStreamBuffer(stream);
+
+    // Round up to a power of two, so growing buffers don't get reallocated too often:
+    size = PSYCH_VERTEX_STREAM_MINSEGMENTSIZE;
+    while (size < segmentSize) size *= 2;
+    stream->segmentSize = size;
+    size *= PSYCH_VERTEX_STREAM_SEGMENTS;
+
+    glGenBuffers(1, &stream->vbo);
+    glBindBuffer(GL_ARRAY_BUFFER, stream->vbo);
+
+    if (stream->persistent) {
+        glBufferStorage(GL_ARRAY_BUFFER, (GLsizeiptr) size, NULL, flags);
+        stream->base = (unsigned char*) glMapBufferRange(GL_ARRAY_BUFFER, 0, (GLsizeiptr) size, flags);
+    }
+    else {
+        glBufferData(GL_ARRAY_BUFFER, (GLsizeiptr) size, NULL, GL_STREAM_DRAW);
+    }
+
+    if (stream->persistent && (NULL == stream->base)) {
+        glBindBuffer(GL_ARRAY_BUFFER, 0);
+        glDeleteBuffers(1, &stream->vbo);
+        stream->vbo = 0;
+        return(FALSE);
+    }
+
+    stream->segment = 0;
+    stream->offset = 0;
+
+    if (PsychPrefStateGet_Verbosity() > 4)
+        printf("PTB-DEBUG: Using %s vertex stream buffer of %i kB for batch drawing.\n", (stream->persistent) ? "persistently mapped" : "orphaned",
+               (int) (size / 1024));
+
+    return(TRUE);
+}
+
+// Return the vertex stream of the OpenGL context of 'windowRecord', or NULL if streaming can't be used:
+static PsychVertexStream* PsychGetVertexStream(PsychWindowRecordType *windowRecord)
+{
+    PsychWindowRecordType *parentRecord;
+    PsychVertexStream *stream;
+
+    if (useVertexStream < 0) {
+        useVertexStream = (getenv("PSYCH_VERTEX_STREAM") && (atoi(getenv("PSYCH_VERTEX_STREAM")) == 0)) ? 0 : 1;
+        if (!useVertexStream && (PsychPrefStateGet_Verbosity() > 4)) printf("PTB-DEBUG: Vertex stream for batch drawing disabled.\n");
+    }
+
+    if (!useVertexStream || !PsychIsGLClassic(windowRecord)) return(NULL);
+
+    parentRecord = PsychGetParentWindow(windowRecord);
+    if (!PsychIsOnscreenWindow(parentRecord) || (parentRecord->targetSpecific.contextObject == NULL) ||
+        (parentRecord->targetSpecific.contextObject != windowRecord->targetSpecific.contextObject))
+        return(NULL);
+
+    stream = parentRecord->vertexStream;
+    if (NULL == stream) {
+        stream = (PsychVertexStream*) calloc(1, sizeof(PsychVertexStream));
+        if (NULL == stream) return(NULL);
+        parentRecord->vertexStream = stream;
+
+        // Only create a buffer if the driver supports buffer mapping with explicit synchronization.
+        // Otherwise the stream stays without vbo, so we don't try again:
+        if (glewIsSupported("GL_VERSION_3_0") || glewIsSupported("GL_ARB_map_buffer_range")) {
+            stream->persistent = (glewIsSupported("GL_ARB_buffer_storage") && glewIsSupported("GL_ARB_sync")) ? TRUE : FALSE;
+            if (!PsychAllocVertexStreamBuffer(stream, 0) && stream->persistent) {
+                stream->persistent = FALSE;
+                PsychAllocVertexStreamBuffer(stream, 0);
+            }
+            glBindBuffer(GL_ARRAY_BUFFER, 0);
+        }
+    }
+
+    return((stream->vbo) ? stream : NULL);
+}
+
+static float* PsychMapVertexStreamRecords(PsychVertexStream *stream, int nrrecords, int layout, int stride);
+
+// Allocate space for a batch of 'nrvertices' vertices of the given 'layout' in the vertex stream
+// of 'windowRecord', and bind the stream. Returns a pointer for writing the interleaved vertex data,
+// or NULL if streaming can't be used, in which case the caller must use client side vertex arrays.
+// Called with the OpenGL context of 'windowRecord' bound, e.g., after PsychPrepareRenderBatch().
+// The caller must not make any OpenGL calls until PsychEnableVertexStream() is called:
+float* PsychMapVertexStream(PsychWindowRecordType *windowRecord, int nrvertices, int layout)
+{
+    PsychVertexStream *stream;
+
+    if ((nrvertices < 1) || (NULL == (stream = PsychGetVertexStream(windowRecord)))) return(NULL);
+
+    return(PsychMapVertexStreamRecords(stream, nrvertices, layout, PsychGetVertexStreamStride(layout)));
+}
+
+// Allocate space for 'nrrecords' records of 'stride' bytes in 'stream' and bind it, as described
+// for PsychMapVertexStream():
+static float* PsychMapVertexStreamRecords(PsychVertexStream *stream, int nrrecords, int layout, int stride)
+{
+    void *dst;
+    size_t bytes;
+    int i;
+
+    // Previous batch aborted by an error between mapping and drawing? Finish its mapping:
+    glBindBuffer(GL_ARRAY_BUFFER, stream->vbo);
+    if (stream->mapped) glUnmapBuffer(GL_ARRAY_BUFFER);
+    stream->mapped = FALSE;
+
+    stream->layout = layout;
+    stream->stride = stride;
+    bytes = (size_t) nrrecords * (size_t) stream->stride;
+    bytes = (bytes + PSYCH_VERTEX_STREAM_ALIGNMENT - 1) & ~((size_t) PSYCH_VERTEX_STREAM_ALIGNMENT - 1);
+
+    // Grow the buffer if the batch doesn't fit into a segment:
+    if ((bytes > stream->segmentSize) && !PsychAllocVertexStreamBuffer(stream, bytes)) {
+        // Out of memory for persistent mapping:
+        glBindBuffer(GL_ARRAY_BUFFER, 0);
+        return(NULL);
+    }
+
+    if (stream->persistent) {
+        // Batch doesn't fit into the remainder of the current segment? Fence the current segment
+        // and move on to the next one, waiting for the GPU to finish drawing from its last use:
+        if (stream->offset + bytes > (size_t) (stream->segment + 1) * stream->segmentSize) {
+            stream->fences[stream->segment] = glFenceSync(GL_SYNC_GPU_COMMANDS_COMPLETE, 0);
+            stream->segment = (stream->segment + 1) % PSYCH_VERTEX_STREAM_SEGMENTS;
+            stream->offset = (size_t) stream->segment * stream->segmentSize;
+
+            i = stream->segment;
+            if (stream->fences[i]) {
+                if (glClientWaitSync(stream->fences[i], GL_SYNC_FLUSH_COMMANDS_BIT, 0) == GL_TIMEOUT_EXPIRED) {
+                    stream->waits++;
+                    while (glClientWaitSync(stream->fences[i], GL_SYNC_FLUSH_COMMANDS_BIT, 1000000000) == GL_TIMEOUT_EXPIRED);
+                }
+                glDeleteSync(stream->fences[i]);
+                stream->fences[i] = 0;
+            }
+        }
+
+        stream->batchOffset = stream->offset;
+        stream->offset += bytes;
+        stream->batches++;
+
+        return((float*) (stream->base + stream->batchOffset));
+    }
+
+    // Orphan the buffer when it is full. The driver keeps the old storage until the GPU is done with it:
+    if (stream->offset + bytes > (size_t) PSYCH_VERTEX_STREAM_SEGMENTS * stream->segmentSize) {
+        glBufferData(GL_ARRAY_BUFFER, (GLsizeiptr) (PSYCH_VERTEX_STREAM_SEGMENTS * stream->segmentSize), NULL, GL_STREAM_DRAW);
+        stream->offset = 0;
+    }
+
+    // Append the batch behind previous batches, which are never overwritten, so no synchronization is needed:
+    stream->batchOffset = stream->offset;
+    stream->mapped = TRUE;
+    dst = glMapBufferRange(GL_ARRAY_BUFFER, (GLintptr) stream->batchOffset, (GLsizeiptr) bytes,
+                           GL_MAP_WRITE_BIT | GL_MAP_INVALIDATE_RANGE_BIT | GL_MAP_UNSYNCHRONIZED_BIT);
+    if (NULL == dst) {
+        stream->mapped = FALSE;
+        glBindBuffer(GL_ARRAY_BUFFER, 0);
+        return(NULL);
+    }
+
+    stream->offset += bytes;
+    stream->batches++;
+
+    return((float*) dst);
+}
+
+// Store the RGBA color of item 'i' of a color vector with 'mc' components per item, as returned by
+// PsychPrepareRenderBatch(), at 'dst' as 4 floats. Returns the position behind the stored color:
+float* PsychStoreVertexStreamColor(float *dst, int i, int mc, double *colors, unsigned char *bytecolors)
+{
+    if (colors) {
+        colors += i * mc;
+        *(dst++) = (float) colors[0];
+        *(dst++) = (float) colors[1];
+        *(dst++) = (float) colors[2];
+        *(dst++) = (mc == 4) ? (float) colors[3] : 1.0f;
+    }
+    else {
+        bytecolors += i * mc;
+        *(dst++) = (float) bytecolors[0] / 255.0f;
+        *(dst++) = (float) bytecolors[1] / 255.0f;
+        *(dst++) = (float) bytecolors[2] / 255.0f;
+        *(dst++) = (mc == 4) ? (float) bytecolors[3] / 255.0f : 1.0f;
+    }
+
+    return(dst);
+}
+
+// Write 'nrvertices' vertices with positions 'xy', and colors and sizes as requested by 'layout', as
+// returned by PsychPrepareRenderBatch(), in interleaved layout to 'dst'. Texture coordinates are
+// not handled here:
+void PsychFillVertexStream(float *dst, int nrvertices, int layout, double *xy, int mc, double *colors, unsigned char *bytecolors, double *size)
+{
+    int i;
+
+    for (i = 0; i < nrvertices; i++) {
+        *(dst++) = (float) xy[i * 2];
+        *(dst++) = (float) xy[i * 2 + 1];
+        if (layout & kPsychVertexStreamColors) dst = PsychStoreVertexStreamColor(dst, i, mc, colors, bytecolors);
+        if (layout & kPsychVertexStreamSizes) *(dst++) = (float) size[i];
+    }
+}
+
+// Setup the vertex arrays for drawing the batch which was written after PsychMapVertexStream():
+// Positions as vertex array, colors as color array, or as texture coordinate set 0 if a default
+// draw shader is active for unclamped high precision colors, point sizes as texture coordinate
+// set 2, texture coordinates as set 0. The batch starts at vertex 0 for glDrawArrays():
+void PsychEnableVertexStream(PsychWindowRecordType *windowRecord)
+{
+    PsychVertexStream *stream = PsychGetParentWindow(windowRecord)->vertexStream;
+    const unsigned char *offset = (const unsigned char*) (size_t) stream->batchOffset;
+
+    if (stream->mapped) glUnmapBuffer(GL_ARRAY_BUFFER);
+    stream->mapped = FALSE;
+
+    glVertexPointer(2, GL_FLOAT, stream->stride, offset);
+    glEnableClientState(GL_VERTEX_ARRAY);
+    offset += 2 * sizeof(float);
+
+    if (stream->layout & kPsychVertexStreamColors) {
+        if (windowRecord->defaultDrawShader) {
+            glTexCoordPointer(4, GL_FLOAT, stream->stride, offset);
+            glEnableClientState(GL_TEXTURE_COORD_ARRAY);
+        }
+        else {
+            glColorPointer(4, GL_FLOAT, stream->stride, offset);
+            glEnableClientState(GL_COLOR_ARRAY);
+        }
+        offset += 4 * sizeof(float);
+    }
+
+    if (stream->layout & kPsychVertexStreamSizes) {
+        glClientActiveTexture(GL_TEXTURE2);
+        glTexCoordPointer(1, GL_FLOAT, stream->stride, offset);
+        glEnableClientState(GL_TEXTURE_COORD_ARRAY);
+        glClientActiveTexture(GL_TEXTURE0);
+        offset += sizeof(float);
+    }
+
+    if (stream->layout & kPsychVertexStreamTexCoords) {
+        glTexCoordPointer(2, GL_FLOAT, stream->stride, offset);
+        glEnableClientState(GL_TEXTURE_COORD_ARRAY);
+    }
+}
+
+// Undo PsychEnableVertexStream() after drawing, and unbind the stream:
+void PsychDisableVertexStream(PsychWindowRecordType *windowRecord)
+{
+    PsychVertexStream *stream = PsychGetParentWindow(windowRecord)->vertexStream;
+
+    glDisableClientState(GL_VERTEX_ARRAY);
+
+    if (stream->layout & kPsychVertexStreamColors) {
+        if (windowRecord->defaultDrawShader) {
+            glDisableClientState(GL_TEXTURE_COORD_ARRAY);
+        }
+        else {
+            glDisableClientState(GL_COLOR_ARRAY);
+        }
+    }
+
+    if (stream->layout & kPsychVertexStreamSizes) {
+        glClientActiveTexture(GL_TEXTURE2);
+        glDisableClientState(GL_TEXTURE_COORD_ARRAY);
+        glClientActiveTexture(GL_TEXTURE0);
+    }
+
+    if (stream->layout & kPsychVertexStreamTexCoords) glDisableClientState(GL_TEXTURE_COORD_ARRAY);
+
+    glBindBuffer(GL_ARRAY_BUFFER, 0);
+
+    // Client side array pointers are expected to be NULL when unused:
+    glVertexPointer(2, PSYCHGLFLOAT, 0, NULL);
+    glColorPointer(4, PSYCHGLFLOAT, 0, NULL);
+    glTexCoordPointer(4, PSYCHGLFLOAT, 0, NULL);
+}
+
+// Return index of the instanced quad shader for 'texturetarget', 0 for untextured quads, after
+// creating it on first use, or -1 if it can't be used:
+static int PsychGetQuadInstanceProgram(PsychVertexStream *stream, GLenum texturetarget)
+{
+    static const char* attribNames[4] = { "dstRect", "texRect", "rotation", "modulateColor" };
+    const char* fragmentsrc;
+    GLuint glsl;
+    GLint status;
+    int i, j;
+
+    switch (texturetarget) {
+        case GL_TEXTURE_2D:
+            i = 0;
+            fragmentsrc = quadInstance2DFragmentShaderSrc;
+            break;
+
+        case GL_TEXTURE_RECTANGLE_EXT:
+            i = 1;
+            fragmentsrc = quadInstanceRectFragmentShaderSrc;
+            break;
+
+        case 0:
+            i = 2;
+            fragmentsrc = quadInstanceUntexturedFragmentShaderSrc;
+            break;
+
+        default:
+            return(-1);
+    }
+
+    if (!(stream->quadProgramsTried & (1 << i))) {
+        stream->quadProgramsTried |= (1 << i);
+
+        glsl = PsychCreateGLSLProgram(fragmentsrc, quadInstanceVertexShaderSrc, NULL);
+        if (glsl) {
+            // The unit quad must be generic attribute 0, so it provokes the vertices. Relink to apply:
+            glBindAttribLocation(glsl, 0, "corner");
+            glLinkProgram(glsl);
+            glGetProgramiv(glsl, GL_LINK_STATUS, &status);
+            if (status != GL_TRUE) {
+                glDeleteProgram(glsl);
+                glsl = 0;
+            }
+        }
+
+        if (glsl) {
+            for (j = 0; j < 4; j++) stream->quadAttribs[i][j] = glGetAttribLocation(glsl, attribNames[j]);
+            stream->quadSwapTexCoords[i] = glGetUniformLocation(glsl, "swapTexCoords");
+            glUseProgram(glsl);
+            if (i < 2) glUniform1i(glGetUniformLocation(glsl, "Image"), 0);
+            glUseProgram(0);
+        }
+        else if (PsychPrefStateGet_Verbosity() > 4) {
+            printf("PTB-DEBUG: Failed to create shader for instanced drawing of quads. Using immediate mode.\n");
+        }
+
+        stream->quadPrograms[i] = glsl;
+    }
+
+    return((stream->quadPrograms[i]) ? i : -1);
+}
+
+// Allocate space for 'nrinstances' quad records of kPsychQuadInstanceFloats floats each, for textures
+// of 'texturetarget' or untextured quads for a 'texturetarget' of 0, in the vertex stream of
+// 'windowRecord', and bind the stream. Returns a pointer for writing the records, or NULL if instanced
+// drawing can't be used. Each record consists of destination rectangle [left, top, right, bottom],
+// texture coordinate rectangle [x, y, xEnd, yEnd], rotation [cos, sin, mode, 0] with mode 1 for
+// rotation of the quad, 2 for rotation of texture coordinates, 0 for none, and RGBA modulate color.
+// Called with the OpenGL context of 'windowRecord' bound and its texture and shader setup done:
+float* PsychMapQuadInstances(PsychWindowRecordType *windowRecord, int nrinstances, GLenum texturetarget)
+{
+    static const GLfloat corners[8] = { 0, 0, 0, 1, 1, 1, 1, 0 };
+    PsychVertexStream *stream;
+
+    if ((nrinstances < 1) || (NULL == (stream = PsychGetVertexStream(windowRecord)))) return(NULL);
+
+    if (stream->instancing == 0) {
+        stream->instancing = -1;
+        if (glewIsSupported("GL_VERSION_3_3")) {
+            stream->drawArraysInstanced = glDrawArraysInstanced;
+            stream->vertexAttribDivisor = glVertexAttribDivisor;
+        }
+        else if (glewIsSupported("GL_ARB_draw_instanced") && glewIsSupported("GL_ARB_instanced_arrays")) {
+            stream->drawArraysInstanced = (PFNGLDRAWARRAYSINSTANCEDPROC) glDrawArraysInstancedARB;
+            stream->vertexAttribDivisor = (PFNGLVERTEXATTRIBDIVISORPROC) glVertexAttribDivisorARB;
+        }
+
+        if (stream->drawArraysInstanced && stream->vertexAttribDivisor) {
+            glGenBuffers(1, &stream->quadVBO);
+            glBindBuffer(GL_ARRAY_BUFFER, stream->quadVBO);
+            glBufferData(GL_ARRAY_BUFFER, sizeof(corners), corners, GL_STATIC_DRAW);
+            glBindBuffer(GL_ARRAY_BUFFER, 0);
+            stream->instancing = 1;
+        }
+
+        if (PsychPrefStateGet_Verbosity() > 4)
+            printf("PTB-DEBUG: Instanced drawing of quads for 'DrawTextures' %s.\n", (stream->instancing > 0) ? "enabled" : "unsupported");
+    }
+
+    if ((stream->instancing < 0) || (PsychGetQuadInstanceProgram(stream, texturetarget) < 0)) return(NULL);
+
+    return(PsychMapVertexStreamRecords(stream, nrinstances, 0, kPsychQuadInstanceFloats * sizeof(float)));
+}
+
+// Draw the first 'nrinstances' quad records written after PsychMapQuadInstances() with the same
+// 'texturetarget', with the texture bound to texture unit 0. 'swapTexCoords' selects texture
+// coordinates for textures which are stored transposed, ie., a textureOrientation other than 2, 3 or 4.
+// Leaves the fixed function pipeline bound, and the stream unbound:
+void PsychDrawQuadInstances(PsychWindowRecordType *windowRecord, int nrinstances, GLenum texturetarget, psych_bool swapTexCoords)
+{
+    PsychVertexStream *stream = PsychGetParentWindow(windowRecord)->vertexStream;
+    const unsigned char *offset = (const unsigned char*) (size_t) stream->batchOffset;
+    int i, j;
+
+    if (stream->mapped) glUnmapBuffer(GL_ARRAY_BUFFER);
+    stream->mapped = FALSE;
+
+    i = PsychGetQuadInstanceProgram(stream, texturetarget);
+    glUseProgram(stream->quadPrograms[i]);
+    if (stream->quadSwapTexCoords[i] >= 0) glUniform1f(stream->quadSwapTexCoords[i], (swapTexCoords) ? 1.0f : 0.0f);
+
+    // Per-instance attributes from the stream:
+    for (j = 0; j < 4; j++) {
+        if (stream->quadAttribs[i][j] < 0) continue;
+        glVertexAttribPointer(stream->quadAttribs[i][j], 4, GL_FLOAT, GL_FALSE, stream->stride, offset + j * 4 * sizeof(float));
+        glEnableVertexAttribArray(stream->quadAttribs[i][j]);
+        stream->vertexAttribDivisor(stream->quadAttribs[i][j], 1);
+    }
+
+    // Unit quad corners:
+    glBindBuffer(GL_ARRAY_BUFFER, stream->quadVBO);
+    glVertexAttribPointer(0, 2, GL_FLOAT, GL_FALSE, 0, NULL);
+    glEnableVertexAttribArray(0);
+
+    stream->drawArraysInstanced(GL_TRIANGLE_FAN, 0, 4, nrinstances);
+    stream->batches++;
+
+    glDisableVertexAttribArray(0);
+    for (j = 0; j < 4; j++) {
+        if (stream->quadAttribs[i][j] < 0) continue;
+        stream->vertexAttribDivisor(stream->quadAttribs[i][j], 0);
+        glDisableVertexAttribArray(stream->quadAttribs[i][j]);
+    }
+
+    glBindBuffer(GL_ARRAY_BUFFER, 0);
+    glUseProgram(0);
+}
+
+// Delete the vertex stream of an onscreen window. Called at window close time, with the OpenGL
+// context of the window bound:
+void PsychDeleteVertexStream(PsychWindowRecordType *windowRecord)
+{
+    PsychVertexStream *stream = windowRecord->vertexStream;
+    int i;
+
+    if (NULL == stream) return;
+    windowRecord->vertexStream = NULL;
+
+    if ((PsychPrefStateGet_Verbosity() > 4) && stream->vbo) {
+        printf("PTB-DEBUG: Vertex stream of window %i: %i batches drawn, %i waits for GPU.\n", windowRecord->windowIndex, stream->batches, stream->waits);
+    }
+
+    PsychReleaseVertexStreamBuffer(stream);
+
+    for (i = 0; i < 3; i++) {
+        if (stream->quadPrograms[i]) glDeleteProgram(stream->quadPrograms[i]);
+    }
+
+    if (stream->quadVBO) glDeleteBuffers(1, &stream->quadVBO);
+
+    free(stream);
+}
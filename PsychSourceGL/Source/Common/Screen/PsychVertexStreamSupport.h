@@ -0,0 +1,47 @@
+/*
+    Common/Screen/PsychVertexStreamSupport.h
+
+    PLATFORMS:
+
+        All.
+
+    AUTHORS:
+
+        agent           agent  agent@local
+
+    HISTORY:
+
+        10/18/26    agent Wrote it.
+
+    DESCRIPTION:
+
+        Per-context streaming vertex buffer for the batch drawing functions of Screen, e.g.,
+        'DrawDots', 'DrawLines' and 'FillRect', and instanced drawing of quads for 'DrawTextures'.
+
+*/
+
+//include once
+#ifndef PSYCH_IS_INCLUDED_PsychVertexStreamSupport
+#define PSYCH_IS_INCLUDED_PsychVertexStreamSupport
+
+#include "Screen.h"
+
+// Optional per-vertex attributes, following the x,y position of each vertex:
+#define kPsychVertexStreamColors    1   // RGBA color as 4 floats.
+#define kPsychVertexStreamSizes     2   // Point size as 1 float.
+#define kPsychVertexStreamTexCoords 4   // Texture coordinates for texture unit 0 as 2 floats. Not combinable with colors if a draw shader is active.
+
+// Floats per quad record for PsychMapQuadInstances(): Destination rect, texture coordinate rect, rotation, modulate color:
+#define kPsychQuadInstanceFloats    16
+
+float*      PsychMapVertexStream(PsychWindowRecordType *windowRecord, int nrvertices, int layout);
+float*      PsychStoreVertexStreamColor(float *dst, int i, int mc, double *colors, unsigned char *bytecolors);
+void        PsychFillVertexStream(float *dst, int nrvertices, int layout, double *xy, int mc, double *colors, unsigned char *bytecolors, double *size);
+void        PsychEnableVertexStream(PsychWindowRecordType *windowRecord);
+void        PsychDisableVertexStream(PsychWindowRecordType *windowRecord);
+float*      PsychMapQuadInstances(PsychWindowRecordType *windowRecord, int nrinstances, GLenum texturetarget);
+void        PsychDrawQuadInstances(PsychWindowRecordType *windowRecord, int nrinstances, GLenum texturetarget, psych_bool swapTexCoords);
+void        PsychDeleteVertexStream(PsychWindowRecordType *windowRecord);
+
+//end include once
+#endif
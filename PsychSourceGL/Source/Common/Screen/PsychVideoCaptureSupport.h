@@ -93,6 +93,24 @@ double PsychGSVideoCaptureSetParameter(int capturehandle, const char* pname, dou
 PsychVideosourceRecordType* PsychGSEnumerateVideoSources(int outPos, int deviceIndex, GstElement **videocaptureplugin);
 void PsychGSExitVideoCapture(void);
 
+// Video frame in the CPU-side frame ring of a GStreamer capture device, mapped read-only. Shared by
+// reference count between the ring and all consumers, and valid until the last of them released it:
+typedef struct PsychCaptureFrame {
+    const void*     data;           // Image data of width x height pixels with depth channels of bitdepth bits each.
+    int             width;
+    int             height;
+    int             depth;
+    int             bitdepth;
+    double          timestamp;      // Capture timestamp in the same timebase as returned by 'GetCapturedImage'.
+    unsigned int    frameIndex;     // Running count of frames stored in the ring.
+    gint            refcount;
+    GstBuffer*      buffer;
+    GstMapInfo      mapinfo;
+} PsychCaptureFrame;
+
+PsychCaptureFrame* PsychGSAcquireCaptureFrame(int capturehandle, int age);
+void PsychGSReleaseCaptureFrame(PsychCaptureFrame* frame);
+
 // PsychGetCodecLaunchLineFromString() - Helper function for GStreamer based movie writing.
 psych_bool PsychGetCodecLaunchLineFromString(char* codecSpec, char* launchString);
 
@@ -136,6 +136,11 @@ typedef struct {
     char* cameraFriendlyName;         // Camera friendly device name.
     char videosourcename[100];        // Plugin name of the videosource plugin.
     void* markerTrackerPlugin;        // Opaque pointer to instance handle of a markerTrackerPlugin.
+    psych_bool videoProbeAttached;    // PsychHaveVideoDataCallback() attached to the sink pad of videosink?
+    PsychCaptureFrame** frameRing;    // CPU-side ring of the most recently captured frames, or NULL if disabled.
+    int frameRingSize;                // Number of slots in frameRing.
+    int frameRingHead;                // Slot in frameRing for the next captured frame.
+    unsigned int frameRingCount;      // Total count of frames stored in frameRing.
 } PsychVidcapRecordType;
 
 static PsychVidcapRecordType vidcapRecordBANK[PSYCH_MAX_CAPTUREDEVICES];
@@ -157,6 +162,7 @@ static bool (*TrackerPlugin_processPluginDataBuffer)(void* handle, unsigned long
 // Forward declaration of internal helper function:
 void PsychGSDeleteAllCaptureDevices(void);
 int PsychGSDrainBufferQueue(PsychVidcapRecordType* capdev, int numFramesToDrain, unsigned int flags);
+static void PsychGSSetFrameRingSize(PsychVidcapRecordType* capdev, int ringSize);
 
 
 /*    PsychGetGSVidcapRecord() -- Given a handle, return ptr to video capture record.
@@ -334,11 +340,14 @@ void PsychGSCheckInit(const char* engineName)
         }
 
         // Select opmode of GStreamers master clock:
-        // We use monotonic clock on Windows and OS/X, as these correspond to the
-        // clocks we use for GetSecs(), but realtime clock on Linux:
+        // We use monotonic clock on all systems. On Windows and OS/X it corresponds to the
+        // clock we use for GetSecs(). On Linux, GetSecs() is CLOCK_MONOTONIC plus an offset
+        // by default, but the timebase is selectable, so PsychGSGetBufferTimestamp() remaps
+        // timestamps to GetSecs() time. The realtime clock would be off by any step of the
+        // system time since startup:
         system_clock = gst_system_clock_obtain();
         if (system_clock) {
-            g_object_set(G_OBJECT(system_clock), "clock-type", ((PSYCH_SYSTEM == PSYCH_LINUX) ? GST_CLOCK_TYPE_REALTIME : GST_CLOCK_TYPE_MONOTONIC), NULL);
+            g_object_set(G_OBJECT(system_clock), "clock-type", GST_CLOCK_TYPE_MONOTONIC, NULL);
         }
         if (PsychPrefStateGet_Verbosity() > 3) printf("PTB-INFO: Using GStreamer version '%s'.\n", (char*) gst_version_string());
 
@@ -749,6 +758,9 @@ void PsychGSCloseVideoCaptureDevice(int capturehandle)
     if (capdev->VideoContext) g_main_loop_unref(capdev->VideoContext);
     capdev->VideoContext = NULL;
 
+    // Release our references to the frames in the frame ring. Consumers may still hold their own:
+    PsychGSSetFrameRingSize(capdev, 0);
+
     PsychDestroyMutex(&capdev->mutex);
     PsychDestroyCondition(&capdev->condition);
 
@@ -2877,6 +2889,126 @@ psych_bool PsychGetCodecLaunchLineFromString(char* codecSpec, char* launchString
     return(PsychSetupRecordingPipeFromString(&dummydev, codecSpec, launchString, TRUE, FALSE, FALSE));
 }
 
+/* PsychGSGetBufferTimestamp: Return capture timestamp of videoBuffer, either in pipeline running time
+ * if recordingflags & 64, or in GetSecs time.
+ */
+static double PsychGSGetBufferTimestamp(PsychVidcapRecordType *capdev, GstBuffer *videoBuffer)
+{
+    GstClockTime baseTime;
+
+    // Retrieve raw buffer timestamp - pipeline running time:
+    if (capdev->recordingflags & 64) return((double) GST_BUFFER_PTS(videoBuffer) / (double) 1e9);
+
+    // Add base time to convert running time buffer timestamp into absolute time:
+    baseTime = gst_element_get_base_time(capdev->camera);
+    if (baseTime == 0) baseTime = capdev->lastSavedBaseTime;
+
+    #if PSYCH_SYSTEM == PSYCH_LINUX
+    // Remap CLOCK_MONOTONIC time to GetSecs time:
+    return(PsychOSMonotonicToRefTime((double) (GST_BUFFER_PTS(videoBuffer) + baseTime) / (double) 1e9));
+    #else
+    // Apply corrective offset for GStreamer clock base zero point:
+    return((double) (GST_BUFFER_PTS(videoBuffer) + baseTime) / (double) 1e9 + gs_startupTime);
+    #endif
+}
+
+/* PsychGSReleaseCaptureFrame: Release one reference to a frame from the frame ring. The last
+ * reference unmaps the frame and returns its buffer to GStreamer. Doesn't touch the capture
+ * device, so consumers can release their frames after the device got closed.
+ */
+void PsychGSReleaseCaptureFrame(PsychCaptureFrame* frame)
+{
+    if (frame && g_atomic_int_dec_and_test(&frame->refcount)) {
+        gst_buffer_unmap(frame->buffer, &frame->mapinfo);
+        gst_buffer_unref(frame->buffer);
+        free(frame);
+    }
+}
+
+/* PsychGSAcquireCaptureFrame: Return a new reference to the frame of the given 'age' in the frame ring,
+ * zero for the most recently captured frame, or NULL if there isn't such a frame. The caller must
+ * release it via PsychGSReleaseCaptureFrame() once done with it.
+ */
+PsychCaptureFrame* PsychGSAcquireCaptureFrame(int capturehandle, int age)
+{
+    PsychVidcapRecordType *capdev = PsychGetGSVidcapRecord(capturehandle);
+    PsychCaptureFrame *frame = NULL;
+
+    PsychLockMutex(&capdev->mutex);
+    if (capdev->frameRing && (age >= 0) && (age < capdev->frameRingSize)) {
+        frame = capdev->frameRing[(capdev->frameRingHead - 1 - age + 2 * capdev->frameRingSize) % capdev->frameRingSize];
+        if (frame) g_atomic_int_inc(&frame->refcount);
+    }
+    PsychUnlockMutex(&capdev->mutex);
+
+    return(frame);
+}
+
+/* PsychGSAcquireRingFrameForBuffer: Return a new reference to the frame in the frame ring which
+ * holds videoBuffer, or NULL if it isn't in the ring.
+ */
+static PsychCaptureFrame* PsychGSAcquireRingFrameForBuffer(PsychVidcapRecordType *capdev, GstBuffer *videoBuffer)
+{
+    PsychCaptureFrame *frame = NULL;
+    int i;
+
+    if (!capdev->frameRing) return(NULL);
+
+    PsychLockMutex(&capdev->mutex);
+    for (i = 0; capdev->frameRing && (i < capdev->frameRingSize); i++) {
+        if (capdev->frameRing[i] && (capdev->frameRing[i]->buffer == videoBuffer)) {
+            frame = capdev->frameRing[i];
+            g_atomic_int_inc(&frame->refcount);
+            break;
+        }
+    }
+    PsychUnlockMutex(&capdev->mutex);
+
+    return(frame);
+}
+
+/* PsychGSStoreRingFrame: Map videoBuffer read-only and store it as most recent frame in the frame ring,
+ * releasing the ring's reference to the oldest frame. Called on the streaming thread.
+ */
+static void PsychGSStoreRingFrame(PsychVidcapRecordType *capdev, GstBuffer *videoBuffer)
+{
+    PsychCaptureFrame *frame, *oldframe;
+
+    frame = (PsychCaptureFrame*) calloc(1, sizeof(PsychCaptureFrame));
+    if (NULL == frame) return;
+
+    if (!gst_buffer_map(videoBuffer, &frame->mapinfo, GST_MAP_READ)) {
+        free(frame);
+        return;
+    }
+
+    frame->buffer = gst_buffer_ref(videoBuffer);
+    frame->data = frame->mapinfo.data;
+    frame->width = capdev->frame_width;
+    frame->height = capdev->frame_height;
+    frame->depth = (capdev->reqpixeldepth != 2) ? capdev->reqpixeldepth : 1;
+    frame->bitdepth = (capdev->bitdepth > 8) ? 16 : 8;
+    frame->timestamp = PsychGSGetBufferTimestamp(capdev, videoBuffer);
+
+    // This is the ring's reference:
+    frame->refcount = 1;
+
+    PsychLockMutex(&capdev->mutex);
+    if (capdev->frameRing) {
+        frame->frameIndex = capdev->frameRingCount++;
+        oldframe = capdev->frameRing[capdev->frameRingHead];
+        capdev->frameRing[capdev->frameRingHead] = frame;
+        capdev->frameRingHead = (capdev->frameRingHead + 1) % capdev->frameRingSize;
+    }
+    else {
+        // Ring got disabled meanwhile:
+        oldframe = frame;
+    }
+    PsychUnlockMutex(&capdev->mutex);
+
+    PsychGSReleaseCaptureFrame(oldframe);
+}
+
 /* PsychHaveVideoDataCallback: This is used if an external C plugin, e.g., video LoadMarkerTrackingPlugin
  * is loaded to execute that plugin on the most recently arrived video input buffer. The callback is attached
  * to the sink-pad of our videosink appsink, so the callback gets executed for each incoming buffer on the
@@ -2924,9 +3056,64 @@ static GstPadProbeReturn PsychHaveVideoDataCallback(GstPad *pad, GstPadProbeInfo
         gst_buffer_unmap(videoBuffer, &mapinfo);
     }
 
+    // Frame ring enabled? Keep this frame mapped in the ring. Must be done after the markertracker,
+    // as the extra reference makes the buffer read-only:
+    if (capdev->frameRing) PsychGSStoreRingFrame(capdev, videoBuffer);
+
     return(GST_PAD_PROBE_OK);
 }
 
+/* PsychGSAttachVideoDataProbe: Attach PsychHaveVideoDataCallback() to the sink pad of the videosink,
+ * unless it is already attached.
+ */
+static void PsychGSAttachVideoDataProbe(PsychVidcapRecordType *capdev)
+{
+    GstPad *pad;
+
+    if (capdev->videoProbeAttached) return;
+
+    // Get the sink pad from the videosink, where our to-be-processed video frames arrive on the streaming thread:
+    pad = gst_element_get_static_pad(capdev->videosink, "sink");
+
+    // Add a pad probe callback PsychHaveVideoDataCallback(). This gets called on each received buffer
+    // from the streaming thread. If a markertracker/data processing plugin is loaded, the PsychHaveVideoDataCallback()
+    // will map the received video buffer and execute the plugin on it, and if the frame ring is enabled it will
+    // store the buffer in the ring, otherwise the callback no-ops:
+    gst_pad_add_probe(pad, GST_PAD_PROBE_TYPE_BUFFER, PsychHaveVideoDataCallback, capdev, NULL);
+    gst_object_unref(pad);
+
+    capdev->videoProbeAttached = TRUE;
+}
+
+/* PsychGSSetFrameRingSize: Resize the frame ring to ringSize frames, or disable it for a ringSize of zero.
+ * Frames in the old ring are released, ie. the new ring starts empty.
+ */
+static void PsychGSSetFrameRingSize(PsychVidcapRecordType* capdev, int ringSize)
+{
+    PsychCaptureFrame **oldRing, **newRing = NULL;
+    int i, oldSize;
+
+    if (ringSize > 0) {
+        newRing = (PsychCaptureFrame**) calloc(ringSize, sizeof(PsychCaptureFrame*));
+        if (NULL == newRing) PsychErrorExitMsg(PsychError_outofMemory, "Out of memory while trying to allocate frame ring for video capture!");
+    }
+
+    PsychLockMutex(&capdev->mutex);
+    oldRing = capdev->frameRing;
+    oldSize = capdev->frameRingSize;
+    capdev->frameRing = newRing;
+    capdev->frameRingSize = ringSize;
+    capdev->frameRingHead = 0;
+    PsychUnlockMutex(&capdev->mutex);
+
+    if (oldRing) {
+        for (i = 0; i < oldSize; i++) PsychGSReleaseCaptureFrame(oldRing[i]);
+        free(oldRing);
+    }
+
+    if (newRing) PsychGSAttachVideoDataProbe(capdev);
+}
+
 /*
  *      PsychGSOpenVideoCaptureDevice() -- Create a video capture object.
  *
@@ -4575,7 +4762,6 @@ int PsychGSGetTextureFromCapture(PsychWindowRecordType *win, int capturehandle,
     GstBuffer *videoBuffer = NULL;
     GstSample *videoSample = NULL;
     double deltaT = 0;
-    GstClockTime baseTime;
 
     int waitforframe;
     int w, h;
@@ -4586,6 +4772,7 @@ int PsychGSGetTextureFromCapture(PsychWindowRecordType *win, int capturehandle,
     double tstart, tend;
     int nrdropped = 0;
     unsigned char* input_image = NULL;
+    PsychCaptureFrame *ringFrame = NULL;
 
     // Disable warning about missing field initializer in calls
     // like GstMapInfo mapinfo = = GST_MAP_INFO_INIT;
@@ -4770,31 +4957,27 @@ int PsychGSGetTextureFromCapture(PsychWindowRecordType *win, int capturehandle,
     if (videoSample) {
         videoBuffer = gst_sample_get_buffer(videoSample);
 
-        // Map the buffers memory for reading:
-        if (!gst_buffer_map(videoBuffer, &mapinfo, GST_MAP_READ)) {
-            printf("PTB-ERROR: Failed to map video data of captured video frame! Something's wrong. Aborting fetch.\n");
-            gst_buffer_unref(videoBuffer);
-            videoBuffer = NULL;
-            return(-1);
+        // Is this buffer already mapped in the frame ring? Then share the ring's mapping:
+        ringFrame = PsychGSAcquireRingFrameForBuffer(capdev, videoBuffer);
+        if (ringFrame) {
+            input_image = (unsigned char*) ringFrame->data;
+            capdev->current_pts = ringFrame->timestamp;
         }
+        else {
+            // Map the buffers memory for reading:
+            if (!gst_buffer_map(videoBuffer, &mapinfo, GST_MAP_READ)) {
+                printf("PTB-ERROR: Failed to map video data of captured video frame! Something's wrong. Aborting fetch.\n");
+                gst_sample_unref(videoSample);
+                videoBuffer = NULL;
+                return(-1);
+            }
 
-        // Assign pointer to videoBuffer's data directly: Avoids one full data copy compared to oldstyle method.
-        // input_image points to the image buffer in our cam:
-        input_image = (unsigned char*) (GLuint*) mapinfo.data;
-
-        // Assign pts presentation timestamp in pipeline stream time and convert to seconds:
-        if (capdev->recordingflags & 64) {
-            // Retrieve raw buffer timestamp - pipeline running time.
-            capdev->current_pts = (double) GST_BUFFER_PTS(videoBuffer) / (double) 1e9;
-        } else {
-            // Add base time to convert running time buffer timestamp into absolute time:
-            baseTime = gst_element_get_base_time(capdev->camera);
-            if (baseTime == 0) baseTime = capdev->lastSavedBaseTime;
-
-            capdev->current_pts = (double) (GST_BUFFER_PTS(videoBuffer) + baseTime) / (double) 1e9;
+            // Assign pointer to videoBuffer's data directly: Avoids one full data copy compared to oldstyle method.
+            // input_image points to the image buffer in our cam:
+            input_image = (unsigned char*) (GLuint*) mapinfo.data;
 
-            // Apply corrective offset for GStreamer clock base zero point:
-            capdev->current_pts+= gs_startupTime;
+            // Assign pts presentation timestamp in pipeline stream time or GetSecs time, in seconds:
+            capdev->current_pts = PsychGSGetBufferTimestamp(capdev, videoBuffer);
         }
 
         deltaT = 0.0;
@@ -5050,8 +5233,13 @@ int PsychGSGetTextureFromCapture(PsychWindowRecordType *win, int capturehandle,
         memcpy(outrawbuffer->data, (const void *) input_image, count);
     }
 
-    // Release the capture buffer. Return it to the DMA ringbuffer pool:
-    gst_buffer_unmap(videoBuffer, &mapinfo);
+    // Release the capture buffer. Return it to the DMA ringbuffer pool, unless the frame ring still holds it:
+    if (ringFrame) {
+        PsychGSReleaseCaptureFrame(ringFrame);
+    }
+    else {
+        gst_buffer_unmap(videoBuffer, &mapinfo);
+    }
     gst_sample_unref(videoSample);
     videoBuffer = NULL;
 
@@ -5212,14 +5400,8 @@ double PsychGSVideoCaptureSetParameter(int capturehandle, const char* pname, dou
             PsychErrorExitMsg(PsychError_user, "Initializing markertracker plugin failed!");
         }
 
-        // Get the sink pad from the videosink, where our to-be-processed video frames arrive on the streaming thread:
-        GstPad *pad = gst_element_get_static_pad(capdev->videosink, "sink");
-
-        // Add a pad probe callback PsychHaveVideoDataCallback(). This gets called on each received buffer
-        // from the streaming thread. If a markertracker/data processing plugin is loaded, the PsychHaveVideoDataCallback()
-        // will map the received video buffer and execute the plugin on it, otherwise the callback no-ops:
-        gst_pad_add_probe(pad, GST_PAD_PROBE_TYPE_BUFFER, PsychHaveVideoDataCallback, capdev, NULL);
-        gst_object_unref(pad);
+        // Execute plugin on each received buffer via PsychHaveVideoDataCallback():
+        PsychGSAttachVideoDataProbe(capdev);
 
         if (PsychPrefStateGet_Verbosity() > 2) {
             printf("PTB-INFO: Markertracker plugin loaded and initialized for device %i as '%s'.\n", capturehandle, pname);
@@ -5262,6 +5444,39 @@ double PsychGSVideoCaptureSetParameter(int capturehandle, const char* pname, dou
         return(0);
     }
 
+    // Set or query size of the CPU-side frame ring:
+    if (strcmp(pname, "FrameRingSize")==0) {
+        oldvalue = (double) capdev->frameRingSize;
+        if (value != DBL_MAX) {
+            if (intval < 0 || intval > 1024) PsychErrorExitMsg(PsychError_user, "Invalid 'FrameRingSize' specified. Must be between 0 and 1024 frames.");
+            PsychGSSetFrameRingSize(capdev, intval);
+        }
+
+        return(oldvalue);
+    }
+
+    // Return frame of age 'value' from the frame ring, without copy if the scripting environment allows it:
+    if (strcmp(pname, "GetRingFrame")==0) {
+        PsychCaptureFrame *frame = PsychGSAcquireCaptureFrame(capturehandle, (value != DBL_MAX) ? intval : 0);
+        double *empty;
+
+        if (frame) {
+            // Return timestamp and index first, as the frame may be gone after return of its image:
+            PsychCopyOutDoubleArg(2, FALSE, frame->timestamp);
+            PsychCopyOutDoubleArg(3, FALSE, (double) frame->frameIndex);
+            PsychCopyOutExternalMatArg(1, FALSE, frame->depth, frame->width, frame->height,
+                                       (frame->bitdepth > 8) ? PsychArgType_uint16 : PsychArgType_uint8, (void*) frame->data,
+                                       (PsychExternalMatReleaseFunc) PsychGSReleaseCaptureFrame, frame);
+        }
+        else {
+            PsychAllocOutDoubleMatArg(1, FALSE, 0, 0, 0, &empty);
+            PsychCopyOutDoubleArg(2, FALSE, -1);
+            PsychCopyOutDoubleArg(3, FALSE, -1);
+        }
+
+        return(0);
+    }
+
     // Check if GstColorBalanceInterface is supported and assign it for use downstream. Probe
     // different providers: camerabin1 (should support it), camerabin2 (doesn't at this point in time),
     // the wrappercamerabinsrc of camerabin2 (doesn't at this point in time), the video source attached
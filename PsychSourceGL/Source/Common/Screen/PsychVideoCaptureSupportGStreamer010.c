@@ -306,11 +306,12 @@ void PsychGSCheckInit(const char* engineName)
         }
 
         // Select opmode of GStreamers master clock:
-        // We use monotonic clock on Windows and OS/X, as these correspond to the
-        // clocks we use for GetSecs(), but realtime clock on Linux:
+        // We use monotonic clock on all systems. On Windows and OS/X it corresponds to the
+        // clock we use for GetSecs(). On Linux, capture timestamps get remapped from
+        // CLOCK_MONOTONIC to GetSecs() time, as the GetSecs() timebase is selectable:
         system_clock = gst_system_clock_obtain();
         if (system_clock) {
-            g_object_set(G_OBJECT(system_clock), "clock-type", ((PSYCH_SYSTEM == PSYCH_LINUX) ? GST_CLOCK_TYPE_REALTIME : GST_CLOCK_TYPE_MONOTONIC), NULL);
+            g_object_set(G_OBJECT(system_clock), "clock-type", GST_CLOCK_TYPE_MONOTONIC, NULL);
         }
         if (PsychPrefStateGet_Verbosity() > 3) printf("PTB-INFO: Using GStreamer version '%s'.\n", (char*) gst_version_string());
 
@@ -4516,8 +4517,13 @@ int PsychGSGetTextureFromCapture(PsychWindowRecordType *win, int capturehandle,
 
 		    capdev->current_pts = (double) (GST_BUFFER_TIMESTAMP(videoBuffer) + baseTime) / (double) 1e9;
 
+            #if PSYCH_SYSTEM == PSYCH_LINUX
+            // Remap CLOCK_MONOTONIC time to GetSecs time:
+            capdev->current_pts = PsychOSMonotonicToRefTime(capdev->current_pts);
+            #else
             // Apply corrective offset for GStreamer clock base zero point:
-            capdev->current_pts+= gs_startupTime;     
+            capdev->current_pts+= gs_startupTime;
+            #endif
         }
         
 	    deltaT = 0.0;
@@ -1467,6 +1467,11 @@ void PsychDCUpdateCameraFrameTimestamp(PsychVidcapRecordType* capdev)
         PsychGetAdjustedPrecisionTimerSeconds(&tRef);
         capdev->current_pts -= (((double) ((psych_uint64) tv.tv_sec * 1000000 + (psych_uint64) tv.tv_usec)) / 1000000.0f) - tRef;
         #endif
+
+        // On Linux, GetSecs time is not necessarily gettimeofday() time, depending on the selected timebase:
+        #if PSYCH_SYSTEM == PSYCH_LINUX
+        capdev->current_pts = PsychOSRealtimeToRefTime(capdev->current_pts);
+        #endif
     }
 }
 
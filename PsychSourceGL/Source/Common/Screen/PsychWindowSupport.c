@@ -1882,6 +1882,21 @@ void PsychCloseWindow(PsychWindowRecordType *windowRecord)
         // Call cleanup routine of text renderers to cleanup anything text related for this windowRecord:
         PsychCleanupTextRenderer(windowRecord);
 
+        // Release pixel buffers of asynchronous readback, if any:
+        PsychDeleteReadbackRing(windowRecord);
+
+        // Stop prefetching of movie frames into our textures, which uses the texture upload thread:
+        PsychDetachMoviesFromWindow(windowRecord);
+
+        // Stop texture upload thread for asynchronous texture creation, if any:
+        PsychDeleteTextureUploader(windowRecord);
+
+        // Delete pooled textures for recycling, if any:
+        PsychDeleteTexturePool(windowRecord);
+
+        // Delete streaming vertex buffer for batch drawing, if any:
+        PsychDeleteVertexStream(windowRecord);
+
         // Destroy a potentially orphaned GPU rendertime query:
         if (windowRecord->gpuRenderTimeQuery) {
             glGetQueryiv(GL_TIME_ELAPSED_EXT, GL_CURRENT_QUERY, &queryState);
@@ -1898,6 +1913,8 @@ void PsychCloseWindow(PsychWindowRecordType *windowRecord)
         for(i=0;i<numWindows;i++) {
             if (windowRecordArray[i]->targetSpecific.contextObject == windowRecord->targetSpecific.contextObject &&
                 (windowRecordArray[i]->windowType==kPsychTexture || windowRecordArray[i]->windowType==kPsychProxyWindow)) {
+                // Release asynchronous readbacks of offscreen windows while their buffers still exist:
+                PsychDeleteReadbackRing(windowRecordArray[i]);
                 windowRecordArray[i]->targetSpecific.contextObject = NULL;
                 windowRecordArray[i]->targetSpecific.glusercontextObject = NULL;
             }
@@ -1941,6 +1958,9 @@ void PsychCloseWindow(PsychWindowRecordType *windowRecord)
         // Texture or Offscreen window - which is also just a form of texture.
         PsychFreeTextureForWindowRecord(windowRecord);
 
+        // Release pixel buffers of asynchronous readback, if any:
+        PsychDeleteReadbackRing(windowRecord);
+
         // Execute hook chain for OpenGL related shutdown:
         PsychPipelineExecuteHook(windowRecord, kPsychCloseWindowPreGLShutdown, NULL, NULL, FALSE, FALSE, NULL, NULL, NULL, NULL);
 
@@ -3307,6 +3327,7 @@ double PsychFlipWindowBuffers(PsychWindowRecordType *windowRecord, int multiflip
     double time_at_swaprequest=0;            // Timestamp taken immediately before requesting buffer swap. Used for consistency checks.
     double time_post_swaprequest=0;            // Timestamp taken immediately after requesting buffer swap. Used for consistency checks.
     double time_at_swapcompletion=0;        // Timestamp taken after swap completion -- initially identical to time_at_vbl.
+    double time_at_flipstart;               // Timestamp taken at start of flip, for event tracing.
     int line_pre_swaprequest = -1;            // Scanline of display immediately before swaprequest.
     int line_post_swaprequest = -1;            // Scanline of display immediately after swaprequest.
     int min_line_allowed = 50;                // The scanline up to which "out of VBL" swaps are accepted: A fudge factor for broken drivers...
@@ -3336,6 +3357,9 @@ double PsychFlipWindowBuffers(PsychWindowRecordType *windowRecord, int multiflip
     if (windowRecord->windowType!=kPsychDoubleBufferOnscreen)
         PsychErrorExitMsg(PsychError_internal,"Attempt to swap a single window buffer");
 
+    // Traced as one complete event at the end, so error exits don't leave an unfinished flip in the trace:
+    PsychGetAdjustedPrecisionTimerSeconds(&time_at_flipstart);
+
     // Retrieve estimate of interframe flip-interval:
     if (windowRecord->nrIFISamples > 0) {
         currentflipestimate=windowRecord->IFIRunningSum / ((double) windowRecord->nrIFISamples);
@@ -4549,6 +4573,11 @@ double PsychFlipWindowBuffers(PsychWindowRecordType *windowRecord, int multiflip
     // We take a second timestamp here to mark the end of the Flip-routine and return it to "userspace"
     PsychGetAdjustedPrecisionTimerSeconds(time_at_flipend);
 
+    // Time from swap request to swap completion, and end of flip:
+    if ((time_at_swaprequest > 0) && (time_at_vbl >= time_at_swaprequest))
+        PsychTraceComplete("Screen", "Swap", time_at_swaprequest, time_at_vbl);
+    PsychTraceComplete("Screen", "Flip", time_at_flipstart, *time_at_flipend);
+
     // Done. Return high resolution system time in seconds when VBL happened.
     return(time_at_vbl);
 }
@@ -5919,6 +5948,10 @@ void PsychSetDrawingTarget(PsychWindowRecordType *windowRecord)
 
     // Called from main thread --> Work to do.
 
+    // Texture as drawing target, e.g., for drawing into it or 'GetImage'? It needs its final
+    // content if it was created asynchronously:
+    if (windowRecord && (windowRecord != (PsychWindowRecordType *) 0x1)) PsychFinishTextureUpload(windowRecord);
+
     // Increase recursion level count:
     recursionLevel++;
 
@@ -227,6 +227,7 @@ PsychError PsychModuleInit(void)
     PsychErrorExit(PsychRegister("TextColor", &SCREENTextColor));
     PsychErrorExit(PsychRegister("Preference", &SCREENPreference));
     PsychErrorExit(PsychRegister("MakeTexture", &SCREENMakeTexture));
+    PsychErrorExit(PsychRegister("MakeTextureBenchmark", &SCREENMakeTextureBenchmark));
     PsychErrorExit(PsychRegister("DrawTexture", &SCREENDrawTexture));
     PsychErrorExit(PsychRegister("FrameRect", &SCREENFrameRect));
     PsychErrorExit(PsychRegister("DrawLine", &SCREENDrawLine));
@@ -236,6 +237,7 @@ PsychError PsychModuleInit(void)
     PsychErrorExit(PsychRegister("DrawDots", &SCREENDrawDots));
     PsychErrorExit(PsychRegister("GetTimeList", &SCREENGetTimeList));
     PsychErrorExit(PsychRegister("ClearTimeList", &SCREENClearTimeList));
+    PsychErrorExit(PsychRegister("Trace", &PsychTraceSubfunction));
     PsychErrorExit(PsychRegister("BlendFunction", &SCREENBlendFunction));
     PsychErrorExit(PsychRegister("WindowSize", &SCREENWindowSize));
     PsychErrorExit(PsychRegister("GetMouseHelper", &SCREENGetMouseHelper));
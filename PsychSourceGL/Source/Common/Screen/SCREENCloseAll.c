@@ -80,6 +80,9 @@ void ScreenCloseAllWindows(void)
     // Check for stale texture ressources:
     PsychRessourceCheckAndReminder(TRUE);
 
+    // Add frames still pending from asynchronous 'AddFrameToMovie' before the movies get finalized:
+    PsychFlushAsyncMovieFrames(-1);
+
     // Shutdown multi-media subsystems if active:
     PsychExitMovieWriting();
     PsychExitMovies();
@@ -62,6 +62,9 @@ PsychError SCREENCopyWindow(void)
     PsychAllocInWindowRecordArg(1, TRUE, &sourceWin);
     PsychCopyRect(sourceRect, sourceWin->clientrect);
 
+    // Wait for completion of asynchronous texture creation of source, if needed:
+    PsychFinishTextureUpload(sourceWin);
+
     PsychCopyInRectArg(3, FALSE, sourceRect);
     if (IsPsychRectEmpty(sourceRect)) return(PsychError_none);
 
@@ -46,6 +46,7 @@
             3/22/05         mk      Added possibility to spec vectors with individual color and size spec per dot.
             4/29/05         mk      Bugfix for color vectors: They should also take values in range 0-255 instead of 0.0-1.0.
             11/14/06        mk      We now also accept color vectors in uint8 format and pass them directly for higher efficiency.
+            10/18/26        agent   Submit dots via the streaming vertex buffer of PsychVertexStreamSupport.c if possible.
 */
 
 #include "Screen.h"
@@ -153,10 +154,10 @@ PsychError SCREENDrawDots(void)
 {
     PsychWindowRecordType                   *windowRecord, *parentWindowRecord;
     int                                     m,n,p,mc,nc,idot_type;
-    int                                     i, nrpoints, nrsize;
+    int                                     i, nrpoints, nrsize, layout;
     psych_bool                              isArgThere, usecolorvector;
     double                                  *xy, *size, *center, *dot_type, *colors;
-    float                                   *sizef;
+    float                                   *sizef, *vertices;
     unsigned char                           *bytecolors;
     GLfloat                                 pointsizerange[2];
     psych_bool                              lenient = FALSE;
@@ -326,6 +327,19 @@ PsychError SCREENDrawDots(void)
         PsychErrorExitMsg(PsychError_user, "Unsupported point size requested in Screen('DrawDots').");
     }
 
+    // Individual size for each dot provided? Validate all point sizes before any
+    // vertex arrays get set up:
+    if (nrsize > 1) {
+        for (i = 0; i < nrpoints; i++) {
+            if (!lenient && ((sizef && (sizef[i] > pointsizerange[1] || sizef[i] < pointsizerange[0])) ||
+                (!sizef && (size[i] > pointsizerange[1] || size[i] < pointsizerange[0])))) {
+                printf("PTB-ERROR: You requested a point size of %f units, which is not in the range (%f to %f) supported by your graphics hardware.\n",
+                       (sizef) ? sizef[i] : size[i], pointsizerange[0], pointsizerange[1]);
+                PsychErrorExitMsg(PsychError_user, "Unsupported point size requested in Screen('DrawDots').");
+            }
+        }
+    }
+
     // Setup initial common point size for all points:
     if (!usePointSizeArray) glPointSize((sizef) ? sizef[0] : (float) size[0]);
     if (usePointSizeArray) glMultiTexCoord1f(GL_TEXTURE2, (sizef) ? sizef[0] : (float) size[0]);
@@ -345,14 +359,25 @@ PsychError SCREENDrawDots(void)
     // associated with the original implementation below and is potentially
     // optimized in specific OpenGL implementations.
 
-    // Pass a pointer to the start of the point-coordinate array:
-    glVertexPointer(2, PSYCHGLFLOAT, 0, &xy[0]);
+    // Try to write positions, colors and per point sizes for the shader based
+    // path interleaved into the streaming vertex buffer. Otherwise use client
+    // side arrays:
+    layout = ((usecolorvector) ? kPsychVertexStreamColors : 0) | ((nrsize > 1 && usePointSizeArray) ? kPsychVertexStreamSizes : 0);
+    vertices = PsychMapVertexStream(windowRecord, nrpoints, layout);
+    if (vertices) {
+        PsychFillVertexStream(vertices, nrpoints, layout, xy, mc, colors, bytecolors, size);
+        PsychEnableVertexStream(windowRecord);
+    }
+    else {
+        // Pass a pointer to the start of the point-coordinate array:
+        glVertexPointer(2, PSYCHGLFLOAT, 0, &xy[0]);
 
-    // Enable fast rendering of arrays:
-    glEnableClientState(GL_VERTEX_ARRAY);
+        // Enable fast rendering of arrays:
+        glEnableClientState(GL_VERTEX_ARRAY);
 
-    if (usecolorvector) {
-        PsychSetupVertexColorArrays(windowRecord, TRUE, mc, colors, bytecolors);
+        if (usecolorvector) {
+            PsychSetupVertexColorArrays(windowRecord, TRUE, mc, colors, bytecolors);
+        }
     }
 
     // Render all n points, starting at point 0, render them as POINTS:
@@ -361,18 +386,10 @@ PsychError SCREENDrawDots(void)
         // path in use. We can use the fast path of only submitting
         // one glDrawArrays call to draw all GL_POINTS. For a single
         // common size, no further setup is needed.
-        if (nrsize > 1) {
+        if ((nrsize > 1) && !vertices) {
             // Individual size for each dot provided. Setup texture unit 2
             // with a 1D texcoord array that stores per point size info in
-            // texture coordinate set 2. But first validate point sizes:
-            for (i = 0; i < nrpoints; i++) {
-                if (!lenient && ((sizef && (sizef[i] > pointsizerange[1] || sizef[i] < pointsizerange[0])) ||
-                    (!sizef && (size[i] > pointsizerange[1] || size[i] < pointsizerange[0])))) {
-                    printf("PTB-ERROR: You requested a point size of %f units, which is not in the range (%f to %f) supported by your graphics hardware.\n",
-                           (sizef) ? sizef[i] : size[i], pointsizerange[0], pointsizerange[1]);
-                    PsychErrorExitMsg(PsychError_user, "Unsupported point size requested in Screen('DrawDots').");
-                }
-            }
+            // texture coordinate set 2.
 
             // Do we need the GL_FLOAT data glTexCoordPointer(1, ...) workaround?
             // See explanation in PsychWindowSupport.c: PsychDetectAndAssignGfxCapabilities():
@@ -393,7 +410,7 @@ PsychError SCREENDrawDots(void)
         // Draw all points:
         glDrawArrays(GL_POINTS, 0, nrpoints);
 
-        if (nrsize > 1) {
+        if ((nrsize > 1) && !vertices) {
             // Individual size for each dot provided. Reset texture unit 2:
             glTexCoordPointer(1, (sizef) ? GL_FLOAT : GL_DOUBLE, 0, (const GLvoid*) NULL);
             glDisableClientState(GL_TEXTURE_COORD_ARRAY);
@@ -406,13 +423,6 @@ PsychError SCREENDrawDots(void)
         // Different size for each dot provided and we can't use our shader based implementation:
         // We have to do One GL - call per dot:
         for (i = 0; i < nrpoints; i++) {
-            if (!lenient && ((sizef && (sizef[i] > pointsizerange[1] || sizef[i] < pointsizerange[0])) ||
-                (!sizef && (size[i] > pointsizerange[1] || size[i] < pointsizerange[0])))) {
-                printf("PTB-ERROR: You requested a point size of %f units, which is not in the range (%f to %f) supported by your graphics hardware.\n",
-                        (sizef) ? sizef[i] : size[i], pointsizerange[0], pointsizerange[1]);
-                PsychErrorExitMsg(PsychError_user, "Unsupported point size requested in Screen('DrawDots').");
-            }
-
             // Setup point size for this point:
             glPointSize((sizef) ? sizef[i] : (float) size[i]);
 
@@ -421,11 +431,16 @@ PsychError SCREENDrawDots(void)
         }
     }
 
-    // Disable fast rendering of arrays:
-    glDisableClientState(GL_VERTEX_ARRAY);
-    glVertexPointer(2, PSYCHGLFLOAT, 0, NULL);
+    if (vertices) {
+        PsychDisableVertexStream(windowRecord);
+    }
+    else {
+        // Disable fast rendering of arrays:
+        glDisableClientState(GL_VERTEX_ARRAY);
+        glVertexPointer(2, PSYCHGLFLOAT, 0, NULL);
 
-    if (usecolorvector) PsychSetupVertexColorArrays(windowRecord, FALSE, 0, NULL, NULL);
+        if (usecolorvector) PsychSetupVertexColorArrays(windowRecord, FALSE, 0, NULL, NULL);
+    }
 
     // Restore old matrix from backup copy, undoing the global translation:
     glPopMatrix();
@@ -50,6 +50,7 @@
         4/22/05     mk          Small bug fix (size = PsychMallocTemp.....)
         12/4/06     mk          Rewrite to make it functional again and to implement a similar
                                 syntax to Screen('DrawDots').
+        10/18/26    agent       Submit lines via the streaming vertex buffer of PsychVertexStreamSupport.c if possible.
  */
 
 #include "Screen.h"
@@ -83,12 +84,12 @@ PsychError SCREENDrawLines(void)
 {
     PsychWindowRecordType       *windowRecord;
     int                         m,n,p, smooth;
-    int                         nrsize, nrvertices, mc, nc, i;
+    int                         nrsize, nrvertices, mc, nc, i, layout;
     psych_bool                  isArgThere, usecolorvector;
     double                      *xy, *size, *center, *dot_type, *colors;
     unsigned char               *bytecolors;
     float                       linesizerange[2];
-    float                       *sizef;
+    float                       *sizef, *vertices;
     psych_bool                  lenient = FALSE;
 
     //all sub functions should have these two lines
@@ -186,6 +187,19 @@ PsychError SCREENDrawLines(void)
         PsychErrorExitMsg(PsychError_user, "Unsupported line width requested.");
     }
 
+    // Individual width for each line provided? Validate all widths before any
+    // vertex arrays get set up:
+    if (nrsize > 1) {
+        for (i=0; i < nrvertices/2; i++) {
+            if (!lenient && ((sizef && (sizef[i] > linesizerange[1] || sizef[i] < linesizerange[0])) ||
+                             (!sizef && (size[i] > linesizerange[1] || size[i] < linesizerange[0])))) {
+                printf("PTB-ERROR: You requested a line width of %f units, which is not in the range (%f to %f) supported by your graphics hardware.\n",
+                       (sizef) ? sizef[i] : size[i], linesizerange[0], linesizerange[1]);
+                PsychErrorExitMsg(PsychError_user, "Unsupported line width requested.");
+            }
+        }
+    }
+
     // Set global width of lines:
     glLineWidth((sizef) ? sizef[0] : (float) size[0]);
 
@@ -204,15 +218,25 @@ PsychError SCREENDrawLines(void)
     // associated with the original implementation below and is potentially
     // optimized in specific OpenGL implementations.
 
-    // Pass a pointer to the start of the arrays:
-    glVertexPointer(2, PSYCHGLFLOAT, 0, &xy[0]);
-
-    if (usecolorvector) {
-        PsychSetupVertexColorArrays(windowRecord, TRUE, mc, colors, bytecolors);
+    // Try to write positions and colors interleaved into the streaming vertex
+    // buffer. Otherwise use client side arrays:
+    layout = (usecolorvector) ? kPsychVertexStreamColors : 0;
+    vertices = PsychMapVertexStream(windowRecord, nrvertices, layout);
+    if (vertices) {
+        PsychFillVertexStream(vertices, nrvertices, layout, xy, mc, colors, bytecolors, NULL);
+        PsychEnableVertexStream(windowRecord);
     }
+    else {
+        // Pass a pointer to the start of the arrays:
+        glVertexPointer(2, PSYCHGLFLOAT, 0, &xy[0]);
 
-    // Enable fast rendering of arrays:
-    glEnableClientState(GL_VERTEX_ARRAY);
+        if (usecolorvector) {
+            PsychSetupVertexColorArrays(windowRecord, TRUE, mc, colors, bytecolors);
+        }
+
+        // Enable fast rendering of arrays:
+        glEnableClientState(GL_VERTEX_ARRAY);
+    }
 
     if (nrsize==1) {
         // Common line-width for all lines: Render all lines, starting at line 0:
@@ -221,13 +245,6 @@ PsychError SCREENDrawLines(void)
     else {
         // Different line-width per line: Need to manually loop through this mess:
         for (i=0; i < nrvertices/2; i++) {
-            if (!lenient && ((sizef && (sizef[i] > linesizerange[1] || sizef[i] < linesizerange[0])) ||
-                             (!sizef && (size[i] > linesizerange[1] || size[i] < linesizerange[0])))) {
-                printf("PTB-ERROR: You requested a line width of %f units, which is not in the range (%f to %f) supported by your graphics hardware.\n",
-                       (sizef) ? sizef[i] : size[i], linesizerange[0], linesizerange[1]);
-                PsychErrorExitMsg(PsychError_user, "Unsupported line width requested.");
-            }
-
             glLineWidth((sizef) ? sizef[i] : (float) size[i]);
 
             // Render line:
@@ -235,11 +252,16 @@ PsychError SCREENDrawLines(void)
         }
     }
 
-    // Disable fast rendering of arrays:
-    glDisableClientState(GL_VERTEX_ARRAY);
-    glVertexPointer(2, PSYCHGLFLOAT, 0, NULL);
+    if (vertices) {
+        PsychDisableVertexStream(windowRecord);
+    }
+    else {
+        // Disable fast rendering of arrays:
+        glDisableClientState(GL_VERTEX_ARRAY);
+        glVertexPointer(2, PSYCHGLFLOAT, 0, NULL);
 
-    if (usecolorvector) PsychSetupVertexColorArrays(windowRecord, FALSE, 0, NULL, NULL);
+        if (usecolorvector) PsychSetupVertexColorArrays(windowRecord, FALSE, 0, NULL, NULL);
+    }
 
     // Restore old matrix from backup copy, undoing the global translation:
     glPopMatrix();
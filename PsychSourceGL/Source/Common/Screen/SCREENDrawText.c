@@ -30,6 +30,7 @@
                             -> Allows for better handling of unicode and multibyte character encodings.
 
         11/02/13    mk      Rewrite OSX renderer: Switch from deprecated ATSUI to "new" CoreText as supported on OSX 10.5 and later.
+        10/18/26    agent   Plugin renderer: Draw and measure via glyph atlas and shaped string cache if the plugin supports it.
 
     DESCRIPTION:
 
@@ -64,6 +65,9 @@ void (*PsychPluginSetTextVerbosity)(unsigned int verbosity) = NULL;
 void (*PsychPluginSetTextAntiAliasing)(int context, int antiAliasing) = NULL;
 void (*PsychPluginSetAffineTransformMatrix)(int context, double matrix[2][3]) = NULL;
 void (*PsychPluginGetTextCursor)(int context, double* xp, double* yp, double* height) = NULL;
+int (*PsychPluginGetTextGlyph)(int context, unsigned int charCode, float* xmin, float* ymin, float* xmax, float* ymax, float* xadvance,
+                               int* left, int* top, int* width, int* height, const unsigned char** bitmap) = NULL;
+int (*PsychPluginGetTextKerning)(int context, unsigned int leftCharCode, unsigned int rightCharCode, float* xkerning) = NULL;
 
 // External renderplugins not yet supported on MS-Windows:
 #if PSYCH_SYSTEM != PSYCH_WINDOWS
@@ -128,7 +132,10 @@ static char synopsisString[] =
     "out of our control.\n"
     "Type 1 is the high quality renderer: It supports unicode, anti-aliasing, and many "
     "other interesting features. This is a renderer loaded from an external plugin, and based on FTGL "
-    "for fast high quality text drawing with OpenGL.\n"
+    "for fast high quality text drawing with OpenGL. On desktop OpenGL, untransformed text is drawn from "
+    "a per-font glyph atlas texture, and the glyph layout of recently drawn or measured strings is cached, "
+    "which makes drawing many short text labels per frame much faster. Setting the environment variable "
+    "PSYCH_TEXT_ATLAS=0 disables this.\n"
     "This function doesn't provide support for text layout. Use the higher level DrawFormattedText() function "
     "if you need basic support for text layout, e.g, centered text output, line wrapping etc.\n";
 
@@ -1628,6 +1635,8 @@ psych_bool PsychLoadTextRendererPlugin(PsychWindowRecordType* windowRecord)
             PsychPluginSetTextAntiAliasing = dlsym(drawtext_plugin, "PsychSetTextAntiAliasing");
             PsychPluginSetAffineTransformMatrix = dlsym(drawtext_plugin, "PsychSetAffineTransformMatrix");
             PsychPluginGetTextCursor = dlsym(drawtext_plugin, "PsychGetTextCursor");
+            PsychPluginGetTextGlyph = dlsym(drawtext_plugin, "PsychGetTextGlyph");
+            PsychPluginGetTextKerning = dlsym(drawtext_plugin, "PsychGetTextKerning");
         #else
             PsychPluginInitText = GetProcAddress(drawtext_plugin, "PsychInitText");
             PsychPluginShutdownText = GetProcAddress(drawtext_plugin, "PsychShutdownText");
@@ -1645,6 +1654,8 @@ psych_bool PsychLoadTextRendererPlugin(PsychWindowRecordType* windowRecord)
             PsychPluginSetTextAntiAliasing = GetProcAddress(drawtext_plugin, "PsychSetTextAntiAliasing");
             PsychPluginSetAffineTransformMatrix = GetProcAddress(drawtext_plugin, "PsychSetAffineTransformMatrix");
             PsychPluginGetTextCursor = GetProcAddress(drawtext_plugin, "PsychGetTextCursor");
+            PsychPluginGetTextGlyph = GetProcAddress(drawtext_plugin, "PsychGetTextGlyph");
+            PsychPluginGetTextKerning = GetProcAddress(drawtext_plugin, "PsychGetTextKerning");
         #endif
 
         // Assign current level of verbosity:
@@ -1668,6 +1679,9 @@ psych_bool PsychLoadTextRendererPlugin(PsychWindowRecordType* windowRecord)
 // OS/Engine specific cleanup routines:
 void PsychCleanupTextRenderer(PsychWindowRecordType* windowRecord)
 {
+    // Release glyph atlas of the plugin renderer, if any:
+    PsychDeleteTextAtlas(windowRecord);
+
     // Do we have allocated display lists for the display list renderers on MS-Windows or Linux
     // for this onscreen window?
     if (windowRecord->textAttributes.DisplayList > 0) {
@@ -2092,6 +2106,8 @@ PsychError PsychDrawUnicodeText(PsychWindowRecordType* winRec, PsychRectType* bo
     float xmin, ymin, xmax, ymax, _xadvance;
     double myyp;
     double dummy;
+    double lineHeight;
+    PsychShapedText *shaped;
     unsigned int i;
     int ctx;
     int rc = 0;
@@ -2176,8 +2192,10 @@ PsychError PsychDrawUnicodeText(PsychWindowRecordType* winRec, PsychRectType* bo
             glPixelStorei(GL_UNPACK_CLIENT_STORAGE_APPLE, GL_FALSE);
         #endif
 
-        // Compute bounding box of drawn string:
-        rc = PsychPluginMeasureText(ctx, stringLengthChars, textUniDoubleString, &xmin, &ymin, &xmax, &ymax, &_xadvance);
+        // Compute bounding box of drawn string, from the cache of shaped strings of the glyph atlas if possible,
+        // otherwise via the plugin:
+        shaped = PsychShapeTextWithAtlas(winRec, ctx, stringLengthChars, textUniDoubleString, &xmin, &ymin, &xmax, &ymax, &_xadvance, &lineHeight);
+        if (!shaped) rc = PsychPluginMeasureText(ctx, stringLengthChars, textUniDoubleString, &xmin, &ymin, &xmax, &ymax, &_xadvance);
 
         // Handle definition of yp properly: Is it the text baseline, or the top of the text bounding box?
         if (yPositionIsBaseline) {
@@ -2193,6 +2211,10 @@ PsychError PsychDrawUnicodeText(PsychWindowRecordType* winRec, PsychRectType* bo
             PsychMakeRect((double*) boundingbox, xmin + *xp, myyp - ymax, xmax + *xp, myyp - ymin);
             *xAdvance = (double) _xadvance;
         }
+        else if (shaped) {
+            // Draw text with a single draw call from the glyph atlas:
+            PsychDrawShapedText(winRec, shaped, *xp, myyp, colorVector, backgroundColorVector);
+        }
         else {
             // Draw text by calling into the plugin:
             rc += PsychPluginDrawText(ctx, *xp, myyp, stringLengthChars, textUniDoubleString);
@@ -2210,7 +2232,12 @@ PsychError PsychDrawUnicodeText(PsychWindowRecordType* winRec, PsychRectType* bo
         // Plugin rendering successfull?
         if (0 == rc) {
             // Yes. Update x position of text drawing cursor:
-            if (PsychPluginGetTextCursor) {
+            if (shaped) {
+                // Text cursor moves by the advance of the shaped string, if it got drawn:
+                if (!boundingbox) *xp = *xp + _xadvance;
+                if (PsychPluginGetTextCursor) *theight = lineHeight;
+            }
+            else if (PsychPluginGetTextCursor) {
                 // Plugin provides accurate text cursor measurement - use it:
                 PsychPluginGetTextCursor(ctx, xp, yp, theight);
                 if (!yPositionIsBaseline)
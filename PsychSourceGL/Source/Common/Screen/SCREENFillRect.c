@@ -18,6 +18,8 @@
 		2/25/05		awi		Relocated PsychSetGLContext() to outside condtional, it only executed for small rects.
 							glClearColor() now sets variable alpha, not static at 1.0 (255). 
 							Added call to PsychUpdateAlphaBlendingFactorLazily().  Drawing now obeys settings by Screen('BlendFunction').
+		10/18/26	agent		Draw batches of rects with one draw call via the streaming vertex buffer of PsychVertexStreamSupport.c.
+							Fix skipping of empty rects in batches.
  
  
 	TO DO:
@@ -33,6 +35,10 @@
 
 #include "Screen.h"
 
+// Corners of the two triangles which make up a rect, as indices into a PsychRectType:
+static const int rectTriangleCorners[6][2] = { {kPsychLeft, kPsychTop}, {kPsychRight, kPsychTop}, {kPsychLeft, kPsychBottom},
+                                               {kPsychRight, kPsychTop}, {kPsychRight, kPsychBottom}, {kPsychLeft, kPsychBottom} };
+
 // If you change the useString then also change the corresponding synopsis string in ScreenSynopsis.c
 static char useString[] = "Screen('FillRect', windowPtr [,color] [,rect] )";                                          
 //                                            1           2        3      
@@ -62,7 +68,8 @@ PsychError SCREENFillRect(void)
 	psych_bool						isArgThere, isScreenRect;
     double							*xy, *colors;
 	unsigned char					*bytecolors;
-	int								numRects, i, nc, mc, nrsize;
+	int								numRects, i, j, nc, mc, nrsize, nrvertices, layout;
+	float							*vertices;
 
 	//all sub functions should have these two lines
 	PsychPushHelp(useString, synopsisString,seeAlsoString);
@@ -153,16 +160,37 @@ PsychError SCREENFillRect(void)
 	  } else {
 	    // Partial fill: Draw provided rects:
 		if (numRects>1) {
-			// Multiple rects provided: Draw the whole batch:
-			for (i=0; i<numRects; i++) {
-				// Per rect color provided?
-				if (nc>1) {
-					// Yes. Set color for this specific rect:
-					PsychSetArrayColor(windowRecord, i, mc, colors, bytecolors);
+			// Multiple rects provided: Try to draw the whole batch as triangles with per vertex colors
+			// from the streaming vertex buffer with one draw call:
+			for (i=0, nrvertices=0; i<numRects; i++) if (!IsPsychRectEmpty(&(xy[i*4]))) nrvertices += 6;
+			layout = (nc>1) ? kPsychVertexStreamColors : 0;
+			vertices = PsychMapVertexStream(windowRecord, nrvertices, layout);
+			if (vertices) {
+				for (i=0; i<numRects; i++) {
+					if (IsPsychRectEmpty(&(xy[i*4]))) continue;
+					for (j=0; j<6; j++) {
+						*(vertices++) = (float) xy[i*4 + rectTriangleCorners[j][0]];
+						*(vertices++) = (float) xy[i*4 + rectTriangleCorners[j][1]];
+						if (nc>1) vertices = PsychStoreVertexStreamColor(vertices, i, mc, colors, bytecolors);
+					}
+				}
+
+				PsychEnableVertexStream(windowRecord);
+				glDrawArrays(GL_TRIANGLES, 0, nrvertices);
+				PsychDisableVertexStream(windowRecord);
+			}
+			else {
+				// Draw one rect after the other:
+				for (i=0; i<numRects; i++) {
+					// Per rect color provided?
+					if (nc>1) {
+						// Yes. Set color for this specific rect:
+						PsychSetArrayColor(windowRecord, i, mc, colors, bytecolors);
+					}
+
+					// Submit rect for drawing:
+					if (!IsPsychRectEmpty(&(xy[i*4]))) PsychGLRect(&(xy[i*4]));
 				}
-				
-				// Submit rect for drawing:
-				if (!IsPsychRectEmpty(rect)) PsychGLRect(&(xy[i*4]));
 			}
 		}
 		else {
@@ -15,14 +15,15 @@
         01/08/03    awi         Created.
         10/12/04    awi         In useString: moved commas to inside [].
         03/20/11    mk          Made 64-bit clean.
+        10/18/26    agent       Optional asynchronous readback via PBO ring, row-major output for Python, blocked transpose.
 
 */
 
 #include "Screen.h"
 
 // If you change the useString then also change the corresponding synopsis string in ScreenSynopsis.c
-static char useString[] =  "imageArray=Screen('GetImage', windowPtr [,rect] [,bufferName] [,floatprecision=0] [,nrchannels=3])";
-//                                                        1           2       3             4                   5
+static char useString[] =  "imageArray=Screen('GetImage', windowPtr [,rect] [,bufferName] [,floatprecision=0] [,nrchannels=3] [,asyncDepth=0])";
+//                                                        1           2       3             4                   5               6
 
 static char synopsisString[] =
 "Slowly copy an image from a window or texture to Matlab/Octave, by default returning a uint8 array.\n\n"
@@ -79,10 +80,21 @@ static char synopsisString[] =
 "framebuffers do support 'floatprecision' readback.\n"
 "\"nrchannels\" Number of color channels to return. By default, 3 channels (RGB) are "
 "returned. Specify 1 for Red/Luminance only, 2 for Red+Green or Luminance+Alpha, 3 for "
-"RGB and 4 for RGBA. A setting of 2 is not supported on OpenGL-ES hardware. \n\n";
-
-static char useString2[] = "Screen('AddFrameToMovie', windowPtr [,rect] [,bufferName] [,moviePtr=0] [,frameduration=1])";
-//                                                    1           2       3             4             5
+"RGB and 4 for RGBA. A setting of 2 is not supported on OpenGL-ES hardware. \n\n"
+"\"asyncDepth\" If set to a value N greater than zero, readback is asynchronous: The image "
+"is transferred into a pixel buffer in the background, and the call returns the image "
+"requested N calls ago, or an empty matrix during the first N calls. This avoids stalling "
+"your script until the graphics card has finished rendering and transferring the image, "
+"at the price of a latency of N calls, e.g., N Screen('Flip')s if you call 'GetImage' once "
+"per flip. The returned image is always the one of the 'rect' and 'bufferName' requested N "
+"calls ago, so if you move 'rect' between calls, the image is of the old position. Moving "
+"'rect' keeps pending images, but changing its size, or 'floatprecision', 'nrchannels' or "
+"'asyncDepth' discards them. Requires support for OpenGL pixel buffer objects, which is not available on "
+"OpenGL-ES hardware. Defaults to zero, ie. synchronous readback.\n\n"
+"On Python, the returned array is in C (row-major) memory layout.\n\n";
+
+static char useString2[] = "Screen('AddFrameToMovie', windowPtr [,rect] [,bufferName] [,moviePtr=0] [,frameduration=1] [,asyncDepth=0])";
+//                                                    1           2       3             4             5                  6
 
 static char synopsisString2[] =
 "Get an image from a window or texture and add it as a new video frame to a movie.\n\n"
@@ -135,6 +147,17 @@ static char synopsisString2[] =
 "\"frameduration\" optionally defines the display duration of the added video frame in "
 "units of movie frame intervals. See the help for 'CreateMovie' for further explanation of "
 "\"frameduration\".\n\n"
+"\"asyncDepth\" If set to a value N greater than zero, readback is asynchronous: The image "
+"is transferred into a pixel buffer in the background, and added to its movie once the "
+"transfer has finished, at the latest N calls later. This avoids stalling your script until "
+"the graphics card has finished rendering and transferring the image. Images are then copied "
+"and encoded on a separate writer thread, with the queue depth and the policy for an encoder "
+"which can't keep up set by the 'WriterQueueDepth=' and 'WriterDropFrames' keywords of "
+"Screen('CreateMovie'). Images still pending are added by Screen('FinalizeMovie'), or when "
+"you change a readback parameter like 'asyncDepth'. "
+"Don't mix asynchronous and synchronous calls on the same movie, as frames would get out of "
+"order. Requires support for OpenGL pixel buffer objects, which is not available on OpenGL-ES "
+"hardware. Defaults to zero, ie. synchronous readback.\n\n"
 "Movie images are stored with 8 bits or 16 bits resolution per pixel color component. "
 "Images are stored as one (RED), three (RGB) or four channel (RGBA) frames. The number "
 "of channels and bitdepth is selected in the Screen('CreateMovie') call and then kept "
@@ -151,18 +174,21 @@ PsychError SCREENGetImage(void)
 {
     PsychRectType   windowRect, sampleRect;
     int             nrchannels, invertedY, stride;
-    size_t          ix, iy, sampleRectWidth, sampleRectHeight, redReturnIndex, greenReturnIndex, blueReturnIndex, alphaReturnIndex;
+    size_t          sampleRectWidth, sampleRectHeight, readbackSize;
     int             viewid = 0;
-    psych_uint8     *returnArrayBase, *redPlane;
-    float           *dredPlane;
+    psych_uint8     *returnArrayBase;
     double          *returnArrayBaseDouble;
+    const void      *pixels;
     PsychWindowRecordType *windowRecord;
     GLboolean       isDoubleBuffer, isStereo;
     char*           buffername = NULL;
     psych_bool      floatprecision = FALSE;
     GLenum          whichBuffer = 0;
+    GLenum          format = GL_RGBA, type = GL_UNSIGNED_BYTE;
     int             frameduration = 1;
     int             moviehandle = 0;
+    int             asyncDepth = 0;
+    psych_bool      cLayout;
     unsigned int    twidth, theight, numChannels, bitdepth;
     unsigned char*  framepixels;
     psych_bool      isOES;
@@ -183,7 +209,7 @@ PsychError SCREENGetImage(void)
     if(PsychIsGiveHelp()){PsychGiveHelp();return(PsychError_none);};
 
     //cap the numbers of inputs and outputs
-    PsychErrorExit(PsychCapNumInputArgs(5));   //The maximum number of inputs
+    PsychErrorExit(PsychCapNumInputArgs(6));   //The maximum number of inputs
     PsychErrorExit(PsychCapNumOutputArgs(1));  //The maximum number of outputs
 
     // Get windowRecord for this window:
@@ -465,6 +491,17 @@ PsychError SCREENGetImage(void)
     sampleRectWidth = (size_t) PsychGetWidthFromRect(sampleRect);
     sampleRectHeight= (size_t) PsychGetHeightFromRect(sampleRect);
 
+    invertedY = (int) (windowRect[kPsychBottom] - sampleRect[kPsychBottom]);
+    glPixelStorei(GL_PACK_ALIGNMENT, 1);
+
+    // Get optional asyncDepth: If greater than zero, readback is asynchronous and returns the
+    // image read 'asyncDepth' calls ago:
+    PsychCopyInIntegerArg(6, FALSE, &asyncDepth);
+    if (asyncDepth < 0 || asyncDepth > PSYCH_MAX_READBACK_DEPTH) {
+        printf("PTB-ERROR: Invalid 'asyncDepth' %i. Must be between 0 and %i.\n", asyncDepth, PSYCH_MAX_READBACK_DEPTH);
+        PsychErrorExitMsg(PsychError_user, "Invalid 'asyncDepth' specified.");
+    }
+
     // Regular image fetch to runtime, or adding to a movie?
     if (!isAddMovieFrame) {
         // Regular fetch:
@@ -479,111 +516,67 @@ PsychError SCREENGetImage(void)
         PsychCopyInIntegerArg(5, FALSE, &nrchannels);
         if (nrchannels < 1 || nrchannels > 4) PsychErrorExitMsg(PsychError_user, "Number of requested channels 'nrchannels' must be between 1 and 4!");
 
-        if (!floatprecision) {
-            // Readback of standard 8bpc uint8 pixels:
-
-            // No Luminance + Alpha on OES:
-            if (isOES && (nrchannels == 2)) PsychErrorExitMsg(PsychError_user, "Number of requested channels 'nrchannels' == 2 not supported on OpenGL-ES!");
-
-            PsychAllocOutUnsignedByteMatArg(1, TRUE, (int) sampleRectHeight, (int) sampleRectWidth, (int) nrchannels, &returnArrayBase);
-            if (isOES) {
-                // We only do RGBA reads on OES, then discard unwanted stuff ourselves:
-                redPlane  = (psych_uint8*) PsychMallocTemp((size_t) 4 * sampleRectWidth * sampleRectHeight);
-            }
-            else {
-                redPlane  = (psych_uint8*) PsychMallocTemp((size_t) nrchannels * sampleRectWidth * sampleRectHeight);
-            }
-
-            glPixelStorei(GL_PACK_ALIGNMENT,1);
-            invertedY = (int) (windowRect[kPsychBottom] - sampleRect[kPsychBottom]);
+        // No Luminance + Alpha on OES:
+        if (isOES && (nrchannels == 2)) PsychErrorExitMsg(PsychError_user, "Number of requested channels 'nrchannels' == 2 not supported on OpenGL-ES!");
 
-            if (isOES) {
-                glReadPixels((int) sampleRect[kPsychLeft], invertedY, (int) sampleRectWidth, (int) sampleRectHeight, GL_RGBA, GL_UNSIGNED_BYTE, redPlane);
-                stride = 4;
-            }
-            else {
-                stride = nrchannels;
-                if (nrchannels==1) glReadPixels((int) sampleRect[kPsychLeft], invertedY, (int) sampleRectWidth, (int) sampleRectHeight, GL_RED, GL_UNSIGNED_BYTE, redPlane);
-                if (nrchannels==2) glReadPixels((int) sampleRect[kPsychLeft], invertedY, (int) sampleRectWidth, (int) sampleRectHeight, GL_LUMINANCE_ALPHA, GL_UNSIGNED_BYTE, redPlane);
-                if (nrchannels==3) glReadPixels((int) sampleRect[kPsychLeft], invertedY, (int) sampleRectWidth, (int) sampleRectHeight, GL_RGB, GL_UNSIGNED_BYTE, redPlane);
-                if (nrchannels==4) glReadPixels((int) sampleRect[kPsychLeft], invertedY, (int) sampleRectWidth, (int) sampleRectHeight, GL_RGBA, GL_UNSIGNED_BYTE, redPlane);
-            }
+        // Only float readback on floating point FBO's with EXT_color_buffer_float support:
+        if (floatprecision && isOES && ((whichBuffer != GL_COLOR_ATTACHMENT0_EXT) || (windowRecord->bpc < 16) || !glewIsSupported("GL_EXT_color_buffer_float"))) {
+            printf("PTB-ERROR: Tried to 'GetImage' pixels in floating point format from a non-floating point surface, or not supported by your hardware.\n");
+            PsychErrorExitMsg(PsychError_user, "'GetImage' of floating point values from given object not supported on OpenGL-ES!");
+        }
 
-            //in one pass transpose and flip what we read with glReadPixels before returning.
-            //-glReadPixels insists on filling up memory in sequence by reading the screen row-wise whearas Matlab reads up memory into columns.
-            //-the Psychtoolbox screen as setup by gluOrtho puts 0,0 at the top left of the window but glReadPixels always believes that it's at the bottom left.
-            for(ix=0; ix < sampleRectWidth; ix++){
-                for(iy=0; iy < sampleRectHeight; iy++){
-                    // Compute write-indices for returned data:
-                    redReturnIndex=PsychIndexElementFrom3DArray(sampleRectHeight, sampleRectWidth, nrchannels, iy, ix, 0);
-                    greenReturnIndex=PsychIndexElementFrom3DArray(sampleRectHeight, sampleRectWidth,  nrchannels, iy, ix, 1);
-                    blueReturnIndex=PsychIndexElementFrom3DArray(sampleRectHeight, sampleRectWidth,  nrchannels, iy, ix, 2);
-                    alphaReturnIndex=PsychIndexElementFrom3DArray(sampleRectHeight, sampleRectWidth,  nrchannels, iy, ix, 3);
-
-                    // Always return RED/LUMINANCE channel:
-                    returnArrayBase[redReturnIndex] = redPlane[(ix + ((sampleRectHeight-1) - iy ) * sampleRectWidth) * (size_t) stride + 0];
-                    // Other channels on demand:
-                    if (nrchannels>1) returnArrayBase[greenReturnIndex] = redPlane[(ix + ((sampleRectHeight-1) - iy ) * sampleRectWidth) * (size_t) stride + 1];
-                    if (nrchannels>2) returnArrayBase[blueReturnIndex]  = redPlane[(ix + ((sampleRectHeight-1) - iy ) * sampleRectWidth) * (size_t) stride + 2];
-                    if (nrchannels>3) returnArrayBase[alphaReturnIndex] = redPlane[(ix + ((sampleRectHeight-1) - iy ) * sampleRectWidth) * (size_t) stride + 3];
-                }
-            }
+        if (isOES) {
+            // We only do RGBA reads on OES, then discard unwanted stuff ourselves:
+            format = GL_RGBA;
+            stride = 4;
         }
         else {
-            // Readback of standard 32bpc float pixels into a double matrix:
+            format = (nrchannels == 1) ? GL_RED : ((nrchannels == 2) ? GL_LUMINANCE_ALPHA : ((nrchannels == 3) ? GL_RGB : GL_RGBA));
+            stride = nrchannels;
+        }
 
-            // No Luminance + Alpha on OES:
-            if (isOES && (nrchannels == 2)) PsychErrorExitMsg(PsychError_user, "Number of requested channels 'nrchannels' == 2 not supported on OpenGL-ES!");
+        type = (floatprecision) ? GL_FLOAT : GL_UNSIGNED_BYTE;
+        readbackSize = sampleRectWidth * sampleRectHeight * (size_t) stride * ((floatprecision) ? sizeof(float) : 1);
 
-            // Only float readback on floating point FBO's with EXT_color_buffer_float support:
-            if (isOES && ((whichBuffer != GL_COLOR_ATTACHMENT0_EXT) || (windowRecord->bpc < 16) || !glewIsSupported("GL_EXT_color_buffer_float"))) {
-                printf("PTB-ERROR: Tried to 'GetImage' pixels in floating point format from a non-floating point surface, or not supported by your hardware.\n");
-                PsychErrorExitMsg(PsychError_user, "'GetImage' of floating point values from given object not supported on OpenGL-ES!");
-            }
+        // Return row-major arrays to runtimes which prefer them, e.g., Python with NumPy. This
+        // only needs a vertical flip of the image, instead of a transpose:
+        cLayout = PsychUseCMemoryLayoutIfOptimal(TRUE);
 
-            PsychAllocOutDoubleMatArg(1, TRUE, (int) sampleRectHeight, (int) sampleRectWidth, (int) nrchannels, &returnArrayBaseDouble);
-            if (isOES) {
-                dredPlane = (float*) PsychMallocTemp((size_t) 4 * sizeof(float) * sampleRectWidth * sampleRectHeight);
-                stride = 4;
-            }
-            else {
-                dredPlane = (float*) PsychMallocTemp((size_t) nrchannels * sizeof(float) * sampleRectWidth * sampleRectHeight);
-                stride = nrchannels;
-            }
+        if (asyncDepth > 0) {
+            // Async readback: Get result of readback 'asyncDepth' calls ago, if any:
+            pixels = PsychAsyncReadPixels(windowRecord, asyncDepth, (int) sampleRect[kPsychLeft], invertedY, (int) sampleRectWidth, (int) sampleRectHeight,
+                                          format, type, readbackSize);
 
-            glPixelStorei(GL_PACK_ALIGNMENT, 1);
-            invertedY = (int) (windowRect[kPsychBottom]-sampleRect[kPsychBottom]);
+            // None yet? Return an empty matrix:
+            if (NULL == pixels) PsychAllocOutDoubleMatArg(1, FALSE, 0, 0, 0, &returnArrayBaseDouble);
+        }
+        else if (cLayout && !floatprecision && (stride == nrchannels)) {
+            // Row-major uint8 in readback format: Read directly into the returned array and flip it in place:
+            PsychAllocOutUnsignedByteMatArg(1, TRUE, (int) sampleRectHeight, (int) sampleRectWidth, (int) nrchannels, &returnArrayBase);
+            glReadPixels((int) sampleRect[kPsychLeft], invertedY, (int) sampleRectWidth, (int) sampleRectHeight, format, type, returnArrayBase);
+            PsychFlipReadbackRowsInPlace(returnArrayBase, sampleRectWidth * (size_t) nrchannels, sampleRectHeight);
+            pixels = NULL;
+        }
+        else {
+            pixels = PsychMallocTemp(readbackSize);
+            glReadPixels((int) sampleRect[kPsychLeft], invertedY, (int) sampleRectWidth, (int) sampleRectHeight, format, type, (void*) pixels);
+        }
 
-            if (!isOES) {
-                if (nrchannels==1) glReadPixels((int) sampleRect[kPsychLeft], invertedY, (int) sampleRectWidth, (int) sampleRectHeight, GL_RED, GL_FLOAT, dredPlane);
-                if (nrchannels==2) glReadPixels((int) sampleRect[kPsychLeft], invertedY, (int) sampleRectWidth, (int) sampleRectHeight, GL_LUMINANCE_ALPHA, GL_FLOAT, dredPlane);
-                if (nrchannels==3) glReadPixels((int) sampleRect[kPsychLeft], invertedY, (int) sampleRectWidth, (int) sampleRectHeight, GL_RGB, GL_FLOAT, dredPlane);
-                if (nrchannels==4) glReadPixels((int) sampleRect[kPsychLeft], invertedY, (int) sampleRectWidth, (int) sampleRectHeight, GL_RGBA, GL_FLOAT, dredPlane);
+        // In one pass flip and - for column-major arrays - transpose what we read with glReadPixels before returning:
+        // - glReadPixels fills memory row-wise, whereas Matlab/Octave arrays are stored column-wise.
+        // - The Psychtoolbox screen puts 0,0 at the top left of the window, but glReadPixels at the bottom left.
+        if (pixels) {
+            if (!floatprecision) {
+                PsychAllocOutUnsignedByteMatArg(1, TRUE, (int) sampleRectHeight, (int) sampleRectWidth, (int) nrchannels, &returnArrayBase);
+                PsychCopyOutReadbackPixelsUInt8((const psych_uint8*) pixels, stride, returnArrayBase, sampleRectWidth, sampleRectHeight, nrchannels, cLayout);
             }
             else {
-                glReadPixels((int) sampleRect[kPsychLeft], invertedY, (int) sampleRectWidth, (int) sampleRectHeight, GL_RGBA, GL_FLOAT, dredPlane);
-            }
-
-            //in one pass transpose and flip what we read with glReadPixels before returning.
-            //-glReadPixels insists on filling up memory in sequence by reading the screen row-wise whearas Matlab reads up memory into columns.
-            //-the Psychtoolbox screen as setup by gluOrtho puts 0,0 at the top left of the window but glReadPixels always believes that it's at the bottom left.
-            for(ix=0; ix < sampleRectWidth; ix++){
-                for(iy=0; iy < sampleRectHeight; iy++){
-                    // Compute write-indices for returned data:
-                    redReturnIndex=PsychIndexElementFrom3DArray(sampleRectHeight, sampleRectWidth, nrchannels, iy, ix, 0);
-                    greenReturnIndex=PsychIndexElementFrom3DArray(sampleRectHeight, sampleRectWidth,  nrchannels, iy, ix, 1);
-                    blueReturnIndex=PsychIndexElementFrom3DArray(sampleRectHeight, sampleRectWidth,  nrchannels, iy, ix, 2);
-                    alphaReturnIndex=PsychIndexElementFrom3DArray(sampleRectHeight, sampleRectWidth,  nrchannels, iy, ix, 3);
-
-                    // Always return RED/LUMINANCE channel:
-                    returnArrayBaseDouble[redReturnIndex] = dredPlane[(ix + ((sampleRectHeight-1) - iy ) * sampleRectWidth) * (size_t) stride + 0];
-                    // Other channels on demand:
-                    if (nrchannels>1) returnArrayBaseDouble[greenReturnIndex] = dredPlane[(ix + ((sampleRectHeight-1) - iy ) * sampleRectWidth) * (size_t) stride + 1];
-                    if (nrchannels>2) returnArrayBaseDouble[blueReturnIndex]  = dredPlane[(ix + ((sampleRectHeight-1) - iy ) * sampleRectWidth) * (size_t) stride + 2];
-                    if (nrchannels>3) returnArrayBaseDouble[alphaReturnIndex] = dredPlane[(ix + ((sampleRectHeight-1) - iy ) * sampleRectWidth) * (size_t) stride + 3];
-                }
+                PsychAllocOutDoubleMatArg(1, TRUE, (int) sampleRectHeight, (int) sampleRectWidth, (int) nrchannels, &returnArrayBaseDouble);
+                PsychCopyOutReadbackPixelsFloat((const float*) pixels, stride, returnArrayBaseDouble, sampleRectWidth, sampleRectHeight, nrchannels, cLayout);
             }
         }
+
+        if (asyncDepth > 0) PsychReleaseAsyncReadPixels(windowRecord);
     }
 
     if (isAddMovieFrame) {
@@ -599,59 +592,65 @@ PsychError SCREENGetImage(void)
         PsychCopyInIntegerArg(5, FALSE, &frameduration);
         if (frameduration < 1) PsychErrorExitMsg(PsychError_user, "Number of requested framedurations 'frameduration' is negative. Must be greater than zero!");
 
-        framepixels = PsychGetVideoFrameForMoviePtr(moviehandle, &twidth, &theight, &numChannels, &bitdepth);
-        if (framepixels) {
-            glPixelStorei(GL_PACK_ALIGNMENT,1);
-            invertedY = (int) (windowRect[kPsychBottom] - sampleRect[kPsychBottom]);
+        // Query frame format of movie. This also validates the moviehandle:
+        PsychGetMovieFrameFormat(moviehandle, &twidth, &theight, &numChannels, &bitdepth);
 
-            if (isOES) {
-                if (bitdepth != 8) PsychErrorExitMsg(PsychError_user, "AddFrameToMovie failed due to wrong bpc value. Only 8 bpc supported on OpenGL-ES.");
+        if (isOES) {
+            if (bitdepth != 8) PsychErrorExitMsg(PsychError_user, "AddFrameToMovie failed due to wrong bpc value. Only 8 bpc supported on OpenGL-ES.");
 
-                if (numChannels == 4) {
-                    // OES: BGRA supported?
-                    if (glewIsSupported("GL_EXT_read_format_bgra")) {
-                        // Yep: Readback in a compatible and acceptably fast format:
-                        glReadPixels((int) sampleRect[kPsychLeft], invertedY, twidth, theight, GL_BGRA, GL_UNSIGNED_BYTE, framepixels);
-                    }
-                    else {
-                        // Suboptimal readback path. will also cause swapped colors in movie writing:
-                        glReadPixels((int) sampleRect[kPsychLeft], invertedY, twidth, theight, GL_RGBA, GL_UNSIGNED_BYTE, framepixels);
-                    }
-                }
-                else if (numChannels == 3) {
-                    glReadPixels((int) sampleRect[kPsychLeft], invertedY, twidth, theight, GL_RGB, GL_UNSIGNED_BYTE, framepixels);
-                }
-                else PsychErrorExitMsg(PsychError_user, "AddFrameToMovie failed due to wrong number of channels. Only 3 or 4 channels are supported on OpenGL-ES.");
+            type = GL_UNSIGNED_BYTE;
+            if (numChannels == 4) {
+                // OES: BGRA supported? If so, readback in a compatible and acceptably fast format,
+                // otherwise use a suboptimal path which will also cause swapped colors in movie writing:
+                format = (glewIsSupported("GL_EXT_read_format_bgra")) ? GL_BGRA : GL_RGBA;
             }
-            else {
-                // Desktop-GL: Use optimal format and support 16 bpc bitdepth as well.
-                switch (numChannels) {
-                    case 4:
-                        glReadPixels((int) sampleRect[kPsychLeft], invertedY, twidth, theight, GL_BGRA, (bitdepth <= 8) ? GL_UNSIGNED_INT_8_8_8_8 : GL_UNSIGNED_SHORT, framepixels);
-                        break;
-
-                    case 3:
-                        glReadPixels((int) sampleRect[kPsychLeft], invertedY, twidth, theight, GL_RGB, (bitdepth <= 8) ? GL_UNSIGNED_BYTE : GL_UNSIGNED_SHORT, framepixels);
-                        break;
-
-                    case 1:
-                        glReadPixels((int) sampleRect[kPsychLeft], invertedY, twidth, theight, GL_RED, (bitdepth <= 8) ? GL_UNSIGNED_BYTE : GL_UNSIGNED_SHORT, framepixels);
-                        break;
-
-                    default:
-                        PsychErrorExitMsg(PsychError_user, "AddFrameToMovie failed due to wrong number of channels. Only 1, 3 or 4 channels are supported on OpenGL.");
-                        break;
-                }
+            else if (numChannels == 3) {
+                format = GL_RGB;
+            }
+            else PsychErrorExitMsg(PsychError_user, "AddFrameToMovie failed due to wrong number of channels. Only 3 or 4 channels are supported on OpenGL-ES.");
+        }
+        else {
+            // Desktop-GL: Use optimal format and support 16 bpc bitdepth as well.
+            switch (numChannels) {
+                case 4:
+                    format = GL_BGRA;
+                    type = (bitdepth <= 8) ? GL_UNSIGNED_INT_8_8_8_8 : GL_UNSIGNED_SHORT;
+                    break;
+
+                case 3:
+                    format = GL_RGB;
+                    type = (bitdepth <= 8) ? GL_UNSIGNED_BYTE : GL_UNSIGNED_SHORT;
+                    break;
+
+                case 1:
+                    format = GL_RED;
+                    type = (bitdepth <= 8) ? GL_UNSIGNED_BYTE : GL_UNSIGNED_SHORT;
+                    break;
+
+                default:
+                    PsychErrorExitMsg(PsychError_user, "AddFrameToMovie failed due to wrong number of channels. Only 1, 3 or 4 channels are supported on OpenGL.");
+                    break;
             }
+        }
+
+        readbackSize = (size_t) twidth * (size_t) theight * (size_t) numChannels * (size_t) (bitdepth / 8);
+
+        if (asyncDepth > 0) {
+            // Async readback: Hand finished readbacks to the movie writer, which encodes them on its own thread:
+            PsychAsyncReadPixelsToMovie(windowRecord, asyncDepth, (int) sampleRect[kPsychLeft], invertedY, (int) twidth, (int) theight,
+                                        format, type, readbackSize, moviehandle, frameduration);
+        }
+        else {
+            framepixels = PsychGetVideoFrameForMoviePtr(moviehandle, &twidth, &theight, &numChannels, &bitdepth);
+            if (NULL == framepixels) PsychErrorExitMsg(PsychError_user, "Invalid 'moviePtr' provided. Doesn't correspond to a movie open for recording!");
+
+            glReadPixels((int) sampleRect[kPsychLeft], invertedY, (int) twidth, (int) theight, format, type, framepixels);
 
             // Add frame to movie, mark it as "upside down", with invalid -1 timestamp and a duration of frameduration ticks:
             if (PsychAddVideoFrameToMovie(moviehandle, frameduration, TRUE, -1) != 0) {
                 PsychErrorExitMsg(PsychError_user, "AddFrameToMovie failed with error above!");
             }
         }
-        else {
-            PsychErrorExitMsg(PsychError_user, "Invalid 'moviePtr' provided. Doesn't correspond to a movie open for recording!");
-        }
     }
 
     if (viewid == -1) {
@@ -58,6 +58,12 @@ PsychError SCREENGetOpenGLTexture(void)
     if (!PsychIsTexture(textureRecord)) {
         PsychErrorExitMsg(PsychError_user, "You tried to query texture information on something else than a texture!");
     }
+
+    // External OpenGL code may use the texture right away, so it needs its final content:
+    PsychFinishTextureUpload(textureRecord);
+
+    // External code may also modify the texture object or keep using it after 'Close', so don't recycle it via the texture pool:
+    textureRecord->texturePoolFormat = 0;
     
     // Query optional x-pos:
     PsychCopyInDoubleArg(3, FALSE, &x);
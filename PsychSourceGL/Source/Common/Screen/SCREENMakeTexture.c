@@ -18,11 +18,13 @@
  *                1/19/05       awi     Removed unused variables to eliminate compiler warnings.
  *                1/26/05       awi     Added StoreNowTime() calls.
  *                3/19/11       mk      Make 64-bit clean.
+ *                10/18/26      agent   Accept uint16 and single input. SIMD and multi-threaded conversion via PsychTextureConversion.
+ *                10/18/26      agent   Asynchronous texture creation via specialFlags 64 and PsychTextureUploadSupport.
  *
  *        DESCRIPTION:
  *
- *                Conversion code for creating OpenGL textures from Matlab/Octave image matrices. Handles uint8 and
- *                double matrices as input. Converts into 8bpc textures by default, but also supports half_float and
+ *                Conversion code for creating OpenGL textures from Matlab/Octave image matrices. Handles uint8, uint16,
+ *                single and double matrices as input. Converts into 8bpc textures by default, but also supports half_float and
  *                float 16 bpc, 32 bpc floating point textures on modern hardware.
  */
 
@@ -38,6 +40,10 @@ static char synopsisString[] =
 "A is alpha, the transparency of a pixel. Alpha values typically range between zero (=fully transparent) and 255 (=fully opaque).\n"
 "The Screen('ColorRange') command affects the range of expected input values in 'imageMatrix' matrices of double precision type, "
 "as does the optional 'floatprecision' flag discussed below.\n"
+"'imageMatrix' can be of uint8, uint16, single or double precision type. Single precision matrices are treated exactly like "
+"double precision matrices, but need only half the memory. uint16 matrices, e.g., 16 bit images from imread(), are "
+"normalized to the range 0 to 1, ie. 65535 maps to 255 for 8 bpc textures and to 1.0 for floating point textures, "
+"so they are best combined with a 'floatprecision' of 1 or 2 to retain their precision.\n"
 "You need to enable Alpha-Blending via Screen('BlendFunction',...) for the transparency values to have an effect.\n"
 "The argument 'optimizeForDrawAngle' if provided, asks Psychtoolbox to optimize the texture for especially fast "
 "drawing at the specified rotation angle. The default is 0 == Optimize for upright drawing. If 'specialFlags' is set "
@@ -63,6 +69,17 @@ static char synopsisString[] =
 "A 'specialFlags' == 8 will prevent automatic mipmap-generation for GL_TEXTURE_2D textures.\n"
 "A 'specialFlags' == 32 setting will prevent automatic closing of the texture if Screen('Close'); is called. Only "
 "Screen('Close', textureIndex); would close the texture.\n"
+"A 'specialFlags' == 64 setting asks for asynchronous texture creation: A copy of 'imageMatrix' is queued for conversion "
+"and upload by a background thread, and the texture handle is returned immediately, so loading of large stimulus sets "
+"can overlap with other work of your script, e.g., display of instructions. Any use of the texture, e.g., by "
+"Screen('DrawTexture'), will wait for completion of its creation if needed. Use Screen('PreloadTextures') to wait for, "
+"or to check for, completion of all pending texture creations. 'specialFlags' 4 is ignored if combined with 64. Textures "
+"get created synchronously as usual if this is not supported by your system, e.g., on OpenGL-ES, or if texture values need "
+"validation for a 16 bit snorm replacement of 16 bpc float textures.\n"
+"The storage of closed textures is kept in a pool and recycled for new textures of the same size and format, to avoid "
+"memory allocation stalls if textures get created and closed in each trial. The pool holds at most 32 textures and 128 MB "
+"per onscreen window. Set the environment variables PSYCH_TEXTURE_POOL_MAXCOUNT and PSYCH_TEXTURE_POOL_MB before the first "
+"texture gets created to change these limits, a setting of zero disables recycling.\n"
 "'floatprecision' defines the precision with which the texture should be stored and processed. Default value is zero, "
 "which asks to store textures with 8 bit per color component precision, a suitable format for standard images read via "
 "imread(). A non-zero value will store the textures color component values as floating point precision numbers, useful "
@@ -100,19 +117,23 @@ PsychError SCREENMakeTexture(void)
     PsychWindowRecordType       *textureRecord;
     PsychWindowRecordType       *windowRecord;
     PsychRectType               rect;
-    psych_bool                  isImageMatrixBytes, isImageMatrixDoubles;
+    psych_bool                  isImageMatrixBytes;
     int                         numMatrixPlanes, xSize, ySize;
-    unsigned char               *byteMatrix;
-    double                      *doubleMatrix;
+    psych_int64                 m, n, p;
+    PsychArgFormatType          imageType;
+    void                        *imageMatrix;
     GLuint                      *texturePointer;
-    GLubyte                     *texturePointer_b;
     GLfloat                     *texturePointer_f;
-    double                      *rp, *gp, *bp, *ap;
-    GLubyte                     *rpb, *gpb, *bpb, *apb;
+    GLubyte                     *rpb;
+    static const int            rgbaOrder[4] = { 0, 1, 2, 3 };
+    static const int            bgraOrder[4] = { 2, 1, 0, 3 };
+    static const int            argbOrder[4] = { 3, 0, 1, 2 };
     int                         usepoweroftwo, usefloatformat, assume_texorientation, textureShader;
     double                      optimized_orientation;
     psych_bool                  bigendian;
     psych_bool                  planar_storage = FALSE;
+    psych_bool                  asyncupload = FALSE;
+    const int                   *order;
     double                      scaled = 1.0;
     double                      offsetd;
 
@@ -177,12 +198,18 @@ PsychError SCREENMakeTexture(void)
     textureShader = 0;
     PsychCopyInIntegerArg(7, FALSE, &textureShader);
 
-    //get the argument and sanity check it.
-    isImageMatrixBytes=PsychAllocInUnsignedByteMatArg(2, kPsychArgAnything, &ySize, &xSize, &numMatrixPlanes, &byteMatrix);
-    isImageMatrixDoubles=PsychAllocInDoubleMatArg(2, kPsychArgAnything, &ySize, &xSize, &numMatrixPlanes, &doubleMatrix);
+    //get the argument and sanity check it. It is used in its native type, without any intermediate copy:
+    if (!PsychAllocInNativeMatArg64(2, kPsychArgAnything, PsychArgType_uint8 | PsychArgType_uint16 | PsychArgType_single | PsychArgType_double,
+                                    &m, &n, &p, &imageType, &imageMatrix))
+        PsychErrorExitMsg(PsychError_user, "Illegal argument type. Image matrices must be uint8, uint16, single or double data type.");
 
-    if (!(isImageMatrixBytes || isImageMatrixDoubles))
-        PsychErrorExitMsg(PsychError_user, "Illegal argument type. Image matrices must be uint8 or double data type.");
+    if ((m > INT_MAX) || (n > INT_MAX) || (p > INT_MAX))
+        PsychErrorExitMsg(PsychError_inputMatrixIllegalDimensionSize, "Specified image matrix is too big");
+
+    ySize = (int) m;
+    xSize = (int) n;
+    numMatrixPlanes = (int) p;
+    isImageMatrixBytes = (imageType == PsychArgType_uint8) ? TRUE : FALSE;
 
     if (numMatrixPlanes < 1 || numMatrixPlanes > 4) {
         iters = 0; // Make compiler happy.
@@ -241,11 +268,11 @@ PsychError SCREENMakeTexture(void)
     if (usefloatformat<0 || usefloatformat>2)
         PsychErrorExitMsg(PsychError_user, "Invalid value for 'floatprecision' parameter provided! Valid values are 0 for 8bpc int, 1 for 16bpc float or 2 for 32bpc float.");
 
-    if (usefloatformat && !isImageMatrixDoubles) {
-        // Floating point texture requested. We only support this if our input is a double matrix, not
-        // for uint8 matrices - converting them to float precision would be just a waste of ressources
+    if (usefloatformat && isImageMatrixBytes) {
+        // Floating point texture requested. We only support this if our input is a uint16, single or double
+        // matrix, not for uint8 matrices - converting them to float precision would be just a waste of ressources
         // without any benefit for precision.
-        PsychErrorExitMsg(PsychError_user, "Creation of a floating point precision texture requested, but uint8 matrix provided! Only double matrices are acceptable for this mode.");
+        PsychErrorExitMsg(PsychError_user, "Creation of a floating point precision texture requested, but uint8 matrix provided! Only uint16, single or double matrices are acceptable for this mode.");
     }
 
     // Float texture on OpenGL-ES requested?
@@ -283,8 +310,21 @@ PsychError SCREENMakeTexture(void)
         if (PsychPrefStateGet_Verbosity() > 7) printf("PTB-DEBUG: Using standard storage for %i layer texture of size %i x %i texels.\n", numMatrixPlanes, xSize, ySize);
     }
 
+    // Asynchronous texture creation requested and possible? The range check of 16 bit snorm
+    // textures as replacement of 16 bpc float textures needs the converted values, so it
+    // only works synchronously:
+    if ((usepoweroftwo & 64) && !planar_storage && !((usefloatformat == 1) && !(windowRecord->gfxcaps & kPsychGfxCapFPTex16)) &&
+        PsychGetTextureUploader(windowRecord)) {
+        // Conversion and upload get done by the texture upload thread of windowRecord:
+        asyncupload = TRUE;
+    }
+
     //Allocate the texture memory and copy the MATLAB matrix into the texture memory.
-    if (usefloatformat || (planar_storage && !isImageMatrixBytes)) {
+    if (asyncupload) {
+        // No texture memory, as PsychCreateTexture() only allocates the storage:
+        textureRecord->textureMemorySizeBytes = 0;
+    }
+    else if (usefloatformat || (planar_storage && !isImageMatrixBytes)) {
         // Allocate a double for each color component and pixel:
         textureRecord->textureMemorySizeBytes = sizeof(double) * (size_t) numMatrixPlanes * (size_t) xSize * (size_t) ySize;
     }
@@ -296,7 +336,11 @@ PsychError SCREENMakeTexture(void)
     // We allocate our own intermediate conversion buffer unless this is
     // creation of a single-layer luminance8 integer texture from a single
     // layer uint8 input matrix and client storage is disabled. In that case, we can use a zero-copy path:
-    if ((isImageMatrixBytes && (numMatrixPlanes == 1) && (!usefloatformat) && !(PsychPrefStateGet_ConserveVRAM() & kPsychDontCacheTextures)) ||
+    if (asyncupload) {
+        // Asynchronous creation: Conversion happens on the texture upload thread.
+        texturePointer = NULL;
+    }
+    else if ((isImageMatrixBytes && (numMatrixPlanes == 1) && (!usefloatformat) && !(PsychPrefStateGet_ConserveVRAM() & kPsychDontCacheTextures)) ||
         (isImageMatrixBytes && planar_storage)) {
         // Zero copy path:
         texturePointer = NULL;
@@ -325,7 +369,7 @@ PsychError SCREENMakeTexture(void)
 
         // Zero-Copy possible? Only for uint8 input -> uint8 output:
         if (texturePointer == NULL) {
-            texturePointer = (GLuint*) byteMatrix;
+            texturePointer = (GLuint*) imageMatrix;
             textureRecord->textureMemory = texturePointer;
             // Set size to zero, so PsychCreateTexture() does not free() our
             // input buffer:
@@ -338,8 +382,8 @@ PsychError SCREENMakeTexture(void)
             textureRecord->textureinternalformat = GL_LUMINANCE8;
         }
         else {
-            // Some cast operation needed from double input format.
-            // We always cast from double to float, potentially with
+            // Some cast operation needed from uint16, single or double input format.
+            // We always cast to float or uint8, potentially with
             // normalization and/or checking of value range.
             textureRecord->textureexternalformat = GL_LUMINANCE;
 
@@ -352,44 +396,30 @@ PsychError SCREENMakeTexture(void)
                 // Override for missing floating point texture support: Try to use 16 bit fixed point signed normalized textures [-1.0 ; 1.0] resolved at 15 bits:
                 if ((usefloatformat == 1) && !(windowRecord->gfxcaps & kPsychGfxCapFPTex16)) textureRecord->textureinternalformat = GL_LUMINANCE16_SNORM;
 
-                // Perform copy with double -> float cast:
-                iters = (size_t) xSize * (size_t) ySize * (size_t) numMatrixPlanes;
-                texturePointer_f = (GLfloat*) texturePointer;
-                for(ix = 0; ix < iters; ix++) {
-                    *(texturePointer_f++) = (GLfloat) *(doubleMatrix++);
-                }
+                // Perform copy with cast to float. All planes are converted as one big plane:
                 iters = (size_t) xSize * (size_t) ySize;
+                PsychConvertTexturePlanes(imageMatrix, imageType, iters * (size_t) numMatrixPlanes, 1, rgbaOrder, texturePointer, TRUE, 1.0, 0.0);
             }
             else {
-                // 8 Bit format, but from double input matrix -> cast to uint8:
+                // 8 Bit format, but from non-uint8 input matrix -> cast to uint8:
                 textureRecord->depth = 8 * numMatrixPlanes;
                 textureRecord->textureexternaltype = GL_UNSIGNED_BYTE;
                 textureRecord->textureinternalformat = GL_LUMINANCE8;
 
-                iters = (size_t) xSize * (size_t) ySize * (size_t) numMatrixPlanes;
-                texturePointer_b = (GLubyte*) texturePointer;
-                for(ix = 0; ix < iters; ix++) {
-                    *(texturePointer_b++) = (GLubyte) (offsetd + scaled * *(doubleMatrix++));
-                }
                 iters = (size_t) xSize * (size_t) ySize;
+                PsychConvertTexturePlanes(imageMatrix, imageType, iters * (size_t) numMatrixPlanes, 1, rgbaOrder, texturePointer, FALSE, scaled, offsetd);
             }
         }
     }
     else if (usefloatformat) {
-        // Conversion routines for HDR 16 bpc or 32 bpc textures -- Slow path.
-        // Our input is always double matrices...
+        // Conversion routines for HDR 16 bpc or 32 bpc textures. Our input is uint16, single
+        // or double matrices. Our input buffer is always of GL_FLOAT precision:
         iters = (size_t) xSize * (size_t) ySize;
-
-        // Our input buffer is always of GL_FLOAT precision:
         textureRecord->textureexternaltype = GL_FLOAT;
-        texturePointer_f=(GLfloat*) texturePointer;
+        if (!asyncupload) PsychConvertTexturePlanes(imageMatrix, imageType, iters, numMatrixPlanes, rgbaOrder, texturePointer, TRUE, 1.0, 0.0);
+        textureRecord->depth = ((usefloatformat == 1) ? 16 : 32) * numMatrixPlanes;
 
         if (numMatrixPlanes==1) {
-            for(ix=0;ix<iters;ix++){
-                *(texturePointer_f++)= (GLfloat) *(doubleMatrix++);
-            }
-            textureRecord->depth=(usefloatformat==1) ? 16 : 32;
-
             textureRecord->textureinternalformat = (usefloatformat==1) ? GL_LUMINANCE_FLOAT16_APPLE : GL_LUMINANCE_FLOAT32_APPLE;
             textureRecord->textureexternalformat = GL_LUMINANCE;
 
@@ -398,14 +428,6 @@ PsychError SCREENMakeTexture(void)
         }
 
         if (numMatrixPlanes==2) {
-            rp=(double*) ((size_t) doubleMatrix);
-            ap=(double*) ((size_t) rp + (size_t) iters * sizeof(double));
-
-            for(ix=0;ix<iters;ix++){
-                *(texturePointer_f++)= (GLfloat) *(rp++);
-                *(texturePointer_f++)= (GLfloat) *(ap++);
-            }
-            textureRecord->depth=(usefloatformat==1) ? 32 : 64;
             textureRecord->textureinternalformat = (usefloatformat==1) ? GL_LUMINANCE_ALPHA_FLOAT16_APPLE : GL_LUMINANCE_ALPHA_FLOAT32_APPLE;
             textureRecord->textureexternalformat = GL_LUMINANCE_ALPHA;
 
@@ -414,16 +436,6 @@ PsychError SCREENMakeTexture(void)
         }
 
         if (numMatrixPlanes==3) {
-            rp=(double*) ((size_t) doubleMatrix);
-            gp=(double*) ((size_t) rp + (size_t) iters * sizeof(double));
-            bp=(double*) ((size_t) gp + (size_t) iters * sizeof(double));
-
-            for(ix=0;ix<iters;ix++){
-                *(texturePointer_f++)= (GLfloat) *(rp++);
-                *(texturePointer_f++)= (GLfloat) *(gp++);
-                *(texturePointer_f++)= (GLfloat) *(bp++);
-            }
-            textureRecord->depth=(usefloatformat==1) ? 48 : 96;
             textureRecord->textureinternalformat = (usefloatformat==1) ? GL_RGB_FLOAT16_APPLE : GL_RGB_FLOAT32_APPLE;
             textureRecord->textureexternalformat = GL_RGB;
 
@@ -432,18 +444,6 @@ PsychError SCREENMakeTexture(void)
         }
 
         if (numMatrixPlanes==4) {
-            rp=(double*) ((size_t) doubleMatrix);
-            gp=(double*) ((size_t) rp + (size_t) iters * sizeof(double));
-            bp=(double*) ((size_t) gp + (size_t) iters * sizeof(double));
-            ap=(double*) ((size_t) bp + (size_t) iters * sizeof(double));
-
-            for(ix=0;ix<iters;ix++){
-                *(texturePointer_f++)= (GLfloat) *(rp++);
-                *(texturePointer_f++)= (GLfloat) *(gp++);
-                *(texturePointer_f++)= (GLfloat) *(bp++);
-                *(texturePointer_f++)= (GLfloat) *(ap++);
-            }
-            textureRecord->depth=(usefloatformat==1) ? 64 : 128;
             textureRecord->textureinternalformat = (usefloatformat==1) ? GL_RGBA_FLOAT16_APPLE : GL_RGBA_FLOAT32_APPLE;
             textureRecord->textureexternalformat = GL_RGBA;
 
@@ -456,150 +456,27 @@ PsychError SCREENMakeTexture(void)
         // Standard LDR texture 8 bpc conversion routines -- Fast path.
         iters = (size_t) xSize * (size_t) ySize;
 
-        // Improved implementation: Takes 13 ms on a 800x800 texture...
-        if (isImageMatrixDoubles && numMatrixPlanes==1){
-            texturePointer_b=(GLubyte*) texturePointer;
-            for(ix=0;ix<iters;ix++){
-                *(texturePointer_b++)= (GLubyte) (offsetd + scaled * *(doubleMatrix++));
-            }
-            textureRecord->depth=8;
-        }
-
-        // Improved version: Takes 3 ms on a 800x800 texture...
-        // NB: Implementing memcpy manually by a for-loop takes 10 ms! This is a huge difference.
-        // -> That's because memcpy on MacOS-X is implemented with hand-coded, highly tuned Assembler code for PowerPC.
-        // -> It's always wise to use system-routines if available, instead of coding it by yourself!
-        if (isImageMatrixBytes && numMatrixPlanes==1) {
-            if (texturePointer) {
-                // Need to do a copy. Use optimized memcpy():
-                memcpy((void*) texturePointer, (void*) byteMatrix, iters);
-
-                //texturePointer_b=(GLubyte*) texturePointer;
-                //for(ix=0;ix<iters;ix++){
-                //    *(texturePointer_b++) = *(byteMatrix++);
-                //}
-            }
-            else {
-                // Zero-Copy path. Just pass a pointer to our input matrix:
-                texturePointer = (GLuint*) byteMatrix;
-                textureRecord->textureMemory = texturePointer;
-                // Set size to zero, so PsychCreateTexture() does not free() our
-                // input buffer:
-                textureRecord->textureMemorySizeBytes = 0;
-            }
-
-            textureRecord->depth=8;
-        }
-
-        // New version: Takes 33 ms on a 800x800 texture...
-        if (isImageMatrixDoubles && numMatrixPlanes==2){
-            texturePointer_b=(GLubyte*) texturePointer;
-            rp=(double*) ((size_t) doubleMatrix);
-            ap=(double*) ((size_t) rp + (size_t) iters * sizeof(double));
-            for(ix=0;ix<iters;ix++){
-                *(texturePointer_b++)= (GLubyte) (offsetd + scaled * *(rp++));
-                *(texturePointer_b++)= (GLubyte) (offsetd + scaled * *(ap++));
-            }
-            textureRecord->depth=16;
-        }
-
-        // New version: Takes 20 ms on a 800x800 texture...
-        if (isImageMatrixBytes && numMatrixPlanes==2){
-            texturePointer_b=(GLubyte*) texturePointer;
-            rpb=(GLubyte*) ((size_t) byteMatrix);
-            apb=(GLubyte*) ((size_t) rpb + (size_t) iters);
-            for(ix=0;ix<iters;ix++){
-                *(texturePointer_b++)= *(rpb++);
-                *(texturePointer_b++)= *(apb++);
-            }
-            textureRecord->depth=16;
+        if (asyncupload) {
+            // Conversion happens on the texture upload thread.
         }
-
-        // Improved version: Takes 43 ms on a 800x800 texture...
-        if (isImageMatrixDoubles && numMatrixPlanes==3){
-            texturePointer_b=(GLubyte*) texturePointer;
-            rp=(double*) ((size_t) doubleMatrix);
-            gp=(double*) ((size_t) rp + (size_t) iters * sizeof(double));
-            bp=(double*) ((size_t) gp + (size_t) iters * sizeof(double));
-            for(ix=0;ix<iters;ix++){
-                *(texturePointer_b++)= (GLubyte) (offsetd + scaled * *(rp++));
-                *(texturePointer_b++)= (GLubyte) (offsetd + scaled * *(gp++));
-                *(texturePointer_b++)= (GLubyte) (offsetd + scaled * *(bp++));
-            }
-            textureRecord->depth=24;
-        }
-
-        // Improved version: Takes 25 ms on a 800x800 texture...
-        if (isImageMatrixBytes && numMatrixPlanes==3){
-            texturePointer_b=(GLubyte*) texturePointer;
-            rpb=(GLubyte*) ((size_t) byteMatrix);
-            gpb=(GLubyte*) ((size_t) rpb + (size_t) iters);
-            bpb=(GLubyte*) ((size_t) gpb + (size_t) iters);
-            for(ix=0;ix<iters;ix++){
-                *(texturePointer_b++)= *(rpb++);
-                *(texturePointer_b++)= *(gpb++);
-                *(texturePointer_b++)= *(bpb++);
-            }
-            textureRecord->depth=24;
+        else if (texturePointer == NULL) {
+            // Zero-Copy path for single layer uint8 input. Just pass a pointer to our input matrix:
+            texturePointer = (GLuint*) imageMatrix;
+            textureRecord->textureMemory = texturePointer;
+            // Set size to zero, so PsychCreateTexture() does not free() our
+            // input buffer:
+            textureRecord->textureMemorySizeBytes = 0;
         }
-
-        // Improved version: Takes 55 ms on a 800x800 texture...
-        if (isImageMatrixDoubles && numMatrixPlanes==4){
-            texturePointer_b=(GLubyte*) texturePointer;
-            rp=(double*) ((size_t) doubleMatrix);
-            gp=(double*) ((size_t) rp + (size_t) iters * sizeof(double));
-            bp=(double*) ((size_t) gp + (size_t) iters * sizeof(double));
-            ap=(double*) ((size_t) bp + (size_t) iters * sizeof(double));
-            if (bigendian) {
-                // Code for big-endian machines like PowerPC:
-                for(ix=0;ix<iters;ix++){
-                    *(texturePointer_b++)= (GLubyte) (offsetd + scaled * *(ap++));
-                    *(texturePointer_b++)= (GLubyte) (offsetd + scaled * *(rp++));
-                    *(texturePointer_b++)= (GLubyte) (offsetd + scaled * *(gp++));
-                    *(texturePointer_b++)= (GLubyte) (offsetd + scaled * *(bp++));
-                }
-            }
-            else {
-                // Code for little-endian machines like Intel Pentium:
-                for(ix=0;ix<iters;ix++){
-                    *(texturePointer_b++)= (GLubyte) (offsetd + scaled * *(bp++));
-                    *(texturePointer_b++)= (GLubyte) (offsetd + scaled * *(gp++));
-                    *(texturePointer_b++)= (GLubyte) (offsetd + scaled * *(rp++));
-                    *(texturePointer_b++)= (GLubyte) (offsetd + scaled * *(ap++));
-                }
-            }
-
-            textureRecord->depth=32;
+        else {
+            // Convert and interleave planes. uint8 input is copied, everything else is scaled and
+            // cast to uint8. RGBA textures are stored in BGRA order on little-endian machines like
+            // Intel, and in ARGB order on big-endian machines like PowerPC:
+            PsychConvertTexturePlanes(imageMatrix, imageType, iters, numMatrixPlanes,
+                                      (numMatrixPlanes == 4) ? ((bigendian) ? argbOrder : bgraOrder) : rgbaOrder,
+                                      texturePointer, FALSE, scaled, offsetd);
         }
 
-        // Improved version: Takes 33 ms on a 800x800 texture...
-        if (isImageMatrixBytes && numMatrixPlanes==4){
-            texturePointer_b=(GLubyte*) texturePointer;
-            rpb=(GLubyte*) ((size_t) byteMatrix);
-            gpb=(GLubyte*) ((size_t) rpb + (size_t) iters);
-            bpb=(GLubyte*) ((size_t) gpb + (size_t) iters);
-            apb=(GLubyte*) ((size_t) bpb + (size_t) iters);
-            if (bigendian) {
-                // Code for big-endian machines like PowerPC:
-                for(ix=0;ix<iters;ix++){
-                    *(texturePointer_b++)= *(apb++);
-                    *(texturePointer_b++)= *(rpb++);
-                    *(texturePointer_b++)= *(gpb++);
-                    *(texturePointer_b++)= *(bpb++);
-                }
-            }
-            else {
-                // Code for little-endian machines like Intel Pentium:
-                for(ix=0;ix<iters;ix++){
-                    *(texturePointer_b++)= *(bpb++);
-                    *(texturePointer_b++)= *(gpb++);
-                    *(texturePointer_b++)= *(rpb++);
-                    *(texturePointer_b++)= *(apb++);
-                }
-            }
-
-            textureRecord->depth=32;
-        }
+        textureRecord->depth = 8 * numMatrixPlanes;
     } // End of 8 bpc texture conversion code (fast-path for LDR textures)
 
     // Override for missing floating point texture support?
@@ -639,7 +516,7 @@ PsychError SCREENMakeTexture(void)
     // type texture. Instead it seems to initialize with trash data, corrupting the texture.
     // Therefore, if FLOAT16 texture creation is requested, we loop over the whole input buffer and
     // set all values with magnitude smaller than 1e-9 to zero. Better safe than sorry...
-    if ((usefloatformat==1) && (windowRecord->gfxcaps & kPsychGfxCapFPTex16)) {
+    if ((usefloatformat==1) && (windowRecord->gfxcaps & kPsychGfxCapFPTex16) && !asyncupload) {
         texturePointer_f=(GLfloat*) texturePointer;
         iters = iters * (size_t) numMatrixPlanes;
         for(ix=0; ix<iters; ix++, texturePointer_f++) if(fabs((double) *texturePointer_f) < 1e-9) { *texturePointer_f = 0.0; }
@@ -691,6 +568,17 @@ PsychError SCREENMakeTexture(void)
         // Let's create and bind a new texture object and fill it with our new texture data.
         PsychCreateTexture(textureRecord);
 
+        // Asynchronous creation? Queue conversion and upload of the content into the empty texture:
+        if (asyncupload) {
+            if (usefloatformat)
+                order = rgbaOrder;
+            else
+                order = (numMatrixPlanes == 4) ? ((bigendian) ? argbOrder : bgraOrder) : rgbaOrder;
+
+            PsychQueueTextureUpload(windowRecord, textureRecord, imageMatrix, imageType, numMatrixPlanes, order, (usefloatformat) ? TRUE : FALSE,
+                                    scaled, offsetd, ((usefloatformat == 1) && (windowRecord->gfxcaps & kPsychGfxCapFPTex16)) ? TRUE : FALSE);
+        }
+
         // Assign GLSL filter-/lookup-shaders if needed:
         PsychAssignHighPrecisionTextureShaders(textureRecord, windowRecord, usefloatformat, (usepoweroftwo & 2) ? 1 : 0);
     }
@@ -736,3 +624,104 @@ PsychError SCREENMakeTexture(void)
 
     return(PsychError_none);
 }
+
+// If you change useString then also change the corresponding synopsis string in ScreenSynopsis.c
+static char useStringBenchmark[] = "results = Screen('MakeTextureBenchmark' [, width=1920][, height=1080][, iterations=10]);";
+//                                                                          1              2               3
+static char synopsisStringBenchmark[] =
+"Measure the speed of the conversion of image matrices into texture data, as done by Screen('MakeTexture').\n"
+"For each combination of input type (uint8, uint16, single, double), number of layers (1 - 4) and output "
+"type (8 bpc or floating point), a synthetic 'width' x 'height' pixels image is converted 'iterations' times, "
+"and the fastest conversion is reported. No window, OpenGL context or graphics hardware is needed, so "
+"this also works on headless machines. uint8 to floating point texture conversion is not supported by "
+"'MakeTexture' and therefore skipped.\n"
+"Images with more than half a million pixel components are converted by multiple threads, one per processor "
+"core, but at most 8. 'threads' in the results is the number of threads available. Set the environment "
+"variable PSYCH_CONVERSION_THREADS before the first use of 'MakeTexture' or 'MakeTextureBenchmark' to "
+"select a different number of threads, e.g., 1 to disable multi-threading.\n"
+"Returns a struct array 'results' with one element per combination, with the fields 'inputType', "
+"'planes', 'floatOutput' (0 or 1), 'threads', 'msecs' for one conversion, and 'megaPixelsPerSec'.\n"
+"Input values of double and single type are scaled by 255, as with Screen('ColorRange', win, 1, [], 1).\n";
+static char seeAlsoStringBenchmark[] = "MakeTexture";
+
+PsychError SCREENMakeTextureBenchmark(void)
+{
+    static const char *FieldNames[] = { "inputType", "planes", "floatOutput", "threads", "msecs", "megaPixelsPerSec" };
+    enum { kFieldInputType, kFieldPlanes, kFieldFloatOutput, kFieldThreads, kFieldMsecs, kFieldMegaPixelsPerSec,
+           kNumFields };
+    static const char *typeNames[] = { "uint8", "uint16", "single", "double" };
+    static const PsychArgFormatType types[] = { PsychArgType_uint8, PsychArgType_uint16, PsychArgType_single, PsychArgType_double };
+    static const int rgbaOrder[4] = { 0, 1, 2, 3 };
+    static const int bgraOrder[4] = { 2, 1, 0, 3 };
+    PsychStructBuilder results;
+    int width, height, iterations, t, planes, floatout, i, count, threads;
+    size_t npixels, k;
+    unsigned char *src;
+    void *dst;
+    double tstart, tend, tbest;
+
+    //all subfunctions should have these two lines.
+    PsychPushHelp(useStringBenchmark, synopsisStringBenchmark, seeAlsoStringBenchmark);
+    if (PsychIsGiveHelp()) { PsychGiveHelp(); return(PsychError_none); };
+
+    PsychErrorExit(PsychCapNumInputArgs(3));
+    PsychErrorExit(PsychCapNumOutputArgs(1));
+
+    width = 1920;
+    PsychCopyInIntegerArg(1, FALSE, &width);
+    height = 1080;
+    PsychCopyInIntegerArg(2, FALSE, &height);
+    if ((width < 1) || (height < 1) || ((double) width * (double) height > 256 * 1024 * 1024))
+        PsychErrorExitMsg(PsychError_user, "Invalid 'width' or 'height' specified. Must be at least 1, and at most 256 Megapixels in total.");
+
+    iterations = 10;
+    PsychCopyInIntegerArg(3, FALSE, &iterations);
+    if (iterations < 1) PsychErrorExitMsg(PsychError_user, "Invalid 'iterations' specified. Must be at least 1.");
+
+    // Source image with 4 layers of the biggest type, and destination of 4 float components per pixel.
+    // Content is a ramp of valid values for all input types:
+    npixels = (size_t) width * (size_t) height;
+    src = (unsigned char*) PsychMallocTemp(npixels * 4 * sizeof(double));
+    dst = PsychMallocTemp(npixels * 4 * sizeof(GLfloat));
+    threads = PsychGetTextureConversionThreads();
+
+    PsychAllocOutStructBuilder(1, FALSE, 4 * 4 * 2 - 4, kNumFields, FieldNames, &results);
+
+    count = 0;
+    for (t = 0; t < 4; t++) {
+        for (k = 0; k < npixels * 4; k++) {
+            switch (types[t]) {
+                case PsychArgType_uint8:  ((psych_uint8*) src)[k] = (psych_uint8) (k % 256); break;
+                case PsychArgType_uint16: ((psych_uint16*) src)[k] = (psych_uint16) (k % 65536); break;
+                case PsychArgType_single: ((float*) src)[k] = (float) (k % 256) / 255.0f; break;
+                default:                  ((double*) src)[k] = (double) (k % 256) / 255.0; break;
+            }
+        }
+
+        for (floatout = 0; floatout < 2; floatout++) {
+            // uint8 input is not accepted for float textures:
+            if (floatout && (types[t] == PsychArgType_uint8)) continue;
+
+            for (planes = 1; planes <= 4; planes++) {
+                tbest = DBL_MAX;
+                for (i = 0; i < iterations; i++) {
+                    PsychGetAdjustedPrecisionTimerSeconds(&tstart);
+                    PsychConvertTexturePlanes(src, types[t], npixels, planes, (planes == 4) ? bgraOrder : rgbaOrder,
+                                              dst, (psych_bool) floatout, 255.0, 0.5);
+                    PsychGetAdjustedPrecisionTimerSeconds(&tend);
+                    if (tend - tstart < tbest) tbest = tend - tstart;
+                }
+
+                PsychSetStructBuilderStringElement(&results, kFieldInputType, count, typeNames[t]);
+                PsychSetStructBuilderDoubleElement(&results, kFieldPlanes, count, planes);
+                PsychSetStructBuilderDoubleElement(&results, kFieldFloatOutput, count, floatout);
+                PsychSetStructBuilderDoubleElement(&results, kFieldThreads, count, threads);
+                PsychSetStructBuilderDoubleElement(&results, kFieldMsecs, count, tbest * 1000);
+                PsychSetStructBuilderDoubleElement(&results, kFieldMegaPixelsPerSec, count, (double) npixels / tbest / 1e6);
+                count++;
+            }
+        }
+    }
+
+    return(PsychError_none);
+}
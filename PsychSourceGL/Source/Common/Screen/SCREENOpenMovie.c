@@ -337,11 +337,19 @@ PsychError SCREENOpenMovie(void)
 
 PsychError SCREENFinalizeMovie(void)
 {
-    static char useString[] = "Screen('FinalizeMovie', moviePtr);";
-    static char synopsisString[] = "Finish creating a new movie file with handle 'moviePtr' and store it to filesystem.\n";
+    static char useString[] = "[framesWritten, framesDropped, meanLatency, maxLatency] = Screen('FinalizeMovie', moviePtr);";
+    static char synopsisString[] = "Finish creating a new movie file with handle 'moviePtr' and store it to filesystem.\n"
+        "Optionally returns statistics about the written video frames: 'framesWritten' is the number of frames "
+        "added to the movie. 'framesDropped' is the number of frames dropped by asynchronous 'AddFrameToMovie' "
+        "because the encoder could not keep up, if the keyword 'WriterDropFrames' was specified in "
+        "Screen('CreateMovie'). 'meanLatency' and 'maxLatency' are the mean and maximum time in seconds from "
+        "readback of a frame by asynchronous 'AddFrameToMovie' until its hand-over to the encoder, or zero if "
+        "no frames were added asynchronously.\n";
     static char seeAlsoString[] = "CreateMovie AddFrameToMovie CloseMovie PlayMovie GetMovieImage GetMovieTimeIndex SetMovieTimeIndex";
 
     int moviehandle = -1;
+    unsigned int framesWritten, framesDropped;
+    double meanLatency, maxLatency;
 
     // All sub functions should have these two lines
     PsychPushHelp(useString, synopsisString, seeAlsoString);
@@ -349,11 +357,23 @@ PsychError SCREENFinalizeMovie(void)
 
     PsychErrorExit(PsychCapNumInputArgs(1));            // Max. 3 input args.
     PsychErrorExit(PsychRequireNumInputArgs(1));        // Min. 2 input args required.
-    PsychErrorExit(PsychCapNumOutputArgs(0));           // Max. 1 output args.
+    PsychErrorExit(PsychCapNumOutputArgs(4));           // Max. 4 output args.
 
     // Get the moviehandle:
     PsychCopyInIntegerArg(1, kPsychArgRequired, &moviehandle);
 
+    // Add frames still pending from asynchronous 'AddFrameToMovie':
+    PsychFlushAsyncMovieFrames(moviehandle);
+
+    // Get statistics after all frames are written:
+    if (PsychGetNumOutputArgs() > 0) {
+        PsychGetMovieWriterStats(moviehandle, &framesWritten, &framesDropped, &meanLatency, &maxLatency);
+        PsychCopyOutDoubleArg(1, FALSE, (double) framesWritten);
+        PsychCopyOutDoubleArg(2, FALSE, (double) framesDropped);
+        PsychCopyOutDoubleArg(3, FALSE, meanLatency);
+        PsychCopyOutDoubleArg(4, FALSE, maxLatency);
+    }
+
     // Finalize the movie:
     if (!PsychFinalizeNewMovieFile(moviehandle)) {
         PsychErrorExitMsg(PsychError_user, "FinalizeMovie failed for reason mentioned above.");
@@ -391,6 +411,12 @@ PsychError SCREENCreateMovie(void)
         "Keywords unknown to a certain implementation or codec will be silently ignored:\n"
         "EncodingQuality=x Set encoding quality to value x, in the range 0.0 for lowest movie quality to "
         "1.0 for highest quality. Default is 0.5 = normal quality. 1.0 often provides near-lossless encoding.\n"
+        "WriterQueueDepth=n Set the maximum number of video frames queued for encoding by asynchronous "
+        "Screen('AddFrameToMovie', ..., asyncDepth) calls to n. Frames are copied and fed to the encoder by a "
+        "separate writer thread. Default is 8. A setting of zero disables the writer thread.\n"
+        "WriterDropFrames If the encoder can't keep up and the writer queue is full, drop new frames instead of "
+        "waiting for space in the queue. The frame preceding a dropped frame is shown for longer in the movie, and the "
+        "number of dropped frames is reported by Screen('FinalizeMovie').\n"
         "'numChannels' Optional number of image channels to encode: Can be 1, 3 or 4 on OpenGL graphics hardware, "
         "and 3 or 4 on OpenGL-ES hardware. 1 = Red/Grayscale channel only, 3 = RGB, 4 = RGBA. Please note that not "
         "all video codecs can encode pure 1 channel data or RGBA data, ie. an alpha channel. If an unsuitable codec "
@@ -17,6 +17,7 @@
 		mm/dd/yy   
  
 		12/04/05	mk		Created  							
+		10/18/26	agent		Wait for or poll for completion of asynchronous 'MakeTexture'.
 		
 	TO DO:
   
@@ -26,8 +27,8 @@
 #include "Screen.h"
 
 // If you change the useString then also change the corresponding synopsis string in ScreenSynopsis.c
-static char useString[] = "[resident [texidresident]] = Screen('PreloadTextures', windowPtr [, texids]);";
-//                                                                                1          2
+static char useString[] = "[resident [texidresident]] = Screen('PreloadTextures', windowPtr [, texids][, dontWait=0]);";
+//                                                                                1          2          3
 static char synopsisString[] = 
 "Try to preload textures into VRAM to facilitate fast drawing. This method tries "
 "to upload textures into the local (and fast) VRAM of your graphics hardware before "
@@ -39,7 +40,11 @@ static char synopsisString[] =
 "The return value 'resident' tells you, if all requested textures could be preloaded. A value of 1 "
 "means full success. The 'texidresident' vector tells you for each texture, if that "
 "specific texture could be preloaded. Preloading requested textures can fail if your gfx-hardware "
-"has an insufficient amount of free VRAM memory. ";
+"has an insufficient amount of free VRAM memory. "
+"Textures which are created asynchronously via Screen('MakeTexture') with 'specialFlags' 64 are waited for "
+"until their creation is complete. If the optional flag 'dontWait' is set to 1, the function doesn't wait. Textures "
+"whose creation is still in progress are then reported as not preloaded, so you can poll for completion of all "
+"texture creations, e.g., while your script displays instructions. ";
 
 static char seeAlsoString[] = "MakeTexture DrawTexture GetMovieImage";	 
 
@@ -55,6 +60,8 @@ PsychError SCREENPreloadTextures(void)
         GLuint*                                 texids;
         GLboolean*                              texresident;
         psych_bool                                 failed = false;
+        psych_bool                                 anypending = false;
+        int                                     dontWait = 0;
         GLclampf                                maxprio = 1.0f;
         GLenum                                  target;
 
@@ -63,7 +70,7 @@ PsychError SCREENPreloadTextures(void)
 	if(PsychIsGiveHelp()){PsychGiveHelp();return(PsychError_none);};
 	
 	//check for superfluous arguments
-	PsychErrorExit(PsychCapNumInputArgs(2));        //The maximum number of inputs
+	PsychErrorExit(PsychCapNumInputArgs(3));        //The maximum number of inputs
 	PsychErrorExit(PsychRequireNumInputArgs(1));    //The minimum number of inputs
 	PsychErrorExit(PsychCapNumOutputArgs(2));       //The maximum number of outputs
 	
@@ -74,7 +81,26 @@ PsychError SCREENPreloadTextures(void)
 	isArgThere = PsychIsArgPresent(PsychArgIn, 2);
         PsychAllocInIntegerListArg(2, FALSE, &n, &texhandles);
         if (n < 1) isArgThere=FALSE;
-        
+
+        // Get optional dontWait flag:
+        PsychCopyInIntegerArg(3, FALSE, &dontWait);
+
+        PsychCreateVolatileWindowRecordPointerList(&numWindows, &windowRecordArray);
+
+        // Wait for, or check for, completion of asynchronous texture creation of all requested textures.
+        // This must happen before we setup for preloading, as it may switch OpenGL contexts. Textures
+        // which are still pending afterwards, because of dontWait, get skipped by the preloading below:
+        for (i = 0; i < ((isArgThere) ? n : numWindows); i++) {
+            texwin = NULL;
+            if (!isArgThere) texwin = windowRecordArray[i];
+            else if (IsWindowIndex(texhandles[i])) FindWindowRecord(texhandles[i], &texwin);
+
+            if (texwin && texwin->windowType==kPsychTexture && texwin->textureUploadJob) {
+                if (!dontWait || !PsychIsTextureUploadPending(texwin)) PsychFinishTextureUpload(texwin);
+                else anypending = true;
+            }
+        }
+
         // Enable this windowRecords framebuffer as current drawingtarget:
         PsychSetDrawingTarget(windowRecord);
 
@@ -95,8 +121,6 @@ PsychError SCREENPreloadTextures(void)
         glPushMatrix();
         glLoadIdentity();
 
-        PsychCreateVolatileWindowRecordPointerList(&numWindows, &windowRecordArray);            
-
         // Process vector of all texids for all requested textures:
         if (!isArgThere) {
             // No handles provided: In this case, we preload all textures:
@@ -104,6 +128,8 @@ PsychError SCREENPreloadTextures(void)
             for(i=0; i<numWindows; i++) {                
                 if (windowRecordArray[i]->windowType==kPsychTexture) {
                     n++;
+                    // Texture creation still pending? Can't preload it yet:
+                    if (windowRecordArray[i]->textureUploadJob) continue;
                     // Prioritize this texture:
                     glPrioritizeTextures(1, (GLuint*) &(windowRecordArray[i]->textureNumber), &maxprio);
                     // Bind this texture:
@@ -139,6 +165,9 @@ PsychError SCREENPreloadTextures(void)
                 texwin = NULL;
                 if (IsWindowIndex(myhandle)) FindWindowRecord(myhandle, &texwin);
                 if (texwin && texwin->windowType==kPsychTexture) {
+                    texids[i] = (GLuint) texwin->textureNumber;
+                    // Texture creation still pending? Can't preload it yet:
+                    if (texwin->textureUploadJob) continue;
                     // Prioritize this texture:
                     glPrioritizeTextures(1, (GLuint*) &(texwin->textureNumber), &maxprio);
                     // Bind this texture:
@@ -150,7 +179,6 @@ PsychError SCREENPreloadTextures(void)
                     glTexCoord2f(1,1); glVertex2i(11,11);
                     glTexCoord2f(1,0); glVertex2i(11,10);                    
                     glEnd();
-                    texids[i] = (GLuint) texwin->textureNumber;
                 }
                 else {
                     // This handle is invalid or at least no texture handle:
@@ -170,10 +198,8 @@ PsychError SCREENPreloadTextures(void)
         // Wait for prefetch completion:
         glFinish();
         
-        // We don't need these anymore:
-        PsychDestroyVolatileWindowRecordPointerList(windowRecordArray);
-        
         if (failed) {
+            PsychDestroyVolatileWindowRecordPointerList(windowRecordArray);
             PsychErrorExitMsg(PsychError_user, "At least one texture handle in texids-vector was invalid! Aborted.");
         }
         
@@ -181,6 +207,7 @@ PsychError SCREENPreloadTextures(void)
         success = NULL;
         PsychAllocOutDoubleArg(1, FALSE, &success);
         *success = (double) glAreTexturesResident(n, texids, texresident);
+        if (anypending) *success = 0;
         
         // Sync pipe again, just to be safe...
         glFinish();
@@ -191,6 +218,28 @@ PsychError SCREENPreloadTextures(void)
         for (i=0; i<n; i++) {
             residency[i] = (psych_bool) ((*success) ? TRUE : texresident[i]);
         }
+
+        // Textures with pending asynchronous creation are not preloaded:
+        if (anypending) {
+            if (!isArgThere) {
+                n = 0;
+                for (i=0; i<numWindows; i++) {
+                    if (windowRecordArray[i]->windowType==kPsychTexture) {
+                        if (windowRecordArray[i]->textureUploadJob) residency[n] = FALSE;
+                        n++;
+                    }
+                }
+            }
+            else {
+                for (i=0; i<n; i++) {
+                    FindWindowRecord(texhandles[i], &texwin);
+                    if (texwin->textureUploadJob) residency[i] = FALSE;
+                }
+            }
+        }
+
+        // We don't need these anymore:
+        PsychDestroyVolatileWindowRecordPointerList(windowRecordArray);
         
         PsychTestForGLErrors();
         
@@ -51,6 +51,18 @@ static char synopsisString[] =  "Set video capture parameter 'parameterName' on
                                 "may need to be made while a capture device is not yet opened, so no valid 'capturePtr' exists. "
                                 "This setting is only honored on the GStreamer video capture engine.\n"
                                 "'GetFramerate' Returns the nominal capture rate of the capture device.\n"
+                                "'FrameRingSize' Set or query the number of most recently captured frames which are kept in "
+                                "a ring buffer in system memory, for retrieval via 'GetRingFrame'. The default of zero disables "
+                                "the ring. The frames stay mapped as received from GStreamer and are shared without copying by "
+                                "the ring, Screen('GetCapturedImage') and 'GetRingFrame'. Some video sources only have a small "
+                                "pool of buffers, so large rings may stall them. Only supported by the GStreamer capture engine.\n"
+                                "[image, timestamp, frameIndex] = Screen('SetVideoCaptureParameter', capturePtr, 'GetRingFrame' [, age=0]); "
+                                "Returns the frame of the given 'age' from the ring enabled via 'FrameRingSize', with 0 for the most "
+                                "recently captured frame, as a raw image matrix in the same format as with Screen('GetCapturedImage') "
+                                "and 'specialmode' 2, its capture 'timestamp' and its running 'frameIndex'. Returns an empty 'image' and "
+                                "-1 for the other values if there is no such frame. Under Python, 'image' is a read-only NumPy view "
+                                "of the frame without any copy, which keeps the frame alive until it is deleted. Under Matlab and "
+                                "Octave, 'image' is a copy.\n"
                                 "'GetBandwidthUsage' Returns firewire bandwidth used by camera at current settings in "
                                 "so called bandwidth units. "
                                 "The 1394 bus has 4915 bandwidth units available per cycle. Each unit corresponds to "
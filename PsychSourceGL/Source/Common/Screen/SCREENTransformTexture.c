@@ -69,6 +69,9 @@ PsychError SCREENTransformTexture(void)
     if (!PsychIsTexture(sourceRecord))
         PsychErrorExitMsg(PsychError_user, "'sourceTexture' argument must be a handle to a texture or offscreen window.");
 
+    // Wait for completion of asynchronous texture creation, if needed:
+    PsychFinishTextureUpload(sourceRecord);
+
     // Get the window structure for the proxy object.
     PsychAllocInWindowRecordArg(2, TRUE, &proxyRecord);
     if (proxyRecord->windowType != kPsychProxyWindow)
@@ -111,6 +114,8 @@ PsychError SCREENTransformTexture(void)
         if (!PsychIsTexture(sourceRecord2))
             PsychErrorExitMsg(PsychError_user, "'sourceTexture2' argument must be a handle to a texture or offscreen window.");
 
+        PsychFinishTextureUpload(sourceRecord2);
+
         // Transform sourceRecord2 source texture into a normalized, upright texture if it isn't already in
         // that format. We require this standard orientation for simplified shader design.
         if (!(specialFlags & 1))
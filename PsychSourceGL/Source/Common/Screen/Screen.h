@@ -74,6 +74,12 @@
 #include "PsychVideoCaptureSupport.h"
 #include "PsychImagingPipelineSupport.h"
 #include "PsychMovieWritingSupport.h"
+#include "PsychReadbackSupport.h"
+#include "PsychTextureConversion.h"
+#include "PsychTextureUploadSupport.h"
+#include "PsychTexturePool.h"
+#include "PsychVertexStreamSupport.h"
+#include "PsychTextAtlasSupport.h"
 #include "ScreenArguments.h"
 #include "RegisterProject.h"
 #include "WindowHelpers.h"
@@ -186,6 +192,7 @@ PsychError SCREENTextColor(void);
 PsychError SCREENPreference(void);
 PsychError SCREENDrawTexture(void);
 PsychError SCREENMakeTexture(void);
+PsychError SCREENMakeTextureBenchmark(void);
 PsychError SCREENFrameRect(void);
 PsychError SCREENDrawLine(void);
 PsychError SCREENFillPoly(void);
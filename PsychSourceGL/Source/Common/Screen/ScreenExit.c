@@ -43,6 +43,9 @@ PsychError ScreenExitFunction(void)
 	// This is defined in Common/Screen/SCREENFillPoly.c
 	PsychCleanupSCREENFillPoly();
 
+    // Stop worker threads for texture conversion:
+    PsychExitTextureConversion();
+
 	// Release our internal locale object for character <-> unicode conversion:
 	PsychSetUnicodeTextConversionLocale(NULL);
 
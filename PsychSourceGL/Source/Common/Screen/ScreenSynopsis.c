@@ -77,6 +77,7 @@ const char** InitializeSynopsis(void)
     synopsis[i++] = "[windowPtr,rect]=Screen('OpenWindow',windowPtrOrScreenNumber [,color] [,rect] [,pixelSize] [,numberOfBuffers] [,stereomode] [,multisample][,imagingmode][,specialFlags][,clientRect][,fbOverrideRect]);";
     synopsis[i++] = "[windowPtr,rect]=Screen('OpenOffscreenWindow',windowPtrOrScreenNumber [,color] [,rect] [,pixelSize] [,specialFlags] [,multiSample]);";
     synopsis[i++] = "textureIndex=Screen('MakeTexture', WindowIndex, imageMatrix [, optimizeForDrawAngle=0] [, specialFlags=0] [, floatprecision=0] [, textureOrientation=0] [, textureShader=0]);";
+    synopsis[i++] = "results = Screen('MakeTextureBenchmark' [, width=1920][, height=1080][, iterations=10]);";
     synopsis[i++] = "oldParams = Screen('PanelFitter', windowPtr [, newParams]);";
     synopsis[i++] = "Screen('Close', [windowOrTextureIndex or list of textureIndices/offscreenWindowIndices]);";
     synopsis[i++] = "Screen('CloseAll');";
@@ -118,14 +119,14 @@ const char** InitializeSynopsis(void)
 
     // Copy an image, very quickly, between textures and onscreen windows
     synopsis[i++] = "\n% Copy an image, very quickly, between textures, offscreen windows and onscreen windows.";
-    synopsis[i++] = "[resident [texidresident]] = Screen('PreloadTextures', windowPtr [, texids]);";
+    synopsis[i++] = "[resident [texidresident]] = Screen('PreloadTextures', windowPtr [, texids][, dontWait=0]);";
     synopsis[i++] = "Screen('DrawTexture', windowPointer, texturePointer [,sourceRect] [,destinationRect] [,rotationAngle] [, filterMode] [, globalAlpha] [, modulateColor] [, textureShader] [, specialFlags] [, auxParameters]);";
     synopsis[i++] = "Screen('DrawTextures', windowPointer, texturePointer(s) [, sourceRect(s)] [, destinationRect(s)] [, rotationAngle(s)] [, filterMode(s)] [, globalAlpha(s)] [, modulateColor(s)] [, textureShader] [, specialFlags] [, auxParameters]);";
     synopsis[i++] = "Screen('CopyWindow', srcWindowPtr, dstWindowPtr, [srcRect], [dstRect], [copyMode])";
 
     // Copy an image, slowly, between matrices and windows
     synopsis[i++] = "\n% Copy an image, slowly, between matrices and windows :";
-    synopsis[i++] = "imageArray=Screen('GetImage', windowPtr [,rect] [,bufferName] [,floatprecision=0] [,nrchannels=3])";
+    synopsis[i++] = "imageArray=Screen('GetImage', windowPtr [,rect] [,bufferName] [,floatprecision=0] [,nrchannels=3] [,asyncDepth=0])";
     synopsis[i++] = "Screen('PutImage', windowPtr, imageArray [,rect]);";
 
     // Synchronize with the window's screen (on-screen only):
@@ -197,6 +198,7 @@ const char** InitializeSynopsis(void)
     synopsis[i++] =  "timeList= Screen('GetTimelist');";
     synopsis[i++] =  "Screen('ClearTimelist');";
     synopsis[i++] =  "Screen('Preference','DebugMakeTexture', enableDebugging);";
+    synopsis[i++] =  "[enabled, numEvents] = Screen('Trace' [, command, ...]);";
 
     // Movie and multimedia handling functions:
     synopsis[i++] = "\n% Movie and multimedia playback functions:";
@@ -207,8 +209,8 @@ const char** InitializeSynopsis(void)
     synopsis[i++] =  "timeindex = Screen('GetMovieTimeIndex', moviePtr);";
     synopsis[i++] =  "[oldtimeindex] = Screen('SetMovieTimeIndex', moviePtr, timeindex [, indexIsFrames=0]);";
     synopsis[i++] =  "moviePtr = Screen('CreateMovie', windowPtr, movieFile [, width][, height][, frameRate=30][, movieOptions][, numChannels=4][, bitdepth=8]);";
-    synopsis[i++] =  "Screen('FinalizeMovie', moviePtr);";
-    synopsis[i++] =  "Screen('AddFrameToMovie', windowPtr [,rect] [,bufferName] [,moviePtr=0] [,frameduration=1]);";
+    synopsis[i++] =  "[framesWritten, framesDropped, meanLatency, maxLatency] = Screen('FinalizeMovie', moviePtr);";
+    synopsis[i++] =  "Screen('AddFrameToMovie', windowPtr [,rect] [,bufferName] [,moviePtr=0] [,frameduration=1] [,asyncDepth=0]);";
     synopsis[i++] =  "Screen('AddAudioBufferToMovie', moviePtr, audioBuffer);";
 
     // Video capture support:
@@ -13,11 +13,14 @@
 	HISTORY:
 	
 		1/18/05		awi		Wrote it. 
+		10/18/26	agent		Store time samples in a growable array instead of a linked list, and as trace events.
 
 	DESCRIPTION:
 
-		For purposes of instrumenting Screen, maintain times samples in an abstract list type.  Internally we use a 
-		linked list.  To external functions reading out values, the list appears to be an array.
+		For purposes of instrumenting Screen, maintain times samples in an abstract list type.  Internally we use an 
+		array, which grows by doubling its size, so storing a sample costs no allocation most of the time.  To external
+		functions reading out values, the list appears to be an array.  If event tracing via PsychTrace.c is enabled,
+		each sample is also recorded as instant event "StoreNowTime", so it shows up in trace dumps.
 		
 		It is easy to time  Screen subfuntions from MATLAB by surrounding them with calls to GetSecs().  
 
@@ -46,57 +49,34 @@
 
 #include "Psych.h"
 
-
-
-typedef struct _timeArrayElement_{
-	double							timeValue;
-	struct _timeArrayElement_		*next;
-} timeArrayElement;
-
-
-static timeArrayElement		*timeListHead=NULL;
-static timeArrayElement		*timeListTail=NULL;
+static double				*timeList=NULL;
 static unsigned int			numElements=0;
+static unsigned int			numAllocated=0;
 
 
 void StoreNowTime(void)
 {
-	double				now;
-	timeArrayElement	*newElement;
+	double				now, *newList;
 	
 	PsychGetAdjustedPrecisionTimerSeconds(&now);
-	newElement=(timeArrayElement *)malloc(sizeof(timeArrayElement));
-	newElement->timeValue=now;
-	newElement->next=NULL;
-	if(timeListTail != NULL)
-		timeListTail->next=newElement;
-	timeListTail=newElement;
-	if(timeListHead==NULL)
-		timeListHead=newElement;
-	++numElements;
+	if(numElements >= numAllocated){
+		newList=(double *)realloc(timeList, ((numAllocated > 0) ? 2 * numAllocated : 1024) * sizeof(double));
+		if(newList==NULL)
+			return;
+		timeList=newList;
+		numAllocated=(numAllocated > 0) ? 2 * numAllocated : 1024;
+	}
+	timeList[numElements++]=now;
+
+	PsychTraceInstant("Screen", "StoreNowTime", 0);
 }
 
 void ClearTimingArray(void)
 {
-	timeArrayElement	*thisElement, *tempElement;
-	
-	
-	thisElement=timeListHead;
-	while(thisElement!=NULL){
-		if(thisElement->next==NULL){
-			//end of list.  free this element.
-			free(thisElement);
-			thisElement=NULL;
-			timeListHead=NULL;
-			timeListTail=NULL;
-			numElements=0;
-		}else{
-			//step ahead and free the element behind
-			tempElement=thisElement;
-			thisElement=thisElement->next;
-			free(tempElement);
-		}
-	}	
+	free(timeList);
+	timeList=NULL;
+	numElements=0;
+	numAllocated=0;
 }
 
 unsigned int GetNumTimeValues(void)
@@ -112,30 +92,8 @@ unsigned int GetTimeArraySizeBytes(void)
 
 void CopyTimeArray(double *destination, unsigned int numElements)
 {
-	timeArrayElement	*thisElement;
-	unsigned int		i;
-
-	thisElement=timeListHead;
-	for(i=0;i<numElements;i++){
-		if(thisElement==NULL)
-			PsychErrorExitMsg(PsychError_internal, "Attempted to copy out more values than are stored in list");
-		else{
-			destination[i]=thisElement->timeValue;
-			thisElement=thisElement->next;
-		}
-	}
-}
-
-
-
-
-
-
-
-
-
-
-
-
-
+	if(numElements > GetNumTimeValues())
+		PsychErrorExitMsg(PsychError_internal, "Attempted to copy out more values than are stored in list");
 
+	memcpy(destination, timeList, numElements * sizeof(double));
+}
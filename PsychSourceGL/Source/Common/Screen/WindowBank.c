@@ -336,6 +336,22 @@ void PsychCreateWindowRecord(PsychWindowRecordType **winRec)
     (*winRec)->gpuRenderTimeQuery = 0;
     (*winRec)->gpuRenderTime = 0.0;
 
+    // No asynchronous readback ring assigned:
+    (*winRec)->readbackRing = NULL;
+
+    // No asynchronous texture creation in use:
+    (*winRec)->textureUploader = NULL;
+    (*winRec)->textureUploadJob = NULL;
+
+    // No texture pool for recycling of texture storage:
+    (*winRec)->texturePool = NULL;
+
+    // No streaming vertex buffer for batch drawing:
+    (*winRec)->vertexStream = NULL;
+
+    // No glyph atlas for text drawing:
+    (*winRec)->textAtlas = NULL;
+
     // No swap group or barrier assigned:
     (*winRec)->swapGroup = 0;
     (*winRec)->swapBarrier = 0;
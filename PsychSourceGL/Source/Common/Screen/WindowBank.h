@@ -19,6 +19,11 @@
         07/22/05  mk            Removed constants for max number of windows. We resize dynamically now (see WindowBank.c)
         10/11/05  mk            Support for special Quicktime movie textures in .targetSpecific part of PsychWindowRecord added.
         12/27/05  mk            Added new targetSpecific - struct for the Win32 port of PTB.
+        10/18/26  agent         Added readbackRing for asynchronous readback.
+        10/18/26  agent         Added gluploadcontextObject and textureUploader/textureUploadJob for asynchronous texture creation.
+        10/18/26  agent         Added texturePool and texturePoolFormat/texturePoolSize for recycling of texture storage.
+        10/18/26  agent         Added vertexStream for streaming of batch drawing vertices.
+        10/18/26  agent         Added textAtlas for glyph atlas text rendering.
 
     DESCRIPTION:
 
@@ -229,6 +234,7 @@ typedef struct{
     CGLPixelFormatObj   pixelFormatObject;
     CGLContextObj       glusercontextObject;    // OpenGL context for userspace rendering code, e.g., moglcore...
     CGLContextObj       glswapcontextObject;    // OpenGL context for performing doublebuffer swaps in PsychFlipWindowBuffers().
+    CGLContextObj       gluploadcontextObject;  // OpenGL context for asynchronous texture uploads in PsychTextureUploadSupport.c.
     void*               deviceContext;          // Pointer to an AGLContext object, or a NULL-pointer.
     // NSWindow* type stored in void* to avoid "Cocoa/Objective-C pollution" in this header file.
     void*               windowHandle;           // Handle for Cocoa window when using windowed mode. (NULL in non-windowed mode).
@@ -249,6 +255,7 @@ typedef struct{
     PIXELFORMATDESCRIPTOR     pixelFormatObject;      // The context's pixel format object.
     HGLRC                     glusercontextObject;    // OpenGL context for userspace rendering code, e.g., moglcore...
     HGLRC                     glswapcontextObject;    // OpenGL context for performing doublebuffer swaps in PsychFlipWindowBuffers().
+    HGLRC                     gluploadcontextObject;  // OpenGL context for asynchronous texture uploads in PsychTextureUploadSupport.c.
 } PsychTargetSpecificWindowRecordType;
 #endif
 
@@ -272,6 +279,7 @@ typedef struct {
     struct wl_surface*        xwindowHandle;                  // Associated Wayland "window", if any.
     struct waffle_context*    glusercontextObject;            // OpenGL context for userspace rendering code, e.g., moglcore...
     struct waffle_context*    glswapcontextObject;            // OpenGL context for performing doublebuffer swaps in PsychFlipWindowBuffers().
+    struct waffle_context*    gluploadcontextObject;          // OpenGL context for asynchronous texture uploads in PsychTextureUploadSupport.c.
     struct wl_list            presentation_feedback_list;     // Used for Wayland backend presentation_feedback extension to queue feedback events.
 } PsychTargetSpecificWindowRecordType;
 #else
@@ -285,6 +293,7 @@ typedef struct {
     Window                    xwindowHandle;                  // Associated X-Window if any.
     struct waffle_context*    glusercontextObject;            // OpenGL context for userspace rendering code, e.g., moglcore...
     struct waffle_context*    glswapcontextObject;            // OpenGL context for performing doublebuffer swaps in PsychFlipWindowBuffers().
+    struct waffle_context*    gluploadcontextObject;          // OpenGL context for asynchronous texture uploads in PsychTextureUploadSupport.c.
 #ifdef PTB_USE_WAYLAND_PRESENT
     struct wl_list            presentation_feedback_list;     // Used for Wayland backend presentation_feedback extension to queue feedback events.
 #endif
@@ -302,6 +311,7 @@ typedef struct{
     Window            xwindowHandle;       // Associated X-Window if any.
     GLXContext        glusercontextObject; // OpenGL context for userspace rendering code, e.g., moglcore...
     GLXContext        glswapcontextObject; // OpenGL context for performing doublebuffer swaps in PsychFlipWindowBuffers().
+    GLXContext        gluploadcontextObject; // OpenGL context for asynchronous texture uploads in PsychTextureUploadSupport.c.
 } PsychTargetSpecificWindowRecordType;
 #endif
 
@@ -313,6 +323,22 @@ typedef struct{
 
 typedef struct _PsychWindowRecordType_ *PsychWindowRecordPntrType;
 
+// Ring of pixel pack buffers for asynchronous readback, opaque outside of PsychReadbackSupport.c:
+typedef struct PsychReadbackRing PsychReadbackRing;
+
+// Texture upload thread and its jobs for asynchronous texture creation, opaque outside of PsychTextureUploadSupport.c:
+typedef struct PsychTextureUploader PsychTextureUploader;
+typedef struct PsychTextureUploadJob PsychTextureUploadJob;
+
+// Pool of released textures for recycling of their storage, opaque outside of PsychTexturePool.c:
+typedef struct PsychTexturePool PsychTexturePool;
+
+// Streaming vertex buffer for batch drawing, opaque outside of PsychVertexStreamSupport.c:
+typedef struct PsychVertexStream PsychVertexStream;
+
+// Glyph atlas and shaped string cache for text drawing, opaque outside of PsychTextAtlasSupport.c:
+typedef struct PsychTextAtlas PsychTextAtlas;
+
 //typedefs for the window bank.  We use the same structure for both windows and textures.
 typedef struct _PsychWindowRecordType_{
 
@@ -361,6 +387,8 @@ typedef struct _PsychWindowRecordType_{
     GLint                       textureFilterShader;    // Optional GLSL program handle for a shader to apply during PsychBlitTextureToDisplay().
     GLint                       textureLookupShader;    // Optional GLSL handle for nearest neighbour texture drawing shader.
     GLint                       textureByteAligned;     // 0 = No knowledge about byte alignment of texture data. > 1, texture rows are x byte aligned.
+    GLint                       texturePoolFormat;      // Internal format of storage allocated by PsychCreateTexture(), if it can be recycled via the texture pool. 0 otherwise.
+    int                         texturePoolSize[2];     // Width and height of that storage.
     GLint                       texturePlanarShader[4]; // Optional GLSL program handles for shaders to apply to planar storage textures - 4 handles for 4 possible channel counts.
     GLint                       textureI420PlanarShader; // Optional GLSL program handle for shader to convert a YUV-I420 planar texture into a standard RGBA8 texture.
     GLint                       textureI800PlanarShader; // Optional GLSL program handle for shader to convert a Y8-I800 planar texture into a standard RGBA8 texture.
@@ -405,6 +433,12 @@ typedef struct _PsychWindowRecordType_{
     double                      osbuiltin_swaptime;     // Optional timestamp of swap completion computed via PsychOSGetSwapCompletionTimestamp();
     double                      gpuRenderTime;          // GPU time spent on rendering. Only returned if a query object is successfully generated.
     GLuint                      gpuRenderTimeQuery;     // Handle to the GPU time query object. 0 if none assigned.
+    PsychReadbackRing*          readbackRing;           // Ring of pixel pack buffers for async 'GetImage' / 'AddFrameToMovie'. NULL if none.
+    PsychTextureUploader*       textureUploader;        // Texture upload thread of onscreen window for async 'MakeTexture'. NULL if none.
+    PsychTextureUploadJob*      textureUploadJob;       // Pending asynchronous upload of texture content. NULL if none.
+    PsychTexturePool*           texturePool;            // Pool of released textures of onscreen window for recycling. NULL if none.
+    PsychVertexStream*          vertexStream;           // Streaming vertex buffer of onscreen window for batch drawing. NULL if none.
+    PsychTextAtlas*             textAtlas;              // Glyph atlas of onscreen window for text drawing. NULL if none.
     psych_int64                 reference_ust;          // UST reference timestamp of vblank with count reference_msc from OpenML. (Optional)
     psych_int64                 reference_msc;          // MSC reference vblank count from OpenML. (Optional)
     psych_int64                 reference_sbc;          // SBC reference swapbuffers count from OpenML. (Optional)
@@ -34,6 +34,9 @@ PsychError PsychModuleInit(void)
     PsychErrorExit(PsychRegister("UntilTime", &WAITSECSWaitUntilSecs));
     PsychErrorExit(PsychRegister("YieldSecs", &WAITSECSYieldSecs));
 
+    // Statistics of precise waits:
+    PsychErrorExit(PsychRegister("Statistics", &WAITSECSStatistics));
+
     // Report the version
     PsychErrorExit(PsychRegister("Version", &MODULEVersion));
 
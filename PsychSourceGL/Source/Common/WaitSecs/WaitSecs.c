@@ -16,6 +16,7 @@
 		4/6/05			awi		Use mach_wait_until() instead of looping.  Mario's suggestion.  
 		4/7/05			awi		Relocate mach_wait_until() call within PsychWaitIntervalSeconds().
 		1/2/08			mk		Add subfunction for waiting until absolute time, and return of wakeup time. 
+		10/18/26		agent		Add subfunction for returning wait statistics. 
 		
 
 	NOTES: 
@@ -53,6 +54,7 @@ const char** InitializeSynopsis(void)
     synopsis[i++] = "[realWakeupTimeSecs] = WaitSecs(waitPeriodSecs);              -- Wait for at least 'waitPeriodSecs' seconds. Try to be precise.";
     synopsis[i++] = "[realWakeupTimeSecs] = WaitSecs('UntilTime', whenSecs);       -- Wait until at least time 'whenSecs'.";
     synopsis[i++] = "[realWakeupTimeSecs] = WaitSecs('YieldSecs', waitPeriodSecs); -- Wait for at least 'waitPeriodSecs' seconds. Be more sloppy.";
+    synopsis[i++] = "stats = WaitSecs('Statistics' [, reset=0]);                 -- Return statistics about waits of calling thread. Linux only.";
     synopsis[i++] = "\nThe optional 'realWakeupTimeSecs' is the real system time when WaitSecs finished waiting,";
     synopsis[i++] = "just as if you'd call realWakeupTimeSecs = GetSecs; after calling WaitSecs. This for your";
     synopsis[i++] = "convenience and to reduce call overhead and drift a bit for this common combo of commands.";
@@ -86,8 +88,10 @@ PsychError WAITSECSWaitSecs(void)
         return(PsychError_none);
     }
 
-    // Wait for requested interval:
+    // Wait for requested interval, letting other script threads run:
+    PsychBeginBlockingRegion();
     PsychWaitIntervalSeconds(waitPeriodSecs);
+    PsychEndBlockingRegion();
 
     // Return current system time at end of sleep:
     PsychGetAdjustedPrecisionTimerSeconds(&now);
@@ -130,7 +134,9 @@ PsychError WAITSECSWaitUntilSecs(void)
     PsychErrorExit(PsychCapNumInputArgs(1));
     
     PsychCopyInDoubleArg(1,TRUE,&waitUntilSecs);
+    PsychBeginBlockingRegion();
     PsychWaitUntilSeconds(waitUntilSecs);
+    PsychEndBlockingRegion();
 
     // Return current system time at end of sleep:
     PsychGetAdjustedPrecisionTimerSeconds(&now);
@@ -166,7 +172,9 @@ PsychError WAITSECSYieldSecs(void)
     PsychErrorExit(PsychCapNumInputArgs(1));
     
     PsychCopyInDoubleArg(1,TRUE,&waitPeriodSecs);
+    PsychBeginBlockingRegion();
     PsychYieldIntervalSeconds(waitPeriodSecs);
+    PsychEndBlockingRegion();
 
     // Return current system time at end of sleep:
     PsychGetAdjustedPrecisionTimerSeconds(&now);
@@ -174,3 +182,75 @@ PsychError WAITSECSYieldSecs(void)
 
     return(PsychError_none);	
 }
+
+PsychError WAITSECSStatistics(void)
+{
+    static char useString[] = "stats = WaitSecs('Statistics' [, reset=0]);";
+    //                         1                              1
+    static char synopsisString[] =
+    "Return statistics about the timed waits of WaitSecs and WaitSecs('UntilTime') in struct 'stats'.\n"
+    "Precise waits sleep until shortly before the deadline, then busy-wait until the deadline. How much "
+    "before the deadline the sleep ends, the 'threshold', gets calibrated by measuring the wakeup latency "
+    "of the operating system after each sleep. This is done separately for normal and realtime scheduling, "
+    "and separately for each thread, so the statistics are also for the calling thread only.\n"
+    "If the optional 'reset' is 1, then the statistics are reset to zero after returning them.\n"
+    "The struct contains the following fields:\n"
+    "'numWaits' Number of waits for a deadline which wasn't already reached at time of call.\n"
+    "'numSleeps' Number of waits which slept before busy-waiting.\n"
+    "'numMisses' Number of waits which ended more than 0.1 msecs after their deadline.\n"
+    "'meanLatenessSecs' Mean time of wakeup after the deadline.\n"
+    "'maxLatenessSecs' Maximum time of wakeup after the deadline.\n"
+    "'spinSecs' Total time spent busy-waiting, using the cpu.\n"
+    "'thresholdSecs' Current busy-wait threshold for the current scheduling class of the thread.\n"
+    "'wakeupLatencySecs' Median wakeup latency after the recent sleeps.\n"
+    "'realtime' 1 if the thread uses realtime scheduling, 0 otherwise.\n"
+    "'timerfd' 1 if sleeps use a timerfd, as selected by setting environment variable PSYCH_WAITSECS_TIMERFD=1 "
+    "before startup, 0 if they use clock_nanosleep().\n"
+    "'fifoPriority' If non-zero, normal threads get switched to realtime SCHED_FIFO scheduling with this "
+    "priority for the duration of each wait, as selected by the environment variable PSYCH_WAITSECS_SCHEDFIFO "
+    "before startup.\n"
+    "This function is only supported on Linux.\n";
+    static char seeAlsoString[] = "UntilTime";
+
+    const char *FieldNames[] = { "numWaits", "numSleeps", "numMisses", "meanLatenessSecs", "maxLatenessSecs", "spinSecs",
+                                 "thresholdSecs", "wakeupLatencySecs", "realtime", "timerfd", "fifoPriority" };
+    PsychGenericScriptType *stats;
+    int reset = 0;
+
+    // All sub functions should have these two lines:
+    PsychPushHelp(useString, synopsisString, seeAlsoString);
+    if (PsychIsGiveHelp()) { PsychGiveHelp(); return(PsychError_none); };
+
+    // Check to see if the user supplied superfluous arguments
+    PsychErrorExit(PsychCapNumOutputArgs(1));
+    PsychErrorExit(PsychCapNumInputArgs(1));
+
+    PsychCopyInIntegerArg(1, kPsychArgOptional, &reset);
+
+    #if PSYCH_SYSTEM == PSYCH_LINUX
+    {
+        PsychWaitStatistics ws;
+
+        PsychOSGetWaitStatistics(&ws, (reset) ? TRUE : FALSE);
+
+        PsychAllocOutStructArray(1, kPsychArgOptional, -1, 11, FieldNames, &stats);
+        PsychSetStructArrayDoubleElement("numWaits", 0, (double) ws.numWaits, stats);
+        PsychSetStructArrayDoubleElement("numSleeps", 0, (double) ws.numSleeps, stats);
+        PsychSetStructArrayDoubleElement("numMisses", 0, (double) ws.numMisses, stats);
+        PsychSetStructArrayDoubleElement("meanLatenessSecs", 0, (ws.numWaits > 0) ? ws.latenessSecs / (double) ws.numWaits : 0, stats);
+        PsychSetStructArrayDoubleElement("maxLatenessSecs", 0, ws.maxLatenessSecs, stats);
+        PsychSetStructArrayDoubleElement("spinSecs", 0, ws.spinSecs, stats);
+        PsychSetStructArrayDoubleElement("thresholdSecs", 0, ws.thresholdSecs, stats);
+        PsychSetStructArrayDoubleElement("wakeupLatencySecs", 0, ws.wakeupLatencySecs, stats);
+        PsychSetStructArrayDoubleElement("realtime", 0, (double) ws.realtime, stats);
+        PsychSetStructArrayDoubleElement("timerfd", 0, (double) ws.timerfd, stats);
+        PsychSetStructArrayDoubleElement("fifoPriority", 0, (double) ws.fifoPriority, stats);
+    }
+    #else
+        (void) FieldNames;
+        (void) stats;
+        PsychErrorExitMsg(PsychError_unimplemented, "WaitSecs('Statistics') is only supported on Linux.");
+    #endif
+
+    return(PsychError_none);
+}
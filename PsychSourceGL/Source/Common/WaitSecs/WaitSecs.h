@@ -25,6 +25,7 @@ PsychError MODULEVersion(void);         //MODULEVersion.c
 PsychError WAITSECSWaitSecs(void);
 PsychError WAITSECSWaitUntilSecs(void);
 PsychError WAITSECSYieldSecs(void);
+PsychError WAITSECSStatistics(void);
 
 //end include once
 #endif
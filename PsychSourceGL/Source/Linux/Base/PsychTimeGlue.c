@@ -13,6 +13,8 @@
  *
  *    2/20/06       mk        Wrote it. Derived from Windows version.
  *    1/03/09       mk        Add generic Mutex locking support as service to ptb modules. Add PsychYieldIntervalSeconds().
+ *    18/10/26      agent     Add selectable GetSecs timebase, CLOCK_MONOTONIC based by default.
+ *    18/10/26      agent     Precision wait engine with per-thread and per scheduling class calibration.
  *
  *    DESCRIPTION:
  *
@@ -25,6 +27,8 @@
 #include <time.h>
 #include <errno.h>
 #include <sched.h>
+#include <unistd.h>
+#include <sys/timerfd.h>
 
 // utsname for uname() so we can find out on which kernel we're running:
 #include <sys/utsname.h>
@@ -40,16 +44,371 @@ static double       precisionTimerAdjustmentFactor = 1;
 static double       estimatedGetSecsValueAtTickCountZero;
 static psych_bool   isKernelTimebaseFrequencyHzInitialized = FALSE;
 static double       kernelTimebaseFrequencyHz;
-static double       sleepwait_threshold = 0.001;
 static double       clockinc = 0;
 
+// GetSecs timebase: Selected once at first use, via environment variable PSYCH_GETSECS_TIMEBASE.
+// For the CLOCK_MONOTONIC(_RAW) based timebases, timebaseOffsetSecs/Nsecs is the constant offset
+// which maps the clock to the legacy gettimeofday() epoch of seconds since 1.1.1970. It is measured
+// by the first module which initializes its timebase and then shared with all other modules in the
+// process via environment variable PSYCH_GETSECS_TIMEBASEOFFSET, so all modules agree on GetSecs time:
+static psych_bool   timebaseInitialized = FALSE;
+static int          timebaseMode = kPsychTimebaseMonotonic;
+static clockid_t    timebaseClock = CLOCK_MONOTONIC;
+static time_t       timebaseOffsetSecs = 0;
+static long         timebaseOffsetNsecs = 0;
+static const char*  timebaseNames[] = { "gettimeofday", "realtime", "monotonic", "monotonicraw" };
+
+// Precision wait engine: PsychWaitUntilSeconds() sleeps until 'threshold' seconds before the deadline,
+// then busy-waits the rest. How early it needs to wake up depends on the wake-up latency of the OS, which
+// differs between threads and between scheduling classes, e.g., SCHED_OTHER threads have a default timer
+// slack of 50 usecs and compete with other processes, whereas realtime SCHED_FIFO/RR threads don't. Each
+// thread therefore calibrates its own 'threshold' separately for normal and realtime scheduling, from the
+// measured wake-up latency of its sleeps, and keeps its own deadline-miss statistics. Thread-local, so our
+// audio, IOPort reader and trigger threads and the main thread don't need locking and don't disturb each
+// others calibration:
+#define kPsychWaitLatencySamples 32
+
+typedef struct PsychWaitCalibration {
+    double          threshold;      // Busy-wait margin before deadline in seconds.
+    double          initial;        // Initial busy-wait margin, until there are enough latency samples.
+    double          penalty;        // Extra margin after deadline misses. Decays after hits.
+    double          latency[kPsychWaitLatencySamples]; // Ringbuffer with wake-up latencies of the most recent sleeps.
+    unsigned int    numSamples;     // Number of latency samples so far.
+    unsigned int    missedCount;    // Number of consecutive deadline misses.
+    unsigned int    skippedCount;   // Number of waits without sleep due to high threshold.
+} PsychWaitCalibration;
+
+typedef struct PsychWaitEngine {
+    psych_bool              initialized;
+    int                     timerfd;        // timerfd to sleep on, or -1 for clock_nanosleep().
+    int                     fifoPriority;   // SCHED_FIFO priority for boost during waits, or 0 for no boost.
+    PsychWaitCalibration    calibration[2]; // Calibration for normal [0] and realtime [1] scheduling.
+    PsychWaitStatistics     stats;
+    struct PsychWaitEngine* next;           // Next engine in list of all engines with a timerfd.
+} PsychWaitEngine;
+
+static __thread PsychWaitEngine waitEngine;
+
+// Process wide options, selected via environment variables PSYCH_WAITSECS_TIMERFD and PSYCH_WAITSECS_SCHEDFIFO:
+static psych_bool       waitUseTimerfd = FALSE;
+static int              waitFifoPriority = 0;
+static pthread_key_t    waitEngineKey;
+static psych_bool       waitEngineKeyValid = FALSE;
+
+// List of the wait engines of all threads which have a timerfd, so the timerfd's of threads which
+// are still alive can be closed at module shutdown:
+static pthread_mutex_t  waitEngineListMutex = PTHREAD_MUTEX_INITIALIZER;
+static PsychWaitEngine* waitEngineList = NULL;
+
+// Convert timespec to seconds:
+static double PsychTimespecToSeconds(const struct timespec* ts)
+{
+    return((double) ts->tv_sec + ((double) ts->tv_nsec / 1e9));
+}
+
+// Convert seconds to timespec:
+static void PsychSecondsToTimespec(double secs, struct timespec* ts)
+{
+    ts->tv_sec  = (time_t) secs;
+    ts->tv_nsec = (long) ((secs - (double) ts->tv_sec) * 1e9);
+}
+
+// Select GetSecs timebase and compute its offset to the legacy gettimeofday() epoch:
+static void PsychInitTimebase(void)
+{
+    struct timespec tMono, tReal, tMono2;
+    char *env, offsetString[64];
+    psych_int64 offset, spread, bestSpread = -1;
+    int mode, i;
+
+    timebaseInitialized = TRUE;
+
+    // Select timebase, default to CLOCK_MONOTONIC:
+    timebaseMode = kPsychTimebaseMonotonic;
+    if ((env = getenv("PSYCH_GETSECS_TIMEBASE"))) {
+        for (mode = 0; mode <= kPsychTimebaseMonotonicRaw; mode++)
+            if (!strcmp(env, timebaseNames[mode]))
+                break;
+
+        if (mode <= kPsychTimebaseMonotonicRaw)
+            timebaseMode = mode;
+        else
+            printf("PTB-WARNING: Unknown GetSecs timebase '%s' requested via PSYCH_GETSECS_TIMEBASE! Using '%s' instead.\n",
+                   env, timebaseNames[timebaseMode]);
+    }
+
+    switch (timebaseMode) {
+        case kPsychTimebaseGettimeofday:
+        case kPsychTimebaseRealtime:
+            timebaseClock = CLOCK_REALTIME;
+            return;
+
+        case kPsychTimebaseMonotonic:
+            timebaseClock = CLOCK_MONOTONIC;
+            break;
+
+        case kPsychTimebaseMonotonicRaw:
+            timebaseClock = CLOCK_MONOTONIC_RAW;
+            break;
+    }
+
+    // Reuse offset for this timebase from other modules in this process, if any:
+    if ((env = getenv("PSYCH_GETSECS_TIMEBASEOFFSET")) && (sscanf(env, "%i:%lli:%li", &mode, (long long*) &timebaseOffsetSecs, &timebaseOffsetNsecs) == 3) &&
+        (mode == timebaseMode))
+        return;
+
+    // Measure offset between CLOCK_REALTIME and our clock, take the tightest of multiple measurements:
+    for (i = 0; i < 10; i++) {
+        clock_gettime(timebaseClock, &tMono);
+        clock_gettime(CLOCK_REALTIME, &tReal);
+        clock_gettime(timebaseClock, &tMono2);
+
+        spread = ((psych_int64) (tMono2.tv_sec - tMono.tv_sec) * 1000000000LL) + (psych_int64) (tMono2.tv_nsec - tMono.tv_nsec);
+        if ((bestSpread < 0) || (spread < bestSpread)) {
+            bestSpread = spread;
+
+            // Offset in integer nanoseconds, relative to the midpoint of both clock queries:
+            offset = ((psych_int64) (tReal.tv_sec - tMono.tv_sec) * 1000000000LL) + (psych_int64) (tReal.tv_nsec - tMono.tv_nsec) - spread / 2;
+            timebaseOffsetSecs = (time_t) (offset / 1000000000LL);
+            timebaseOffsetNsecs = (long) (offset % 1000000000LL);
+            if (timebaseOffsetNsecs < 0) {
+                timebaseOffsetSecs--;
+                timebaseOffsetNsecs += 1000000000L;
+            }
+        }
+    }
+
+    // Publish offset for other modules:
+    snprintf(offsetString, sizeof(offsetString), "%i:%lli:%li", timebaseMode, (long long) timebaseOffsetSecs, timebaseOffsetNsecs);
+    setenv("PSYCH_GETSECS_TIMEBASEOFFSET", offsetString, 1);
+}
+
+// Return GetSecs timebase mode and name, the offset of the timebase clock to GetSecs time, and its resolution:
+int PsychOSGetTimebase(const char** name, double* offset, double* resolution)
+{
+    struct timespec res;
+
+    if (!timebaseInitialized)
+        PsychInitTimebase();
+
+    if (resolution) {
+        clock_getres(timebaseClock, &res);
+        *resolution = PsychTimespecToSeconds(&res);
+        if ((timebaseMode == kPsychTimebaseGettimeofday) && (*resolution < 0.000001))
+            *resolution = 0.000001;
+    }
+
+    if (name)
+        *name = timebaseNames[timebaseMode];
+
+    if (offset)
+        *offset = (double) timebaseOffsetSecs + (double) timebaseOffsetNsecs / 1e9;
+
+    return(timebaseMode);
+}
+
+// Close timerfd of wait engine 'engine' and remove it from the engine list. Caller must hold waitEngineListMutex:
+static void PsychCloseWaitEngineTimerfd(PsychWaitEngine* engine)
+{
+    PsychWaitEngine** link;
+
+    for (link = &waitEngineList; *link; link = &((*link)->next)) {
+        if (*link == engine) {
+            *link = engine->next;
+            break;
+        }
+    }
+
+    if (engine->timerfd >= 0)
+        close(engine->timerfd);
+
+    engine->timerfd = -1;
+    engine->next = NULL;
+}
+
+// Destructor for the wait engine of an exiting thread: Close its timerfd:
+static void PsychWaitEngineThreadExit(void* arg)
+{
+    pthread_mutex_lock(&waitEngineListMutex);
+    PsychCloseWaitEngineTimerfd((PsychWaitEngine*) arg);
+    pthread_mutex_unlock(&waitEngineListMutex);
+}
+
+// Read the process wide wait engine options from the environment, once at module init time:
+static void PsychInitWaitEngineOptions(void)
+{
+    char* env;
+
+    waitUseTimerfd = ((env = getenv("PSYCH_WAITSECS_TIMERFD")) && (atoi(env) > 0)) ? TRUE : FALSE;
+
+    waitFifoPriority = ((env = getenv("PSYCH_WAITSECS_SCHEDFIFO"))) ? atoi(env) : 0;
+    if (waitFifoPriority < 0) waitFifoPriority = 0;
+    if (waitFifoPriority > 99) waitFifoPriority = 99;
+
+    // The key is only used to close timerfd's of exiting threads:
+    if (waitUseTimerfd && !waitEngineKeyValid && !pthread_key_create(&waitEngineKey, PsychWaitEngineThreadExit))
+        waitEngineKeyValid = TRUE;
+}
+
+// Initialize the wait engine of the calling thread at its first wait:
+static void PsychInitWaitEngine(PsychWaitEngine* engine)
+{
+    double threshold;
+    int i;
+
+    memset(engine, 0, sizeof(*engine));
+    engine->timerfd = -1;
+    engine->fifoPriority = waitFifoPriority;
+
+    if (waitUseTimerfd && waitEngineKeyValid) {
+        engine->timerfd = timerfd_create(CLOCK_MONOTONIC, TFD_CLOEXEC);
+        if (engine->timerfd < 0)
+            printf("PTB-WARNING: Could not create timerfd for precise waits [%s]. Using clock_nanosleep() instead.\n", strerror(errno));
+        else {
+            pthread_mutex_lock(&waitEngineListMutex);
+            engine->next = waitEngineList;
+            waitEngineList = engine;
+            pthread_mutex_unlock(&waitEngineListMutex);
+            pthread_setspecific(waitEngineKey, (void*) engine);
+        }
+    }
+
+    // The busy-wait threshold should be significantly higher than the granularity of
+    // the underlying system clock, say 100x the resolution, but no higher than 10 msecs.
+    // We start with optimistic 250 microseconds, then let calibration take over:
+    threshold = 0.00025;
+    if (threshold < 100 * clockinc) threshold = 100 * clockinc;
+    if (threshold > 0.010) threshold = 0.010;
+
+    for (i = 0; i < 2; i++)
+        engine->calibration[i].threshold = engine->calibration[i].initial = threshold;
+
+    engine->initialized = TRUE;
+}
+
+// Return wait engine of calling thread, and its calibration for the current scheduling class of the thread:
+static PsychWaitEngine* PsychGetWaitEngine(PsychWaitCalibration** calibration)
+{
+    PsychWaitEngine* engine = &waitEngine;
+    int policy;
+
+    if (!engine->initialized)
+        PsychInitWaitEngine(engine);
+
+    if (calibration) {
+        policy = sched_getscheduler(0);
+        *calibration = &engine->calibration[((policy == SCHED_FIFO) || (policy == SCHED_RR) || engine->fifoPriority) ? 1 : 0];
+    }
+
+    return(engine);
+}
+
+// Sort the latency samples of calibration 'cal' into 'sorted', return number of samples:
+static int PsychSortWaitLatencies(PsychWaitCalibration* cal, double* sorted)
+{
+    int i, j, n;
+    double v;
+
+    n = (cal->numSamples < kPsychWaitLatencySamples) ? (int) cal->numSamples : kPsychWaitLatencySamples;
+    for (i = 0; i < n; i++) {
+        v = cal->latency[i];
+        for (j = i; (j > 0) && (sorted[j - 1] > v); j--)
+            sorted[j] = sorted[j - 1];
+        sorted[j] = v;
+    }
+
+    return(n);
+}
+
+// Update calibration with wake-up latency 'latency' of the last sleep, if 'latency' >= 0, and compute the new busy-wait threshold:
+static void PsychCalibrateWaitEngine(PsychWaitCalibration* cal, double latency)
+{
+    double sorted[kPsychWaitLatencySamples];
+    double threshold, minthreshold;
+    int n;
+
+    if (latency >= 0)
+        cal->latency[cal->numSamples++ % kPsychWaitLatencySamples] = latency;
+
+    // Wake-up latencies are heavy tailed, with rare outliers of multiple msecs, so use the 2nd largest of the
+    // recent samples, approximately the 97th percentile, instead of something sensitive to single outliers,
+    // plus the penalty for recent deadline misses. But no lower than 20 microseconds, or 20x the clock
+    // resolution, and no higher than 10 msecs:
+    n = PsychSortWaitLatencies(cal, sorted);
+    threshold = (n < kPsychWaitLatencySamples / 2) ? cal->initial : sorted[n - 1 - n / kPsychWaitLatencySamples];
+    threshold += cal->penalty;
+    minthreshold = (20 * clockinc > 0.00002) ? 20 * clockinc : 0.00002;
+    if (threshold < minthreshold) threshold = minthreshold;
+    if (threshold > 0.010) threshold = 0.010;
+    cal->threshold = threshold;
+}
+
+// Age out the largest latency sample of calibration 'cal', by replacing it with the median, then recompute the threshold:
+static void PsychAgeWaitLatencies(PsychWaitCalibration* cal)
+{
+    double sorted[kPsychWaitLatencySamples];
+    int i, imax, n;
+
+    n = PsychSortWaitLatencies(cal, sorted);
+    if (n < kPsychWaitLatencySamples / 2)
+        return;
+
+    for (i = 1, imax = 0; i < n; i++)
+        if (cal->latency[i] > cal->latency[imax])
+            imax = i;
+
+    cal->latency[imax] = sorted[n / 2];
+    PsychCalibrateWaitEngine(cal, -1);
+}
+
+// Compute absolute CLOCK_MONOTONIC deadline for GetSecs time 'targettime', given current GetSecs time 'now':
+static void PsychTimebaseToMonotonicDeadline(double targettime, double now, struct timespec* deadline)
+{
+    struct timespec ts;
+
+    if (timebaseMode == kPsychTimebaseMonotonic) {
+        // Our timebase is CLOCK_MONOTONIC, so the mapping is exact:
+        PsychSecondsToTimespec(targettime - ((double) timebaseOffsetSecs + (double) timebaseOffsetNsecs / 1e9), deadline);
+    }
+    else {
+        // Other timebase: Map the remaining interval onto CLOCK_MONOTONIC. This way, sleeps restarted
+        // after interruption by a signal are drift-free, and steps of system time don't stretch the sleep:
+        clock_gettime(CLOCK_MONOTONIC, &ts);
+        PsychSecondsToTimespec(PsychTimespecToSeconds(&ts) + (targettime - now), deadline);
+    }
+}
+
+// Sleep until absolute CLOCK_MONOTONIC 'deadline'. Returns zero on success, or an errno error code:
+static int PsychSleepUntilMonotonicDeadline(PsychWaitEngine* engine, const struct timespec* deadline)
+{
+    struct itimerspec its;
+    psych_uint64 expirations;
+
+    if (engine->timerfd < 0)
+        return(clock_nanosleep(CLOCK_MONOTONIC, TIMER_ABSTIME, deadline, NULL));
+
+    memset(&its, 0, sizeof(its));
+    its.it_value = *deadline;
+    if (timerfd_settime(engine->timerfd, TFD_TIMER_ABSTIME, &its, NULL))
+        return(errno);
+
+    if (read(engine->timerfd, &expirations, sizeof(expirations)) < 0)
+        return(errno);
+
+    return(0);
+}
+
 void PsychWaitUntilSeconds(double whenSecs)
 {
-    struct timespec rqtp;
-    double targettime;
-    static unsigned int missed_count=0;
-    double now=0.0;
-    int rc;
+    PsychWaitEngine* engine;
+    PsychWaitCalibration* cal;
+    struct sched_param sp, oldsp;
+    struct timespec deadline;
+    double targettime, spinstart, lateness;
+    double now = 0.0;
+    int oldpolicy = SCHED_OTHER;
+    psych_bool boosted = FALSE;
+    int rc = 0, fifoError = 0;
 
     // Get current time:
     PsychGetPrecisionTimerSeconds(&now);
@@ -57,73 +416,136 @@ void PsychWaitUntilSeconds(double whenSecs)
     // If the deadline has already passed, we do nothing and return immediately:
     if (now >= whenSecs) return;
 
-    // Waiting stage 1: If we have more than sleepwait_threshold seconds left
-    // until the deadline, we call the OS usleep() function, so the
-    // CPU gets released for (difference - sleepwait_threshold) seconds to other processes and threads.
+    // Get wait engine of calling thread, and its calibration for the threads scheduling class:
+    engine = PsychGetWaitEngine(&cal);
+    engine->stats.numWaits++;
+
+    // Optional boost to SCHED_FIFO realtime scheduling for the duration of the wait, if the thread isn't
+    // realtime scheduled already. This avoids delays of wakeup by other threads and processes, and the
+    // timer slack of normal threads, at the expense of two extra syscalls:
+    if (engine->fifoPriority && !pthread_getschedparam(pthread_self(), &oldpolicy, &oldsp) && (oldpolicy != SCHED_FIFO) && (oldpolicy != SCHED_RR)) {
+        sp.sched_priority = engine->fifoPriority;
+        if ((fifoError = pthread_setschedparam(pthread_self(), SCHED_FIFO, &sp))) {
+            // Warning is printed after the wait, so printing doesn't delay it:
+            engine->fifoPriority = 0;
+            cal = &engine->calibration[0];
+        }
+        else {
+            boosted = TRUE;
+        }
+    }
+
+    // Waiting stage 1: If we have more than 'threshold' seconds left until the deadline, we sleep,
+    // so the CPU gets released to other processes and threads for (difference - threshold) seconds.
     // -> Good for general system behaviour and for lowered power-consumption (longer battery runtime for
     // Laptops) as the CPU can go idle if nothing else to do...
 
-    // Set an absolute deadline of whenSecs - sleepwait_threshold. We busy-wait the last few microseconds
+    // Set an absolute deadline of whenSecs - threshold. We busy-wait the last few microseconds
     // to take scheduling jitter/delays gracefully into account:
-    targettime    = whenSecs - sleepwait_threshold;
-
-    // Convert targettime to timespec for the Posix clock functions:
-    rqtp.tv_sec   = (unsigned long long) targettime;
-    rqtp.tv_nsec  = ((targettime - (double) rqtp.tv_sec) * (double) 1e9);
-
-    // Use clock_nanosleep() to high-res sleep until targettime, repeat if that gets
-    // prematurely interrupted for whatever reason...
-    while (now < targettime) {
-        // MK: Oldstyle - obsolete: usleep((unsigned long)((whenSecs - now - sleepwait_threshold) * 1000000.0f));
-
-        // Starting in 2008, we use high-precision/high-resolution POSIX realtime timers for precise waiting:
-        // Call clock_nanosleep, use the realtime wall clock instead of the monotonic clock -- monotonic would
-        // by theoretically a bit better as NTP time adjustments couldn't mess with our sleep, but that would
-        // cause inconsistencies to other times reported by different useful system services which all measure
-        // against wall clock, and in practice, the effect of NTP adjustments is minimal or negligible, as these
-        // never create backwards running time or large timewarps, only 1 ppm level adjustments per second, ie,
-        // the effect is way below the sleepwait_threshold for any reasonable sleep time -- easily compensated by
-        // our hybrid approach...
-        // We use TIMER_ABSTIME, so we are totally drift-free and restartable in case our sleep gets interrupted by
-        // signals. If clock_nanosleep gets EINTR - Interrupted by a posix signal, we simply loop and restart the
-        // sleep. If it returns a different error condition, we abort sleep iteration -- something would be seriously
-        // wrong...
-        if ((rc = clock_nanosleep(CLOCK_REALTIME, TIMER_ABSTIME, &rqtp, NULL)) && (rc != EINTR)) break;
-
-        // Update our 'now' time for reiterating or continuing with busy-sleep...
-        PsychGetPrecisionTimerSeconds(&now);
-    }
-
-    // Waiting stage 2: We are less than sleepwait_threshold seconds away from deadline.
+    targettime = whenSecs - cal->threshold;
+
+    // Use high-precision/high-resolution POSIX realtime timers for precise waiting, on CLOCK_MONOTONIC
+    // with an absolute deadline, so we are totally drift-free and restartable in case our sleep gets
+    // interrupted by signals. If the sleep gets EINTR - Interrupted by a posix signal, we simply restart
+    // the sleep. If it returns a different error condition, we abort sleep iteration -- something would be
+    // seriously wrong... We loop in case the timebase clock got adjusted relative to CLOCK_MONOTONIC:
+    if (now < targettime) {
+        engine->stats.numSleeps++;
+
+        while (now < targettime) {
+            PsychTimebaseToMonotonicDeadline(targettime, now, &deadline);
+            while ((rc = PsychSleepUntilMonotonicDeadline(engine, &deadline)) == EINTR);
+
+            // Update our 'now' time for reiterating or continuing with busy-sleep...
+            PsychGetPrecisionTimerSeconds(&now);
+            if (rc) break;
+        }
+
+        // Calibrate with measured wake-up latency:
+        if (!rc)
+            PsychCalibrateWaitEngine(cal, (now > targettime) ? now - targettime : 0);
+    }
+    else if (whenSecs - now > 2 * cal->initial) {
+        // Wait is longer than a sleep with the initial threshold, but we busy-wait it completely, because
+        // of rare large outliers in the latency samples. No sleep means no new samples which would push the
+        // outliers out of the ringbuffer, so age them out instead, lest we get stuck at a high threshold:
+        if (++cal->skippedCount >= 8) {
+            PsychAgeWaitLatencies(cal);
+            cal->skippedCount = 0;
+        }
+    }
+
+    // Waiting stage 2: We are less than 'threshold' seconds away from deadline.
     // Perform busy-waiting until deadline reached:
+    spinstart = now;
     while (now < whenSecs) PsychGetPrecisionTimerSeconds(&now);
+    engine->stats.spinSecs += now - spinstart;
+
+    if (boosted)
+        pthread_setschedparam(pthread_self(), oldpolicy, &oldsp);
+
+    // Account lateness of wakeup:
+    lateness = now - whenSecs;
+    engine->stats.latenessSecs += lateness;
+    if (lateness > engine->stats.maxLatenessSecs)
+        engine->stats.maxLatenessSecs = lateness;
+
+    // Warnings are only printed here, after the deadline. Inside a blocking region of a Python module
+    // call, the scripting glue defers their output until the Python GIL is held again:
+    if (fifoError)
+        printf("PTB-WARNING: Could not switch thread to SCHED_FIFO priority %i for precise waits [%s]. Disabled for this thread.\n",
+               sp.sched_priority, strerror(fifoError));
 
     // Check for deadline-miss of more than 0.1 ms:
-    if (now - whenSecs > 0.0001) {
+    if (lateness > 0.0001) {
         // Deadline missed by over 0.1 ms.
-        missed_count++;
-        // As long as the threshold is below a msec, immediately increase by 100 microsecs...
-        if (sleepwait_threshold < 0.001) sleepwait_threshold+=0.0001;
-
-        // If threshold has reached 1 msec, we require multiple consecutive misses before increasing any further:
-        if (missed_count>5) {
-            // Too many consecutive misses. Increase our threshold for sleep-waiting
-            // by 0.1 ms until it reaches max. 10 ms.
-            if (sleepwait_threshold < 0.01) sleepwait_threshold+=0.0001;
-
-            printf("PTB-WARNING: Wait-Deadline missed for %i consecutive times (Last miss %lf ms). New sleepwait_threshold is %lf ms.\n",
-                   missed_count, (now - whenSecs)*1000.0f, sleepwait_threshold*1000.0f);
+        engine->stats.numMisses++;
+        cal->missedCount++;
+
+        // If the sleep itself overshot the deadline, increase penalty margin by 100 microsecs, up
+        // to 10 msecs. If the thread got preempted while busy-waiting instead, a larger margin would
+        // only mean more busy-waiting, so leave it alone:
+        if ((spinstart >= whenSecs) && (cal->penalty < 0.01)) {
+            cal->penalty += 0.0001;
+            PsychCalibrateWaitEngine(cal, -1);
         }
+
+        // Only complain after multiple consecutive misses:
+        if (cal->missedCount > 5)
+            printf("PTB-WARNING: Wait-Deadline missed for %i consecutive times (Last miss %lf ms). New wait threshold is %lf ms.\n",
+                   cal->missedCount, lateness * 1000.0f, cal->threshold * 1000.0f);
     }
     else {
-        // No miss detected. Reset counter...
-        missed_count=0;
+        // No miss detected. Reset counter, let penalty decay:
+        cal->missedCount = 0;
+        cal->penalty *= 0.95;
     }
 
     // Ready.
     return;
 }
 
+// Return precise wait statistics of the calling thread, optionally reset them afterwards:
+void PsychOSGetWaitStatistics(PsychWaitStatistics* stats, psych_bool reset)
+{
+    double sorted[kPsychWaitLatencySamples];
+    PsychWaitCalibration* cal;
+    PsychWaitEngine* engine = PsychGetWaitEngine(&cal);
+    int n = PsychSortWaitLatencies(cal, sorted);
+
+    engine->stats.thresholdSecs = cal->threshold;
+    engine->stats.wakeupLatencySecs = (n > 0) ? sorted[n / 2] : 0;
+    engine->stats.realtime = (cal == &engine->calibration[1]) ? 1 : 0;
+    engine->stats.timerfd = (engine->timerfd >= 0) ? 1 : 0;
+    engine->stats.fifoPriority = engine->fifoPriority;
+
+    if (stats)
+        *stats = engine->stats;
+
+    if (reset)
+        memset(&engine->stats, 0, sizeof(engine->stats));
+}
+
 void PsychWaitIntervalSeconds(double delaySecs)
 {
     double deadline;
@@ -162,17 +584,20 @@ void PsychWaitIntervalSeconds(double delaySecs)
  */
 void PsychYieldIntervalSeconds(double delaySecs)
 {
+    PsychWaitCalibration* cal;
+
     if (delaySecs <= 0) {
         // Yield cpu for remainder of this timeslice:
         sched_yield();
     }
     else {
         // On Linux we use standard wait ops - they're good enough for us.
-        // However, we make sure that the wait lasts at least 2x the sleepwait_threshold,
-        // so the cpu gets certainly released to other threads, instead of getting hogged
-        // by busy-waiting for too short delaySecs intervals - which would be detrimental
-        // to the goals of PsychYieldIntervalSeconds():
-        delaySecs = (delaySecs > 2.0 * sleepwait_threshold) ? delaySecs : (2.0 * sleepwait_threshold);
+        // However, we make sure that the wait lasts at least 2x the wait threshold of the
+        // calling thread, so the cpu gets certainly released to other threads, instead of
+        // getting hogged by busy-waiting for too short delaySecs intervals - which would be
+        // detrimental to the goals of PsychYieldIntervalSeconds():
+        PsychGetWaitEngine(&cal);
+        delaySecs = (delaySecs > 2.0 * cal->threshold) ? delaySecs : (2.0 * cal->threshold);
         PsychWaitIntervalSeconds(delaySecs);
     }
 }
@@ -189,6 +614,13 @@ double PsychGetKernelTimebaseFrequencyHz(void)
 
 void PsychInitTimeGlue(void)
 {
+    // Select GetSecs timebase:
+    if (!timebaseInitialized)
+        PsychInitTimebase();
+
+    // Select options of the precision wait engine:
+    PsychInitWaitEngineOptions();
+
     // Set this, although its totally pointless on our implementation...
     PsychEstimateGetSecsValueAtTickCountZero();
 }
@@ -199,6 +631,21 @@ void PsychExitTimeGlue(void)
     // Disable game-mode optimizations if any are active:
     PsychOSSetGameMode(FALSE, 3);
 
+    // Release the timerfd's of all threads which are still alive, and the key whose destructor
+    // would release them at thread exit, as the destructor won't exist after module unload. Any
+    // thread which waits again afterwards reinitializes its wait engine:
+    pthread_mutex_lock(&waitEngineListMutex);
+    while (waitEngineList) {
+        waitEngineList->initialized = FALSE;
+        PsychCloseWaitEngineTimerfd(waitEngineList);
+    }
+    pthread_mutex_unlock(&waitEngineListMutex);
+
+    if (waitEngineKeyValid) {
+        pthread_key_delete(waitEngineKey);
+        waitEngineKeyValid = FALSE;
+    }
+
     return;
 }
 
@@ -227,7 +674,7 @@ void PsychGetPrecisionTimerTicksMinimumDelta(psych_uint32 *delta)
 
     // We return the real clock tick resolution in microseconds, as 1 tick == 1 microsec
     // in our implementation.
-    clock_getres(CLOCK_REALTIME, &res);
+    clock_getres(timebaseClock, &res);
     *delta = (psych_uint32) ((((double) res.tv_sec) + ((double) res.tv_nsec / 1e9)) * 1e6);
 }
 
@@ -273,6 +720,10 @@ double PsychOSMonotonicToRefTime(double monotonicTime)
 
     // Given input monotonicTime time value closer to tMonotonic than to GetSecs time?
     if (fabs(monotonicTime - tMonotonic) < fabs(monotonicTime - now)) {
+        // Our timebase is CLOCK_MONOTONIC with a constant offset, so remapping is exact:
+        if ((timebaseMode == kPsychTimebaseMonotonic) && (precisionTimerAdjustmentFactor == 1))
+            return(monotonicTime + ((double) timebaseOffsetSecs + (double) timebaseOffsetNsecs / 1e9));
+
         // Timestamps are in monotonic time! Need to remap.
         // Requery reference and monotonic time in a retry-loop
         // to make sure remapping error is tighlty bounded to max. 20 usecs:
@@ -303,79 +754,54 @@ double PsychOSMonotonicToRefTime(double monotonicTime)
 void PsychGetPrecisionTimerSeconds(double *secs)
 {
     static psych_bool firstTime = TRUE;
-    struct timespec res;
+    struct timespec res, ts;
+    struct timeval tv;
 
     // First time invocation?
     if (firstTime) {
+        if (!timebaseInitialized)
+            PsychInitTimebase();
+
         // We query the real clock tick resolution in secs and store in global clockinc.
-        // This is useful as a constraint on sleepwait_threshold etc. for our sleep routines...
-        clock_getres(CLOCK_REALTIME, &res);
+        // This is useful as a constraint on the wait thresholds of our sleep routines...
+        clock_getres(timebaseClock, &res);
         clockinc = ((double) res.tv_sec) + ((double) res.tv_nsec / 1.e9);
+        if ((timebaseMode == kPsychTimebaseGettimeofday) && (clockinc < 0.000001))
+            clockinc = 0.000001;
 
-        // sleepwait_threshold should be significantly higher than the granularity of
-        // the underlying system clock, say 100x the resolution, but no higher than 10 msecs,
-        // and no lower than 100 microseconds. We start with optimistic 250 microseconds...
-        sleepwait_threshold = 0.00025;
-        if (sleepwait_threshold < 100 * clockinc) sleepwait_threshold = 100 * clockinc;
-        if (sleepwait_threshold > 0.010) sleepwait_threshold = 0.010;
-        // Only output info about sleepwait threshold and clock resolution if we consider the
-        // clock rather low res, ie. increments bigger 20 microseconds:
-        if (clockinc > 0.00002) printf("PTB-INFO: Real resolution of (rather low resolution!) system clock is %1.4f microseconds, dynamic sleepwait_threshold starts with %lf msecs...\n", clockinc * 1e6, sleepwait_threshold * 1e3);
+        // Only output info about clock resolution if we consider the clock rather low res,
+        // ie. increments bigger 20 microseconds:
+        if (clockinc > 0.00002) printf("PTB-INFO: Real resolution of (rather low resolution!) system clock is %1.4f microseconds, wait thresholds will be at least %lf msecs...\n", clockinc * 1e6, 20 * clockinc * 1e3);
 
         firstTime = FALSE;
     }
 
-    // We use gettimeofday() - It works with microsecond resolution and
+    // Legacy timebase: gettimeofday() - It works with microsecond resolution and
     // is implemented via the highest precision time source on each
     // Linux system, e.g., the processors performance counters on
     // Intel Pentium systems. Actually, the resolution of the underlying
     // clocksource is often much better than 1 microsecond, e.g., nanoseconds,
-    // but Linux chooses always the highest precision reliable source, so in
-    // case TSC's are broken and HPET's are not available and ACPI PM-Timers
-    // aren't available, it could be a worse than 1 usec source, although this
-    // is extremely unlikely...
-    static double oldss = -1;
-    double ss;
-    struct timeval tv;
-    gettimeofday(&tv, NULL);
-    ss = ((double) tv.tv_sec) + (((double) tv.tv_usec) / 1000000.0);
-
-    // Some correctness checks against last queried value, if initialized:
-    if (oldss > -1) {
-        // Old reference available. We check for monotonicity, ie. if time
-        // is not going backwards. That's all we can do, as we don't have access
-        // to a reference clock. We can't check for clock halts either, because
-        // given a fast machine, or concurrent calls from multiple threads and a
-        // low granularity clocksource, it could happen that multiple queries report
-        // the same time. However, i (MK) checked the source code of current Linux2.6.22
-        // kernels and found that Linux itself contains plenty of checks and measures to
-        // make sure the clock is working correctly and to compensate for any conceivable
-        // failure. We couldn't do a better job than the kernel in any case. This check
-        // is just to spot idiots in front of the keyboard that manually override Linux
-        // clocksource selection and basically try to shoot themselves into the leg.
-        // It may also be useful is somebody is running a very old Linux kernel without
-        // sophisticated checking and for testing/debugging PTB and its error-handling itself by
-        // fault-injection...
-        // MK: DISABLED FOR THIS RELEASE: Gives false alarms due to some race-condition when
-        // function is called from multiple concurrent threads. Proper fix is known, but i
-        // want to get a beta out now and not in a week...
-        // if (ss < oldss) {
-        if (FALSE) {
-            // Time warp detected! Time going backwards!!! Nothing we can do, only report
-            // it:
-            printf("\n\nPTB-CRITICAL-ERROR: Your systems clock is reporting time to run backwards!!!\n");
-            printf("PTB-CRITICAL-ERROR: (Delta %lf secs). This is impossible and indicates some\n", ss - oldss);
-            printf("PTB-CRITICAL-ERROR: broken clock hardware or Linux setup!! Stop using this machine\n");
-            printf("PTB-CRITICAL-ERROR: for psychophysics immmediately and resolve the problem!!!\n\n");
-            fflush(NULL);
-        }
+    // but gettimeofday() truncates to microseconds, and follows all NTP and
+    // administrator adjustments of system time:
+    if (timebaseMode == kPsychTimebaseGettimeofday) {
+        gettimeofday(&tv, NULL);
+        *secs = ((double) tv.tv_sec) + (((double) tv.tv_usec) / 1000000.0);
+        return;
     }
 
-    // Init reference timestamp for checking in next call:
-    oldss = ss;
+    // Other timebases: clock_gettime() on our timebase clock, with nanosecond resolution,
+    // served by the vDSO without a syscall. Add the constant offset to the legacy epoch in
+    // integer arithmetic, so there is only one rounding step for conversion to double. Note
+    // that a double holding seconds since 1970 only resolves about 0.25 microseconds:
+    clock_gettime(timebaseClock, &ts);
+    ts.tv_sec += timebaseOffsetSecs;
+    ts.tv_nsec += timebaseOffsetNsecs;
+    if (ts.tv_nsec >= 1000000000L) {
+        ts.tv_sec++;
+        ts.tv_nsec -= 1000000000L;
+    }
 
-    // Assign final time value:
-    *secs= ss;
+    *secs = PsychTimespecToSeconds(&ts);
 }
 
 void PsychGetAdjustedPrecisionTimerSeconds(double *secs)
@@ -412,6 +838,29 @@ double PsychGetEstimatedSecsValueAtTickCountZero(void)
     return(estimatedGetSecsValueAtTickCountZero);
 }
 
+/* PsychOSRealtimeToRefTime(t)
+ *
+ * Map given CLOCK_REALTIME aka gettimeofday() time value realTime to PTB
+ * reference time. Pass-through if our timebase is CLOCK_REALTIME.
+ */
+double PsychOSRealtimeToRefTime(double realTime)
+{
+    double now, now2, tReal;
+
+    if (timebaseMode <= kPsychTimebaseRealtime)
+        return(realTime);
+
+    // Requery reference and realtime time in a retry-loop
+    // to make sure remapping error is tighlty bounded to max. 20 usecs:
+    do {
+        PsychGetAdjustedPrecisionTimerSeconds(&now);
+        tReal = PsychGetWallClockSeconds();
+        PsychGetAdjustedPrecisionTimerSeconds(&now2);
+    } while (now2 - now > 0.000020);
+
+    return(realTime + ((now + now2) / 2 - tReal));
+}
+
 /* PsychGetWallClockSeconds - Return gettimeofday() wall clock time. */
 double PsychGetWallClockSeconds(void)
 {
@@ -603,6 +1052,9 @@ int PsychSetThreadPriority(psych_thread* threadhandle, int basePriority, int twe
 /* Assign a name to a thread, for debugging: */
 void PsychSetThreadName(const char *name)
 {
+    // Name for trace output:
+    PsychTraceSetThreadName(name);
+
     #  if defined(__GNU_LIBRARY__) && defined(__GLIBC__) && defined(__GLIBC_MINOR__) && \
     (__GLIBC__ >= 3 || (__GLIBC__ == 2 && __GLIBC_MINOR__ >= 12))
     pthread_setname_np(pthread_self(), name);
@@ -665,8 +1117,9 @@ int PsychTimedWaitCondition(psych_condition* condition, psych_mutex* mutex, doub
     struct timespec abstime;
     double tnow;
 
-    // Convert relative wait time to absolute system time:
-    PsychGetAdjustedPrecisionTimerSeconds(&tnow);
+    // Convert relative wait time to absolute system time. pthread_cond_timedwait() uses
+    // CLOCK_REALTIME, which is not necessarily our GetSecs timebase:
+    tnow = PsychGetWallClockSeconds();
     maxwaittimesecs+=tnow;
 
     // Split maxwaittimesecs in...
@@ -71,6 +71,30 @@ const char* PsychSupportStatus(void);
 // Linux specific: CLOCK_MONOTONIC time in seconds -- Usually the system uptime:
 double PsychOSGetLinuxMonotonicTime(void);
 double PsychOSMonotonicToRefTime(double monotonicTime);
+double PsychOSRealtimeToRefTime(double realTime);
+
+// Linux specific: GetSecs timebases, selectable via environment variable PSYCH_GETSECS_TIMEBASE:
+#define kPsychTimebaseGettimeofday  0   // "gettimeofday": Legacy gettimeofday(), microsecond resolution.
+#define kPsychTimebaseRealtime      1   // "realtime": CLOCK_REALTIME, same as gettimeofday(), nanosecond resolution.
+#define kPsychTimebaseMonotonic     2   // "monotonic": CLOCK_MONOTONIC + offset to gettimeofday() epoch at startup. Default.
+#define kPsychTimebaseMonotonicRaw  3   // "monotonicraw": CLOCK_MONOTONIC_RAW + offset, not slewed by NTP.
+int PsychOSGetTimebase(const char** name, double* offset, double* resolution);
+
+// Linux specific: Statistics of the precision wait engine of the calling thread, for PsychWaitUntilSeconds() and friends:
+typedef struct PsychWaitStatistics {
+    psych_uint64    numWaits;           // Number of waits for a deadline in the future.
+    psych_uint64    numSleeps;          // Number of waits which slept before busy-waiting.
+    psych_uint64    numMisses;          // Number of deadlines missed by more than 0.1 msecs.
+    double          latenessSecs;       // Sum of wakeup times after deadline.
+    double          maxLatenessSecs;    // Maximum wakeup time after deadline.
+    double          spinSecs;           // Sum of time spent busy-waiting.
+    double          thresholdSecs;      // Current busy-wait margin before deadline.
+    double          wakeupLatencySecs;  // Median wakeup latency after the recent sleeps.
+    int             realtime;           // 1 = Calibration for realtime scheduling, 0 = normal scheduling.
+    int             timerfd;            // 1 = Sleeps use a timerfd, 0 = Sleeps use clock_nanosleep().
+    int             fifoPriority;       // SCHED_FIFO priority of boost during waits, 0 = No boost.
+} PsychWaitStatistics;
+void PsychOSGetWaitStatistics(PsychWaitStatistics* stats, psych_bool reset);
 
 // Test if module needs to call XInitThreads() itself during startup:
 int PsychOSNeedXInitThreads(int verbose);
@@ -35,6 +35,18 @@ static unsigned int psychHIDKbQueueFlags[PSYCH_HID_MAX_DEVICES];
 static PsychHIDEventRecord psychHIDKbQueueOldEvent[PSYCH_HID_MAX_DEVICES];
 static Window  psychHIDKbQueueXWindow[PSYCH_HID_MAX_DEVICES];
 static psych_bool psychHIDKbQueueActive[PSYCH_HID_MAX_DEVICES];
+
+// Shadow key state for round-trip free KbCheck, maintained by the KbQueue worker thread for queues created
+// with flag 8. 'keys' is a bitmap of pressed keys/buttons, indexed like KbCheck's keyCode vector, 'changeTime'
+// the GetSecs time of the last state change of each key. Readers use the seqlock 'seq', which is odd while
+// the worker is updating the state:
+typedef struct PsychHIDShadowKeyState {
+    volatile unsigned int seq;
+    unsigned char keys[32];
+    double changeTime[256];
+} PsychHIDShadowKeyState;
+
+static PsychHIDShadowKeyState* psychHIDKbQueueShadowState[PSYCH_HID_MAX_DEVICES];
 static psych_mutex KbQueueMutex;
 static psych_condition KbQueueCondition;
 static psych_bool  KbQueueThreadTerminate;
@@ -68,6 +80,7 @@ void PsychHIDInitializeHIDStandardInterfaces(void)
     memset(&psychHIDKbQueueOldEvent[0], 0, sizeof(psychHIDKbQueueOldEvent));
     memset(&psychHIDKbQueueFlags[0], 0, sizeof(psychHIDKbQueueFlags));
     memset(&psychHIDKbQueueXWindow[0], 0, sizeof(psychHIDKbQueueXWindow));
+    memset(&psychHIDKbQueueShadowState[0], 0, sizeof(psychHIDKbQueueShadowState));
 
     // Call XInitThreads() ourselves before any other X-Lib call if we need to
     // do this to work around lack of proper X-Lib threading init in the host
@@ -331,16 +344,14 @@ PsychError PsychHIDEnumerateHIDInputDevices(int deviceClass)
     return(PsychError_none);
 }
 
-PsychError PsychHIDOSKbCheck(int deviceIndex, double* scanList)
+// Query current key/button state of device 'deviceIndex' from the X-Server into the 256 bit vector
+// 'keys_return'. Returns TRUE if the device has buttons instead of keys, with button indices shifted by +1:
+static psych_bool KbQueryKeyState(int deviceIndex, unsigned char* keys_return)
 {
-    double* buttonStates;
-    unsigned char keys_return[32];
-    int keysdown;
-    double timestamp;
     int i, j;
     psych_bool isButtons = FALSE;
 
-    memset(keys_return, 0, sizeof(keys_return));
+    memset(keys_return, 0, 32);
 
     // Map "default" deviceIndex to legacy "Core protocol" method of querying keyboard
     // state. This will give us whatever X has setup as default keyboard:
@@ -384,7 +395,7 @@ PsychError PsychHIDOSKbCheck(int deviceIndex, double* scanList)
                 // printf("NumKeys %i\n", ((XKeyState*) data)->num_keys);
 
                 // Copy 32 Byte keystate vector into key_return. Each bit encodes for one key:
-                memcpy(&keys_return[0], &(((XKeyState*) data)->keys[0]), sizeof(keys_return));
+                memcpy(&keys_return[0], &(((XKeyState*) data)->keys[0]), 32);
                 isButtons = FALSE;
             }
 
@@ -393,7 +404,7 @@ PsychError PsychHIDOSKbCheck(int deviceIndex, double* scanList)
                 // printf("NumButtons %i\n", ((XButtonState*) data)->num_buttons);
 
                 // Copy 32 Byte buttonstate vector into key_return. Each bit encodes for one button:
-                memcpy(&keys_return[0], &(((XButtonState*) data)->buttons[0]), sizeof(keys_return));
+                memcpy(&keys_return[0], &(((XButtonState*) data)->buttons[0]), 32);
                 isButtons = TRUE;
             }
 
@@ -404,6 +415,66 @@ PsychError PsychHIDOSKbCheck(int deviceIndex, double* scanList)
         XFreeDeviceState(state);
     }
 
+    return(isButtons);
+}
+
+// Seqlock protected update of shadow key state 'state' by the KbQueue worker thread:
+static void KbQueueUpdateShadowKeyState(PsychHIDShadowKeyState* state, int index, psych_bool pressed, double tnow)
+{
+    if ((index < 0) || (index > 255) || (((state->keys[index / 8] & (1 << (index % 8))) ? TRUE : FALSE) == pressed))
+        return;
+
+    state->seq++;
+    __sync_synchronize();
+
+    if (pressed)
+        state->keys[index / 8] |= (1 << (index % 8));
+    else
+        state->keys[index / 8] &= ~(1 << (index % 8));
+
+    state->changeTime[index] = tnow;
+
+    __sync_synchronize();
+    state->seq++;
+}
+
+PsychError PsychHIDOSKbCheck(int deviceIndex, double* scanList)
+{
+    double* buttonStates;
+    double* changeTimes;
+    unsigned char keys_return[32];
+    double change_return[256];
+    PsychHIDShadowKeyState* state;
+    unsigned int seq;
+    int keysdown;
+    double timestamp;
+    int i, j;
+    psych_bool isButtons = FALSE;
+
+    memset(change_return, 0, sizeof(change_return));
+
+    // Served from shadow key state of a running keyboard queue? Only for an explicitly specified device.
+    // The default deviceIndex INT_MAX queries all keyboards via XQueryKeymap(), which the shadow state
+    // of a single device can't replace:
+    state = NULL;
+    if ((deviceIndex >= 0) && (deviceIndex < ndevices) && psychHIDKbQueueActive[deviceIndex])
+        state = psychHIDKbQueueShadowState[deviceIndex];
+
+    if (state) {
+        // Yes: Copy a consistent snapshot, no need to talk to the X-Server:
+        do {
+            seq = state->seq;
+            __sync_synchronize();
+            memcpy(keys_return, state->keys, sizeof(keys_return));
+            memcpy(change_return, state->changeTime, sizeof(change_return));
+            __sync_synchronize();
+        } while ((seq & 1) || (seq != state->seq));
+    }
+    else {
+        // No: Query the X-Server:
+        isButtons = KbQueryKeyState(deviceIndex, keys_return);
+    }
+
     // Done with query. We have keyboard state in keys_return[] now.
 
     // Request current time of query:
@@ -424,6 +495,11 @@ PsychError PsychHIDOSKbCheck(int deviceIndex, double* scanList)
     // Copy keyboard state:
     PsychAllocOutDoubleMatArg(3, kPsychArgOptional, 1, 256, 1, &buttonStates);
 
+    // Copy time of last state change per key, or zero if unknown:
+    PsychAllocOutDoubleMatArg(4, kPsychArgOptional, 1, 256, 1, &changeTimes);
+    for (i = 0; i < 256; i++)
+        changeTimes[i] = (scanList && (scanList[i] <= 0)) ? 0 : change_return[i];
+
     // Map 32 times 8 bitvector to 256 element return vector:
     for(i = 0; i < 32; i++) {
         for(j = 0; j < 8; j++) {
@@ -504,10 +580,10 @@ PsychError PsychHIDOSGamePadAxisQuery(int deviceIndex, int axisId, double* min,
             *(outSamples++) = (double) i;
 
             // Sampletime in row 2: Need to convert msecs to sec and
-            // then map from CLOCK_MONOTONIC to our CLOCK_REALTIME
-            // GetSecs() timebase:
+            // then map from CLOCK_MONOTONIC to our GetSecs() timebase,
+            // via the drift corrected mapping of the clock domain:
             tSample = (double) samples[i].time / 1000.0;
-            *(outSamples++) = PsychOSMonotonicToRefTime(tSample);
+            *(outSamples++) = PsychClockDomainToRefTime(kPsychClockDomainMonotonic, tSample);
 
             // Axis motion samples in successive rows:
             for (j = 0; j < axis_count_return; j++) {
@@ -523,6 +599,19 @@ PsychError PsychHIDOSGamePadAxisQuery(int deviceIndex, int axisId, double* min,
     return(PsychError_none);
 }
 
+// Map X-Server event time to GetSecs time, given GetSecs time 'tnow' of reception by us. The X-Server
+// timestamps events with CLOCK_MONOTONIC time in msecs, truncated to 32 bits, so compute the age of
+// the event from current CLOCK_MONOTONIC time, with wraparound handling:
+static double KbQueueXTimeToGetSecs(Time xtime, double tnow)
+{
+    psych_uint32 age = (psych_uint32) ((psych_uint64) (PsychOSGetLinuxMonotonicTime() * 1000.0)) - (psych_uint32) xtime;
+
+    // Rounding can make fresh events appear to be from the future:
+    if (age > 0x80000000) age = 0;
+
+    return(tnow - (double) age / 1000.0);
+}
+
 // This is the event dequeue & process function which updates
 // Keyboard queue state. It can be called with 'blockingSinglepass'
 // set to TRUE to process exactly one event, if called from the
@@ -536,7 +625,7 @@ static void KbQueueProcessEvents(void)
     XIDeviceEvent* event;
     XIRawEvent* rawevent;
     psych_bool valid;
-    double tnow;
+    double tnow, tKernel;
     int i, j, index, deviceid, numValuators;
     unsigned int screen_width, screen_height;
     char asciiChar;
@@ -551,6 +640,7 @@ static void KbQueueProcessEvents(void)
 
         // Take timestamp:
         PsychGetAdjustedPrecisionTimerSeconds(&tnow);
+        PsychTraceBegin("PsychHID", "KbQueueProcessEvent");
 
         // Clear ringbuffer event:
         memset(&evt, 0 , sizeof(evt));
@@ -611,6 +701,9 @@ static void KbQueueProcessEvents(void)
                 // Map Xinput device id to PTB 'deviceIndex' aka the proper keyboard queue:
                 for (i = 0; i < ndevices; i++) if (deviceid == info[i].deviceid) break;
 
+                // Kernel / X-Server timestamp of the event, only needed for latency tracing:
+                tKernel = ((i < ndevices) && PsychHIDEventLatencyTraceEnabled(i)) ? KbQueueXTimeToGetSecs((event) ? event->time : rawevent->time, tnow) : -1;
+
                 // Special handling for synthetic key repeat flags required?
                 if ((i < ndevices) && (psychHIDKbQueueFlags[i] & 0x3)) {
                     // Yes: Filter out key repeat on raw events (from pointer devices) as well?
@@ -697,6 +790,12 @@ static void KbQueueProcessEvents(void)
                     // Need the lock from here on:
                     PsychLockMutex(&KbQueueMutex);
 
+                    // Maintain shadow key state for KbCheck, if enabled. This tracks all keys, not only the queue's keyFlags:
+                    if (psychHIDKbQueueActive[i] && psychHIDKbQueueShadowState[i])
+                        KbQueueUpdateShadowKeyState(psychHIDKbQueueShadowState[i], index,
+                                                    (cookie->evtype == XI_KeyPress) || (cookie->evtype == XI_ButtonPress) || (cookie->evtype == XI_RawButtonPress),
+                                                    tnow);
+
                     // This keyboard queue created and started? Interested in this
                     // keycode?
                     if (psychHIDKbQueueActive[i] && (psychHIDKbQueueScanKeys[i][index] != 0)) {
@@ -734,7 +833,7 @@ static void KbQueueProcessEvents(void)
                             evt.X = evt.Y = evt.normX = evt.normY = 0;
                         }
 
-                        PsychHIDAddEventToEventBuffer(i, &evt);
+                        PsychHIDAddTracedEventToEventBuffer(i, &evt, tKernel);
 
                         // Tell waiting userspace (under KbQueueMutex protection for better scheduling) something interesting has changed:
                         PsychSignalCondition(&KbQueueCondition);
@@ -832,7 +931,8 @@ static void KbQueueProcessEvents(void)
 
                             // Fetch most recent touch record in the series for this touch point:
                             // oldevt == NULL if none yet exists, or none exists anymore due to some buffer wraparound:
-                            PsychHIDEventRecord *oldevt = PsychHIDLastTouchEventFromEventBuffer(i, evt.rawEventCode);
+                            PsychHIDEventRecord oldevtRecord;
+                            PsychHIDEventRecord *oldevt = (PsychHIDLastTouchEventFromEventBuffer(i, evt.rawEventCode, &oldevtRecord, 0)) ? &oldevtRecord : NULL;
 
                             // Everything of interest is in the valuators:
                             if (cookie->evtype != XI_TouchOwnership) {
@@ -962,9 +1062,9 @@ static void KbQueueProcessEvents(void)
                                     if (FALSE) {
                                         // Nope, we lost touch data. Did we already send a fail event for this touch queue?
                                         // If not, then do it now via the magic 0xffffffff touch point with type 5 for sequence abort.
-                                        if (!PsychHIDLastTouchEventFromEventBuffer(i, 0xffffffff)) {
+                                        if (!PsychHIDLastTouchEventFromEventBuffer(i, 0xffffffff, NULL, 0)) {
                                             // Inject touch end event now ...
-                                            PsychHIDAddEventToEventBuffer(i, &evt);
+                                            PsychHIDAddTracedEventToEventBuffer(i, &evt, tKernel);
 
                                             // Then let the code below inject it again, but with type 5 for fail,
                                             // and magic id 0xffffffff:
@@ -978,8 +1078,10 @@ static void KbQueueProcessEvents(void)
                                 case XI_TouchOwnership:
                                     // Ownership marker: We are the sole owner of this sequence, so got all the data
                                     // untampered :) - Set integrity bit for this touch point in last event for it:
-                                    if (oldevt)
+                                    if (oldevt) {
                                         oldevt->status |= (1 << 31);
+                                        PsychHIDLastTouchEventFromEventBuffer(i, evt.rawEventCode, NULL, (1 << 31));
+                                    }
 
                                     // printf("%i: XI_TouchOwnership!! %p\n", evt.rawEventCode, oldevt);
 
@@ -996,7 +1098,8 @@ static void KbQueueProcessEvents(void)
                         // Add anything but touch ownership events:
                         if (cookie->evtype != XI_TouchOwnership) {
                             // Update event buffer:
-                            PsychHIDAddEventToEventBuffer(i, &evt);
+                            PsychHIDAddTracedEventToEventBuffer(i, &evt, tKernel);
+                            PsychTraceInstant("PsychHID", "KbQueueAddEvent", (double) evt.rawEventCode);
 
                             // Tell waiting userspace (under KbQueueMutex protection for better scheduling) something interesting has changed:
                             PsychSignalCondition(&KbQueueCondition);
@@ -1010,6 +1113,8 @@ static void KbQueueProcessEvents(void)
                 XFreeEventData(thread_dpy, cookie);
             }
         }
+
+        PsychTraceEnd("PsychHID", "KbQueueProcessEvent");
     }
 
     return;
@@ -1162,6 +1267,15 @@ PsychError PsychHIDOSKbQueueCreate(int deviceIndex, int numScankeys, int* scanKe
     // Store associated X-Window handle, or zero for unspecified:
     psychHIDKbQueueXWindow[deviceIndex] = windowHandle;
 
+    // Shadow key state for KbCheck requested?
+    if (flags & 8) {
+        psychHIDKbQueueShadowState[deviceIndex] = calloc(1, sizeof(PsychHIDShadowKeyState));
+        if (NULL == psychHIDKbQueueShadowState[deviceIndex]) {
+            PsychHIDOSKbQueueRelease(deviceIndex);
+            PsychErrorExitMsg(PsychError_outofMemory, "Failed to create keyboard queue due to out of memory condition.");
+        }
+    }
+
     if (x_inputMethod == NULL) {
         // Create an input method and context in the currently set locale
         // for use in translation to the currently set keyboard layout. This
@@ -1230,6 +1344,7 @@ void PsychHIDOSKbQueueRelease(int deviceIndex)
     free(psychHIDKbQueueLastPress[deviceIndex]); psychHIDKbQueueLastPress[deviceIndex] = NULL;
     free(psychHIDKbQueueLastRelease[deviceIndex]); psychHIDKbQueueLastRelease[deviceIndex] = NULL;
     free(psychHIDKbQueueScanKeys[deviceIndex]); psychHIDKbQueueScanKeys[deviceIndex] = NULL;
+    free(psychHIDKbQueueShadowState[deviceIndex]); psychHIDKbQueueShadowState[deviceIndex] = NULL;
 
     // Release kbqueue event buffer:
     PsychHIDDeleteEventBuffer(deviceIndex);
@@ -1377,7 +1492,7 @@ void PsychHIDOSKbQueueStop(int deviceIndex)
 void PsychHIDOSKbQueueStart(int deviceIndex)
 {
     psych_bool queueActive;
-    int i;
+    int i, j;
     int numValuators;
 
     if (deviceIndex < 0) {
@@ -1402,6 +1517,27 @@ void PsychHIDOSKbQueueStart(int deviceIndex)
 
     // Queue is inactive. Start it:
 
+    // Seed shadow key state, if any, with the current key state, so keys which are already
+    // held down get reported properly. The worker only learns about future state changes:
+    if (psychHIDKbQueueShadowState[deviceIndex]) {
+        PsychHIDShadowKeyState* state = psychHIDKbQueueShadowState[deviceIndex];
+        unsigned char keys[32];
+        psych_bool isButtons = KbQueryKeyState(deviceIndex, keys);
+
+        state->seq++;
+        __sync_synchronize();
+        memset(state->keys, 0, sizeof(state->keys));
+        memset(state->changeTime, 0, sizeof(state->changeTime));
+        for (i = 0; i < 256; i++) {
+            // Buttons are shifted by +1 index, see PsychHIDOSKbCheck():
+            j = (isButtons) ? i - 1 : i;
+            if ((j >= 0) && (keys[i / 8] & (1 << (i % 8))))
+                state->keys[j / 8] |= (1 << (j % 8));
+        }
+        __sync_synchronize();
+        state->seq++;
+    }
+
     // Will this be the first active queue, ie., aren't there any queues running so far?
     queueActive = FALSE;
     for (i = 0; i < PSYCH_HID_MAX_DEVICES; i++) {
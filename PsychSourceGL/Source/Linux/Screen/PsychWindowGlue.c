@@ -367,6 +367,7 @@ psych_bool PsychOSOpenOnscreenWindow(PsychScreenSettingsType *screenSettings, Ps
     // Init userspace GL context to safe default:
     windowRecord->targetSpecific.glusercontextObject = NULL;
     windowRecord->targetSpecific.glswapcontextObject = NULL;
+    windowRecord->targetSpecific.gluploadcontextObject = NULL;
 
     // Which display depth is requested?
     depth = PsychGetValueFromDepthStruct(0, &(screenSettings->depth));
@@ -964,6 +965,22 @@ psych_bool PsychOSOpenOnscreenWindow(PsychScreenSettingsType *screenSettings, Ps
         return(FALSE);
     }
 
+    // Create rendering context for asynchronous texture uploads the same way. Failure is not fatal, as
+    // 'MakeTexture' then just creates textures synchronously:
+    PsychLockDisplay();
+
+    if (fbconfig) {
+        windowRecord->targetSpecific.gluploadcontextObject = glXCreateNewContext(dpy, fbconfig[0], GLX_RGBA_TYPE, windowRecord->targetSpecific.contextObject, True);
+    } else {
+        windowRecord->targetSpecific.gluploadcontextObject = glXCreateContext(dpy, visinfo, windowRecord->targetSpecific.contextObject, True);
+    }
+
+    PsychUnlockDisplay();
+
+    if ((windowRecord->targetSpecific.gluploadcontextObject == NULL) && (PsychPrefStateGet_Verbosity() > 3)) {
+        printf("PTB-INFO: Creating a private OpenGL context for asynchronous texture uploads failed. Textures will be created synchronously.\n");
+    }
+
     // External 3D graphics support enabled?
     if (PsychPrefStateGet_3DGfx()) {
         // Yes. We need to create an extra OpenGL rendering context for the external
@@ -1463,6 +1480,12 @@ void PsychOSCloseWindow(PsychWindowRecordType *windowRecord)
     glXDestroyContext(dpy, windowRecord->targetSpecific.glswapcontextObject);
     windowRecord->targetSpecific.glswapcontextObject=NULL;
 
+    // Delete texture upload context, if any:
+    if (windowRecord->targetSpecific.gluploadcontextObject) {
+        glXDestroyContext(dpy, windowRecord->targetSpecific.gluploadcontextObject);
+        windowRecord->targetSpecific.gluploadcontextObject = NULL;
+    }
+
     // Delete userspace context, if any:
     if (windowRecord->targetSpecific.glusercontextObject) {
         glXDestroyContext(dpy, windowRecord->targetSpecific.glusercontextObject);
@@ -535,6 +535,7 @@ psych_bool PsychOSOpenOnscreenWindow(PsychScreenSettingsType * screenSettings, P
     // Init userspace GL context to safe default:
     windowRecord->targetSpecific.glusercontextObject = NULL;
     windowRecord->targetSpecific.glswapcontextObject = NULL;
+    windowRecord->targetSpecific.gluploadcontextObject = NULL;
 
     // Default to use of one shared x-display connection "dpy" for all onscreen windows
     // on a given x-display and x-screen:
@@ -817,6 +818,13 @@ psych_bool PsychOSOpenOnscreenWindow(PsychScreenSettingsType * screenSettings, P
         return (FALSE);
     }
 
+    // Create rendering context for asynchronous texture uploads the same way. Failure is not fatal, as
+    // 'MakeTexture' then just creates textures synchronously:
+    windowRecord->targetSpecific.gluploadcontextObject = waffle_context_create(config, windowRecord->targetSpecific.contextObject);
+    if ((windowRecord->targetSpecific.gluploadcontextObject == NULL) && (PsychPrefStateGet_Verbosity() > 3)) {
+        printf("PTB-INFO: Creating a private OpenGL context for asynchronous texture uploads failed. Textures will be created synchronously.\n");
+    }
+
     // External 3D graphics support enabled?
     if (PsychPrefStateGet_3DGfx()) {
         // Yes. We need to create an extra OpenGL rendering context for the external
@@ -1164,6 +1172,12 @@ void PsychOSCloseWindow(PsychWindowRecordType * windowRecord)
     waffle_context_destroy(windowRecord->targetSpecific.glswapcontextObject);
     windowRecord->targetSpecific.glswapcontextObject = NULL;
 
+    // Delete texture upload context, if any:
+    if (windowRecord->targetSpecific.gluploadcontextObject) {
+        waffle_context_destroy(windowRecord->targetSpecific.gluploadcontextObject);
+        windowRecord->targetSpecific.gluploadcontextObject = NULL;
+    }
+
     // Delete userspace context, if any:
     if (windowRecord->targetSpecific.glusercontextObject) {
         waffle_context_destroy(windowRecord->targetSpecific.glusercontextObject);
@@ -413,6 +413,9 @@ int PsychSetThreadPriority(psych_thread* threadhandle, int basePriority, int twe
 /* Assign a name to a thread, for debugging: */
 void PsychSetThreadName(const char *name)
 {
+    // Name for trace output:
+    PsychTraceSetThreadName(name);
+
     // OSX interface only allows assigning name to current thread, different to Linux:
     pthread_setname_np(name);
 }
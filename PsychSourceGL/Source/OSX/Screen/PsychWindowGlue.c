@@ -491,6 +491,7 @@ psych_bool PsychOSOpenOnscreenWindow(PsychScreenSettingsType *screenSettings, Ps
     windowRecord->targetSpecific.pixelFormatObject = NULL;
     windowRecord->targetSpecific.glusercontextObject = NULL;
     windowRecord->targetSpecific.glswapcontextObject = NULL;
+    windowRecord->targetSpecific.gluploadcontextObject = NULL;
 
     // Try to find matching pixelformat:
     error = CGLChoosePixelFormat(attribs, &(windowRecord->targetSpecific.pixelFormatObject), &numVirtualScreens);
@@ -599,6 +600,14 @@ psych_bool PsychOSOpenOnscreenWindow(PsychScreenSettingsType *screenSettings, Ps
         return(FALSE);
     }
 
+    // Create gluploadcontextObject for asynchronous texture uploads by a background thread. Failure
+    // is not fatal, as 'MakeTexture' then just creates textures synchronously:
+    error=CGLCreateContext(windowRecord->targetSpecific.pixelFormatObject, windowRecord->targetSpecific.contextObject, &(windowRecord->targetSpecific.gluploadcontextObject));
+    if (error) {
+        if (PsychPrefStateGet_Verbosity() > 3) printf("PTB-INFO: Creating a private OpenGL context for asynchronous texture uploads failed [%s]. Textures will be created synchronously.\n", CGLErrorString(error));
+        windowRecord->targetSpecific.gluploadcontextObject = NULL;
+    }
+
     // Store Cocoa onscreen window handle:
     windowRecord->targetSpecific.windowHandle = cocoaWindow;
 
@@ -737,6 +746,7 @@ void PsychOSCloseWindow(PsychWindowRecordType *windowRecord)
     CGLReleaseContext(windowRecord->targetSpecific.contextObject);
     if (windowRecord->targetSpecific.glusercontextObject) CGLReleaseContext(windowRecord->targetSpecific.glusercontextObject);
     if (windowRecord->targetSpecific.glswapcontextObject) CGLReleaseContext(windowRecord->targetSpecific.glswapcontextObject);
+    if (windowRecord->targetSpecific.gluploadcontextObject) CGLReleaseContext(windowRecord->targetSpecific.gluploadcontextObject);
 
     // Release all cursor constraints for this window:
     PsychOSConstrainPointer(windowRecord, FALSE, NULL);
@@ -1497,8 +1497,8 @@ int PsychSetThreadPriority(psych_thread* threadhandle, int basePriority, int twe
 /* Assign a name to a thread, for debugging: */
 void PsychSetThreadName(const char *name)
 {
-    // No-op for now.
-    (void) name;
+    // Only used for trace output for now:
+    PsychTraceSetThreadName(name);
     return;
 }
 
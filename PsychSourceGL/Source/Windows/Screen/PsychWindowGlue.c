@@ -802,6 +802,7 @@ psych_bool PsychOSOpenOnscreenWindow(PsychScreenSettingsType *screenSettings, Ps
     // Init to safe default:
     windowRecord->targetSpecific.glusercontextObject = NULL;
     windowRecord->targetSpecific.glswapcontextObject = NULL;
+    windowRecord->targetSpecific.gluploadcontextObject = NULL;
 
     // Map the logical screen number to a device handle for the corresponding
     // physical display device: CGDirectDisplayID is currently typedef'd to a
@@ -1750,6 +1751,18 @@ dwmdontcare:
         }
     }
 
+    // Setup dedicated context for asynchronous texture uploads. Failure is not fatal, as 'MakeTexture'
+    // then just creates textures synchronously, but the context is useless without ressource sharing:
+    windowRecord->targetSpecific.gluploadcontextObject = wglCreateContext(hDC);
+    if (windowRecord->targetSpecific.gluploadcontextObject && !wglShareLists(windowRecord->targetSpecific.contextObject, windowRecord->targetSpecific.gluploadcontextObject)) {
+        wglDeleteContext(windowRecord->targetSpecific.gluploadcontextObject);
+        windowRecord->targetSpecific.gluploadcontextObject = NULL;
+    }
+
+    if ((windowRecord->targetSpecific.gluploadcontextObject == NULL) && (PsychPrefStateGet_Verbosity() > 3)) {
+        printf("PTB-INFO: Creating a private OpenGL context for asynchronous texture uploads failed. Textures will be created synchronously.\n");
+    }
+
     if (PsychPrefStateGet_Verbosity() > 4) {
         printf("PTB-DEBUG: Final low-level window setup: ShowWindow(), SetCapture(), diagnostics...\n");
         fflush(NULL);
@@ -1887,6 +1900,12 @@ void PsychOSCloseWindow(PsychWindowRecordType *windowRecord)
     wglDeleteContext(windowRecord->targetSpecific.glswapcontextObject);
     windowRecord->targetSpecific.glswapcontextObject=NULL;
 
+    // Delete texture upload context, if any:
+    if (windowRecord->targetSpecific.gluploadcontextObject) {
+        wglDeleteContext(windowRecord->targetSpecific.gluploadcontextObject);
+        windowRecord->targetSpecific.gluploadcontextObject = NULL;
+    }
+
     // Delete userspace context:
     if (windowRecord->targetSpecific.glusercontextObject) {
         wglDeleteContext(windowRecord->targetSpecific.glusercontextObject);
@@ -81,7 +81,8 @@ function datapixxmakemex()
     S = [S ' ' PTBDIR 'PsychSourceGL/Source/Common/Base/PsychError.c'];
     S = [S ' ' PTBDIR 'PsychSourceGL/Source/Common/Base/PsychHelp.c'];
     S = [S ' ' PTBDIR 'PsychSourceGL/Source/Common/Base/PsychInit.c'];
-    S = [S ' ' PTBDIR 'PsychSourceGL/Source/Common/Base/PsychInstrument.c'];
+    S = [S ' ' PTBDIR 'PsychSourceGL/Source/Common/Base/PsychClockDomains.c'];
+    S = [S ' ' PTBDIR 'PsychSourceGL/Source/Common/Base/PsychTrace.c'];
     S = [S ' ' PTBDIR 'PsychSourceGL/Source/Common/Base/PsychMemory.c'];
     S = [S ' ' PTBDIR 'PsychSourceGL/Source/Common/Base/PsychRegisterProject.c'];
     S = [S ' ' PTBDIR 'PsychSourceGL/Source/Common/Base/PsychStructGlue.c'];
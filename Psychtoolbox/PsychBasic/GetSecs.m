@@ -46,13 +46,24 @@ function s=GetSecs(s,subscript)
 %
 % LINUX : _________________________________________________________________
 %
-% On Linux, the gettimeofday() system call is used, which usually has
-% microsecond resolution and accuracy. Linux always chooses the highest
-% precision clock on a system for that call, usually the processors
-% performance counter or the HPET high precision event timer, or the ACPI
-% power management timer - whatever is the best tradeoff between
-% reliability, acccuracy and performance. To our current knowledge, all
-% computers running a Linux 2.6 kernel have reliably working clocks.
+% On Linux, the CLOCK_MONOTONIC clock is used by default, queried via
+% clock_gettime() with nanosecond resolution. A constant offset, measured at
+% startup, is added, so GetSecs returns seconds since 1. January 1970, like
+% the gettimeofday() system call used by older Psychtoolbox versions. Unlike
+% gettimeofday(), GetSecs time can not jump due to changes of system time by
+% the administrator or NTP. Linux always chooses the highest precision clock
+% on a system for these calls, usually the processors performance counter or
+% the HPET high precision event timer, or the ACPI power management timer -
+% whatever is the best tradeoff between reliability, acccuracy and
+% performance. To our current knowledge, all computers running a Linux 2.6
+% kernel have reliably working clocks.
+%
+% The environment variable PSYCH_GETSECS_TIMEBASE allows to select a
+% different timebase before the first Psychtoolbox function is called:
+% 'gettimeofday' for the old gettimeofday() clock, 'realtime' for the same
+% CLOCK_REALTIME clock, but with nanosecond resolution, 'monotonic' for the
+% default, or 'monotonicraw' for CLOCK_MONOTONIC_RAW, which is not slewed
+% by NTP. GetSecs('Timebase') returns the selected timebase.
 %
 %
 % See also: WaitSecs, GetSecsTest, 
@@ -70,5 +81,6 @@ function s=GetSecs(s,subscript)
 % 10/25/05 awi  Divided into general section and OS 9 & Win specific sections.
 %               Imported into OS X PTB.
 % 01/28/08 mk   Updated help texts to match current implementation.
+% 10/18/26 agent Document selectable Linux timebase.
 
 AssertMex('GetSecs.m');
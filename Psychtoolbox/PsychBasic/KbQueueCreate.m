@@ -63,7 +63,9 @@ function KbQueueCreate(deviceNumber, keyList, numValuators, numSlots, flags, win
 %      recording new events. 10000 elements capacity is the default, which may be
 %      too little if you use 'numValuators' > 0 to store dynamic (motion) data like
 %      mouse movements or touchscreen input, which can be generated at rates of
-%      multiple hundred events per second of data collection.
+%      multiple hundred events per second of data collection. The buffer is sized
+%      for 'numSlots' events without valuators. Events with valuators take more
+%      room, so the buffer may be full with fewer than 'numSlots' of them.
 %
 %      'flags' defines special modes of operation for the queue. These are OS
 %      specific, see "PsychHID KbQueueCreate?" for an up to date list of supported
@@ -47,8 +47,16 @@ function r=WaitSecs(s,se)
 % Linux: __________________________________________________________________
 %
 % WaitSecs always uses the POSIX realtime high-precision timing facilities
-% (clock_nanosleep(CLOCK_RT,...)). It sleeps the main MATLAB thread for the
-% given wait period, surrendering CPU time to other processes while waiting.
+% (clock_nanosleep(CLOCK_MONOTONIC,...)). It sleeps the main MATLAB thread
+% until shortly before the end of the wait period, surrendering CPU time to
+% other processes while waiting, then busy-waits for the rest of the wait.
+% How early the sleep ends gets calibrated by measuring the wakeup latency
+% of the operating system after each sleep, separately for normal and for
+% realtime priority, see Priority(). WaitSecs('Statistics') reports how
+% well this works. Setting the environment variable PSYCH_WAITSECS_TIMERFD=1
+% before startup sleeps on a timerfd instead, and PSYCH_WAITSECS_SCHEDFIFO
+% set to a realtime priority level between 1 and 99 temporarily switches to
+% realtime scheduling during each wait, if permitted.
 % WaitSecs is now safe to use at any priority setting.
 %
 % NB.: Use of a modern 2.6.x kernel is recommended, and many modern
@@ -66,4 +74,5 @@ function r=WaitSecs(s,se)
 % 2/4/00    dgp     Updated for Mac OS 9.
 % 7/2/04    awi     Divided into separate sections for OS X, Mac and Windows.  
 % 7/10/04   awi     Edits for clarity.
+% 10/18/26  agent   Linux: Describe calibrated precision waits.
 AssertMex('WaitSecs.m');
@@ -20,8 +20,10 @@
 %   ConvolutionKernelTest           - Test routine for correctness, accuracy and speed of PTB imaging convolution shaders.
 %   DatapixxGPUDitherpatternTest    - Low level diagnostic of GPU dithering bugs via Datapixx et al.
 %   DeinterlacerTest                - Simple correctness test for GLSL video image deinterlacer. INCOMPLETE.
+%   DotsPerFrameBenchmark           - Measure batch drawing throughput of DrawDots, DrawLines and FillRect.
 %   DrawingIntoTexturesTest         - Tests if using a texture as an offscreen window, i.e., for drawing, works.
 %   DrawTextFontSwitchSpeedTest - Test speed of text drawing when switching between different font type/style/size settings.
+%   DrawTexturesBenchmark           - Measure sprites per frame drawn via DrawTextures.
 %   DriftTexturePrecisionTest       - Test subpixel accuracy of texture interpolators: What is the smallest
 %                                     fraction of a pixel that one can scroll, using built-in bilinear interpolation?
 %   eGalaxTrace-*.evemu             - Linux evdev traces with recorded single/multi-touch input from an eGalax touchscreen.
@@ -39,6 +41,7 @@
 %   FloatTexturePrecisionTest       - Test effective precision of floating point 16bpc textures.
 %   FrameSequentialStereoTest       - Test routine for timing and stimulus onset on quad-buffered frame-sequential stereo hardware.
 %   GetCharTest                     - Tests of GetChar.
+%   GetImageAsyncTest               - Test and benchmark asynchronous Screen('GetImage') readback.
 %   GetSecsTest                     - Timing test of clock used by Psychtoolbox, e.g., GetSecs, WaitSecs, Screen...
 %   GraphicsDisplaySyncAcrossDualHeadsTest - Test synchronization of refresh cycles of different display heads.
 %   GraphicsDisplaySyncAcrossDualHeadsTestLinux - Linux version of the test.
@@ -46,16 +49,21 @@
 %   HighColorPrecisionDrawingTest   - Test drawing precision of a variety of Screen() functions, esp. wrt. high precision framebuffers.
 %   HighPrecisionLuminanceOutputDriversImagingPipelineTest - Test precision of a variety of high precision luminance device output drivers.
 %   JavaClockTest                   - Timing test of clock used by Java functions (e.g. GetChar)
+%   KbQueueMergeTest                - Test the merged event buffer of all keyboard queues.
 %   KeyboardLatencyTest             - Get a feeling for keyboard and mouse latency via some sound-based measurement procedure.
 %   LabLuvTest                      - Test routines that convert to CIELAB and CIELUV.
 %   LoadGenerator                   - Create cpu load by spinning in an infinite loop. Used in conjunction with FlipTimingWithRTBoxPhotoDiodeTest.
 %   LosslessMovieWritingTest        - Test lossless encoding and decoding of video in movie files.
+%   MakeTextureAsyncTest            - Test and benchmark asynchronous texture creation by MakeTexture and PreloadTextures.
+%   MakeTextureConversionTest       - Test and benchmark conversion of uint8, uint16, single and double input by MakeTexture.
 %   MakeTextureTimingTest           - Time memory allocation by MakeTexture
 %   MakeTextureTimingTest2          - Time texture creation -> upload -> destruction for given texture by MakeTexture et al.
 %   MatlabTimingTest                - Test for MATLAB timing glitch caused by sigsetjmp().
 %   MelanopsinFundamentalTest       - Test the PTB routines generate a good melanopsin fundamental.
 %   MexTimingLoopTest               - Test for MATLAB timing glitch without return to MATLAB.
 %   MonoImageToSRGBTest             - Test/demo for routine PsychColorimetric/MonoImageToSRGB.
+%   MoviePrefetchBenchmark          - Measure movie playback throughput with frame prefetching.
+%   MovieWriterAsyncTest            - Test and benchmark asynchronous movie writing by AddFrameToMovie.
 %   MultiWindowLockStepTest         - Exercise asynchronous flip scheduling and timestamping on multiple onscreen windows in parallel.
 %   OSAUCSTest                      - Test OSA UCS <-> XYZ conversion routines.
 %   OSXCompositorIdiocyTest         - Test for potential OSX compositor brokeness.
@@ -76,13 +84,16 @@
 %   StandaloneTimingTest            - Test for timing glitch outside of MATLAB process. 
 %   StructsFileTest                 - Test routines for reading and writing struct arrays to text files.
 %   SyncedCLUTUpdateTest            - Visual test of clut write synching to vertical retrace.
+%   TextAtlasTest                   - Test and benchmark text drawing via the glyph atlas.
 %   TextBoundsTest                  - Test Screen('TestBounds')
 %   TextBugTest                     - Look for interference between
 %   TextFontTest                    - Test setting the text font.
 %   TextInitBugTest                 - Test for failure of 'DrawText' default font.
 %   TextInOffscreenWindowTest       - Compare text rendered into onscreen and offscreen windows. 
 %   TextureChannelsTest             - Test assignment of matrix layers to RGBA texture channels
+%   TexturePoolTest                 - Test and benchmark recycling of texture storage via the texture pool.
 %   TextureTest                     - Exercise Screen('DrawTexture').
 %   TrolandTest                     - Colorimetric conversions.
 %   VBLSyncTest                     - Tests syncing of PTB-OSX to the vertical retrace.
+%   VideoCaptureRingTest            - Test and benchmark the video capture frame ring.
 %   WavelengthSamplingTest          - Test conversion between representations of wavelength sampling information.
@@ -0,0 +1,91 @@
+function DotsPerFrameBenchmark(screenid, nFrames, dotCounts)
+% DotsPerFrameBenchmark - Measure batch drawing throughput of DrawDots, DrawLines and FillRect.
+%
+% DotsPerFrameBenchmark([screenid=max][, nFrames=100][, dotCounts=[1000, 10000, 100000, 1000000]])
+%
+% Screen submits the vertices of batch drawing commands like 'DrawDots',
+% 'DrawLines' and multi-rect 'FillRect' via a streaming vertex buffer on
+% desktop OpenGL, with one draw call per batch. This benchmark draws
+% 'nFrames' frames for each number of items in 'dotCounts', with a common
+% color and size, and with per item colors and sizes, and prints the mean
+% time per frame and the resulting number of items per second.
+%
+% Frames are finished via Screen('DrawingFinished', win, 0, 1) and not
+% flipped, so the results are not limited by the display refresh rate.
+%
+% Run the benchmark once with and once without the environment variable
+% PSYCH_VERTEX_STREAM=0 set before starting Matlab or Octave, to compare
+% against the client side vertex arrays used without streaming.
+%
+% With a software renderer like Mesa llvmpipe, e.g., under Xvfb, the
+% results mostly reflect vertex processing on the cpu, not transfers to a
+% graphics card, so compare streaming against client side arrays on the
+% graphics hardware of your experiment setup.
+
+% History:
+% 10/18/26  agent   Written.
+
+if nargin < 1 || isempty(screenid)
+    screenid = max(Screen('Screens'));
+end
+
+if nargin < 2 || isempty(nFrames)
+    nFrames = 100;
+end
+
+if nargin < 3 || isempty(dotCounts)
+    dotCounts = [1000, 10000, 100000, 1000000];
+end
+
+PsychDefaultSetup(1);
+oldsync = Screen('Preference', 'SkipSyncTests', 2);
+oldvisual = Screen('Preference', 'VisualDebugLevel', 0);
+
+try
+    [win, winRect] = Screen('OpenWindow', screenid, 0, [0 0 800 600]);
+    Screen('BlendFunction', win, GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA);
+    [w, h] = RectSize(winRect);
+    rand('seed', 1);
+
+    fprintf('\n%10s  %-30s  %12s  %16s\n', 'Items', 'Command', 'msecs/frame', 'Items/sec');
+
+    for n = dotCounts
+        xy = [rand(1, n) * w; rand(1, n) * h];
+        colors = uint8(rand(4, n) * 255);
+        sizes = 1 + rand(1, n) * 4;
+        rects = [xy; xy + 2];
+
+        BenchOne(win, nFrames, n, 'DrawDots', @() Screen('DrawDots', win, xy, 2, 255));
+        BenchOne(win, nFrames, n, 'DrawDots colors', @() Screen('DrawDots', win, xy, 2, colors));
+        BenchOne(win, nFrames, n, 'DrawDots colors+sizes, type 3', @() Screen('DrawDots', win, xy, sizes, colors, [], 3));
+        BenchOne(win, nFrames, n, 'DrawLines colors', @() Screen('DrawLines', win, xy, 1, colors));
+        BenchOne(win, nFrames, n, 'FillRect colors', @() Screen('FillRect', win, colors, rects));
+    end
+
+    sca;
+catch
+    sca;
+    Screen('Preference', 'SkipSyncTests', oldsync);
+    Screen('Preference', 'VisualDebugLevel', oldvisual);
+    psychrethrow(psychlasterror);
+end
+
+Screen('Preference', 'SkipSyncTests', oldsync);
+Screen('Preference', 'VisualDebugLevel', oldvisual);
+
+return;
+
+function BenchOne(win, nFrames, n, name, drawcmd)
+% Warmup, so buffer allocation doesn't count:
+drawcmd();
+Screen('DrawingFinished', win, 0, 1);
+
+tStart = GetSecs;
+for frame = 1:nFrames
+    drawcmd();
+    Screen('DrawingFinished', win, 0, 1);
+end
+t = (GetSecs - tStart) / nFrames;
+
+fprintf('%10i  %-30s  %12.3f  %16.0f\n', n, name, t * 1000, n / t);
+return;
@@ -0,0 +1,126 @@
+function DrawTexturesBenchmark(nSprites, nFrames, screenid)
+% DrawTexturesBenchmark - Measure sprites per frame drawn via Screen('DrawTextures').
+%
+% DrawTexturesBenchmark([nSprites=[100, 1000, 10000]][, nFrames=100][, screenid=max])
+%
+% Screen('DrawTextures') draws many copies of one texture without any
+% shader, e.g., sprites for a visual search display, as instances of a
+% single unit quad. The destination rectangle, rotation and modulate color
+% of all sprites are uploaded once per call, and all sprites are drawn in
+% one draw call. Textures with shaders, e.g., procedural Gabor patches,
+% are drawn in immediate mode as before.
+%
+% The benchmark first checks that one 'DrawTextures' call draws the same
+% image as a loop of 'DrawTexture' calls, for sprites with different
+% colors. Then, for each number of sprites in 'nSprites', it draws that
+% many small rotated sprites with individual colors for 'nFrames' frames,
+% once via one 'DrawTextures' call per frame, and once via one
+% 'DrawTexture' call per sprite, and prints the mean time per frame and
+% the number of sprites per second. Frames are finished via
+% Screen('DrawingFinished', win, 0, 1), which waits for the gpu to finish
+% drawing, and not flipped, so the results are not limited by the display
+% refresh rate.
+%
+% With the environment variable PSYCH_VERTEX_STREAM=0, 'DrawTextures'
+% draws each sprite in immediate mode instead. Screen reads the variable
+% once when it gets loaded, so for a second run to compare against, call
+% setenv('PSYCH_VERTEX_STREAM', '0') followed by 'clear Screen'.
+%
+% The consistency check tolerates differences in up to 1% of all pixels,
+% as the instanced and the immediate mode path may rasterize sprite edges
+% slightly differently.
+
+% History:
+% 10/18/26  agent   Written.
+
+if nargin < 1 || isempty(nSprites)
+    nSprites = [100, 1000, 10000];
+end
+
+if nargin < 2 || isempty(nFrames)
+    nFrames = 100;
+end
+
+if nargin < 3 || isempty(screenid)
+    screenid = max(Screen('Screens'));
+end
+
+PsychDefaultSetup(1);
+oldsync = Screen('Preference', 'SkipSyncTests', 2);
+oldvisual = Screen('Preference', 'VisualDebugLevel', 0);
+
+try
+    [win, winRect] = Screen('OpenWindow', screenid, 0, [0 0 800 600]);
+    [w, h] = RectSize(winRect);
+
+    % 16 x 16 pixels sprite: A white disc on transparent background.
+    [x, y] = meshgrid(-7.5:7.5, -7.5:7.5);
+    sprite = 255 * ones(16, 16, 2);
+    sprite(:, :, 2) = 255 * (sqrt(x.^2 + y.^2) < 7);
+    tex = Screen('MakeTexture', win, sprite);
+    Screen('BlendFunction', win, 'GL_SRC_ALPHA', 'GL_ONE_MINUS_SRC_ALPHA');
+
+    % Consistency of 'DrawTextures' and a loop of 'DrawTexture', with nearest neighbour filtering:
+    rand('seed', 1);
+    n = 200;
+    dstRects = CenterRectOnPoint([0 0 16 16], round(rand(1, n) * (w - 16) + 8), round(rand(1, n) * (h - 16) + 8))';
+    colors = round(rand(3, n) * 255);
+
+    Screen('FillRect', win, 0);
+    Screen('DrawTextures', win, tex, [], dstRects, [], 0, [], colors);
+    img1 = double(Screen('GetImage', win, [], 'backBuffer'));
+
+    Screen('FillRect', win, 0);
+    for i = 1:n
+        Screen('DrawTexture', win, tex, [], dstRects(:, i), [], 0, [], colors(:, i));
+    end
+    img2 = double(Screen('GetImage', win, [], 'backBuffer'));
+
+    nDiff = sum(any(abs(img1 - img2) > 1, 3));
+    nDiff = sum(nDiff(:));
+    if nDiff > 0.01 * numel(img1(:, :, 1))
+        error('DrawTextures and DrawTexture images differ in %i pixels!', nDiff);
+    end
+    fprintf('DrawTextures and DrawTexture images match, %i pixels differ.\n', nDiff);
+
+    for n = nSprites
+        dstRects = CenterRectOnPoint([0 0 16 16], rand(1, n) * w, rand(1, n) * h)';
+        angles = rand(1, n) * 360;
+        colors = round(rand(3, n) * 255);
+
+        % Warmup, so shader creation doesn't count:
+        Screen('DrawTextures', win, tex, [], dstRects, angles, 1, [], colors);
+        Screen('DrawingFinished', win, 0, 1);
+
+        tStart = GetSecs;
+        for frame = 1:nFrames
+            Screen('DrawTextures', win, tex, [], dstRects, angles + frame, 1, [], colors);
+            Screen('DrawingFinished', win, 0, 1);
+        end
+        tBatch = (GetSecs - tStart) / nFrames;
+
+        tStart = GetSecs;
+        for frame = 1:nFrames
+            for i = 1:n
+                Screen('DrawTexture', win, tex, [], dstRects(:, i), angles(i) + frame, 1, [], colors(:, i));
+            end
+            Screen('DrawingFinished', win, 0, 1);
+        end
+        tSingle = (GetSecs - tStart) / nFrames;
+
+        fprintf('%i sprites: DrawTextures %.3f msecs/frame, %.0f sprites/sec. DrawTexture loop %.3f msecs/frame, %.0f sprites/sec.\n', ...
+                n, tBatch * 1000, n / tBatch, tSingle * 1000, n / tSingle);
+    end
+
+    sca;
+catch
+    sca;
+    Screen('Preference', 'SkipSyncTests', oldsync);
+    Screen('Preference', 'VisualDebugLevel', oldvisual);
+    psychrethrow(psychlasterror);
+end
+
+Screen('Preference', 'SkipSyncTests', oldsync);
+Screen('Preference', 'VisualDebugLevel', oldvisual);
+
+return;
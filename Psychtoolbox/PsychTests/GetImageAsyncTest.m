@@ -0,0 +1,109 @@
+function GetImageAsyncTest(screenid, depth)
+% GetImageAsyncTest - Test and benchmark asynchronous Screen('GetImage').
+%
+% GetImageAsyncTest([screenid=max][, depth=2])
+%
+% Draws a sequence of random images into an offscreen window and reads them
+% back with synchronous and asynchronous Screen('GetImage') calls, with the
+% 'asyncDepth' parameter set to 'depth'. Asynchronous readback must return
+% empty matrices for the first 'depth' calls, then exactly the images which
+% synchronous readback returned 'depth' calls earlier, for all combinations
+% of 'nrchannels' and 'floatprecision'. Then the image of the last frame is
+% compared against the uploaded random image, to verify the orientation of
+% the returned images.
+%
+% Finally the time per frame for synchronous and asynchronous readback of
+% the full onscreen window after each Screen('Flip') is measured.
+%
+% The comparisons don't need a real display, e.g., they also pass under
+% Xvfb with Mesa llvmpipe. The timings only show the benefit of
+% asynchronous readback with a graphics card, as a software renderer has
+% no transfer from video memory to hide.
+
+% History:
+% 10/18/26  agent   Written.
+
+if nargin < 1 || isempty(screenid)
+    screenid = max(Screen('Screens'));
+end
+
+if nargin < 2 || isempty(depth)
+    depth = 2;
+end
+
+PsychDefaultSetup(1);
+oldsync = Screen('Preference', 'SkipSyncTests', 2);
+oldvisual = Screen('Preference', 'VisualDebugLevel', 0);
+nframes = 10;
+failed = 0;
+
+try
+    win = Screen('OpenWindow', screenid, 0, [0 0 640 480]);
+    offwin = Screen('OpenOffscreenWindow', win, 0, [0 0 321 203]);
+    rand('seed', 1);
+
+    for nrchannels = 1:4
+        for floatprecision = 0:1
+            sync = cell(1, nframes);
+            for i = 1:nframes
+                img = uint8(rand(203, 321, 3) * 255);
+                Screen('PutImage', offwin, img);
+                sync{i} = Screen('GetImage', offwin, [], [], floatprecision, nrchannels);
+                async = Screen('GetImage', offwin, [], [], floatprecision, nrchannels, depth);
+
+                if i <= depth
+                    ok = isempty(async);
+                else
+                    ok = isequal(async, sync{i - depth});
+                end
+
+                if ~ok
+                    fprintf('FAIL: nrchannels %i, floatprecision %i: Async image of frame %i wrong.\n', nrchannels, floatprecision, i);
+                    failed = failed + 1;
+                end
+            end
+
+            % Check orientation and content of last image, as far as the framebuffer has channels for it:
+            if floatprecision
+                ref = double(img) / 255;
+                ok = max(max(max(abs(sync{nframes}(:, :, 1:min(nrchannels, 3)) - ref(:, :, 1:min(nrchannels, 3)))))) < 1 / 512;
+            else
+                ok = isequal(sync{nframes}(:, :, 1:min(nrchannels, 3)), img(:, :, 1:min(nrchannels, 3)));
+            end
+
+            if (nrchannels ~= 2) && ~ok
+                fprintf('FAIL: nrchannels %i, floatprecision %i: Readback differs from uploaded image.\n', nrchannels, floatprecision);
+                failed = failed + 1;
+            end
+        end
+    end
+
+    % Benchmark full window readback after each flip:
+    for asyncDepth = [0, depth]
+        for i = 1:100 + asyncDepth
+            Screen('FillRect', win, mod(i, 256));
+            Screen('Flip', win);
+            if i == asyncDepth + 1
+                t = GetSecs;
+            end
+            Screen('GetImage', win, [], 'frontBuffer', 0, 3, asyncDepth);
+        end
+        fprintf('asyncDepth %i: %f msecs per flip + GetImage.\n', asyncDepth, (GetSecs - t) * 10);
+    end
+
+    sca;
+catch
+    sca;
+    Screen('Preference', 'SkipSyncTests', oldsync);
+    Screen('Preference', 'VisualDebugLevel', oldvisual);
+    psychrethrow(psychlasterror);
+end
+
+Screen('Preference', 'SkipSyncTests', oldsync);
+Screen('Preference', 'VisualDebugLevel', oldvisual);
+
+if failed
+    error('GetImageAsyncTest: %i checks FAILED!', failed);
+end
+
+fprintf('GetImageAsyncTest: All checks passed.\n');
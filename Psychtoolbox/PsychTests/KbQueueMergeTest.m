@@ -0,0 +1,134 @@
+function KbQueueMergeTest(duration)
+% KbQueueMergeTest - Test the merged event buffer of all keyboard queues.
+%
+% KbQueueMergeTest([duration=10])
+%
+% Creates and starts a keyboard queue for each keyboard, enables the merged
+% event buffer via PsychHID('KbQueueMerge', 1), and asks you to type on one
+% or more of your keyboards for 'duration' seconds. Typing on multiple
+% keyboards at the same time, e.g., a keyboard and a response pad, gives
+% the most thorough test.
+%
+% Then it fetches all events via PsychHID('KbQueueGetMergedEvents') and
+% checks that they are ordered by time, and that the merged events of each
+% keyboard are identical to the events fetched from that keyboard's own
+% queue via KbEventGet(). It also checks that flushing and disabling the
+% merged buffer via PsychHID('KbQueueMerge', 2) and PsychHID('KbQueueMerge', 0)
+% discards all pending events, and that invalid 'numSlots' are rejected.
+
+% History:
+% 10/18/26  agent   Written.
+
+if nargin < 1 || isempty(duration)
+    duration = 10;
+end
+
+KbName('UnifyKeyNames');
+keyboards = GetKeyboardIndices;
+if isempty(keyboards)
+    error('No keyboards found!');
+end
+
+% Start from a disabled merged buffer:
+PsychHID('KbQueueMerge', 0);
+
+% numSlots must be at least 1:
+try
+    PsychHID('KbQueueMerge', 1, 0);
+    error('PsychHID(''KbQueueMerge'', 1, 0) did not reject numSlots = 0!');
+catch
+    err = psychlasterror;
+    if ~isempty(strfind(err.message, 'did not reject'))
+        psychrethrow(err);
+    end
+end
+
+[oldEnable, navail] = PsychHID('KbQueueMerge', 1, 100000);
+if oldEnable ~= 0 || navail ~= 0
+    error('Merged buffer was not disabled before the test!');
+end
+
+try
+    for k = keyboards
+        KbQueueCreate(k);
+        KbQueueStart(k);
+    end
+
+    fprintf('Type on one or more of your %i keyboards for the next %i seconds...\n', length(keyboards), duration);
+    WaitSecs(duration);
+
+    for k = keyboards
+        KbQueueStop(k);
+    end
+
+    merged = PsychHID('KbQueueGetMergedEvents');
+    fprintf('%i merged events recorded.\n', length(merged));
+    if isempty(merged)
+        error('No events recorded. Did you type anything?');
+    end
+
+    % Merged events must be ordered by time:
+    if any(diff([merged.Time]) < 0)
+        error('Merged events are not ordered by time!');
+    end
+
+    % Merged events of each keyboard must be identical to its own queue events:
+    for k = keyboards
+        mine = merged([merged.DeviceIndex] == k);
+        n = 0;
+        while 1
+            evt = KbEventGet(k);
+            if isempty(evt)
+                break;
+            end
+
+            n = n + 1;
+            if n > length(mine) || mine(n).Time ~= evt.Time || mine(n).Keycode ~= evt.Keycode || mine(n).Pressed ~= evt.Pressed
+                error('Merged event %i of keyboard %i differs from the keyboard queue event!', n, k);
+            end
+        end
+
+        if n ~= length(mine)
+            error('Keyboard %i: %i merged events, but %i keyboard queue events!', k, length(mine), n);
+        end
+
+        if n > 0
+            fprintf('Keyboard %i: %i events match.\n', k, n);
+        end
+    end
+
+    % Flush discards all pending events, but keeps the merged buffer enabled:
+    for k = keyboards
+        KbQueueStart(k);
+    end
+    fprintf('Type some more for 2 seconds...\n');
+    WaitSecs(2);
+    for k = keyboards
+        KbQueueStop(k);
+    end
+
+    PsychHID('KbQueueMerge', 2);
+    [enabled, navail] = PsychHID('KbQueueMerge');
+    if enabled ~= 1 || navail ~= 0
+        error('Flush of merged buffer failed, %i events left!', navail);
+    end
+
+    PsychHID('KbQueueMerge', 0);
+    if PsychHID('KbQueueMerge') ~= 0
+        error('Disable of merged buffer failed!');
+    end
+
+    for k = keyboards
+        KbQueueRelease(k);
+    end
+catch
+    PsychHID('KbQueueMerge', 0);
+    for k = keyboards
+        KbQueueRelease(k);
+    end
+    psychrethrow(psychlasterror);
+end
+
+fprintf('KbQueueMergeTest passed.\n');
+
+return;
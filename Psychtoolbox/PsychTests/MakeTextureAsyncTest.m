@@ -0,0 +1,122 @@
+function MakeTextureAsyncTest(screenid, ntextures, width, height)
+% MakeTextureAsyncTest - Test and benchmark asynchronous texture creation.
+%
+% MakeTextureAsyncTest([screenid=max][, ntextures=50][, width=1920][, height=1080])
+%
+% Creates 'ntextures' textures of 'width' x 'height' pixels from random RGB
+% images, once synchronously, and once asynchronously via Screen('MakeTexture')
+% with 'specialFlags' 64. Prints the time spent in 'MakeTexture' calls for
+% both cases, and the time until Screen('PreloadTextures') reports completion
+% of all asynchronous texture creations when polled with 'dontWait' = 1.
+%
+% Then the content of asynchronously created textures is compared against
+% synchronously created ones via Screen('GetImage'), for uint8, uint16,
+% single and double input with 1 to 4 layers, and 8 bpc and 32 bpc float
+% precision. Also checks that closing textures whose creation is still in
+% progress works.
+%
+% Asynchronous creation needs desktop OpenGL with pixel buffer objects and
+% a shared upload context for the window. Without those, e.g., on OpenGL-ES,
+% all textures are created synchronously, so the content checks still pass,
+% but both timings are about the same.
+
+% History:
+% 10/18/26  agent   Written.
+
+if nargin < 1 || isempty(screenid)
+    screenid = max(Screen('Screens'));
+end
+
+if nargin < 2 || isempty(ntextures)
+    ntextures = 50;
+end
+
+if nargin < 3 || isempty(width)
+    width = 1920;
+end
+
+if nargin < 4 || isempty(height)
+    height = 1080;
+end
+
+PsychDefaultSetup(1);
+oldsync = Screen('Preference', 'SkipSyncTests', 2);
+oldvisual = Screen('Preference', 'VisualDebugLevel', 0);
+failed = 0;
+
+try
+    win = Screen('OpenWindow', screenid, 0, [0 0 640 480]);
+    Screen('ColorRange', win, 1, [], 1);
+    rand('seed', 1);
+    img = rand(height, width, 3);
+
+    % Benchmark: Time spent in MakeTexture for synchronous and asynchronous creation:
+    for specialFlags = [0, 64]
+        tex = zeros(1, ntextures);
+        t = GetSecs;
+        for i = 1:ntextures
+            tex(i) = Screen('MakeTexture', win, img, [], specialFlags);
+        end
+        tcreate = GetSecs - t;
+
+        % Poll for completion, as a script would do while showing instructions:
+        while ~Screen('PreloadTextures', win, tex, 1)
+            WaitSecs('YieldSecs', 0.001);
+        end
+        tdone = GetSecs - t;
+
+        fprintf('specialFlags %2i: %f msecs in MakeTexture per texture, all %i textures ready after %f msecs.\n', ...
+                specialFlags, tcreate * 1000 / ntextures, ntextures, tdone * 1000);
+        Screen('Close', tex);
+    end
+
+    % Closing textures with pending asynchronous creation must work:
+    tex = zeros(1, 10);
+    for i = 1:10
+        tex(i) = Screen('MakeTexture', win, img, [], 64);
+    end
+    Screen('Close', tex);
+
+    % Compare content of asynchronously and synchronously created textures:
+    img16 = uint16(floor(rand(61, 97, 4) * 65536));
+    imgd = double(img16) / 65535;
+
+    for planes = 1:4
+        nch = 1 + 2 * (planes > 2);
+        for floatprecision = [0, 2]
+            inputs = {uint8(imgd(:, :, 1:planes) * 255), img16(:, :, 1:planes), single(imgd(:, :, 1:planes)), imgd(:, :, 1:planes)};
+            for i = 1:numel(inputs)
+                if floatprecision && isa(inputs{i}, 'uint8')
+                    continue;
+                end
+
+                tex = Screen('MakeTexture', win, inputs{i}, [], 0, floatprecision);
+                atex = Screen('MakeTexture', win, inputs{i}, [], 64, floatprecision);
+                ref = Screen('GetImage', tex, [], [], floatprecision > 0, nch);
+                out = Screen('GetImage', atex, [], [], floatprecision > 0, nch);
+                Screen('Close', [tex, atex]);
+
+                if ~isequal(ref, out)
+                    fprintf('FAIL: %s input, %i planes, floatprecision %i: Async texture content differs.\n', class(inputs{i}), planes, floatprecision);
+                    failed = failed + 1;
+                end
+            end
+        end
+    end
+
+    sca;
+catch
+    sca;
+    Screen('Preference', 'SkipSyncTests', oldsync);
+    Screen('Preference', 'VisualDebugLevel', oldvisual);
+    psychrethrow(psychlasterror);
+end
+
+Screen('Preference', 'SkipSyncTests', oldsync);
+Screen('Preference', 'VisualDebugLevel', oldvisual);
+
+if failed
+    error('MakeTextureAsyncTest: %i checks FAILED!', failed);
+end
+
+fprintf('MakeTextureAsyncTest: All checks passed.\n');
@@ -0,0 +1,111 @@
+function results = MakeTextureConversionTest(screenid, width, height)
+% MakeTextureConversionTest - Test and benchmark MakeTexture input conversion.
+%
+% results = MakeTextureConversionTest([screenid=max][, width=1920][, height=1080])
+%
+% First runs Screen('MakeTextureBenchmark') for a 'width' x 'height' pixels
+% image and prints the conversion speed in Megapixels per second for each
+% combination of input type (uint8, uint16, single, double), number of
+% layers and output precision. This part needs no window or graphics
+% hardware. The struct array 'results' of the benchmark is returned.
+%
+% Then, unless 'screenid' is -1, a window is opened and textures are
+% created from the same random images as uint8, uint16, single and double
+% matrices, with 1 to 4 layers, for 8 bpc and 32 bpc float precision. The
+% texture content is read back via Screen('GetImage') and compared against
+% the expected values, to verify conversion, interleaving and channel
+% order of all code paths. uint16 input is normalized to the range 0 - 1.
+%
+% Only the second part depends on the graphics driver, as it reads the
+% textures back via Screen('GetImage'). Pass 'screenid' -1 to only run the
+% benchmark, e.g., on a machine without a display.
+%
+% Set the environment variable PSYCH_CONVERSION_THREADS=1 before starting
+% Matlab or Octave to benchmark single-threaded conversion.
+
+% History:
+% 10/18/26  agent   Written.
+
+if nargin < 1 || isempty(screenid)
+    screenid = max(Screen('Screens'));
+end
+
+if nargin < 2 || isempty(width)
+    width = 1920;
+end
+
+if nargin < 3 || isempty(height)
+    height = 1080;
+end
+
+results = Screen('MakeTextureBenchmark', width, height);
+fprintf('MakeTexture conversion of %i x %i pixels, %i threads:\n', width, height, results(1).threads);
+fprintf('Input    Planes  Output    msecs    MPix/s\n');
+outputs = {'uint8', 'float'};
+for r = results
+    fprintf('%-8s %6i  %-6s %8.3f %9.1f\n', r.inputType, r.planes, outputs{r.floatOutput + 1}, r.msecs, r.megaPixelsPerSec);
+end
+
+if screenid < 0
+    return;
+end
+
+PsychDefaultSetup(1);
+oldsync = Screen('Preference', 'SkipSyncTests', 2);
+oldvisual = Screen('Preference', 'VisualDebugLevel', 0);
+failed = 0;
+
+try
+    win = Screen('OpenWindow', screenid, 0, [0 0 640 480]);
+    % Apply ColorRange to double input, so single and double values 0 - 1 map to 0 - 255:
+    Screen('ColorRange', win, 1, [], 1);
+    rand('seed', 1);
+    img16 = uint16(floor(rand(61, 97, 4) * 65536));
+    imgd = double(img16) / 65535;
+
+    for planes = 1:4
+        % Readback of the color channels only, alpha is not returned for luminance textures:
+        nch = 1 + 2 * (planes > 2);
+        for floatprecision = [0, 2]
+            inputs = {uint8(imgd(:, :, 1:planes) * 255), img16(:, :, 1:planes), single(imgd(:, :, 1:planes)), imgd(:, :, 1:planes)};
+            for i = 1:numel(inputs)
+                if floatprecision && isa(inputs{i}, 'uint8')
+                    continue;
+                end
+
+                tex = Screen('MakeTexture', win, inputs{i}, [], [], floatprecision);
+                out = Screen('GetImage', tex, [], [], 1, nch);
+                Screen('Close', tex);
+
+                % 8 bpc textures may round or truncate, depending on gpu:
+                ref = imgd(:, :, 1:nch);
+                if floatprecision
+                    ok = max(abs(out(:) - ref(:))) < 1e-5;
+                else
+                    ok = max(abs(out(:) - ref(:))) <= 1 / 255 + 1e-6;
+                end
+
+                if ~ok
+                    fprintf('FAIL: %s input, %i planes, floatprecision %i: Texture content wrong.\n', class(inputs{i}), planes, floatprecision);
+                    failed = failed + 1;
+                end
+            end
+        end
+    end
+
+    sca;
+catch
+    sca;
+    Screen('Preference', 'SkipSyncTests', oldsync);
+    Screen('Preference', 'VisualDebugLevel', oldvisual);
+    psychrethrow(psychlasterror);
+end
+
+Screen('Preference', 'SkipSyncTests', oldsync);
+Screen('Preference', 'VisualDebugLevel', oldvisual);
+
+if failed
+    error('MakeTextureConversionTest: %i checks FAILED!', failed);
+end
+
+fprintf('MakeTextureConversionTest: All checks passed.\n');
@@ -0,0 +1,118 @@
+function MoviePrefetchBenchmark(moviename, nMovies, nFrames, screenid)
+% MoviePrefetchBenchmark - Measure movie playback throughput with frame prefetching.
+%
+% MoviePrefetchBenchmark([moviename][, nMovies=1][, nFrames=300][, screenid=max])
+%
+% During movie playback with the GStreamer engine, decoded video frames are
+% uploaded into textures in the background, by the texture upload thread of
+% the onscreen window, for up to 3 frames ahead. Screen('GetMovieImage') then
+% only needs to return the texture of the oldest prefetched frame, instead
+% of uploading the frame itself.
+%
+% This benchmark plays 'nMovies' instances of the movie file 'moviename'
+% simultaneously, fetches and draws 'nFrames' frames of each movie as fast
+% as possible, and prints the mean time spent in Screen('GetMovieImage') and
+% the achieved number of frames per second. Playback runs at the highest
+% possible rate without sound, and without sync of flips to the display
+% refresh, so the results are not limited by the display refresh rate.
+%
+% If 'moviename' is omitted, a 10 seconds 3840 x 2160 pixels 4K test movie
+% with a moving ball is created from a GStreamer videotestsrc in the
+% temporary directory, via the gst-launch-1.0 command line tool.
+%
+% The environment variable PSYCH_MOVIE_PREFETCH=0 disables prefetching, and
+% PSYCH_MOVIE_PREFETCH=n prefetches n frames instead of 3. Screen reads it
+% when the first movie starts playing, so to compare different settings,
+% call setenv('PSYCH_MOVIE_PREFETCH', '0') and 'clear Screen' between runs.
+%
+% Decoding of 4K video is expensive, so with several movies the decoder can
+% become the bottleneck, and prefetching then helps less.
+
+% History:
+% 10/18/26  agent   Written.
+
+if nargin < 1 || isempty(moviename)
+    moviename = [tempdir 'PTB4KTestMovie.avi'];
+    if ~exist(moviename, 'file')
+        fprintf('Creating 4K test movie %s ...\n', moviename);
+        cmd = sprintf('gst-launch-1.0 -q videotestsrc num-buffers=300 pattern=ball ! video/x-raw,width=3840,height=2160,framerate=30/1 ! jpegenc ! avimux ! filesink location="%s"', moviename);
+        if system(cmd) ~= 0
+            error('Failed to create test movie via gst-launch-1.0! Please provide a moviename instead.');
+        end
+    end
+end
+
+if nargin < 2 || isempty(nMovies)
+    nMovies = 1;
+end
+
+if nargin < 3 || isempty(nFrames)
+    nFrames = 300;
+end
+
+if nargin < 4 || isempty(screenid)
+    screenid = max(Screen('Screens'));
+end
+
+PsychDefaultSetup(1);
+oldsync = Screen('Preference', 'SkipSyncTests', 2);
+oldvisual = Screen('Preference', 'VisualDebugLevel', 0);
+
+try
+    [win, winRect] = Screen('OpenWindow', screenid, 0, [0 0 1280 720]);
+
+    movies = zeros(1, nMovies);
+    for i = 1:nMovies
+        movies(i) = Screen('OpenMovie', win, moviename);
+    end
+
+    % Play at maximum speed, without sound:
+    for i = 1:nMovies
+        Screen('PlayMovie', movies(i), 1, 1, 0);
+    end
+
+    % Layout of movies side by side:
+    dstRects = zeros(4, nMovies);
+    for i = 1:nMovies
+        dstRects(:, i) = [(i - 1) * RectWidth(winRect) / nMovies, 0, i * RectWidth(winRect) / nMovies, RectHeight(winRect)];
+    end
+
+    fetchTime = 0;
+    count = 0;
+    tStart = GetSecs;
+    for frame = 1:nFrames
+        for i = 1:nMovies
+            t = GetSecs;
+            tex = Screen('GetMovieImage', win, movies(i), 1);
+            fetchTime = fetchTime + (GetSecs - t);
+            if tex <= 0
+                continue;
+            end
+
+            Screen('DrawTexture', win, tex, [], dstRects(:, i));
+            Screen('Close', tex);
+            count = count + 1;
+        end
+        Screen('Flip', win, 0, 0, 2);
+    end
+    tTotal = GetSecs - tStart;
+
+    fprintf('%i movies, %i frames fetched: %.3f msecs per GetMovieImage, %.1f frames/sec overall.\n', nMovies, count, fetchTime / count * 1000, count / tTotal);
+
+    for i = 1:nMovies
+        Screen('PlayMovie', movies(i), 0);
+        Screen('CloseMovie', movies(i));
+    end
+
+    sca;
+catch
+    sca;
+    Screen('Preference', 'SkipSyncTests', oldsync);
+    Screen('Preference', 'VisualDebugLevel', oldvisual);
+    psychrethrow(psychlasterror);
+end
+
+Screen('Preference', 'SkipSyncTests', oldsync);
+Screen('Preference', 'VisualDebugLevel', oldvisual);
+
+return;
@@ -0,0 +1,100 @@
+function MovieWriterAsyncTest(nFrames, screenid, codec)
+% MovieWriterAsyncTest - Test and benchmark asynchronous movie writing.
+%
+% MovieWriterAsyncTest([nFrames=300][, screenid=max][, codec])
+%
+% Screen('AddFrameToMovie', ..., asyncDepth) with 'asyncDepth' > 0 reads
+% back video frames into pixel buffers in the background, and hands them to
+% a writer thread of the movie once the transfer is finished. The writer
+% thread copies the frames and feeds them to the GStreamer encoder, with a
+% bounded queue of frames. If the queue is full, further frames either wait
+% for the encoder, or get dropped if the movie was created with the keyword
+% 'WriterDropFrames' in 'movieOptions'.
+%
+% The test records 'nFrames' frames of a moving square, drawn into a
+% 1280 x 720 pixels onscreen window, into three movie files in the temporary
+% directory: Once with synchronous 'AddFrameToMovie', once asynchronous with
+% waiting for the encoder, and once asynchronous with dropping of frames.
+% For each run it prints the time per Screen('Flip') + 'AddFrameToMovie',
+% and the number of written and dropped frames and the readback to encoder
+% latency, as returned by Screen('FinalizeMovie'). Without dropping, all
+% 'nFrames' frames must be written. The optional 'codec' is passed as
+% ':CodecType=' in 'movieOptions'. It defaults to the default encoder.
+%
+% The movie files get deleted after each run. Pass a slow 'codec' to see
+% the difference between waiting for the encoder and dropping of frames.
+
+% History:
+% 10/18/26  agent   Written.
+
+if nargin < 1 || isempty(nFrames)
+    nFrames = 300;
+end
+
+if nargin < 2 || isempty(screenid)
+    screenid = max(Screen('Screens'));
+end
+
+if nargin < 3
+    codec = [];
+end
+
+PsychDefaultSetup(1);
+oldsync = Screen('Preference', 'SkipSyncTests', 2);
+oldvisual = Screen('Preference', 'VisualDebugLevel', 0);
+failed = 0;
+
+names = {'synchronous', 'asynchronous', 'asynchronous + drop'};
+asyncDepths = [0, 2, 2];
+options = {'', 'WriterQueueDepth=8', 'WriterQueueDepth=8 WriterDropFrames'};
+
+try
+    win = Screen('OpenWindow', screenid, 0, [0 0 1280 720]);
+
+    for run = 1:3
+        moviename = sprintf('%sPTBMovieWriterAsyncTest%i.mov', tempdir, run);
+        movieOptions = options{run};
+        if ~isempty(codec)
+            movieOptions = [movieOptions ' :CodecType=' codec];
+        end
+
+        movie = Screen('CreateMovie', win, moviename, [], [], 30, movieOptions);
+
+        t = GetSecs;
+        for i = 1:nFrames
+            Screen('FillRect', win, [0 0 mod(i, 256)]);
+            Screen('FillRect', win, 255, OffsetRect([0 0 100 100], mod(i * 8, 1180), 310));
+            % Don't sync flips to the display refresh, so encoding speed is the limit:
+            Screen('Flip', win, [], [], 2);
+            Screen('AddFrameToMovie', win, [], 'frontBuffer', movie, 1, asyncDepths(run));
+        end
+        t = (GetSecs - t) / nFrames;
+
+        [framesWritten, framesDropped, meanLatency, maxLatency] = Screen('FinalizeMovie', movie);
+        fprintf('%s: %f msecs per flip + AddFrameToMovie. %i frames written, %i dropped. Latency mean %f msecs, max %f msecs.\n', ...
+                names{run}, t * 1000, framesWritten, framesDropped, meanLatency * 1000, maxLatency * 1000);
+
+        if framesWritten + framesDropped ~= nFrames || (run < 3 && framesDropped > 0)
+            fprintf('FAIL: %s: Expected %i written frames, but %i written and %i dropped.\n', names{run}, nFrames, framesWritten, framesDropped);
+            failed = failed + 1;
+        end
+
+        delete(moviename);
+    end
+
+    sca;
+catch
+    sca;
+    Screen('Preference', 'SkipSyncTests', oldsync);
+    Screen('Preference', 'VisualDebugLevel', oldvisual);
+    psychrethrow(psychlasterror);
+end
+
+Screen('Preference', 'SkipSyncTests', oldsync);
+Screen('Preference', 'VisualDebugLevel', oldvisual);
+
+if failed
+    error('MovieWriterAsyncTest: %i checks FAILED!', failed);
+end
+
+fprintf('MovieWriterAsyncTest: All checks passed.\n');
@@ -0,0 +1,117 @@
+function TextAtlasTest(screenid, nLabels, nFrames)
+% TextAtlasTest - Test and benchmark text drawing via the glyph atlas.
+%
+% TextAtlasTest([screenid=max][, nLabels=500][, nFrames=100])
+%
+% With the default FTGL based text renderer plugin on desktop OpenGL,
+% Screen('DrawText') draws untransformed text from a per-font glyph atlas
+% texture, with one draw call per string, and caches the glyph layout and
+% bounding box of recently drawn or measured strings, which are then also
+% used by Screen('TextBounds').
+%
+% The test first checks that Screen('TextBounds') returns the same results
+% for repeated measurements of the same strings, ie., uncached and cached,
+% and that the text cursor position returned by Screen('DrawText') advances
+% by the 'xAdvance' returned by Screen('TextBounds'). Then it draws
+% 'nLabels' short numeric labels, as in a scatter plot or a grid of item
+% numbers, for 'nFrames' frames and prints the mean time per frame, once
+% with the same labels in each frame, and once with new labels in each
+% frame. Frames are finished via Screen('DrawingFinished', win, 0, 1) and
+% not flipped, so the results are not limited by the display refresh rate.
+%
+% With the environment variable PSYCH_TEXT_ATLAS=0, the plugin draws all
+% text itself again. Screen reads the variable once when it gets loaded,
+% so to compare against the plugin, call setenv('PSYCH_TEXT_ATLAS', '0')
+% followed by 'clear Screen', then run the test again.
+%
+% The test checks 'TextBounds' only against itself, not against reference
+% values, as glyph metrics depend on the installed fonts.
+
+% History:
+% 10/18/26  agent   Written.
+
+if nargin < 1 || isempty(screenid)
+    screenid = max(Screen('Screens'));
+end
+
+if nargin < 2 || isempty(nLabels)
+    nLabels = 500;
+end
+
+if nargin < 3 || isempty(nFrames)
+    nFrames = 100;
+end
+
+PsychDefaultSetup(1);
+oldsync = Screen('Preference', 'SkipSyncTests', 2);
+oldvisual = Screen('Preference', 'VisualDebugLevel', 0);
+
+try
+    [win, winRect] = Screen('OpenWindow', screenid, 0, [0 0 800 600]);
+    [w, h] = RectSize(winRect);
+    Screen('TextSize', win, 14);
+
+    % Consistency of uncached and cached measurements, and of text cursor advance:
+    strings = {'Hello World!', 'AVAVA Ty To', 'gjpqy', ' ', '', char([72 228 246 252 223])};
+    for i = 1:length(strings)
+        [nbox1, box1, height1, adv1] = Screen('TextBounds', win, strings{i}, 100, 100);
+        [nbox2, box2, height2, adv2] = Screen('TextBounds', win, strings{i}, 100, 100);
+        if ~isequal(box1, box2) || ~isequal(height1, height2) || ~isequal(adv1, adv2)
+            error('TextBounds of string ''%s'' differ between repeated measurements!', strings{i});
+        end
+
+        newX = Screen('DrawText', win, strings{i}, 100, 100, 255);
+        if abs(newX - (100 + adv1)) > 1e-3
+            error('DrawText of string ''%s'' advanced text cursor by %f pixels instead of xAdvance %f pixels!', strings{i}, newX - 100, adv1);
+        end
+    end
+    fprintf('TextBounds and DrawText text cursor results are consistent.\n');
+
+    rand('seed', 1);
+    xy = [rand(1, nLabels) * (w - 50); rand(1, nLabels) * (h - 20)];
+    labels = cell(1, nLabels);
+    for i = 1:nLabels
+        labels{i} = sprintf('%i', i);
+    end
+
+    % Warmup, so font loading doesn't count:
+    DrawLabels(win, labels, xy);
+    Screen('DrawingFinished', win, 0, 1);
+
+    tStart = GetSecs;
+    for frame = 1:nFrames
+        DrawLabels(win, labels, xy);
+        Screen('DrawingFinished', win, 0, 1);
+    end
+    t = (GetSecs - tStart) / nFrames;
+    fprintf('%i constant labels: %.3f msecs/frame, %.0f labels/sec.\n', nLabels, t * 1000, nLabels / t);
+
+    tStart = GetSecs;
+    for frame = 1:nFrames
+        for i = 1:nLabels
+            labels{i} = sprintf('%i', frame * nLabels + i);
+        end
+        DrawLabels(win, labels, xy);
+        Screen('DrawingFinished', win, 0, 1);
+    end
+    t = (GetSecs - tStart) / nFrames;
+    fprintf('%i changing labels: %.3f msecs/frame, %.0f labels/sec.\n', nLabels, t * 1000, nLabels / t);
+
+    sca;
+catch
+    sca;
+    Screen('Preference', 'SkipSyncTests', oldsync);
+    Screen('Preference', 'VisualDebugLevel', oldvisual);
+    psychrethrow(psychlasterror);
+end
+
+Screen('Preference', 'SkipSyncTests', oldsync);
+Screen('Preference', 'VisualDebugLevel', oldvisual);
+
+return;
+
+function DrawLabels(win, labels, xy)
+for i = 1:length(labels)
+    Screen('DrawText', win, labels{i}, xy(1, i), xy(2, i), 255);
+end
+return;
@@ -0,0 +1,112 @@
+function TexturePoolTest(screenid, width, height, nTrials)
+% TexturePoolTest - Test recycling of texture storage via the texture pool.
+%
+% TexturePoolTest([screenid=max][, width=1920][, height=1080][, nTrials=100])
+%
+% Screen keeps the storage of closed textures in a pool, and recycles it
+% for new textures of the same size and format, instead of allocating new
+% storage. This test first checks that recycled textures get their correct
+% new content, for 8 bpc and float textures, rectangle and GL_TEXTURE_2D
+% textures, textures which were used as drawing targets, and for
+% asynchronous texture creation via specialFlags 64. Texture content is
+% read back via Screen('GetImage') and compared against the expected values.
+%
+% Then it measures the time of creating, preloading, drawing and closing a
+% 'width' x 'height' pixels RGBA texture in each of 'nTrials' trials, as a
+% typical per-trial stimulus script would do. Run the test once with and
+% once without the environment variable PSYCH_TEXTURE_POOL_MB=0 set before
+% starting Matlab or Octave, to compare against non-pooled allocation.
+%
+% Recycled storage keeps the content of its previous texture until it
+% gets overwritten, so the content checks use a different image for each
+% texture, to catch any code path which doesn't write the full new content.
+
+% History:
+% 10/18/26  agent   Written.
+
+if nargin < 1 || isempty(screenid)
+    screenid = max(Screen('Screens'));
+end
+
+if nargin < 2 || isempty(width)
+    width = 1920;
+end
+
+if nargin < 3 || isempty(height)
+    height = 1080;
+end
+
+if nargin < 4 || isempty(nTrials)
+    nTrials = 100;
+end
+
+PsychDefaultSetup(1);
+oldsync = Screen('Preference', 'SkipSyncTests', 2);
+oldvisual = Screen('Preference', 'VisualDebugLevel', 0);
+failed = 0;
+
+try
+    win = Screen('OpenWindow', screenid, 0, [0 0 640 480]);
+    rand('seed', 1);
+
+    % Create, check and close textures of the same shape repeatedly, so all but
+    % the first one recycle the storage of their predecessor:
+    for specialFlags = [0, 1, 64]
+        for floatprecision = [0, 2]
+            for trial = 1:3
+                img = rand(61, 97, 3);
+                if floatprecision
+                    tex = Screen('MakeTexture', win, img, [], specialFlags, floatprecision);
+                else
+                    img = round(img * 255) / 255;
+                    tex = Screen('MakeTexture', win, uint8(img * 255), [], specialFlags, floatprecision);
+                end
+
+                out = Screen('GetImage', tex, [], [], 1, 3);
+                if max(abs(out(:) - img(:))) > 1 / 255 + 1e-6
+                    fprintf('FAIL: specialFlags %i, floatprecision %i, trial %i: Texture content wrong.\n', specialFlags, floatprecision, trial);
+                    failed = failed + 1;
+                end
+
+                % Draw into the texture on the second trial, so it gets a framebuffer
+                % object, which must not leave a stale texture in the pool:
+                if trial == 2
+                    Screen('FillRect', tex, 0);
+                end
+
+                Screen('Close', tex);
+            end
+        end
+    end
+
+    % Per-trial stimulus churn:
+    img = uint8(rand(height, width, 4) * 255);
+    t = zeros(1, nTrials);
+    for trial = 1:nTrials
+        tStart = GetSecs;
+        tex = Screen('MakeTexture', win, img);
+        Screen('PreloadTextures', win, tex);
+        Screen('DrawTexture', win, tex);
+        Screen('Close', tex);
+        Screen('DrawingFinished', win, 0, 1);
+        t(trial) = GetSecs - tStart;
+    end
+
+    sca;
+catch
+    sca;
+    Screen('Preference', 'SkipSyncTests', oldsync);
+    Screen('Preference', 'VisualDebugLevel', oldvisual);
+    psychrethrow(psychlasterror);
+end
+
+Screen('Preference', 'SkipSyncTests', oldsync);
+Screen('Preference', 'VisualDebugLevel', oldvisual);
+
+fprintf('Create, preload, draw and close of %i x %i RGBA texture: Mean %f msecs, max %f msecs.\n', width, height, mean(t(2:end)) * 1000, max(t(2:end)) * 1000);
+
+if failed
+    error('TexturePoolTest: %i checks FAILED!', failed);
+end
+
+fprintf('TexturePoolTest: All checks passed.\n');
@@ -0,0 +1,133 @@
+function VideoCaptureRingTest(nFrames, ringSize, screenid)
+% VideoCaptureRingTest - Test and benchmark the video capture frame ring.
+%
+% VideoCaptureRingTest([nFrames=300][, ringSize=8][, screenid=max])
+%
+% With the GStreamer video capture engine, Screen('SetVideoCaptureParameter',
+% grabber, 'FrameRingSize', ringSize) keeps the 'ringSize' most recently
+% captured video frames mapped in system memory, together with their
+% capture timestamps. Screen('SetVideoCaptureParameter', grabber,
+% 'GetRingFrame', age) returns the frame of a given 'age' from the ring,
+% without any copy under Python, and as a copy under Matlab and Octave.
+% Screen('GetCapturedImage') shares the ring's mapping of a frame instead of
+% mapping it again.
+%
+% The test captures 'nFrames' frames of 640 x 480 pixels RGB video from a
+% GStreamer videotestsrc, so no camera is needed, and fetches each frame as
+% texture via Screen('GetCapturedImage'). During capture, it checks that
+% all frames in the ring have the expected size, consecutive frame indices
+% and timestamps which increase with decreasing age. After capture, it
+% prints the mean time for fetching the newest frame via 'GetRingFrame',
+% and for fetching a frame as raw image matrix via 'GetCapturedImage'.
+%
+% Each raw 'GetCapturedImage' call waits for the next frame of the 30 fps
+% test source, so expect about 33 msecs, whereas 'GetRingFrame' returns the
+% newest frame without waiting.
+
+% History:
+% 10/18/26  agent   Written.
+
+if nargin < 1 || isempty(nFrames)
+    nFrames = 300;
+end
+
+if nargin < 2 || isempty(ringSize)
+    ringSize = 8;
+end
+
+if nargin < 3 || isempty(screenid)
+    screenid = max(Screen('Screens'));
+end
+
+PsychDefaultSetup(1);
+oldsync = Screen('Preference', 'SkipSyncTests', 2);
+oldvisual = Screen('Preference', 'VisualDebugLevel', 0);
+
+try
+    win = Screen('OpenWindow', screenid, 0, [0 0 640 480]);
+
+    % Use a live test pattern as video source, via special deviceIndex -9:
+    Screen('SetVideoCaptureParameter', -1, 'SetNextCaptureBinSpec=videotestsrc is-live=true pattern=ball ! videoconvert name=ptbdvsource');
+    grabber = Screen('OpenVideoCapture', win, -9, [0 0 640 480], 3, [], [], [], [], 3);
+
+    Screen('SetVideoCaptureParameter', grabber, 'FrameRingSize', ringSize);
+    if Screen('SetVideoCaptureParameter', grabber, 'FrameRingSize') ~= ringSize
+        error('FrameRingSize query did not return the assigned ring size %i!', ringSize);
+    end
+
+    Screen('StartVideoCapture', grabber, 30, 0);
+
+    nChecked = 0;
+    for frame = 1:nFrames
+        tex = Screen('GetCapturedImage', win, grabber, 1);
+        if tex > 0
+            Screen('DrawTexture', win, tex);
+            Screen('Close', tex);
+        end
+        Screen('Flip', win, [], [], 2);
+
+        % Check the content of the ring from newest to oldest frame:
+        [img, tNewest, idxNewest] = Screen('SetVideoCaptureParameter', grabber, 'GetRingFrame', 0);
+        if isempty(img)
+            continue;
+        end
+
+        for age = 1:min(ringSize, idxNewest + 1) - 1
+            [img, t, idx] = Screen('SetVideoCaptureParameter', grabber, 'GetRingFrame', age);
+            if isempty(img) || idx > idxNewest
+                % Ring advanced since fetch of the newest frame:
+                break;
+            end
+
+            if ~isequal(size(img), [3, 640, 480]) || ~isa(img, 'uint8')
+                error('Ring frame of age %i has wrong format!', age);
+            end
+
+            if idx ~= idxNewest - age || t >= tNewest
+                error('Ring frame of age %i has frameIndex %i and timestamp %f, newest frame %i and %f!', age, idx, t, idxNewest, tNewest);
+            end
+            nChecked = nChecked + 1;
+        end
+    end
+    fprintf('%i ring frames checked, last frameIndex %i.\n', nChecked, idxNewest);
+
+    % Benchmark access to the newest frame:
+    nFetches = 100;
+    tStart = GetSecs;
+    for i = 1:nFetches
+        img = Screen('SetVideoCaptureParameter', grabber, 'GetRingFrame', 0); %#ok<NASGU>
+    end
+    tRing = (GetSecs - tStart) / nFetches;
+
+    tStart = GetSecs;
+    for i = 1:nFetches
+        [tex, pts, dropped, img] = Screen('GetCapturedImage', win, grabber, 1, [], 2); %#ok<ASGLU>
+    end
+    tRaw = (GetSecs - tStart) / nFetches;
+    fprintf('GetRingFrame: %.3f msecs, GetCapturedImage raw image: %.3f msecs per frame, including wait for capture.\n', tRing * 1000, tRaw * 1000);
+
+    Screen('StopVideoCapture', grabber);
+
+    % Ring frames stay available after stop of capture, until the ring is disabled:
+    if isempty(Screen('SetVideoCaptureParameter', grabber, 'GetRingFrame', 0))
+        error('Ring frame unavailable after stop of capture!');
+    end
+
+    Screen('SetVideoCaptureParameter', grabber, 'FrameRingSize', 0);
+    if ~isempty(Screen('SetVideoCaptureParameter', grabber, 'GetRingFrame', 0))
+        error('Ring frame available after disabling the ring!');
+    end
+
+    Screen('CloseVideoCapture', grabber);
+    sca;
+catch
+    sca;
+    Screen('Preference', 'SkipSyncTests', oldsync);
+    Screen('Preference', 'VisualDebugLevel', oldvisual);
+    psychrethrow(psychlasterror);
+end
+
+Screen('Preference', 'SkipSyncTests', oldsync);
+Screen('Preference', 'VisualDebugLevel', oldvisual);
+
+return;